@@ -49,6 +49,8 @@
 #include "math/ncm_util.h"
 #include "math/integral.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
+#include "math/ncm_spline_cubic_notaknot.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #ifdef HAVE_HDF5
@@ -68,6 +70,23 @@ struct _NcDataReducedShearClusterMassPrivate
 	gdouble z_cluster;
 	gdouble ra_cluster;
 	gdouble dec_cluster;
+	guint nnodes;
+	guint nthreads;
+	gboolean nodes_ok;
+	GArray *gal_int;
+	GArray *int_node;
+	GArray *node_z;
+	GArray *node_w;
+	GArray *lnP;
+	GArray *kappa_inf;
+	GArray *gamma_inf;
+	gdouble z_min;
+	gdouble z_max;
+	NcmSpline *beta_s;
+	NcmVector *pz_z;
+	NcmVector *pz_pdf;
+	NcmVector *pz_z_best;
+	NcmVector *pz_nknots;
 };
 
 enum
@@ -81,6 +100,12 @@ enum
   PROP_Z_CLUSTER, 
   PROP_RA_CLUSTER, 
   PROP_DEC_CLUSTER, 
+  PROP_NNODES,
+  PROP_NTHREADS,
+  PROP_PZ_Z,
+  PROP_PZ_PDF,
+  PROP_PZ_Z_BEST,
+  PROP_PZ_NKNOTS,
   PROP_SIZE,
 };
 
@@ -98,6 +123,23 @@ nc_data_reduced_shear_cluster_mass_init (NcDataReducedShearClusterMass *drs)
   self->dec_cluster  = 0.0;
 	self->has_rh       = FALSE;
 	self->psf_size     = 0.0;
+	self->nnodes       = 0;
+	self->nthreads     = 0;
+	self->nodes_ok     = FALSE;
+	self->gal_int      = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->int_node     = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->node_z       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	self->node_w       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	self->lnP          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	self->kappa_inf    = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	self->gamma_inf    = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	self->z_min        = 0.0;
+	self->z_max        = 0.0;
+	self->beta_s       = ncm_spline_cubic_notaknot_new ();
+	self->pz_z         = NULL;
+	self->pz_pdf       = NULL;
+	self->pz_z_best    = NULL;
+	self->pz_nknots    = NULL;
 }
 
 static void
@@ -118,8 +160,18 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
 			
 			g_clear_pointer (&self->photoz_array, ncm_obj_array_unref);
 			self->photoz_array = ncm_obj_array_ref (photoz_array);
+			self->nodes_ok     = FALSE;
 
-			if (self->gal_obs != NULL)
+			if (self->photoz_array->len > 0)
+			{
+				/* An array of objects replaces the packed table */
+				ncm_vector_clear (&self->pz_z);
+				ncm_vector_clear (&self->pz_pdf);
+				ncm_vector_clear (&self->pz_z_best);
+				ncm_vector_clear (&self->pz_nknots);
+			}
+
+			if ((self->gal_obs != NULL) && (self->photoz_array->len > 0))
 			{
 				g_assert_cmpuint (self->photoz_array->len, ==, ncm_matrix_nrows (self->gal_obs));
 			}
@@ -133,7 +185,7 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
 			ncm_matrix_clear (&self->gal_obs);
 			self->gal_obs = ncm_matrix_ref (gal_obs);
 
-			if (self->photoz_array != NULL)
+			if ((self->photoz_array != NULL) && (self->photoz_array->len > 0))
 			{
 				g_assert_cmpuint (self->photoz_array->len, ==, ncm_matrix_nrows (self->gal_obs));
 			}
@@ -148,6 +200,7 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
       break;
     case PROP_Z_CLUSTER:
       self->z_cluster = g_value_get_double (value);
+      self->nodes_ok  = FALSE;
       break;
     case PROP_RA_CLUSTER:
       self->ra_cluster = g_value_get_double (value);
@@ -155,6 +208,32 @@ nc_data_reduced_shear_cluster_mass_set_property (GObject *object, guint prop_id,
     case PROP_DEC_CLUSTER:
       self->dec_cluster = g_value_get_double (value);
       break;
+    case PROP_NNODES:
+      nc_data_reduced_shear_cluster_mass_set_nnodes (drs, g_value_get_uint (value));
+      break;
+    case PROP_NTHREADS:
+      nc_data_reduced_shear_cluster_mass_set_nthreads (drs, g_value_get_uint (value));
+      break;
+    case PROP_PZ_Z:
+      ncm_vector_clear (&self->pz_z);
+      self->pz_z     = g_value_dup_object (value);
+      self->nodes_ok = FALSE;
+      break;
+    case PROP_PZ_PDF:
+      ncm_vector_clear (&self->pz_pdf);
+      self->pz_pdf   = g_value_dup_object (value);
+      self->nodes_ok = FALSE;
+      break;
+    case PROP_PZ_Z_BEST:
+      ncm_vector_clear (&self->pz_z_best);
+      self->pz_z_best = g_value_dup_object (value);
+      self->nodes_ok  = FALSE;
+      break;
+    case PROP_PZ_NKNOTS:
+      ncm_vector_clear (&self->pz_nknots);
+      self->pz_nknots = g_value_dup_object (value);
+      self->nodes_ok  = FALSE;
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -194,6 +273,24 @@ nc_data_reduced_shear_cluster_mass_get_property (GObject *object, guint prop_id,
     case PROP_DEC_CLUSTER:
       g_value_set_double (value, self->dec_cluster);
       break;
+    case PROP_NNODES:
+      g_value_set_uint (value, nc_data_reduced_shear_cluster_mass_get_nnodes (drs));
+      break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, nc_data_reduced_shear_cluster_mass_get_nthreads (drs));
+      break;
+    case PROP_PZ_Z:
+      g_value_set_object (value, self->pz_z);
+      break;
+    case PROP_PZ_PDF:
+      g_value_set_object (value, self->pz_pdf);
+      break;
+    case PROP_PZ_Z_BEST:
+      g_value_set_object (value, self->pz_z_best);
+      break;
+    case PROP_PZ_NKNOTS:
+      g_value_set_object (value, self->pz_nknots);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -209,6 +306,11 @@ nc_data_reduced_shear_cluster_mass_dispose (GObject *object)
   ncm_matrix_clear (&self->gal_obs);
 	ncm_obj_array_clear (&self->photoz_array);
 	nc_distance_clear (&self->dist);
+	ncm_spline_clear (&self->beta_s);
+	ncm_vector_clear (&self->pz_z);
+	ncm_vector_clear (&self->pz_pdf);
+	ncm_vector_clear (&self->pz_z_best);
+	ncm_vector_clear (&self->pz_nknots);
 	
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_reduced_shear_cluster_mass_parent_class)->dispose (object);
@@ -217,7 +319,16 @@ nc_data_reduced_shear_cluster_mass_dispose (GObject *object)
 static void
 nc_data_reduced_shear_cluster_mass_finalize (GObject *object)
 {
-  /*NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (object);*/
+  NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (object);
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+
+	g_array_unref (self->gal_int);
+	g_array_unref (self->int_node);
+	g_array_unref (self->node_z);
+	g_array_unref (self->node_w);
+	g_array_unref (self->lnP);
+	g_array_unref (self->kappa_inf);
+	g_array_unref (self->gamma_inf);
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_reduced_shear_cluster_mass_parent_class)->finalize (object);
@@ -295,64 +406,374 @@ nc_data_reduced_shear_cluster_mass_class_init (NcDataReducedShearClusterMassClas
                                                          "Cluster (halo) DEC",
                                                          -360.0, 360.0, 0.0,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+                                   PROP_NNODES,
+                                   g_param_spec_uint ("nnodes",
+                                                      NULL,
+                                                      "Number of quadrature nodes per photo-z interval",
+                                                      2, G_MAXUINT, 20,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used in the galaxy loop",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	/**
+	 * NcDataReducedShearClusterMass:pz-z:
+	 * 
+	 * Packed photometric redshift table: redshift knots of all galaxies,
+	 * the knots of each galaxy are stored contiguously, see #NcDataReducedShearClusterMass:pz-nknots.
+	 * When the packed table is present #NcDataReducedShearClusterMass:photoz-array is not used.
+	 * 
+	 */
+	g_object_class_install_property (object_class,
+	                                 PROP_PZ_Z,
+	                                 g_param_spec_object ("pz-z",
+	                                                      NULL,
+	                                                      "Packed photo-z redshift knots",
+	                                                      NCM_TYPE_VECTOR,
+	                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	/**
+	 * NcDataReducedShearClusterMass:pz-pdf:
+	 * 
+	 * Packed photometric redshift table: $P(z)$ at the knots in #NcDataReducedShearClusterMass:pz-z.
+	 * 
+	 */
+	g_object_class_install_property (object_class,
+	                                 PROP_PZ_PDF,
+	                                 g_param_spec_object ("pz-pdf",
+	                                                      NULL,
+	                                                      "Packed photo-z distribution",
+	                                                      NCM_TYPE_VECTOR,
+	                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	/**
+	 * NcDataReducedShearClusterMass:pz-z-best:
+	 * 
+	 * Packed photometric redshift table: best fit redshift of each galaxy.
+	 * 
+	 */
+	g_object_class_install_property (object_class,
+	                                 PROP_PZ_Z_BEST,
+	                                 g_param_spec_object ("pz-z-best",
+	                                                      NULL,
+	                                                      "Packed photo-z best fit redshift",
+	                                                      NCM_TYPE_VECTOR,
+	                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	/**
+	 * NcDataReducedShearClusterMass:pz-nknots:
+	 * 
+	 * Packed photometric redshift table: number of knots of each galaxy, 
+	 * zero means a delta distribution at the best fit redshift.
+	 * 
+	 */
+	g_object_class_install_property (object_class,
+	                                 PROP_PZ_NKNOTS,
+	                                 g_param_spec_object ("pz-nknots",
+	                                                      NULL,
+	                                                      "Packed photo-z number of knots",
+	                                                      NCM_TYPE_VECTOR,
+	                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
  
   data_class->m2lnL_val  = &_nc_data_reduced_shear_cluster_mass_m2lnL_val;
   data_class->get_length = &_nc_data_reduced_shear_cluster_mass_get_len;
   data_class->prepare    = &_nc_data_reduced_shear_cluster_mass_prepare;
 }
 
-typedef struct _NcDataReducedShearClusterMassInteg
+#define _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BLOCK 1024
+#define _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BETA_NKNOTS 200
+#define _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_HDF5_CHUNK 65536
+
+static guint
+_nc_data_reduced_shear_cluster_mass_ngal (NcDataReducedShearClusterMassPrivate * const self)
 {
-	NcGalaxyRedshift *gz;
-	NcReducedShearClusterMass *rs;
-	NcReducedShearCalib *rs_calib;
-	NcDistance *dist;
-	NcHICosmo *cosmo;
-	NcWLSurfaceMassDensity *smd;
-	NcDensityProfile *dp;
-	gdouble z_cluster;
-	gdouble R_Mpc;
-	gdouble dt_cluster;
-	gdouble g_obs;
-	guint interval_index;
-	gdouble psf_size;
-	gdouble rh;
-	} NcDataReducedShearClusterMassInteg;
+  if (self->pz_z_best != NULL)
+    return ncm_vector_len (self->pz_z_best);
+  else
+    return (self->photoz_array != NULL) ? self->photoz_array->len : 0;
+}
 
-static gdouble
-_nc_data_reduced_shear_cluster_mass_Pgal (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ)
+static void
+_nc_data_reduced_shear_cluster_mass_append_nodes (NcDataReducedShearClusterMassPrivate * const self, NcGalaxyRedshift *gz, gsl_integration_glfixed_table *glt)
 {
-	const gdouble g_th = nc_wl_surface_mass_density_reduced_shear_infinity (integ->smd, integ->dp, integ->cosmo, integ->R_Mpc, z_gal, integ->z_cluster, integ->z_cluster);
-	const gdouble Pgal = nc_reduced_shear_cluster_mass_P_z_gth_gobs (integ->rs, integ->cosmo, z_gal, g_th, integ->g_obs);
-	
-	return Pgal;
+  const gdouble z_gal = nc_galaxy_redshift_mode (gz);
+
+  {
+    const guint nint = self->int_node->len - 1;
+    g_array_append_val (self->gal_int, nint);
+  }
+
+  if (z_gal < self->z_cluster + 0.1 || z_gal > 1.25)
+    return;
+
+  if (!nc_galaxy_redshift_has_dist (gz))
+  {
+    const gdouble w = 1.0;
+
+    g_array_append_val (self->node_z, z_gal);
+    g_array_append_val (self->node_w, w);
+    {
+      const guint nnode = self->node_z->len;
+      g_array_append_val (self->int_node, nnode);
+    }
+
+    self->z_min = GSL_MIN (self->z_min, z_gal);
+    self->z_max = GSL_MAX (self->z_max, z_gal);
+  }
+  else
+  {
+    const guint ndists = nc_galaxy_redshift_nintervals (gz);
+    guint j;
+
+    for (j = 0; j < ndists; j++)
+    {
+      gdouble z_gal_lower, z_gal_upper;
+      guint k;
+
+      nc_galaxy_redshift_pdf_limits (gz, j, &z_gal_lower, &z_gal_upper);
+
+      for (k = 0; k < self->nnodes; k++)
+      {
+        gdouble z_k, w_k;
+
+        gsl_integration_glfixed_point (z_gal_lower, z_gal_upper, k, &z_k, &w_k, glt);
+        w_k *= nc_galaxy_redshift_pdf (gz, j, z_k);
+
+        g_array_append_val (self->node_z, z_k);
+        g_array_append_val (self->node_w, w_k);
+      }
+      {
+        const guint nnode = self->node_z->len;
+        g_array_append_val (self->int_node, nnode);
+      }
+
+      self->z_min = GSL_MIN (self->z_min, z_gal_lower);
+      self->z_max = GSL_MAX (self->z_max, z_gal_upper);
+    }
+  }
 }
 
-static gdouble
-_nc_data_reduced_shear_cluster_mass_Pgal_calib (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ)
+/*
+ * Builds the fixed quadrature nodes of each galaxy. Each galaxy
+ * has a set of intervals (one for each photo-z interval or a single one
+ * for galaxies without distribution) and each interval a set of nodes z_k
+ * with weights w_k p(z_k), such that the original integral over the interval
+ * becomes a weighted sum. The nodes depend only on the data, not on the models,
+ * so they are computed once. When the data is stored in the packed table, 
+ * a temporary #NcGalaxyRedshift is built for each galaxy.
+ */
+static void
+_nc_data_reduced_shear_cluster_mass_prepare_nodes (NcDataReducedShearClusterMassPrivate * const self)
 {
-	const gdouble g_th       = nc_wl_surface_mass_density_reduced_shear_infinity (integ->smd, integ->dp, integ->cosmo, integ->R_Mpc, z_gal, integ->z_cluster, integ->z_cluster);
-	const gdouble g_th_calib = nc_reduced_shear_calib_eval (integ->rs_calib, g_th, integ->psf_size, integ->rh);
-	const gdouble Pgal       = nc_reduced_shear_cluster_mass_P_z_gth_gobs (integ->rs, integ->cosmo, z_gal, g_th_calib, integ->g_obs);
-	return Pgal;
+  const guint ngal = _nc_data_reduced_shear_cluster_mass_ngal (self);
+  gsl_integration_glfixed_table *glt = gsl_integration_glfixed_table_alloc (self->nnodes);
+  guint i;
+
+  g_array_set_size (self->gal_int, 0);
+  g_array_set_size (self->int_node, 0);
+  g_array_set_size (self->node_z, 0);
+  g_array_set_size (self->node_w, 0);
+
+  self->z_min = GSL_POSINF;
+  self->z_max = GSL_NEGINF;
+
+  {
+    const guint nnode = 0;
+    g_array_append_val (self->int_node, nnode);
+  }
+
+  if (self->pz_z_best != NULL)
+  {
+    guint offset = 0;
+
+    g_assert (self->pz_nknots != NULL);
+    g_assert_cmpuint (ncm_vector_len (self->pz_nknots), ==, ngal);
+
+    for (i = 0; i < ngal; i++)
+    {
+      const guint nknots = ncm_vector_get (self->pz_nknots, i);
+      NcGalaxyRedshift *gz;
+
+      if (nknots == 0)
+      {
+        gz = NC_GALAXY_REDSHIFT (nc_galaxy_redshift_spec_new (ncm_vector_get (self->pz_z_best, i)));
+      }
+      else
+      {
+        NcmVector *zv               = ncm_vector_get_subvector (self->pz_z, offset, nknots);
+        NcmVector *Pzv              = ncm_vector_get_subvector (self->pz_pdf, offset, nknots);
+        NcGalaxyRedshiftSpline *gzs = nc_galaxy_redshift_spline_new ();
+
+        nc_galaxy_redshift_spline_init_from_vectors (gzs, zv, Pzv);
+        gz = NC_GALAXY_REDSHIFT (gzs);
+
+        ncm_vector_free (zv);
+        ncm_vector_free (Pzv);
+        offset += nknots;
+      }
+
+      _nc_data_reduced_shear_cluster_mass_append_nodes (self, gz, glt);
+      nc_galaxy_redshift_free (gz);
+    }
+  }
+  else
+  {
+    for (i = 0; i < ngal; i++)
+    {
+      NcGalaxyRedshift *gz = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, i));
+      _nc_data_reduced_shear_cluster_mass_append_nodes (self, gz, glt);
+    }
+  }
+
+  {
+    const guint nint = self->int_node->len - 1;
+    g_array_append_val (self->gal_int, nint);
+  }
+
+  gsl_integration_glfixed_table_free (glt);
+  self->nodes_ok = TRUE;
 }
 
-static gdouble
-_nc_data_reduced_shear_cluster_mass_PgalPz (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ)
+/*
+ * Tabulates beta_s(z_s) = Sigma_crit_infinity / Sigma_crit(z_s), i.e., the
+ * source redshift dependence of the reduced shear at fixed projected radius,
+ * g(R, z_s) = beta_s gamma_inf(R) / (1 - beta_s kappa_inf(R)).
+ */
+static void
+_nc_data_reduced_shear_cluster_mass_prepare_beta_s (NcDataReducedShearClusterMassPrivate * const self, NcHICosmo *cosmo)
 {
-	const gdouble Pgal = _nc_data_reduced_shear_cluster_mass_Pgal (z_gal, integ);
-	const gdouble Pz   = nc_galaxy_redshift_pdf (integ->gz, integ->interval_index, z_gal);
+  const gdouble zl      = self->z_cluster;
+  const gdouble Dinf    = nc_distance_transverse_z_to_infinity (self->dist, cosmo, 0.0);
+  const gdouble betainf = nc_distance_transverse_z_to_infinity (self->dist, cosmo, zl) / Dinf;
+  const gdouble dt_l    = nc_distance_transverse (self->dist, cosmo, zl);
+  const gdouble z_min   = self->z_min;
+  const gdouble z_max   = (self->z_max > self->z_min) ? self->z_max : self->z_min + 1.0;
+  NcmVector *zv         = ncm_vector_new (_NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BETA_NKNOTS);
+  NcmVector *bv         = ncm_vector_new (_NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BETA_NKNOTS);
+  guint i;
 
-	return Pgal * Pz;
+  for (i = 0; i < _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BETA_NKNOTS; i++)
+  {
+    const gdouble zs   = z_min + (z_max - z_min) * i / (_NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BETA_NKNOTS - 1.0);
+    const gdouble Ds   = nc_distance_angular_diameter (self->dist, cosmo, zs);
+    const gdouble Dls  = (nc_distance_transverse (self->dist, cosmo, zs) - dt_l) / (1.0 + zs);
+
+    ncm_vector_set (zv, i, zs);
+    ncm_vector_set (bv, i, (Dls / Ds) / betainf);
+  }
+
+  ncm_spline_set (self->beta_s, zv, bv, TRUE);
+
+  ncm_vector_free (zv);
+  ncm_vector_free (bv);
 }
 
-static gdouble
-_nc_data_reduced_shear_cluster_mass_PgalPz_calib (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ)
+typedef struct _NcDataReducedShearClusterMassEval
 {
-	const gdouble Pgal = _nc_data_reduced_shear_cluster_mass_Pgal_calib (z_gal, integ);
-	const gdouble Pz   = nc_galaxy_redshift_pdf (integ->gz, integ->interval_index, z_gal);
+  NcDataReducedShearClusterMassPrivate *self;
+	NcReducedShearClusterMass *rs;
+	NcReducedShearCalib *rs_calib;
+	NcHICosmo *cosmo;
+} NcDataReducedShearClusterMassEval;
 
-	return Pgal * Pz;
+/*
+ * Computes kappa_inf(R) and gamma_inf(R) of each galaxy inside the radial
+ * range. This is done serially, since NcWLSurfaceMassDensity (and the
+ * NcDistance it uses) builds its tables lazily at the first evaluation,
+ * the threaded loop below only reads the values stored here.
+ */
+static void
+_nc_data_reduced_shear_cluster_mass_prepare_profile (NcDataReducedShearClusterMassPrivate * const self, NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo)
+{
+  const guint ngal   = _nc_data_reduced_shear_cluster_mass_ngal (self);
+  const gdouble RH   = nc_hicosmo_RH_Mpc (cosmo);
+  const gdouble dA   = nc_distance_angular_diameter (self->dist, cosmo, self->z_cluster) * RH;
+  guint gal;
+
+  g_array_set_size (self->kappa_inf, ngal);
+  g_array_set_size (self->gamma_inf, ngal);
+
+  for (gal = 0; gal < ngal; gal++)
+  {
+    const guint int_i      = g_array_index (self->gal_int, guint, gal);
+    const guint int_f      = g_array_index (self->gal_int, guint, gal + 1);
+    const gdouble r_arcmin = ncm_matrix_get (self->gal_obs, gal, 0);
+    const gdouble R_Mpc    = (r_arcmin / 60.0) * (M_PI / 180.0) * dA;
+    gdouble kappa_inf      = GSL_NAN;
+    gdouble gamma_inf      = GSL_NAN;
+
+    if ((int_i < int_f) && (R_Mpc >= 0.75) && (R_Mpc <= 3.0))
+    {
+      kappa_inf = nc_wl_surface_mass_density_convergence_infinity (smd, dp, cosmo, R_Mpc, self->z_cluster, self->z_cluster);
+      gamma_inf = nc_wl_surface_mass_density_shear_infinity (smd, dp, cosmo, R_Mpc, self->z_cluster, self->z_cluster);
+    }
+
+    g_array_index (self->kappa_inf, gdouble, gal) = kappa_inf;
+    g_array_index (self->gamma_inf, gdouble, gal) = gamma_inf;
+  }
+}
+
+static void
+_nc_data_reduced_shear_cluster_mass_eval_block (glong i, glong f, gpointer data)
+{
+  NcDataReducedShearClusterMassEval *eval = (NcDataReducedShearClusterMassEval *) data;
+	NcDataReducedShearClusterMassPrivate * const self = eval->self;
+  const guint ngal = _nc_data_reduced_shear_cluster_mass_ngal (self);
+  glong b;
+
+  for (b = i; b < f; b++)
+  {
+    const guint gal_i = b * _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BLOCK;
+    const guint gal_f = GSL_MIN (gal_i + _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BLOCK, ngal);
+    guint gal;
+
+    for (gal = gal_i; gal < gal_f; gal++)
+    {
+      const guint int_i       = g_array_index (self->gal_int, guint, gal);
+      const guint int_f       = g_array_index (self->gal_int, guint, gal + 1);
+      const gdouble kappa_inf = g_array_index (self->kappa_inf, gdouble, gal);
+      const gdouble gamma_inf = g_array_index (self->gamma_inf, gdouble, gal);
+      gdouble lnP             = 0.0;
+
+      if (int_i < int_f)
+      {
+        const gdouble g_obs    = ncm_matrix_get (self->gal_obs, gal, 1);
+        const gdouble rh       = self->has_rh ? ncm_matrix_get (self->gal_obs, gal, 2) : 0.0;
+
+        /* Galaxies outside the radial range have no profile terms, see _nc_data_reduced_shear_cluster_mass_prepare_profile(). */
+        if (gsl_finite (kappa_inf))
+        {
+          guint j;
+
+          for (j = int_i; j < int_f; j++)
+          {
+            const guint node_i = g_array_index (self->int_node, guint, j);
+            const guint node_f = g_array_index (self->int_node, guint, j + 1);
+            gdouble P_j        = 0.0;
+            guint k;
+
+            for (k = node_i; k < node_f; k++)
+            {
+              const gdouble z_k    = g_array_index (self->node_z, gdouble, k);
+              const gdouble w_k    = g_array_index (self->node_w, gdouble, k);
+              const gdouble beta_s = ncm_spline_eval (self->beta_s, z_k);
+              gdouble g_th         = beta_s * gamma_inf / (1.0 - beta_s * kappa_inf);
+
+              if (self->has_rh)
+                g_th = nc_reduced_shear_calib_eval (eval->rs_calib, g_th, self->psf_size, rh);
+
+              P_j += w_k * nc_reduced_shear_cluster_mass_P_z_gth_gobs (eval->rs, eval->cosmo, z_k, g_th, g_obs);
+            }
+
+            lnP += log (P_j);
+          }
+        }
+      }
+
+      g_array_index (self->lnP, gdouble, gal) = lnP;
+    }
+  }
 }
 
 static void
@@ -365,104 +786,44 @@ _nc_data_reduced_shear_cluster_mass_m2lnL_val (NcmData *data, NcmMSet *mset, gdo
   NcDensityProfile *dp          = NC_DENSITY_PROFILE (ncm_mset_peek (mset, nc_density_profile_id ()));
 	NcReducedShearClusterMass *rs = NC_REDUCED_SHEAR_CLUSTER_MASS (ncm_mset_peek (mset, nc_reduced_shear_cluster_mass_id ()));
 	NcReducedShearCalib *rs_calib = NC_REDUCED_SHEAR_CALIB (ncm_mset_peek (mset, nc_reduced_shear_calib_id ()));
-	const guint ngal              = self->photoz_array->len;
-	const gdouble RH              = nc_hicosmo_RH_Mpc (cosmo);
-	const gdouble dA              = nc_distance_angular_diameter (self->dist, cosmo, self->z_cluster) * RH;
-	const gdouble dt              = nc_distance_transverse (self->dist, cosmo, self->z_cluster);
-	gsl_integration_workspace **w = ncm_integral_get_workspace ();
-  	
-	NcDataReducedShearClusterMassInteg integ_data;
-	gint i;
+	const guint ngal              = _nc_data_reduced_shear_cluster_mass_ngal (self);
+	const guint nblocks           = (ngal + _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BLOCK - 1) / _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_BLOCK;
+	NcDataReducedShearClusterMassEval eval = {self, rs, rs_calib, cosmo};
+	guint i;
 
-	gdouble (*Pgal) (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ);
-  gdouble (*PgalPz) (gdouble z_gal, NcDataReducedShearClusterMassInteg *integ);
-	
   g_assert (cosmo != NULL);
   g_assert (smd != NULL);
   g_assert (dp != NULL);
   g_assert (rs != NULL);
 
-	integ_data.rs         = rs;
-	integ_data.rs_calib   = rs_calib;
-	integ_data.dist       = self->dist;
-	integ_data.cosmo      = cosmo;
-	integ_data.smd        = smd;
-	integ_data.dp         = dp;
-	integ_data.z_cluster  = self->z_cluster;
-	integ_data.dt_cluster = dt;
-  integ_data.psf_size   = self->psf_size;
-	
-	m2lnL[0] = 0.0;
-
 	if (self->has_rh == TRUE)
-	{
-		Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal_calib;
-		PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz_calib;		
 		g_assert (rs_calib != NULL);
-	}
-	else
-	{
-		Pgal   = &_nc_data_reduced_shear_cluster_mass_Pgal;
-		PgalPz = &_nc_data_reduced_shear_cluster_mass_PgalPz;
-	}
-		
-	for (i = 0; i < ngal; i++)
-	{
-		NcGalaxyRedshift *gz      = NC_GALAXY_REDSHIFT (ncm_obj_array_peek (self->photoz_array, i));
-		const gdouble r_arcmin    = ncm_matrix_get (self->gal_obs, i, 0);
-		const gdouble g_obs       = ncm_matrix_get (self->gal_obs, i, 1);
-		const gdouble rh          = self->has_rh ? ncm_matrix_get (self->gal_obs, i, 2) : 0.0;
-		const gdouble R_Mpc       = (r_arcmin / 60.0) * (M_PI / 180.0) * dA;
-
-		const gdouble z_gal       = nc_galaxy_redshift_mode (gz);
-
-		if (R_Mpc < 0.75 || R_Mpc > 3.0 || z_gal < self->z_cluster + 0.1 || z_gal > 1.25)
-		{
-			//printf ("r_arcmin = %.5g R_Mpc = %.5g\n", r_arcmin, R_Mpc);
-			//printf ("z_gal = %.5g\n", z_gal);
-			continue;
-		}
 
-    integ_data.gz    = gz;
-		integ_data.R_Mpc = R_Mpc;
-		integ_data.g_obs = g_obs;
-		integ_data.rh    = rh;
-		
-		if (!nc_galaxy_redshift_has_dist (gz))
-		{
-			//const gdouble z_gal = nc_galaxy_redshift_mode (gz);
-			const gdouble P_i   = Pgal (z_gal, &integ_data);
-			//printf ("zgal = %.5g\n", z_gal);
-			m2lnL[0] += log (P_i);
-		}
-		else
-		{
-			const guint ndists = nc_galaxy_redshift_nintervals (gz);
-			gint j;
+	if (!self->nodes_ok)
+		_nc_data_reduced_shear_cluster_mass_prepare_nodes (self);
 
-			for (j = 0; j < ndists; j++)
-			{
-				gdouble z_gal_lower, z_gal_upper, P_ij, abserr;
-				gsl_function F;
-				
-				nc_galaxy_redshift_pdf_limits (gz, j, &z_gal_lower, &z_gal_upper);
-
-				//printf ("zgal_l = %.5g zgal_u = %.5g\n", z_gal_lower, z_gal_upper);
-				integ_data.interval_index = j;
-
-				F.params   = &integ_data;
-				F.function = (gdouble (*)(gdouble,gpointer)) PgalPz;
-				
-				gsl_integration_qag (&F, z_gal_lower, z_gal_upper, 0.0, 1.0e-5, NCM_INTEGRAL_PARTITION, 1, *w, &P_ij, &abserr);
+	m2lnL[0] = 0.0;
+	if (self->node_z->len == 0)
+		return;
+
+	/* Everything with lazy caches is evaluated here, before the threaded loop */
+	nc_distance_prepare_if_needed (self->dist, cosmo);
+	nc_wl_surface_mass_density_prepare_if_needed (smd, cosmo);
+	_nc_data_reduced_shear_cluster_mass_prepare_beta_s (self, cosmo);
+	_nc_data_reduced_shear_cluster_mass_prepare_profile (self, smd, dp, cosmo);
+	g_array_set_size (self->lnP, ngal);
+
+	if ((self->nthreads > 1) && (nblocks > 1))
+		ncm_func_eval_threaded_loop_full (&_nc_data_reduced_shear_cluster_mass_eval_block, 0, nblocks, &eval);
+	else
+		_nc_data_reduced_shear_cluster_mass_eval_block (0, nblocks, &eval);
 
-				m2lnL[0] += log (P_ij);
-			}
-		}
-	}
+	/* Reduction in a fixed order, the result does not depend on the number of threads */
+	for (i = 0; i < ngal; i++)
+		m2lnL[0] += g_array_index (self->lnP, gdouble, i);
 
 	m2lnL[0] = -2.0 * m2lnL[0];
-	
-	ncm_memory_pool_return (w);
+
   return;
 }
 
@@ -472,7 +833,7 @@ _nc_data_reduced_shear_cluster_mass_get_len (NcmData *data)
 	NcDataReducedShearClusterMass *drs = NC_DATA_REDUCED_SHEAR_CLUSTER_MASS (data);
 	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
 
-	return (self->photoz_array != NULL) ? self->photoz_array->len : 0; 
+	return _nc_data_reduced_shear_cluster_mass_ngal (self);
 }
 
 static void 
@@ -488,6 +849,9 @@ _nc_data_reduced_shear_cluster_mass_prepare (NcmData *data, NcmMSet *mset)
   g_assert ((cosmo != NULL) && (smd != NULL) && (dp != NULL) && (rs != NULL));
 
   nc_distance_prepare_if_needed (self->dist, cosmo);
+
+	if (!self->nodes_ok)
+		_nc_data_reduced_shear_cluster_mass_prepare_nodes (self);
 }
 
 
@@ -584,6 +948,76 @@ nc_data_reduced_shear_cluster_mass_set_dist (NcDataReducedShearClusterMass *drs,
   self->dist = nc_distance_ref (dist);
 }
 
+/**
+ * nc_data_reduced_shear_cluster_mass_set_nnodes:
+ * @drs: a #NcDataReducedShearClusterMass
+ * @nnodes: number of nodes
+ * 
+ * Sets the number of Gauss-Legendre nodes used in each photometric
+ * redshift interval. The nodes and the respective weights (including
+ * the photo-z distribution) are computed once for each galaxy.
+ * 
+ */
+void 
+nc_data_reduced_shear_cluster_mass_set_nnodes (NcDataReducedShearClusterMass *drs, const guint nnodes)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+
+	g_assert_cmpuint (nnodes, >=, 2);
+	
+	if (self->nnodes != nnodes)
+	{
+		self->nnodes   = nnodes;
+		self->nodes_ok = FALSE;
+	}
+}
+
+/**
+ * nc_data_reduced_shear_cluster_mass_get_nnodes:
+ * @drs: a #NcDataReducedShearClusterMass
+ * 
+ * Returns: the number of nodes used in each photometric redshift interval.
+ */
+guint 
+nc_data_reduced_shear_cluster_mass_get_nnodes (NcDataReducedShearClusterMass *drs)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	
+	return self->nnodes;
+}
+
+/**
+ * nc_data_reduced_shear_cluster_mass_set_nthreads:
+ * @drs: a #NcDataReducedShearClusterMass
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used to compute the likelihood, 
+ * when @nthreads is larger than one the galaxies are split in
+ * blocks and evaluated in the thread pool.
+ * 
+ */
+void 
+nc_data_reduced_shear_cluster_mass_set_nthreads (NcDataReducedShearClusterMass *drs, const guint nthreads)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	
+	self->nthreads = nthreads;
+}
+
+/**
+ * nc_data_reduced_shear_cluster_mass_get_nthreads:
+ * @drs: a #NcDataReducedShearClusterMass
+ * 
+ * Returns: the number of threads used to compute the likelihood.
+ */
+guint 
+nc_data_reduced_shear_cluster_mass_get_nthreads (NcDataReducedShearClusterMass *drs)
+{
+	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	
+	return self->nthreads;
+}
+
 #ifdef HAVE_HDF5
 typedef struct _NcmHDF5Table
 {
@@ -690,7 +1124,7 @@ ncm_hdf5_table_has_col (NcmHDF5Table *h5tb, const gchar *col)
 }
 
 void
-ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector **vec)
+ncm_hdf5_table_read_col_chunk_as_vec (NcmHDF5Table *h5tb, const gchar *col, const hsize_t start, const hsize_t nrecords, NcmVector **vec)
 {
 	size_t field_sizes_sd[1] = { sizeof (gdouble) };
 	size_t field_offset[1]   = { 0 };
@@ -698,11 +1132,13 @@ ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector
 	guint _cindex = 0;
 	gint cindex;
 	gint mi, ret;
+
+	g_assert_cmpuint (start + nrecords, <=, h5tb->nrecords);
 	
-	if (*vec != NULL)
-		g_assert_cmpuint (ncm_vector_len (*vec), ==, h5tb->nrecords);
-	else
-		*vec = ncm_vector_new (h5tb->nrecords);
+	if ((*vec != NULL) && (ncm_vector_len (*vec) != nrecords))
+		ncm_vector_clear (vec);
+	if (*vec == NULL)
+		*vec = ncm_vector_new (nrecords);
 
 	mi      = H5Tget_member_index (h5tb->table_h5t, col);
 	mtype   = H5Tget_member_type (h5tb->table_h5t, mi);
@@ -720,13 +1156,13 @@ ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector
 		GArray *tmp = g_array_new (FALSE, FALSE, sizeof (gfloat)); 
 		gint i;
 		
-		g_array_set_size (tmp, h5tb->nrecords);
+		g_array_set_size (tmp, nrecords);
 
 		field_sizes_sd[0] = sizeof (gfloat);
-		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (gfloat), field_offset, field_sizes_sd, tmp->data);
+		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (gfloat), field_offset, field_sizes_sd, tmp->data);
 		g_assert_cmpint (ret, !=, -1);
 
-		for (i = 0; i < h5tb->nrecords; i++)
+		for (i = 0; i < nrecords; i++)
 		{
 			ncm_vector_set (*vec, i, g_array_index (tmp, gfloat, i));
 		}
@@ -737,7 +1173,7 @@ ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector
 	{
 		g_assert_cmpint (H5Tequal (mntype, H5T_NATIVE_DOUBLE), >, 0);
 
-		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (gdouble), field_offset, field_sizes_sd, ncm_vector_data (*vec));
+		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (gdouble), field_offset, field_sizes_sd, ncm_vector_data (*vec));
 		g_assert_cmpint (ret, !=, -1);
 	}
 
@@ -749,7 +1185,16 @@ ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector
 }
 
 void
-ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArray **a)
+ncm_hdf5_table_read_col_as_vec (NcmHDF5Table *h5tb, const gchar *col, NcmVector **vec)
+{
+	if (*vec != NULL)
+		g_assert_cmpuint (ncm_vector_len (*vec), ==, h5tb->nrecords);
+
+	ncm_hdf5_table_read_col_chunk_as_vec (h5tb, col, 0, h5tb->nrecords, vec);
+}
+
+void
+ncm_hdf5_table_read_col_chunk_as_longarray (NcmHDF5Table *h5tb, const gchar *col, const hsize_t start, const hsize_t nrecords, GArray **a)
 {
 	size_t field_sizes_sd[1] = { sizeof (glong) };
 	size_t field_offset[1]   = { 0 };
@@ -757,15 +1202,17 @@ ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArr
 	guint _cindex = 0;
 	gint cindex;
 	gint mi, ret;
+
+	g_assert_cmpuint (start + nrecords, <=, h5tb->nrecords);
 	
 	if (*a != NULL)
 	{
-		g_array_set_size (*a, h5tb->nrecords);
+		g_array_set_size (*a, nrecords);
 	}
 	else
 	{
 		*a = g_array_new (TRUE, TRUE, sizeof (glong));
-		g_array_set_size (*a, h5tb->nrecords);
+		g_array_set_size (*a, nrecords);
 	}
 
 	mi      = H5Tget_member_index (h5tb->table_h5t, col);
@@ -784,14 +1231,13 @@ ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArr
 		GArray *tmp = g_array_new (TRUE, TRUE, sizeof (gint)); 
 		gint i;
 
-		g_array_set_size (tmp, h5tb->nrecords);
+		g_array_set_size (tmp, nrecords);
 
-		//printf ("name '%s', nrecords %llu\n", h5tb->name, h5tb->nrecords);
 		field_sizes_sd[0] = sizeof (gint);
-		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (gint), field_offset, field_sizes_sd, tmp->data);
+		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (gint), field_offset, field_sizes_sd, tmp->data);
 		g_assert_cmpint (ret, !=, -1);
 
-		for (i = 0; i < h5tb->nrecords; i++)
+		for (i = 0; i < nrecords; i++)
 		{
 			g_array_index (*a, glong, i) = g_array_index (tmp, gint, i);
 		}
@@ -802,7 +1248,7 @@ ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArr
 	{
 		g_assert_cmpint (H5Tequal (mntype, H5T_NATIVE_LONG), >, 0);
 		
-		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (glong), field_offset, field_sizes_sd, (*a)->data);
+		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (glong), field_offset, field_sizes_sd, (*a)->data);
 	  g_assert_cmpint (ret, !=, -1);
 	}
 
@@ -813,7 +1259,13 @@ ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArr
 }
 
 void
-ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix **mat)
+ncm_hdf5_table_read_col_as_longarray (NcmHDF5Table *h5tb, const gchar *col, GArray **a)
+{
+	ncm_hdf5_table_read_col_chunk_as_longarray (h5tb, col, 0, h5tb->nrecords, a);
+}
+
+void
+ncm_hdf5_table_read_col_chunk_as_mat (NcmHDF5Table *h5tb, const gchar *col, const hsize_t start, const hsize_t nrecords, NcmMatrix **mat)
 {
 	size_t field_offset[1] = { 0 };
 	size_t field_sizes_sd[1];
@@ -823,6 +1275,8 @@ ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix
 	gint mi, ret;
 	H5T_class_t mtype_class;
 	hsize_t ncols;
+
+	g_assert_cmpuint (start + nrecords, <=, h5tb->nrecords);
 	
 	mi          = H5Tget_member_index (h5tb->table_h5t, col);
 	mtype       = H5Tget_member_type (h5tb->table_h5t, mi);
@@ -840,11 +1294,12 @@ ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix
 	
 	if (*mat != NULL)
 	{
-		g_assert_cmpuint (ncm_matrix_nrows (*mat), ==, h5tb->nrecords);
 		g_assert_cmpuint (ncm_matrix_ncols (*mat), ==, ncols);
+		if (ncm_matrix_nrows (*mat) != nrecords)
+			ncm_matrix_clear (mat);
 	}
-	else
-		*mat = ncm_matrix_new (h5tb->nrecords, ncols);
+	if (*mat == NULL)
+		*mat = ncm_matrix_new (nrecords, ncols);
 
 	if (!g_ptr_array_find_with_equal_func (h5tb->field_names, col, g_str_equal, &_cindex))
 		g_error ("ncm_hdf5_table_read_col_as_mat: column `%s' not found in table `%s'.", col, h5tb->name);
@@ -857,13 +1312,13 @@ ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix
 		GArray *tmp = g_array_new (FALSE, FALSE, sizeof (gfloat)); 
 		gint i;
 		
-		g_array_set_size (tmp, h5tb->nrecords * ncols);
+		g_array_set_size (tmp, nrecords * ncols);
 
 		field_sizes_sd[0] = sizeof (gfloat) * ncols;
-		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (gfloat) * ncols, field_offset, field_sizes_sd, tmp->data);
+		ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (gfloat) * ncols, field_offset, field_sizes_sd, tmp->data);
 		g_assert_cmpint (ret, !=, -1);
 
-		for (i = 0; i < h5tb->nrecords; i++)
+		for (i = 0; i < nrecords; i++)
 		{
 			gint j;
 			gfloat *row = &g_array_index (tmp, gfloat, i * ncols);
@@ -880,7 +1335,7 @@ ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix
 		g_assert_cmpint (H5Tequal (mntype, H5T_NATIVE_DOUBLE), >, 0);
 
 	  field_sizes_sd[0] = sizeof (gdouble) * ncols;
-	  ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, 0, h5tb->nrecords, sizeof (gdouble) * ncols, field_offset, field_sizes_sd, ncm_matrix_data (*mat));
+	  ret = H5TBread_fields_index (h5tb->h5f, h5tb->name, 1, &cindex, start, nrecords, sizeof (gdouble) * ncols, field_offset, field_sizes_sd, ncm_matrix_data (*mat));
 	  g_assert_cmpint (ret, !=, -1);
 	}
 
@@ -894,6 +1349,15 @@ ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix
 	g_assert_cmpint (ret, !=, -1);
 }
 
+void
+ncm_hdf5_table_read_col_as_mat (NcmHDF5Table *h5tb, const gchar *col, NcmMatrix **mat)
+{
+	if (*mat != NULL)
+		g_assert_cmpuint (ncm_matrix_nrows (*mat), ==, h5tb->nrecords);
+
+	ncm_hdf5_table_read_col_chunk_as_mat (h5tb, col, 0, h5tb->nrecords, mat);
+}
+
 void
 ncm_hdf5_table_read_col_as_fixstr (NcmHDF5Table *h5tb, const gchar *col, GArray **a)
 {
@@ -962,12 +1426,53 @@ _g_long_hash (gconstpointer v)
  * Loads from a HDF5 file the data, filters by @ftype when available, using
  * the cluster information in @z_cluster, @ra_cluster and @dec_cluster.
  * 
+ * This is equivalent to nc_data_reduced_shear_cluster_mass_load_hdf5_cut()
+ * without cuts, i.e., with infinite ranges, in which case galaxies with a 
+ * negative or non-finite Z_BEST are also kept.
+ * 
  */
 void 
 nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs, const gchar *hdf5_file, const gchar ftype, const gdouble z_cluster, const gdouble ra_cluster, const gdouble dec_cluster)
+{
+	nc_data_reduced_shear_cluster_mass_load_hdf5_cut (drs, hdf5_file, ftype, z_cluster, ra_cluster, dec_cluster, GSL_NEGINF, GSL_POSINF, GSL_NEGINF, GSL_POSINF);
+}
+
+/**
+ * nc_data_reduced_shear_cluster_mass_load_hdf5_cut:
+ * @drs: a #NcDataReducedShearClusterMass
+ * @hdf5_file: a file containing #NcDataReducedShearClusterMass data
+ * @ftype: filter type ('u', 'g', 'r', 'i', 'z')
+ * @z_cluster: cluster redshift
+ * @ra_cluster: cluster RA
+ * @dec_cluster: cluster DEC
+ * @r_arcmin_min: minimum angular distance to the cluster center (arcmin)
+ * @r_arcmin_max: maximum angular distance to the cluster center (arcmin)
+ * @z_best_min: minimum best fit photometric redshift
+ * @z_best_max: maximum best fit photometric redshift
+ * 
+ * Loads from a HDF5 file the data, filters by @ftype when available, using
+ * the cluster information in @z_cluster, @ra_cluster and @dec_cluster.
+ * 
+ * The photometric redshift table is read in chunks, column by column, and
+ * the galaxies outside the angular distance range [@r_arcmin_min, @r_arcmin_max]
+ * or whose Z_BEST is outside [@z_best_min, @z_best_max] are discarded while 
+ * streaming. A range with both limits infinite disables the corresponding
+ * cut, so that galaxies with a non-finite Z_BEST are discarded only when 
+ * the Z_BEST range is finite. The photo-z distributions of the remaining 
+ * galaxies are stored in a single packed table (see 
+ * #NcDataReducedShearClusterMass:pz-z and related properties) instead of 
+ * one #NcGalaxyRedshift object per galaxy.
+ * 
+ * It is an error if no galaxy survives the cuts.
+ * 
+ */
+void 
+nc_data_reduced_shear_cluster_mass_load_hdf5_cut (NcDataReducedShearClusterMass *drs, const gchar *hdf5_file, const gchar ftype, const gdouble z_cluster, const gdouble ra_cluster, const gdouble dec_cluster, const gdouble r_arcmin_min, const gdouble r_arcmin_max, const gdouble z_best_min, const gdouble z_best_max)
 {
 #ifdef HAVE_HDF5
 	NcDataReducedShearClusterMassPrivate * const self = drs->priv;
+	const gboolean cut_r  = gsl_finite (r_arcmin_min) || gsl_finite (r_arcmin_max);
+	const gboolean cut_zb = gsl_finite (z_best_min) || gsl_finite (z_best_max);
 	GHashTable *fdata     = g_hash_table_new_full (_g_long_hash, _g_long_equal, NULL, NULL); 
 	NcmVector *vecs[5]    = {NULL, NULL, NULL, NULL, NULL};
 	NcmMatrix *mats[2]    = {NULL, NULL};
@@ -976,8 +1481,13 @@ nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs
 	GArray *photz_id      = NULL;
 	GArray *filter        = NULL;
 	GArray *gal_obs_array = NULL;
+	GArray *pz_z          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	GArray *pz_pdf        = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	GArray *pz_z_best     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	GArray *pz_nknots     = g_array_new (FALSE, FALSE, sizeof (gdouble));
 	NcmHDF5Table *photz_table;
 	NcmHDF5Table *gal_table;
+	hsize_t start;
 	hid_t h5f;
 	herr_t ret;
 	gint i;
@@ -1054,141 +1564,125 @@ nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs
 	}
 
 	{
-		const gchar *cols[]  = {"Z_BEST"};
-		const gchar *acols[] = {"zbins", "pdz"};
-		for (i = 0; i < 1; i++)
-		{
-			vecs[i+4] = NULL;
-			ncm_hdf5_table_read_col_as_vec (photz_table, cols[i], &vecs[i+4]);
-		}
-		for (i = 0; i < 2; i++)
-		{
-			mats[i] = NULL;
-			ncm_hdf5_table_read_col_as_mat (photz_table, acols[i], &mats[i]);
-		}
+		const gchar *photz_id_col = NULL;
 
 		if (ncm_hdf5_table_has_col (photz_table, "id"))
-			ncm_hdf5_table_read_col_as_longarray (photz_table, "id", &photz_id);
+			photz_id_col = "id";
 		else if (ncm_hdf5_table_has_col (photz_table, "objectId"))
-			ncm_hdf5_table_read_col_as_longarray (photz_table, "objectId", &photz_id);
+			photz_id_col = "objectId";
 		else
 			g_error ("nc_data_reduced_shear_cluster_mass_load_hdf5: cannot find id in photoz table.");
-	}
 
-	g_ptr_array_set_size ((GPtrArray *) self->photoz_array, 0);
-	self->z_cluster   = z_cluster;
-	self->ra_cluster  = ra_cluster;
-	self->dec_cluster = dec_cluster;
-	gal_obs_array     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+		g_ptr_array_set_size ((GPtrArray *) self->photoz_array, 0);
+		self->z_cluster   = z_cluster;
+		self->ra_cluster  = ra_cluster;
+		self->dec_cluster = dec_cluster;
+		gal_obs_array     = g_array_new (FALSE, FALSE, sizeof (gdouble));
 
-	for (i = 0; i < photz_table->nrecords; i++)
-	{
-		glong photz_id_i = g_array_index (photz_id, glong, i);
-		if (!g_hash_table_contains (fdata, &photz_id_i))
-			continue;
-		else
+		/* The photo-z table is streamed in chunks, only the galaxies passing the cuts are kept */
+		for (start = 0; start < photz_table->nrecords; start += _NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_HDF5_CHUNK)
 		{
-			const gint gindex = GPOINTER_TO_INT (g_hash_table_lookup (fdata, &photz_id_i));
-			const gdouble ra  = ncm_vector_get (vecs[0], gindex);
-			const gdouble dec = ncm_vector_get (vecs[1], gindex);
-			const gdouble e1  = ncm_vector_get (vecs[2], gindex);
-			const gdouble e2  = ncm_vector_get (vecs[3], gindex);
-			const gdouble rh  = (rh_vec != NULL) ? ncm_vector_get (rh_vec, gindex) : 0.0;
-			const gdouble zb  = ncm_vector_get (vecs[4], i);
-			const guint ncols = ncm_matrix_ncols (mats[0]);
-
-			gint first_nz     = -1;
-			gint last_nz      = -1;
-			gint j;
+			const hsize_t nchunk = GSL_MIN (_NC_DATA_REDUCED_SHEAR_CLUSTER_MASS_HDF5_CHUNK, photz_table->nrecords - start);
+			guint ncols;
+
+			ncm_hdf5_table_read_col_chunk_as_longarray (photz_table, photz_id_col, start, nchunk, &photz_id);
+			ncm_hdf5_table_read_col_chunk_as_vec (photz_table, "Z_BEST", start, nchunk, &vecs[4]);
+			ncm_hdf5_table_read_col_chunk_as_mat (photz_table, "zbins", start, nchunk, &mats[0]);
+			ncm_hdf5_table_read_col_chunk_as_mat (photz_table, "pdz", start, nchunk, &mats[1]);
 
 			g_assert_cmpuint (ncm_matrix_ncols (mats[0]), ==, ncm_matrix_ncols (mats[1]));
 			g_assert_cmpuint (ncm_matrix_nrows (mats[0]), ==, ncm_matrix_nrows (mats[1]));
+			ncols = ncm_matrix_ncols (mats[0]);
 
-			for (j = 0; j < ncols; j++)
+			for (i = 0; i < nchunk; i++)
 			{
-				const gdouble Pz_j = ncm_matrix_get (mats[1], i, j);
-
-				if (Pz_j > 0.0)
-				{
-					if (first_nz == -1)
-					{
-						first_nz = j;
-					}
-					last_nz = j;
-				}
-			}
-
-			if (first_nz == -1)
-			{
-				g_error ("nc_data_reduced_shear_cluster_mass_load_hdf5: galaxy %d, empty P_z.", i);
-			}
-
-			{
-				NcGalaxyRedshift *gz = NULL;
-				gboolean is_delta = (first_nz == last_nz);
-				if (is_delta)
-				{
-					gz = NC_GALAXY_REDSHIFT (nc_galaxy_redshift_spec_new (zb));
-				}
+				glong photz_id_i = g_array_index (photz_id, glong, i);
+				if (!g_hash_table_contains (fdata, &photz_id_i))
+					continue;
 				else
 				{
-					NcmVector *zv               = ncm_matrix_get_row (mats[0], i);
-					NcmVector *Pzv              = ncm_matrix_get_row (mats[1], i);
-					NcGalaxyRedshiftSpline *gzs = nc_galaxy_redshift_spline_new ();
-
-					gz = NC_GALAXY_REDSHIFT (gzs);
-					
-					nc_galaxy_redshift_spline_init_from_vectors (gzs, zv, Pzv);
-					
-					ncm_vector_clear (&zv);
-					ncm_vector_clear (&Pzv);
-				}
+					const gint gindex = GPOINTER_TO_INT (g_hash_table_lookup (fdata, &photz_id_i));
+					const gdouble ra  = ncm_vector_get (vecs[0], gindex);
+					const gdouble dec = ncm_vector_get (vecs[1], gindex);
+					const gdouble e1  = ncm_vector_get (vecs[2], gindex);
+					const gdouble e2  = ncm_vector_get (vecs[3], gindex);
+					const gdouble rh  = (rh_vec != NULL) ? ncm_vector_get (rh_vec, gindex) : 0.0;
+					const gdouble zb  = ncm_vector_get (vecs[4], i);
+
+					gint first_nz     = -1;
+					gint last_nz      = -1;
+					gint j;
+
+					for (j = 0; j < ncols; j++)
+					{
+						const gdouble Pz_j = ncm_matrix_get (mats[1], i, j);
 
-				if (gsl_finite (ra) && gsl_finite (dec) && gsl_finite (e1) && gsl_finite (e2))
-				{
-					const gdouble r_arcmin = ncm_util_great_circle_distance (ra, dec, ra_cluster, dec_cluster) * 60.0;
-					const gdouble posangle = -(0.5 * M_PI - ncm_util_position_angle (ra, dec, ra_cluster, dec_cluster));
-					const gdouble cos2phi  = cos (2.0 * posangle);
-					const gdouble sin2phi  = sin (2.0 * posangle);
-					const gdouble g_obs    = - (e1 * cos2phi + e2 * sin2phi); 
-					
-					ncm_obj_array_add (self->photoz_array, G_OBJECT (gz));
-
-					g_array_append_val (gal_obs_array, r_arcmin);
-					g_array_append_val (gal_obs_array, g_obs);
-					if (rh_vec != NULL)
-						g_array_append_val (gal_obs_array, rh);
-				}
+						if (Pz_j > 0.0)
+						{
+							if (first_nz == -1)
+							{
+								first_nz = j;
+							}
+							last_nz = j;
+						}
+					}
 
-				if (FALSE)
-				{
-					printf ("[%ld %ld] % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g %5d %5d", 
-					        g_array_index (gal_id, glong, gindex), 
-					        g_array_index (photz_id, glong, i), 
-					        ra, dec, e1, e2, zb, first_nz, last_nz);
+					if (first_nz == -1)
+					{
+						g_error ("nc_data_reduced_shear_cluster_mass_load_hdf5: galaxy %lld, empty P_z.", (long long) (start + i));
+					}
 
-					if (nc_galaxy_redshift_has_dist (gz))
+					if (gsl_finite (ra) && gsl_finite (dec) && gsl_finite (e1) && gsl_finite (e2) && (!cut_zb || ((zb >= z_best_min) && (zb <= z_best_max))))
 					{
-						printf (" DISTR Z_BEST % 22.15g NINTERVALS %d", nc_galaxy_redshift_mode (gz), nc_galaxy_redshift_nintervals (gz));
-						if (nc_galaxy_redshift_nintervals (gz) > 1)
+						const gdouble r_arcmin = ncm_util_great_circle_distance (ra, dec, ra_cluster, dec_cluster) * 60.0;
+
+						if (!cut_r || ((r_arcmin >= r_arcmin_min) && (r_arcmin <= r_arcmin_max)))
 						{
-							gint k;
-							for (k = 0; k < nc_galaxy_redshift_nintervals (gz); k++)
+							const gdouble posangle = -(0.5 * M_PI - ncm_util_position_angle (ra, dec, ra_cluster, dec_cluster));
+							const gdouble cos2phi  = cos (2.0 * posangle);
+							const gdouble sin2phi  = sin (2.0 * posangle);
+							const gdouble g_obs    = - (e1 * cos2phi + e2 * sin2phi); 
+							gdouble nknots         = 0.0;
+
+							/* 
+							 * Delta distributions are represented by Z_BEST only, otherwise only
+							 * the non-zero part of P_z is kept, including the two zero knots 
+							 * bracketing it (the only ones used by NcGalaxyRedshiftSpline).
+							 */
+							if (first_nz != last_nz)
 							{
-								printf (" % 22.15g", nc_galaxy_redshift_interval_weight (gz, k));
+								const gint k_i = GSL_MAX (first_nz - 1, 0);
+								const gint k_f = GSL_MIN (last_nz + 1, ncols - 1);
+
+								for (j = k_i; j <= k_f; j++)
+								{
+									const gdouble z_j  = ncm_matrix_get (mats[0], i, j);
+									const gdouble Pz_j = ncm_matrix_get (mats[1], i, j);
+
+									g_array_append_val (pz_z, z_j);
+									g_array_append_val (pz_pdf, Pz_j);
+								}
+								nknots = k_f - k_i + 1;
 							}
+
+							g_array_append_val (pz_z_best, zb);
+							g_array_append_val (pz_nknots, nknots);
+
+							g_array_append_val (gal_obs_array, r_arcmin);
+							g_array_append_val (gal_obs_array, g_obs);
+							if (rh_vec != NULL)
+								g_array_append_val (gal_obs_array, rh);
 						}
-						printf ("\n");
 					}
-					else
-						printf (" DELTA Z_BEST % 22.15g\n", nc_galaxy_redshift_mode (gz));
 				}
-
-				nc_galaxy_redshift_free (gz);
 			}
 		}
 	}
 
+	if (pz_z_best->len == 0)
+		g_error ("nc_data_reduced_shear_cluster_mass_load_hdf5: no galaxy left in `%s' after the cuts r_arcmin in [% 22.15g, % 22.15g] and Z_BEST in [% 22.15g, % 22.15g].",
+		         hdf5_file, r_arcmin_min, r_arcmin_max, z_best_min, z_best_max);
+
 	ncm_matrix_clear (&self->gal_obs);
 	if (rh_vec != NULL)
 	{
@@ -1200,8 +1694,19 @@ nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs
 		self->gal_obs = ncm_matrix_new_array (gal_obs_array, 2);
 		self->has_rh  = FALSE;
 	}
+
+	ncm_vector_clear (&self->pz_z);
+	ncm_vector_clear (&self->pz_pdf);
+	ncm_vector_clear (&self->pz_z_best);
+	ncm_vector_clear (&self->pz_nknots);
+
+	self->pz_z      = (pz_z->len > 0)   ? ncm_vector_new_array (pz_z)   : NULL;
+	self->pz_pdf    = (pz_pdf->len > 0) ? ncm_vector_new_array (pz_pdf) : NULL;
+	self->pz_z_best = ncm_vector_new_array (pz_z_best);
+	self->pz_nknots = ncm_vector_new_array (pz_nknots);
 	
-	g_assert_cmpuint (self->photoz_array->len, ==, ncm_matrix_nrows (self->gal_obs));
+	g_assert_cmpuint (ncm_vector_len (self->pz_z_best), ==, ncm_matrix_nrows (self->gal_obs));
+	self->nodes_ok = FALSE;
 
 	ncm_data_set_init (NCM_DATA (drs), TRUE);
 	
@@ -1220,6 +1725,10 @@ nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs
 	g_array_unref (gal_id);
 	g_array_unref (photz_id);
 	g_array_unref (gal_obs_array);
+	g_array_unref (pz_z);
+	g_array_unref (pz_pdf);
+	g_array_unref (pz_z_best);
+	g_array_unref (pz_nknots);
 	if (filter != NULL)
 		g_array_unref (filter);
 
@@ -84,8 +84,13 @@ void nc_data_reduced_shear_cluster_mass_free (NcDataReducedShearClusterMass *drs
 void nc_data_reduced_shear_cluster_mass_clear (NcDataReducedShearClusterMass **drs);
 
 void nc_data_reduced_shear_cluster_mass_set_dist (NcDataReducedShearClusterMass *drs, NcDistance *dist);
+void nc_data_reduced_shear_cluster_mass_set_nnodes (NcDataReducedShearClusterMass *drs, const guint nnodes);
+guint nc_data_reduced_shear_cluster_mass_get_nnodes (NcDataReducedShearClusterMass *drs);
+void nc_data_reduced_shear_cluster_mass_set_nthreads (NcDataReducedShearClusterMass *drs, const guint nthreads);
+guint nc_data_reduced_shear_cluster_mass_get_nthreads (NcDataReducedShearClusterMass *drs);
 
 void nc_data_reduced_shear_cluster_mass_load_hdf5 (NcDataReducedShearClusterMass *drs, const gchar *hdf5_file, const gchar ftype, const gdouble z_cluster, const gdouble ra_cluster, const gdouble dec_cluster);
+void nc_data_reduced_shear_cluster_mass_load_hdf5_cut (NcDataReducedShearClusterMass *drs, const gchar *hdf5_file, const gchar ftype, const gdouble z_cluster, const gdouble ra_cluster, const gdouble dec_cluster, const gdouble r_arcmin_min, const gdouble r_arcmin_max, const gdouble z_best_min, const gdouble z_best_max);
 
 G_END_DECLS
 
@@ -63,6 +63,11 @@
  * Usually $z_{lens} = z_{cluster}, but we define these as two different arguments in order to handle cases where shear signal has been 
  * rescaled to a different cluster redshift (following D. Applegate's code.).
  * 
+ * The functions nc_wl_surface_mass_density_sigma_array(), nc_wl_surface_mass_density_sigma_mean_array(), 
+ * nc_wl_surface_mass_density_reduced_shear_array() and nc_wl_surface_mass_density_reduced_shear_infinity_array() 
+ * evaluate the same quantities over arrays of radii and redshifts, reusing the redshift dependent quantities for 
+ * consecutive entries sharing the same redshifts.
+ * 
  */
 
 #ifdef HAVE_CONFIG_H
@@ -318,6 +323,33 @@ nc_wl_surface_mass_density_prepare_if_needed (NcWLSurfaceMassDensity *smd, NcHIC
     nc_wl_surface_mass_density_prepare (smd, cosmo);
 }
 
+typedef struct _NcWLSurfaceMassDensityEval
+{
+	gdouble zc;
+	gdouble rs;
+} NcWLSurfaceMassDensityEval;
+
+static void
+_nc_wl_surface_mass_density_eval_set_zc (NcDensityProfile *dp, NcHICosmo *cosmo, const gdouble zc, NcWLSurfaceMassDensityEval *ev)
+{
+	if (zc != ev->zc)
+	{
+		ev->zc = zc;
+		ev->rs = nc_density_profile_scale_radius (dp, cosmo, zc);
+	}
+}
+
+static void
+_nc_wl_surface_mass_density_eval_sigma (NcDensityProfile *dp, NcHICosmo *cosmo, NcWLSurfaceMassDensityEval *ev, const gdouble R, gdouble *sigma, gdouble *sigma_mean)
+{
+	const gdouble x = R / ev->rs;
+
+	if (sigma != NULL)
+		sigma[0] = 2.0 * nc_density_profile_integral_density_los (dp, cosmo, R, ev->zc);
+	if (sigma_mean != NULL)
+		sigma_mean[0] = (2.0 / (x * x)) * nc_density_profile_integral_density_2d (dp, cosmo, R, ev->zc);
+}
+
 /**
  * nc_wl_surface_mass_density_sigma_critical:
  * @smd: a #NcWLSurfaceMassDensity
@@ -597,3 +629,175 @@ nc_wl_surface_mass_density_reduced_shear_infinity (NcWLSurfaceMassDensity *smd,
 	
 	return g;
 }
+
+/**
+ * nc_wl_surface_mass_density_sigma_array:
+ * @smd: a #NcWLSurfaceMassDensity
+ * @dp: a #NcDensityProfile  
+ * @cosmo: a #NcHICosmo
+ * @R: a #NcmVector containing the projected radii
+ * @zc: a #NcmVector containing the cluster redshifts
+ * @res: a #NcmVector to store the results
+ *
+ * Computes the surface mass density $\Sigma (R_i)$ for each pair $(R_i, z_{c,i})$, 
+ * see nc_wl_surface_mass_density_sigma().
+ *
+ */
+void
+nc_wl_surface_mass_density_sigma_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zc, NcmVector *res)
+{
+	const guint len = ncm_vector_len (R);
+	NcWLSurfaceMassDensityEval ev = {GSL_NAN, 0.0};
+	guint i;
+
+	g_assert_cmpuint (ncm_vector_len (zc), ==, len);
+	g_assert_cmpuint (ncm_vector_len (res), ==, len);
+
+	for (i = 0; i < len; i++)
+	{
+		gdouble sigma;
+
+		_nc_wl_surface_mass_density_eval_set_zc (dp, cosmo, ncm_vector_get (zc, i), &ev);
+		_nc_wl_surface_mass_density_eval_sigma (dp, cosmo, &ev, ncm_vector_get (R, i), &sigma, NULL);
+
+		ncm_vector_set (res, i, sigma);
+	}
+}
+
+/**
+ * nc_wl_surface_mass_density_sigma_mean_array:
+ * @smd: a #NcWLSurfaceMassDensity
+ * @dp: a #NcDensityProfile  
+ * @cosmo: a #NcHICosmo
+ * @R: a #NcmVector containing the projected radii
+ * @zc: a #NcmVector containing the cluster redshifts
+ * @res: a #NcmVector to store the results
+ *
+ * Computes the mean surface mass density $\overline{\Sigma} (<R_i)$ for each pair $(R_i, z_{c,i})$, 
+ * see nc_wl_surface_mass_density_sigma_mean().
+ *
+ */
+void
+nc_wl_surface_mass_density_sigma_mean_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zc, NcmVector *res)
+{
+	const guint len = ncm_vector_len (R);
+	NcWLSurfaceMassDensityEval ev = {GSL_NAN, 0.0};
+	guint i;
+
+	g_assert_cmpuint (ncm_vector_len (zc), ==, len);
+	g_assert_cmpuint (ncm_vector_len (res), ==, len);
+
+	for (i = 0; i < len; i++)
+	{
+		gdouble sigma_mean;
+
+		_nc_wl_surface_mass_density_eval_set_zc (dp, cosmo, ncm_vector_get (zc, i), &ev);
+		_nc_wl_surface_mass_density_eval_sigma (dp, cosmo, &ev, ncm_vector_get (R, i), NULL, &sigma_mean);
+
+		ncm_vector_set (res, i, sigma_mean);
+	}
+}
+
+/**
+ * nc_wl_surface_mass_density_reduced_shear_array:
+ * @smd: a #NcWLSurfaceMassDensity
+ * @dp: a #NcDensityProfile  
+ * @cosmo: a #NcHICosmo
+ * @R: a #NcmVector containing the projected radii
+ * @zs: a #NcmVector containing the source redshifts
+ * @zl: a #NcmVector containing the lens redshifts
+ * @zc: a #NcmVector containing the cluster redshifts
+ * @res: a #NcmVector to store the results
+ *
+ * Computes the reduced shear $g(R_i)$ for each entry of the input arrays, 
+ * see nc_wl_surface_mass_density_reduced_shear(). The surface mass density
+ * and its mean are computed only once per entry.
+ *
+ */
+void
+nc_wl_surface_mass_density_reduced_shear_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zs, NcmVector *zl, NcmVector *zc, NcmVector *res)
+{
+	const guint len = ncm_vector_len (R);
+	NcWLSurfaceMassDensityEval ev = {GSL_NAN, 0.0};
+	guint i;
+
+	g_assert_cmpuint (ncm_vector_len (zs), ==, len);
+	g_assert_cmpuint (ncm_vector_len (zl), ==, len);
+	g_assert_cmpuint (ncm_vector_len (zc), ==, len);
+	g_assert_cmpuint (ncm_vector_len (res), ==, len);
+
+	for (i = 0; i < len; i++)
+	{
+		const gdouble zc_i       = ncm_vector_get (zc, i);
+		const gdouble sigma_crit = nc_wl_surface_mass_density_sigma_critical (smd, cosmo, ncm_vector_get (zs, i), ncm_vector_get (zl, i), zc_i);
+		gdouble sigma, sigma_mean;
+
+		_nc_wl_surface_mass_density_eval_set_zc (dp, cosmo, zc_i, &ev);
+		_nc_wl_surface_mass_density_eval_sigma (dp, cosmo, &ev, ncm_vector_get (R, i), &sigma, &sigma_mean);
+
+		ncm_vector_set (res, i, (sigma_mean - sigma) / (sigma_crit - sigma));
+	}
+}
+
+/**
+ * nc_wl_surface_mass_density_reduced_shear_infinity_array:
+ * @smd: a #NcWLSurfaceMassDensity
+ * @dp: a #NcDensityProfile  
+ * @cosmo: a #NcHICosmo
+ * @R: a #NcmVector containing the projected radii
+ * @zs: a #NcmVector containing the source redshifts
+ * @zl: a #NcmVector containing the lens redshifts
+ * @zc: a #NcmVector containing the cluster redshifts
+ * @res: a #NcmVector to store the results
+ *
+ * Computes the reduced shear $g(R_i)$ for each entry of the input arrays using a 
+ * lensed source at infinite redshift, see nc_wl_surface_mass_density_reduced_shear_infinity().
+ * The distances to infinity are computed once per distinct consecutive lens redshift.
+ *
+ */
+void
+nc_wl_surface_mass_density_reduced_shear_infinity_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zs, NcmVector *zl, NcmVector *zc, NcmVector *res)
+{
+	const guint len        = ncm_vector_len (R);
+	const gdouble a        = ncm_c_c2 () / (4.0 * M_PI * ncm_c_G_mass_solar ()) * ncm_c_Mpc ();
+	const gdouble RH_Mpc   = nc_hicosmo_RH_Mpc (cosmo);
+	const gdouble Dinf     = nc_distance_transverse_z_to_infinity (smd->dist, cosmo, 0.0);
+	gdouble zl_last        = GSL_NAN;
+	gdouble Dt_l           = 0.0;
+	gdouble betainf        = 0.0;
+	gdouble sigma_crit_inf = 0.0;
+	NcWLSurfaceMassDensityEval ev = {GSL_NAN, 0.0};
+	guint i;
+
+	g_assert_cmpuint (ncm_vector_len (zs), ==, len);
+	g_assert_cmpuint (ncm_vector_len (zl), ==, len);
+	g_assert_cmpuint (ncm_vector_len (zc), ==, len);
+	g_assert_cmpuint (ncm_vector_len (res), ==, len);
+
+	for (i = 0; i < len; i++)
+	{
+		const gdouble zs_i = ncm_vector_get (zs, i);
+		const gdouble zl_i = ncm_vector_get (zl, i);
+		gdouble sigma, sigma_mean, Ds, Dls, beta_s;
+
+		if (zl_i != zl_last)
+		{
+			const gdouble Dl    = nc_distance_angular_diameter (smd->dist, cosmo, zl_i);
+			const gdouble Dlinf = nc_distance_transverse_z_to_infinity (smd->dist, cosmo, zl_i);
+
+			zl_last        = zl_i;
+			Dt_l           = nc_distance_transverse (smd->dist, cosmo, zl_i);
+			betainf        = Dlinf / Dinf;
+			sigma_crit_inf = a * Dinf / (Dl * Dlinf * RH_Mpc);
+		}
+
+		Ds     = nc_distance_angular_diameter (smd->dist, cosmo, zs_i);
+		Dls    = (nc_distance_transverse (smd->dist, cosmo, zs_i) - Dt_l) / (1.0 + zs_i);
+		beta_s = (Dls / Ds) / betainf;
+
+		_nc_wl_surface_mass_density_eval_set_zc (dp, cosmo, ncm_vector_get (zc, i), &ev);
+		_nc_wl_surface_mass_density_eval_sigma (dp, cosmo, &ev, ncm_vector_get (R, i), &sigma, &sigma_mean);
+
+		ncm_vector_set (res, i, beta_s * (sigma_mean - sigma) / (sigma_crit_inf - beta_s * sigma));
+	}
+}
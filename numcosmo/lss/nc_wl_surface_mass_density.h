@@ -32,6 +32,7 @@
 #include <numcosmo/nc_distance.h>
 #include <numcosmo/lss/nc_density_profile.h>
 #include <numcosmo/math/ncm_ode_spline.h>
+#include <numcosmo/math/ncm_vector.h>
 #include <numcosmo/math/ncm_model.h>
 #include <numcosmo/math/ncm_model_ctrl.h>
 
@@ -107,6 +108,11 @@ gdouble nc_wl_surface_mass_density_shear_infinity (NcWLSurfaceMassDensity *smd,
 gdouble nc_wl_surface_mass_density_reduced_shear (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, const gdouble R, const gdouble zs, const gdouble zl, const gdouble zc);
 gdouble nc_wl_surface_mass_density_reduced_shear_infinity (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, const gdouble R, const gdouble zs, const gdouble zl, const gdouble zc);
 
+void nc_wl_surface_mass_density_sigma_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zc, NcmVector *res);
+void nc_wl_surface_mass_density_sigma_mean_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zc, NcmVector *res);
+void nc_wl_surface_mass_density_reduced_shear_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zs, NcmVector *zl, NcmVector *zc, NcmVector *res);
+void nc_wl_surface_mass_density_reduced_shear_infinity_array (NcWLSurfaceMassDensity *smd, NcDensityProfile *dp, NcHICosmo *cosmo, NcmVector *R, NcmVector *zs, NcmVector *zl, NcmVector *zc, NcmVector *res);
+
 G_END_DECLS
 
 #endif /* _NC_WL_SURFACE_MASS_DENSITY_INLINE_H_ */
@@ -39,9 +39,11 @@
 
 #include "math/ncm_abc.h"
 #include "math/ncm_func_eval.h"
+#include "math/ncm_c.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_statistics_double.h>
+#include <gsl/gsl_blas.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
 enum
@@ -53,6 +55,8 @@ enum
   PROP_DATASET,
   PROP_EPSILON,
   PROP_NPARTICLES,
+  PROP_ADAPTIVE,
+  PROP_ESS_FRAC,
   PROP_LEN
 };
 
@@ -89,6 +93,11 @@ ncm_abc_init (NcmABC *abc)
   abc->ntotal        = 0;
   abc->naccepted     = 0;
   abc->nupdates      = 0;
+  abc->adaptive      = FALSE;
+  abc->ess_frac      = NCM_ABC_DEFAULT_ESS_FRAC;
+  abc->target_epsilon = 0.0;
+  abc->nsims         = 0;
+  abc->local_LLT     = g_ptr_array_new_with_free_func ((GDestroyNotify) &ncm_matrix_free);
 }
 
 static void
@@ -138,6 +147,12 @@ _ncm_abc_set_property (GObject *object, guint prop_id, const GValue *value, GPar
       g_assert_not_reached ();
       abc->nparticles = g_value_get_uint (value);
       break;
+    case PROP_ADAPTIVE:
+      ncm_abc_set_adaptive (abc, g_value_get_boolean (value));
+      break;
+    case PROP_ESS_FRAC:
+      ncm_abc_set_ess_frac (abc, g_value_get_double (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -170,6 +185,12 @@ _ncm_abc_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec
     case PROP_NPARTICLES:
       g_value_set_uint (value, abc->nparticles);
       break;
+    case PROP_ADAPTIVE:
+      g_value_set_boolean (value, abc->adaptive);
+      break;
+    case PROP_ESS_FRAC:
+      g_value_set_double (value, abc->ess_frac);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -197,6 +218,7 @@ _ncm_abc_dispose (GObject *object)
   g_clear_pointer (&abc->weights_tm1, g_array_unref);
   g_clear_pointer (&abc->dists, g_array_unref);
   g_clear_pointer (&abc->wran, gsl_ran_discrete_free);
+  g_clear_pointer (&abc->local_LLT, g_ptr_array_unref);
 
   if (abc->mp != NULL)
   {
@@ -271,6 +293,20 @@ ncm_abc_class_init (NcmABCClass *klass)
                                                       "Number of particles",
                                                       0, G_MAXUINT, 100,
                                                       G_PARAM_READABLE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_ADAPTIVE,
+                                   g_param_spec_boolean ("adaptive",
+                                                         NULL,
+                                                         "Whether to use the adaptive population updates",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_ESS_FRAC,
+                                   g_param_spec_double ("ess-frac",
+                                                        NULL,
+                                                        "Fraction of the effective sample size kept by each epsilon update",
+                                                        0.0, 1.0, NCM_ABC_DEFAULT_ESS_FRAC,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -590,6 +626,114 @@ ncm_abc_get_depsilon (NcmABC *abc)
   return abc->depsilon;
 }
 
+/**
+ * ncm_abc_set_adaptive:
+ * @abc: a #NcmABC
+ * @adaptive: whether to use the adaptive population updates
+ * 
+ * When @adaptive is TRUE the particle updates no longer use the transition
+ * kernel and the epsilon update of the subclass. Instead, each update
+ * chooses the new tolerance such that the particles of the previous
+ * population with distance below it keep a fraction
+ * #NcmABC:ess-frac of the effective sample size (ESS), the surviving
+ * particles have their weights recycled as the mixture weights of the
+ * proposal, and each of them is perturbed by a Gaussian with its own
+ * locally adapted covariance
+ * $\Sigma_j = \sum_k \tilde{w}_k (\theta_k - \theta_j)(\theta_k - \theta_j)^\intercal$,
+ * where the sum runs over the surviving particles.
+ * 
+ */
+void 
+ncm_abc_set_adaptive (NcmABC *abc, gboolean adaptive)
+{
+  if (abc->started_up)
+    g_error ("ncm_abc_set_adaptive: cannot change the update mode during an update, call ncm_abc_end_update() first.");
+  abc->adaptive = adaptive;
+}
+
+/**
+ * ncm_abc_get_adaptive:
+ * @abc: a #NcmABC
+ * 
+ * Returns: whether the adaptive population updates are enabled.
+ */
+gboolean 
+ncm_abc_get_adaptive (NcmABC *abc)
+{
+  return abc->adaptive;
+}
+
+/**
+ * ncm_abc_set_ess_frac:
+ * @abc: a #NcmABC
+ * @ess_frac: a fraction in $(0, 1)$
+ * 
+ * Sets the fraction of the effective sample size of the current population
+ * that must survive each epsilon update in the adaptive mode, see
+ * ncm_abc_set_adaptive(). The fraction must be smaller than one, otherwise
+ * no particle could be left out and the tolerance would never decrease.
+ * 
+ */
+void 
+ncm_abc_set_ess_frac (NcmABC *abc, gdouble ess_frac)
+{
+  g_assert_cmpfloat (ess_frac, >, 0.0);
+  g_assert_cmpfloat (ess_frac, <, 1.0);
+  abc->ess_frac = ess_frac;
+}
+
+/**
+ * ncm_abc_get_ess_frac:
+ * @abc: a #NcmABC
+ * 
+ * Returns: the effective sample size fraction used by the adaptive mode.
+ */
+gdouble 
+ncm_abc_get_ess_frac (NcmABC *abc)
+{
+  return abc->ess_frac;
+}
+
+/**
+ * ncm_abc_get_ess:
+ * @abc: a #NcmABC
+ * 
+ * Computes the effective sample size $(\sum_i w_i)^2/\sum_i w_i^2$ of
+ * the current particle population.
+ * 
+ * Returns: the effective sample size.
+ */
+gdouble 
+ncm_abc_get_ess (NcmABC *abc)
+{
+  gdouble S1 = 0.0, S2 = 0.0;
+  guint i;
+
+  for (i = 0; i < abc->weights->len; i++)
+  {
+    const gdouble w_i = g_array_index (abc->weights, gdouble, i);
+    S1 += w_i;
+    S2 += w_i * w_i;
+  }
+
+  return (S2 > 0.0) ? S1 * S1 / S2 : 0.0;
+}
+
+/**
+ * ncm_abc_get_nsims:
+ * @abc: a #NcmABC
+ * 
+ * Gets the total number of mock data sets simulated in all finished
+ * particle generations and updates since the last ncm_abc_reset().
+ * 
+ * Returns: the number of simulations.
+ */
+guint64 
+ncm_abc_get_nsims (NcmABC *abc)
+{
+  return abc->nsims;
+}
+
 void
 _ncm_abc_update (NcmABC *abc, NcmMSet *mset, gdouble dist, gdouble weight)
 {
@@ -760,6 +904,7 @@ ncm_abc_end_run (NcmABC *abc)
     ncm_timer_task_end (abc->nt);
 
   ncm_mset_catalog_sync (abc->mcat, TRUE);
+  abc->nsims += abc->ntotal;
 
   for (i = 0; i < abc->nparticles; i++)
     WT += g_array_index (abc->weights, gdouble, i);
@@ -802,6 +947,7 @@ ncm_abc_reset (NcmABC *abc)
   abc->ntotal          = 0;
   abc->naccepted       = 0;
   abc->nupdates        = 0;
+  abc->nsims           = 0;
   ncm_mset_catalog_reset (abc->mcat);
 }
 
@@ -935,6 +1081,7 @@ typedef struct _NcmABCThread
   NcmMSet *mset;
   NcmDataset *dset;
   NcmVector *thetastar;
+  NcmVector *work;
   NcmRNG *rng;
 } NcmABCThread;
 
@@ -952,6 +1099,7 @@ _ncm_abc_dup_thread (gpointer userdata)
     abct->mset      = ncm_mset_dup (mset, abc->ser);
     abct->dset      = ncm_dataset_dup (abc->dset, abc->ser);
     abct->thetastar = ncm_vector_dup (abc->thetastar);
+    abct->work      = ncm_vector_dup (abc->thetastar);
     abct->rng       = ncm_rng_new (NULL);
     
     ncm_rng_set_seed (abct->rng, gsl_rng_get (rng->r));
@@ -971,6 +1119,7 @@ _ncm_abc_free_thread (gpointer data)
   ncm_mset_clear (&abct->mset);
   ncm_dataset_clear (&abct->dset);
   ncm_vector_clear (&abct->thetastar);
+  ncm_vector_clear (&abct->work);
   ncm_rng_clear (&abct->rng);
   g_free (abct);
 }
@@ -982,6 +1131,7 @@ _ncm_abc_thread_eval (glong i, glong f, gpointer data)
   NcmABC *abc = NCM_ABC (data);
   NcmABCThread **abct_ptr = ncm_memory_pool_get (abc->mp);
   NcmABCThread *abct = *abct_ptr;
+  guint nprop = 0;
   guint j;
   for (j = i; j < f;)
   {
@@ -995,12 +1145,13 @@ _ncm_abc_thread_eval (glong i, glong f, gpointer data)
     dist = ncm_abc_mock_distance (abc, abct->dset, abct->thetastar, abct->thetastar, abct->rng);
     prob = ncm_abc_distance_prob (abc, dist);
 
-    G_LOCK (update_lock);
-    abc->ntotal++;
-    G_UNLOCK (update_lock);
+    /* Proposals are counted locally and accumulated on acceptance. */
+    nprop++;
     if (prob == 1.0 || (prob != 0.0 && gsl_rng_uniform (abct->rng->r) < prob))
     {
       G_LOCK (update_lock);
+      abc->ntotal += nprop;
+      nprop = 0;
       abc->cur_sample_id++;
       abc->naccepted++;
       _ncm_abc_update (abc, abct->mset, dist, 1.0);
@@ -1108,6 +1259,244 @@ ncm_abc_mean_covar (NcmABC *abc, NcmFit *fit)
   fit->fstate->has_covar = TRUE;
 }
 
+typedef struct _NcmABCDistWeight
+{
+  gdouble dist;
+  gdouble weight;
+} NcmABCDistWeight;
+
+static gint 
+_ncm_abc_dist_weight_cmp (gconstpointer a, gconstpointer b)
+{
+  const NcmABCDistWeight *dw_a = a;
+  const NcmABCDistWeight *dw_b = b;
+  
+  if (dw_a->dist > dw_b->dist) 
+    return 1;
+  else if (dw_a->dist < dw_b->dist) 
+    return -1;
+  else 
+    return 0;  
+}
+
+static void
+_ncm_abc_adaptive_epsilon (NcmABC *abc)
+{
+  GArray *dw           = g_array_sized_new (FALSE, FALSE, sizeof (NcmABCDistWeight), abc->nparticles);
+  const gdouble ess_min = abc->ess_frac * ncm_abc_get_ess (abc);
+  gdouble epsilon       = abc->epsilon;
+  gdouble S1 = 0.0, S2 = 0.0;
+  guint j;
+
+  /* 
+   * The distances are read from the catalog since abc->dists may have been
+   * sorted by ncm_abc_get_dist_quantile().
+   */
+  for (j = 0; j < abc->nparticles; j++)
+  {
+    NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + j);
+    NcmABCDistWeight dw_j = {ncm_vector_get (row, 0), g_array_index (abc->weights, gdouble, j)};
+
+    g_array_append_val (dw, dw_j);
+  }
+  g_array_sort (dw, &_ncm_abc_dist_weight_cmp);
+
+  for (j = 0; j + 1 < abc->nparticles; j++)
+  {
+    const NcmABCDistWeight *dw_j   = &g_array_index (dw, NcmABCDistWeight, j);
+    const NcmABCDistWeight *dw_jp1 = &g_array_index (dw, NcmABCDistWeight, j + 1);
+
+    S1 += dw_j->weight;
+    S2 += dw_j->weight * dw_j->weight;
+
+    if ((S2 > 0.0) && (S1 * S1 / S2 >= ess_min) && (dw_jp1->dist > dw_j->dist))
+    {
+      epsilon = 0.5 * (dw_j->dist + dw_jp1->dist);
+      break;
+    }
+  }
+
+  epsilon = GSL_MAX (epsilon, abc->target_epsilon);
+  g_array_unref (dw);
+
+  if (abc->mtype > NCM_FIT_RUN_MSGS_NONE)
+    g_message ("# NcmABC: ESS of the current population %.2f (%.2f required).\n", ncm_abc_get_ess (abc), ess_min);
+
+  if (epsilon < abc->epsilon)
+    ncm_abc_update_epsilon (abc, epsilon);
+  else if (abc->epsilon > abc->target_epsilon)
+    g_warning ("_ncm_abc_adaptive_epsilon: epsilon = %g cannot be decreased keeping an ESS of %.2f, the population has stalled.", 
+               abc->epsilon, ess_min);
+}
+
+static void
+_ncm_abc_adaptive_prepare (NcmABC *abc)
+{
+  NcmMSet *mset          = ncm_mset_catalog_peek_mset (abc->mcat);
+  const guint fparam_len = ncm_mset_fparam_len (mset);
+  GPtrArray *thetas      = g_ptr_array_new_with_free_func ((GDestroyNotify) &ncm_vector_free);
+  gdouble WT             = 0.0;
+  guint nalive           = 0;
+  guint j, k;
+
+  /* Recycling the previous population: only the particles inside the new tolerance survive. */
+  for (j = 0; j < abc->nparticles; j++)
+  {
+    NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + j);
+    const gdouble w_j = (ncm_vector_get (row, 0) < abc->epsilon) ? g_array_index (abc->weights, gdouble, j) : 0.0;
+
+    g_array_index (abc->weights_tm1, gdouble, j) = w_j;
+    g_ptr_array_add (thetas, ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2));
+    WT += w_j;
+    nalive += (w_j > 0.0) ? 1 : 0;
+  }
+
+  if (nalive < 2)
+    g_error ("_ncm_abc_adaptive_prepare: only %u particle(s) inside epsilon = %g, cannot adapt the proposal.", nalive, abc->epsilon);
+
+  for (j = 0; j < abc->nparticles; j++)
+    g_array_index (abc->weights_tm1, gdouble, j) = g_array_index (abc->weights_tm1, gdouble, j) / WT;
+
+  if (abc->local_LLT->len != abc->nparticles)
+    g_ptr_array_set_size (abc->local_LLT, 0);
+  
+  for (j = 0; j < abc->nparticles; j++)
+  {
+    if (abc->local_LLT->len == j)
+      g_ptr_array_add (abc->local_LLT, ncm_matrix_new (fparam_len, fparam_len));
+    else if (ncm_matrix_nrows (g_ptr_array_index (abc->local_LLT, j)) != fparam_len)
+    {
+      ncm_matrix_free (g_ptr_array_index (abc->local_LLT, j));
+      g_ptr_array_index (abc->local_LLT, j) = ncm_matrix_new (fparam_len, fparam_len);
+    }
+  }
+
+  /* Weighted global covariance of the survivors, used when a local one is singular. */
+  ncm_vector_set_zero (abc->theta);
+  for (k = 0; k < abc->nparticles; k++)
+    ncm_vector_axpy (abc->theta, g_array_index (abc->weights_tm1, gdouble, k), g_ptr_array_index (thetas, k));
+
+  ncm_matrix_set_zero (abc->covar);
+  for (k = 0; k < abc->nparticles; k++)
+  {
+    const gdouble w_k = g_array_index (abc->weights_tm1, gdouble, k);
+    if (w_k > 0.0)
+    {
+      ncm_vector_memcpy (abc->thetastar, g_ptr_array_index (thetas, k));
+      ncm_vector_sub (abc->thetastar, abc->theta);
+      gsl_blas_dsyr (CblasLower, w_k, ncm_vector_gsl (abc->thetastar), ncm_matrix_gsl (abc->covar));
+    }
+  }
+  ncm_matrix_copy_triangle (abc->covar, 'L');
+
+  for (j = 0; j < abc->nparticles; j++)
+  {
+    NcmMatrix *LLT     = g_ptr_array_index (abc->local_LLT, j);
+    NcmVector *theta_j = g_ptr_array_index (thetas, j);
+    gint ret;
+
+    if (g_array_index (abc->weights_tm1, gdouble, j) == 0.0)
+      continue;
+
+    ncm_matrix_set_zero (LLT);
+    for (k = 0; k < abc->nparticles; k++)
+    {
+      const gdouble w_k = g_array_index (abc->weights_tm1, gdouble, k);
+      if (w_k > 0.0)
+      {
+        ncm_vector_memcpy (abc->thetastar, g_ptr_array_index (thetas, k));
+        ncm_vector_sub (abc->thetastar, theta_j);
+        gsl_blas_dsyr (CblasLower, w_k, ncm_vector_gsl (abc->thetastar), ncm_matrix_gsl (LLT));
+      }
+    }
+    ncm_matrix_copy_triangle (LLT, 'L');
+
+    ret = ncm_matrix_cholesky_decomp (LLT, 'L');
+    if (ret != 0)
+    {
+      ncm_matrix_memcpy (LLT, abc->covar);
+      ret = ncm_matrix_cholesky_decomp (LLT, 'L');
+      if (ret != 0)
+        g_error ("_ncm_abc_adaptive_prepare[ncm_matrix_cholesky_decomp]: %d.", ret);
+    }
+  }
+
+  if (abc->mtype > NCM_FIT_RUN_MSGS_NONE)
+    g_message ("# NcmABC: %u of %u particles recycled into the proposal.\n", nalive, abc->nparticles);
+
+  g_ptr_array_unref (thetas);
+}
+
+/*
+ * In the adaptive mode the proposal is not truncated to the parameter
+ * bounds, a draw outside them is discarded (FALSE is returned) and the
+ * caller chooses a new particle. The accepted proposals are then
+ * distributed as the untruncated mixture restricted to the bounds, which
+ * differs from it only by a global normalization, thus
+ * _ncm_abc_proposal_pdf() gives the correct importance weights.
+ */
+static gboolean
+_ncm_abc_propose (NcmABC *abc, NcmMSet *mset, guint np, NcmVector *theta, NcmVector *thetastar, NcmRNG *rng)
+{
+  if (abc->adaptive)
+  {
+    NcmMatrix *LLT = g_ptr_array_index (abc->local_LLT, np);
+    const guint len = ncm_vector_len (thetastar);
+    gint ret;
+    guint i;
+
+    ncm_rng_lock (rng);
+    for (i = 0; i < len; i++)
+      ncm_vector_set (thetastar, i, gsl_ran_ugaussian (rng->r));
+    ncm_rng_unlock (rng);
+
+    ret = gsl_blas_dtrmv (CblasLower, CblasNoTrans, CblasNonUnit,
+                          ncm_matrix_gsl (LLT), ncm_vector_gsl (thetastar));
+    NCM_TEST_GSL_RESULT ("_ncm_abc_propose", ret);
+
+    ncm_vector_add (thetastar, theta);
+
+    return ncm_mset_fparam_valid_bounds (mset, thetastar);
+  }
+  else
+  {
+    ncm_mset_trans_kern_generate (abc->tkern, theta, thetastar, rng);
+    return TRUE;
+  }
+}
+
+static gdouble
+_ncm_abc_proposal_pdf (NcmABC *abc, guint np, NcmVector *theta, NcmVector *thetastar, NcmVector *work)
+{
+  if (abc->adaptive)
+  {
+    NcmMatrix *LLT = g_ptr_array_index (abc->local_LLT, np);
+    const guint len = ncm_vector_len (work);
+    gdouble m2lnP = 0.0;
+    gint ret;
+    guint i;
+
+    ncm_vector_memcpy (work, theta);
+    ncm_vector_sub (work, thetastar);
+
+    ret = gsl_blas_dtrsv (CblasLower, CblasNoTrans, CblasNonUnit,
+                          ncm_matrix_gsl (LLT), ncm_vector_gsl (work));
+    NCM_TEST_GSL_RESULT ("_ncm_abc_proposal_pdf", ret);
+
+    ret = gsl_blas_ddot (ncm_vector_gsl (work), ncm_vector_gsl (work), &m2lnP);
+    NCM_TEST_GSL_RESULT ("_ncm_abc_proposal_pdf", ret);
+
+    m2lnP += len * ncm_c_ln2pi ();
+
+    for (i = 0; i < len; i++)
+      m2lnP += 2.0 * log (ncm_matrix_get (LLT, i, i));
+
+    return exp (- 0.5 * m2lnP);
+  }
+  else
+    return ncm_mset_trans_kern_pdf (abc->tkern, theta, thetastar);
+}
+
 /**
  * ncm_abc_start_update:
  * @abc: a #NcmABC
@@ -1126,7 +1515,7 @@ ncm_abc_start_update (NcmABC *abc)
   if (abc->started_up)
     g_error ("ncm_abc_start_update: run already started, run ncm_abc_end_update() first.");
 
-  if (abc->tkern == NULL)
+  if ((abc->tkern == NULL) && !abc->adaptive)
     g_error ("ncm_abc_start_update: no transition kernel defined.");
 
   switch (abc->mtype)
@@ -1189,10 +1578,18 @@ ncm_abc_start_update (NcmABC *abc)
   g_clear_pointer (&abc->wran, gsl_ran_discrete_free);
   g_array_set_size (abc->weights_tm1, abc->nparticles);
 
-  ncm_abc_update_tkern (abc);
-  
-  memcpy (abc->weights_tm1->data, abc->weights->data, sizeof (gdouble) * abc->nparticles);
-  abc->wran = gsl_ran_discrete_preproc (abc->nparticles, (gdouble *)abc->weights->data);
+  if (abc->adaptive)
+  {
+    _ncm_abc_adaptive_epsilon (abc);
+    _ncm_abc_adaptive_prepare (abc);
+  }
+  else
+  {
+    ncm_abc_update_tkern (abc);
+    memcpy (abc->weights_tm1->data, abc->weights->data, sizeof (gdouble) * abc->nparticles);
+  }
+
+  abc->wran = gsl_ran_discrete_preproc (abc->nparticles, (gdouble *)abc->weights_tm1->data);
 
   ncm_mset_catalog_reset_stats (abc->mcat);
   
@@ -1229,6 +1626,7 @@ ncm_abc_end_update (NcmABC *abc)
     ncm_timer_task_end (abc->nt);
 
   g_clear_pointer (&abc->wran, gsl_ran_discrete_free);
+  abc->nsims += abc->ntotal;
 
   for (i = 0; i < abc->nparticles; i++)
     WT += g_array_index (abc->weights, gdouble, i);
@@ -1307,11 +1705,67 @@ ncm_abc_update (NcmABC *abc)
   ncm_timer_task_pause (abc->nt);
 }
 
+/**
+ * ncm_abc_run_to_epsilon:
+ * @abc: a #NcmABC
+ * @nparticles: number of particles in each population
+ * @target_epsilon: target tolerance
+ * @max_updates: maximum number of population updates
+ * 
+ * Generates the initial population of @nparticles particles, if no update
+ * was performed yet, and then updates the population until the tolerance
+ * reaches @target_epsilon or @max_updates updates were done. In the
+ * adaptive mode (see ncm_abc_set_adaptive()) the tolerance schedule never
+ * goes below @target_epsilon.
+ * 
+ * Returns: the total number of simulations used so far, see ncm_abc_get_nsims().
+ */
+guint64
+ncm_abc_run_to_epsilon (NcmABC *abc, guint nparticles, gdouble target_epsilon, guint max_updates)
+{
+  guint i;
+
+  g_assert_cmpfloat (target_epsilon, >=, 0.0);
+
+  abc->target_epsilon = target_epsilon;
+
+  if (abc->nupdates == 0)
+  {
+    ncm_abc_start_run (abc);
+    ncm_abc_run (abc, nparticles);
+    ncm_abc_end_run (abc);
+  }
+  else if (nparticles != abc->nparticles)
+    g_error ("ncm_abc_run_to_epsilon: cannot change the number of particles after the first update [%u != %u].", nparticles, abc->nparticles);
+
+  abc->n = abc->nparticles;
+
+  for (i = 0; (i < max_updates) && (abc->epsilon > target_epsilon); i++)
+  {
+    ncm_abc_start_update (abc);
+    ncm_abc_update (abc);
+    ncm_abc_end_update (abc);
+
+    if (abc->mtype > NCM_FIT_RUN_MSGS_NONE)
+      g_message ("# NcmABC: population %u, epsilon = %g, simulations used %" G_GUINT64_FORMAT ".\n", abc->nupdates, abc->epsilon, abc->nsims);
+  }
+
+  abc->target_epsilon = 0.0;
+
+  if (abc->epsilon > target_epsilon)
+    g_warning ("ncm_abc_run_to_epsilon: target epsilon %g not reached after %u updates, current epsilon %g.", target_epsilon, max_updates, abc->epsilon);
+  else if (abc->mtype > NCM_FIT_RUN_MSGS_NONE)
+    g_message ("# NcmABC: target epsilon %g reached using %" G_GUINT64_FORMAT " simulations.\n", target_epsilon, abc->nsims);
+
+  return abc->nsims;
+}
+
 static void 
 _ncm_abc_update_single (NcmABC *abc)
 {
-  NcmMSet *mset = ncm_mset_catalog_peek_mset (abc->mcat);
-  NcmRNG *rng   = ncm_mset_catalog_peek_rng (abc->mcat);
+  NcmMSet *mset   = ncm_mset_catalog_peek_mset (abc->mcat);
+  NcmRNG *rng     = ncm_mset_catalog_peek_rng (abc->mcat);
+  NcmVector *work = ncm_vector_new (ncm_vector_len (abc->thetastar));
   guint i = 0;
   
   for (i = 0; i < abc->n;)
@@ -1322,7 +1776,11 @@ _ncm_abc_update_single (NcmABC *abc)
     NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + np);
     NcmVector *theta = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
     
-    ncm_mset_trans_kern_generate (abc->tkern, theta, abc->thetastar, rng);
+    if (!_ncm_abc_propose (abc, mset, np, theta, abc->thetastar, rng))
+    {
+      ncm_vector_free (theta);
+      continue;
+    }
     ncm_mset_fparams_set_vector (mset, abc->thetastar);
     ncm_dataset_resample (abc->dset_mock, mset, rng);
     
@@ -1339,9 +1797,12 @@ _ncm_abc_update_single (NcmABC *abc)
       guint j;
       for (j = 0; j < abc->nparticles; j++)
       {        
+        const gdouble w_j = g_array_index (abc->weights_tm1, gdouble, j);
+        if (w_j == 0.0)
+          continue;
         row    = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + j);
         theta  = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
-        denom += g_array_index (abc->weights_tm1, gdouble, j) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abc->thetastar);
+        denom += w_j * _ncm_abc_proposal_pdf (abc, j, theta, abc->thetastar, work);
         ncm_vector_free (theta);
       }
       new_weight = new_weight / denom; 
@@ -1352,6 +1813,8 @@ _ncm_abc_update_single (NcmABC *abc)
       i++;
     }
   }
+
+  ncm_vector_free (work);
 }
 
 static void 
@@ -1361,6 +1824,7 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
   NcmABC *abc = NCM_ABC (data);
   NcmABCThread **abct_ptr = ncm_memory_pool_get (abc->mp);
   NcmABCThread *abct = *abct_ptr;
+  guint nprop = 0;
   guint j;
 
   for (j = i; j < f;)
@@ -1371,7 +1835,11 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
     NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + np);
     NcmVector *theta = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
 
-    ncm_mset_trans_kern_generate (abc->tkern, theta, abct->thetastar, abct->rng);
+    if (!_ncm_abc_propose (abc, abct->mset, np, theta, abct->thetastar, abct->rng))
+    {
+      ncm_vector_free (theta);
+      continue;
+    }
 
     ncm_mset_fparams_set_vector (abct->mset, abct->thetastar);
     ncm_dataset_resample (abct->dset, abct->mset, abct->rng);
@@ -1388,10 +1856,9 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
 */
     ncm_vector_free (theta);
     
-    G_LOCK (update_lock);
-    abc->ntotal++;
-    G_UNLOCK (update_lock);
-    
+    /* Proposals are counted locally and accumulated on acceptance. */
+    nprop++;
+
     if (prob == 1.0 || (prob != 0.0 && gsl_rng_uniform (abct->rng->r) < prob))
     {
       gdouble new_weight = ncm_mset_trans_kern_prior_pdf (abc->prior, abct->thetastar);
@@ -1399,14 +1866,19 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
       guint k;
       for (k = 0; k < abc->nparticles; k++)
       {
+        const gdouble w_k = g_array_index (abc->weights_tm1, gdouble, k);
+        if (w_k == 0.0)
+          continue;
         row    = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + k);
         theta  = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
-        denom += g_array_index (abc->weights_tm1, gdouble, k) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abct->thetastar);
+        denom += w_k * _ncm_abc_proposal_pdf (abc, k, theta, abct->thetastar, abct->work);
         ncm_vector_free (theta);
       }
       new_weight = new_weight / denom; 
 
       G_LOCK (update_lock);
+      abc->ntotal += nprop;
+      nprop = 0;
       abc->cur_sample_id++;
       abc->naccepted++;
       _ncm_abc_update (abc, abct->mset, dist, new_weight);
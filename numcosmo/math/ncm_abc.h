@@ -92,6 +92,11 @@ struct _NcmABC
   guint nupdates;
   guint n;
   guint nparticles;
+  gboolean adaptive;
+  gdouble ess_frac;
+  gdouble target_epsilon;
+  guint64 nsims;
+  GPtrArray *local_LLT;
 };
 
 GType ncm_abc_get_type (void) G_GNUC_CONST;
@@ -118,6 +123,13 @@ void ncm_abc_update_epsilon (NcmABC *abc, gdouble epsilon);
 gdouble ncm_abc_get_epsilon (NcmABC *abc);
 gdouble ncm_abc_get_depsilon (NcmABC *abc);
 
+void ncm_abc_set_adaptive (NcmABC *abc, gboolean adaptive);
+gboolean ncm_abc_get_adaptive (NcmABC *abc);
+void ncm_abc_set_ess_frac (NcmABC *abc, gdouble ess_frac);
+gdouble ncm_abc_get_ess_frac (NcmABC *abc);
+gdouble ncm_abc_get_ess (NcmABC *abc);
+guint64 ncm_abc_get_nsims (NcmABC *abc);
+
 void ncm_abc_start_run (NcmABC *abc);
 void ncm_abc_end_run (NcmABC *abc);
 void ncm_abc_reset (NcmABC *abc);
@@ -128,7 +140,10 @@ void ncm_abc_start_update (NcmABC *abc);
 void ncm_abc_end_update (NcmABC *abc);
 void ncm_abc_update (NcmABC *abc);
 
+guint64 ncm_abc_run_to_epsilon (NcmABC *abc, guint nparticles, gdouble target_epsilon, guint max_updates);
+
 #define NCM_ABC_MIN_SYNC_INTERVAL (10.0)
+#define NCM_ABC_DEFAULT_ESS_FRAC (0.5)
 
 G_END_DECLS
 
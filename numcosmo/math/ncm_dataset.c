@@ -266,6 +266,31 @@ ncm_dataset_dup (NcmDataset *dset, NcmSerialize *ser)
   return NCM_DATASET (ncm_serialize_dup_obj (ser, G_OBJECT (dset)));
 }
 
+/**
+ * ncm_dataset_bootstrap_view:
+ * @dset: a #NcmDataset
+ *
+ * Creates a lightweight copy of @dset for bootstrap resampling in
+ * concurrent workers. Every #NcmData is duplicated, together with its own
+ * #NcmBootstrap, but the #NcmVector and #NcmMatrix objects holding the
+ * data are shared with @dset by reference (see
+ * #NCM_SERIALIZE_OPT_SHARE_ARRAYS). Hence, the view can only be used with
+ * #NcmData objects that do not modify these arrays during the likelihood
+ * evaluation, e.g., #NcmDataGaussCov without a @cov_func implementation.
+ *
+ * Returns: (transfer full): a #NcmDataset sharing the data arrays of @dset.
+ */
+NcmDataset *
+ncm_dataset_bootstrap_view (NcmDataset *dset)
+{
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP | NCM_SERIALIZE_OPT_SHARE_ARRAYS);
+  NcmDataset *view  = ncm_dataset_dup (dset, ser);
+
+  ncm_serialize_free (ser);
+
+  return view;
+}
+
 /**
  * ncm_dataset_copy:
  * @dset: pointer to type defined by #NcmDataset
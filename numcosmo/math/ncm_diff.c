@@ -39,6 +39,7 @@
 #include "build_cfg.h"
 
 #include "math/ncm_diff.h"
+#include "math/ncm_func_eval.h"
 
 struct _NcmDiffPrivate
 {
@@ -715,243 +716,188 @@ _ncm_diff_rf_Hessian_step (NcmDiff *diff, NcmDiffFuncNto1 f, gpointer user_data,
   }
 }
 
-static GArray *
-ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
+typedef struct _NcmDiffFuncParams
 {
-  GPtrArray *tables  = NULL;
-  GPtrArray *dfs     = g_ptr_array_new ();
-  GPtrArray *roffs   = g_ptr_array_new ();
-  GArray *f_a        = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *yh_a       = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  NcmVector *x_v     = NULL;
-  NcmVector *f_v     = NULL; 
-  NcmVector *yh1_v   = NULL;
-  NcmVector *yh2_v   = NULL;
-  NcmVector *dfb     = NULL;
-  NcmVector *dfr     = NULL;
-  NcmVector *roffb   = NULL;
-  NcmVector *roffr   = NULL;
-  NcmVector *err     = NULL;
-  NcmVector *err_err = NULL;
-  NcmVector *ferr    = NULL;
-  NcmVector *df_best = NULL;
-  GArray *df         = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *not_conv   = g_array_new (FALSE, FALSE, sizeof (guchar));
-  const guint nvar   = x_a->len;
-  NcmMatrix *Eerr_m  = NULL;
-  NcmMatrix *df_m;
-  guint a;
-
-  g_array_set_size (df, dim * nvar);
-  df_m = ncm_matrix_new_array (df, dim);
-
-  if (po == 0)
-    tables = diff->priv->forward_tables;
-  else
-    tables = diff->priv->central_tables;
+  NcmDiffFunc1toM f_1_to_M;
+  NcmDiffFuncNto1 f_N_to_1;
+  NcmDiffFunc1to1 f_1_to_1;
+  gpointer user_data;
+} NcmDiffFuncParams;
 
-  if (Eerr != NULL)
-  {
-    *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
-    g_array_set_size (*Eerr, dim * nvar);
-    Eerr_m = ncm_matrix_new_array (*Eerr, dim);
-  }
+static void
+_ncm_diff_by_step_algo_a (NcmDiff *diff, NcmDiffStepAlgo step_algo, GPtrArray *tables, const guint po, NcmVector *x_v, const guint a, const guint dim, NcmVector *f_v, NcmDiffFuncNtoM f, gpointer user_data, NcmVector *df_a, NcmVector *Eerr_a)
+{
+  GPtrArray *dfs        = g_ptr_array_new ();
+  GPtrArray *roffs      = g_ptr_array_new ();
+  GArray *yh_a          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *not_conv      = g_array_new (FALSE, FALSE, sizeof (guchar));
+  const gdouble x       = ncm_vector_get (x_v, a);
+  const gdouble scale   = (x == 0.0) ? 1.0 : fabs (x);
+  const gdouble h0      = diff->priv->ini_h * scale;
+  const guint ntry_conv = 3;
+  NcmDiffTable *ldtable = NULL;
+  NcmVector *yh1_v      = NULL;
+  NcmVector *yh2_v      = NULL;
+  NcmVector *dfb        = ncm_vector_new (dim);
+  NcmVector *dfr        = ncm_vector_new (dim);
+  NcmVector *roffb      = ncm_vector_new (dim);
+  NcmVector *roffr      = ncm_vector_new (dim);
+  NcmVector *err        = ncm_vector_new (dim);
+  NcmVector *err_err    = ncm_vector_new (dim);
+  NcmVector *ferr       = ncm_vector_new (dim);
+  NcmVector *df_best    = ncm_vector_new (dim);
+  guint order_index;
+  guint t = 0;
 
   g_ptr_array_set_free_func (dfs,   (GDestroyNotify) ncm_vector_free);
   g_ptr_array_set_free_func (roffs, (GDestroyNotify) ncm_vector_free);
-  
-  g_array_set_size (f_a,      dim);
+
   g_array_set_size (yh_a,     dim);
   g_array_set_size (not_conv, dim);
 
-  x_v   = ncm_vector_new_array (x_a);
-  f_v   = ncm_vector_new_array (f_a);
   yh1_v = ncm_vector_new_array (yh_a);
   yh2_v = ncm_vector_new_array (yh_a);
+  g_array_unref (yh_a);
 
-  dfb     = ncm_vector_new (dim);
-  dfr     = ncm_vector_new (dim);
+  ncm_vector_set_all (ferr, GSL_POSINF);
 
-  roffb   = ncm_vector_new (dim);
-  roffr   = ncm_vector_new (dim);
+  memset (not_conv->data, ntry_conv, not_conv->len);
 
-  err     = ncm_vector_new (dim);
-  err_err = ncm_vector_new (dim);
-  ferr    = ncm_vector_new (dim);
-  df_best = ncm_vector_new (dim);
-  
-  g_array_unref (f_a);
-  g_array_unref (yh_a);
-
-  f (x_v, f_v, user_data);
-  
-  for (a = 0; a < x_a->len; a++)
+  for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
   {
-    const gdouble x       = g_array_index (x_a, gdouble, a);
-    const gdouble scale   = (x == 0.0) ? 1.0 : fabs (x);
-    const gdouble h0      = diff->priv->ini_h * scale;
-    const guint ntry_conv = 3;
-    NcmDiffTable *ldtable = NULL;
-    guint order_index;
-    guint t = 0;
-
-    ncm_vector_set_all (ferr, GSL_POSINF);
-    g_ptr_array_set_size (dfs, 0);
-    g_ptr_array_set_size (roffs, 0);
-
-    memset (not_conv->data, ntry_conv, not_conv->len);
-        
-    for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
+    const guint nt       = order_index + 2;
+    NcmDiffTable *dtable = g_ptr_array_index (tables, order_index);
+    guint i;
+
+    for (; t < nt; t++)
     {
-      const guint nt       = order_index + 2;
-      NcmDiffTable *dtable = g_ptr_array_index (tables, order_index);
-      guint i;
+      const gdouble ho      = h0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
+      volatile gdouble temp = x + ho;
+      const gdouble h       = temp - x;
 
-      for (; t < nt; t++)
-      {
-        const gdouble ho      = h0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
-        volatile gdouble temp = x + ho;
-        const gdouble h       = temp - x;
+      NcmVector *df_t   = ncm_vector_new (dim);
+      NcmVector *roff_t = ncm_vector_new (dim);
 
-        NcmVector *df_t   = ncm_vector_new (dim);
-        NcmVector *roff_t = ncm_vector_new (dim);
+      step_algo (diff, f, user_data, a, x, h, x_v, f_v, yh1_v, yh2_v, df_t, roff_t);
 
-        step_algo (diff, f, user_data, a, x, h, x_v, f_v, yh1_v, yh2_v, df_t, roff_t);
+      g_ptr_array_add (dfs,   df_t);
+      g_ptr_array_add (roffs, roff_t);
 
-        g_ptr_array_add (dfs,   df_t);
-        g_ptr_array_add (roffs, roff_t);
-        
-        ncm_vector_set (x_v, a, x);
-      }
+      ncm_vector_set (x_v, a, x);
+    }
 
-      if (ldtable == NULL)
-      {
-        ncm_vector_memcpy (dfb, g_ptr_array_index (dfs, 0));
-        ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
+    if (ldtable == NULL)
+    {
+      ncm_vector_memcpy (dfb, g_ptr_array_index (dfs, 0));
+      ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
 
-        ncm_vector_memcpy (roffb, g_ptr_array_index (roffs, 0));
-        ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
-        
-        ncm_vector_memcpy (df_best, dfb);
-        
-        ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
-        ncm_vector_axpy  (dfr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (dfs, 1));
+      ncm_vector_memcpy (roffb, g_ptr_array_index (roffs, 0));
+      ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
 
-        ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
-        ncm_vector_axpy  (roffr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (roffs, 1));
-      }
-      else
-      {
-        ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
-        ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
+      ncm_vector_memcpy (df_best, dfb);
 
-        ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
-        ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
+      ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
+      ncm_vector_axpy  (dfr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (dfs, 1));
 
-        for (i = 1; i < nt; i++)
-        {
-          ncm_vector_axpy (dfr,   ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (dfs, i));
-          ncm_vector_axpy (roffr, ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (roffs, i));
-        }
+      ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
+      ncm_vector_axpy  (roffr, ncm_vector_get (dtable->lambda, 1), g_ptr_array_index (roffs, 1));
+    }
+    else
+    {
+      ncm_vector_memcpy (dfr, g_ptr_array_index (dfs, 0));
+      ncm_vector_scale (dfr, ncm_vector_get (dtable->lambda, 0));
+
+      ncm_vector_memcpy (roffr, g_ptr_array_index (roffs, 0));
+      ncm_vector_scale (roffr, ncm_vector_get (dtable->lambda, 0));
+
+      for (i = 1; i < nt; i++)
+      {
+        ncm_vector_axpy (dfr,   ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (dfs, i));
+        ncm_vector_axpy (roffr, ncm_vector_get (dtable->lambda,  i), g_ptr_array_index (roffs, i));
       }
-      
-      ncm_vector_memcpy (err, dfr);
-      ncm_vector_memcpy (err_err, dfr);
+    }
 
-      ncm_vector_sub (err, dfb);
-      ncm_vector_cmp (err_err, dfb);
+    ncm_vector_memcpy (err, dfr);
+    ncm_vector_memcpy (err_err, dfr);
+
+    ncm_vector_sub (err, dfb);
+    ncm_vector_cmp (err_err, dfb);
+    {
+      gboolean improve = FALSE;
+      for (i = 0; i < dim; i++)
       {
-        gboolean improve = FALSE;
-        for (i = 0; i < dim; i++)
-        {
-          const gdouble err_i     = fabs (ncm_vector_get (err, i));
-          const gdouble ferr_i    = ncm_vector_get (ferr, i);
-          const gdouble roffb_i   = fabs (ncm_vector_get (roffb, i)) * diff->priv->roff_pad;
-          const gdouble roffr_i   = fabs (ncm_vector_get (roffr, i)) * diff->priv->roff_pad;
-          
-          const gdouble terr_i    = GSL_MAX (err_i, GSL_MAX (roffb_i, roffr_i));
-          const gdouble err_err_i = ncm_vector_get (err_err, i);
+        const gdouble err_i     = fabs (ncm_vector_get (err, i));
+        const gdouble ferr_i    = ncm_vector_get (ferr, i);
+        const gdouble roffb_i   = fabs (ncm_vector_get (roffb, i)) * diff->priv->roff_pad;
+        const gdouble roffr_i   = fabs (ncm_vector_get (roffr, i)) * diff->priv->roff_pad;
 
-          gdouble df_best_i = ncm_vector_get (df_best, i);
-          gdouble cerr_i    = ferr_i;
+        const gdouble terr_i    = GSL_MAX (err_i, GSL_MAX (roffb_i, roffr_i));
+        const gdouble err_err_i = ncm_vector_get (err_err, i);
+
+        gdouble df_best_i = ncm_vector_get (df_best, i);
+        gdouble cerr_i    = ferr_i;
 
 #define NOT_CONV (g_array_index (not_conv, guchar, i))
 
-          if (NOT_CONV && (err_err_i < 1.0e-3))
-            NOT_CONV--;
-          else
+        if (NOT_CONV && (err_err_i < 1.0e-3))
+          NOT_CONV--;
+        else
+        {
+          if (err_err_i > 1.0e-3)
           {
-            if (err_err_i > 1.0e-3)
-            {
-              NOT_CONV = ntry_conv;
-              if (err_err_i > 1.0)
-                ncm_vector_set (ferr, i, GSL_POSINF);
-            }
+            NOT_CONV = ntry_conv;
+            if (err_err_i > 1.0)
+              ncm_vector_set (ferr, i, GSL_POSINF);
           }
-          
-          if ((terr_i < ferr_i) && !NOT_CONV)
-          {
-            df_best_i = ncm_vector_get (dfr, i);
-            ncm_vector_set (df_best, i, df_best_i);
-            ncm_vector_set (ferr, i, terr_i);
-            cerr_i = terr_i;
+        }
 
-            improve = TRUE;
-          }
+        if ((terr_i < ferr_i) && !NOT_CONV)
+        {
+          df_best_i = ncm_vector_get (dfr, i);
+          ncm_vector_set (df_best, i, df_best_i);
+          ncm_vector_set (ferr, i, terr_i);
+          cerr_i = terr_i;
 
-          if (NOT_CONV || (roffr_i < cerr_i))
-            improve = TRUE;
-/*          
-          printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g improve: %s\n", 
-                  nt, i, a, NOT_CONV, ferr_i, err_i, roffb_i, roffr_i,
-                  err_err_i, improve ? "T" : "F");
-*/
+          improve = TRUE;
         }
 
-        if (!improve)
-          break;
-      }
+        if (NOT_CONV || (roffr_i < cerr_i))
+          improve = TRUE;
+#undef NOT_CONV
 /*
-      ncm_vector_log_vals (dfb,     "dfb  ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (dfr,     "dfr  ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (err,     "err  ", "% 22.15e", TRUE);
-
-      ncm_vector_log_vals (df_best, "df   ", "% 22.15g", TRUE);
-      ncm_vector_log_vals (ferr,    "ferr ", "% 22.15e", TRUE);
+        printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g improve: %s\n",
+                nt, i, a, NOT_CONV, ferr_i, err_i, roffb_i, roffr_i,
+                err_err_i, improve ? "T" : "F");
 */
+      }
 
-      ncm_vector_memcpy (dfb, dfr);
-      ncm_vector_memcpy (roffb, roffr);
-      ldtable = dtable;
+      if (!improve)
+        break;
     }
+/*
+    ncm_vector_log_vals (dfb,     "dfb  ", "% 22.15g", TRUE);
+    ncm_vector_log_vals (dfr,     "dfr  ", "% 22.15g", TRUE);
+    ncm_vector_log_vals (err,     "err  ", "% 22.15e", TRUE);
 
-    {
-      NcmVector *df_a = ncm_matrix_get_row (df_m, a);
-      ncm_vector_memcpy (df_a, df_best);
-      ncm_vector_free (df_a);
+    ncm_vector_log_vals (df_best, "df   ", "% 22.15g", TRUE);
+    ncm_vector_log_vals (ferr,    "ferr ", "% 22.15e", TRUE);
+*/
 
-      if (Eerr_m != NULL)
-      {
-        NcmVector *Eerr_a = ncm_matrix_get_row (Eerr_m, a);
-        ncm_vector_memcpy (Eerr_a, ferr);
-        ncm_vector_free (Eerr_a);
-      }
-    }
+    ncm_vector_memcpy (dfb, dfr);
+    ncm_vector_memcpy (roffb, roffr);
+    ldtable = dtable;
   }
 
-  if (Eerr_m != NULL)
-  {
-    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
-  }
+  ncm_vector_memcpy (df_a, df_best);
+  if (Eerr_a != NULL)
+    ncm_vector_memcpy (Eerr_a, ferr);
 
   {
     g_array_unref (not_conv);
-    
+
     g_ptr_array_unref (dfs);
     g_ptr_array_unref (roffs);
 
-    ncm_vector_clear (&x_v);
-    ncm_vector_clear (&f_v);
     ncm_vector_clear (&yh1_v);
     ncm_vector_clear (&yh2_v);
 
@@ -963,9 +909,63 @@ ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArra
 
     ncm_vector_clear (&err);
     ncm_vector_clear (&err_err);
-    
+
     ncm_vector_clear (&ferr);
     ncm_vector_clear (&df_best);
+  }
+}
+
+static GArray *
+ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, gpointer user_data, GArray **Eerr)
+{
+  GPtrArray *tables = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
+  GArray *f_a       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *df        = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const guint nvar  = x_a->len;
+  NcmVector *x_v    = NULL;
+  NcmVector *f_v    = NULL;
+  NcmMatrix *Eerr_m = NULL;
+  NcmMatrix *df_m;
+  guint a;
+
+  g_array_set_size (df, dim * nvar);
+  df_m = ncm_matrix_new_array (df, dim);
+
+  if (Eerr != NULL)
+  {
+    *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    g_array_set_size (*Eerr, dim * nvar);
+    Eerr_m = ncm_matrix_new_array (*Eerr, dim);
+  }
+
+  g_array_set_size (f_a, dim);
+
+  x_v = ncm_vector_new_array (x_a);
+  f_v = ncm_vector_new_array (f_a);
+
+  g_array_unref (f_a);
+
+  f (x_v, f_v, user_data);
+
+  for (a = 0; a < nvar; a++)
+  {
+    NcmVector *df_a   = ncm_matrix_get_row (df_m, a);
+    NcmVector *Eerr_a = (Eerr_m != NULL) ? ncm_matrix_get_row (Eerr_m, a) : NULL;
+
+    _ncm_diff_by_step_algo_a (diff, step_algo, tables, po, x_v, a, dim, f_v, f, user_data, df_a, Eerr_a);
+
+    ncm_vector_free (df_a);
+    ncm_vector_clear (&Eerr_a);
+  }
+
+  if (Eerr_m != NULL)
+  {
+    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
+  }
+
+  {
+    ncm_vector_clear (&x_v);
+    ncm_vector_clear (&f_v);
 
     ncm_matrix_clear (&df_m);
     ncm_matrix_clear (&Eerr_m);
@@ -974,12 +974,152 @@ ncm_diff_by_step_algo (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArra
   }
 }
 
+static void
+_ncm_diff_Hessian_by_step_algo_ab (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo, GPtrArray *tables, const guint po, NcmVector *x_v, const guint a, const guint b, const gdouble fval, NcmDiffFuncNto1 f, gpointer user_data, gdouble *df_ab, gdouble *Eerr_ab)
+{
+  GArray *dfs           = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *roffs         = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const guint ntry_conv = 3;
+  const gdouble x       = ncm_vector_get (x_v, a);
+  const gdouble y       = ncm_vector_get (x_v, b);
+  const gdouble scale_x = (x == 0.0) ? 1.0 : fabs (x);
+  const gdouble scale_y = (y == 0.0) ? 1.0 : fabs (y);
+  const gdouble hx0     = diff->priv->ini_h * scale_x;
+  const gdouble hy0     = diff->priv->ini_h * scale_y;
+  NcmDiffTable *ldtable = NULL;
+  gdouble ferr          = GSL_POSINF;
+  gdouble err           = 0.0;
+  gdouble err_err       = 0.0;
+  gdouble df_best       = 0.0;
+  gdouble dfb           = 0.0;
+  gdouble dfr           = 0.0;
+  gdouble roffb         = 0.0;
+  gdouble roffr         = 0.0;
+  guint t               = 0;
+  guint not_converging  = ntry_conv;
+  guint order_index;
+
+  for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
+  {
+    const guint nt        = order_index + 2;
+    NcmDiffTable *dtable  = g_ptr_array_index (tables, order_index);
+    guint i;
+
+    for (; t < nt; t++)
+    {
+      const gdouble hxo    = hx0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
+      const gdouble hyo    = hy0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
+      volatile gdouble t_x = x + hxo;
+      const gdouble hx     = t_x - x;
+      volatile gdouble t_y = y + hyo;
+      const gdouble hy     = t_y - y;
+
+      gdouble df_t   = 0.0;
+      gdouble roff_t = 0.0;
+
+      Hstep_algo (diff, f, user_data, a, x, hx, b, y, hy, x_v, fval, &df_t, &roff_t);
+
+      g_array_append_val (dfs,   df_t);
+      g_array_append_val (roffs, roff_t);
+
+      ncm_vector_set (x_v, a, x);
+      ncm_vector_set (x_v, b, y);
+    }
+
+    if (ldtable == NULL)
+    {
+      const gdouble lambda0 = ncm_vector_get (dtable->lambda, 0);
+      const gdouble lambda1 = ncm_vector_get (dtable->lambda, 1);
+
+      dfb   = g_array_index (dfs, gdouble, 0);
+      dfr   = dfb * lambda0 + g_array_index (dfs, gdouble, 1) * lambda1;
+
+      roffb = g_array_index (roffs, gdouble, 0);
+      roffr = roffb * lambda0 + g_array_index (roffs, gdouble, 1) * lambda1;
+
+      df_best = dfb;
+    }
+    else
+    {
+      dfr   = 0.0;
+      roffr = 0.0;
+
+      for (i = 0; i < nt; i++)
+      {
+        const gdouble lambda_i = ncm_vector_get (dtable->lambda,  i);
+        const gdouble df_i     = g_array_index (dfs, gdouble, i);
+        const gdouble roff_i   = g_array_index (roffs, gdouble, i);
+
+        dfr   += lambda_i * df_i;
+        roffr += lambda_i * roff_i;
+      }
+    }
+
+    err     = fabs (dfr - dfb);
+    err_err = (dfr == 0.0) ? ((dfb == 0.0) ? 0.0 : fabs (dfb)) : ((dfb == 0.0) ? fabs (dfr) : fabs ((dfr - dfb) / GSL_MIN (fabs (dfr), fabs (dfb))));
+
+    {
+      gboolean improve = FALSE;
+
+      const gdouble Eroffb = fabs (roffb) * diff->priv->roff_pad;
+      const gdouble Eroffr = fabs (roffr) * diff->priv->roff_pad;
+      const gdouble terr   = GSL_MAX (err, GSL_MAX (Eroffb, Eroffr));
+      gdouble cerr         = ferr;
+
+      if (not_converging && (err_err < 1.0e-3))
+        not_converging--;
+      else
+      {
+        if (err_err > 1.0e-3)
+        {
+          not_converging = ntry_conv;
+          if (err_err > 1.0)
+            ferr = GSL_POSINF;
+        }
+      }
+
+/*
+      printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g",
+              nt, a, b, not_converging, ferr, err, Eroffb, Eroffr, terr, err_err);
+*/
+      if ((terr < ferr) && !not_converging)
+      {
+        df_best = dfr;
+        ferr    = terr;
+        cerr    = terr;
+        improve = TRUE;
+
+        /*printf (" -UP-");*/
+      }
+/*
+      else
+        printf ("     ");
+*/
+      if (not_converging || (Eroffr < cerr))
+        improve = TRUE;
+
+      /*printf (" improve: %s\n", improve ? "T" : "F");*/
+
+      if (!improve)
+        break;
+    }
+
+    dfb     = dfr;
+    roffb   = roffr;
+    ldtable = dtable;
+  }
+
+  df_ab[0]   = df_best;
+  Eerr_ab[0] = ferr;
+
+  g_array_unref (dfs);
+  g_array_unref (roffs);
+}
+
 static GArray *
 ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo, guint po, GArray *x_a, NcmDiffFuncNto1 f, gpointer user_data, GArray **Eerr)
 {
-  GPtrArray *tables = NULL;
-  GArray *dfs       = g_array_new (FALSE, FALSE, sizeof (gdouble));
-  GArray *roffs     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GPtrArray *tables = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
   NcmVector *x_v    = NULL;
   GArray *df        = g_array_new (FALSE, FALSE, sizeof (gdouble));
   const guint nvar  = x_a->len;
@@ -989,12 +1129,7 @@ ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo,
   guint a;
 
   g_array_set_size (df, nvar * nvar);
-  df_m = ncm_matrix_new_array (df, nvar); 
-
-  if (po == 0)
-    tables = diff->priv->forward_tables;
-  else
-    tables = diff->priv->central_tables;
+  df_m = ncm_matrix_new_array (df, nvar);
 
   if (Eerr != NULL)
   {
@@ -1007,168 +1142,249 @@ ncm_diff_Hessian_by_step_algo (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo,
 
   fval = f (x_v, user_data);
 
-  for (a = 0; a < x_a->len; a++)
+  for (a = 0; a < nvar; a++)
   {
     guint b;
-    for (b = a + 1; b < x_a->len; b++)
+    for (b = a + 1; b < nvar; b++)
     {
-      const guint ntry_conv = 3;
-      const gdouble x       = g_array_index (x_a, gdouble, a);
-      const gdouble y       = g_array_index (x_a, gdouble, b);
-      const gdouble scale_x = (x == 0.0) ? 1.0 : fabs (x);
-      const gdouble scale_y = (y == 0.0) ? 1.0 : fabs (y);
-      const gdouble hx0     = diff->priv->ini_h * scale_x;
-      const gdouble hy0     = diff->priv->ini_h * scale_y;
-      NcmDiffTable *ldtable = NULL;
-      gdouble ferr          = GSL_POSINF;
-      gdouble err           = 0.0;
-      gdouble err_err       = 0.0;
-      gdouble df_best       = 0.0;
-      gdouble dfb           = 0.0;
-      gdouble dfr           = 0.0;
-      gdouble roffb         = 0.0;
-      gdouble roffr         = 0.0;        
-      guint t               = 0;
-      guint not_converging  = ntry_conv;
-      guint order_index;
-
-      g_array_set_size (dfs, 0);
-      g_array_set_size (roffs, 0);
-      
-      for (order_index = 0; order_index < diff->priv->maxorder; order_index++)
+      gdouble df_ab, Eerr_ab;
+
+      _ncm_diff_Hessian_by_step_algo_ab (diff, Hstep_algo, tables, po, x_v, a, b, fval, f, user_data, &df_ab, &Eerr_ab);
+
+      ncm_matrix_set (df_m, a, b, df_ab);
+      ncm_matrix_set (df_m, b, a, df_ab);
+
+      if (Eerr_m != NULL)
       {
-        const guint nt        = order_index + 2;
-        NcmDiffTable *dtable  = g_ptr_array_index (tables, order_index);
-        guint i;
+        ncm_matrix_set (Eerr_m, a, b, Eerr_ab);
+        ncm_matrix_set (Eerr_m, b, a, Eerr_ab);
+      }
+    }
+  }
 
-        for (; t < nt; t++)
-        {
-          const gdouble hxo    = hx0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
-          const gdouble hyo    = hy0 * ((po == 0) ? ncm_vector_get (dtable->h, t) : sqrt (ncm_vector_get (dtable->h, t)));
-          volatile gdouble t_x = x + hxo;
-          const gdouble hx     = t_x - x;
-          volatile gdouble t_y = y + hyo;
-          const gdouble hy     = t_y - y;
+  if (Eerr_m != NULL)
+  {
+    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
+  }
 
-          gdouble df_t   = 0.0;
-          gdouble roff_t = 0.0;
+  {
+    ncm_vector_clear (&x_v);
 
-          Hstep_algo (diff, f, user_data, a, x, hx, b, y, hy, x_v, fval, &df_t, &roff_t);
+    ncm_matrix_clear (&df_m);
+    ncm_matrix_clear (&Eerr_m);
 
-          g_array_append_val (dfs,   df_t);
-          g_array_append_val (roffs, roff_t);
+    return df;
+  }
+}
 
-          ncm_vector_set (x_v, a, x);
-          ncm_vector_set (x_v, b, y);
-        }
+static void
+_ncm_diff_trans_N_to_1 (NcmVector *x, NcmVector *y, gpointer user_data)
+{
+  NcmDiffFuncParams *fp = (NcmDiffFuncParams *) user_data;
+  ncm_vector_set (y, 0, fp->f_N_to_1 (x, fp->user_data));
+}
 
-        if (ldtable == NULL)
-        {
-          const gdouble lambda0 = ncm_vector_get (dtable->lambda, 0);
-          const gdouble lambda1 = ncm_vector_get (dtable->lambda, 1);
-          
-          dfb   = g_array_index (dfs, gdouble, 0);
-          dfr   = dfb * lambda0 + g_array_index (dfs, gdouble, 1) * lambda1;
+/*
+ * Multi-threaded versions: every direction $a$ (or pair $(a, b)$ for the
+ * mixed derivatives) is an independent Richardson sequence and is sent to
+ * the thread pool as a separated task. Each task obtains its own user data
+ * from the memory pool @mp and writes only to its own row (element) of the
+ * result, hence the output does not depend on the scheduling.
+ */
 
-          roffb = g_array_index (roffs, gdouble, 0);
-          roffr = roffb * lambda0 + g_array_index (roffs, gdouble, 1) * lambda1;
+typedef struct _NcmDiffMTArg
+{
+  NcmDiff *diff;
+  NcmDiffStepAlgo step_algo;
+  NcmDiffHessianStepAlgo Hstep_algo;
+  GPtrArray *tables;
+  guint po;
+  guint dim;
+  NcmVector *x_v;
+  NcmVector *f_v;
+  gdouble fval;
+  NcmDiffFuncNtoM f;
+  NcmDiffFuncNto1 f_N_to_1;
+  NcmMemoryPool *mp;
+  NcmMatrix *df_m;
+  NcmMatrix *Eerr_m;
+} NcmDiffMTArg;
 
-          df_best = dfb;
-        }
-        else
-        {
-          dfr   = 0.0;
-          roffr = 0.0;
+static void
+_ncm_diff_by_step_algo_mt_eval (glong i, glong f, gpointer data)
+{
+  NcmDiffMTArg *arg    = (NcmDiffMTArg *) data;
+  gpointer *ud_ptr     = ncm_memory_pool_get (arg->mp);
+  NcmVector *x_v       = ncm_vector_dup (arg->x_v);
+  NcmDiffFuncParams fp = {NULL, arg->f_N_to_1, NULL, *ud_ptr};
+  NcmDiffFuncNtoM func = (arg->f_N_to_1 != NULL) ? &_ncm_diff_trans_N_to_1 : arg->f;
+  gpointer user_data   = (arg->f_N_to_1 != NULL) ? &fp : *ud_ptr;
+  glong a;
+
+  for (a = i; a < f; a++)
+  {
+    NcmVector *df_a   = ncm_matrix_get_row (arg->df_m, a);
+    NcmVector *Eerr_a = (arg->Eerr_m != NULL) ? ncm_matrix_get_row (arg->Eerr_m, a) : NULL;
 
-          for (i = 0; i < nt; i++)
-          {
-            const gdouble lambda_i = ncm_vector_get (dtable->lambda,  i);
-            const gdouble df_i     = g_array_index (dfs, gdouble, i);
-            const gdouble roff_i   = g_array_index (roffs, gdouble, i);
-            
-            dfr   += lambda_i * df_i;
-            roffr += lambda_i * roff_i;
-          }
-        }
+    _ncm_diff_by_step_algo_a (arg->diff, arg->step_algo, arg->tables, arg->po, x_v, a, arg->dim, arg->f_v, func, user_data, df_a, Eerr_a);
 
-        err     = fabs (dfr - dfb);
-        err_err = (dfr == 0.0) ? ((dfb == 0.0) ? 0.0 : fabs (dfb)) : ((dfb == 0.0) ? fabs (dfr) : fabs ((dfr - dfb) / GSL_MIN (fabs (dfr), fabs (dfb))));
+    ncm_vector_free (df_a);
+    ncm_vector_clear (&Eerr_a);
+  }
 
-        {
-          gboolean improve = FALSE;
+  ncm_vector_free (x_v);
+  ncm_memory_pool_return (ud_ptr);
+}
 
-          const gdouble Eroffb = fabs (roffb) * diff->priv->roff_pad;
-          const gdouble Eroffr = fabs (roffr) * diff->priv->roff_pad;
-          const gdouble terr   = GSL_MAX (err, GSL_MAX (Eroffb, Eroffr));
-          gdouble cerr         = ferr;
+static GArray *
+ncm_diff_by_step_algo_mt (NcmDiff *diff, NcmDiffStepAlgo step_algo, guint po, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, NcmDiffFuncNto1 f_N_to_1, NcmMemoryPool *mp, GArray **Eerr)
+{
+  GArray *df       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const guint nvar = x_a->len;
+  NcmDiffMTArg arg;
+
+  arg.diff       = diff;
+  arg.step_algo  = step_algo;
+  arg.Hstep_algo = NULL;
+  arg.tables     = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
+  arg.po         = po;
+  arg.dim        = dim;
+  arg.x_v        = ncm_vector_new_array (x_a);
+  arg.f_v        = ncm_vector_new (dim);
+  arg.fval       = 0.0;
+  arg.f          = f;
+  arg.f_N_to_1   = f_N_to_1;
+  arg.mp         = mp;
+  arg.Eerr_m     = NULL;
 
-          if (not_converging && (err_err < 1.0e-3))
-            not_converging--;
-          else 
-          {
-            if (err_err > 1.0e-3)
-            {
-              not_converging = ntry_conv;
-              if (err_err > 1.0)
-                ferr = GSL_POSINF;
-            }
-          }
-          
-/*          
-          printf ("[%3u, %3u, %3u] !conv %u % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g % 22.15g", 
-                  nt, a, b, not_converging, ferr, err, Eroffb, Eroffr, terr, err_err);
-*/
-          if ((terr < ferr) && !not_converging)
-          {
-            df_best = dfr;
-            ferr    = terr;
-            cerr    = terr;
-            improve = TRUE;
+  g_array_set_size (df, dim * nvar);
+  arg.df_m = ncm_matrix_new_array (df, dim);
 
-            /*printf (" -UP-");*/
-          }
-/*
-          else
-            printf ("     ");
-*/
-          if (not_converging || (Eroffr < cerr))
-            improve = TRUE;
+  if (Eerr != NULL)
+  {
+    *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    g_array_set_size (*Eerr, dim * nvar);
+    arg.Eerr_m = ncm_matrix_new_array (*Eerr, dim);
+  }
 
-          /*printf (" improve: %s\n", improve ? "T" : "F");*/
+  {
+    gpointer *ud_ptr = ncm_memory_pool_get (mp);
+    if (f_N_to_1 != NULL)
+      ncm_vector_set (arg.f_v, 0, f_N_to_1 (arg.x_v, *ud_ptr));
+    else
+      f (arg.x_v, arg.f_v, *ud_ptr);
+    ncm_memory_pool_return (ud_ptr);
+  }
 
-          if (!improve)
-            break;
-        }
-        
-        dfb     = dfr;
-        roffb   = roffr;
-        ldtable = dtable;
-      }
+  if (nvar > 0)
+    ncm_func_eval_threaded_loop_full (&_ncm_diff_by_step_algo_mt_eval, 0, nvar, &arg);
 
-      ncm_matrix_set (df_m, a, b, df_best);
-      ncm_matrix_set (df_m, b, a, df_best);
-      
-      if (Eerr_m != NULL)
-      {
-        ncm_matrix_set (Eerr_m, a, b, ferr);
-        ncm_matrix_set (Eerr_m, b, a, ferr);
-      }
+  if (arg.Eerr_m != NULL)
+  {
+    ncm_matrix_scale (arg.Eerr_m, NCM_DIFF_ERR_PAD);
+  }
+
+  {
+    ncm_vector_clear (&arg.x_v);
+    ncm_vector_clear (&arg.f_v);
+
+    ncm_matrix_clear (&arg.df_m);
+    ncm_matrix_clear (&arg.Eerr_m);
+
+    return df;
+  }
+}
+
+static void
+_ncm_diff_Hessian_by_step_algo_mt_eval (glong i, glong f, gpointer data)
+{
+  NcmDiffMTArg *arg = (NcmDiffMTArg *) data;
+  gpointer *ud_ptr  = ncm_memory_pool_get (arg->mp);
+  NcmVector *x_v    = ncm_vector_dup (arg->x_v);
+  const guint nvar  = ncm_vector_len (x_v);
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    /* Maps the linear index k into the pair (a, b) with a < b in row-major order. */
+    guint a = 0;
+    guint b;
+    glong k_a = k;
+    gdouble df_ab, Eerr_ab;
+
+    while (k_a >= (glong) (nvar - a - 1))
+    {
+      k_a -= nvar - a - 1;
+      a++;
+    }
+    b = a + 1 + k_a;
+
+    _ncm_diff_Hessian_by_step_algo_ab (arg->diff, arg->Hstep_algo, arg->tables, arg->po, x_v, a, b, arg->fval, arg->f_N_to_1, *ud_ptr, &df_ab, &Eerr_ab);
+
+    ncm_matrix_set (arg->df_m, a, b, df_ab);
+    ncm_matrix_set (arg->df_m, b, a, df_ab);
+
+    if (arg->Eerr_m != NULL)
+    {
+      ncm_matrix_set (arg->Eerr_m, a, b, Eerr_ab);
+      ncm_matrix_set (arg->Eerr_m, b, a, Eerr_ab);
     }
   }
 
-  if (Eerr_m != NULL)
+  ncm_vector_free (x_v);
+  ncm_memory_pool_return (ud_ptr);
+}
+
+static GArray *
+ncm_diff_Hessian_by_step_algo_mt (NcmDiff *diff, NcmDiffHessianStepAlgo Hstep_algo, guint po, GArray *x_a, NcmDiffFuncNto1 f, NcmMemoryPool *mp, GArray **Eerr)
+{
+  GArray *df        = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const guint nvar  = x_a->len;
+  const guint npair = (nvar > 1) ? nvar * (nvar - 1) / 2 : 0;
+  NcmDiffMTArg arg;
+
+  arg.diff       = diff;
+  arg.step_algo  = NULL;
+  arg.Hstep_algo = Hstep_algo;
+  arg.tables     = (po == 0) ? diff->priv->forward_tables : diff->priv->central_tables;
+  arg.po         = po;
+  arg.dim        = 1;
+  arg.x_v        = ncm_vector_new_array (x_a);
+  arg.f_v        = NULL;
+  arg.f          = NULL;
+  arg.f_N_to_1   = f;
+  arg.mp         = mp;
+  arg.Eerr_m     = NULL;
+
+  g_array_set_size (df, nvar * nvar);
+  arg.df_m = ncm_matrix_new_array (df, nvar);
+
+  if (Eerr != NULL)
   {
-    ncm_matrix_scale (Eerr_m, NCM_DIFF_ERR_PAD);
+    *Eerr = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    g_array_set_size (*Eerr, nvar * nvar);
+    arg.Eerr_m = ncm_matrix_new_array (*Eerr, nvar);
   }
-  
+
   {
-    g_array_unref (dfs);
-    g_array_unref (roffs);
+    gpointer *ud_ptr = ncm_memory_pool_get (mp);
+    arg.fval = f (arg.x_v, *ud_ptr);
+    ncm_memory_pool_return (ud_ptr);
+  }
 
-    ncm_vector_clear (&x_v);
+  if (npair > 0)
+    ncm_func_eval_threaded_loop_full (&_ncm_diff_Hessian_by_step_algo_mt_eval, 0, npair, &arg);
 
-    ncm_matrix_clear (&df_m);
-    ncm_matrix_clear (&Eerr_m);
+  if (arg.Eerr_m != NULL)
+  {
+    ncm_matrix_scale (arg.Eerr_m, NCM_DIFF_ERR_PAD);
+  }
+
+  {
+    ncm_vector_clear (&arg.x_v);
+
+    ncm_matrix_clear (&arg.df_m);
+    ncm_matrix_clear (&arg.Eerr_m);
 
     return df;
   }
@@ -1237,14 +1453,6 @@ ncm_diff_rc_d2_N_to_M (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncN
   return ncm_diff_by_step_algo (diff, _ncm_diff_rc_d2_step, 1, x_a, dim, f, user_data, Eerr);
 }
 
-typedef struct _NcmDiffFuncParams
-{
-  NcmDiffFunc1toM f_1_to_M;
-  NcmDiffFuncNto1 f_N_to_1;
-  NcmDiffFunc1to1 f_1_to_1;
-  gpointer user_data;
-} NcmDiffFuncParams;
-
 static void 
 _ncm_diff_trans_1_to_M (NcmVector *x, NcmVector *y, gpointer user_data)
 {
@@ -1252,13 +1460,6 @@ _ncm_diff_trans_1_to_M (NcmVector *x, NcmVector *y, gpointer user_data)
   fp->f_1_to_M (ncm_vector_get (x, 0), y, fp->user_data);
 }
 
-static void 
-_ncm_diff_trans_N_to_1 (NcmVector *x, NcmVector *y, gpointer user_data)
-{
-  NcmDiffFuncParams *fp = (NcmDiffFuncParams *) user_data;
-  ncm_vector_set (y, 0, fp->f_N_to_1 (x, fp->user_data));
-}
-
 static void 
 _ncm_diff_trans_1_to_1 (NcmVector *x, NcmVector *y, gpointer user_data)
 {
@@ -1468,6 +1669,69 @@ ncm_diff_rf_Hessian_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpoin
   return res;
 }
 
+/**
+ * ncm_diff_rf_d1_N_to_M_mt: (skip)
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @dim: dimension of @f
+ * @f: (scope call): function to differentiate
+ * @mp: a #NcmMemoryPool of user data for @f
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rf_d1_N_to_M() but each partial derivative is computed 
+ * in a different thread. Each thread calls @f using its own user data 
+ * obtained from @mp, that is, the slices of @mp must be independent 
+ * copies of the function user data.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The derivative of @f at @x_a.
+ */
+GArray *
+ncm_diff_rf_d1_N_to_M_mt (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, NcmMemoryPool *mp, GArray **Eerr)
+{
+  return ncm_diff_by_step_algo_mt (diff, _ncm_diff_rf_d1_step, 0, x_a, dim, f, NULL, mp, Eerr);
+}
+
+/**
+ * ncm_diff_rf_Hessian_N_to_1_mt: (skip)
+ * @diff: a #NcmDiff
+ * @x_a: (array) (element-type double) (in): function argument
+ * @f: (scope call): function to differentiate
+ * @mp: a #NcmMemoryPool of user data for @f
+ * @Eerr: (array) (element-type double) (out) (transfer full): estimated errors
+ * 
+ * Same as ncm_diff_rf_Hessian_N_to_1() but each diagonal element and each 
+ * pair of the off-diagonal elements are computed in a different thread. 
+ * See ncm_diff_rf_d1_N_to_M_mt() for the requirements on @mp.
+ * 
+ * Returns: (transfer full) (array) (element-type double): The Hessian of @f at @x_a.
+ */
+GArray *
+ncm_diff_rf_Hessian_N_to_1_mt (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, NcmMemoryPool *mp, GArray **Eerr)
+{
+  GArray *dEerr = NULL;
+
+  GArray *diag = ncm_diff_by_step_algo_mt (diff, _ncm_diff_rc_d2_step, 1, x_a, 1, NULL, f, mp, &dEerr);
+  GArray *res  = ncm_diff_Hessian_by_step_algo_mt (diff, _ncm_diff_rf_Hessian_step, 0, x_a, f, mp, Eerr);
+
+  guint i;
+
+  g_assert_cmpuint (diag->len * diag->len, ==, res->len);
+  
+  for (i = 0; i < diag->len; i++)
+  {
+    g_array_index (res, gdouble, i * diag->len + i) = g_array_index (diag, gdouble, i);
+    if (Eerr != NULL)
+    {
+      g_array_index (*Eerr, gdouble, i * diag->len + i) = g_array_index (dEerr, gdouble, i);
+    }
+  }
+
+  g_array_unref (dEerr);
+  g_array_unref (diag);
+
+  return res;
+}
+
 /**
  * ncm_diff_rf_d1_1_to_1:
  * @diff: a #NcmDiff
@@ -32,6 +32,7 @@
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_vector.h>
 #include <numcosmo/math/ncm_matrix.h>
+#include <numcosmo/math/ncm_memory_pool.h>
 
 G_BEGIN_DECLS
 
@@ -109,6 +110,9 @@ GArray *ncm_diff_rc_d2_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gp
 
 GArray *ncm_diff_rf_Hessian_N_to_1 (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, gpointer user_data, GArray **Eerr);
 
+GArray *ncm_diff_rf_d1_N_to_M_mt (NcmDiff *diff, GArray *x_a, const guint dim, NcmDiffFuncNtoM f, NcmMemoryPool *mp, GArray **Eerr);
+GArray *ncm_diff_rf_Hessian_N_to_1_mt (NcmDiff *diff, GArray *x_a, NcmDiffFuncNto1 f, NcmMemoryPool *mp, GArray **Eerr);
+
 gdouble ncm_diff_rf_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpointer user_data, gdouble *err);
 gdouble ncm_diff_rc_d1_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpointer user_data, gdouble *err);
 gdouble ncm_diff_rc_d2_1_to_1 (NcmDiff *diff, const gdouble x, NcmDiffFunc1to1 f, gpointer user_data, gdouble *err);
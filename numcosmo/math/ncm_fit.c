@@ -42,6 +42,7 @@
 #include "math/ncm_util.h"
 #include "math/integral.h"
 #include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 #include "math/ncm_fit_gsl_ls.h"
 #include "math/ncm_fit_gsl_mm.h"
 #include "math/ncm_fit_gsl_mms.h"
@@ -96,8 +97,13 @@ ncm_fit_init (NcmFit *fit)
   fit->equality_constraints_tot   = g_array_new (FALSE, FALSE, sizeof (gdouble));
   fit->inequality_constraints_tot = g_array_new (FALSE, FALSE, sizeof (gdouble));
 
-  fit->sub_fit = NULL;
-  fit->diff    = ncm_diff_new ();
+  fit->sub_fit    = NULL;
+  fit->warm_covar = NULL;
+  fit->diff       = ncm_diff_new ();
+  fit->nthreads = 0;
+  fit->mp       = NULL;
+  fit->ser      = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  g_mutex_init (&fit->dup_lock);
 }
 
 static void
@@ -277,6 +283,8 @@ _ncm_fit_constructed (GObject *object)
   }
 }
 
+static void _ncm_fit_clear_mt_pool (NcmFit *fit);
+
 static void
 ncm_fit_dispose (GObject *object)
 {
@@ -292,9 +300,13 @@ ncm_fit_dispose (GObject *object)
   g_clear_pointer (&fit->inequality_constraints_tot, g_array_unref);
 
   ncm_fit_clear (&fit->sub_fit);
+  ncm_matrix_clear (&fit->warm_covar);
 
   ncm_diff_clear (&fit->diff);
 
+  _ncm_fit_clear_mt_pool (fit);
+  ncm_serialize_clear (&fit->ser);
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_parent_class)->dispose (object);
 }
@@ -305,6 +317,7 @@ ncm_fit_finalize (GObject *object)
   NcmFit *fit = NCM_FIT (object);
 
   g_timer_destroy (fit->timer);
+  g_mutex_clear (&fit->dup_lock);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_parent_class)->finalize (object);
@@ -442,6 +455,116 @@ _ncm_fit_reset (NcmFit *fit)
   }
 }
 
+/*
+ * Each thread worker holds a copy of the fit object and a pointer to the 
+ * main one, the parameters of the copy are synchronized with the main 
+ * #NcmMSet before each evaluation.
+ */
+
+typedef struct _NcmFitMTWorker
+{
+  NcmFit *fit;
+  NcmFit *main_fit;
+} NcmFitMTWorker;
+
+static gpointer
+_ncm_fit_mt_worker_dup (gpointer userdata)
+{
+  NcmFit *fit = NCM_FIT (userdata);
+
+  g_mutex_lock (&fit->dup_lock);
+  {
+    NcmFitMTWorker *fw = g_new (NcmFitMTWorker, 1);
+
+    fw->fit      = ncm_fit_dup (fit, fit->ser);
+    fw->main_fit = fit;
+
+    ncm_serialize_reset (fit->ser, TRUE);
+    g_mutex_unlock (&fit->dup_lock);
+
+    return fw;
+  }
+}
+
+static void
+_ncm_fit_mt_worker_free (gpointer userdata)
+{
+  NcmFitMTWorker *fw = (NcmFitMTWorker *) userdata;
+
+  ncm_fit_clear (&fw->fit);
+  g_free (fw);
+}
+
+static NcmMemoryPool *
+_ncm_fit_peek_mt_pool (NcmFit *fit)
+{
+  if (fit->mp == NULL)
+    fit->mp = ncm_memory_pool_new (&_ncm_fit_mt_worker_dup, fit, &_ncm_fit_mt_worker_free);
+
+  return fit->mp;
+}
+
+static void
+_ncm_fit_clear_mt_pool (NcmFit *fit)
+{
+  if (fit->mp != NULL)
+  {
+    ncm_memory_pool_free (fit->mp, TRUE);
+    fit->mp = NULL;
+  }
+}
+
+static void
+_ncm_fit_mt_worker_sync (NcmFitMTWorker *fw)
+{
+  ncm_mset_param_set_mset (fw->fit->mset, fw->main_fit->mset);
+}
+
+/*
+ * The synchronization above only transfers the parameter values. The
+ * copies are still valid if they have the same models, free parameters
+ * and likelihood (data and priors) as the main object, the latter is
+ * compared through the serialized form.
+ */
+static gboolean
+_ncm_fit_mt_pool_is_valid (NcmFit *fit)
+{
+  NcmFitMTWorker **fw_ptr = ncm_memory_pool_get (fit->mp);
+  NcmFitMTWorker *fw      = *fw_ptr;
+  const guint fparam_len  = ncm_mset_fparam_len (fit->mset);
+  gboolean valid          = ncm_mset_cmp (fw->fit->mset, fit->mset, TRUE) && (ncm_mset_fparam_len (fw->fit->mset) == fparam_len);
+  guint i;
+
+  for (i = 0; valid && (i < fparam_len); i++)
+  {
+    const NcmMSetPIndex *pi   = ncm_mset_fparam_get_pi (fit->mset, i);
+    const NcmMSetPIndex *w_pi = ncm_mset_fparam_get_pi (fw->fit->mset, i);
+
+    valid = (pi->mid == w_pi->mid) && (pi->pid == w_pi->pid);
+  }
+
+  if (valid)
+  {
+    GVariant *lh_var   = ncm_serialize_to_variant (fit->ser, G_OBJECT (fit->lh));
+    GVariant *w_lh_var = NULL;
+
+    ncm_serialize_reset (fit->ser, TRUE);
+    w_lh_var = ncm_serialize_to_variant (fit->ser, G_OBJECT (fw->fit->lh));
+    ncm_serialize_reset (fit->ser, TRUE);
+
+    valid = g_variant_equal (lh_var, w_lh_var);
+
+    g_variant_unref (lh_var);
+    g_variant_unref (w_lh_var);
+  }
+
+  ncm_memory_pool_return (fw_ptr);
+
+  return valid;
+}
+
+#define _NCM_FIT_USE_MT(fit) (((fit)->nthreads > 1) && (ncm_mset_fparam_len ((fit)->mset) > 1))
+
 /**
  * ncm_fit_new:
  * @ftype: a #NcmFitType
@@ -528,6 +651,46 @@ ncm_fit_dup (NcmFit *fit, NcmSerialize *ser)
   return NCM_FIT (ncm_serialize_dup_obj (ser, G_OBJECT (fit)));
 }
 
+/**
+ * ncm_fit_dup_with_dataset:
+ * @fit: a #NcmFit
+ * @dset: a #NcmDataset
+ * @ser: a #NcmSerialize
+ *
+ * Duplicates @fit as ncm_fit_dup(), except that the likelihood of the
+ * duplicate uses @dset, by reference, instead of a copy of the dataset
+ * of @fit. This is used together with ncm_dataset_bootstrap_view()
+ * to avoid copying large datasets.
+ *
+ * Returns: (transfer full): the duplicate of @fit using @dset.
+ */
+NcmFit *
+ncm_fit_dup_with_dataset (NcmFit *fit, NcmDataset *dset, NcmSerialize *ser)
+{
+  const gchar *name     = "_ncm_fit_dup_with_dataset_dset";
+  NcmDataset *fit_dset  = fit->lh->dset;
+  GVariant *var;
+  NcmFit *dup;
+
+  g_assert (G_OBJECT_TYPE (dset) == G_OBJECT_TYPE (fit_dset));
+
+  /*
+   * The dataset of @fit is serialized as a named instance, which is
+   * then replaced by @dset before deserializing.
+   */
+  ncm_serialize_set (ser, fit_dset, name, TRUE);
+  var = ncm_serialize_to_variant (ser, G_OBJECT (fit));
+  ncm_serialize_unset (ser, fit_dset);
+
+  ncm_serialize_set (ser, dset, name, TRUE);
+  dup = NCM_FIT (ncm_serialize_from_variant (ser, var));
+  ncm_serialize_unset (ser, dset);
+
+  g_variant_unref (var);
+
+  return dup;
+}
+
 /**
  * ncm_fit_free:
  * @fit: a #NcmFit
@@ -607,6 +770,101 @@ ncm_fit_get_sub_fit (NcmFit *fit)
   return ncm_fit_ref (fit->sub_fit);
 }
 
+/**
+ * ncm_fit_set_warm_start:
+ * @fit: a #NcmFit
+ * @covar: (allow-none): a #NcmMatrix or NULL
+ *
+ * Sets @covar as an estimate of the covariance of the free parameters
+ * around the point where the next minimizations start, for example the
+ * covariance of a previous fit to a similar data set. The backends that
+ * support it use @covar to set their initial steps: #NcmFitGSLMM sets the
+ * size of the first trial step, #NcmFitNLOpt sets the initial step of each
+ * parameter and #NcmFitLevmar starts with a small damping term, i.e., closer
+ * to a Gauss-Newton step. The other backends ignore it. Pass NULL to return
+ * to the default (cold) initialization.
+ *
+ */
+void
+ncm_fit_set_warm_start (NcmFit *fit, NcmMatrix *covar)
+{
+  if (covar != NULL)
+  {
+    const guint fparam_len = ncm_mset_fparams_len (fit->mset);
+    
+    g_assert_cmpuint (ncm_matrix_nrows (covar), ==, fparam_len);
+    g_assert_cmpuint (ncm_matrix_ncols (covar), ==, fparam_len);
+    ncm_matrix_ref (covar);
+  }
+
+  ncm_matrix_clear (&fit->warm_covar);
+  fit->warm_covar = covar;
+}
+
+/**
+ * ncm_fit_peek_warm_start:
+ * @fit: a #NcmFit
+ *
+ * Returns: (transfer none): the warm start covariance set by ncm_fit_set_warm_start() or NULL.
+ */
+NcmMatrix *
+ncm_fit_peek_warm_start (NcmFit *fit)
+{
+  return fit->warm_covar;
+}
+
+/**
+ * ncm_fit_set_warm_start_from:
+ * @fit: a #NcmFit
+ * @ref: a #NcmFit
+ *
+ * Sets the warm start covariance of @fit, see ncm_fit_set_warm_start(),
+ * using the covariance computed in @ref restricted to the free parameters
+ * of @fit. This is meant for profile fits, where @fit keeps fixed some of
+ * the parameters fitted by @ref. Every free parameter of @fit must also
+ * be free in @ref and the covariance of @ref must be available.
+ *
+ */
+void
+ncm_fit_set_warm_start_from (NcmFit *fit, NcmFit *ref)
+{
+  const guint fparam_len = ncm_mset_fparams_len (fit->mset);
+
+  if (fparam_len == 0)
+  {
+    ncm_fit_set_warm_start (fit, NULL);
+  }
+  else
+  {
+    NcmMatrix *covar = ncm_matrix_new (fparam_len, fparam_len);
+    guint *fpi       = g_new (guint, fparam_len);
+    guint a, b;
+
+    for (a = 0; a < fparam_len; a++)
+    {
+      const NcmMSetPIndex *pi = ncm_mset_fparam_get_pi (fit->mset, a);
+      const gint ref_fpi      = ncm_mset_fparam_get_fpi (ref->mset, pi->mid, pi->pid);
+
+      if (ref_fpi < 0)
+        g_error ("ncm_fit_set_warm_start_from: parameter [%d:%u] is not free in the reference fit.",
+                 pi->mid, pi->pid);
+
+      fpi[a] = ref_fpi;
+    }
+
+    for (a = 0; a < fparam_len; a++)
+    {
+      for (b = 0; b < fparam_len; b++)
+        ncm_matrix_set (covar, a, b, ncm_fit_covar_fparam_cov (ref, fpi[a], fpi[b]));
+    }
+
+    ncm_fit_set_warm_start (fit, covar);
+
+    ncm_matrix_free (covar);
+    g_free (fpi);
+  }
+}
+
 static NcmFitGrad _ncm_fit_grad_analitical = {
   NCM_FIT_GRAD_ANALYTICAL,
   "Analytical gradient",
@@ -788,6 +1046,46 @@ ncm_fit_get_params_reltol (NcmFit *fit)
   return fit->params_reltol;
 }
 
+/**
+ * ncm_fit_set_nthreads:
+ * @fit: a #NcmFit
+ * @nthreads: number of threads
+ *
+ * If @nthreads is larger than one, the numerical derivatives 
+ * computed through ncm_fit_ls_J_nd_fo(), ncm_fit_ls_J_nd_ce(),
+ * ncm_fit_ls_J_nd_ac(), ncm_fit_numdiff_m2lnL_hessian() and the 
+ * Fisher matrix in ncm_fit_fisher() are evaluated using the thread 
+ * pool. Each thread uses its own copy of @fit obtained through 
+ * ncm_fit_dup(). These copies are created on demand and kept between
+ * runs, their parameters are synchronized with @fit before each
+ * evaluation. They are discarded by this function and by ncm_fit_reset()
+ * (called at the beginning of every ncm_fit_run()) when the models, the
+ * free parameters or the likelihood of @fit changed.
+ * 
+ * Note that this setting is not transmitted to the copies
+ * obtained using ncm_fit_dup().
+ *
+ */
+void
+ncm_fit_set_nthreads (NcmFit *fit, guint nthreads)
+{
+  fit->nthreads = nthreads;
+  _ncm_fit_clear_mt_pool (fit);
+}
+
+/**
+ * ncm_fit_get_nthreads:
+ * @fit: a #NcmFit
+ *
+ * Returns: the number of threads used to compute numerical derivatives, 
+ * see ncm_fit_set_nthreads().
+ */
+guint
+ncm_fit_get_nthreads (NcmFit *fit)
+{
+  return fit->nthreads;
+}
+
 /**
  * ncm_fit_peek_mset:
  * @fit: a #NcmFit
@@ -1145,6 +1443,9 @@ _ncm_fit_run_empty (NcmFit *fit, NcmFitRunMsgs mtype)
 void
 ncm_fit_reset (NcmFit *fit)
 {
+  if ((fit->mp != NULL) && !_ncm_fit_mt_pool_is_valid (fit))
+    _ncm_fit_clear_mt_pool (fit);
+
   NCM_FIT_GET_CLASS (fit)->reset (fit);
 }
 
@@ -1588,6 +1889,9 @@ ncm_fit_fishermatrix_print (NcmFit *fit, FILE *out, gchar *header)
 
 static gdouble _ncm_fit_numdiff_m2lnL_val (NcmVector *x, gpointer user_data);
 static void _ncm_fit_numdiff_ls_f (NcmVector *x, NcmVector *y, gpointer user_data);
+static gdouble _ncm_fit_numdiff_m2lnL_val_mt (NcmVector *x, gpointer user_data);
+static void _ncm_fit_numdiff_ls_f_mt (NcmVector *x, NcmVector *y, gpointer user_data);
+static void _ncm_fit_ls_J_nd_mt (NcmFit *fit, NcmMatrix *J, gboolean central);
 
 /**
  * ncm_fit_m2lnL_grad_an:
@@ -1866,6 +2170,13 @@ ncm_fit_ls_J_nd_fo (NcmFit *fit, NcmMatrix *J)
 
   ncm_fit_ls_f (fit, fit->fstate->ls_f);
 
+  if (_NCM_FIT_USE_MT (fit))
+  {
+    _ncm_fit_ls_J_nd_mt (fit, J, FALSE);
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     NcmVector *J_col_i = ncm_matrix_get_col (J, i);
@@ -1903,6 +2214,13 @@ ncm_fit_ls_J_nd_ce (NcmFit *fit, NcmMatrix *J)
   guint fparam_len = ncm_mset_fparam_len (fit->mset);
   guint i;
 
+  if (_NCM_FIT_USE_MT (fit))
+  {
+    _ncm_fit_ls_J_nd_mt (fit, J, TRUE);
+    fit->fstate->grad_eval++;
+    return;
+  }
+
   for (i = 0; i < fparam_len; i++)
   {
     NcmVector *J_col_i = ncm_matrix_get_col (J, i);
@@ -1953,7 +2271,10 @@ ncm_fit_ls_J_nd_ac (NcmFit *fit, NcmMatrix *J)
   x = ncm_vector_new_array (x_a);
 
   ncm_mset_fparams_get_vector (fit->mset, x);
-  J_a = ncm_diff_rf_d1_N_to_M (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f, fit, NULL);
+  if (_NCM_FIT_USE_MT (fit))
+    J_a = ncm_diff_rf_d1_N_to_M_mt (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f_mt, _ncm_fit_peek_mt_pool (fit), NULL);
+  else
+    J_a = ncm_diff_rf_d1_N_to_M (fit->diff, x_a, data_len, _ncm_fit_numdiff_ls_f, fit, NULL);
 
   ncm_matrix_set_from_array (J, J_a);
   ncm_mset_fparams_set_vector (fit->mset, x);
@@ -2059,6 +2380,104 @@ _ncm_fit_numdiff_ls_f (NcmVector *x, NcmVector *y, gpointer user_data)
   ncm_fit_ls_f (fit, y);
 }
 
+static gdouble 
+_ncm_fit_numdiff_m2lnL_val_mt (NcmVector *x, gpointer user_data)
+{
+  NcmFitMTWorker *fw = (NcmFitMTWorker *) user_data;
+
+  _ncm_fit_mt_worker_sync (fw);
+  return _ncm_fit_numdiff_m2lnL_val (x, fw->fit);
+}
+
+static void
+_ncm_fit_numdiff_ls_f_mt (NcmVector *x, NcmVector *y, gpointer user_data)
+{
+  NcmFitMTWorker *fw = (NcmFitMTWorker *) user_data;
+
+  _ncm_fit_mt_worker_sync (fw);
+  _ncm_fit_numdiff_ls_f (x, y, fw->fit);
+}
+
+typedef struct _NcmFitMTJArg
+{
+  NcmFit *fit;
+  NcmMatrix *J;
+  gboolean central;
+} NcmFitMTJArg;
+
+static void
+_ncm_fit_ls_J_nd_mt_eval (glong i, glong f, gpointer data)
+{
+  NcmFitMTJArg *arg       = (NcmFitMTJArg *) data;
+  NcmFitMTWorker **fw_ptr = ncm_memory_pool_get (arg->fit->mp);
+  NcmFitMTWorker *fw      = *fw_ptr;
+  NcmFit *wfit            = fw->fit;
+  NcmVector *ls_f         = arg->fit->fstate->ls_f;
+  NcmVector *ls_f_pmh     = ncm_vector_new (ncm_vector_len (ls_f));
+  glong l;
+
+  _ncm_fit_mt_worker_sync (fw);
+
+  for (l = i; l < f; l++)
+  {
+    NcmVector *J_col_l    = ncm_matrix_get_col (arg->J, l);
+    const gdouble p       = ncm_mset_fparam_get (wfit->mset, l);
+    const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (wfit->mset, l));
+    guint k;
+
+    if (arg->central)
+    {
+      const gdouble h      = p_scale * GSL_ROOT3_DBL_EPSILON;
+      const gdouble pph    = p + h;
+      const gdouble pmh    = p - h;
+      const gdouble twoh   = pph - pmh;
+      const gdouble one_2h = 1.0 / twoh;
+
+      ncm_fit_params_set (wfit, l, pph);
+      ncm_fit_ls_f (wfit, J_col_l);
+
+      ncm_fit_params_set (wfit, l, pmh);
+      ncm_fit_ls_f (wfit, ls_f_pmh);
+
+      for (k = 0; k < ncm_vector_len (ls_f_pmh); k++)
+        ncm_vector_set (J_col_l, k,
+                        (ncm_vector_get (J_col_l, k) - ncm_vector_get (ls_f_pmh, k)) * one_2h
+                        );
+    }
+    else
+    {
+      const gdouble htilde = p_scale * GSL_SQRT_DBL_EPSILON;
+      const gdouble pph    = p + htilde;
+      const gdouble h      = pph - p;
+      const gdouble one_h  = 1.0 / h;
+
+      ncm_fit_params_set (wfit, l, pph);
+      ncm_fit_ls_f (wfit, J_col_l);
+
+      for (k = 0; k < ncm_vector_len (ls_f); k++)
+        ncm_vector_set (J_col_l, k,
+                        (ncm_vector_get (J_col_l, k) - ncm_vector_get (ls_f, k)) * one_h
+                        );
+    }
+
+    ncm_fit_params_set (wfit, l, p);
+    ncm_vector_free (J_col_l);
+  }
+
+  ncm_vector_free (ls_f_pmh);
+  ncm_memory_pool_return (fw_ptr);
+}
+
+static void
+_ncm_fit_ls_J_nd_mt (NcmFit *fit, NcmMatrix *J, gboolean central)
+{
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  NcmFitMTJArg arg       = {fit, J, central};
+
+  _ncm_fit_peek_mt_pool (fit);
+  ncm_func_eval_threaded_loop_full (&_ncm_fit_ls_J_nd_mt_eval, 0, fparam_len, &arg);
+}
+
 /**
  * ncm_fit_numdiff_m2lnL_hessian:
  * @fit: a #NcmFit
@@ -2080,7 +2499,10 @@ ncm_fit_numdiff_m2lnL_hessian (NcmFit *fit, NcmMatrix *H, gdouble reltol)
   x = ncm_vector_new_array (x_a);
 
   ncm_mset_fparams_get_vector (fit->mset, x);
-  H_a = ncm_diff_rf_Hessian_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
+  if (_NCM_FIT_USE_MT (fit))
+    H_a = ncm_diff_rf_Hessian_N_to_1_mt (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val_mt, _ncm_fit_peek_mt_pool (fit), NULL);
+  else
+    H_a = ncm_diff_rf_Hessian_N_to_1 (fit->diff, x_a, _ncm_fit_numdiff_m2lnL_val, fit, NULL);
 
   ncm_matrix_set_from_array (H, H_a);
   ncm_mset_fparams_set_vector (fit->mset, x);
@@ -2157,6 +2579,133 @@ ncm_fit_obs_fisher (NcmFit *fit)
   ncm_fit_numdiff_m2lnL_covar (fit);
 }
 
+typedef struct _NcmFitMTFisherArg
+{
+  NcmFit *fit;
+  NcmMatrix *dmu;
+} NcmFitMTFisherArg;
+
+static void
+_ncm_fit_dataset_mean_vector (NcmDataset *dset, NcmMSet *mset, NcmVector *mu)
+{
+  const guint ndata = ncm_dataset_get_length (dset);
+  guint offset      = 0;
+  guint i;
+
+  for (i = 0; i < ndata; i++)
+  {
+    NcmData *data   = ncm_dataset_peek_data (dset, i);
+    const guint len = ncm_data_get_length (data);
+    NcmVector *mu_i = ncm_vector_get_subvector (mu, offset, len);
+
+    ncm_data_mean_vector (data, mset, mu_i);
+
+    ncm_vector_free (mu_i);
+    offset += len;
+  }
+}
+
+/*
+ * Each row @l of arg->dmu receives the central difference derivative of
+ * the mean vectors of all data with respect to the @l-th free parameter.
+ */
+static void
+_ncm_fit_fisher_matrix_mt_eval (glong i, glong f, gpointer data)
+{
+  NcmFitMTFisherArg *arg  = (NcmFitMTFisherArg *) data;
+  NcmFitMTWorker **fw_ptr = ncm_memory_pool_get (arg->fit->mp);
+  NcmFitMTWorker *fw      = *fw_ptr;
+  NcmFit *wfit            = fw->fit;
+  NcmVector *mu_pmh       = ncm_vector_new (ncm_matrix_ncols (arg->dmu));
+  glong l;
+
+  _ncm_fit_mt_worker_sync (fw);
+
+  for (l = i; l < f; l++)
+  {
+    NcmVector *dmu_l      = ncm_matrix_get_row (arg->dmu, l);
+    const gdouble p       = ncm_mset_fparam_get (wfit->mset, l);
+    const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (wfit->mset, l));
+    const gdouble h       = p_scale * GSL_ROOT3_DBL_EPSILON;
+    const gdouble pph     = p + h;
+    const gdouble pmh     = p - h;
+    const gdouble one_2h  = 1.0 / (pph - pmh);
+
+    ncm_fit_params_set (wfit, l, pph);
+    _ncm_fit_dataset_mean_vector (wfit->lh->dset, wfit->mset, dmu_l);
+
+    ncm_fit_params_set (wfit, l, pmh);
+    _ncm_fit_dataset_mean_vector (wfit->lh->dset, wfit->mset, mu_pmh);
+
+    ncm_vector_sub (dmu_l, mu_pmh);
+    ncm_vector_scale (dmu_l, one_2h);
+
+    ncm_fit_params_set (wfit, l, p);
+    ncm_vector_free (dmu_l);
+  }
+
+  ncm_vector_free (mu_pmh);
+  ncm_memory_pool_return (fw_ptr);
+}
+
+/*
+ * The threaded version is only equivalent to ncm_dataset_fisher_matrix()
+ * when all data use the default Gaussian Fisher matrix of #NcmData.
+ */
+static gboolean
+_ncm_fit_fisher_matrix_has_mt (NcmFit *fit)
+{
+  NcmDataClass *data_class = g_type_class_peek (NCM_TYPE_DATA);
+  const guint ndata        = ncm_dataset_get_length (fit->lh->dset);
+  guint i;
+
+  if (!_NCM_FIT_USE_MT (fit))
+    return FALSE;
+
+  for (i = 0; i < ndata; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (fit->lh->dset, i);
+
+    if (NCM_DATA_GET_CLASS (data)->fisher_matrix != data_class->fisher_matrix)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+_ncm_fit_fisher_matrix_mt (NcmFit *fit, NcmMatrix **IM)
+{
+  const guint fparams_len = ncm_mset_fparams_len (fit->mset);
+  const guint ndata       = ncm_dataset_get_length (fit->lh->dset);
+  guint offset            = 0;
+  NcmFitMTFisherArg arg   = {fit, ncm_matrix_new (fparams_len, ncm_dataset_get_n (fit->lh->dset))};
+  guint i;
+
+  _ncm_fit_peek_mt_pool (fit);
+  ncm_func_eval_threaded_loop_full (&_ncm_fit_fisher_matrix_mt_eval, 0, fparams_len, &arg);
+
+  /* Summing in the data order makes the result independent of the scheduling. */
+  *IM = ncm_matrix_new (fparams_len, fparams_len);
+  ncm_matrix_set_zero (*IM);
+  for (i = 0; i < ndata; i++)
+  {
+    NcmData *data       = ncm_dataset_peek_data (fit->lh->dset, i);
+    const guint len     = ncm_data_get_length (data);
+    NcmMatrix *dmu_view = ncm_matrix_get_submatrix (arg.dmu, 0, offset, fparams_len, len);
+    NcmMatrix *dmu_i    = ncm_matrix_dup (dmu_view);
+
+    ncm_data_inv_cov_UH (data, fit->mset, dmu_i);
+    ncm_matrix_dgemm (*IM, 'N', 'T', 1.0, dmu_i, dmu_i, 1.0);
+
+    ncm_matrix_free (dmu_view);
+    ncm_matrix_free (dmu_i);
+    offset += len;
+  }
+
+  ncm_matrix_free (arg.dmu);
+}
+
 /**
  * ncm_fit_fisher:
  * @fit: a #NcmFit
@@ -2172,7 +2721,10 @@ ncm_fit_fisher (NcmFit *fit)
   if ((ncm_likelihood_priors_length_f (fit->lh) > 0) || (ncm_likelihood_priors_length_m2lnL (fit->lh) > 0))
     g_warning ("ncm_fit_fisher: the analysis contains priors which are ignored in the Fisher matrix calculation.");
 
-  ncm_dataset_fisher_matrix (fit->lh->dset, fit->mset, &IM);
+  if (_ncm_fit_fisher_matrix_has_mt (fit))
+    _ncm_fit_fisher_matrix_mt (fit, &IM);
+  else
+    ncm_dataset_fisher_matrix (fit->lh->dset, fit->mset, &IM);
   ncm_fit_fisher_to_covar (fit, IM);
 
   ncm_matrix_clear (&IM);
@@ -37,6 +37,7 @@
 #include <numcosmo/math/ncm_mset_func.h>
 #include <numcosmo/math/ncm_likelihood.h>
 #include <numcosmo/math/ncm_fit_state.h>
+#include <numcosmo/math/ncm_memory_pool.h>
 
 #ifndef NUMCOSMO_GIR_SCAN
 #ifdef HAVE_NLOPT_2_2
@@ -161,7 +162,12 @@ struct _NcmFit
   NcmObjArray *inequality_constraints;
 	GArray *inequality_constraints_tot;
   NcmFit *sub_fit;
+  NcmMatrix *warm_covar;
   NcmDiff *diff;
+  guint nthreads;
+  NcmMemoryPool *mp;
+  NcmSerialize *ser;
+  GMutex dup_lock;
 };
 
 GType ncm_fit_get_type (void) G_GNUC_CONST;
@@ -170,12 +176,17 @@ NcmFit *ncm_fit_new (NcmFitType ftype, gchar *algo_name, NcmLikelihood *lh, NcmM
 NcmFit *ncm_fit_ref (NcmFit *fit);
 NcmFit *ncm_fit_copy_new (NcmFit *fit, NcmLikelihood *lh, NcmMSet *mset, NcmFitGradType gtype);
 NcmFit *ncm_fit_dup (NcmFit *fit, NcmSerialize *ser);
+NcmFit *ncm_fit_dup_with_dataset (NcmFit *fit, NcmDataset *dset, NcmSerialize *ser);
 void ncm_fit_free (NcmFit *fit);
 void ncm_fit_clear (NcmFit **fit);
 
 void ncm_fit_set_sub_fit (NcmFit *fit, NcmFit *sub_fit);
 NcmFit *ncm_fit_get_sub_fit (NcmFit *fit);
 
+void ncm_fit_set_warm_start (NcmFit *fit, NcmMatrix *covar);
+NcmMatrix *ncm_fit_peek_warm_start (NcmFit *fit);
+void ncm_fit_set_warm_start_from (NcmFit *fit, NcmFit *ref);
+
 void ncm_fit_set_grad_type (NcmFit *fit, NcmFitGradType gtype);
 
 void ncm_fit_set_maxiter (NcmFit *fit, guint maxiter);
@@ -187,6 +198,9 @@ gdouble ncm_fit_get_m2lnL_reltol (NcmFit *fit);
 gdouble ncm_fit_get_m2lnL_abstol (NcmFit *fit);
 gdouble ncm_fit_get_params_reltol (NcmFit *fit);
 
+void ncm_fit_set_nthreads (NcmFit *fit, guint nthreads);
+guint ncm_fit_get_nthreads (NcmFit *fit);
+
 NcmMSet *ncm_fit_peek_mset (NcmFit *fit);
 
 NCM_INLINE void ncm_fit_params_set (NcmFit *fit, guint i, const gdouble x);
@@ -856,21 +856,18 @@ ncm_fit_esmcmc_set_sampler (NcmFitESMCMC *esmcmc, NcmMSetTransKern *tkern)
  * @esmcmc: a #NcmFitESMCMC
  * @nthreads: numbers of simultaneous walkers updates
  *
- * If @nthreads is larger than nwalkers / 2, it will be set to
- * nwalkers / 2.
+ * If @nthreads is larger than one the walkers in each half of the
+ * ensemble (see ncm_fit_esmcmc_walker_get_subset()) are updated
+ * simultaneously. There is no restriction on the number of walkers,
+ * the number of simultaneous updates is the size of the current half
+ * and the number of threads is controlled by
+ * ncm_func_eval_set_max_threads().
  *
  */
 void 
 ncm_fit_esmcmc_set_nthreads (NcmFitESMCMC *esmcmc, guint nthreads)
 {
 	NcmFitESMCMCPrivate * const self = esmcmc->priv;
-  if (nthreads > 0)
-  {
-    if (self->nwalkers % 2 == 1)
-      g_error ("ncm_fit_esmcmc_set_nthreads: cannot parallelize with an odd number of walkers [%u].", self->nwalkers);
-    if (nthreads > self->nwalkers / 2)
-      nthreads = self->nwalkers / 2;
-  }
   self->nthreads = nthreads;
 }
 
@@ -1093,12 +1090,18 @@ _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
   self->naccepted_lup = 0;
   self->noffboard_lup = 0;
 
-  for (k = ki; k < kf; k++)
   {
-    NcmVector *full_theta_k = g_ptr_array_index (self->full_theta, k);
+    GPtrArray *block = g_ptr_array_sized_new (kf - ki);
+
+    for (k = ki; k < kf; k++)
+      g_ptr_array_add (block, g_ptr_array_index (self->full_theta, k));
 
-    ncm_mset_catalog_add_from_vector (self->mcat, full_theta_k);
+    ncm_mset_catalog_add_from_vector_block (self->mcat, block);
+    g_ptr_array_unref (block);
+  }
 
+  for (k = ki; k < kf; k++)
+  {
     self->cur_sample_id++;
     ncm_timer_task_increment (self->nt);
 
@@ -1789,6 +1792,20 @@ _ncm_fit_esmcmc_run_mt (NcmFitESMCMC *esmcmc, const glong i, const glong f)
 	ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, i, f, esmcmc);
 }
 
+static void
+_ncm_fit_esmcmc_run_subsets (NcmFitESMCMC *esmcmc, void (*run) (NcmFitESMCMC *, const glong, const glong), const guint ki)
+{
+	NcmFitESMCMCPrivate * const self = esmcmc->priv;
+	guint s;
+
+	for (s = ncm_fit_esmcmc_walker_subset_of (self->walker, ki); s < 2; s++)
+	{
+		guint si, sf;
+		ncm_fit_esmcmc_walker_get_subset (self->walker, s, &si, &sf);
+		run (esmcmc, GSL_MAX (si, ki), sf);
+	}
+}
+
 static void
 _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
 {
@@ -1796,7 +1813,6 @@ _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
   NcmRNG *rng      = ncm_mset_catalog_peek_rng (self->mcat);
   gboolean mthread = (self->nthreads > 1);
 	void (*run) (NcmFitESMCMC *, const glong, const glong) = mthread ? (self->has_mpi ? _ncm_fit_esmcmc_eval_mpi : _ncm_fit_esmcmc_run_mt) : _ncm_fit_esmcmc_run_serial;
-	const guint nwalkers_2 = self->nwalkers / 2;
 	guint ki               = (self->cur_sample_id + 1) % self->nwalkers;
 	guint i;
 
@@ -1806,15 +1822,7 @@ _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
 		_ncm_fit_esmcmc_get_jumps (esmcmc, ki, self->nwalkers);
 		ncm_fit_esmcmc_walker_setup (self->walker, self->theta, self->m2lnL, ki, self->nwalkers, rng);
 
-		if (ki < nwalkers_2)
-		{
-			run (esmcmc, ki, nwalkers_2);
-			run (esmcmc, nwalkers_2, self->nwalkers);
-		}
-		else
-		{
-			run (esmcmc, ki, self->nwalkers);
-		}
+		_ncm_fit_esmcmc_run_subsets (esmcmc, run, ki);
 
 		ncm_fit_esmcmc_walker_clean (self->walker, ki, self->nwalkers);
 
@@ -1826,8 +1834,7 @@ _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
 			_ncm_fit_esmcmc_get_jumps (esmcmc, 0, self->nwalkers);
 			ncm_fit_esmcmc_walker_setup (self->walker, self->theta, self->m2lnL, 0, self->nwalkers, rng);
 
-			run (esmcmc, 0, nwalkers_2);
-			run (esmcmc, nwalkers_2, self->nwalkers);
+			_ncm_fit_esmcmc_run_subsets (esmcmc, run, 0);
 
 			ncm_fit_esmcmc_walker_clean (self->walker, 0, self->nwalkers);
 
@@ -45,7 +45,6 @@ enum
   PROP_0,
   PROP_SIZE,
   PROP_NPARAMS,
-  
 };
 
 G_DEFINE_ABSTRACT_TYPE (NcmFitESMCMCWalker, ncm_fit_esmcmc_walker, G_TYPE_OBJECT);
@@ -264,6 +263,51 @@ ncm_fit_esmcmc_walker_get_nparams (NcmFitESMCMCWalker *walker)
   return NCM_FIT_ESMCMC_WALKER_GET_CLASS (walker)->get_nparams (walker);
 }
 
+/**
+ * ncm_fit_esmcmc_walker_get_subset:
+ * @walker: a #NcmFitESMCMCWalker
+ * @s: subset index, 0 or 1
+ * @ki: (out): first walker index
+ * @kf: (out): last walker index
+ *
+ * The ensemble is partitioned in two halves, the walkers in a half are
+ * moved simultaneously using only the walkers in the other one. When the
+ * number of walkers is odd the second half contains the extra walker.
+ *
+ * Gets the walkers in the subset @s, i.e., from @ki to @kf (@kf not included).
+ *
+ */
+void
+ncm_fit_esmcmc_walker_get_subset (NcmFitESMCMCWalker *walker, guint s, guint *ki, guint *kf)
+{
+  const guint size = ncm_fit_esmcmc_walker_get_size (walker);
+
+  g_assert_cmpuint (s, <, 2);
+  g_assert_cmpuint (size, >=, 2);
+
+  ki[0] = (s == 0) ? 0        : size / 2;
+  kf[0] = (s == 0) ? size / 2 : size;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_subset_of:
+ * @walker: a #NcmFitESMCMCWalker
+ * @k: walker index
+ *
+ * See ncm_fit_esmcmc_walker_get_subset().
+ *
+ * Returns: the index of the subset containing the @k-th walker.
+ */
+guint
+ncm_fit_esmcmc_walker_subset_of (NcmFitESMCMCWalker *walker, guint k)
+{
+  const guint size = ncm_fit_esmcmc_walker_get_size (walker);
+
+  g_assert_cmpuint (k, <, size);
+
+  return (k < size / 2) ? 0 : 1;
+}
+
 /**
  * ncm_fit_esmcmc_walker_setup: (virtual setup)
  * @walker: a #NcmMSetCatalog
@@ -78,6 +78,9 @@ guint ncm_fit_esmcmc_walker_get_size (NcmFitESMCMCWalker *walker);
 void ncm_fit_esmcmc_walker_set_nparams (NcmFitESMCMCWalker *walker, guint nparams);
 guint ncm_fit_esmcmc_walker_get_nparams (NcmFitESMCMCWalker *walker);
 
+void ncm_fit_esmcmc_walker_get_subset (NcmFitESMCMCWalker *walker, guint s, guint *ki, guint *kf);
+guint ncm_fit_esmcmc_walker_subset_of (NcmFitESMCMCWalker *walker, guint k);
+
 void ncm_fit_esmcmc_walker_setup (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, guint ki, guint kf, NcmRNG *rng);
 void ncm_fit_esmcmc_walker_step (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k);
 gdouble ncm_fit_esmcmc_walker_prob (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k, const gdouble m2lnL_cur, const gdouble m2lnL_star);
@@ -0,0 +1,814 @@
+/***************************************************************************
+ *            ncm_fit_esmcmc_walker_adaptive.c
+ *
+ *  Sun October 18 16:20:31 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * ncm_fit_esmcmc_walker_adaptive.c
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:ncm_fit_esmcmc_walker_adaptive
+ * @title: NcmFitESMCMCWalkerAdaptive
+ * @short_description: Ensemble sampler Markov Chain Monte Carlo walker - adaptive proposal move.
+ *
+ * Implementing an adaptive proposal walker for #NcmFitESMCMC.
+ *
+ * The proposal is the mixture
+ * $$q(\theta^\star) = w\,q_\mathrm{KDE}(\theta^\star) + (1-w)\,\mathcal{N}(\theta^\star;\bar{\theta}, s^2\Sigma),$$
+ * where $q_\mathrm{KDE}$ is a #NcmStatsDistNdKDEGauss built from the walkers
+ * in the complementary set of the current subset (as in #NcmFitESMCMCWalkerAPS)
+ * and $\bar{\theta}$, $\Sigma$ are the mean and covariance of all ensembles seen
+ * so far. Both components do not depend on the current walker position, hence
+ * the acceptance probability has the same form as in the APS move.
+ *
+ * The covariance is accumulated online: at each setup the whole ensemble is
+ * added to the running mean and the Cholesky factor of the sum of squares is
+ * updated through a sequence of rank-one updates (a rank-$k$ update for an
+ * ensemble of $k$ walkers). No decomposition is recomputed between steps. The
+ * accumulator starts from a small diagonal term computed from the first
+ * ensemble, which keeps the factor positive definite and whose relative weight
+ * decreases as more ensembles are added.
+ *
+ * Since the proposal depends on the chain history, this is an adaptive MCMC.
+ * The adaptation diminishes as $1/n$, and it can be frozen at any time with
+ * ncm_fit_esmcmc_walker_adaptive_set_adapt(), for example after burn-in.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include "build_cfg.h"
+
+#include "math/ncm_fit_esmcmc_walker.h"
+#include "math/ncm_fit_esmcmc_walker_adaptive.h"
+
+#include "math/ncm_fit_esmcmc.h"
+#include "math/ncm_stats_dist_nd_kde_gauss.h"
+#include "math/ncm_util.h"
+#include "math/ncm_c.h"
+
+#ifndef NUMCOSMO_GIR_SCAN
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_randist.h>
+#endif /* NUMCOSMO_GIR_SCAN */
+
+enum
+{
+  PROP_0,
+  PROP_KDE_WEIGHT,
+  PROP_COV_SCALE,
+  PROP_ADAPT,
+};
+
+struct _NcmFitESMCMCWalkerAdaptivePrivate
+{
+  guint size;
+  guint nparams;
+  NcmVector *m2lnp_star;
+  NcmVector *m2lnp_cur;
+  gchar *desc;
+  GPtrArray *dndg;
+  GPtrArray *thetastar;
+  GPtrArray *tmp;
+  NcmVector *mean;
+  NcmVector *delta;
+  NcmMatrix *L;
+  gdouble lndetL;
+  guint nobs;
+  gdouble kde_weight;
+  gdouble cov_scale;
+  gboolean adapt;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (NcmFitESMCMCWalkerAdaptive, ncm_fit_esmcmc_walker_adaptive, NCM_TYPE_FIT_ESMCMC_WALKER);
+
+static void
+ncm_fit_esmcmc_walker_adaptive_init (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv = ncm_fit_esmcmc_walker_adaptive_get_instance_private (adaptive);
+
+  self->size       = 0;
+  self->nparams    = 0;
+  self->m2lnp_star = NULL;
+  self->m2lnp_cur  = NULL;
+  self->desc       = "Adaptive-Move";
+  self->dndg       = g_ptr_array_new ();
+  self->thetastar  = g_ptr_array_new ();
+  self->tmp        = g_ptr_array_new ();
+  self->mean       = NULL;
+  self->delta      = NULL;
+  self->L          = NULL;
+  self->lndetL     = 0.0;
+  self->nobs       = 0;
+  self->kde_weight = 0.0;
+  self->cov_scale  = 0.0;
+  self->adapt      = FALSE;
+
+  g_ptr_array_set_free_func (self->dndg, (GDestroyNotify) ncm_stats_dist_nd_kde_gauss_free);
+  g_ptr_array_set_free_func (self->thetastar, (GDestroyNotify) ncm_vector_free);
+  g_ptr_array_set_free_func (self->tmp, (GDestroyNotify) ncm_vector_free);
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (object);
+  g_return_if_fail (NCM_IS_FIT_ESMCMC_WALKER_ADAPTIVE (object));
+
+  switch (prop_id)
+  {
+    case PROP_KDE_WEIGHT:
+      ncm_fit_esmcmc_walker_adaptive_set_kde_weight (adaptive, g_value_get_double (value));
+      break;
+    case PROP_COV_SCALE:
+      ncm_fit_esmcmc_walker_adaptive_set_cov_scale (adaptive, g_value_get_double (value));
+      break;
+    case PROP_ADAPT:
+      ncm_fit_esmcmc_walker_adaptive_set_adapt (adaptive, g_value_get_boolean (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (object);
+  g_return_if_fail (NCM_IS_FIT_ESMCMC_WALKER_ADAPTIVE (object));
+
+  switch (prop_id)
+  {
+    case PROP_KDE_WEIGHT:
+      g_value_set_double (value, ncm_fit_esmcmc_walker_adaptive_get_kde_weight (adaptive));
+      break;
+    case PROP_COV_SCALE:
+      g_value_set_double (value, ncm_fit_esmcmc_walker_adaptive_get_cov_scale (adaptive));
+      break;
+    case PROP_ADAPT:
+      g_value_set_boolean (value, ncm_fit_esmcmc_walker_adaptive_get_adapt (adaptive));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_dispose (GObject *object)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (object);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  ncm_vector_clear (&self->m2lnp_star);
+  ncm_vector_clear (&self->m2lnp_cur);
+  ncm_vector_clear (&self->mean);
+  ncm_vector_clear (&self->delta);
+  ncm_matrix_clear (&self->L);
+
+  g_clear_pointer (&self->dndg, g_ptr_array_unref);
+  g_clear_pointer (&self->thetastar, g_ptr_array_unref);
+  g_clear_pointer (&self->tmp, g_ptr_array_unref);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (ncm_fit_esmcmc_walker_adaptive_parent_class)->dispose (object);
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_finalize (GObject *object)
+{
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (ncm_fit_esmcmc_walker_adaptive_parent_class)->finalize (object);
+}
+
+static void _ncm_fit_esmcmc_walker_adaptive_set_size (NcmFitESMCMCWalker *walker, guint size);
+static guint _ncm_fit_esmcmc_walker_adaptive_get_size (NcmFitESMCMCWalker *walker);
+static void _ncm_fit_esmcmc_walker_adaptive_set_nparams (NcmFitESMCMCWalker *walker, guint nparams);
+static guint _ncm_fit_esmcmc_walker_adaptive_get_nparams (NcmFitESMCMCWalker *walker);
+static void _ncm_fit_esmcmc_walker_adaptive_setup (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, guint ki, guint kf, NcmRNG *rng);
+static void _ncm_fit_esmcmc_walker_adaptive_step (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k);
+static gdouble _ncm_fit_esmcmc_walker_adaptive_prob (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k, const gdouble m2lnL_cur, const gdouble m2lnL_star);
+static gdouble _ncm_fit_esmcmc_walker_adaptive_prob_norm (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k);
+static void _ncm_fit_esmcmc_walker_adaptive_clean (NcmFitESMCMCWalker *walker, guint ki, guint kf);
+static const gchar *_ncm_fit_esmcmc_walker_adaptive_desc (NcmFitESMCMCWalker *walker);
+
+static void
+ncm_fit_esmcmc_walker_adaptive_class_init (NcmFitESMCMCWalkerAdaptiveClass *klass)
+{
+  GObjectClass* object_class = G_OBJECT_CLASS (klass);
+  NcmFitESMCMCWalkerClass *walker_class = NCM_FIT_ESMCMC_WALKER_CLASS (klass);
+
+  object_class->set_property = _ncm_fit_esmcmc_walker_adaptive_set_property;
+  object_class->get_property = _ncm_fit_esmcmc_walker_adaptive_get_property;
+  object_class->dispose      = _ncm_fit_esmcmc_walker_adaptive_dispose;
+  object_class->finalize     = _ncm_fit_esmcmc_walker_adaptive_finalize;
+
+  g_object_class_install_property (object_class,
+                                   PROP_KDE_WEIGHT,
+                                   g_param_spec_double ("kde-weight",
+                                                        NULL,
+                                                        "Weight of the KDE component in the proposal mixture",
+                                                        0.0, 1.0, 0.5,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_COV_SCALE,
+                                   g_param_spec_double ("cov-scale",
+                                                        NULL,
+                                                        "Scale applied to the accumulated covariance in the Gaussian component",
+                                                        1.0e-2, 1.0e2, 1.2,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_ADAPT,
+                                   g_param_spec_boolean ("adapt",
+                                                         NULL,
+                                                         "Whether to keep updating the mean and covariance",
+                                                         TRUE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  walker_class->set_size    = &_ncm_fit_esmcmc_walker_adaptive_set_size;
+  walker_class->get_size    = &_ncm_fit_esmcmc_walker_adaptive_get_size;
+  walker_class->set_nparams = &_ncm_fit_esmcmc_walker_adaptive_set_nparams;
+  walker_class->get_nparams = &_ncm_fit_esmcmc_walker_adaptive_get_nparams;
+  walker_class->setup       = &_ncm_fit_esmcmc_walker_adaptive_setup;
+  walker_class->step        = &_ncm_fit_esmcmc_walker_adaptive_step;
+  walker_class->prob        = &_ncm_fit_esmcmc_walker_adaptive_prob;
+  walker_class->prob_norm   = &_ncm_fit_esmcmc_walker_adaptive_prob_norm;
+  walker_class->clean       = &_ncm_fit_esmcmc_walker_adaptive_clean;
+  walker_class->desc        = &_ncm_fit_esmcmc_walker_adaptive_desc;
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_set_sys (NcmFitESMCMCWalker *walker, guint size, guint nparams)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpuint (size, >, 0);
+  g_assert_cmpuint (nparams, >, 0);
+
+  if (self->size != size || self->nparams != nparams)
+  {
+    guint i;
+
+    ncm_vector_clear (&self->m2lnp_star);
+    ncm_vector_clear (&self->m2lnp_cur);
+    ncm_vector_clear (&self->mean);
+    ncm_vector_clear (&self->delta);
+    ncm_matrix_clear (&self->L);
+
+    g_ptr_array_set_size (self->dndg, 0);
+    g_ptr_array_set_size (self->thetastar, 0);
+    g_ptr_array_set_size (self->tmp, 0);
+
+    self->size    = size;
+    self->nparams = nparams;
+
+    self->m2lnp_star = ncm_vector_new (self->size);
+    self->m2lnp_cur  = ncm_vector_new (self->size);
+    self->mean       = ncm_vector_new (self->nparams);
+    self->delta      = ncm_vector_new (self->nparams);
+    self->L          = ncm_matrix_new (self->nparams, self->nparams);
+    self->nobs       = 0;
+
+    for (i = 0; i < self->size; i++)
+    {
+      g_ptr_array_add (self->thetastar, ncm_vector_new (self->nparams));
+      g_ptr_array_add (self->tmp, ncm_vector_new (self->nparams));
+    }
+  }
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_set_size (NcmFitESMCMCWalker *walker, guint size)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpuint (size, >, 0);
+
+  if (self->nparams != 0)
+    _ncm_fit_esmcmc_walker_adaptive_set_sys (walker, size, self->nparams);
+  else
+    self->size = size;
+}
+
+static guint
+_ncm_fit_esmcmc_walker_adaptive_get_size (NcmFitESMCMCWalker *walker)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->size;
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_set_nparams (NcmFitESMCMCWalker *walker, guint nparams)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpuint (nparams, >, 0);
+
+  if (self->size != 0)
+    _ncm_fit_esmcmc_walker_adaptive_set_sys (walker, self->size, nparams);
+  else
+    self->nparams = nparams;
+}
+
+static guint
+_ncm_fit_esmcmc_walker_adaptive_get_nparams (NcmFitESMCMCWalker *walker)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->nparams;
+}
+
+/*
+ * Rank-one update of the lower triangular factor L,
+ * L L^T -> L L^T + x x^T, x is overwritten.
+ */
+static void
+_ncm_fit_esmcmc_walker_adaptive_chol_update (NcmMatrix *L, NcmVector *x)
+{
+  const guint n = ncm_matrix_nrows (L);
+  guint k, i;
+
+  for (k = 0; k < n; k++)
+  {
+    const gdouble Lkk = ncm_matrix_get (L, k, k);
+    const gdouble xk  = ncm_vector_get (x, k);
+    const gdouble r   = hypot (Lkk, xk);
+    const gdouble c   = r / Lkk;
+    const gdouble s   = xk / Lkk;
+
+    ncm_matrix_set (L, k, k, r);
+
+    for (i = k + 1; i < n; i++)
+    {
+      const gdouble Lik = (ncm_matrix_get (L, i, k) + s * ncm_vector_get (x, i)) / c;
+
+      ncm_matrix_set (L, i, k, Lik);
+      ncm_vector_set (x, i, c * ncm_vector_get (x, i) - s * Lik);
+    }
+  }
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_start (NcmFitESMCMCWalkerAdaptivePrivate * const self, GPtrArray *theta)
+{
+  const gdouble reg = 1.0e-3;
+  guint i, k;
+
+  ncm_vector_set_zero (self->mean);
+  for (k = 0; k < self->size; k++)
+    ncm_vector_add (self->mean, g_ptr_array_index (theta, k));
+  ncm_vector_scale (self->mean, 1.0 / self->size);
+
+  ncm_matrix_set_zero (self->L);
+  for (i = 0; i < self->nparams; i++)
+  {
+    const gdouble mean_i = ncm_vector_get (self->mean, i);
+    gdouble var_i        = 0.0;
+
+    for (k = 0; k < self->size; k++)
+      var_i += gsl_pow_2 (ncm_vector_get (g_ptr_array_index (theta, k), i) - mean_i);
+
+    var_i = var_i / self->size;
+    if (var_i <= 0.0)
+      var_i = gsl_pow_2 (mean_i != 0.0 ? mean_i : 1.0);
+
+    ncm_matrix_set (self->L, i, i, sqrt (reg * var_i));
+  }
+
+  ncm_vector_set_zero (self->mean);
+  self->nobs = 0;
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_add_ensemble (NcmFitESMCMCWalkerAdaptivePrivate * const self, GPtrArray *theta)
+{
+  guint k, i;
+
+  if (self->nobs == 0)
+    _ncm_fit_esmcmc_walker_adaptive_start (self, theta);
+
+  /*
+   * Welford update of the mean and of the sum of squares S, only the
+   * Cholesky factor of S is kept:
+   * S_n = S_{n-1} + (n - 1) / n (x - mean_{n-1}) (x - mean_{n-1})^T.
+   */
+  for (k = 0; k < self->size; k++)
+  {
+    NcmVector *theta_k = g_ptr_array_index (theta, k);
+    const gdouble n    = self->nobs + 1.0;
+
+    ncm_vector_memcpy (self->delta, theta_k);
+    ncm_vector_sub (self->delta, self->mean);
+    ncm_vector_axpy (self->mean, 1.0 / n, self->delta);
+
+    if (self->nobs > 0)
+    {
+      ncm_vector_scale (self->delta, sqrt ((n - 1.0) / n));
+      _ncm_fit_esmcmc_walker_adaptive_chol_update (self->L, self->delta);
+    }
+    self->nobs++;
+  }
+
+  self->lndetL = 0.0;
+  for (i = 0; i < self->nparams; i++)
+    self->lndetL += log (ncm_matrix_get (self->L, i, i));
+}
+
+/*
+ * Proposal covariance s^2 S_n / n, its factor is sqrt(s^2 / n) L.
+ */
+static gdouble
+_ncm_fit_esmcmc_walker_adaptive_gauss_factor (NcmFitESMCMCWalkerAdaptivePrivate * const self)
+{
+  return self->cov_scale / sqrt (1.0 * self->nobs);
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_gauss_sample (NcmFitESMCMCWalkerAdaptivePrivate * const self, NcmVector *x, NcmRNG *rng)
+{
+  const gdouble f = _ncm_fit_esmcmc_walker_adaptive_gauss_factor (self);
+  guint i;
+  gint ret;
+
+  for (i = 0; i < self->nparams; i++)
+    ncm_vector_set (x, i, gsl_ran_ugaussian (rng->r));
+
+  ret = gsl_blas_dtrmv (CblasLower, CblasNoTrans, CblasNonUnit, ncm_matrix_gsl (self->L), ncm_vector_gsl (x));
+  NCM_TEST_GSL_RESULT ("_ncm_fit_esmcmc_walker_adaptive_gauss_sample", ret);
+
+  ncm_vector_scale (x, f);
+  ncm_vector_add (x, self->mean);
+}
+
+static gdouble
+_ncm_fit_esmcmc_walker_adaptive_gauss_m2lnp (NcmFitESMCMCWalkerAdaptivePrivate * const self, NcmVector *x, NcmVector *tmp)
+{
+  const gdouble f = _ncm_fit_esmcmc_walker_adaptive_gauss_factor (self);
+  gdouble chi2;
+  gint ret;
+
+  ncm_vector_memcpy (tmp, x);
+  ncm_vector_sub (tmp, self->mean);
+
+  ret = gsl_blas_dtrsv (CblasLower, CblasNoTrans, CblasNonUnit, ncm_matrix_gsl (self->L), ncm_vector_gsl (tmp));
+  NCM_TEST_GSL_RESULT ("_ncm_fit_esmcmc_walker_adaptive_gauss_m2lnp", ret);
+
+  ret = gsl_blas_ddot (ncm_vector_gsl (tmp), ncm_vector_gsl (tmp), &chi2);
+  NCM_TEST_GSL_RESULT ("_ncm_fit_esmcmc_walker_adaptive_gauss_m2lnp", ret);
+
+  return chi2 / (f * f) + 2.0 * (self->lndetL + self->nparams * log (f)) + self->nparams * ncm_c_ln2pi ();
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_setup (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, guint ki, guint kf, NcmRNG *rng)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+  const guint s_i = ncm_fit_esmcmc_walker_subset_of (walker, ki);
+  const guint s_f = ncm_fit_esmcmc_walker_subset_of (walker, kf - 1);
+  guint s, k;
+
+  if (self->adapt || (self->nobs == 0))
+    _ncm_fit_esmcmc_walker_adaptive_add_ensemble (self, theta);
+
+  if (self->kde_weight > 0.0)
+  {
+    if (self->dndg->len == 0)
+    {
+      /* One KDE for each half of the ensemble. */
+      for (s = 0; s < 2; s++)
+      {
+        NcmStatsDistNdKDEGauss *dndg = ncm_stats_dist_nd_kde_gauss_new (self->nparams, FALSE);
+        ncm_stats_dist_nd_kde_gauss_set_over_smooth (dndg, 1.273);
+        g_ptr_array_add (self->dndg, dndg);
+      }
+    }
+
+    for (s = s_i; s <= s_f; s++)
+    {
+      NcmStatsDistNd *dnd = g_ptr_array_index (self->dndg, s);
+      guint si, sf;
+
+      ncm_fit_esmcmc_walker_get_subset (walker, s, &si, &sf);
+      ncm_stats_dist_nd_reset (dnd);
+      for (k = 0; k < self->size; k++)
+      {
+        if ((k < si) || (k >= sf))
+          ncm_stats_dist_nd_kde_gauss_add_obs (NCM_STATS_DIST_ND_KDE_GAUSS (dnd), g_ptr_array_index (theta, k));
+      }
+      ncm_stats_dist_nd_prepare (dnd);
+    }
+  }
+
+  for (k = ki; k < kf; k++)
+  {
+    NcmVector *thetastar_k = g_ptr_array_index (self->thetastar, k);
+
+    if ((self->kde_weight > 0.0) && ((self->kde_weight == 1.0) || (gsl_rng_uniform (rng->r) < self->kde_weight)))
+    {
+      NcmStatsDistNd *dnd = g_ptr_array_index (self->dndg, ncm_fit_esmcmc_walker_subset_of (walker, k));
+      ncm_stats_dist_nd_sample (dnd, thetastar_k, rng);
+    }
+    else
+    {
+      _ncm_fit_esmcmc_walker_adaptive_gauss_sample (self, thetastar_k, rng);
+    }
+  }
+}
+
+static gdouble
+_ncm_fit_esmcmc_walker_adaptive_m2lnp (NcmFitESMCMCWalker *walker, NcmFitESMCMCWalkerAdaptivePrivate * const self, NcmVector *x, guint k)
+{
+  NcmVector *tmp = g_ptr_array_index (self->tmp, k);
+
+  if (self->kde_weight == 0.0)
+  {
+    return _ncm_fit_esmcmc_walker_adaptive_gauss_m2lnp (self, x, tmp);
+  }
+  else
+  {
+    NcmStatsDistNd *dnd  = g_ptr_array_index (self->dndg, ncm_fit_esmcmc_walker_subset_of (walker, k));
+    const gdouble a      = log (self->kde_weight) - 0.5 * ncm_stats_dist_nd_eval_m2lnp (dnd, x);
+
+    if (self->kde_weight == 1.0)
+    {
+      return - 2.0 * a;
+    }
+    else
+    {
+      const gdouble b      = log1p (- self->kde_weight) - 0.5 * _ncm_fit_esmcmc_walker_adaptive_gauss_m2lnp (self, x, tmp);
+      const gdouble max_ab = GSL_MAX (a, b);
+
+      return - 2.0 * (max_ab + log (exp (a - max_ab) + exp (b - max_ab)));
+    }
+  }
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_step (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+  NcmVector *theta_k = g_ptr_array_index (theta, k);
+
+  ncm_vector_memcpy (thetastar, g_ptr_array_index (self->thetastar, k));
+
+  ncm_vector_set (self->m2lnp_star, k, _ncm_fit_esmcmc_walker_adaptive_m2lnp (walker, self, thetastar, k));
+  ncm_vector_set (self->m2lnp_cur,  k, _ncm_fit_esmcmc_walker_adaptive_m2lnp (walker, self, theta_k, k));
+}
+
+static gdouble
+_ncm_fit_esmcmc_walker_adaptive_prob (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k, const gdouble m2lnL_cur, const gdouble m2lnL_star)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+  const gdouble m2lnp_star = ncm_vector_get (self->m2lnp_star, k);
+  const gdouble m2lnp_cur  = ncm_vector_get (self->m2lnp_cur, k);
+
+  return exp (- 0.5 * ((m2lnL_star - m2lnp_star) - (m2lnL_cur - m2lnp_cur)));
+}
+
+static gdouble
+_ncm_fit_esmcmc_walker_adaptive_prob_norm (NcmFitESMCMCWalker *walker, GPtrArray *theta, GPtrArray *m2lnL, NcmVector *thetastar, guint k)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+  const gdouble m2lnp_star = ncm_vector_get (self->m2lnp_star, k);
+  const gdouble m2lnp_cur  = ncm_vector_get (self->m2lnp_cur, k);
+
+  return -0.5 * (m2lnp_cur - m2lnp_star);
+}
+
+static void
+_ncm_fit_esmcmc_walker_adaptive_clean (NcmFitESMCMCWalker *walker, guint ki, guint kf)
+{
+  /* Nothing to do. */
+}
+
+static const gchar *
+_ncm_fit_esmcmc_walker_adaptive_desc (NcmFitESMCMCWalker *walker)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = NCM_FIT_ESMCMC_WALKER_ADAPTIVE (walker);
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->desc;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_new:
+ * @nwalkers: number of walkers
+ * @nparams: number of parameters
+ *
+ * Creates a new #NcmFitESMCMCWalkerAdaptive to be used
+ * with @nwalkers.
+ *
+ * Returns: (transfer full): a new #NcmFitESMCMCWalkerAdaptive.
+ */
+NcmFitESMCMCWalkerAdaptive *
+ncm_fit_esmcmc_walker_adaptive_new (guint nwalkers, guint nparams)
+{
+  NcmFitESMCMCWalkerAdaptive *adaptive = g_object_new (NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE,
+                                                       "size", nwalkers,
+                                                       "nparams", nparams,
+                                                       NULL);
+
+  return adaptive;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_set_kde_weight:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ * @w: a double $\in [0,1]$
+ *
+ * Sets the weight $w$ of the KDE component in the proposal mixture. With
+ * $w = 1$ only the KDE of the complementary walkers is used and with
+ * $w = 0$ only the Gaussian built from the accumulated covariance.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_set_kde_weight (NcmFitESMCMCWalkerAdaptive *adaptive, const gdouble w)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpfloat (w, >=, 0.0);
+  g_assert_cmpfloat (w, <=, 1.0);
+
+  self->kde_weight = w;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_kde_weight:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ *
+ * Returns: the weight of the KDE component in the proposal mixture.
+ */
+gdouble
+ncm_fit_esmcmc_walker_adaptive_get_kde_weight (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->kde_weight;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_set_cov_scale:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ * @scale: a double $\in (0,\infty)$
+ *
+ * Sets the scale $s$ of the Gaussian component, its covariance is
+ * $s^2\Sigma$. Values slightly larger than one make the proposal
+ * heavier-tailed than the accumulated posterior approximation.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_set_cov_scale (NcmFitESMCMCWalkerAdaptive *adaptive, const gdouble scale)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpfloat (scale, >, 0.0);
+
+  self->cov_scale = scale;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_cov_scale:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ *
+ * Returns: the scale of the Gaussian component.
+ */
+gdouble
+ncm_fit_esmcmc_walker_adaptive_get_cov_scale (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->cov_scale;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_set_adapt:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ * @adapt: whether to update the mean and covariance
+ *
+ * Sets whether the ensembles are added to the running mean and
+ * covariance at each setup. When @adapt is FALSE the current
+ * proposal is frozen.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_set_adapt (NcmFitESMCMCWalkerAdaptive *adaptive, gboolean adapt)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  self->adapt = adapt;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_adapt:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ *
+ * Returns: whether the mean and covariance are being updated.
+ */
+gboolean
+ncm_fit_esmcmc_walker_adaptive_get_adapt (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->adapt;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_reset:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ *
+ * Discards the accumulated mean and covariance, they are restarted
+ * from the ensemble at the next setup.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_reset (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  self->nobs = 0;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_nobs:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ *
+ * Returns: the number of points accumulated in the mean and covariance.
+ */
+guint
+ncm_fit_esmcmc_walker_adaptive_get_nobs (NcmFitESMCMCWalkerAdaptive *adaptive)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  return self->nobs;
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_mean:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ * @mean: a #NcmVector
+ *
+ * Copies the accumulated mean to @mean.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_get_mean (NcmFitESMCMCWalkerAdaptive *adaptive, NcmVector *mean)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+
+  g_assert_cmpuint (self->nobs, >, 0);
+  ncm_vector_memcpy (mean, self->mean);
+}
+
+/**
+ * ncm_fit_esmcmc_walker_adaptive_get_cov:
+ * @adaptive: a #NcmFitESMCMCWalkerAdaptive
+ * @cov: a #NcmMatrix
+ *
+ * Computes the accumulated covariance $\Sigma$ (including the initial
+ * diagonal regularization) from its Cholesky factor and copies it to @cov.
+ *
+ */
+void
+ncm_fit_esmcmc_walker_adaptive_get_cov (NcmFitESMCMCWalkerAdaptive *adaptive, NcmMatrix *cov)
+{
+  NcmFitESMCMCWalkerAdaptivePrivate * const self = adaptive->priv;
+  gint ret;
+
+  g_assert_cmpuint (self->nobs, >, 0);
+
+  ret = gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1.0 / self->nobs, ncm_matrix_gsl (self->L), ncm_matrix_gsl (self->L), 0.0, ncm_matrix_gsl (cov));
+  NCM_TEST_GSL_RESULT ("ncm_fit_esmcmc_walker_adaptive_get_cov", ret);
+}
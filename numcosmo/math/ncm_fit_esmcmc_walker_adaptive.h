@@ -0,0 +1,82 @@
+/***************************************************************************
+ *            ncm_fit_esmcmc_walker_adaptive.h
+ *
+ *  Sun October 18 16:20:31 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * ncm_fit_esmcmc_walker_adaptive.h
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NCM_FIT_ESMCMC_WALKER_ADAPTIVE_H_
+#define _NCM_FIT_ESMCMC_WALKER_ADAPTIVE_H_
+
+#include <glib.h>
+#include <glib-object.h>
+#include <numcosmo/build_cfg.h>
+#include <numcosmo/math/ncm_fit_esmcmc_walker.h>
+#include <numcosmo/math/ncm_matrix.h>
+#include <numcosmo/math/ncm_mset.h>
+
+G_BEGIN_DECLS
+
+#define NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE             (ncm_fit_esmcmc_walker_adaptive_get_type ())
+#define NCM_FIT_ESMCMC_WALKER_ADAPTIVE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE, NcmFitESMCMCWalkerAdaptive))
+#define NCM_FIT_ESMCMC_WALKER_ADAPTIVE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE, NcmFitESMCMCWalkerAdaptiveClass))
+#define NCM_IS_FIT_ESMCMC_WALKER_ADAPTIVE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE))
+#define NCM_IS_FIT_ESMCMC_WALKER_ADAPTIVE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE))
+#define NCM_FIT_ESMCMC_WALKER_ADAPTIVE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), NCM_TYPE_FIT_ESMCMC_WALKER_ADAPTIVE, NcmFitESMCMCWalkerAdaptiveClass))
+
+typedef struct _NcmFitESMCMCWalkerAdaptiveClass NcmFitESMCMCWalkerAdaptiveClass;
+typedef struct _NcmFitESMCMCWalkerAdaptive NcmFitESMCMCWalkerAdaptive;
+typedef struct _NcmFitESMCMCWalkerAdaptivePrivate NcmFitESMCMCWalkerAdaptivePrivate;
+
+struct _NcmFitESMCMCWalkerAdaptiveClass
+{
+  /*< private >*/
+  NcmFitESMCMCWalkerClass parent_class;
+};
+
+struct _NcmFitESMCMCWalkerAdaptive
+{
+  /*< private >*/
+  NcmFitESMCMCWalker parent_instance;
+  NcmFitESMCMCWalkerAdaptivePrivate *priv;
+};
+
+GType ncm_fit_esmcmc_walker_adaptive_get_type (void) G_GNUC_CONST;
+
+NcmFitESMCMCWalkerAdaptive *ncm_fit_esmcmc_walker_adaptive_new (guint nwalkers, guint nparams);
+
+void ncm_fit_esmcmc_walker_adaptive_set_kde_weight (NcmFitESMCMCWalkerAdaptive *adaptive, const gdouble w);
+gdouble ncm_fit_esmcmc_walker_adaptive_get_kde_weight (NcmFitESMCMCWalkerAdaptive *adaptive);
+
+void ncm_fit_esmcmc_walker_adaptive_set_cov_scale (NcmFitESMCMCWalkerAdaptive *adaptive, const gdouble scale);
+gdouble ncm_fit_esmcmc_walker_adaptive_get_cov_scale (NcmFitESMCMCWalkerAdaptive *adaptive);
+
+void ncm_fit_esmcmc_walker_adaptive_set_adapt (NcmFitESMCMCWalkerAdaptive *adaptive, gboolean adapt);
+gboolean ncm_fit_esmcmc_walker_adaptive_get_adapt (NcmFitESMCMCWalkerAdaptive *adaptive);
+
+void ncm_fit_esmcmc_walker_adaptive_reset (NcmFitESMCMCWalkerAdaptive *adaptive);
+guint ncm_fit_esmcmc_walker_adaptive_get_nobs (NcmFitESMCMCWalkerAdaptive *adaptive);
+void ncm_fit_esmcmc_walker_adaptive_get_mean (NcmFitESMCMCWalkerAdaptive *adaptive, NcmVector *mean);
+void ncm_fit_esmcmc_walker_adaptive_get_cov (NcmFitESMCMCWalkerAdaptive *adaptive, NcmMatrix *cov);
+
+G_END_DECLS
+
+#endif /* _NCM_FIT_ESMCMC_WALKER_ADAPTIVE_H_ */
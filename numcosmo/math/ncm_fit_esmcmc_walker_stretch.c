@@ -60,7 +60,6 @@ static void
 ncm_fit_esmcmc_walker_stretch_init (NcmFitESMCMCWalkerStretch *stretch)
 {
   stretch->size     = 0;
-  stretch->size_2   = 0;
   stretch->nparams  = 0;
   stretch->a        = 0.0;
   stretch->z        = NULL;
@@ -205,8 +204,6 @@ _ncm_fit_esmcmc_walker_stretch_set_sys (NcmFitESMCMCWalker *walker, guint size,
     ncm_matrix_clear (&stretch->z);
     ncm_matrix_clear (&stretch->box);
 
-    g_assert (size % 2 == 0);
-
     stretch->z        = ncm_matrix_new (size, nparams);
 
     stretch->norm_box = ncm_vector_new (size);
@@ -216,12 +213,15 @@ _ncm_fit_esmcmc_walker_stretch_set_sys (NcmFitESMCMCWalker *walker, guint size,
 
     g_array_set_size (stretch->indices, size * nparams);
 
-    g_array_set_size (stretch->numbers, size);
-    for (i = 0; i < size; i++)
-      g_array_index (stretch->numbers, guint, i) = i;
+    /*
+     * Walker indices repeated twice, the complement of any contiguous
+     * subset [ki, kf) is then the contiguous range starting at kf.
+     */
+    g_array_set_size (stretch->numbers, 2 * size);
+    for (i = 0; i < 2 * size; i++)
+      g_array_index (stretch->numbers, guint, i) = i % size;
     
     stretch->size    = size;
-    stretch->size_2  = size / 2;
     stretch->nparams = nparams;
   }
 }
@@ -278,28 +278,34 @@ _ncm_fit_esmcmc_walker_stretch_setup (NcmFitESMCMCWalker *walker, GPtrArray *the
   {
     for (k = ki; k < kf; k++)
     {
-      const guint subensemble = (k < stretch->size_2) ? stretch->size_2 : 0;
-      const gdouble u         = gsl_rng_uniform (rng->r);
-      const gdouble z         = gsl_pow_2 (1.0 + (stretch->a - 1.0) * u) / stretch->a;
-      const guint j           = gsl_rng_uniform_int (rng->r, stretch->size_2) + subensemble;
+      const guint s   = ncm_fit_esmcmc_walker_subset_of (walker, k);
+      guint si, sf;
+      ncm_fit_esmcmc_walker_get_subset (walker, s, &si, &sf);
+      {
+        const guint csize = stretch->size - (sf - si);
+        const gdouble u   = gsl_rng_uniform (rng->r);
+        const gdouble z   = gsl_pow_2 (1.0 + (stretch->a - 1.0) * u) / stretch->a;
+        const guint j     = g_array_index (stretch->numbers, guint, sf + gsl_rng_uniform_int (rng->r, csize));
 
-      /*printf ("# Walker %u using z = % 20.15g and other walker %u to move.\n", k, z, j);*/
+        /*printf ("# Walker %u using z = % 20.15g and other walker %u to move.\n", k, z, j);*/
 
-      ncm_matrix_set (stretch->z, k, 0, z);
-      g_array_index (stretch->indices, guint, k) = j;
+        ncm_matrix_set (stretch->z, k, 0, z);
+        g_array_index (stretch->indices, guint, k) = j;
+      }
     }
   }
   else
   {
     for (k = ki; k < kf; k++)
     {
-      const guint subensemble = (k < stretch->size_2) ? stretch->size_2 : 0;
-      guint pi;
+      const guint s = ncm_fit_esmcmc_walker_subset_of (walker, k);
+      guint si, sf, pi;
+
+      ncm_fit_esmcmc_walker_get_subset (walker, s, &si, &sf);
       for (pi = 0; pi < stretch->nparams; pi++)
       {
         const gdouble u = gsl_rng_uniform (rng->r);
         const gdouble z = gsl_pow_2 (1.0 + (stretch->a - 1.0) * u) / stretch->a;
-        /*const guint j   = gsl_rng_uniform_int (rng->r, stretch->size_2) + subensemble;*/
 
         ncm_matrix_set (stretch->z, k, pi, z);
         /*g_array_index (stretch->indices, guint, k * stretch->nparams + pi) = j;*/
@@ -307,8 +313,8 @@ _ncm_fit_esmcmc_walker_stretch_setup (NcmFitESMCMCWalker *walker, GPtrArray *the
       gsl_ran_choose (rng->r, 
                       &g_array_index (stretch->indices, guint, k * stretch->nparams), 
                       stretch->nparams, 
-                      &g_array_index (stretch->numbers, guint, subensemble), 
-                      stretch->size_2,
+                      &g_array_index (stretch->numbers, guint, sf), 
+                      stretch->size - (sf - si),
                       g_array_get_element_size (stretch->numbers));
     }
   }
@@ -56,7 +56,6 @@ struct _NcmFitESMCMCWalkerStretch
   /*< private >*/
   NcmFitESMCMCWalker parent_instance;
   guint size;
-  guint size_2;
   guint nparams;
   gdouble a;
   NcmMatrix *z;
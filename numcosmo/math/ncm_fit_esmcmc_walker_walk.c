@@ -59,7 +59,6 @@ static void
 ncm_fit_esmcmc_walker_walk_init (NcmFitESMCMCWalkerWalk *walk)
 {
   walk->size         = 0;
-  walk->size_2       = 0;
   walk->nparams      = 0;
   walk->a            = 0.0;
   walk->sqrt_nparams = 0.0;
@@ -183,15 +182,17 @@ _ncm_fit_esmcmc_walker_walk_set_sys (NcmFitESMCMCWalker *walker, guint size, gui
     
     ncm_matrix_clear (&walk->z);
 
-    g_assert (size % 2 == 0);
-
     walk->z = ncm_matrix_new (size, nparams);
 
     g_array_set_size (walk->indices, size * nparams);
 
-    g_array_set_size (walk->numbers, size);
-    for (i = 0; i < size; i++)
-      g_array_index (walk->numbers, guint, i) = i;
+    /*
+     * Walker indices repeated twice, the complement of any contiguous
+     * subset [ki, kf) is then the contiguous range starting at kf.
+     */
+    g_array_set_size (walk->numbers, 2 * size);
+    for (i = 0; i < 2 * size; i++)
+      g_array_index (walk->numbers, guint, i) = i % size;
 
     g_ptr_array_set_size (walk->thetabar, 0);
     for (i = 0; i < size; i++)
@@ -200,9 +201,6 @@ _ncm_fit_esmcmc_walker_walk_set_sys (NcmFitESMCMCWalker *walker, guint size, gui
       g_ptr_array_add (walk->thetabar, thetabar_i);
     }
     
-    walk->size   = size;
-    walk->size_2 = size / 2;
-
     walk->size         = size;
     walk->nparams      = nparams;
     walk->sqrt_nparams = sqrt (1.0 * walk->nparams);
@@ -259,8 +257,10 @@ _ncm_fit_esmcmc_walker_walk_setup (NcmFitESMCMCWalker *walker, GPtrArray *theta,
 
   for (k = ki; k < kf; k++)
   {
-    const guint subensemble = (k < walk->size_2) ? walk->size_2 : 0;
-    guint pi;
+    const guint s = ncm_fit_esmcmc_walker_subset_of (walker, k);
+    guint si, sf, pi;
+
+    ncm_fit_esmcmc_walker_get_subset (walker, s, &si, &sf);
     for (pi = 0; pi < walk->nparams; pi++)
     {
       const gdouble zi        = gsl_ran_ugaussian (rng->r);
@@ -270,20 +270,10 @@ _ncm_fit_esmcmc_walker_walk_setup (NcmFitESMCMCWalker *walker, GPtrArray *theta,
     gsl_ran_choose (rng->r, 
                     &g_array_index (walk->indices, guint, k * walk->nparams), 
                     walk->nparams, 
-                    &g_array_index (walk->numbers, guint, subensemble), 
-                    walk->size_2,
+                    &g_array_index (walk->numbers, guint, sf), 
+                    walk->size - (sf - si),
                     g_array_get_element_size (walk->numbers));
 
-/*    
-    for (pi = 0; pi < walk->nparams; pi++)
-    {
-      printf ("Choosing for walker %u, walker %u | nparams %u size_2 %u subensemble %u | numbers[subensemble + %u] = %u\n",
-              k, g_array_index (walk->indices, guint, k * walk->nparams + pi),
-              walk->nparams, walk->size_2, subensemble,
-              pi, g_array_index (walk->numbers, guint, subensemble + pi));
-    }
-*/    
-    
   }
 }
 
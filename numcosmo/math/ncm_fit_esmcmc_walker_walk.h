@@ -55,7 +55,6 @@ struct _NcmFitESMCMCWalkerWalk
   /*< private >*/
   NcmFitESMCMCWalker parent_instance;
   guint size;
-  guint size_2;
   guint nparams;
   gdouble a;
   gdouble sqrt_nparams;
@@ -214,7 +214,20 @@ _ncm_fit_gsl_mm_run (NcmFit *fit, NcmFitRunMsgs mtype)
   g_assert (fit->fstate->fparam_len != 0);
   
   ncm_mset_fparams_get_vector (fit->mset, fit->fstate->fparams);
-  gsl_multimin_fdfminimizer_set (fit_gsl_mm->mm, &fit_gsl_mm->f, ncm_vector_gsl (fit->fstate->fparams), fit_gsl_mm->err_a, fit_gsl_mm->err_b);
+
+  if (fit->warm_covar != NULL)
+  {
+    gdouble step = GSL_POSINF;
+    guint i;
+
+    /* Warm start: the first trial step is the smallest expected standard deviation. */
+    for (i = 0; i < fit->fstate->fparam_len; i++)
+      step = GSL_MIN (step, sqrt (ncm_matrix_get (fit->warm_covar, i, i)));
+
+    gsl_multimin_fdfminimizer_set (fit_gsl_mm->mm, &fit_gsl_mm->f, ncm_vector_gsl (fit->fstate->fparams), step, fit_gsl_mm->err_b);
+  }
+  else
+    gsl_multimin_fdfminimizer_set (fit_gsl_mm->mm, &fit_gsl_mm->f, ncm_vector_gsl (fit->fstate->fparams), fit_gsl_mm->err_a, fit_gsl_mm->err_b);
 
   do
   {
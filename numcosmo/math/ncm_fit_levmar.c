@@ -46,6 +46,12 @@
 #include <gsl/gsl_blas.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
+/* 
+ * Initial damping scale used when the fit is warm started, see ncm_fit_set_warm_start().
+ * Starting close to the minimum, the first steps can be nearly Gauss-Newton.
+ */
+#define _NCM_FIT_LEVMAR_WARM_INIT_MU (1.0e-6)
+
 enum
 {
   PROP_0,
@@ -261,7 +267,7 @@ ncm_fit_levmar_der_run (NcmFit *fit, NcmFitRunMsgs mtype)
 
   NCM_UNUSED (mtype);
 
-  opts[0] = LM_INIT_MU; 
+  opts[0] = (fit->warm_covar != NULL) ? _NCM_FIT_LEVMAR_WARM_INIT_MU : LM_INIT_MU; 
   opts[1] = 1.0e-15; 
   opts[2] = 1.0e-15;
   opts[3] = 1.0e-20;
@@ -302,7 +308,7 @@ ncm_fit_levmar_dif_run (NcmFit *fit, NcmFitRunMsgs mtype)
 
   NCM_UNUSED (mtype);
 
-  opts[0] = LM_INIT_MU; 
+  opts[0] = (fit->warm_covar != NULL) ? _NCM_FIT_LEVMAR_WARM_INIT_MU : LM_INIT_MU; 
   opts[1] = 1.0e-15; 
   opts[2] = 1.0e-15;
   opts[3] = 1.0e-20;
@@ -343,7 +349,7 @@ ncm_fit_levmar_bc_der_run (NcmFit *fit, NcmFitRunMsgs mtype)
 
   NCM_UNUSED (mtype);
 
-  opts[0] = LM_INIT_MU; 
+  opts[0] = (fit->warm_covar != NULL) ? _NCM_FIT_LEVMAR_WARM_INIT_MU : LM_INIT_MU; 
   opts[1] = 1.0e-15; 
   opts[2] = 1.0e-15;
   opts[3] = 1.0e-20;
@@ -385,7 +391,7 @@ ncm_fit_levmar_bc_dif_run (NcmFit *fit, NcmFitRunMsgs mtype)
 
   NCM_UNUSED (mtype);
 
-  opts[0] = LM_INIT_MU; 
+  opts[0] = (fit->warm_covar != NULL) ? _NCM_FIT_LEVMAR_WARM_INIT_MU : LM_INIT_MU; 
   opts[1] = 1.0e-15; 
   opts[2] = 1.0e-15;
   opts[3] = 1.0e-20;
@@ -44,6 +44,7 @@
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_statistics_double.h>
+#include <gsl/gsl_blas.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
 enum
@@ -55,6 +56,10 @@ enum
   PROP_MTYPE,
   PROP_NTHREADS,
   PROP_KEEP_ORDER,
+  PROP_RNG_SUBSTREAMS,
+  PROP_SHARE_DATA,
+  PROP_REFIT,
+  PROP_BIAS_CHECK,
   PROP_DATA_FILE,
 };
 
@@ -68,20 +73,28 @@ ncm_fit_mc_init (NcmFitMC *mc)
   mc->mcat            = NULL;
   mc->mtype           = NCM_FIT_RUN_MSGS_NONE;
   mc->rtype           = NCM_FIT_MC_RESAMPLE_BOOTSTRAP_LEN;
+  mc->refit           = NCM_FIT_MC_REFIT_COLD;
+  mc->bias_check      = 0;
+  mc->refit_covar     = NULL;
+  mc->refit_bias      = NULL;
+  mc->newton_oob      = 0;
   mc->bf              = NULL;
   mc->nt              = ncm_timer_new ();
   mc->ser             = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
   mc->nthreads        = 0;
   mc->n               = 0;
   mc->keep_order      = FALSE;
+  mc->substreams      = FALSE;
+  mc->share_data      = FALSE;
   mc->mp              = NULL;
+  mc->rng_mp          = NULL;
   mc->cur_sample_id   = -1; /* Represents that no samples were calculated yet. */
   mc->write_index     = 0;
   mc->started         = FALSE;
+  mc->pending         = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) &ncm_vector_free);
   g_mutex_init (&mc->dup_fit);
   g_mutex_init (&mc->resample_lock);
   g_mutex_init (&mc->update_lock);
-  g_cond_init (&mc->write_cond);
 }
 
 static void _ncm_fit_mc_set_fit_obj (NcmFitMC *mc, NcmFit *fit);
@@ -112,6 +125,18 @@ ncm_fit_mc_set_property (GObject *object, guint prop_id, const GValue *value, GP
     case PROP_KEEP_ORDER:
       ncm_fit_mc_keep_order (mc, g_value_get_boolean (value));
       break;
+    case PROP_RNG_SUBSTREAMS:
+      ncm_fit_mc_use_rng_substreams (mc, g_value_get_boolean (value));
+      break;
+    case PROP_SHARE_DATA:
+      ncm_fit_mc_share_data (mc, g_value_get_boolean (value));
+      break;
+    case PROP_REFIT:
+      ncm_fit_mc_set_refit (mc, g_value_get_enum (value));
+      break;
+    case PROP_BIAS_CHECK:
+      ncm_fit_mc_set_bias_check (mc, g_value_get_uint (value));
+      break;
     case PROP_DATA_FILE:
       ncm_fit_mc_set_data_file (mc, g_value_get_string (value));
       break;    
@@ -147,6 +172,18 @@ ncm_fit_mc_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
     case PROP_KEEP_ORDER:
       g_value_set_boolean (value, mc->keep_order);
       break;
+    case PROP_RNG_SUBSTREAMS:
+      g_value_set_boolean (value, mc->substreams);
+      break;
+    case PROP_SHARE_DATA:
+      g_value_set_boolean (value, mc->share_data);
+      break;
+    case PROP_REFIT:
+      g_value_set_enum (value, mc->refit);
+      break;
+    case PROP_BIAS_CHECK:
+      g_value_set_uint (value, mc->bias_check);
+      break;
     case PROP_DATA_FILE:
       g_value_set_string (value, ncm_mset_catalog_peek_filename (mc->mcat));
       break;
@@ -164,9 +201,12 @@ ncm_fit_mc_dispose (GObject *object)
   ncm_fit_clear (&mc->fit);
   ncm_mset_clear (&mc->fiduc);
   ncm_vector_clear (&mc->bf);
+  ncm_matrix_clear (&mc->refit_covar);
+  ncm_stats_vec_clear (&mc->refit_bias);
   ncm_timer_clear (&mc->nt);
   ncm_serialize_clear (&mc->ser);
   ncm_mset_catalog_clear (&mc->mcat);
+  g_clear_pointer (&mc->pending, g_hash_table_unref);
 
   if (mc->mp != NULL)
   {
@@ -174,6 +214,12 @@ ncm_fit_mc_dispose (GObject *object)
     mc->mp = NULL;
   }
 
+  if (mc->rng_mp != NULL)
+  {
+    ncm_memory_pool_free (mc->rng_mp, TRUE);
+    mc->rng_mp = NULL;
+  }
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_mc_parent_class)->dispose (object);
 }
@@ -186,7 +232,6 @@ ncm_fit_mc_finalize (GObject *object)
   g_mutex_clear (&mc->dup_fit);
   g_mutex_clear (&mc->resample_lock);
   g_mutex_clear (&mc->update_lock);
-  g_cond_clear (&mc->write_cond);
   
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_mc_parent_class)->finalize (object);
@@ -238,6 +283,34 @@ ncm_fit_mc_class_init (NcmFitMCClass *klass)
                                                          "Whether keep the catalog in order of sampling",
                                                          TRUE,
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_RNG_SUBSTREAMS,
+                                   g_param_spec_boolean ("rng-substreams",
+                                                         NULL,
+                                                         "Whether to resample each realization using its own RNG substream",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_SHARE_DATA,
+                                   g_param_spec_boolean ("share-data",
+                                                         NULL,
+                                                         "Whether the threads share the data arrays in bootstrap runs",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_REFIT,
+                                   g_param_spec_enum ("refit",
+                                                      NULL,
+                                                      "How each realization is refitted",
+                                                      NCM_TYPE_FIT_MC_REFIT, NCM_FIT_MC_REFIT_COLD,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_BIAS_CHECK,
+                                   g_param_spec_uint ("bias-check",
+                                                      NULL,
+                                                      "Interval between realizations also refitted cold to estimate the refit bias",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   g_object_class_install_property (object_class,
                                    PROP_NTHREADS,
                                    g_param_spec_uint ("nthreads",
@@ -367,6 +440,67 @@ _ncm_fit_mc_resample (NcmFitMC *mc, NcmFit *fit)
   return mc->cur_sample_id;
 }
 
+/*
+ * Reserves the next sample index and resamples using the substream
+ * with the same index. Only the index reservation is done under lock.
+ */
+static gint
+_ncm_fit_mc_resample_substream (NcmFitMC *mc, NcmFit *fit, NcmRNG *sub)
+{
+  gint sample_index;
+
+  g_mutex_lock (&mc->resample_lock);
+  sample_index = ++mc->cur_sample_id;
+  g_mutex_unlock (&mc->resample_lock);
+
+  ncm_rng_substream_set (ncm_mset_catalog_peek_rng (mc->mcat), sub, sample_index);
+  mc->resample (fit->lh->dset, mc->fiduc, sub);
+
+  return sample_index;
+}
+
+static gint
+_ncm_fit_mc_resample_next (NcmFitMC *mc, NcmFit *fit, NcmRNG **sub_ptr)
+{
+  if (sub_ptr != NULL)
+  {
+    return _ncm_fit_mc_resample_substream (mc, fit, *sub_ptr);
+  }
+  else
+  {
+    gint sample_index;
+
+    g_mutex_lock (&mc->resample_lock);
+    sample_index = _ncm_fit_mc_resample (mc, fit);
+    g_mutex_unlock (&mc->resample_lock);
+
+    return sample_index;
+  }
+}
+
+static gpointer
+_ncm_fit_mc_dup_rng (gpointer userdata)
+{
+  NcmFitMC *mc = NCM_FIT_MC (userdata);
+  return ncm_rng_substream_new (ncm_mset_catalog_peek_rng (mc->mcat), 0);
+}
+
+static NcmRNG **
+_ncm_fit_mc_get_substream (NcmFitMC *mc)
+{
+  if (!mc->substreams)
+    return NULL;
+
+  return ncm_memory_pool_get (mc->rng_mp);
+}
+
+static void
+_ncm_fit_mc_return_substream (NcmRNG **sub_ptr)
+{
+  if (sub_ptr != NULL)
+    ncm_memory_pool_return (sub_ptr);
+}
+
 /**
  * ncm_fit_mc_set_rtype:
  * @mc: a #NcmFitMC
@@ -435,6 +569,101 @@ ncm_fit_mc_keep_order (NcmFitMC *mc, gboolean keep_order)
   mc->keep_order = keep_order;
 }
 
+/**
+ * ncm_fit_mc_use_rng_substreams:
+ * @mc: a #NcmFitMC
+ * @substreams: whether to use RNG substreams
+ *
+ * If @substreams is TRUE, the $i$-th realization is resampled using the
+ * substream $i$ of the catalog #NcmRNG (see ncm_rng_substream_set()),
+ * instead of drawing from the shared generator under a lock. The resampling
+ * then runs concurrently and each realization depends only on the
+ * RNG seed and on its index, hence the results are identical for
+ * any number of threads and when a run is resumed from a catalog.
+ * Note that the realizations are not the same as the ones obtained
+ * with @substreams FALSE.
+ *
+ */
+void 
+ncm_fit_mc_use_rng_substreams (NcmFitMC *mc, gboolean substreams)
+{
+  if (mc->started)
+    g_error ("ncm_fit_mc_use_rng_substreams: Cannot change the RNG mode during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->substreams = substreams;
+}
+
+/**
+ * ncm_fit_mc_share_data:
+ * @mc: a #NcmFitMC
+ * @share_data: whether to share the data arrays
+ *
+ * If @share_data is TRUE, in bootstrap runs with more than one thread
+ * each thread uses a view of the dataset, see
+ * ncm_dataset_bootstrap_view(), instead of a full copy. The data
+ * arrays are then allocated only once and each thread keeps only its
+ * own bootstrap indices. This must only be enabled when the #NcmData
+ * objects do not modify their arrays during the fit. It has no effect
+ * on #NCM_FIT_MC_RESAMPLE_FROM_MODEL runs, where each realization
+ * writes its own data.
+ *
+ */
+void 
+ncm_fit_mc_share_data (NcmFitMC *mc, gboolean share_data)
+{
+  if (mc->started)
+    g_error ("ncm_fit_mc_share_data: Cannot change the data sharing during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->share_data = share_data;
+}
+
+/**
+ * ncm_fit_mc_set_refit:
+ * @mc: a #NcmFitMC
+ * @refit: a #NcmFitMCRefit
+ *
+ * Sets how each realization is refitted. Using #NCM_FIT_MC_REFIT_WARM or
+ * #NCM_FIT_MC_REFIT_NEWTON, the covariance of the fitting parameters at the
+ * fiducial best fit is obtained when the run starts, from the fit state
+ * if it contains one (e.g., after ncm_fit_fisher()) or from
+ * ncm_fit_numdiff_m2lnL_covar() otherwise. For each realization, the
+ * gradient $g$ of $-2\ln(L)$ at the fiducial best fit $\theta_0$ gives the
+ * Newton step $\theta_0 - Cg/2$, which is used as the starting point of the
+ * warm refit or directly as the estimate of the realization.
+ *
+ */
+void 
+ncm_fit_mc_set_refit (NcmFitMC *mc, NcmFitMCRefit refit)
+{
+  g_assert_cmpint (refit, <, NCM_FIT_MC_REFIT_LEN);
+  if (mc->started)
+    g_error ("ncm_fit_mc_set_refit: Cannot change the refit mode during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->refit = refit;
+}
+
+/**
+ * ncm_fit_mc_set_bias_check:
+ * @mc: a #NcmFitMC
+ * @bias_check: interval between checked realizations
+ *
+ * If @bias_check is larger than zero and the refit mode is not
+ * #NCM_FIT_MC_REFIT_COLD, every @bias_check-th realization is also
+ * refitted cold and the differences between the two results, in units
+ * of the fiducial standard deviations, are accumulated, see
+ * ncm_fit_mc_peek_refit_bias() and ncm_fit_mc_log_refit_bias(). The
+ * catalog always contains the results of the chosen refit mode.
+ *
+ */
+void 
+ncm_fit_mc_set_bias_check (NcmFitMC *mc, guint bias_check)
+{
+  if (mc->started)
+    g_error ("ncm_fit_mc_set_bias_check: Cannot change the bias check during a run, call ncm_fit_mc_end_run() first.");
+
+  mc->bias_check = bias_check;
+}
+
 /**
  * ncm_fit_mc_set_fiducial:
  * @mc: a #NcmFitMC
@@ -476,13 +705,12 @@ ncm_fit_mc_set_rng (NcmFitMC *mc, NcmRNG *rng)
   ncm_mset_catalog_set_rng (mc->mcat, rng);
 }
 
-void
-_ncm_fit_mc_update (NcmFitMC *mc, NcmFit *fit)
+static void
+_ncm_fit_mc_log_update (NcmFitMC *mc, NcmFit *fit)
 {
   const guint part = 5;
   const guint step = (mc->n / part) == 0 ? 1 : (mc->n / part);
 
-  ncm_mset_catalog_add_from_mset (mc->mcat, fit->mset, ncm_fit_state_get_m2lnL_curval (fit->fstate), NULL);
   ncm_timer_task_increment (mc->nt);
 
   switch (mc->mtype)
@@ -510,8 +738,12 @@ _ncm_fit_mc_update (NcmFitMC *mc, NcmFit *fit)
     }
     default:
     case NCM_FIT_RUN_MSGS_FULL:
-      fit->mtype = mc->mtype;
-      ncm_fit_log_state (fit);
+      /* Results committed from the reorder buffer no longer have a fit object attached. */
+      if (fit != NULL)
+      {
+        fit->mtype = mc->mtype;
+        ncm_fit_log_state (fit);
+      }
       ncm_mset_catalog_log_current_stats (mc->mcat);
       /* ncm_timer_task_increment (mc->nt); */
       ncm_timer_task_log_elapsed (mc->nt);
@@ -523,6 +755,13 @@ _ncm_fit_mc_update (NcmFitMC *mc, NcmFit *fit)
   }
 }
 
+void
+_ncm_fit_mc_update (NcmFitMC *mc, NcmFit *fit)
+{
+  ncm_mset_catalog_add_from_mset (mc->mcat, fit->mset, ncm_fit_state_get_m2lnL_curval (fit->fstate), NULL);
+  _ncm_fit_mc_log_update (mc, fit);
+}
+
 void
 _ncm_fit_mc_resample_bstrap (NcmDataset *dset, NcmMSet *mset, NcmRNG *rng)
 {
@@ -550,6 +789,28 @@ ncm_fit_mc_start_run (NcmFitMC *mc)
   mc->bf = ncm_vector_new (param_len);
   ncm_mset_param_get_vector (mc->fit->mset, mc->bf);
 
+  ncm_matrix_clear (&mc->refit_covar);
+  mc->newton_oob = 0;
+  if (mc->refit != NCM_FIT_MC_REFIT_COLD)
+  {
+    const guint fparam_len = ncm_mset_fparams_len (mc->fit->mset);
+
+    if (!mc->fit->fstate->has_covar)
+      ncm_fit_numdiff_m2lnL_covar (mc->fit);
+    mc->refit_covar = ncm_matrix_dup (mc->fit->fstate->covar);
+
+    if (mc->bias_check > 0)
+    {
+      if ((mc->refit_bias == NULL) || (ncm_stats_vec_len (mc->refit_bias) != fparam_len + 1))
+      {
+        ncm_stats_vec_clear (&mc->refit_bias);
+        mc->refit_bias = ncm_stats_vec_new (fparam_len + 1, NCM_STATS_VEC_VAR, FALSE);
+      }
+      else
+        ncm_stats_vec_reset (mc->refit_bias, TRUE);
+    }
+  }
+
   switch (mc->mtype)
   {
     default:
@@ -609,9 +870,18 @@ ncm_fit_mc_start_run (NcmFitMC *mc)
 void
 ncm_fit_mc_end_run (NcmFitMC *mc)
 {
+  if ((mc->mtype > NCM_FIT_RUN_MSGS_NONE) && (mc->refit != NCM_FIT_MC_REFIT_COLD))
+    ncm_fit_mc_log_refit_bias (mc);
+
+  if (mc->newton_oob > 0)
+    g_warning ("ncm_fit_mc_end_run: %d Newton steps fell outside the parameter bounds and were discarded, see ncm_fit_mc_get_newton_out_of_bounds().", 
+               mc->newton_oob);
+
   if (ncm_timer_task_is_running (mc->nt))
     ncm_timer_task_end (mc->nt);
 
+  ncm_fit_set_warm_start (mc->fit, NULL);
+
   if (mc->mp != NULL)
   {
     ncm_memory_pool_free (mc->mp, TRUE);
@@ -637,6 +907,7 @@ ncm_fit_mc_reset (NcmFitMC *mc)
   mc->cur_sample_id   = -1;
   mc->write_index     = 0;
   mc->started         = FALSE;  
+  g_hash_table_remove_all (mc->pending);
   ncm_mset_catalog_reset (mc->mcat);
 }
 
@@ -748,6 +1019,10 @@ ncm_fit_mc_run (NcmFitMC *mc, guint n)
   if (mc->mtype > NCM_FIT_RUN_MSGS_NONE)
     ncm_timer_task_log_start_datetime (mc->nt);
 
+  if (mc->substreams && (mc->rng_mp == NULL))
+    mc->rng_mp = ncm_memory_pool_new (&_ncm_fit_mc_dup_rng, mc,
+                                      (GDestroyNotify) &ncm_rng_free);
+
   if (mc->nthreads <= 1)
     _ncm_fit_mc_run_single (mc);
   else
@@ -756,20 +1031,111 @@ ncm_fit_mc_run (NcmFitMC *mc, guint n)
   ncm_timer_task_pause (mc->nt);
 }
 
+static void
+_ncm_fit_mc_newton_step (NcmFitMC *mc, NcmFit *fit, gboolean eval_m2lnL)
+{
+  const guint fparam_len = ncm_mset_fparams_len (fit->mset);
+  NcmVector *grad        = ncm_vector_new (fparam_len);
+  NcmVector *theta       = ncm_vector_new (fparam_len);
+
+  ncm_mset_fparams_get_vector (fit->mset, theta);
+  ncm_fit_m2lnL_grad (fit, grad);
+
+  /* theta_0 - H^{-1} g with H = 2 C^{-1}. */
+  gsl_blas_dsymv (CblasUpper, -0.5, ncm_matrix_gsl (mc->refit_covar), ncm_vector_gsl (grad), 1.0, ncm_vector_gsl (theta));
+
+  /* Steps outside the parameter space keep the fiducial best fit, they are counted and reported in ncm_fit_mc_end_run(). */
+  if (ncm_mset_fparam_valid_bounds (fit->mset, theta))
+    ncm_mset_fparams_set_vector (fit->mset, theta);
+  else
+    g_atomic_int_inc (&mc->newton_oob);
+
+  if (eval_m2lnL)
+  {
+    gdouble m2lnL;
+    ncm_fit_m2lnL_val (fit, &m2lnL);
+    ncm_fit_state_set_m2lnL_curval (fit->fstate, m2lnL);
+  }
+
+  ncm_vector_free (grad);
+  ncm_vector_free (theta);
+}
+
+static void
+_ncm_fit_mc_check_bias (NcmFitMC *mc, NcmFit *fit)
+{
+  const guint fparam_len = ncm_mset_fparams_len (fit->mset);
+  const gdouble m2lnL    = ncm_fit_state_get_m2lnL_curval (fit->fstate);
+  NcmVector *theta       = ncm_vector_new (fparam_len);
+  guint i;
+
+  ncm_mset_fparams_get_vector (fit->mset, theta);
+
+  ncm_mset_param_set_vector (fit->mset, mc->bf);
+  ncm_fit_set_warm_start (fit, NULL);
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+
+  g_mutex_lock (&mc->update_lock);
+  ncm_stats_vec_set (mc->refit_bias, 0, m2lnL - ncm_fit_state_get_m2lnL_curval (fit->fstate));
+  for (i = 0; i < fparam_len; i++)
+  {
+    const gdouble sigma = sqrt (ncm_matrix_get (mc->refit_covar, i, i));
+    ncm_stats_vec_set (mc->refit_bias, i + 1, (ncm_vector_get (theta, i) - ncm_mset_fparam_get (fit->mset, i)) / sigma);
+  }
+  ncm_stats_vec_update (mc->refit_bias);
+  g_mutex_unlock (&mc->update_lock);
+
+  /* The catalog receives the result of the chosen refit mode. */
+  ncm_mset_fparams_set_vector (fit->mset, theta);
+  ncm_fit_state_set_m2lnL_curval (fit->fstate, m2lnL);
+
+  ncm_vector_free (theta);
+}
+
+static void
+_ncm_fit_mc_refit (NcmFitMC *mc, NcmFit *fit, gint sample_index)
+{
+  switch (mc->refit)
+  {
+    case NCM_FIT_MC_REFIT_COLD:
+      ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+      return;
+    case NCM_FIT_MC_REFIT_WARM:
+      _ncm_fit_mc_newton_step (mc, fit, FALSE);
+      ncm_fit_set_warm_start (fit, mc->refit_covar);
+      ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+      break;
+    case NCM_FIT_MC_REFIT_NEWTON:
+      _ncm_fit_mc_newton_step (mc, fit, TRUE);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  if ((mc->bias_check > 0) && (sample_index % mc->bias_check == 0))
+    _ncm_fit_mc_check_bias (mc, fit);
+}
+
 static void 
 _ncm_fit_mc_run_single (NcmFitMC *mc)
 {
+  NcmRNG **sub_ptr = _ncm_fit_mc_get_substream (mc);
   guint i;
 
   for (i = 0; i < mc->n; i++)
   {
+    gint sample_index;
+
     ncm_mset_param_set_vector (mc->fit->mset, mc->bf);
-    _ncm_fit_mc_resample (mc, mc->fit);
-    ncm_fit_run (mc->fit, NCM_FIT_RUN_MSGS_NONE);
+    sample_index = _ncm_fit_mc_resample_next (mc, mc->fit, sub_ptr);
+    _ncm_fit_mc_refit (mc, mc->fit, sample_index);
 
     _ncm_fit_mc_update (mc, mc->fit);
     mc->write_index++;
   }
+
+  _ncm_fit_mc_return_substream (sub_ptr);
 }
 
 static gpointer
@@ -778,18 +1144,48 @@ _ncm_fit_mc_dup_fit (gpointer userdata)
   NcmFitMC *mc = NCM_FIT_MC (userdata);
   g_mutex_lock (&mc->dup_fit);
   {
-    NcmFit *fit = ncm_fit_dup (mc->fit, mc->ser);
+    NcmFit *fit;
+
+    if (mc->share_data && (mc->rtype != NCM_FIT_MC_RESAMPLE_FROM_MODEL))
+    {
+      NcmDataset *view = ncm_dataset_bootstrap_view (mc->fit->lh->dset);
+      fit = ncm_fit_dup_with_dataset (mc->fit, view, mc->ser);
+      ncm_dataset_free (view);
+    }
+    else
+      fit = ncm_fit_dup (mc->fit, mc->ser);
+
     ncm_serialize_reset (mc->ser, TRUE);
     g_mutex_unlock (&mc->dup_fit);
     return fit;
   }
 }
 
+/*
+ * Must be called holding update_lock. Commits, in order, every buffered
+ * result that became contiguous with write_index.
+ */
+static void
+_ncm_fit_mc_commit_pending (NcmFitMC *mc)
+{
+  NcmVector *row;
+
+  while ((row = g_hash_table_lookup (mc->pending, GINT_TO_POINTER (mc->write_index))) != NULL)
+  {
+    ncm_mset_catalog_add_from_vector (mc->mcat, row);
+    _ncm_fit_mc_log_update (mc, NULL);
+
+    g_hash_table_remove (mc->pending, GINT_TO_POINTER (mc->write_index));
+    mc->write_index++;
+  }
+}
+
 static void 
 _ncm_fit_mc_mt_eval_keep_order (glong i, glong f, gpointer data)
 {
   NcmFitMC *mc = NCM_FIT_MC (data);
   NcmFit **fit_ptr = ncm_memory_pool_get (mc->mp);
+  NcmRNG **sub_ptr = _ncm_fit_mc_get_substream (mc);
   NcmFit *fit = *fit_ptr;
   guint j;
 
@@ -799,23 +1195,34 @@ _ncm_fit_mc_mt_eval_keep_order (glong i, glong f, gpointer data)
 
     ncm_mset_param_set_vector (fit->mset, mc->bf);
 
-    g_mutex_lock (&mc->resample_lock);
-    sample_index = _ncm_fit_mc_resample (mc, fit);
-    g_mutex_unlock (&mc->resample_lock);
+    sample_index = _ncm_fit_mc_resample_next (mc, fit, sub_ptr);
 
-    ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+    _ncm_fit_mc_refit (mc, fit, sample_index);
 
     g_mutex_lock (&mc->update_lock);    
-    while (mc->write_index != sample_index)
-      g_cond_wait (&mc->write_cond, &mc->update_lock);
+    if (mc->write_index == sample_index)
+    {
+      _ncm_fit_mc_update (mc, fit);
+      mc->write_index++;
+      _ncm_fit_mc_commit_pending (mc);
+    }
+    else
+    {
+      /* 
+       * Out of order result: store the catalog row and move on to the
+       * next realization, the thread owning write_index commits it.
+       */
+      NcmVector *row = ncm_vector_new (ncm_mset_catalog_ncols (mc->mcat));
 
-    _ncm_fit_mc_update (mc, fit);
-    mc->write_index++;
-    g_cond_broadcast (&mc->write_cond);
+      ncm_vector_set (row, 0, ncm_fit_state_get_m2lnL_curval (fit->fstate));
+      ncm_mset_fparams_get_vector_offset (fit->mset, row, 1);
 
+      g_hash_table_insert (mc->pending, GINT_TO_POINTER (sample_index), row);
+    }
     g_mutex_unlock (&mc->update_lock);    
   }
 
+  _ncm_fit_mc_return_substream (sub_ptr);
   ncm_memory_pool_return (fit_ptr);
 }
 
@@ -826,18 +1233,19 @@ _ncm_fit_mc_mt_eval (glong i, glong f, gpointer data)
   G_LOCK_DEFINE_STATIC (update_lock);
   NcmFitMC *mc = NCM_FIT_MC (data);
   NcmFit **fit_ptr = ncm_memory_pool_get (mc->mp);
+  NcmRNG **sub_ptr = _ncm_fit_mc_get_substream (mc);
   NcmFit *fit = *fit_ptr;
   guint j;
 
   for (j = i; j < f; j++)
   {
+    gint sample_index;
+
     ncm_mset_param_set_vector (fit->mset, mc->bf);
 
-    g_mutex_lock (&mc->resample_lock);
-    _ncm_fit_mc_resample (mc, fit);
-    g_mutex_unlock (&mc->resample_lock);
+    sample_index = _ncm_fit_mc_resample_next (mc, fit, sub_ptr);
 
-    ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+    _ncm_fit_mc_refit (mc, fit, sample_index);
 
     G_LOCK (update_lock);    
     _ncm_fit_mc_update (mc, fit);
@@ -845,6 +1253,7 @@ _ncm_fit_mc_mt_eval (glong i, glong f, gpointer data)
     G_UNLOCK (update_lock);
   }
 
+  _ncm_fit_mc_return_substream (sub_ptr);
   ncm_memory_pool_return (fit_ptr);
 }
 
@@ -875,7 +1284,10 @@ _ncm_fit_mc_run_mt (NcmFitMC *mc)
   g_assert_cmpuint (mc->nthreads, >, 1);
 
   if (mc->keep_order)
+  {
     ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval_keep_order, 0, mc->n, mc);
+    g_assert_cmpuint (g_hash_table_size (mc->pending), ==, 0);
+  }
   else
     ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval, 0, mc->n, mc);  
 }
@@ -960,3 +1372,79 @@ ncm_fit_mc_get_catalog (NcmFitMC *mc)
 {
   return ncm_mset_catalog_ref (mc->mcat);
 }
+
+/**
+ * ncm_fit_mc_peek_refit_bias:
+ * @mc: a #NcmFitMC
+ *
+ * Gets the statistics of the differences between the refits and the
+ * cold fits of the checked realizations, see ncm_fit_mc_set_bias_check().
+ * The first component is the difference in $-2\ln(L)$ and the others
+ * are the differences in each fitting parameter in units of the
+ * fiducial standard deviation.
+ * 
+ * Returns: (transfer none) (allow-none): the refit bias #NcmStatsVec or NULL.
+ */
+NcmStatsVec *
+ncm_fit_mc_peek_refit_bias (NcmFitMC *mc)
+{
+  return mc->refit_bias;
+}
+
+/**
+ * ncm_fit_mc_get_newton_out_of_bounds:
+ * @mc: a #NcmFitMC
+ *
+ * Gets the number of realizations of the current run whose Newton step,
+ * see ncm_fit_mc_set_refit(), fell outside the parameter bounds. For
+ * these realizations the step is discarded: #NCM_FIT_MC_REFIT_WARM
+ * starts the refit from the fiducial best fit and #NCM_FIT_MC_REFIT_NEWTON
+ * records the fiducial best fit itself.
+ * 
+ * Returns: the number of Newton steps outside the parameter bounds.
+ */
+guint
+ncm_fit_mc_get_newton_out_of_bounds (NcmFitMC *mc)
+{
+  return g_atomic_int_get (&mc->newton_oob);
+}
+
+/**
+ * ncm_fit_mc_log_refit_bias:
+ * @mc: a #NcmFitMC
+ *
+ * Logs the mean time per realization and, when available, the
+ * bias of the refits against the cold fits, see ncm_fit_mc_set_bias_check().
+ * 
+ */
+void
+ncm_fit_mc_log_refit_bias (NcmFitMC *mc)
+{
+  const GEnumValue *refit = ncm_cfg_enum_get_value (NCM_TYPE_FIT_MC_REFIT, mc->refit);
+
+  ncm_cfg_msg_sepa ();
+  g_message ("# NcmFitMC: Refit mode `%s', mean time per realization: %s.\n", 
+             refit->value_nick, ncm_timer_task_mean_time_str (mc->nt));
+
+  if (mc->newton_oob > 0)
+    g_message ("# NcmFitMC: %d Newton steps outside the parameter bounds were discarded.\n", mc->newton_oob);
+
+  if ((mc->refit_bias != NULL) && (ncm_stats_vec_get_weight (mc->refit_bias) > 0.0))
+  {
+    const guint len = ncm_stats_vec_len (mc->refit_bias);
+    guint i;
+
+    g_message ("# NcmFitMC: Refit minus cold fit over %.0f checked realizations:\n", 
+               ncm_stats_vec_get_weight (mc->refit_bias));
+    g_message ("#   %-30s: mean % 12.5g sd % 12.5g\n", "Delta m2lnL",
+               ncm_stats_vec_get_mean (mc->refit_bias, 0),
+               ncm_stats_vec_get_sd (mc->refit_bias, 0));
+    for (i = 1; i < len; i++)
+    {
+      g_message ("#   %-30s: mean % 12.5g sd % 12.5g (in fiducial sigmas)\n", 
+                 ncm_mset_fparam_name (mc->fit->mset, i - 1),
+                 ncm_stats_vec_get_mean (mc->refit_bias, i),
+                 ncm_stats_vec_get_sd (mc->refit_bias, i));
+    }
+  }
+}
@@ -33,6 +33,7 @@
 #include <numcosmo/math/ncm_mset_catalog.h>
 #include <numcosmo/math/ncm_timer.h>
 #include <numcosmo/math/ncm_memory_pool.h>
+#include <numcosmo/math/ncm_stats_vec.h>
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_histogram.h>
@@ -71,6 +72,24 @@ typedef enum _NcmFitMCResampleType
   NCM_FIT_MC_RESAMPLE_BOOTSTRAP_LEN, /*< skip >*/
 } NcmFitMCResampleType;
 
+/**
+ * NcmFitMCRefit:
+ * @NCM_FIT_MC_REFIT_COLD: each realization is fitted starting from the fiducial best fit with the default minimizer initialization.
+ * @NCM_FIT_MC_REFIT_WARM: each realization is fitted starting from the Newton step around the fiducial best fit, with the minimizer initialized from the fiducial covariance (see ncm_fit_set_warm_start()).
+ * @NCM_FIT_MC_REFIT_NEWTON: no fit is performed, each realization is estimated by the Newton step (linear response) around the fiducial best fit.
+ * 
+ * How each resampled realization is refitted.
+ * 
+ */
+typedef enum _NcmFitMCRefit
+{
+  NCM_FIT_MC_REFIT_COLD = 0,
+  NCM_FIT_MC_REFIT_WARM,
+  NCM_FIT_MC_REFIT_NEWTON, 
+  /* < private > */
+  NCM_FIT_MC_REFIT_LEN, /*< skip >*/
+} NcmFitMCRefit;
+
 typedef void (*NcmFitMCResample) (NcmDataset *dset, NcmMSet *mset, NcmRNG *rng);
 
 struct _NcmFitMCClass
@@ -89,21 +108,29 @@ struct _NcmFitMC
   NcmMSetCatalog *mcat;
   NcmFitRunMsgs mtype;
   NcmFitMCResampleType rtype;
+  NcmFitMCRefit refit;
+  guint bias_check;
+  NcmMatrix *refit_covar;
+  NcmStatsVec *refit_bias;
+  gint newton_oob;
   NcmVector *bf;
   NcmTimer *nt;
   NcmSerialize *ser;
   guint nthreads;
   guint n;
   gboolean keep_order;
+  gboolean substreams;
+  gboolean share_data;
   NcmMemoryPool *mp;
+  NcmMemoryPool *rng_mp;
   gint write_index;
   gint cur_sample_id;
   gint first_sample_id;
   gboolean started;
+  GHashTable *pending;
   GMutex dup_fit;
   GMutex resample_lock;
   GMutex update_lock;
-  GCond write_cond;
 };
 
 GType ncm_fit_mc_get_type (void) G_GNUC_CONST;
@@ -118,6 +145,10 @@ void ncm_fit_mc_set_mtype (NcmFitMC *mc, NcmFitRunMsgs mtype);
 void ncm_fit_mc_set_rtype (NcmFitMC *mc, NcmFitMCResampleType rtype);
 void ncm_fit_mc_set_nthreads (NcmFitMC *mc, guint nthreads);
 void ncm_fit_mc_keep_order (NcmFitMC *mc, gboolean keep_order);
+void ncm_fit_mc_use_rng_substreams (NcmFitMC *mc, gboolean substreams);
+void ncm_fit_mc_share_data (NcmFitMC *mc, gboolean share_data);
+void ncm_fit_mc_set_refit (NcmFitMC *mc, NcmFitMCRefit refit);
+void ncm_fit_mc_set_bias_check (NcmFitMC *mc, guint bias_check);
 void ncm_fit_mc_set_fiducial (NcmFitMC *mc, NcmMSet *fiduc);
 void ncm_fit_mc_set_rng (NcmFitMC *mc, NcmRNG *rng);
 
@@ -130,6 +161,9 @@ void ncm_fit_mc_run_lre (NcmFitMC *mc, guint prerun, gdouble lre);
 void ncm_fit_mc_mean_covar (NcmFitMC *mc);
 
 NcmMSetCatalog *ncm_fit_mc_get_catalog (NcmFitMC *mc);
+NcmStatsVec *ncm_fit_mc_peek_refit_bias (NcmFitMC *mc);
+guint ncm_fit_mc_get_newton_out_of_bounds (NcmFitMC *mc);
+void ncm_fit_mc_log_refit_bias (NcmFitMC *mc);
 
 #define NCM_FIT_MC_MIN_SYNC_INTERVAL (10.0)
 
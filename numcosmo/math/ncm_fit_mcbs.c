@@ -265,6 +265,21 @@ ncm_fit_mcbs_set_rng (NcmFitMCBS *mcbs, NcmRNG *rng)
   ncm_mset_catalog_set_rng (mcbs->mcat, rng);
 }
 
+/**
+ * ncm_fit_mcbs_share_data:
+ * @mcbs: a #NcmFitMCBS
+ * @share_data: whether to share the data arrays
+ *
+ * Sets whether the threads of the bootstrap runs share the data arrays,
+ * see ncm_fit_mc_share_data().
+ *
+ */
+void
+ncm_fit_mcbs_share_data (NcmFitMCBS *mcbs, gboolean share_data)
+{
+  ncm_fit_mc_share_data (mcbs->mc_bstrap, share_data);
+}
+
 /**
  * ncm_fit_mcbs_run:
  * @mcbs: a #NcmFitMCBS
@@ -69,6 +69,7 @@ void ncm_fit_mcbs_clear (NcmFitMCBS **mcbs);
 
 void ncm_fit_mcbs_set_filename (NcmFitMCBS *mcbs, const gchar *filename);
 void ncm_fit_mcbs_set_rng (NcmFitMCBS *mcbs, NcmRNG *rng);
+void ncm_fit_mcbs_share_data (NcmFitMCBS *mcbs, gboolean share_data);
 void ncm_fit_mcbs_run (NcmFitMCBS *mcbs, NcmMSet *fiduc, guint ni, guint nf, guint nbstraps, NcmFitMCResampleType rtype, NcmFitRunMsgs mtype, guint bsmt);
 
 NcmMSetCatalog *ncm_fit_mcbs_get_catalog (NcmFitMCBS *mcbs);
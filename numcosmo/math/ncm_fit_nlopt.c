@@ -296,7 +296,10 @@ _ncm_fit_nlopt_run (NcmFit *fit, NcmFitRunMsgs mtype)
       ncm_vector_set (fit_nlopt->lb,     i, ncm_mset_fparam_get_lower_bound (fit->mset, i));
       ncm_vector_set (fit_nlopt->ub,     i, ncm_mset_fparam_get_upper_bound (fit->mset, i));
       ncm_vector_set (fit_nlopt->pabs,   i, ncm_mset_fparam_get_abstol (fit->mset, i));
-      ncm_vector_set (fit_nlopt->pscale, i, ncm_mset_fparam_get_scale (fit->mset, i));
+      if (fit->warm_covar != NULL)
+        ncm_vector_set (fit_nlopt->pscale, i, sqrt (ncm_matrix_get (fit->warm_covar, i, i)));
+      else
+        ncm_vector_set (fit_nlopt->pscale, i, ncm_mset_fparam_get_scale (fit->mset, i));
     }
 
     nlopt_remove_inequality_constraints (fit_nlopt->nlopt);
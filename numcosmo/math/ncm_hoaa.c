@@ -76,6 +76,9 @@
 #include "math/ncm_util.h"
 #include "math/ncm_rng.h"
 #include "math/ncm_diff.h"
+#include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
+#include "math/ncm_serialize.h"
 #include "ncm_enum_types.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
@@ -150,6 +153,7 @@ struct _NcmHOAAPrivate
   NcmSpline *upsilon_s, *gamma_s, *qbar_s, *pbar_s;
   gdouble sigma0;
   NcmDiff *diff;
+  guint nthreads;
 };
 
 enum
@@ -162,6 +166,7 @@ enum
   PROP_TF,
   PROP_SAVE_EVOL,
   PROP_OPT,
+  PROP_NTHREADS,
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (NcmHOAA, ncm_hoaa, G_TYPE_OBJECT);
@@ -221,6 +226,7 @@ ncm_hoaa_init (NcmHOAA *hoaa)
   self->sigma0    = 0.0;
 
   self->diff      = ncm_diff_new ();
+  self->nthreads  = 0;
   
   ncm_rng_set_random_seed (self->rng, TRUE);
 }
@@ -257,6 +263,9 @@ _ncm_hoaa_set_property (GObject *object, guint prop_id, const GValue *value, GPa
       if (self->opt == NCM_HOAA_OPT_INVALID)
         g_error ("_ncm_hoaa_set_property: `opt' property must be set.");
       break;
+    case PROP_NTHREADS:
+      ncm_hoaa_set_nthreads (hoaa, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -293,6 +302,9 @@ _ncm_hoaa_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
     case PROP_OPT:
       g_value_set_enum (value, self->opt);
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_hoaa_get_nthreads (hoaa));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -476,6 +488,13 @@ ncm_hoaa_class_init (NcmHOAAClass *klass)
                                                       "Evolution options",
                                                       NCM_TYPE_HOAA_OPT, NCM_HOAA_OPT_INVALID,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used by ncm_hoaa_eval_Delta_array()",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
   klass->eval_mnu         = &_ncm_hoaa_eval_mnu;
   klass->eval_nu          = &_ncm_hoaa_eval_nu;
@@ -635,6 +654,35 @@ ncm_hoaa_save_evol (NcmHOAA *hoaa, gboolean save_evol)
   }
 }
 
+/**
+ * ncm_hoaa_set_nthreads:
+ * @hoaa: a #NcmHOAA
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used by ncm_hoaa_eval_Delta_array(),
+ * values smaller than two disable threading.
+ *
+ */
+void 
+ncm_hoaa_set_nthreads (NcmHOAA *hoaa, const guint nthreads)
+{
+  NcmHOAAPrivate * const self = hoaa->priv;
+  self->nthreads = nthreads;
+}
+
+/**
+ * ncm_hoaa_get_nthreads:
+ * @hoaa: a #NcmHOAA
+ *
+ * Returns: the number of threads used by ncm_hoaa_eval_Delta_array().
+ */
+guint 
+ncm_hoaa_get_nthreads (NcmHOAA *hoaa)
+{
+  NcmHOAAPrivate * const self = hoaa->priv;
+  return self->nthreads;
+}
+
 typedef struct _NcmHOAAArg
 {
   NcmHOAA *hoaa;
@@ -2600,6 +2648,141 @@ ncm_hoaa_eval_solution (NcmHOAA *hoaa, NcmModel *model, const gdouble t, const g
   Av[0] = 0.5 * (Pq * S - PS * q);
 }
 
+typedef struct _NcmHOAADeltaArray
+{
+  NcmHOAA *hoaa;
+  NcmModel *model;
+  NcmSerialize *ser;
+  GMutex dup_lock;
+  NcmMemoryPool *mp;
+  gdouble t;
+  NcmVector *k;
+  NcmVector *Delta_phi;
+  NcmVector *Delta_Pphi;
+} NcmHOAADeltaArray;
+
+typedef struct _NcmHOAADeltaWorker
+{
+  NcmHOAA *hoaa;
+  NcmModel *model;
+} NcmHOAADeltaWorker;
+
+static gpointer
+_ncm_hoaa_delta_worker_dup (gpointer userdata)
+{
+  NcmHOAADeltaArray *da  = (NcmHOAADeltaArray *) userdata;
+  NcmHOAADeltaWorker *dw = g_new (NcmHOAADeltaWorker, 1);
+
+  g_mutex_lock (&da->dup_lock);
+
+  dw->hoaa  = NCM_HOAA (ncm_serialize_dup_obj (da->ser, G_OBJECT (da->hoaa)));
+  dw->model = (da->model != NULL) ? ncm_model_dup (da->model, da->ser) : NULL;
+
+  ncm_serialize_reset (da->ser, TRUE);
+  g_mutex_unlock (&da->dup_lock);
+
+  return dw;
+}
+
+static void
+_ncm_hoaa_delta_worker_free (gpointer p)
+{
+  NcmHOAADeltaWorker *dw = (NcmHOAADeltaWorker *) p;
+
+  ncm_hoaa_clear (&dw->hoaa);
+  ncm_model_clear (&dw->model);
+
+  g_free (dw);
+}
+
+static void
+_ncm_hoaa_eval_Delta_k (NcmHOAADeltaArray *da, NcmHOAA *hoaa, NcmModel *model, const glong j)
+{
+  gdouble Delta_phi, Delta_Pphi;
+
+  ncm_hoaa_set_k (hoaa, ncm_vector_get (da->k, j));
+  ncm_hoaa_prepare (hoaa, model);
+  ncm_hoaa_eval_Delta (hoaa, model, da->t, &Delta_phi, &Delta_Pphi);
+
+  ncm_vector_set (da->Delta_phi, j, Delta_phi);
+  if (da->Delta_Pphi != NULL)
+    ncm_vector_set (da->Delta_Pphi, j, Delta_Pphi);
+}
+
+static void
+_ncm_hoaa_eval_Delta_mt (glong i, glong f, gpointer data)
+{
+  NcmHOAADeltaArray *da       = (NcmHOAADeltaArray *) data;
+  NcmHOAADeltaWorker **dw_ptr = ncm_memory_pool_get (da->mp);
+  NcmHOAADeltaWorker *dw      = *dw_ptr;
+  glong j;
+
+  for (j = i; j < f; j++)
+    _ncm_hoaa_eval_Delta_k (da, dw->hoaa, dw->model, j);
+
+  ncm_memory_pool_return (dw_ptr);
+}
+
+/**
+ * ncm_hoaa_eval_Delta_array:
+ * @hoaa: a #NcmHOAA
+ * @model: (allow-none): a #NcmModel
+ * @t: time $t$
+ * @k: a #NcmVector containing the modes $k$
+ * @Delta_phi: a #NcmVector to store $\Delta_\phi(k)$
+ * @Delta_Pphi: (allow-none): a #NcmVector to store $\Delta_{P_\phi}(k)$
+ * 
+ * Prepares the solution for each mode in @k and calculates the power 
+ * spectra at $t$, see ncm_hoaa_eval_Delta(). 
+ * 
+ * When #NcmHOAA:nthreads is larger than one the modes are distributed,
+ * one at a time, among the threads in the library thread pool, each 
+ * thread using its own copies of @hoaa and @model. In this case @hoaa
+ * is left untouched, otherwise it ends prepared for the last mode.
+ *
+ */
+void 
+ncm_hoaa_eval_Delta_array (NcmHOAA *hoaa, NcmModel *model, const gdouble t, NcmVector *k, NcmVector *Delta_phi, NcmVector *Delta_Pphi)
+{
+  NcmHOAAPrivate * const self = hoaa->priv;
+  const guint len = ncm_vector_len (k);
+  NcmHOAADeltaArray da;
+
+  g_assert_cmpuint (ncm_vector_len (Delta_phi), ==, len);
+  if (Delta_Pphi != NULL)
+    g_assert_cmpuint (ncm_vector_len (Delta_Pphi), ==, len);
+
+  da.hoaa       = hoaa;
+  da.model      = model;
+  da.ser        = NULL;
+  da.mp         = NULL;
+  da.t          = t;
+  da.k          = k;
+  da.Delta_phi  = Delta_phi;
+  da.Delta_Pphi = Delta_Pphi;
+
+  if ((self->nthreads > 1) && (len > 1))
+  {
+    da.ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+    da.mp  = ncm_memory_pool_new (&_ncm_hoaa_delta_worker_dup, &da,
+                                  (GDestroyNotify) &_ncm_hoaa_delta_worker_free);
+    g_mutex_init (&da.dup_lock);
+
+    ncm_func_eval_threaded_loop_full (&_ncm_hoaa_eval_Delta_mt, 0, len, &da);
+
+    ncm_memory_pool_free (da.mp, TRUE);
+    ncm_serialize_free (da.ser);
+    g_mutex_clear (&da.dup_lock);
+  }
+  else
+  {
+    guint j;
+
+    for (j = 0; j < len; j++)
+      _ncm_hoaa_eval_Delta_k (&da, hoaa, model, j);
+  }
+}
+
 /**
  * ncm_hoaa_eval_nu: (virtual eval_nu)
  * @hoaa: a #NcmHOAA
@@ -136,6 +136,8 @@ void ncm_hoaa_set_abstol (NcmHOAA *hoaa, const gdouble abstol);
 void ncm_hoaa_set_k (NcmHOAA *hoaa, const gdouble k);
 void ncm_hoaa_set_ti (NcmHOAA *hoaa, const gdouble ti);
 void ncm_hoaa_set_tf (NcmHOAA *hoaa, const gdouble tf);
+void ncm_hoaa_set_nthreads (NcmHOAA *hoaa, const guint nthreads);
+guint ncm_hoaa_get_nthreads (NcmHOAA *hoaa);
 
 void ncm_hoaa_save_evol (NcmHOAA *hoaa, gboolean save_evol);
 void ncm_hoaa_prepare (NcmHOAA *hoaa, NcmModel *model);
@@ -150,6 +152,7 @@ void ncm_hoaa_eval_QV2AA (NcmHOAA *hoaa, NcmModel *model, const gdouble t, const
 void ncm_hoaa_eval_QV (NcmHOAA *hoaa, NcmModel *model, const gdouble t, gdouble *q, gdouble *v, gdouble *Pq, gdouble *Pv);
 void ncm_hoaa_eval_Delta (NcmHOAA *hoaa, NcmModel *model, const gdouble t, gdouble *Delta_phi, gdouble *Delta_Pphi);
 void ncm_hoaa_eval_solution (NcmHOAA *hoaa, NcmModel *model, const gdouble t, const gdouble S, const gdouble PS, gdouble *Aq, gdouble *Av);
+void ncm_hoaa_eval_Delta_array (NcmHOAA *hoaa, NcmModel *model, const gdouble t, NcmVector *k, NcmVector *Delta_phi, NcmVector *Delta_Pphi);
 
 NCM_INLINE gdouble ncm_hoaa_eval_nu (NcmHOAA *hoaa, NcmModel *model, const gdouble t, const gdouble k);
 NCM_INLINE gdouble ncm_hoaa_eval_mnu (NcmHOAA *hoaa, NcmModel *model, const gdouble t, const gdouble k);
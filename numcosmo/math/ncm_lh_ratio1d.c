@@ -42,6 +42,8 @@
 #include "math/ncm_c.h"
 #include "math/ncm_cfg.h"
 #include "math/ncm_util.h"
+#include "math/ncm_func_eval.h"
+#include "math/ncm_diff.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_cdf.h>
@@ -55,6 +57,7 @@ enum
   PROP_FIT,
   PROP_PI,
   PROP_CONSTRAINT,
+  PROP_NTHREADS,
   PROP_SIZE,
 };
 
@@ -75,6 +78,7 @@ ncm_lh_ratio1d_init (NcmLHRatio1d *lhr1d)
   lhr1d->niter       = 0;
   lhr1d->func_eval   = 0;
   lhr1d->grad_eval   = 0;
+  lhr1d->nthreads    = 0;
   lhr1d->mtype       = NCM_FIT_RUN_MSGS_NONE;
   lhr1d->rtype       = NCM_LH_RATIO1D_ROOT_BRACKET;
 }
@@ -136,6 +140,9 @@ ncm_lh_ratio1d_set_property (GObject *object, guint prop_id, const GValue *value
     case PROP_CONSTRAINT:
       lhr1d->constraint = g_value_dup_object (value);
       break;
+    case PROP_NTHREADS:
+      ncm_lh_ratio1d_set_nthreads (lhr1d, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -162,6 +169,9 @@ ncm_lh_ratio1d_get_property (GObject *object, guint prop_id, GValue *value, GPar
     case PROP_CONSTRAINT:
       g_value_set_object (value, lhr1d->constraint);
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_lh_ratio1d_get_nthreads (lhr1d));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -222,6 +232,20 @@ ncm_lh_ratio1d_class_init (NcmLHRatio1dClass *klass)
                                                         "Constraint",
                                                         NCM_TYPE_MSET_FUNC,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  /**
+   * NcmLHRatio1d:nthreads:
+   *
+   * Number of threads, values larger than one search both bounds concurrently.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 
@@ -402,22 +426,40 @@ ncm_lh_ratio1d_log_finish (NcmLHRatio1d *lhr1d, gdouble pl, gdouble pu)
   }  
 }
 
+/*
+ * Each bound is searched by its own profile fit, so the lower and upper
+ * searches can run concurrently with independent NcmFit copies.
+ */
+typedef struct _NcmLHRatio1dBound
+{
+  NcmLHRatio1d *lhr1d;
+  NcmFit *constrained;
+  NcmDiff *diff;
+  gdouble (*root) (struct _NcmLHRatio1dBound *bound, gdouble x0, gdouble x);
+  gdouble scale;
+  gdouble res;
+  guint niter;
+  guint func_eval;
+  guint grad_eval;
+} NcmLHRatio1dBound;
+
 static gdouble
 ncm_lh_ratio1d_f (gdouble x, gpointer ptr)
 {
-  NcmLHRatio1d *lhr1d = NCM_LH_RATIO1D (ptr);
+  NcmLHRatio1dBound *bound = (NcmLHRatio1dBound *) ptr;
+  NcmLHRatio1d *lhr1d      = bound->lhr1d;
   gdouble p = lhr1d->bf + x;
 
   p = GSL_MAX (p, lhr1d->lb);
   p = GSL_MIN (p, lhr1d->ub);
 
-  ncm_mset_param_set (lhr1d->constrained->mset, lhr1d->pi.mid, lhr1d->pi.pid, p);
+  ncm_mset_param_set (bound->constrained->mset, lhr1d->pi.mid, lhr1d->pi.pid, p);
 
-  ncm_fit_run (lhr1d->constrained, NCM_FIT_RUN_MSGS_NONE);
+  ncm_fit_run (bound->constrained, NCM_FIT_RUN_MSGS_NONE);
 
-  lhr1d->niter     += lhr1d->constrained->fstate->niter;
-  lhr1d->func_eval += lhr1d->constrained->fstate->func_eval;
-  lhr1d->grad_eval += lhr1d->constrained->fstate->grad_eval;
+  bound->niter     += bound->constrained->fstate->niter;
+  bound->func_eval += bound->constrained->fstate->func_eval;
+  bound->grad_eval += bound->constrained->fstate->grad_eval;
 
   if (p == lhr1d->lb)
   {
@@ -431,15 +473,16 @@ ncm_lh_ratio1d_f (gdouble x, gpointer ptr)
   }
 
   {
-    const gdouble m2lnL_const = ncm_fit_state_get_m2lnL_curval (lhr1d->constrained->fstate);
+    const gdouble m2lnL_const = ncm_fit_state_get_m2lnL_curval (bound->constrained->fstate);
     const gdouble m2lnL = ncm_fit_state_get_m2lnL_curval (lhr1d->fit->fstate);
     return m2lnL_const - (m2lnL + lhr1d->chisquare);
   }
 }
 
 static gdouble
-ncm_lh_ratio1d_root_brent (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x)
+ncm_lh_ratio1d_root_brent (NcmLHRatio1dBound *bound, gdouble x0, gdouble x)
 {
+  NcmLHRatio1d *lhr1d = bound->lhr1d;
   gint status;
   gint iter = 0, max_iter = 1000000;
   const gsl_root_fsolver_type *T;
@@ -448,7 +491,7 @@ ncm_lh_ratio1d_root_brent (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x)
   gdouble prec = 1e-5, x1 = x;
 
   F.function = &ncm_lh_ratio1d_f;
-  F.params   = lhr1d;
+  F.params   = bound;
 
   T = gsl_root_fsolver_brent;
   s = gsl_root_fsolver_alloc (T);
@@ -474,7 +517,7 @@ ncm_lh_ratio1d_root_brent (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x)
 
     ncm_lh_ratio1d_log_root_step (lhr1d, x0, x1);
 
-    if (!gsl_finite (ncm_lh_ratio1d_f (x, lhr1d)))
+    if (!gsl_finite (ncm_lh_ratio1d_f (x, bound)))
     {
       g_debug ("Ops");
       x = GSL_NAN;
@@ -492,10 +535,10 @@ ncm_lh_ratio1d_root_brent (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x)
 static gdouble
 ncm_lh_ratio1d_numdiff_df (gdouble x, gpointer p)
 {
-  NcmLHRatio1d *lhr1d = NCM_LH_RATIO1D (p);
+  NcmLHRatio1dBound *bound = (NcmLHRatio1dBound *) p;
   gdouble res, err;
 
-  res = ncm_diff_rf_d1_1_to_1 (lhr1d->fit->diff, x, ncm_lh_ratio1d_f, p, &err);
+  res = ncm_diff_rf_d1_1_to_1 (bound->diff, x, ncm_lh_ratio1d_f, p, &err);
 
   return res;
 }
@@ -510,8 +553,9 @@ ncm_lh_ratio1d_numdiff_fdf (gdouble x, gpointer p, gdouble *y, gdouble *dy)
 
 
 static gdouble
-ncm_lh_ratio1d_root_steffenson (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x1)
+ncm_lh_ratio1d_root_steffenson (NcmLHRatio1dBound *bound, gdouble x0, gdouble x1)
 {
+  NcmLHRatio1d *lhr1d = bound->lhr1d;
   gint status;
   gint iter = 0, max_iter = 1000000;
   const gsl_root_fdfsolver_type *T;
@@ -523,7 +567,7 @@ ncm_lh_ratio1d_root_steffenson (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x1)
   F.f = &ncm_lh_ratio1d_f;
   F.df = &ncm_lh_ratio1d_numdiff_df;
   F.fdf = &ncm_lh_ratio1d_numdiff_fdf;
-  F.params = lhr1d;
+  F.params = bound;
 
   T = gsl_root_fdfsolver_steffenson;
   s = gsl_root_fdfsolver_alloc (T);
@@ -549,7 +593,7 @@ ncm_lh_ratio1d_root_steffenson (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x1)
 
     ncm_lh_ratio1d_log_root_step (lhr1d, x, x0);
 
-    if (!gsl_finite (ncm_lh_ratio1d_f (x, lhr1d)))
+    if (!gsl_finite (ncm_lh_ratio1d_f (x, bound)))
     {
       g_debug ("Ops");
       x = GSL_NAN;
@@ -566,6 +610,46 @@ ncm_lh_ratio1d_root_steffenson (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x1)
 
 #define NCM_LH_RATIO1D_SCALE_INCR (1.1)
 
+/*
+ * Searches one bound, walking away from the best fit by steps of
+ * bound->scale (negative for the lower bound) until the profile
+ * likelihood crosses the threshold. The profile fit starts from the
+ * best fit, its nearest converged neighbour, and then follows the
+ * previous step along the walk.
+ */
+static void
+_ncm_lh_ratio1d_find_bound (NcmLHRatio1dBound *bound)
+{
+  NcmLHRatio1d *lhr1d = bound->lhr1d;
+  gdouble r_s = bound->scale;
+  gdouble r   = 0.0;
+  gdouble val;
+
+  ncm_mset_param_set_mset (bound->constrained->mset, lhr1d->fit->mset);
+
+  while ((val = ncm_lh_ratio1d_f (r_s, bound)) < 0.0)
+  {
+    ncm_lh_ratio1d_log_param_val (lhr1d, r_s, val);
+    r = r_s;
+    r_s *= NCM_LH_RATIO1D_SCALE_INCR;
+  }
+
+  if (bound->scale < 0.0)
+    bound->res = bound->root (bound, r_s, r);
+  else
+    bound->res = bound->root (bound, r, r_s);
+}
+
+static void
+_ncm_lh_ratio1d_find_bound_mt (glong i, glong f, gpointer data)
+{
+  NcmLHRatio1dBound *bounds = (NcmLHRatio1dBound *) data;
+  glong l;
+
+  for (l = i; l < f; l++)
+    _ncm_lh_ratio1d_find_bound (&bounds[l]);
+}
+
 /**
  * ncm_lh_ratio1d_find_bounds:
  * @lhr1d: a #NcmLHRatio1d
@@ -574,14 +658,22 @@ ncm_lh_ratio1d_root_steffenson (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x1)
  * @lb: (out): lower bound
  * @ub: (out): upper bound 
  * 
- * FIXME
+ * Finds the profile likelihood interval of the parameter at
+ * confidence level @clevel. Both searches start from the best fit
+ * and the profile fits are warm-started with the best fit
+ * covariance, see ncm_fit_set_warm_start_from(). When
+ * #NcmLHRatio1d:nthreads is larger than one the lower and upper
+ * bounds are searched concurrently, each with its own copy of the
+ * constrained fit; the intermediate messages are then suppressed.
  * 
  */
 void 
 ncm_lh_ratio1d_find_bounds (NcmLHRatio1d *lhr1d, gdouble clevel, NcmFitRunMsgs mtype, gdouble *lb, gdouble *ub)
 {
-  gdouble scale, r, r_min, r_max, val;
-  static gdouble (*root) (NcmLHRatio1d *lhr1d, gdouble x0, gdouble x);
+  gdouble scale, r_min, r_max;
+  gdouble (*root) (NcmLHRatio1dBound *bound, gdouble x0, gdouble x);
+  NcmLHRatio1dBound bounds[2];
+  guint i;
 
   g_assert_cmpfloat (clevel, >, 0.0);
   g_assert_cmpfloat (clevel, <, 1.0);
@@ -591,8 +683,6 @@ ncm_lh_ratio1d_find_bounds (NcmLHRatio1d *lhr1d, gdouble clevel, NcmFitRunMsgs m
   scale = sqrt (lhr1d->chisquare) * 
     ncm_fit_covar_sd (lhr1d->fit, lhr1d->pi.mid, lhr1d->pi.pid);
 
-  r = 0.0;
-
   r_min = -scale;
   r_max =  scale;
 
@@ -618,23 +708,64 @@ ncm_lh_ratio1d_find_bounds (NcmLHRatio1d *lhr1d, gdouble clevel, NcmFitRunMsgs m
   lhr1d->mtype = mtype;
 
   ncm_lh_ratio1d_log_start (lhr1d, clevel);
-  
-  while ((val = ncm_lh_ratio1d_f (r_min, lhr1d)) < 0.0)
+
+  ncm_fit_set_warm_start_from (lhr1d->constrained, lhr1d->fit);
+
+  for (i = 0; i < 2; i++)
   {
-    ncm_lh_ratio1d_log_param_val (lhr1d, r_min, val);
-    r = r_min;
-    r_min *= NCM_LH_RATIO1D_SCALE_INCR;
+    bounds[i].lhr1d     = lhr1d;
+    bounds[i].constrained = NULL;
+    bounds[i].diff      = NULL;
+    bounds[i].root      = root;
+    bounds[i].scale     = (i == 0) ? r_min : r_max;
+    bounds[i].res       = GSL_NAN;
+    bounds[i].niter     = 0;
+    bounds[i].func_eval = 0;
+    bounds[i].grad_eval = 0;
   }
-  r_min = root (lhr1d, r_min, r);
 
-  r = 0.0;
-  while ((val = ncm_lh_ratio1d_f (r_max, lhr1d)) < 0.0)
+  if (lhr1d->nthreads > 1)
   {
-    ncm_lh_ratio1d_log_param_val (lhr1d, r_max, val);
-    r = r_max;
-    r_max *= NCM_LH_RATIO1D_SCALE_INCR;
+    NcmSerialize *ser = ncm_serialize_global ();
+
+    for (i = 0; i < 2; i++)
+    {
+      bounds[i].constrained = ncm_fit_dup (lhr1d->constrained, ser);
+      bounds[i].diff        = ncm_diff_new ();
+      ncm_serialize_reset (ser, TRUE);
+
+      ncm_fit_set_warm_start (bounds[i].constrained, ncm_fit_peek_warm_start (lhr1d->constrained));
+    }
+
+    ncm_serialize_free (ser);
+
+    lhr1d->mtype = NCM_FIT_RUN_MSGS_NONE;
+    ncm_func_eval_threaded_loop_full (&_ncm_lh_ratio1d_find_bound_mt, 0, 2, bounds);
+    lhr1d->mtype = mtype;
+  }
+  else
+  {
+    for (i = 0; i < 2; i++)
+    {
+      bounds[i].constrained = ncm_fit_ref (lhr1d->constrained);
+      bounds[i].diff        = ncm_diff_ref (lhr1d->fit->diff);
+
+      _ncm_lh_ratio1d_find_bound (&bounds[i]);
+    }
+  }
+
+  for (i = 0; i < 2; i++)
+  {
+    lhr1d->niter     += bounds[i].niter;
+    lhr1d->func_eval += bounds[i].func_eval;
+    lhr1d->grad_eval += bounds[i].grad_eval;
+
+    ncm_fit_clear (&bounds[i].constrained);
+    ncm_diff_clear (&bounds[i].diff);
   }
-  r_max = root (lhr1d, r, r_max);
+
+  r_min = bounds[0].res;
+  r_max = bounds[1].res;
 
   *lb = r_min;
   *ub = r_max;
@@ -642,3 +773,29 @@ ncm_lh_ratio1d_find_bounds (NcmLHRatio1d *lhr1d, gdouble clevel, NcmFitRunMsgs m
   ncm_lh_ratio1d_log_finish (lhr1d, r_min, r_max);
 }
 
+/**
+ * ncm_lh_ratio1d_set_nthreads:
+ * @lhr1d: a #NcmLHRatio1d
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used by ncm_lh_ratio1d_find_bounds(),
+ * values larger than one search both bounds concurrently.
+ *
+ */
+void
+ncm_lh_ratio1d_set_nthreads (NcmLHRatio1d *lhr1d, guint nthreads)
+{
+  lhr1d->nthreads = nthreads;
+}
+
+/**
+ * ncm_lh_ratio1d_get_nthreads:
+ * @lhr1d: a #NcmLHRatio1d
+ *
+ * Returns: the number of threads used by ncm_lh_ratio1d_find_bounds().
+ */
+guint
+ncm_lh_ratio1d_get_nthreads (NcmLHRatio1d *lhr1d)
+{
+  return lhr1d->nthreads;
+}
@@ -78,6 +78,7 @@ struct _NcmLHRatio1d
   guint niter;
   guint func_eval;
   guint grad_eval;
+  guint nthreads;
 };
 
 GType ncm_lh_ratio1d_get_type (void) G_GNUC_CONST;
@@ -89,6 +90,9 @@ void ncm_lh_ratio1d_clear (NcmLHRatio1d **lhr1d);
 void ncm_lh_ratio1d_set_pindex (NcmLHRatio1d *lhr1d, NcmMSetPIndex *pi);
 void ncm_lh_ratio1d_find_bounds (NcmLHRatio1d *lhr1d, gdouble clevel, NcmFitRunMsgs mtype, gdouble *lb, gdouble *ub);
 
+void ncm_lh_ratio1d_set_nthreads (NcmLHRatio1d *lhr1d, guint nthreads);
+guint ncm_lh_ratio1d_get_nthreads (NcmLHRatio1d *lhr1d);
+
 G_END_DECLS
 
 #endif /* _NCM_LH_RATIO1D_H_ */
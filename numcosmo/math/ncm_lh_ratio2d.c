@@ -43,6 +43,7 @@
 #include "math/ncm_cfg.h"
 #include "math/ncm_matrix.h"
 #include "math/ncm_util.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_cdf.h>
@@ -58,6 +59,7 @@ enum
   PROP_PI1,
   PROP_PI2,
   PROP_BORDER_PREC,
+  PROP_NTHREADS,
   PROP_SIZE,
 };
 
@@ -85,6 +87,7 @@ ncm_lh_ratio2d_init (NcmLHRatio2d *lhr2d)
   lhr2d->shift[1]    = 0.0;
   lhr2d->border_prec = 0.0;
   lhr2d->angular     = FALSE;
+  lhr2d->nthreads    = 0;
   lhr2d->diff        = ncm_diff_new ();
 }
 
@@ -114,6 +117,9 @@ ncm_lh_ratio2d_set_property (GObject *object, guint prop_id, const GValue *value
     case PROP_BORDER_PREC:
       lhr2d->border_prec = g_value_get_double (value);
       break;
+    case PROP_NTHREADS:
+      ncm_lh_ratio2d_set_nthreads (lhr2d, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -143,6 +149,9 @@ ncm_lh_ratio2d_get_property (GObject *object, guint prop_id, GValue *value, GPar
     case PROP_BORDER_PREC:
       g_value_set_double (value, lhr2d->border_prec);
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_lh_ratio2d_get_nthreads (lhr2d));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -258,6 +267,13 @@ ncm_lh_ratio2d_class_init (NcmLHRatio2dClass *klass)
                                                         "Border precision",
                                                         1.0e-16, 1.0e3, 1.0e-5,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -514,6 +530,13 @@ _ncm_lh_ratio2d_inside_interval (gdouble *p, const gdouble lb, const gdouble ub,
   return TRUE;
 }
 
+static void
+_ncm_lh_ratio2d_coords_to_param (NcmLHRatio2d *lhr2d, const gdouble alpha, const gdouble beta, gdouble *p1, gdouble *p2)
+{
+  *p1 = lhr2d->bf[0] + alpha * ncm_matrix_get (lhr2d->e_vec, 0, 0) + beta * ncm_matrix_get (lhr2d->e_vec, 0, 1);
+  *p2 = lhr2d->bf[1] + alpha * ncm_matrix_get (lhr2d->e_vec, 1, 0) + beta * ncm_matrix_get (lhr2d->e_vec, 1, 1);  
+}
+
 static void
 ncm_lh_ratio2d_tofparam (NcmLHRatio2d *lhr2d, gdouble *p1, gdouble *p2)
 {
@@ -522,8 +545,7 @@ ncm_lh_ratio2d_tofparam (NcmLHRatio2d *lhr2d, gdouble *p1, gdouble *p2)
   alpha = lhr2d->shift[0] + lhr2d->r * cos (lhr2d->theta);
   beta  = lhr2d->shift[1] + lhr2d->r * sin (lhr2d->theta);
 
-  *p1 = lhr2d->bf[0] + alpha * ncm_matrix_get (lhr2d->e_vec, 0, 0) + beta * ncm_matrix_get (lhr2d->e_vec, 0, 1);
-  *p2 = lhr2d->bf[1] + alpha * ncm_matrix_get (lhr2d->e_vec, 1, 0) + beta * ncm_matrix_get (lhr2d->e_vec, 1, 1);  
+  _ncm_lh_ratio2d_coords_to_param (lhr2d, alpha, beta, p1, p2);
 }
 
 static gdouble
@@ -882,6 +904,215 @@ _ncm_lh_ratio2d_set_angular_interval (NcmLHRatio2d *lhr2d, const gdouble da, gdo
   }
 }
 
+/*
+ * Parallel border search: the border is sampled along rays leaving the
+ * best fit in the eigenbasis of the covariance. The rays are split in
+ * contiguous angular sectors, one per thread, and each sector runs its
+ * own copy of the constrained fit. Inside a sector the profile fit of
+ * each ray starts from the border solution of the previous ray, its
+ * nearest converged neighbour, and the radial bracket starts from the
+ * previous radius. The bracket is expanded at most
+ * NCM_LH_RATIO2D_RAY_BRACKET_MAXITER times, a ray that never leaves the
+ * region (e.g., along an unbounded flat direction) is an error.
+ */
+
+#define NCM_LH_RATIO2D_RAY_BRACKET_FACTOR (1.25)
+#define NCM_LH_RATIO2D_RAY_BRACKET_MAXITER (100)
+
+typedef struct _NcmLHRatio2dRays
+{
+  NcmLHRatio2d *lhr2d;
+  NcmSerialize *ser;
+  gdouble theta0;
+  guint np;
+  gdouble *r;
+  GMutex update;
+} NcmLHRatio2dRays;
+
+typedef struct _NcmLHRatio2dRay
+{
+  NcmLHRatio2d *lhr2d;
+  NcmFit *constrained;
+  gdouble theta;
+  guint niter;
+  guint func_eval;
+  guint grad_eval;
+} NcmLHRatio2dRay;
+
+static gdouble
+_ncm_lh_ratio2d_ray_f (gdouble r, gpointer ptr)
+{
+  NcmLHRatio2dRay *ray = (NcmLHRatio2dRay *) ptr;
+  NcmLHRatio2d *lhr2d  = ray->lhr2d;
+  gdouble p[2];
+
+  _ncm_lh_ratio2d_coords_to_param (lhr2d, r * cos (ray->theta), r * sin (ray->theta), &p[0], &p[1]);
+
+  if (!_ncm_lh_ratio2d_inside_interval (&p[0], lhr2d->lb[0], lhr2d->ub[0], 1e-4) ||
+      !_ncm_lh_ratio2d_inside_interval (&p[1], lhr2d->lb[1], lhr2d->ub[1], 1e-4))
+    return 1.0e5;
+
+  ncm_mset_param_set_pi (ray->constrained->mset, lhr2d->pi, p, 2);
+  ncm_fit_run (ray->constrained, NCM_FIT_RUN_MSGS_NONE);
+
+  ray->niter     += ray->constrained->fstate->niter;
+  ray->func_eval += ray->constrained->fstate->func_eval;
+  ray->grad_eval += ray->constrained->fstate->grad_eval;
+
+  {
+    const gdouble m2lnL_const = ncm_fit_state_get_m2lnL_curval (ray->constrained->fstate);
+    const gdouble m2lnL = ncm_fit_state_get_m2lnL_curval (lhr2d->fit->fstate);
+    return m2lnL_const - (m2lnL + lhr2d->chisquare);
+  }
+}
+
+static gdouble
+_ncm_lh_ratio2d_ray_root (NcmLHRatio2dRay *ray, gdouble r0, gdouble r1)
+{
+  gint status;
+  gint iter = 0, max_iter = 1000000;
+  gsl_root_fsolver *s = gsl_root_fsolver_alloc (gsl_root_fsolver_brent);
+  gsl_function F;
+  gdouble r = r1;
+
+  F.function = &_ncm_lh_ratio2d_ray_f;
+  F.params   = ray;
+
+  gsl_root_fsolver_set (s, &F, r0, r1);
+
+  do
+  {
+    iter++;
+    status = gsl_root_fsolver_iterate (s);
+    if (status)
+    {
+      g_warning ("%s", gsl_strerror (status));
+      r = GSL_NAN;
+      break;
+    }
+
+    r  = gsl_root_fsolver_root (s);
+    r0 = gsl_root_fsolver_x_lower (s);
+    r1 = gsl_root_fsolver_x_upper (s);
+    status = gsl_root_test_interval (r0, r1, 0, ray->lhr2d->border_prec);
+  }
+  while (status == GSL_CONTINUE && iter < max_iter);
+
+  gsl_root_fsolver_free (s);
+
+  /* Leaves the constrained fit at the border, the starting point of the next ray. */
+  if (gsl_finite (r))
+    _ncm_lh_ratio2d_ray_f (r, ray);
+
+  return r;
+}
+
+static void
+_ncm_lh_ratio2d_rays_sector (glong i, glong f, gpointer data)
+{
+  NcmLHRatio2dRays *rays = (NcmLHRatio2dRays *) data;
+  NcmLHRatio2d *lhr2d    = rays->lhr2d;
+  NcmLHRatio2dRay ray    = {lhr2d, NULL, 0.0, 0, 0, 0};
+  gdouble r_prev         = sqrt (lhr2d->chisquare);
+  glong k;
+
+  g_mutex_lock (&rays->update);
+  ray.constrained = ncm_fit_dup (lhr2d->constrained, rays->ser);
+  ncm_serialize_reset (rays->ser, TRUE);
+  ncm_fit_set_warm_start (ray.constrained, ncm_fit_peek_warm_start (lhr2d->constrained));
+  ncm_mset_param_set_mset (ray.constrained->mset, lhr2d->fit->mset);
+  g_mutex_unlock (&rays->update);
+
+  for (k = i; k < f; k++)
+  {
+    gdouble r0 = 0.0;
+    gdouble r1 = r_prev;
+
+    ray.theta = rays->theta0 + 2.0 * M_PI * k / rays->np;
+
+    if (_ncm_lh_ratio2d_ray_f (r1, &ray) < 0.0)
+    {
+      guint n = 0;
+      do
+      {
+        if (n++ == NCM_LH_RATIO2D_RAY_BRACKET_MAXITER)
+          g_error ("_ncm_lh_ratio2d_rays_sector: cannot bracket the border along the ray at %.2f degrees, "
+                   "the profile likelihood is still inside the region at r = %g.", 
+                   ncm_c_radian_to_degree (ncm_c_radian_0_2pi (ray.theta)), r1);
+        r0  = r1;
+        r1 *= NCM_LH_RATIO2D_RAY_BRACKET_FACTOR;
+      } while (_ncm_lh_ratio2d_ray_f (r1, &ray) < 0.0);
+    }
+    else
+    {
+      r0 = r1 / NCM_LH_RATIO2D_RAY_BRACKET_FACTOR;
+      while ((r0 > lhr2d->border_prec) && (_ncm_lh_ratio2d_ray_f (r0, &ray) > 0.0))
+      {
+        r1  = r0;
+        r0 /= NCM_LH_RATIO2D_RAY_BRACKET_FACTOR;
+      }
+      if (r0 <= lhr2d->border_prec)
+        r0 = 0.0;
+    }
+
+    rays->r[k] = _ncm_lh_ratio2d_ray_root (&ray, r0, r1);
+
+    if (gsl_finite (rays->r[k]))
+      r_prev = rays->r[k];
+  }
+
+  g_mutex_lock (&rays->update);
+  lhr2d->niter     += ray.niter;
+  lhr2d->func_eval += ray.func_eval;
+  lhr2d->grad_eval += ray.grad_eval;
+  g_mutex_unlock (&rays->update);
+
+  ncm_fit_free (ray.constrained);
+}
+
+static NcmLHRatio2dRegion *
+_ncm_lh_ratio2d_conf_region_rays (NcmLHRatio2d *lhr2d, gdouble clevel, guint np)
+{
+  NcmLHRatio2dRays rays;
+  NcmLHRatio2dRegion *rg = g_slice_new0 (NcmLHRatio2dRegion);
+  guint k;
+
+  rays.lhr2d  = lhr2d;
+  rays.ser    = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  rays.theta0 = gsl_rng_uniform (lhr2d->rng->r) * 2.0 * M_PI;
+  rays.np     = np;
+  rays.r      = g_new (gdouble, np);
+  g_mutex_init (&rays.update);
+
+  ncm_func_eval_threaded_loop_nw (&_ncm_lh_ratio2d_rays_sector, 0, np, &rays, GSL_MIN (lhr2d->nthreads, np - 1));
+
+  rg->np     = np + 1;
+  rg->p1     = ncm_vector_new (rg->np);
+  rg->p2     = ncm_vector_new (rg->np);
+  rg->clevel = clevel;
+
+  for (k = 0; k < rg->np; k++)
+  {
+    const guint l        = k % np;
+    const gdouble theta  = rays.theta0 + 2.0 * M_PI * l / np;
+    gdouble p1, p2;
+
+    _ncm_lh_ratio2d_coords_to_param (lhr2d, rays.r[l] * cos (theta), rays.r[l] * sin (theta), &p1, &p2);
+
+    ncm_vector_set (rg->p1, k, p1);
+    ncm_vector_set (rg->p2, k, p2);
+
+    if (k < np)
+      ncm_lh_ratio2d_log_border_found (lhr2d, rays.r[l]);
+  }
+
+  g_mutex_clear (&rays.update);
+  g_free (rays.r);
+  ncm_serialize_free (rays.ser);
+
+  return rg;
+}
+
 /**
  * ncm_lh_ratio2d_conf_region:
  * @lhr2d: a @NcmFit
@@ -889,7 +1120,16 @@ _ncm_lh_ratio2d_set_angular_interval (NcmLHRatio2d *lhr2d, const gdouble da, gdo
  * @expected_np: Expected number of points, if lesser than 1 it uses the default value of 100.
  * @mtype: FIXME
  *
- * FIXME
+ * Computes the border of the profile likelihood confidence region at
+ * @clevel. The profile fits are warm-started with the best fit
+ * covariance, see ncm_fit_set_warm_start_from(), and each one starts
+ * from the previous border point.
+ *
+ * When #NcmLHRatio2d:nthreads is larger than one, the border is sampled
+ * instead along @expected_np rays leaving the best fit at evenly spaced
+ * angles. The rays are split in contiguous angular sectors computed in
+ * parallel, each with its own copy of the constrained fit, and the
+ * radial roots are always bracketed.
  *
  * Returns: (transfer full): FIXME
  */
@@ -911,6 +1151,15 @@ ncm_lh_ratio2d_conf_region (NcmLHRatio2d *lhr2d, gdouble clevel, gdouble expecte
   ncm_lh_ratio2d_log_start (lhr2d, clevel);
 
   lhr2d->chisquare = gsl_cdf_chisq_Qinv (1.0 - clevel, 2);
+
+  ncm_fit_set_warm_start_from (lhr2d->constrained, lhr2d->fit);
+
+  if (lhr2d->nthreads > 1)
+  {
+    g_timer_destroy (iter_timer);
+    return _ncm_lh_ratio2d_conf_region_rays (lhr2d, clevel, GSL_MAX (expected_np, 3.0));
+  }
+
   lhr2d->shift[0] = 0.0;
   lhr2d->shift[1] = 0.0;
   lhr2d->theta = gsl_rng_uniform (lhr2d->rng->r) * 2.0 * M_PI;
@@ -1145,3 +1394,29 @@ ncm_lh_ratio2d_region_print (NcmLHRatio2dRegion *rg, FILE *out)
   }
 }
 
+/**
+ * ncm_lh_ratio2d_set_nthreads:
+ * @lhr2d: a #NcmLHRatio2d
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used by ncm_lh_ratio2d_conf_region(),
+ * values larger than one select the parallel sector search.
+ *
+ */
+void
+ncm_lh_ratio2d_set_nthreads (NcmLHRatio2d *lhr2d, guint nthreads)
+{
+  lhr2d->nthreads = nthreads;
+}
+
+/**
+ * ncm_lh_ratio2d_get_nthreads:
+ * @lhr2d: a #NcmLHRatio2d
+ *
+ * Returns: the number of threads used by ncm_lh_ratio2d_conf_region().
+ */
+guint
+ncm_lh_ratio2d_get_nthreads (NcmLHRatio2d *lhr2d)
+{
+  return lhr2d->nthreads;
+}
@@ -85,6 +85,7 @@ struct _NcmLHRatio2d
   guint niter;
   guint func_eval;
   guint grad_eval;
+  guint nthreads;
   NcmDiff *diff;
 };
 
@@ -133,6 +134,8 @@ void ncm_lh_ratio2d_free (NcmLHRatio2d *lhr2d);
 void ncm_lh_ratio2d_clear (NcmLHRatio2d **lhr2d);
 
 void ncm_lh_ratio2d_set_pindex (NcmLHRatio2d *lhr2d, NcmMSetPIndex *pi1, NcmMSetPIndex *pi2);
+void ncm_lh_ratio2d_set_nthreads (NcmLHRatio2d *lhr2d, guint nthreads);
+guint ncm_lh_ratio2d_get_nthreads (NcmLHRatio2d *lhr2d);
 
 NcmLHRatio2dRegion *ncm_lh_ratio2d_conf_region (NcmLHRatio2d *lhr2d, gdouble clevel, gdouble expected_np, NcmFitRunMsgs mtype);
 NcmLHRatio2dRegion *ncm_lh_ratio2d_fisher_border (NcmLHRatio2d *lhr2d, gdouble clevel, gdouble expected_np, NcmFitRunMsgs mtype);
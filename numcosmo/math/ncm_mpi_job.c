@@ -60,12 +60,34 @@ struct _NcmMPIJobPrivate
 	NcmMemoryPool *return_buf_pool;
 	GHashTable *input_buf_table;
 	GHashTable *return_buf_table;
+	guint max_inflight;
+	guint last_job_id;
+	GQueue *pending;
+	GPtrArray *running;
+	GArray *slave_load;
+	GQueue *done;
 };
 
+typedef struct _NcmMPIJobTask
+{
+	guint job_id;
+	gint slave_id;
+	gint cmd;
+	gpointer input;
+	gpointer ret;
+	gpointer input_buf;
+	gpointer return_buf;
+#ifdef HAVE_MPI
+	MPI_Request send_req[2];
+	MPI_Request recv_req;
+#endif /* HAVE_MPI */
+} NcmMPIJobTask;
+
 enum
 {
 	PROP_0,
 	PROP_PLACEHOLDER,
+	PROP_MAX_INFLIGHT,
 };
 
 extern NcmMPIJobCtrl _mpi_ctrl;
@@ -93,6 +115,12 @@ ncm_mpi_job_init (NcmMPIJob *mpi_job)
 	self->return_buf_pool  = ncm_memory_pool_new (_ncm_mpi_job_create_return_buffer, mpi_job, _ncm_mpi_job_destroy_buffer);
 	self->input_buf_table  = g_hash_table_new (g_direct_hash, g_direct_equal);
 	self->return_buf_table = g_hash_table_new (g_direct_hash, g_direct_equal);
+	self->max_inflight     = 0;
+	self->last_job_id      = 0;
+	self->pending          = g_queue_new ();
+	self->running          = g_ptr_array_new ();
+	self->slave_load       = g_array_new (FALSE, TRUE, sizeof (guint));
+	self->done             = g_queue_new ();
 }
 
 static gpointer 
@@ -131,6 +159,9 @@ _ncm_mpi_job_set_property (GObject *object, guint prop_id, const GValue *value,
 		case PROP_PLACEHOLDER:
 			self->placeholder = g_value_get_uint (value);
 			break;
+		case PROP_MAX_INFLIGHT:
+			ncm_mpi_job_set_max_inflight (mpi_job, g_value_get_uint (value));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -149,6 +180,9 @@ _ncm_mpi_job_get_property (GObject *object, guint prop_id, GValue *value, GParam
 		case PROP_PLACEHOLDER:
 			g_value_set_uint (value, self->placeholder);
 			break;
+		case PROP_MAX_INFLIGHT:
+			g_value_set_uint (value, ncm_mpi_job_get_max_inflight (mpi_job));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -188,10 +222,22 @@ _ncm_mpi_job_finalize (GObject *object)
 	NcmMPIJob *mpi_job = NCM_MPI_JOB (object);
 	NcmMPIJobPrivate * const self = mpi_job->priv;
 
+	/* 
+	 * The subclass and the buffer tables are already disposed at this 
+	 * point, the submitted jobs cannot be completed anymore.
+	 */
+	g_assert (g_queue_is_empty (self->pending));
+	g_assert_cmpuint (self->running->len, ==, 0);
+
 	ncm_mpi_job_free_all_slaves (mpi_job);
 
 	ncm_memory_pool_free (self->input_buf_pool, TRUE);
 	ncm_memory_pool_free (self->return_buf_pool, TRUE);
+
+	g_queue_free (self->pending);
+	g_queue_free (self->done);
+	g_ptr_array_unref (self->running);
+	g_array_unref (self->slave_load);
 		
 	/* Chain up : end */
 	G_OBJECT_CLASS (ncm_mpi_job_parent_class)->finalize (object);
@@ -238,6 +284,21 @@ ncm_mpi_job_class_init (NcmMPIJobClass *klass)
 	                                                    "placeholder",
 	                                                    0, G_MAXUINT, 0,
 	                                                    G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+	/**
+	 * NcmMPIJob:max-inflight:
+	 *
+	 * Maximum number of jobs sent to each slave before any of them returns.
+	 * Values larger than one keep the slaves busy while the master unpacks
+	 * the previous results and packs the next inputs.
+	 * 
+	 */
+	g_object_class_install_property (object_class,
+	                                 PROP_MAX_INFLIGHT,
+	                                 g_param_spec_uint ("max-inflight",
+	                                                    NULL,
+	                                                    "Maximum number of jobs in flight per slave",
+	                                                    1, G_MAXUINT, 1,
+	                                                    G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
 	klass->work_init             = NULL;
 	klass->work_clear            = NULL;
@@ -661,171 +722,364 @@ ncm_mpi_job_init_all_slaves (NcmMPIJob *mpi_job, NcmSerialize *ser)
 
 		self->owned_slaves       = _mpi_ctrl.nslaves;
 		_mpi_ctrl.working_slaves = _mpi_ctrl.nslaves;
+
+		g_array_set_size (self->slave_load, 0);
+		g_array_set_size (self->slave_load, _mpi_ctrl.nslaves);
 	}
 #else
 	g_error ("ncm_mpi_job_init_all_slaves: MPI unsupported.");
 #endif /* HAVE_MPI */
 }
 
+#ifdef HAVE_MPI
+
+static gint
+_ncm_mpi_job_free_slave (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	gint slave_id = -1;
+	guint min_load = self->max_inflight;
+	gint i;
+
+	for (i = 0; i < self->slave_load->len; i++)
+	{
+		const guint load_i = g_array_index (self->slave_load, guint, i);
+		if (load_i < min_load)
+		{
+			min_load = load_i;
+			slave_id = i + 1;
+		}
+	}
+
+	return slave_id;
+}
+
+static void
+_ncm_mpi_job_task_dispatch (NcmMPIJob *mpi_job, NcmMPIJobTask *task, gint slave_id)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	task->slave_id   = slave_id;
+	task->cmd        = NCM_MPI_CTRL_SLAVE_WORK;
+	task->input_buf  = ncm_mpi_job_pack_input (mpi_job, task->input);
+	task->return_buf = ncm_mpi_job_get_return_buffer (mpi_job, task->ret);
+
+	NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Dispatching job %u to slave %d!\n", _mpi_ctrl.size, _mpi_ctrl.rank, task->job_id, slave_id);
+
+	MPI_Isend (&task->cmd, 1, MPI_INT, slave_id, NCM_MPI_CTRL_TAG_CMD, MPI_COMM_WORLD, &task->send_req[0]);
+	MPI_Isend (task->input_buf, self->input_len, self->input_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_INPUT, MPI_COMM_WORLD, &task->send_req[1]);
+	MPI_Irecv (task->return_buf, self->return_len, self->return_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_RETURN, MPI_COMM_WORLD, &task->recv_req);
+
+	g_array_index (self->slave_load, guint, slave_id - 1)++;
+	g_ptr_array_add (self->running, task);
+}
+
+static void
+_ncm_mpi_job_dispatch_pending (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	while (!g_queue_is_empty (self->pending))
+	{
+		const gint slave_id = _ncm_mpi_job_free_slave (mpi_job);
+
+		if (slave_id < 0)
+			break;
+		else
+		{
+			NcmMPIJobTask *task = g_queue_pop_head (self->pending);
+			_ncm_mpi_job_task_dispatch (mpi_job, task, slave_id);
+		}
+	}
+}
+
+static void
+_ncm_mpi_job_task_finish (NcmMPIJob *mpi_job, guint i)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	NcmMPIJobTask *task = g_ptr_array_index (self->running, i);
+
+	MPI_Waitall (2, task->send_req, MPI_STATUSES_IGNORE);
+
+	ncm_mpi_job_destroy_input_buffer (mpi_job, task->input, task->input_buf);
+	ncm_mpi_job_unpack_return (mpi_job, task->return_buf, task->ret);
+	ncm_mpi_job_destroy_return_buffer (mpi_job, task->ret, task->return_buf);
+
+	NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Job %u returned from slave %d!\n", _mpi_ctrl.size, _mpi_ctrl.rank, task->job_id, task->slave_id);
+
+	g_array_index (self->slave_load, guint, task->slave_id - 1)--;
+	g_queue_push_tail (self->done, GUINT_TO_POINTER (task->job_id));
+	g_ptr_array_remove_index_fast (self->running, i);
+
+	g_slice_free (NcmMPIJobTask, task);
+}
+
+static gboolean
+_ncm_mpi_job_progress (NcmMPIJob *mpi_job, gboolean block)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	const guint nrunning = self->running->len;
+
+	if (nrunning == 0)
+		return FALSE;
+	else
+	{
+		MPI_Request *reqs = g_new (MPI_Request, nrunning);
+		gint index        = MPI_UNDEFINED;
+		gint flag         = 0;
+		gint i;
+
+		for (i = 0; i < nrunning; i++)
+		{
+			NcmMPIJobTask *task = g_ptr_array_index (self->running, i);
+			reqs[i] = task->recv_req;
+		}
+
+		if (block)
+		{
+			MPI_Waitany (nrunning, reqs, &index, MPI_STATUS_IGNORE);
+			flag = 1;
+		}
+		else
+			MPI_Testany (nrunning, reqs, &index, &flag, MPI_STATUS_IGNORE);
+
+		g_free (reqs);
+
+		if (!flag || (index == MPI_UNDEFINED))
+			return FALSE;
+
+		_ncm_mpi_job_task_finish (mpi_job, index);
+		_ncm_mpi_job_dispatch_pending (mpi_job);
+
+		return TRUE;
+	}
+}
+
+#endif /* HAVE_MPI */
+
+static void
+_ncm_mpi_job_run_local (NcmMPIJob *mpi_job, NcmMPIJobTask *task)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	ncm_mpi_job_run (mpi_job, task->input, task->ret);
+	g_queue_push_tail (self->done, GUINT_TO_POINTER (task->job_id));
+
+	g_slice_free (NcmMPIJobTask, task);
+}
+
 /**
- * ncm_mpi_job_run_array:
+ * ncm_mpi_job_set_max_inflight:
  * @mpi_job: a #NcmMPIJob
- * @input_array: (array) (element-type GObject): an array of input pointers
- * @ret_array: (array) (element-type GObject): an array of (allocated) return pointers
- * 
- * Send work to all slaves in a round-robin fashion. Both arrays @input_array and @ret_array
- * must have the same length and should be filled with the appropriated pointers.
+ * @max_inflight: maximum number of jobs per slave
+ *
+ * Sets the maximum number of jobs that can be sent to each slave
+ * without waiting for their returns, see #NcmMPIJob:max-inflight.
  * 
  */
 void
-ncm_mpi_job_run_array (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array)
+ncm_mpi_job_set_max_inflight (NcmMPIJob *mpi_job, guint max_inflight)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	g_assert_cmpuint (max_inflight, >, 0);
+
+	self->max_inflight = max_inflight;
+}
+
+/**
+ * ncm_mpi_job_get_max_inflight:
+ * @mpi_job: a #NcmMPIJob
+ *
+ * Returns: the maximum number of jobs in flight per slave.
+ */
+guint
+ncm_mpi_job_get_max_inflight (NcmMPIJob *mpi_job)
 {
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	return self->max_inflight;
+}
+
+/**
+ * ncm_mpi_job_submit:
+ * @mpi_job: a #NcmMPIJob
+ * @input: the input pointer
+ * @ret: the (allocated) return pointer
+ * 
+ * Submits a job without waiting for its completion. The job is sent
+ * to the least loaded slave with less than #NcmMPIJob:max-inflight
+ * jobs, or queued until one of them becomes available. Both @input
+ * and @ret must remain valid until the job is reported as complete
+ * by ncm_mpi_job_poll(), ncm_mpi_job_wait_any() or 
+ * ncm_mpi_job_wait_all(). All submitted jobs must be completed 
+ * before the last reference to @mpi_job is released.
+ * 
+ * When there are no slaves available the job is run immediately by
+ * the calling process.
+ * 
+ * Returns: the job identifier.
+ */
+guint
+ncm_mpi_job_submit (NcmMPIJob *mpi_job, gpointer input, gpointer ret)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	NcmMPIJobTask *task = g_slice_new0 (NcmMPIJobTask);
+
+	task->job_id = ++self->last_job_id;
+	task->input  = input;
+	task->ret    = ret;
+
 #ifdef HAVE_MPI
 	g_assert_cmpint (_mpi_ctrl.rank, ==, NCM_MPI_CTRL_MASTER_ID);
-	enum buf_type { input_type, ret_type, msg_type, };
-	struct buf_desc { gpointer obj; gpointer buf; enum buf_type t; };		
-	if (_mpi_ctrl.size > 1)
+	if (self->owned_slaves > 0)
 	{
-		NcmMPIJobPrivate * const self = mpi_job->priv;
-		const guint njobs      = input_array->len;
-		const guint njobs_pa   = njobs - njobs / _mpi_ctrl.size;
-		const guint prealloc   = (njobs < 100) ? njobs : 100;
-		gint check_block       = 10;
-		GArray *req_array      = g_array_sized_new (FALSE, TRUE, sizeof (MPI_Request), prealloc);
-		GPtrArray *cmd_array   = g_ptr_array_new_with_free_func (g_free);
-		GArray *buf_desc_a     = g_array_new (FALSE, TRUE, sizeof (struct buf_desc));
-		gint i;
+		g_queue_push_tail (self->pending, task);
+		_ncm_mpi_job_dispatch_pending (mpi_job);
+	}
+	else
+#endif /* HAVE_MPI */
+	{
+		_ncm_mpi_job_run_local (mpi_job, task);
+	}
 
-		g_assert_cmpuint (input_array->len, ==, ret_array->len);
+	return task->job_id;
+}
 
-		for (i = 0; i < njobs; i++)
-		{
-			gpointer input      = g_ptr_array_index (input_array, i);
-			gpointer ret        = g_ptr_array_index (ret_array, i);
-			if (i < njobs_pa)
-			{
-				const gint slave_id = (i % _mpi_ctrl.nslaves) + 1;
-				gint *cmd           = g_new (gint, 1);
-				MPI_Request request;
-
-				*cmd = NCM_MPI_CTRL_SLAVE_WORK;
-				g_ptr_array_add (cmd_array, cmd);
-
-				{
-					struct buf_desc bd = {NULL, NULL, msg_type};
-					MPI_Isend (cmd, 1, MPI_INT, slave_id, NCM_MPI_CTRL_TAG_CMD, MPI_COMM_WORLD, &request);
-					g_array_append_val (req_array, request);
-					g_array_append_val (buf_desc_a, bd);
-				}
-
-				{
-					struct buf_desc bd = {input, ncm_mpi_job_pack_input (mpi_job, input), input_type};
-					MPI_Isend (bd.buf, self->input_len, self->input_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_INPUT, MPI_COMM_WORLD, &request);
-					g_array_append_val (req_array, request);
-					g_array_append_val (buf_desc_a, bd);
-				}
-
-				{
-					struct buf_desc bd = {ret, ncm_mpi_job_get_return_buffer (mpi_job, ret), ret_type};
-					MPI_Irecv (bd.buf, self->return_len, self->input_dtype, slave_id, NCM_MPI_CTRL_TAG_WORK_RETURN, MPI_COMM_WORLD, &request);
-					g_array_append_val (req_array, request);
-					g_array_append_val (buf_desc_a, bd);
-				}
-			}
-			else
-			{
-				ncm_mpi_job_run (mpi_job, input, ret);
-				check_block = 1;
-			}
-
-			if ((i > 0) && ((i % check_block) == 0))
-			{
-				gint j;
-				NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Testing %d sends:\n", _mpi_ctrl.size, _mpi_ctrl.rank, req_array->len);
-				for (j = req_array->len - 1; j >= 0; j--)
-				{
-					MPI_Status status;
-					gint done = 0;
-
-					MPI_Test (&g_array_index (req_array, MPI_Request, j), &done, &status);
-					NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Send %d is %s!\n", _mpi_ctrl.size, _mpi_ctrl.rank, j, done ? "done" : "not done");
-					
-					if (done)
-					{
-						struct buf_desc bd = g_array_index (buf_desc_a, struct buf_desc, j);
-						
-						NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Send %d removing %d!\n", _mpi_ctrl.size, _mpi_ctrl.rank, j, bd.t);
-
-						g_array_remove_index_fast (req_array,  j);
-						g_array_remove_index_fast (buf_desc_a, j);
-						
-						switch (bd.t)
-						{
-							case input_type:
-								ncm_mpi_job_destroy_input_buffer (mpi_job, bd.obj, bd.buf);
-								break;
-							case ret_type:
-								ncm_mpi_job_unpack_return (mpi_job, bd.buf, bd.obj);
-								ncm_mpi_job_destroy_return_buffer (mpi_job, bd.obj, bd.buf);
-								break;
-							case msg_type:
-								break;
-							default:
-								g_assert_not_reached ();
-								break;
-						}
-						NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Send %d removing %d, finished!\n", _mpi_ctrl.size, _mpi_ctrl.rank, j, bd.t);
-					}
-				}
-			}
-		}
+/**
+ * ncm_mpi_job_poll:
+ * @mpi_job: a #NcmMPIJob
+ * @job_id: (out): the identifier of the completed job
+ * 
+ * Checks, without blocking, whether any of the submitted jobs has
+ * completed. Completed returns are unpacked and the freed slaves
+ * receive the next queued jobs. This function can be called by the
+ * master between its own computations to overlap them with the
+ * remote evaluations.
+ * 
+ * Returns: TRUE if a job has completed and its identifier was written in @job_id.
+ */
+gboolean
+ncm_mpi_job_poll (NcmMPIJob *mpi_job, guint *job_id)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
 
-		NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Waiting for the remainers return (%u)!\n", _mpi_ctrl.size, _mpi_ctrl.rank, req_array->len);
-		MPI_Waitall (req_array->len, (MPI_Request *) req_array->data, MPI_STATUSES_IGNORE);
+#ifdef HAVE_MPI
+	while (_ncm_mpi_job_progress (mpi_job, FALSE));
+#endif /* HAVE_MPI */
 
-		for (i = 0; i < buf_desc_a->len; i++)
-		{
-			struct buf_desc bd = g_array_index (buf_desc_a, struct buf_desc, i);
-			switch (bd.t)
-			{
-				case input_type:
-					ncm_mpi_job_destroy_input_buffer (mpi_job, bd.obj, bd.buf);
-					break;
-				case ret_type:
-					ncm_mpi_job_unpack_return (mpi_job, bd.buf, bd.obj);
-					ncm_mpi_job_destroy_return_buffer (mpi_job, bd.obj, bd.buf);
-					break;
-				case msg_type:
-					break;
-				default:
-					g_assert_not_reached ();
-			}
-		}
+	if (g_queue_is_empty (self->done))
+		return FALSE;
 
-		g_array_unref (req_array);
-		g_array_unref (buf_desc_a);
-		g_ptr_array_unref (cmd_array);
+	job_id[0] = GPOINTER_TO_UINT (g_queue_pop_head (self->done));
 
-		return;
-	}
+	return TRUE;
+}
+
+/**
+ * ncm_mpi_job_wait_any:
+ * @mpi_job: a #NcmMPIJob
+ * 
+ * Waits for the completion of any submitted job. If all slaves are 
+ * busy and there are queued jobs, the master runs one of them itself
+ * instead of idling.
+ * 
+ * Returns: the identifier of the completed job.
+ */
+guint
+ncm_mpi_job_wait_any (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	guint job_id = 0;
+
+	if (ncm_mpi_job_poll (mpi_job, &job_id))
+		return job_id;
+
+	if (!g_queue_is_empty (self->pending))
+		_ncm_mpi_job_run_local (mpi_job, g_queue_pop_tail (self->pending));
+#ifdef HAVE_MPI
+	else if (self->running->len > 0)
+		_ncm_mpi_job_progress (mpi_job, TRUE);
+#endif /* HAVE_MPI */
 	else
+		g_error ("ncm_mpi_job_wait_any: no jobs submitted.");
+
+	return GPOINTER_TO_UINT (g_queue_pop_head (self->done));
+}
+
+/**
+ * ncm_mpi_job_wait_all:
+ * @mpi_job: a #NcmMPIJob
+ * 
+ * Waits for the completion of all submitted jobs and discards
+ * their identifiers.
+ * 
+ */
+void
+ncm_mpi_job_wait_all (NcmMPIJob *mpi_job)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+
+	while (!g_queue_is_empty (self->pending))
 	{
-		const guint njobs = input_array->len;
-		gint i;
+#ifdef HAVE_MPI
+		if (_ncm_mpi_job_progress (mpi_job, FALSE))
+			continue;
+#endif /* HAVE_MPI */
+		_ncm_mpi_job_run_local (mpi_job, g_queue_pop_tail (self->pending));
+	}
 
-		for (i = 0; i < njobs; i++)
-		{
-			gpointer input = g_ptr_array_index (input_array, i);
-			gpointer ret   = g_ptr_array_index (ret_array, i);
-			ncm_mpi_job_run (mpi_job, input, ret);
-		}
+#ifdef HAVE_MPI
+	while (_ncm_mpi_job_progress (mpi_job, TRUE));
+#endif /* HAVE_MPI */
 
-		return;
+	g_queue_clear (self->done);
+}
+
+/**
+ * ncm_mpi_job_run_array:
+ * @mpi_job: a #NcmMPIJob
+ * @input_array: (array) (element-type GObject): an array of input pointers
+ * @ret_array: (array) (element-type GObject): an array of (allocated) return pointers
+ * 
+ * Send work to all slaves. Both arrays @input_array and @ret_array
+ * must have the same length and should be filled with the appropriated pointers.
+ * 
+ * The jobs are distributed dynamically, each slave receives up to 
+ * #NcmMPIJob:max-inflight jobs and a new one as soon as any of them 
+ * returns. While all slaves are busy the master runs the jobs 
+ * at the end of the queue. Without slaves, or when compiled without
+ * MPI, the jobs are run in order by the calling process. This function
+ * must not be called while there are jobs submitted by
+ * ncm_mpi_job_submit() not yet completed.
+ * 
+ */
+void
+ncm_mpi_job_run_array (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array)
+{
+	NcmMPIJobPrivate * const self = mpi_job->priv;
+	const guint njobs = input_array->len;
+	gint i;
+
+#ifdef HAVE_MPI
+	g_assert_cmpint (_mpi_ctrl.rank, ==, NCM_MPI_CTRL_MASTER_ID);
+#endif /* HAVE_MPI */
+	g_assert_cmpuint (input_array->len, ==, ret_array->len);
+	g_assert_cmpuint (self->running->len, ==, 0);
+	g_assert (g_queue_is_empty (self->pending));
+
+	for (i = 0; i < njobs; i++)
+	{
+		gpointer input = g_ptr_array_index (input_array, i);
+		gpointer ret   = g_ptr_array_index (ret_array, i);
+
+		ncm_mpi_job_submit (mpi_job, input, ret);
 	}
-#else
-	g_error ("ncm_mpi_job_run_array: MPI unsupported.");
+
+	NCM_MPI_JOB_DEBUG_PRINT ("#[%3d %3d] Waiting for the remainers return (%u, %u)!\n", _mpi_ctrl.size, _mpi_ctrl.rank, self->running->len, g_queue_get_length (self->pending));
+	ncm_mpi_job_wait_all (mpi_job);
+
 	return;
-#endif /* HAVE_MPI */
 }
 
 /**
@@ -852,6 +1106,7 @@ ncm_mpi_job_free_all_slaves (NcmMPIJob *mpi_job)
 		gint i;
 
 		g_assert_cmpuint (self->owned_slaves, ==, _mpi_ctrl.nslaves);
+		g_assert_cmpuint (self->running->len, ==, 0);
 
 		for (i = 0; i < _mpi_ctrl.nslaves; i++)
 		{
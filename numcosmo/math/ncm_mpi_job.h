@@ -173,9 +173,17 @@ void ncm_mpi_job_unpack_return (NcmMPIJob *mpi_job, gpointer buf, gpointer ret);
 
 void ncm_mpi_job_run (NcmMPIJob *mpi_job, gpointer input, gpointer ret);
 
+void ncm_mpi_job_set_max_inflight (NcmMPIJob *mpi_job, guint max_inflight);
+guint ncm_mpi_job_get_max_inflight (NcmMPIJob *mpi_job);
+
 void ncm_mpi_job_init_all_slaves (NcmMPIJob *mpi_job, NcmSerialize *ser);
 void ncm_mpi_job_run_array (NcmMPIJob *mpi_job, GPtrArray *input_array, GPtrArray *ret_array);
 
+guint ncm_mpi_job_submit (NcmMPIJob *mpi_job, gpointer input, gpointer ret);
+gboolean ncm_mpi_job_poll (NcmMPIJob *mpi_job, guint *job_id);
+guint ncm_mpi_job_wait_any (NcmMPIJob *mpi_job);
+void ncm_mpi_job_wait_all (NcmMPIJob *mpi_job);
+
 void ncm_mpi_job_free_all_slaves (NcmMPIJob *mpi_job);
 
 /*#define NCM_MPI_DEBUG 1*/
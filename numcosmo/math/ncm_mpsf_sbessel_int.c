@@ -43,6 +43,8 @@
 #include "math/binsplit.h"
 #include "math/ncm_spline_gsl.h"
 #include "math/ncm_mpsf_trig_int.h"
+#include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_math.h>
@@ -423,6 +425,37 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_new_from_sections (gulong prec, NcmGridS
   return ncm_mpsf_sbessel_jl_xj_integrate_spline_new (prec, x, k);
 }
 
+/**
+ * ncm_mpsf_sbessel_jl_xj_integrate_spline_free: (skip)
+ * @int_jlspline: a #NcmMpsfSBesselIntSpline
+ *
+ * Frees @int_jlspline, its grids and all its rules.
+ *
+*/
+void
+ncm_mpsf_sbessel_jl_xj_integrate_spline_free (NcmMpsfSBesselIntSpline *int_jlspline)
+{
+  const gulong map_size = int_jlspline->x->nnodes * int_jlspline->k->nnodes;
+  guint i;
+
+  for (i = 0; i < int_jlspline->rules_count; i++)
+    ncm_mpsf_sbessel_jl_xj_integral_recur_free (int_jlspline->xnjlrec[i]);
+
+  g_slice_free1 (map_size * sizeof (NcmMpsfSBesselIntegRecur *), int_jlspline->xnjlrec);
+  g_slice_free1 (map_size * sizeof (guint), int_jlspline->map_ij2r);
+  g_hash_table_unref (int_jlspline->int_hash);
+
+  mpfr_clears (
+    int_jlspline->rules[0], int_jlspline->rules[1], int_jlspline->rules[2], int_jlspline->rules[3],
+    int_jlspline->crules[0], int_jlspline->crules[1], int_jlspline->crules[2], int_jlspline->crules[3],
+    NULL);
+
+  ncm_grid_free (int_jlspline->x, int_jlspline->x->data != NULL);
+  ncm_grid_free (int_jlspline->k, int_jlspline->k->data != NULL);
+
+  g_slice_free (NcmMpsfSBesselIntSpline, int_jlspline);
+}
+
 /**
  * ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new: (skip)
  * @prec: FIXME
@@ -444,11 +477,14 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new (gulong prec, glong l, NcmGri
   gchar *rname = g_strconcat (name_x, name_k, NULL);
   gchar *rname_hash = g_compute_checksum_for_string (G_CHECKSUM_MD5, rname, strlen (rname));
   gchar *filename = g_strdup_printf ("xnjl_rule_%ld_%lu_%s.dat", l, prec, rname_hash);
-  printf ("# looking for cache (%s) name (%s)\n", filename, rname);
+  g_debug ("ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new: looking for cache `%s' name `%s'.", filename, rname);
 
   if (ncm_cfg_exists (filename))
     int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_load (filename);
   else
+    int_jlspline = NULL;
+
+  if (int_jlspline == NULL)
   {
     int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_new_from_sections (prec, x_secs,  k_secs);
     ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare (int_jlspline, l, rnd);
@@ -490,6 +526,27 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare_new (NcmMpsfSBesselIntSpline *in
   g_assert_not_reached ();
 }
 
+typedef struct _NcmMpsfSBesselIntSplinePrepare
+{
+  NcmMpsfSBesselIntSpline *int_jlspline;
+  GPtrArray *qs;
+  glong l;
+  mp_rnd_t rnd;
+} NcmMpsfSBesselIntSplinePrepare;
+
+static void
+_ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare_rules (glong i, glong f, gpointer data)
+{
+  NcmMpsfSBesselIntSplinePrepare *prep = (NcmMpsfSBesselIntSplinePrepare *) data;
+  glong n;
+
+  for (n = i; n < f; n++)
+  {
+    ncm_mpsf_sbessel_jl_xj_integral_recur_set_q (prep->int_jlspline->xnjlrec[n], prep->l,
+                                                 g_ptr_array_index (prep->qs, n), prep->rnd);
+  }
+}
+
 /**
  * ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare: (skip)
  * @int_jlspline: a #NcmMpsfSBesselIntSpline
@@ -503,28 +560,32 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare (NcmMpsfSBesselIntSpline *int_jl
 {
   gulong i, j;
   GTimer *bench = g_timer_new ();
-  gdouble elapsed[5] = {0, 0, 0, 0, 0};
+  GPtrArray *qs = g_ptr_array_new ();
+  NcmMpsfSBesselIntSplinePrepare prep;
   mpq_t q;
   GHashTable *rhash = g_hash_table_new (NULL, NULL);
   mpq_init (q);
   int_jlspline->l = l;
   int_jlspline->rules_count = 0;
 
+  /*
+   * First pass (serial): find the distinct products x_i k_j, allocate
+   * one recurrence object for each of them and build the index map.
+   */
   for (j = 0; j < int_jlspline->k->nnodes; j++)
   {
     for (i = 0; i < int_jlspline->x->nnodes; i++)
     {
       NcmMpsfSBesselIntegRecur *xnjlrec;
       mpq_mul (q, int_jlspline->x->nodes[i], int_jlspline->k->nodes[j]);
-      //mpfr_printf ("# %lu %lu | %Qd\n", i, j, q); fflush (stdout);
       if ((xnjlrec = g_hash_table_lookup (int_jlspline->int_hash, q)) == NULL)
       {
-        xnjlrec = ncm_mpsf_sbessel_jl_xj_integral_recur_new (int_jlspline->prec, NULL);
-        ncm_mpsf_sbessel_jl_xj_integral_recur_set_q (xnjlrec, l, q, rnd);
         mpq_ptr qq = (mpq_ptr)g_slice_new (mpq_t);
+        xnjlrec = ncm_mpsf_sbessel_jl_xj_integral_recur_new (int_jlspline->prec, NULL);
         mpq_init (qq);
         mpq_set (qq, q);
         g_hash_table_insert (int_jlspline->int_hash, qq, xnjlrec);
+        g_ptr_array_add (qs, qq);
 
         int_jlspline->xnjlrec[int_jlspline->rules_count] = xnjlrec;
 
@@ -537,40 +598,83 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare (NcmMpsfSBesselIntSpline *int_jl
         NCM_MPSF_SBESSEL_INT_MAP(int_jlspline,i,j) =
           GPOINTER_TO_INT(g_hash_table_lookup (rhash, xnjlrec));
     }
+  }
 
-    elapsed[0] = elapsed[1];
-    elapsed[1] = elapsed[2];
-    elapsed[2] = elapsed[3];
-    elapsed[3] = elapsed[4];
-    elapsed[4] = g_timer_elapsed (bench, NULL);
+  /*
+   * Second pass: the rules are independent and each one carries its own
+   * MPFR state, so they are computed in parallel.
+   */
+  prep.int_jlspline = int_jlspline;
+  prep.qs           = qs;
+  prep.l            = l;
+  prep.rnd          = rnd;
 
-    printf ("# %lu %lu | total %fs | estimated left %fs %fs\n", i, j, elapsed[4], elapsed[4] * (int_jlspline->k->nnodes - j - 1) / (j + 1.0), (elapsed[4]-elapsed[3]) * (int_jlspline->k->nnodes - j - 1) + 0.0 * (elapsed[4] - 2.0 * elapsed[3] + elapsed[2]) * gsl_pow_2 (int_jlspline->k->nnodes - j - 1) / 2.0 ); fflush (stdout);
-  }
+  ncm_func_eval_threaded_loop_full (&_ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare_rules, 0, int_jlspline->rules_count, &prep);
+
+  g_debug ("ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare: %u rules computed in %fs.", int_jlspline->rules_count, g_timer_elapsed (bench, NULL));
 
   g_hash_table_unref (rhash);
+  g_ptr_array_unref (qs);
   int_jlspline->prepared = TRUE;
   g_timer_destroy (bench);
   mpq_clear (q);
 }
 
+/* The mapped data has no alignment guarantee. */
+static guint32
+_ncm_mpsf_sbessel_jl_xj_integrate_spline_read_be_uint32 (const gchar *data)
+{
+  guint32 val;
+
+  memcpy (&val, data, sizeof (guint32));
+
+  return GUINT32_FROM_BE (val);
+}
+
+static gchar *
+_ncm_mpsf_sbessel_jl_xj_integrate_spline_checksum (const gchar *data, gsize len)
+{
+  return g_compute_checksum_for_data (G_CHECKSUM_SHA256, (const guchar *) data, len);
+}
+
 /**
  * ncm_mpsf_sbessel_jl_xj_integrate_spline_save:
  * @int_jlspline: a #NcmMpsfSBesselIntSpline
- * @filename: FIXME
+ * @filename: cache file name, relative to the numcosmo data directory
+ *
+ * Saves @int_jlspline in the numcosmo data directory. The file starts
+ * with the magic string "NcSBR" followed by the format version
+ * #NCM_MPSF_SBESSEL_INT_CACHE_VERSION and ends with the SHA-256
+ * checksum (hexadecimal) of all preceding bytes.
+ *
+ * The content is first assembled in memory and then atomically moved
+ * into place, therefore, different processes (e.g. MPI ranks) can
+ * safely write the same file concurrently, the readers will always see
+ * a complete file.
  *
- * FIXME
 */
 void
 ncm_mpsf_sbessel_jl_xj_integrate_spline_save (NcmMpsfSBesselIntSpline *int_jlspline, gchar *filename)
 {
+  gchar *fullname = ncm_cfg_get_fullpath ("%s", filename);
+  gchar magic[5] = "NcSBR";
+  GError *error = NULL;
+  gchar *buf = NULL;
+  gsize len = 0;
+  gchar *checksum;
   gulong i, j;
+  FILE *f;
+
   g_assert (int_jlspline->prepared == TRUE);
-  FILE *f = ncm_cfg_fopen (filename, "w");
-  gchar magic[5] = "NcSBR";
+
+  f = open_memstream (&buf, &len);
+  if (f == NULL)
+    g_error ("ncm_mpsf_sbessel_jl_xj_integrate_spline_save: cannot create memory stream.");
 
   if (fwrite (magic, 1, 5, f) != 5)
     g_error ("ncm_mpsf_sbessel_jl_xj_integrate_spline_save: io error");
 
+  NCM_WRITE_UINT32(f, NCM_MPSF_SBESSEL_INT_CACHE_VERSION);
   NCM_WRITE_UINT32(f, int_jlspline->prec);
   ncm_grid_write (int_jlspline->x, f);
   ncm_grid_write (int_jlspline->k, f);
@@ -585,46 +689,139 @@ ncm_mpsf_sbessel_jl_xj_integrate_spline_save (NcmMpsfSBesselIntSpline *int_jlspl
     ncm_mpsf_sbessel_jl_xj_integral_recur_write (int_jlspline->xnjlrec[i], f);
 
   fclose (f);
+
+  checksum = _ncm_mpsf_sbessel_jl_xj_integrate_spline_checksum (buf, len);
+  buf = g_realloc (buf, len + NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN);
+  memcpy (&buf[len], checksum, NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN);
+
+  if (!g_file_set_contents (fullname, buf, len + NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN, &error))
+  {
+    g_warning ("ncm_mpsf_sbessel_jl_xj_integrate_spline_save: cannot save cache `%s': %s.", fullname, error->message);
+    g_error_free (error);
+  }
+
+  g_free (checksum);
+  g_free (buf);
+  g_free (fullname);
 }
 
 /**
  * ncm_mpsf_sbessel_jl_xj_integrate_spline_load: (skip)
- * @filename: FIXME
+ * @filename: cache file name, relative to the numcosmo data directory
  *
- * FIXME
+ * Loads a #NcmMpsfSBesselIntSpline saved by
+ * ncm_mpsf_sbessel_jl_xj_integrate_spline_save(). The file is memory
+ * mapped and its version and checksum are verified before parsing.
  *
- * Returns: FIXME
+ * Returns: the loaded #NcmMpsfSBesselIntSpline or NULL if the file is
+ * missing, truncated, corrupted or was written with a different format
+ * version.
 */
 NcmMpsfSBesselIntSpline *
 ncm_mpsf_sbessel_jl_xj_integrate_spline_load (gchar *filename)
 {
-  gulong i, j;
-  FILE *f = ncm_cfg_fopen (filename, "r");
-  gchar magic[5];
-  NcmGrid *x_grid, *k_grid;
-  NcmMpsfSBesselIntSpline *int_jlspline;
-  guint32 prec;
+  gchar *fullname = ncm_cfg_get_fullpath ("%s", filename);
+  GError *error = NULL;
+  GMappedFile *mfile = g_mapped_file_new (fullname, FALSE, &error);
+  NcmMpsfSBesselIntSpline *int_jlspline = NULL;
+  const gsize header_len = 5 + sizeof (guint32);
+  const gchar *data;
+  gchar *checksum;
+  gsize len;
+
+  if (mfile == NULL)
+  {
+    g_warning ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: cannot open cache `%s': %s.", fullname, error->message);
+    g_error_free (error);
+    g_free (fullname);
+    return NULL;
+  }
 
-  if (fread (magic, 1, 5, f) != 5)
-    g_error ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: io error");
-  NCM_READ_UINT32(f, prec);
-  x_grid = ncm_grid_read (f);
-  k_grid = ncm_grid_read (f);
-  int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_new (prec, x_grid, k_grid);
+  data = g_mapped_file_get_contents (mfile);
+  len  = g_mapped_file_get_length (mfile);
 
-  for (j = 0; j < int_jlspline->k->nnodes; j++)
-    for (i = 0; i < int_jlspline->x->nnodes; i++)
-      NCM_READ_UINT32(f, NCM_MPSF_SBESSEL_INT_MAP(int_jlspline,i,j));
+  if ((len < header_len + NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN) || (memcmp (data, "NcSBR", 5) != 0))
+  {
+    g_warning ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: `%s' is not a valid cache file, ignoring.", fullname);
+  }
+  else if (_ncm_mpsf_sbessel_jl_xj_integrate_spline_read_be_uint32 (&data[5]) != NCM_MPSF_SBESSEL_INT_CACHE_VERSION)
+  {
+    g_warning ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: cache `%s' version %u differs from %u, ignoring.",
+               fullname, _ncm_mpsf_sbessel_jl_xj_integrate_spline_read_be_uint32 (&data[5]), NCM_MPSF_SBESSEL_INT_CACHE_VERSION);
+  }
+  else
+  {
+    len -= NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN;
+    checksum = _ncm_mpsf_sbessel_jl_xj_integrate_spline_checksum (data, len);
 
-  NCM_READ_UINT32(f, int_jlspline->rules_count);
+    if (memcmp (checksum, &data[len], NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN) != 0)
+    {
+      g_warning ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: cache `%s' checksum mismatch, ignoring.", fullname);
+    }
+    else
+    {
+      FILE *f = fmemopen ((gpointer) &data[header_len], len - header_len, "r");
+      NcmGrid *x_grid, *k_grid;
+      guint32 prec;
+      gulong i, j;
 
-  for (i = 0; i < int_jlspline->rules_count; i++)
-    int_jlspline->xnjlrec[i] = ncm_mpsf_sbessel_jl_xj_integral_recur_read (f);
+      if (f == NULL)
+        g_error ("ncm_mpsf_sbessel_jl_xj_integrate_spline_load: cannot create memory stream.");
 
-  fclose (f);
+      NCM_READ_UINT32(f, prec);
+      x_grid = ncm_grid_read (f);
+      k_grid = ncm_grid_read (f);
+      int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_new (prec, x_grid, k_grid);
+
+      for (j = 0; j < int_jlspline->k->nnodes; j++)
+        for (i = 0; i < int_jlspline->x->nnodes; i++)
+          NCM_READ_UINT32(f, NCM_MPSF_SBESSEL_INT_MAP(int_jlspline,i,j));
+
+      NCM_READ_UINT32(f, int_jlspline->rules_count);
+
+      for (i = 0; i < int_jlspline->rules_count; i++)
+        int_jlspline->xnjlrec[i] = ncm_mpsf_sbessel_jl_xj_integral_recur_read (f);
+
+      int_jlspline->prepared = TRUE;
+      fclose (f);
+    }
+    g_free (checksum);
+  }
+
+  g_mapped_file_unref (mfile);
+  g_free (fullname);
   return int_jlspline;
 }
 
+/**
+ * ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_fill: (skip)
+ * @prec: MPFR precision
+ * @lmin: first multipole
+ * @lmax: last multipole
+ * @x_secs: a #NcmGridSection
+ * @k_secs: a #NcmGridSection
+ * @rnd: MPFR rounding mode
+ *
+ * Makes sure the cache files for all multipoles in [@lmin, @lmax] are
+ * present in the numcosmo data directory, computing and saving the
+ * missing ones. The rules of each multipole are computed in parallel,
+ * see ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare().
+ *
+*/
+void
+ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_fill (gulong prec, glong lmin, glong lmax, NcmGridSection *x_secs, NcmGridSection *k_secs, mp_rnd_t rnd)
+{
+  glong l;
+
+  g_assert_cmpint (lmin, <=, lmax);
+
+  for (l = lmin; l <= lmax; l++)
+  {
+    NcmMpsfSBesselIntSpline *int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new (prec, l, x_secs, k_secs, rnd);
+    ncm_mpsf_sbessel_jl_xj_integrate_spline_free (int_jlspline);
+  }
+}
+
 /**
  * ncm_mpsf_sbessel_jl_xj_integrate_spline_next: (skip)
  * @int_jlspline: a #NcmMpsfSBesselIntSpline
@@ -742,26 +939,78 @@ _taylor_get_nmax (gint l, gint j, gdouble mx2_4)
   return ceil(rs[nr - 1]);
 }
 
+/*
+ * Scratch space used by the functions below, one per thread, see
+ * _ncm_mpsf_sbessel_int_get_ws().
+ */
+typedef struct _NcmMpsfSBesselIntWS
+{
+  NcmBinSplit *bs;
+  binsplit_int_xn_jl_data *data;
+  mpz_t term, qn2;
+  mpz_t iterm, itermc, isumc, isum, iterm_const, ifour_xn2, iqd_jm1;
+  mpz_t sum_sin, sum_cos, sum_sinint, cor, qd_jm1;
+} NcmMpsfSBesselIntWS;
+
+static gpointer
+_ncm_mpsf_sbessel_int_ws_alloc (gpointer userdata)
+{
+  NcmMpsfSBesselIntWS *ws = g_slice_new (NcmMpsfSBesselIntWS);
+
+  NCM_UNUSED (userdata);
+
+  ws->data = g_slice_new (binsplit_int_xn_jl_data);
+  ws->bs   = ncm_binsplit_alloc ((gpointer)ws->data);
+
+  mpz_inits (ws->term, ws->qn2, NULL);
+  mpz_inits (ws->iterm, ws->itermc, ws->isumc, ws->isum, ws->iterm_const, ws->ifour_xn2, ws->iqd_jm1, NULL);
+  mpz_inits (ws->sum_sin, ws->sum_cos, ws->sum_sinint, ws->cor, ws->qd_jm1, NULL);
+
+  return ws;
+}
+
 static void
-_xn_jl_taylor (gint l, gint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
+_ncm_mpsf_sbessel_int_ws_free (gpointer p)
+{
+  NcmMpsfSBesselIntWS *ws = (NcmMpsfSBesselIntWS *) p;
+
+  mpz_clears (ws->term, ws->qn2, NULL);
+  mpz_clears (ws->iterm, ws->itermc, ws->isumc, ws->isum, ws->iterm_const, ws->ifour_xn2, ws->iqd_jm1, NULL);
+  mpz_clears (ws->sum_sin, ws->sum_cos, ws->sum_sinint, ws->cor, ws->qd_jm1, NULL);
+
+  g_slice_free (NcmMpsfSBesselIntWS, ws);
+  /* Leak we dont have a free function for binsplit FIXME:LEAK */
+}
+
+static NcmMpsfSBesselIntWS **
+_ncm_mpsf_sbessel_int_get_ws (void)
 {
-  static NcmBinSplit *bs = NULL;
+  G_LOCK_DEFINE_STATIC (create_lock);
+  static NcmMemoryPool *mp = NULL;
+
+  G_LOCK (create_lock);
+  if (mp == NULL)
+    mp = ncm_memory_pool_new (_ncm_mpsf_sbessel_int_ws_alloc, NULL, _ncm_mpsf_sbessel_int_ws_free);
+  G_UNLOCK (create_lock);
+
+  return ncm_memory_pool_get (mp);
+}
+
+static void
+_xn_jl_taylor (NcmMpsfSBesselIntWS *ws, gint l, gint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
+{
+  NcmBinSplit *bs = ws->bs;
   const gdouble x = mpq_get_d (q);
   const gdouble mx2_4 = -x * x / 4.0;
   const gdouble nmax = _taylor_get_nmax (l, j, mx2_4);
   gulong prec = mpfr_get_prec (res);
-  static binsplit_int_xn_jl_data *data = NULL;
+  binsplit_int_xn_jl_data *data = ws->data;
   mpfr_t sqrt_pi, gamma_l_3_2, x_pow_1_l_j;
   mpq_t mq2_4;
 
   g_assert (x >= 0);
 //  g_assert (x <= l);
 
-  if (data == NULL)
-    data = g_slice_new (binsplit_int_xn_jl_data);
-  if (bs == NULL)
-    bs = ncm_binsplit_alloc ((gpointer)data);
-
   mpfr_inits2 (prec, sqrt_pi, gamma_l_3_2, x_pow_1_l_j, NULL);
   mpfr_const_pi (sqrt_pi, rnd);
   mpfr_sqrt (sqrt_pi, sqrt_pi, rnd);
@@ -800,18 +1049,13 @@ _xn_jl_taylor (gint l, gint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
  *************************************************************************************/
 
 static void
-_xn_jl_finite_x (gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos, mpz_t cor)
+_xn_jl_finite_x (NcmMpsfSBesselIntWS *ws, gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos, mpz_t cor)
 {
-  static mpz_t term, qn2;
-  static gboolean init_mpz = TRUE;
+  mpz_ptr term = ws->term;
+  mpz_ptr qn2 = ws->qn2;
   mpz_ptr sum = cor;
   gulong n, signs[2] = {0, 0};
   gulong first_term, second_term;
-  if (init_mpz)
-  {
-    mpz_inits (term, sum, qn2, NULL);
-    init_mpz = FALSE;
-  }
 
   first_term = ((1-l) < 0) ? ((4 - ((l - 1) % 4)) % 4) : ((1 - l) % 4);
   second_term = (first_term + 1) % 4;
@@ -858,10 +1102,15 @@ _xn_jl_finite_x (gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos, mpz_t c
 }
 
 static void
-_xn_jl_finite_inverse_x (gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos, mpz_t sum_sinint, mpz_t cor, gulong prec, gulong *lk)
+_xn_jl_finite_inverse_x (NcmMpsfSBesselIntWS *ws, gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos, mpz_t sum_sinint, mpz_t cor, gulong prec, gulong *lk)
 {
-  static mpz_t term, termc, sumc, sum, term_const, four_xn2, qd_jm1;
-  static gboolean init_mpz = TRUE;
+  mpz_ptr term = ws->iterm;
+  mpz_ptr termc = ws->itermc;
+  mpz_ptr sumc = ws->isumc;
+  mpz_ptr sum = ws->isum;
+  mpz_ptr term_const = ws->iterm_const;
+  mpz_ptr four_xn2 = ws->ifour_xn2;
+  mpz_ptr qd_jm1 = ws->iqd_jm1;
   gboolean converged[2] = {FALSE, FALSE};
   glong signs[2] = {1, 1};
   gulong n, poch_jp1_j = 1L;
@@ -871,12 +1120,6 @@ _xn_jl_finite_inverse_x (gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos,
   glong wsum;
   mpz_ptr suml;
 
-  if (init_mpz)
-  {
-    mpz_inits (term, termc, sumc, sum, term_const, four_xn2, qd_jm1, NULL);
-    init_mpz = FALSE;
-  }
-
   second_term = (4 - ((l - j) % 4)) % 4;                    /* Analysing k = 2 to get the second signs */
   first_term = (second_term + 1) % 4;                       /* Analysing k = 1 to get the first signs  */
   signs[first_term  % 2] = (first_term  / 2) == 0 ? 1 : -1; /* FIXME (doc this) */
@@ -1027,36 +1270,31 @@ _xn_jl_finite_inverse_x (gint l, guint j, mpq_t q, mpz_t sum_sin, mpz_t sum_cos,
 
 
 static void
-_xn_jl_finite (guint l, guint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
+_xn_jl_finite (NcmMpsfSBesselIntWS *ws, guint l, guint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
 {
-  static mpz_t sum_sin, sum_cos, sum_sinint, cor, qd_jm1;
-  static gboolean init_mpz = TRUE;
+  mpz_ptr sum_sin = ws->sum_sin;
+  mpz_ptr sum_cos = ws->sum_cos;
+  mpz_ptr sum_sinint = ws->sum_sinint;
+  mpz_ptr cor = ws->cor;
+  mpz_ptr qd_jm1 = ws->qd_jm1;
   gulong prec = mpfr_get_prec (res);
   gulong lk = 0;
   mpfr_t cos_x, sin_x, sinint_x, xx, pre_cos, pre_sin, xn_pow, corfact;
   mpfr_inits2 (prec, cos_x, sin_x, sinint_x, xx, pre_cos, pre_sin, xn_pow, corfact, NULL);
 
-  if (init_mpz)
-  {
-    mpz_inits (sum_sin, sum_cos, sum_sinint, cor, qd_jm1, NULL);
-    init_mpz = FALSE;
-  }
-  else
-  {
-    mpz_set_ui (sum_sin, 0);
-    mpz_set_ui (sum_cos, 0);
-    mpz_set_ui (sum_sinint, 0);
-    mpz_set_ui (cor, 0);
-  }
+  mpz_set_ui (sum_sin, 0);
+  mpz_set_ui (sum_cos, 0);
+  mpz_set_ui (sum_sinint, 0);
+  mpz_set_ui (cor, 0);
 
   mpfr_set_q (xx, q, rnd);
   mpfr_sin_cos (sin_x, cos_x, xx, rnd);
 
   if (j > 0)
-    _xn_jl_finite_x (l, j, q, sum_sin, sum_cos, cor);
+    _xn_jl_finite_x (ws, l, j, q, sum_sin, sum_cos, cor);
 
   if (l > j)
-    _xn_jl_finite_inverse_x (l, j, q, sum_sin, sum_cos, sum_sinint, cor, prec, &lk);
+    _xn_jl_finite_inverse_x (ws, l, j, q, sum_sin, sum_cos, sum_sinint, cor, prec, &lk);
   else
   {
     if (l == j)
@@ -1143,6 +1381,7 @@ _xn_jl_finite (guint l, guint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
 void
 ncm_mpsf_sbessel_jl_xj_integral_q (guint l, guint j, mpq_t q, mpfr_t res, mp_rnd_t rnd)
 {
+  NcmMpsfSBesselIntWS **ws_ptr;
   gboolean taylor;
   gint sign = mpz_sgn (mpq_numref (q));
 
@@ -1155,11 +1394,14 @@ ncm_mpsf_sbessel_jl_xj_integral_q (guint l, guint j, mpq_t q, mpfr_t res, mp_rnd
   }
 
   taylor = (mpq_cmp_ui (q, l, 1) <= 0);
+  ws_ptr = _ncm_mpsf_sbessel_int_get_ws ();
 
   if (taylor)
-    _xn_jl_taylor (l, j, q, res, rnd);
+    _xn_jl_taylor (*ws_ptr, l, j, q, res, rnd);
   else
-    _xn_jl_finite (l, j, q, res, rnd);
+    _xn_jl_finite (*ws_ptr, l, j, q, res, rnd);
+
+  ncm_memory_pool_return (ws_ptr);
 
   if (FALSE)
     mpfr_printf ("# l %d j %d q %Qd x %.15e res % .36Re | used assym %s\n", l, j, q, mpq_get_d (q), res, !taylor ? "yes" : "no");
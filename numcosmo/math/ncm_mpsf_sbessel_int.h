@@ -80,6 +80,23 @@ struct _NcmMpsfSBesselIntSpline
   gboolean prepared;
 };
 
+/**
+ * NCM_MPSF_SBESSEL_INT_CACHE_VERSION:
+ *
+ * Version of the on-disk format used by
+ * ncm_mpsf_sbessel_jl_xj_integrate_spline_save(), files with a different
+ * version are ignored and regenerated.
+ */
+#define NCM_MPSF_SBESSEL_INT_CACHE_VERSION (2)
+
+/**
+ * NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN:
+ *
+ * Length of the hexadecimal SHA-256 checksum appended to the cache files
+ * by ncm_mpsf_sbessel_jl_xj_integrate_spline_save().
+ */
+#define NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN (64)
+
 #define NCM_MPSF_SBESSEL_INT_MAP(int_jlspline,xi,kj) ((int_jlspline)->map_ij2r[((int_jlspline)->row * kj + xi)])
 
 void ncm_mpsf_sbessel_jl_xj_integral (gint l, gint j, gdouble x, mpfr_t res, mp_rnd_t rnd);
@@ -101,6 +118,8 @@ NcmMpsfSBesselIntSpline *ncm_mpsf_sbessel_jl_xj_integrate_spline_new (gulong pre
 NcmMpsfSBesselIntSpline *ncm_mpsf_sbessel_jl_xj_integrate_spline_new_from_sections (gulong prec, NcmGridSection *x_secs, NcmGridSection *k_secs);
 NcmMpsfSBesselIntSpline *ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new (gulong prec, glong l, NcmGridSection *x_secs, NcmGridSection *k_secs, mp_rnd_t rnd);
 NcmMpsfSBesselIntSpline *ncm_mpsf_sbessel_jl_xj_integrate_spline_load (gchar *filename);
+void ncm_mpsf_sbessel_jl_xj_integrate_spline_free (NcmMpsfSBesselIntSpline *int_jlspline);
+void ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_fill (gulong prec, glong lmin, glong lmax, NcmGridSection *x_secs, NcmGridSection *k_secs, mp_rnd_t rnd);
 
 void ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare (NcmMpsfSBesselIntSpline *int_jlspline, glong l, mp_rnd_t rnd);
 void ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare_new (NcmMpsfSBesselIntSpline *int_jlspline, glong l, mp_rnd_t rnd);
@@ -40,6 +40,7 @@
 #include "math/binsplit.h"
 #include "math/ncm_cfg.h"
 #include "math/ncm_util.h"
+#include "math/ncm_memory_pool.h"
 
 #define NC_BINSPLIT_EVAL_NAME binsplit_sin_integral_taylor
 #define _mx2 (((mpq_ptr)data))
@@ -109,32 +110,73 @@ NCM_BINSPLIT_DECL(binsplit_sin_integral_assym_q,v,u,n,data)
 #include "binsplit_eval.c"
 #undef _m2x2
 
+static gpointer
+_taylor_bs_alloc (gpointer userdata)
+{
+  mpq_ptr mq2 = g_slice_new (__mpq_struct);
+
+  NCM_UNUSED (userdata);
+
+  mpq_init (mq2);
+  return ncm_binsplit_alloc ((gpointer)mq2);
+}
+
+static gpointer
+_assym_bs_alloc (gpointer userdata)
+{
+  gpointer *data = g_slice_alloc (2 * sizeof (gpointer));
+
+  NCM_UNUSED (userdata);
+
+  return ncm_binsplit_alloc ((gpointer)data);
+}
+
 static void
-_taylor_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
+_trig_int_bs_free (gpointer p)
 {
-  static NcmBinSplit *bs = NULL;
-  static mpq_ptr mq2 = NULL;
-  if (mq2 == NULL)
+  NCM_UNUSED (p);
+  /* Leak we dont have a free function for binsplit FIXME:LEAK */
+}
+
+static NcmBinSplit **
+_ncm_mpsf_trig_int_get_bs (gboolean taylor)
+{
+  G_LOCK_DEFINE_STATIC (create_lock);
+  static NcmMemoryPool *mp_taylor = NULL;
+  static NcmMemoryPool *mp_assym = NULL;
+
+  G_LOCK (create_lock);
+  if (mp_taylor == NULL)
   {
-    mq2 = g_slice_new (__mpq_struct);
-    mpq_init (mq2);
+    mp_taylor = ncm_memory_pool_new (_taylor_bs_alloc, NULL, _trig_int_bs_free);
+    mp_assym  = ncm_memory_pool_new (_assym_bs_alloc, NULL, _trig_int_bs_free);
   }
+  G_UNLOCK (create_lock);
+
+  return ncm_memory_pool_get (taylor ? mp_taylor : mp_assym);
+}
+
+static void
+_taylor_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
+{
+  NcmBinSplit **bs_ptr = _ncm_mpsf_trig_int_get_bs (TRUE);
+  NcmBinSplit *bs = *bs_ptr;
+  mpq_ptr mq2 = (mpq_ptr) bs->userdata;
+
   mpq_mul (mq2, q, q);
   mpq_neg (mq2, mq2);
   mpq_div_2exp (mq2, mq2, 1);
 
-  if (bs == NULL)
-    bs = ncm_binsplit_alloc ((gpointer)mq2);
-
   ncm_binsplit_eval_prec (bs, binsplit_sin_integral_taylor, 10, mpfr_get_prec (res));
   ncm_binsplit_get (bs, res);
   mpfr_mul_q (res, res, q, rnd);
+
+  ncm_memory_pool_return (bs_ptr);
 }
 
 static void
 _assym_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
 {
-  static NcmBinSplit *bs = NULL;
   glong prec = mpfr_get_prec (res);
   glong mprec;
 
@@ -144,8 +186,10 @@ _assym_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
 
   if ((prec - mprec) > 0)
   {
+    NcmBinSplit **bs_ptr = _ncm_mpsf_trig_int_get_bs (FALSE);
+    NcmBinSplit *bs = *bs_ptr;
+    gpointer *data = (gpointer *) bs->userdata;
     gulong nf;
-    static gpointer *data = NULL;
     mpq_t mq2_2;
     mpq_init (mq2_2);
     mpq_mul (mq2_2, q, q);
@@ -153,11 +197,6 @@ _assym_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
     mpq_div_2exp (mq2_2, mq2_2, 1);
     MPFR_DECL_INIT (sin_x, prec);
     MPFR_DECL_INIT (cos_x, prec);
-    if (data == NULL)
-      data = g_slice_alloc (2 * sizeof(gpointer));
-    if (bs == NULL)
-      bs = ncm_binsplit_alloc (data);
-
     mpfr_sin_cos (sin_x, cos_x, res, rnd);
     mpfr_div_q (sin_x, sin_x, q, rnd);
     mpfr_div_q (sin_x, sin_x, q, rnd);
@@ -184,6 +223,7 @@ _assym_mpfr (mpq_t q, mpfr_ptr res, mp_rnd_t rnd)
     mpfr_sub (res, res, cos_x, rnd);
 
     mpq_clear (mq2_2);
+    ncm_memory_pool_return (bs_ptr);
   }
   else
   {
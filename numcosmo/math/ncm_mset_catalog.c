@@ -114,6 +114,7 @@ struct _NcmMSetCatalogPrivate
   gchar *rtype_str;
   GArray *porder;
   NcmVector *quantile_ws;
+  guint nthreads;
   gint first_id;
   gint cur_id;
   gint file_first_id;
@@ -215,6 +216,7 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   self->rtype_str      = NULL;
   self->porder         = g_array_new (FALSE, FALSE, sizeof (gint));
   self->quantile_ws    = NULL;
+  self->nthreads       = 0;
 #ifdef NUMCOSMO_HAVE_CFITSIO
   self->fptr           = NULL;
 #endif /* NUMCOSMO_HAVE_CFITSIO */
@@ -1601,6 +1603,38 @@ ncm_mset_catalog_set_sync_interval (NcmMSetCatalog *mcat, gdouble interval)
   self->sync_interval = interval;
 }
 
+/**
+ * ncm_mset_catalog_set_nthreads:
+ * @mcat: a #NcmMSetCatalog
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used to evaluate functions over the
+ * catalog rows, see ncm_mset_catalog_calc_ci_direct(), 
+ * ncm_mset_catalog_calc_ci_interp() and ncm_mset_catalog_calc_pvalue().
+ * When @nthreads is larger than one the functions are evaluated in
+ * blocks of rows using ncm_mset_func_eval_vector_batch().
+ *
+ */
+void
+ncm_mset_catalog_set_nthreads (NcmMSetCatalog *mcat, guint nthreads)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  self->nthreads = nthreads;
+}
+
+/**
+ * ncm_mset_catalog_get_nthreads:
+ * @mcat: a #NcmMSetCatalog
+ *
+ * Returns: the number of threads set by ncm_mset_catalog_set_nthreads().
+ */
+guint
+ncm_mset_catalog_get_nthreads (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  return self->nthreads;
+}
+
 /**
  * ncm_mset_catalog_set_first_id:
  * @mcat: a #NcmMSetCatalog
@@ -2577,7 +2611,7 @@ ncm_mset_catalog_get_tau_method (NcmMSetCatalog *mcat)
 }
 
 static void
-_ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
+_ncm_mset_catalog_update_bounds (NcmMSetCatalog *mcat, NcmVector *x)
 {
   NcmMSetCatalogPrivate *self = mcat->priv;
   const guint len = self->pstats->len;
@@ -2592,6 +2626,83 @@ _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
     ncm_vector_set (self->params_max, i, GSL_MAX (p_i, cur_max_p_i));
     ncm_vector_set (self->params_min, i, GSL_MIN (p_i, cur_min_p_i));
   }
+}
+
+static gboolean
+_ncm_mset_catalog_ensemble_done (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  return ((self->cur_id + 1) % self->nchains + 1 == self->nchains);
+}
+
+static void
+_ncm_mset_catalog_ensemble_flush (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  NcmVector *e_mean = ncm_stats_vec_peek_mean (self->e_stats);
+  const guint len   = ncm_vector_len (e_mean);
+  NcmVector *e_var  = ncm_vector_new (len);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    ncm_vector_set (e_var, i, ncm_stats_vec_get_var (self->e_stats, i));
+  }
+
+  ncm_stats_vec_append (self->e_mean_stats, e_mean, TRUE);
+  g_ptr_array_add (self->e_var_array, e_var);
+
+  ncm_stats_vec_reset (self->e_stats, FALSE);
+}
+
+static void
+_ncm_mset_catalog_update_bestfit (NcmMSetCatalog *mcat, NcmVector *x)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  if (self->m2lnp_var >= 0)
+  {
+    gdouble *m2lnp = ncm_vector_ptr (x, self->m2lnp_var);
+    if (*m2lnp < self->bestfit)
+    {
+      ncm_vector_clear (&self->bestfit_row);
+      self->bestfit_row = ncm_vector_ref (x);
+      self->bestfit     = *m2lnp;
+
+      ncm_mset_fparams_set_vector_offset (self->mset, x, self->nadd_vals);
+    }
+    g_ptr_array_add (self->order_cat, ncm_vector_ref (x));
+    self->order_cat_sort = FALSE;
+  }
+}
+
+static void
+_ncm_mset_catalog_auto_sync (NcmMSetCatalog *mcat)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  switch (self->smode)
+  {
+    case NCM_MSET_CATALOG_SYNC_DISABLE:
+      break;
+    case NCM_MSET_CATALOG_SYNC_AUTO:
+      ncm_mset_catalog_sync (mcat, FALSE);
+      break;
+    case NCM_MSET_CATALOG_SYNC_TIMED:
+      ncm_mset_catalog_timed_sync (mcat, FALSE);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+static void
+_ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+
+  _ncm_mset_catalog_update_bounds (mcat, x);
 
   if (self->weighted)
   {
@@ -2620,57 +2731,111 @@ _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
   }
 
   self->cur_id++;
+  if ((self->nchains > 1) && _ncm_mset_catalog_ensemble_done (mcat))
+    _ncm_mset_catalog_ensemble_flush (mcat);
+
+  self->post_lnnorm_up = FALSE;
+  _ncm_mset_catalog_update_bestfit (mcat, x);
+  _ncm_mset_catalog_auto_sync (mcat);
+}
+
+/*
+ * Block version of _ncm_mset_catalog_post_update, the rows are
+ * processed in order with the same semantics as the single row
+ * version but the full sample (and each ensemble) statistics are
+ * updated with a single block update and the catalog is synchronized
+ * only once at the end.
+ */
+static void
+_ncm_mset_catalog_post_update_block (NcmMSetCatalog *mcat, GPtrArray *rows)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const guint nrows = rows->len;
+  NcmVector *w      = self->weighted ? ncm_vector_new (nrows) : NULL;
+  guint k;
+
+  if (nrows == 0)
+  {
+    ncm_vector_clear (&w);
+    return;
+  }
+
   if (self->nchains > 1)
   {
-    if ((self->cur_id + 1) % self->nchains + 1 == self->nchains)
+    GPtrArray *e_rows = g_ptr_array_new ();
+    GArray *e_w       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    const gint cur_id = self->cur_id;
+
+    for (k = 0; k < nrows; k++)
     {
-      NcmVector *e_mean = ncm_stats_vec_peek_mean (self->e_stats);
-      const guint len   = ncm_vector_len (e_mean);
-      NcmVector *e_var  = ncm_vector_new (len);
-      guint i;
+      NcmVector *x_k      = g_ptr_array_index (rows, k);
+      const guint chain_id = (self->cur_id + 1) % self->nchains;
+      NcmStatsVec *pstats = g_ptr_array_index (self->chain_pstats, chain_id);
 
-      for (i = 0; i < len; i++)
+      if (self->weighted)
       {
-        ncm_vector_set (e_var, i, ncm_stats_vec_get_var (self->e_stats, i));
+        const gdouble w_k = ncm_vector_get (x_k, self->nadd_vals - 1);
+        ncm_stats_vec_append_weight (pstats, x_k, w_k, FALSE);
+        g_array_append_val (e_w, w_k);
       }
+      else
+        ncm_stats_vec_append (pstats, x_k, FALSE);
 
-      ncm_stats_vec_append (self->e_mean_stats, e_mean, TRUE);
-      g_ptr_array_add (self->e_var_array, e_var);
+      g_ptr_array_add (e_rows, x_k);
 
-      ncm_stats_vec_reset (self->e_stats, FALSE);
+      self->cur_id++;
+      if (_ncm_mset_catalog_ensemble_done (mcat))
+      {
+        if (self->weighted)
+        {
+          NcmVector *e_wv = ncm_vector_new_data_static ((gdouble *)e_w->data, e_w->len, 1);
+          ncm_stats_vec_append_weight_data (self->e_stats, e_rows, e_wv, FALSE);
+          ncm_vector_free (e_wv);
+        }
+        else
+          ncm_stats_vec_append_data (self->e_stats, e_rows, FALSE);
+
+        _ncm_mset_catalog_ensemble_flush (mcat);
+        g_ptr_array_set_size (e_rows, 0);
+        g_array_set_size (e_w, 0);
+      }
     }
-  }
 
-  self->post_lnnorm_up = FALSE;
-  if (self->m2lnp_var >= 0)
-  {
-    gdouble *m2lnp = ncm_vector_ptr (x, self->m2lnp_var);
-    if (*m2lnp < self->bestfit)
+    if (e_rows->len > 0)
     {
-      ncm_vector_clear (&self->bestfit_row);
-      self->bestfit_row = ncm_vector_ref (x);
-      self->bestfit     = *m2lnp;
-
-      ncm_mset_fparams_set_vector_offset (self->mset, x, self->nadd_vals);
+      if (self->weighted)
+      {
+        NcmVector *e_wv = ncm_vector_new_data_static ((gdouble *)e_w->data, e_w->len, 1);
+        ncm_stats_vec_append_weight_data (self->e_stats, e_rows, e_wv, FALSE);
+        ncm_vector_free (e_wv);
+      }
+      else
+        ncm_stats_vec_append_data (self->e_stats, e_rows, FALSE);
     }
-    g_ptr_array_add (self->order_cat, ncm_vector_ref (x));
-    self->order_cat_sort = FALSE;
+
+    g_ptr_array_unref (e_rows);
+    g_array_unref (e_w);
+    self->cur_id = cur_id;
   }
-  
-  switch (self->smode)
+
+  for (k = 0; k < nrows; k++)
   {
-    case NCM_MSET_CATALOG_SYNC_DISABLE:
-      break;
-    case NCM_MSET_CATALOG_SYNC_AUTO:
-      ncm_mset_catalog_sync (mcat, FALSE);
-      break;
-    case NCM_MSET_CATALOG_SYNC_TIMED:
-      ncm_mset_catalog_timed_sync (mcat, FALSE);
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
+    NcmVector *x_k = g_ptr_array_index (rows, k);
+
+    _ncm_mset_catalog_update_bounds (mcat, x_k);
+    if (self->weighted)
+      ncm_vector_set (w, k, ncm_vector_get (x_k, self->nadd_vals - 1));
   }
+
+  ncm_stats_vec_append_weight_data (self->pstats, rows, w, FALSE);
+  self->cur_id += nrows;
+
+  self->post_lnnorm_up = FALSE;
+  for (k = 0; k < nrows; k++)
+    _ncm_mset_catalog_update_bestfit (mcat, g_ptr_array_index (rows, k));
+
+  _ncm_mset_catalog_auto_sync (mcat);
+  ncm_vector_clear (&w);
 }
 
 /**
@@ -2778,6 +2943,31 @@ ncm_mset_catalog_add_from_vector_array (NcmMSetCatalog *mcat, NcmVector *vals, g
   ncm_vector_free (row_i);
 }
 
+/**
+ * ncm_mset_catalog_add_from_vector_block:
+ * @mcat: a #NcmMSetCatalog
+ * @vals_array: (element-type NcmVector): a #GPtrArray of #NcmVector
+ *
+ * Adds the elements in @vals_array to the catalog, in order. This is
+ * equivalent to calling ncm_mset_catalog_add_from_vector() for each element
+ * of @vals_array but the statistics are updated in a single block
+ * and the catalog is synchronized only once. This is the preferred way of
+ * adding a full ensemble of walkers at once.
+ *
+ */
+void
+ncm_mset_catalog_add_from_vector_block (NcmMSetCatalog *mcat, GPtrArray *vals_array)
+{
+  GPtrArray *rows = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  guint k;
+
+  for (k = 0; k < vals_array->len; k++)
+    g_ptr_array_add (rows, ncm_vector_dup (g_ptr_array_index (vals_array, k)));
+
+  _ncm_mset_catalog_post_update_block (mcat, rows);
+  g_ptr_array_unref (rows);
+}
+
 static gdouble
 _fvar (gdouble v_i, guint i, gpointer user_data)
 {
@@ -3962,6 +4152,98 @@ ncm_mset_catalog_param_pdf_pvalue (NcmMSetCatalog *mcat, gdouble pvalue, gboolea
   }
 }
 
+#define _NCM_MSET_CATALOG_FUNC_BLOCK_SIZE (1 << 14)
+
+/*
+ * Evaluates @func at @x_v for the catalog rows [i0, i0 + nrows (res)), using 
+ * the first rows of @params_ws to hold the parameters.
+ */
+static void
+_ncm_mset_catalog_eval_func_block (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, guint i0, NcmMatrix *params_ws, NcmMatrix *res)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const guint nrows           = ncm_matrix_nrows (res);
+  NcmMatrix *params           = ncm_matrix_get_submatrix (params_ws, 0, 0, nrows, ncm_matrix_ncols (params_ws));
+  guint k;
+
+  for (k = 0; k < nrows; k++)
+    ncm_matrix_set_row (params, k, ncm_mset_catalog_peek_row (mcat, i0 + k));
+
+  ncm_mset_func_eval_vector_batch (func, self->mset, params, self->nadd_vals, x_v, res, self->nthreads);
+
+  ncm_matrix_free (params);
+}
+
+/*
+ * Adds the values of @func at @x_v for each catalog row to the
+ * distributions in @epdf_a, uses self->quantile_ws of length dim.
+ */
+static void
+_ncm_mset_catalog_func_add_obs (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GPtrArray *epdf_a, NcmFitRunMsgs mtype)
+{
+  NcmMSetCatalogPrivate *self = mcat->priv;
+  const guint dim             = ncm_vector_len (x_v);
+  const guint cat_len         = ncm_mset_catalog_len (mcat);
+  guint i, j;
+
+  if (self->nthreads > 1)
+  {
+    const guint block_size = GSL_MIN (cat_len, _NCM_MSET_CATALOG_FUNC_BLOCK_SIZE);
+    NcmMatrix *params_ws   = ncm_matrix_new (block_size, ncm_mset_catalog_ncols (mcat));
+    NcmMatrix *res_ws      = ncm_matrix_new (block_size, dim);
+    guint i0;
+
+    for (i = 0, i0 = 0; i0 < cat_len; i0 += block_size)
+    {
+      const guint nb   = GSL_MIN (cat_len - i0, block_size);
+      NcmMatrix *res_b = ncm_matrix_get_submatrix (res_ws, 0, 0, nb, dim);
+      guint k;
+
+      _ncm_mset_catalog_eval_func_block (mcat, func, x_v, i0, params_ws, res_b);
+
+      for (k = 0; k < nb; k++, i++)
+      {
+        for (j = 0; j < dim; j++)
+        {
+          NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
+          ncm_stats_dist1d_epdf_add_obs (epdf, ncm_matrix_get (res_b, k, j));
+        }
+        if ((i % (cat_len / 100) == 0) && (mtype > NCM_FIT_RUN_MSGS_NONE))
+          ncm_message ("=");
+      }
+
+      ncm_matrix_free (res_b);
+    }
+
+    ncm_matrix_free (params_ws);
+    ncm_matrix_free (res_ws);
+  }
+  else
+  {
+    for (i = 0; i < cat_len; i++)
+    {
+      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
+
+      ncm_mset_fparams_set_vector_offset (self->mset, row, self->nadd_vals);
+
+      ncm_mset_func_eval_vector (func, self->mset, x_v, self->quantile_ws);
+
+      for (j = 0; j < dim; j++)
+      {
+        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
+        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_vector_get (self->quantile_ws, j));
+      }
+      if (i % (cat_len / 100) == 0)
+      {
+        if (mtype > NCM_FIT_RUN_MSGS_NONE)
+        {
+          ncm_message ("=");
+        }
+      }
+    }
+  }
+}
+
 /**
  * ncm_mset_catalog_calc_ci_direct:
  * @mcat: a #NcmMSetCatalog
@@ -4009,15 +4291,35 @@ ncm_mset_catalog_calc_ci_direct (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
     ncm_vector_clear (&self->quantile_ws);
     self->quantile_ws = ncm_vector_new (cat_len * dim);
 
-    for (i = 0; i < cat_len; i++)
+    if (self->nthreads > 1)
     {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-      NcmVector *qws = ncm_vector_get_subvector (self->quantile_ws, i * dim, dim);
-      ncm_mset_fparams_set_vector_offset (self->mset, row, self->nadd_vals);
+      NcmMatrix *qws       = ncm_matrix_new_data_static (ncm_vector_data (self->quantile_ws), cat_len, dim);
+      NcmMatrix *params_ws = ncm_matrix_new (GSL_MIN (cat_len, _NCM_MSET_CATALOG_FUNC_BLOCK_SIZE), ncm_mset_catalog_ncols (mcat));
+
+      for (i = 0; i < cat_len; i += _NCM_MSET_CATALOG_FUNC_BLOCK_SIZE)
+      {
+        const guint nb   = GSL_MIN (cat_len - i, _NCM_MSET_CATALOG_FUNC_BLOCK_SIZE);
+        NcmMatrix *res_b = ncm_matrix_get_submatrix (qws, i, 0, nb, dim);
 
-      ncm_mset_func_eval_vector (func, self->mset, x_v, qws);
+        _ncm_mset_catalog_eval_func_block (mcat, func, x_v, i, params_ws, res_b);
+        ncm_matrix_free (res_b);
+      }
 
-      ncm_vector_free (qws);
+      ncm_matrix_free (params_ws);
+      ncm_matrix_free (qws);
+    }
+    else
+    {
+      for (i = 0; i < cat_len; i++)
+      {
+        NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
+        NcmVector *qws = ncm_vector_get_subvector (self->quantile_ws, i * dim, dim);
+        ncm_mset_fparams_set_vector_offset (self->mset, row, self->nadd_vals);
+
+        ncm_mset_func_eval_vector (func, self->mset, x_v, qws);
+
+        ncm_vector_free (qws);
+      }
     }
 
     for (i = 0; i < dim; i++)
@@ -4121,30 +4423,11 @@ ncm_mset_catalog_calc_ci_interp (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
       ncm_message ("|\n# - |");
     }
 
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-
-      ncm_mset_fparams_set_vector_offset (self->mset, row, self->nadd_vals);
-
-      ncm_mset_func_eval_vector (func, self->mset, x_v, self->quantile_ws);
+    _ncm_mset_catalog_func_add_obs (mcat, func, x_v, epdf_a, mtype);
 
-      for (j = 0; j < dim; j++)
-      {
-        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
-        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_vector_get (self->quantile_ws, j));
-      }
-      if (i % (cat_len / 100) == 0)
-      {
-        if (mtype > NCM_FIT_RUN_MSGS_NONE)
-        {
-          ncm_message ("=");
-        }
-      }
-    }
     if (mtype > NCM_FIT_RUN_MSGS_NONE)
     {
-      if (i % (cat_len / 100) != 0)
+      if (cat_len % (cat_len / 100) != 0)
         ncm_message ("=");
       ncm_message ("|\n");
       ncm_message ("# - |");
@@ -4259,30 +4542,11 @@ ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector
       ncm_message ("|\n# - |");
     }
 
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-
-      ncm_mset_fparams_set_vector_offset (self->mset, row, self->nadd_vals);
-
-      ncm_mset_func_eval_vector (func, self->mset, x_v, self->quantile_ws);
+    _ncm_mset_catalog_func_add_obs (mcat, func, x_v, epdf_a, mtype);
 
-      for (j = 0; j < dim; j++)
-      {
-        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
-        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_vector_get (self->quantile_ws, j));
-      }
-      if (i % (cat_len / 100) == 0)
-      {
-        if (mtype > NCM_FIT_RUN_MSGS_NONE)
-        {
-          ncm_message ("=");
-        }
-      }
-    }
     if (mtype > NCM_FIT_RUN_MSGS_NONE)
     {
-      if (i % (cat_len / 100) != 0)
+      if (cat_len % (cat_len / 100) != 0)
         ncm_message ("=");
       ncm_message ("|\n");
       ncm_message ("# - |");
@@ -143,6 +143,8 @@ void ncm_mset_catalog_clear (NcmMSetCatalog **mcat);
 void ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename);
 void ncm_mset_catalog_set_sync_mode (NcmMSetCatalog *mcat, NcmMSetCatalogSync smode);
 void ncm_mset_catalog_set_sync_interval (NcmMSetCatalog *mcat, gdouble interval);
+void ncm_mset_catalog_set_nthreads (NcmMSetCatalog *mcat, guint nthreads);
+guint ncm_mset_catalog_get_nthreads (NcmMSetCatalog *mcat);
 void ncm_mset_catalog_set_first_id (NcmMSetCatalog *mcat, gint first_id);
 void ncm_mset_catalog_set_run_type (NcmMSetCatalog *mcat, const gchar *rtype_str);
 void ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng);
@@ -186,6 +188,7 @@ void ncm_mset_catalog_add_from_mset (NcmMSetCatalog *mcat, NcmMSet *mset, ...) G
 void ncm_mset_catalog_add_from_mset_array (NcmMSetCatalog *mcat, NcmMSet *mset, gdouble *ax);
 void ncm_mset_catalog_add_from_vector (NcmMSetCatalog *mcat, NcmVector *vals);
 void ncm_mset_catalog_add_from_vector_array (NcmMSetCatalog *mcat, NcmVector *vals, gdouble *ax);
+void ncm_mset_catalog_add_from_vector_block (NcmMSetCatalog *mcat, GPtrArray *vals_array);
 void ncm_mset_catalog_log_current_stats (NcmMSetCatalog *mcat);
 void ncm_mset_catalog_log_current_chain_stats (NcmMSetCatalog *mcat);
 
@@ -0,0 +1,1090 @@
+/***************************************************************************
+ *            ncm_mset_catalog_stream.c
+ *
+ *  Sun October 18 18:02:17 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * ncm_mset_catalog_stream.c
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:ncm_mset_catalog_stream
+ * @title: NcmMSetCatalogStream
+ * @short_description: Single pass, bounded memory analysis of #NcmMSetCatalog files.
+ *
+ * This object computes summary statistics of one or more #NcmMSetCatalog
+ * fits files without loading them into memory. The rows are read in chunks
+ * of a fixed number of rows and fed to a set of mergeable accumulators:
+ * a #NcmStatsVec with the weighted mean, variance and covariance of all
+ * columns, and a fixed-range histogram for each column that corresponds to a
+ * bounded free parameter of the catalog #NcmMSet. The histograms are used to
+ * estimate quantiles, e.g., medians and credible intervals.
+ *
+ * Since all accumulators can be merged, ncm_mset_catalog_stream_add_files()
+ * processes each input file in a different thread and merges the results in
+ * the input order. This requires a reentrant cfitsio build, otherwise the
+ * files are processed serially.
+ *
+ * The function ncm_mset_catalog_stream_join() joins compatible catalogs into
+ * a single one, interleaving the ensembles of each input as they are read,
+ * again using only a chunk of rows of each file at a time.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include "build_cfg.h"
+
+#include "math/ncm_mset_catalog_stream.h"
+#include "math/ncm_serialize.h"
+#include "math/ncm_func_eval.h"
+#include "math/ncm_util.h"
+#include "math/ncm_cfg.h"
+
+#ifndef NUMCOSMO_GIR_SCAN
+#include <gsl/gsl_histogram.h>
+#include <math.h>
+#include <string.h>
+#ifdef NUMCOSMO_HAVE_CFITSIO
+#include <fitsio.h>
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+#endif /* NUMCOSMO_GIR_SCAN */
+
+struct _NcmMSetCatalogStreamPrivate
+{
+  guint ncols;
+  guint nbins;
+  guint nchains;
+  gint weight_col;
+  guint64 nrows;
+  GPtrArray *col_names;
+  GArray *lb;
+  GArray *ub;
+  NcmStatsVec *pstats;
+  GPtrArray *hists;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (NcmMSetCatalogStream, ncm_mset_catalog_stream, G_TYPE_OBJECT);
+
+static void
+_ncm_mset_catalog_stream_hist_free (gpointer h)
+{
+  if (h != NULL)
+    gsl_histogram_free (h);
+}
+
+static void
+ncm_mset_catalog_stream_init (NcmMSetCatalogStream *mcs)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv = ncm_mset_catalog_stream_get_instance_private (mcs);
+
+  self->ncols      = 0;
+  self->nbins      = 0;
+  self->nchains    = 0;
+  self->weight_col = -1;
+  self->nrows      = 0;
+  self->col_names  = g_ptr_array_new_with_free_func (g_free);
+  self->lb         = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  self->ub         = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  self->pstats     = NULL;
+  self->hists      = g_ptr_array_new_with_free_func (_ncm_mset_catalog_stream_hist_free);
+}
+
+static void
+_ncm_mset_catalog_stream_dispose (GObject *object)
+{
+  NcmMSetCatalogStream *mcs = NCM_MSET_CATALOG_STREAM (object);
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+
+  ncm_stats_vec_clear (&self->pstats);
+
+  g_clear_pointer (&self->hists, g_ptr_array_unref);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (ncm_mset_catalog_stream_parent_class)->dispose (object);
+}
+
+static void
+_ncm_mset_catalog_stream_finalize (GObject *object)
+{
+  NcmMSetCatalogStream *mcs = NCM_MSET_CATALOG_STREAM (object);
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+
+  g_clear_pointer (&self->col_names, g_ptr_array_unref);
+  g_clear_pointer (&self->lb, g_array_unref);
+  g_clear_pointer (&self->ub, g_array_unref);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (ncm_mset_catalog_stream_parent_class)->finalize (object);
+}
+
+static void
+ncm_mset_catalog_stream_class_init (NcmMSetCatalogStreamClass *klass)
+{
+  GObjectClass* object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose  = &_ncm_mset_catalog_stream_dispose;
+  object_class->finalize = &_ncm_mset_catalog_stream_finalize;
+}
+
+static void
+_ncm_mset_catalog_stream_alloc (NcmMSetCatalogStream *mcs)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  guint i;
+
+  self->pstats = ncm_stats_vec_new (self->ncols, NCM_STATS_VEC_COV, FALSE);
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    const gdouble lb = g_array_index (self->lb, gdouble, i);
+    const gdouble ub = g_array_index (self->ub, gdouble, i);
+
+    if (gsl_finite (lb) && gsl_finite (ub) && (ub > lb) && (self->nbins > 0))
+    {
+      gsl_histogram *h = gsl_histogram_alloc (self->nbins);
+
+      gsl_histogram_set_ranges_uniform (h, lb, ub);
+      g_ptr_array_add (self->hists, h);
+    }
+    else
+      g_ptr_array_add (self->hists, NULL);
+  }
+}
+
+#ifdef NUMCOSMO_HAVE_CFITSIO
+
+static fitsfile *
+_ncm_mset_catalog_stream_open (const gchar *filename, guint *ncols, guint *nchains, glong *nrows)
+{
+  fitsfile *fptr = NULL;
+  gint status    = 0;
+  gint nchains_i = 0;
+  gint ncols_i   = 0;
+
+  if (!g_file_test (filename, G_FILE_TEST_EXISTS))
+    g_error ("_ncm_mset_catalog_stream_open: catalog file `%s' not found.", filename);
+
+  fits_open_file (&fptr, filename, READONLY, &status);
+  NCM_FITS_ERROR (status);
+
+  fits_movnam_hdu (fptr, BINARY_TBL, NCM_MSET_CATALOG_EXTNAME, 0, &status);
+  NCM_FITS_ERROR (status);
+
+  fits_read_key (fptr, TINT, NCM_MSET_CATALOG_NCHAINS_LABEL, &nchains_i, NULL, &status);
+  NCM_FITS_ERROR (status);
+
+  fits_get_num_cols (fptr, &ncols_i, &status);
+  NCM_FITS_ERROR (status);
+
+  fits_get_num_rows (fptr, nrows, &status);
+  NCM_FITS_ERROR (status);
+
+  ncols[0]   = ncols_i;
+  nchains[0] = nchains_i;
+
+  return fptr;
+}
+
+static void
+_ncm_mset_catalog_stream_close (fitsfile *fptr)
+{
+  gint status = 0;
+
+  fits_close_file (fptr, &status);
+  NCM_FITS_ERROR (status);
+}
+
+static gchar *
+_ncm_mset_catalog_stream_read_col_name (fitsfile *fptr, guint i)
+{
+  gchar *key  = g_strdup_printf ("TTYPE%u", i + 1);
+  gchar name[FLEN_VALUE];
+  gint status = 0;
+
+  fits_read_key (fptr, TSTRING, key, name, NULL, &status);
+  NCM_FITS_ERROR (status);
+
+  g_free (key);
+
+  return g_strdup (name);
+}
+
+static void
+_ncm_mset_catalog_stream_check_cols (fitsfile *fptr, const gchar *filename, GPtrArray *col_names)
+{
+  guint i;
+
+  for (i = 0; i < col_names->len; i++)
+  {
+    gchar *name_i = _ncm_mset_catalog_stream_read_col_name (fptr, i);
+
+    if (strcmp (name_i, g_ptr_array_index (col_names, i)) != 0)
+      g_error ("_ncm_mset_catalog_stream_check_cols: incompatible catalog `%s', column %u is `%s' instead of `%s'.",
+               filename, i, name_i, (gchar *) g_ptr_array_index (col_names, i));
+
+    g_free (name_i);
+  }
+}
+
+/*
+ * Reads @len rows starting at @row (0-based) for all @ncols columns,
+ * the result is stored column by column in @buf.
+ */
+static void
+_ncm_mset_catalog_stream_read_chunk (fitsfile *fptr, guint ncols, glong row, glong len, gdouble *buf)
+{
+  const gdouble dnull = 0.0;
+  gint status         = 0;
+  guint c;
+
+  for (c = 0; c < ncols; c++)
+  {
+    fits_read_col_dbl (fptr, c + 1, row + 1, 1, len, dnull, &buf[c * len], NULL, &status);
+    NCM_FITS_ERROR (status);
+  }
+}
+
+static NcmMSet *
+_ncm_mset_catalog_stream_load_mset (const gchar *filename)
+{
+  gchar *base_name = ncm_util_basename_fits (filename);
+  gchar *mset_file = g_strdup_printf ("%s.mset", base_name);
+  NcmMSet *mset    = NULL;
+
+  if (g_file_test (mset_file, G_FILE_TEST_EXISTS))
+  {
+    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
+    mset = ncm_mset_load (mset_file, ser);
+    ncm_serialize_free (ser);
+  }
+
+  g_free (base_name);
+  g_free (mset_file);
+
+  return mset;
+}
+
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+/**
+ * ncm_mset_catalog_stream_new:
+ * @filename: a #NcmMSetCatalog fits filename
+ * @nbins: number of histogram bins
+ *
+ * Creates a new empty #NcmMSetCatalogStream compatible with the catalog
+ * in @filename. Only the header of @filename (and its #NcmMSet file, when
+ * available) is read. Histograms with @nbins bins are allocated for the
+ * columns that correspond to free parameters with finite bounds.
+ *
+ * Returns: (transfer full): a new #NcmMSetCatalogStream.
+ */
+NcmMSetCatalogStream *
+ncm_mset_catalog_stream_new (const gchar *filename, guint nbins)
+{
+  NcmMSetCatalogStream *mcs = g_object_new (NCM_TYPE_MSET_CATALOG_STREAM, NULL);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  NcmMSet *mset = _ncm_mset_catalog_stream_load_mset (filename);
+  glong nrows   = 0;
+  fitsfile *fptr;
+  guint i;
+
+  fptr = _ncm_mset_catalog_stream_open (filename, &self->ncols, &self->nchains, &nrows);
+  self->nbins = nbins;
+
+  g_array_set_size (self->lb, self->ncols);
+  g_array_set_size (self->ub, self->ncols);
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    gchar *name_i = _ncm_mset_catalog_stream_read_col_name (fptr, i);
+
+    g_array_index (self->lb, gdouble, i) = GSL_NEGINF;
+    g_array_index (self->ub, gdouble, i) = GSL_POSINF;
+
+    if (strcmp (name_i, "NcmMSetCatalog:Row-weights") == 0)
+    {
+      self->weight_col = i;
+    }
+    else if (mset != NULL)
+    {
+      const guint fparam_len = ncm_mset_fparam_len (mset);
+      guint j;
+
+      for (j = 0; j < fparam_len; j++)
+      {
+        if (strcmp (name_i, ncm_mset_fparam_full_name (mset, j)) == 0)
+        {
+          g_array_index (self->lb, gdouble, i) = ncm_mset_fparam_get_lower_bound (mset, j);
+          g_array_index (self->ub, gdouble, i) = ncm_mset_fparam_get_upper_bound (mset, j);
+          break;
+        }
+      }
+    }
+
+    g_ptr_array_add (self->col_names, name_i);
+  }
+
+  _ncm_mset_catalog_stream_close (fptr);
+  _ncm_mset_catalog_stream_alloc (mcs);
+
+  if (mset != NULL)
+    ncm_mset_free (mset);
+#else
+  g_error ("ncm_mset_catalog_stream_new: cannot read catalogs without cfitsio.");
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+  return mcs;
+}
+
+/*
+ * Creates an empty accumulator with the same columns and histogram ranges as @mcs.
+ */
+static NcmMSetCatalogStream *
+_ncm_mset_catalog_stream_dup_empty (NcmMSetCatalogStream *mcs)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  NcmMSetCatalogStream *dup = g_object_new (NCM_TYPE_MSET_CATALOG_STREAM, NULL);
+  NcmMSetCatalogStreamPrivate * const dself = dup->priv;
+  guint i;
+
+  dself->ncols      = self->ncols;
+  dself->nbins      = self->nbins;
+  dself->nchains    = self->nchains;
+  dself->weight_col = self->weight_col;
+
+  for (i = 0; i < self->ncols; i++)
+    g_ptr_array_add (dself->col_names, g_strdup (g_ptr_array_index (self->col_names, i)));
+
+  g_array_append_vals (dself->lb, self->lb->data, self->lb->len);
+  g_array_append_vals (dself->ub, self->ub->data, self->ub->len);
+
+  _ncm_mset_catalog_stream_alloc (dup);
+
+  return dup;
+}
+
+/**
+ * ncm_mset_catalog_stream_ref:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Increases the reference count of @mcs by one.
+ *
+ * Returns: (transfer full): @mcs
+ */
+NcmMSetCatalogStream *
+ncm_mset_catalog_stream_ref (NcmMSetCatalogStream *mcs)
+{
+  return g_object_ref (mcs);
+}
+
+/**
+ * ncm_mset_catalog_stream_free:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Decreases the reference count of @mcs by one.
+ *
+ */
+void
+ncm_mset_catalog_stream_free (NcmMSetCatalogStream *mcs)
+{
+  g_object_unref (mcs);
+}
+
+/**
+ * ncm_mset_catalog_stream_clear:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * If *@mcs is different from NULL, decreases the reference count of
+ * *@mcs by one and sets *@mcs to NULL.
+ *
+ */
+void
+ncm_mset_catalog_stream_clear (NcmMSetCatalogStream **mcs)
+{
+  g_clear_object (mcs);
+}
+
+/**
+ * ncm_mset_catalog_stream_reset:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Removes all data accumulated in @mcs.
+ *
+ */
+void
+ncm_mset_catalog_stream_reset (NcmMSetCatalogStream *mcs)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  guint i;
+
+  ncm_stats_vec_reset (self->pstats, TRUE);
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    gsl_histogram *h = g_ptr_array_index (self->hists, i);
+
+    if (h != NULL)
+      gsl_histogram_reset (h);
+  }
+
+  self->nrows = 0;
+}
+
+static void
+_ncm_mset_catalog_stream_update (NcmMSetCatalogStream *mcs, const gdouble *buf, glong len)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  glong r;
+
+  for (r = 0; r < len; r++)
+  {
+    const gdouble w = (self->weight_col >= 0) ? buf[self->weight_col * len + r] : 1.0;
+    guint c;
+
+    for (c = 0; c < self->ncols; c++)
+    {
+      const gdouble x_c = buf[c * len + r];
+      gsl_histogram *h  = g_ptr_array_index (self->hists, c);
+
+      ncm_stats_vec_set (self->pstats, c, x_c);
+
+      if (h != NULL)
+      {
+        const gdouble xi = h->range[0];
+        const gdouble xf = h->range[h->n];
+        const gdouble u  = (x_c - xi) / (xf - xi);
+        const glong k    = GSL_MIN (GSL_MAX ((glong) floor (u * h->n), 0), (glong) h->n - 1);
+
+        h->bin[k] += w;
+      }
+    }
+
+    ncm_stats_vec_update_weight (self->pstats, w);
+  }
+
+  self->nrows += len;
+}
+
+/**
+ * ncm_mset_catalog_stream_add_file:
+ * @mcs: a #NcmMSetCatalogStream
+ * @filename: a #NcmMSetCatalog fits filename
+ * @burnin: number of rows to skip at the beginning of the file
+ * @chunk_size: number of rows read at a time
+ *
+ * Reads all rows of @filename after the first @burnin rows, in chunks of
+ * @chunk_size rows, and adds them to the accumulators of @mcs. The file must
+ * have the same columns as the one used to create @mcs.
+ *
+ */
+void
+ncm_mset_catalog_stream_add_file (NcmMSetCatalogStream *mcs, const gchar *filename, glong burnin, guint chunk_size)
+{
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  guint ncols   = 0;
+  guint nchains = 0;
+  glong nrows   = 0;
+  fitsfile *fptr;
+  gdouble *buf;
+  glong row;
+
+  g_assert_cmpuint (chunk_size, >, 0);
+
+  fptr = _ncm_mset_catalog_stream_open (filename, &ncols, &nchains, &nrows);
+
+  if (ncols != self->ncols)
+    g_error ("ncm_mset_catalog_stream_add_file: incompatible catalog `%s', number of columns %u != %u.",
+             filename, ncols, self->ncols);
+  if (nchains != self->nchains)
+    g_error ("ncm_mset_catalog_stream_add_file: incompatible catalog `%s', number of chains %u != %u.",
+             filename, nchains, self->nchains);
+  if (nrows < burnin)
+    g_error ("ncm_mset_catalog_stream_add_file: burnin larger than the catalogue size %ld <=> %ld",
+             burnin, nrows);
+
+  _ncm_mset_catalog_stream_check_cols (fptr, filename, self->col_names);
+
+  buf = g_new (gdouble, (gsize) ncols * chunk_size);
+
+  for (row = burnin; row < nrows; row += chunk_size)
+  {
+    const glong len = GSL_MIN (nrows - row, (glong) chunk_size);
+
+    _ncm_mset_catalog_stream_read_chunk (fptr, ncols, row, len, buf);
+    _ncm_mset_catalog_stream_update (mcs, buf, len);
+  }
+
+  g_free (buf);
+  _ncm_mset_catalog_stream_close (fptr);
+#else
+  g_error ("ncm_mset_catalog_stream_add_file: cannot read catalogs without cfitsio.");
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+typedef struct _NcmMSetCatalogStreamFiles
+{
+  GPtrArray *accs;
+  gchar **filenames;
+  const glong *burnins;
+  guint chunk_size;
+} NcmMSetCatalogStreamFiles;
+
+static void
+_ncm_mset_catalog_stream_add_files_loop (glong i, glong f, gpointer data)
+{
+  NcmMSetCatalogStreamFiles *files = (NcmMSetCatalogStreamFiles *) data;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    NcmMSetCatalogStream *acc = g_ptr_array_index (files->accs, k);
+    const glong burnin        = (files->burnins != NULL) ? files->burnins[k] : 0;
+
+    ncm_mset_catalog_stream_add_file (acc, files->filenames[k], burnin, files->chunk_size);
+  }
+}
+
+/**
+ * ncm_mset_catalog_stream_add_files:
+ * @mcs: a #NcmMSetCatalogStream
+ * @filenames: (array zero-terminated=1): a NULL terminated array of filenames
+ * @burnins: (array) (allow-none): burnin of each file or NULL
+ * @chunk_size: number of rows read at a time
+ *
+ * Same as ncm_mset_catalog_stream_add_file() for each file in @filenames.
+ * Each file is read into its own accumulator, using one thread per file when
+ * cfitsio is reentrant, and then the accumulators are merged into @mcs in the
+ * same order as @filenames. The memory used is bounded by the number of
+ * threads times @chunk_size rows.
+ *
+ */
+void
+ncm_mset_catalog_stream_add_files (NcmMSetCatalogStream *mcs, gchar **filenames, const glong *burnins, guint chunk_size)
+{
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  const guint nfiles = g_strv_length (filenames);
+  NcmMSetCatalogStreamFiles files = {g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_mset_catalog_stream_free), filenames, burnins, chunk_size};
+  guint k;
+
+  if (nfiles == 0)
+  {
+    g_ptr_array_unref (files.accs);
+    return;
+  }
+
+  for (k = 0; k < nfiles; k++)
+    g_ptr_array_add (files.accs, _ncm_mset_catalog_stream_dup_empty (mcs));
+
+  if (fits_is_reentrant () && (nfiles > 1))
+    ncm_func_eval_threaded_loop_full (&_ncm_mset_catalog_stream_add_files_loop, 0, nfiles, &files);
+  else
+    _ncm_mset_catalog_stream_add_files_loop (0, nfiles, &files);
+
+  for (k = 0; k < nfiles; k++)
+    ncm_mset_catalog_stream_merge (mcs, g_ptr_array_index (files.accs, k));
+
+  g_ptr_array_unref (files.accs);
+#else
+  g_error ("ncm_mset_catalog_stream_add_files: cannot read catalogs without cfitsio.");
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
+
+/**
+ * ncm_mset_catalog_stream_merge:
+ * @mcs: a #NcmMSetCatalogStream
+ * @src: a #NcmMSetCatalogStream
+ *
+ * Adds all data accumulated in @src to @mcs. Both objects must have been
+ * created from compatible catalogs with the same number of bins.
+ *
+ */
+void
+ncm_mset_catalog_stream_merge (NcmMSetCatalogStream *mcs, NcmMSetCatalogStream *src)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  NcmMSetCatalogStreamPrivate * const sself = src->priv;
+  guint i;
+
+  g_assert_cmpuint (self->ncols, ==, sself->ncols);
+  g_assert_cmpuint (self->nbins, ==, sself->nbins);
+
+  if (sself->nrows == 0)
+    return;
+
+  ncm_stats_vec_merge (self->pstats, sself->pstats);
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    gsl_histogram *h     = g_ptr_array_index (self->hists, i);
+    gsl_histogram *src_h = g_ptr_array_index (sself->hists, i);
+
+    g_assert ((h == NULL) == (src_h == NULL));
+
+    if (h != NULL)
+      NCM_TEST_GSL_RESULT ("ncm_mset_catalog_stream_merge", gsl_histogram_add (h, src_h));
+  }
+
+  self->nrows += sself->nrows;
+}
+
+/**
+ * ncm_mset_catalog_stream_ncols:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Returns: the number of columns in @mcs.
+ */
+guint
+ncm_mset_catalog_stream_ncols (NcmMSetCatalogStream *mcs)
+{
+  return mcs->priv->ncols;
+}
+
+/**
+ * ncm_mset_catalog_stream_nchains:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Returns: the number of chains of the catalogs used in @mcs.
+ */
+guint
+ncm_mset_catalog_stream_nchains (NcmMSetCatalogStream *mcs)
+{
+  return mcs->priv->nchains;
+}
+
+/**
+ * ncm_mset_catalog_stream_nrows:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Returns: the number of rows accumulated in @mcs.
+ */
+guint64
+ncm_mset_catalog_stream_nrows (NcmMSetCatalogStream *mcs)
+{
+  return mcs->priv->nrows;
+}
+
+/**
+ * ncm_mset_catalog_stream_col_name:
+ * @mcs: a #NcmMSetCatalogStream
+ * @i: column index
+ *
+ * Returns: (transfer none): the name of the @i-th column.
+ */
+const gchar *
+ncm_mset_catalog_stream_col_name (NcmMSetCatalogStream *mcs, guint i)
+{
+  g_assert_cmpuint (i, <, mcs->priv->ncols);
+  return g_ptr_array_index (mcs->priv->col_names, i);
+}
+
+/**
+ * ncm_mset_catalog_stream_col_by_name:
+ * @mcs: a #NcmMSetCatalogStream
+ * @name: column name
+ * @col_index: (out): column index
+ *
+ * Looks for a column named @name.
+ *
+ * Returns: whether the column was found.
+ */
+gboolean
+ncm_mset_catalog_stream_col_by_name (NcmMSetCatalogStream *mcs, const gchar *name, guint *col_index)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  guint i;
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    if (strcmp (g_ptr_array_index (self->col_names, i), name) == 0)
+    {
+      col_index[0] = i;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+ * ncm_mset_catalog_stream_col_has_hist:
+ * @mcs: a #NcmMSetCatalogStream
+ * @i: column index
+ *
+ * Returns: whether the @i-th column has a histogram, and therefore quantile estimates.
+ */
+gboolean
+ncm_mset_catalog_stream_col_has_hist (NcmMSetCatalogStream *mcs, guint i)
+{
+  g_assert_cmpuint (i, <, mcs->priv->ncols);
+  return g_ptr_array_index (mcs->priv->hists, i) != NULL;
+}
+
+/**
+ * ncm_mset_catalog_stream_peek_stats:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Returns: (transfer none): the #NcmStatsVec containing the moments of all columns.
+ */
+NcmStatsVec *
+ncm_mset_catalog_stream_peek_stats (NcmMSetCatalogStream *mcs)
+{
+  return mcs->priv->pstats;
+}
+
+/**
+ * ncm_mset_catalog_stream_get_quantile:
+ * @mcs: a #NcmMSetCatalogStream
+ * @i: column index
+ * @p: probability $p \in [0, 1]$
+ *
+ * Estimates the @p quantile of the @i-th column by inverting the
+ * cumulative histogram, interpolating linearly inside each bin. The
+ * resolution is limited by the bin width. It returns NaN when the column
+ * has no histogram or no data.
+ *
+ * Returns: the @p quantile.
+ */
+gdouble
+ncm_mset_catalog_stream_get_quantile (NcmMSetCatalogStream *mcs, guint i, const gdouble p)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  gsl_histogram *h;
+  gsl_histogram_pdf *pdf;
+  gdouble q;
+
+  g_assert_cmpuint (i, <, self->ncols);
+  g_assert_cmpfloat (p, >=, 0.0);
+  g_assert_cmpfloat (p, <=, 1.0);
+
+  h = g_ptr_array_index (self->hists, i);
+
+  if ((h == NULL) || (gsl_histogram_sum (h) <= 0.0))
+    return GSL_NAN;
+
+  pdf = gsl_histogram_pdf_alloc (h->n);
+  NCM_TEST_GSL_RESULT ("ncm_mset_catalog_stream_get_quantile", gsl_histogram_pdf_init (pdf, h));
+
+  q = gsl_histogram_pdf_sample (pdf, GSL_MIN (p, 1.0 - GSL_DBL_EPSILON));
+
+  gsl_histogram_pdf_free (pdf);
+
+  return q;
+}
+
+/**
+ * ncm_mset_catalog_stream_log_stats:
+ * @mcs: a #NcmMSetCatalogStream
+ *
+ * Logs the number of rows, and for each column, the mean, standard deviation,
+ * median and the $1\sigma$ central credible interval (when available).
+ *
+ */
+void
+ncm_mset_catalog_stream_log_stats (NcmMSetCatalogStream *mcs)
+{
+  NcmMSetCatalogStreamPrivate * const self = mcs->priv;
+  const gdouble p1s = 0.5 * erfc (M_SQRT1_2);
+  guint i;
+
+  g_message ("# Catalog streamed rows: %" G_GUINT64_FORMAT ".", self->nrows);
+  g_message ("# Catalog n-chains:      %u.", self->nchains);
+  g_message ("# Catalog weighted:      %s.", (self->weight_col >= 0) ? "yes" : "no");
+  g_message ("# %32s | %22s | %22s | %22s | %22s | %22s", "column", "mean", "sd", "median", "-1sigma", "+1sigma");
+
+  for (i = 0; i < self->ncols; i++)
+  {
+    const gchar *name = g_ptr_array_index (self->col_names, i);
+    const gdouble mean = ncm_stats_vec_get_mean (self->pstats, i);
+    const gdouble sd   = ncm_stats_vec_get_sd (self->pstats, i);
+
+    if (ncm_mset_catalog_stream_col_has_hist (mcs, i))
+    {
+      const gdouble med = ncm_mset_catalog_stream_get_quantile (mcs, i, 0.5);
+      const gdouble lb  = ncm_mset_catalog_stream_get_quantile (mcs, i, p1s);
+      const gdouble ub  = ncm_mset_catalog_stream_get_quantile (mcs, i, 1.0 - p1s);
+
+      g_message ("# %32s | % 22.15g | % 22.15g | % 22.15g | % 22.15g | % 22.15g", name, mean, sd, med, lb - med, ub - med);
+    }
+    else
+      g_message ("# %32s | % 22.15g | % 22.15g | %22s | %22s | %22s", name, mean, sd, "-", "-", "-");
+  }
+}
+
+#ifdef NUMCOSMO_HAVE_CFITSIO
+
+typedef struct _NcmMSetCatalogStreamJoin
+{
+  fitsfile **fptrs;
+  gdouble **bufs;
+  const glong *burnins;
+  guint ncols;
+  guint nchains;
+  glong *max_time;
+  glong t0;
+  glong t1;
+} NcmMSetCatalogStreamJoin;
+
+static glong
+_ncm_mset_catalog_stream_join_seg (NcmMSetCatalogStreamJoin *join, guint k)
+{
+  const glong t1 = GSL_MIN (join->t1, join->max_time[k]);
+  return (t1 > join->t0) ? (t1 - join->t0) * join->nchains : 0;
+}
+
+static void
+_ncm_mset_catalog_stream_join_read_loop (glong i, glong f, gpointer data)
+{
+  NcmMSetCatalogStreamJoin *join = (NcmMSetCatalogStreamJoin *) data;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    const glong len = _ncm_mset_catalog_stream_join_seg (join, k);
+
+    if (len > 0)
+    {
+      const glong burnin = (join->burnins != NULL) ? join->burnins[k] : 0;
+      _ncm_mset_catalog_stream_read_chunk (join->fptrs[k], join->ncols, burnin + join->t0 * join->nchains, len, join->bufs[k]);
+    }
+  }
+}
+
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+/**
+ * ncm_mset_catalog_stream_join:
+ * @filenames: (array zero-terminated=1): a NULL terminated array of filenames
+ * @burnins: (array) (allow-none): burnin of each file or NULL
+ * @out: output filename
+ * @chunk_size: approximated number of rows kept in memory
+ *
+ * Joins the catalogs in @filenames into a new catalog @out. For each time $t$,
+ * the ensemble at $t$ of each input catalog (that reaches $t$) is
+ * appended to @out in the order of @filenames. All catalogs must have the same
+ * columns, number of chains and #NcmMSet, and each burnin must be a multiple
+ * of the number of chains.
+ *
+ * The inputs are read in blocks of ensembles containing about @chunk_size rows
+ * in total, in parallel when cfitsio is reentrant, and each block is written
+ * to @out before the next one is read. The header keys of the first catalog
+ * are copied to @out, and its #NcmMSet is saved together with @out.
+ *
+ */
+void
+ncm_mset_catalog_stream_join (gchar **filenames, const glong *burnins, const gchar *out, guint chunk_size)
+{
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  const guint nfiles     = g_strv_length (filenames);
+  NcmMSet *mset          = _ncm_mset_catalog_stream_load_mset (filenames[0]);
+  GPtrArray *col_names   = g_ptr_array_new_with_free_func (g_free);
+  GPtrArray *tform_array = g_ptr_array_new ();
+  NcmMSetCatalogStreamJoin join;
+  fitsfile *optr   = NULL;
+  glong mmax_time  = 0;
+  glong out_row    = 0;
+  gint status      = 0;
+  glong tstep;
+  gdouble *obuf;
+  guint k;
+
+  g_assert_cmpuint (nfiles, >, 0);
+  g_assert_cmpuint (chunk_size, >, 0);
+
+  if (mset == NULL)
+    g_error ("ncm_mset_catalog_stream_join: mset file of catalog `%s' not found.", filenames[0]);
+
+  if (g_file_test (out, G_FILE_TEST_EXISTS))
+    g_error ("ncm_mset_catalog_stream_join: output file `%s' already exists.", out);
+
+  join.fptrs    = g_new0 (fitsfile *, nfiles);
+  join.bufs     = g_new0 (gdouble *, nfiles);
+  join.max_time = g_new0 (glong, nfiles);
+  join.burnins  = burnins;
+  join.ncols    = 0;
+  join.nchains  = 0;
+
+  for (k = 0; k < nfiles; k++)
+  {
+    const glong burnin = (burnins != NULL) ? burnins[k] : 0;
+    NcmMSet *mset_k    = _ncm_mset_catalog_stream_load_mset (filenames[k]);
+    guint ncols_k      = 0;
+    guint nchains_k    = 0;
+    glong nrows_k      = 0;
+
+    join.fptrs[k] = _ncm_mset_catalog_stream_open (filenames[k], &ncols_k, &nchains_k, &nrows_k);
+
+    if (k == 0)
+    {
+      guint i;
+
+      join.ncols   = ncols_k;
+      join.nchains = nchains_k;
+
+      for (i = 0; i < ncols_k; i++)
+      {
+        g_ptr_array_add (col_names, _ncm_mset_catalog_stream_read_col_name (join.fptrs[k], i));
+        g_ptr_array_add (tform_array, "1D");
+      }
+    }
+    else
+    {
+      if ((mset_k == NULL) || (ncm_mset_cmp_all (mset, mset_k) != 0))
+        g_error ("ncm_mset_catalog_stream_join: catalog `%s' has an incompatible mset.", filenames[k]);
+
+      g_assert_cmpuint (ncols_k, ==, join.ncols);
+      g_assert_cmpuint (nchains_k, ==, join.nchains);
+
+      _ncm_mset_catalog_stream_check_cols (join.fptrs[k], filenames[k], col_names);
+    }
+
+    if (burnin % join.nchains != 0)
+      g_error ("ncm_mset_catalog_stream_join: burnin[%u] not multiple of nchains %u.", k, join.nchains);
+    if (nrows_k < burnin)
+      g_error ("ncm_mset_catalog_stream_join: burnin larger than the catalogue size %ld <=> %ld",
+               burnin, nrows_k);
+
+    join.max_time[k] = (nrows_k - burnin) / join.nchains;
+    mmax_time        = GSL_MAX (mmax_time, join.max_time[k]);
+
+    if (mset_k != NULL)
+      ncm_mset_free (mset_k);
+  }
+
+  /* Output table, same layout as the first catalog plus its user keys. */
+  fits_create_file (&optr, out, &status);
+  NCM_FITS_ERROR (status);
+
+  fits_create_tbl (optr, BINARY_TBL, 0, join.ncols, (gchar **) col_names->pdata, (gchar **) tform_array->pdata,
+                   NULL, NCM_MSET_CATALOG_EXTNAME, &status);
+  NCM_FITS_ERROR (status);
+
+  {
+    gint nkeys = 0;
+    gint i;
+
+    fits_get_hdrspace (join.fptrs[0], &nkeys, NULL, &status);
+    NCM_FITS_ERROR (status);
+
+    for (i = 1; i <= nkeys; i++)
+    {
+      gchar card[FLEN_CARD];
+      gint kclass;
+
+      fits_read_record (join.fptrs[0], i, card, &status);
+      NCM_FITS_ERROR (status);
+
+      kclass = fits_get_keyclass (card);
+
+      if ((kclass == TYP_USER_KEY) || (kclass == TYP_CONT_KEY))
+      {
+        fits_write_record (optr, card, &status);
+        NCM_FITS_ERROR (status);
+      }
+    }
+  }
+
+  {
+    gchar *base_name  = ncm_util_basename_fits (out);
+    gchar *mset_file  = g_strdup_printf ("%s.mset", base_name);
+    NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
+
+    ncm_mset_save (mset, ser, mset_file, TRUE);
+
+    ncm_serialize_free (ser);
+    g_free (base_name);
+    g_free (mset_file);
+  }
+
+  tstep = GSL_MAX (1, (glong) chunk_size / (join.nchains * nfiles));
+
+  for (k = 0; k < nfiles; k++)
+    join.bufs[k] = g_new (gdouble, (gsize) join.ncols * tstep * join.nchains);
+
+  obuf = g_new (gdouble, (gsize) join.ncols * tstep * join.nchains * nfiles);
+
+  for (join.t0 = 0; join.t0 < mmax_time; join.t0 += tstep)
+  {
+    glong nout = 0;
+    glong t;
+    guint c;
+
+    join.t1 = GSL_MIN (join.t0 + tstep, mmax_time);
+
+    for (k = 0; k < nfiles; k++)
+      nout += _ncm_mset_catalog_stream_join_seg (&join, k);
+
+    if (fits_is_reentrant () && (nfiles > 1))
+      ncm_func_eval_threaded_loop_full (&_ncm_mset_catalog_stream_join_read_loop, 0, nfiles, &join);
+    else
+      _ncm_mset_catalog_stream_join_read_loop (0, nfiles, &join);
+
+    /* Interleave: time, then file, then chain. */
+    for (c = 0; c < join.ncols; c++)
+    {
+      gdouble *ocol = &obuf[c * nout];
+      glong o       = 0;
+
+      for (t = join.t0; t < join.t1; t++)
+      {
+        for (k = 0; k < nfiles; k++)
+        {
+          const glong len = _ncm_mset_catalog_stream_join_seg (&join, k);
+
+          if (t < join.max_time[k])
+          {
+            const gdouble *icol = &join.bufs[k][c * len + (t - join.t0) * join.nchains];
+            memcpy (&ocol[o], icol, sizeof (gdouble) * join.nchains);
+            o += join.nchains;
+          }
+        }
+      }
+
+      g_assert_cmpint (o, ==, nout);
+
+      fits_write_col_dbl (optr, c + 1, out_row + 1, 1, nout, ocol, &status);
+      NCM_FITS_ERROR (status);
+    }
+
+    out_row += nout;
+  }
+
+  fits_close_file (optr, &status);
+  NCM_FITS_ERROR (status);
+
+  for (k = 0; k < nfiles; k++)
+  {
+    _ncm_mset_catalog_stream_close (join.fptrs[k]);
+    g_free (join.bufs[k]);
+  }
+
+  g_free (obuf);
+  g_free (join.fptrs);
+  g_free (join.bufs);
+  g_free (join.max_time);
+  g_ptr_array_unref (col_names);
+  g_ptr_array_unref (tform_array);
+  ncm_mset_free (mset);
+#else
+  g_error ("ncm_mset_catalog_stream_join: cannot join catalogs without cfitsio.");
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+}
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *            ncm_mset_catalog_stream.h
+ *
+ *  Sun October 18 18:02:17 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * ncm_mset_catalog_stream.h
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NCM_MSET_CATALOG_STREAM_H_
+#define _NCM_MSET_CATALOG_STREAM_H_
+
+#include <glib.h>
+#include <glib-object.h>
+#include <numcosmo/build_cfg.h>
+#include <numcosmo/math/ncm_stats_vec.h>
+#include <numcosmo/math/ncm_mset_catalog.h>
+
+G_BEGIN_DECLS
+
+#define NCM_TYPE_MSET_CATALOG_STREAM             (ncm_mset_catalog_stream_get_type ())
+#define NCM_MSET_CATALOG_STREAM(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), NCM_TYPE_MSET_CATALOG_STREAM, NcmMSetCatalogStream))
+#define NCM_MSET_CATALOG_STREAM_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), NCM_TYPE_MSET_CATALOG_STREAM, NcmMSetCatalogStreamClass))
+#define NCM_IS_MSET_CATALOG_STREAM(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NCM_TYPE_MSET_CATALOG_STREAM))
+#define NCM_IS_MSET_CATALOG_STREAM_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), NCM_TYPE_MSET_CATALOG_STREAM))
+#define NCM_MSET_CATALOG_STREAM_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), NCM_TYPE_MSET_CATALOG_STREAM, NcmMSetCatalogStreamClass))
+
+typedef struct _NcmMSetCatalogStreamClass NcmMSetCatalogStreamClass;
+typedef struct _NcmMSetCatalogStream NcmMSetCatalogStream;
+typedef struct _NcmMSetCatalogStreamPrivate NcmMSetCatalogStreamPrivate;
+
+struct _NcmMSetCatalogStreamClass
+{
+  /*< private >*/
+  GObjectClass parent_class;
+};
+
+struct _NcmMSetCatalogStream
+{
+  /*< private >*/
+  GObject parent_instance;
+  NcmMSetCatalogStreamPrivate *priv;
+};
+
+GType ncm_mset_catalog_stream_get_type (void) G_GNUC_CONST;
+
+NcmMSetCatalogStream *ncm_mset_catalog_stream_new (const gchar *filename, guint nbins);
+NcmMSetCatalogStream *ncm_mset_catalog_stream_ref (NcmMSetCatalogStream *mcs);
+void ncm_mset_catalog_stream_free (NcmMSetCatalogStream *mcs);
+void ncm_mset_catalog_stream_clear (NcmMSetCatalogStream **mcs);
+
+void ncm_mset_catalog_stream_reset (NcmMSetCatalogStream *mcs);
+void ncm_mset_catalog_stream_add_file (NcmMSetCatalogStream *mcs, const gchar *filename, glong burnin, guint chunk_size);
+void ncm_mset_catalog_stream_add_files (NcmMSetCatalogStream *mcs, gchar **filenames, const glong *burnins, guint chunk_size);
+void ncm_mset_catalog_stream_merge (NcmMSetCatalogStream *mcs, NcmMSetCatalogStream *src);
+
+guint ncm_mset_catalog_stream_ncols (NcmMSetCatalogStream *mcs);
+guint ncm_mset_catalog_stream_nchains (NcmMSetCatalogStream *mcs);
+guint64 ncm_mset_catalog_stream_nrows (NcmMSetCatalogStream *mcs);
+const gchar *ncm_mset_catalog_stream_col_name (NcmMSetCatalogStream *mcs, guint i);
+gboolean ncm_mset_catalog_stream_col_by_name (NcmMSetCatalogStream *mcs, const gchar *name, guint *col_index);
+gboolean ncm_mset_catalog_stream_col_has_hist (NcmMSetCatalogStream *mcs, guint i);
+
+NcmStatsVec *ncm_mset_catalog_stream_peek_stats (NcmMSetCatalogStream *mcs);
+gdouble ncm_mset_catalog_stream_get_quantile (NcmMSetCatalogStream *mcs, guint i, const gdouble p);
+void ncm_mset_catalog_stream_log_stats (NcmMSetCatalogStream *mcs);
+
+void ncm_mset_catalog_stream_join (gchar **filenames, const glong *burnins, const gchar *out, guint chunk_size);
+
+#define NCM_MSET_CATALOG_STREAM_DEFAULT_NBINS (1000)
+#define NCM_MSET_CATALOG_STREAM_DEFAULT_CHUNK_SIZE (1 << 16)
+
+G_END_DECLS
+
+#endif /* _NCM_MSET_CATALOG_STREAM_H_ */
@@ -39,6 +39,9 @@
 
 #include "math/ncm_mset_func.h"
 #include "math/ncm_util.h"
+#include "math/ncm_serialize.h"
+#include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
 
 enum
 {
@@ -479,6 +482,197 @@ ncm_mset_func_numdiff_fparams (NcmMSetFunc *func, NcmMSet *mset, const gdouble *
   g_array_unref (grad_a);
 }
 
+typedef struct _NcmMSetFuncBatch
+{
+  NcmMSetFunc *func;
+  NcmMSet *mset;
+  NcmMatrix *fparams;
+  guint offset;
+  const gdouble *x;
+  NcmVector *x_v;
+  NcmMatrix *res;
+  NcmMemoryPool *mp;
+  NcmSerialize *ser;
+  GMutex dup_lock;
+} NcmMSetFuncBatch;
+
+typedef struct _NcmMSetFuncBatchWorker
+{
+  NcmMSetFunc *func;
+  NcmMSet *mset;
+} NcmMSetFuncBatchWorker;
+
+static void
+_ncm_mset_func_batch_eval_rows (NcmMSetFuncBatch *batch, NcmMSetFunc *func, NcmMSet *mset, glong i, glong f)
+{
+  const gdouble *x = (func->eval_x != NULL) ? ncm_vector_data (func->eval_x) : batch->x;
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    NcmVector *row = ncm_matrix_get_row (batch->fparams, k);
+
+    ncm_mset_fparams_set_vector_offset (mset, row, batch->offset);
+
+    if (batch->x_v != NULL)
+    {
+      const guint len = ncm_vector_len (batch->x_v);
+      guint j;
+
+      for (j = 0; j < len; j++)
+        NCM_MSET_FUNC_GET_CLASS (func)->eval (func, mset, ncm_vector_ptr (batch->x_v, j), ncm_matrix_ptr (batch->res, k, j));
+    }
+    else
+      NCM_MSET_FUNC_GET_CLASS (func)->eval (func, mset, x, ncm_matrix_ptr (batch->res, k, 0));
+
+    ncm_vector_free (row);
+  }
+}
+
+static gpointer
+_ncm_mset_func_batch_worker_dup (gpointer userdata)
+{
+  NcmMSetFuncBatch *batch    = (NcmMSetFuncBatch *) userdata;
+  NcmMSetFuncBatchWorker *bw = g_new (NcmMSetFuncBatchWorker, 1);
+
+  g_mutex_lock (&batch->dup_lock);
+
+  bw->mset = ncm_mset_dup (batch->mset, batch->ser);
+  bw->func = NCM_MSET_FUNC (ncm_serialize_dup_obj (batch->ser, G_OBJECT (batch->func)));
+  ncm_serialize_reset (batch->ser, TRUE);
+
+  g_mutex_unlock (&batch->dup_lock);
+
+  return bw;
+}
+
+static void
+_ncm_mset_func_batch_worker_free (gpointer userdata)
+{
+  NcmMSetFuncBatchWorker *bw = (NcmMSetFuncBatchWorker *) userdata;
+
+  ncm_mset_func_clear (&bw->func);
+  ncm_mset_clear (&bw->mset);
+  g_free (bw);
+}
+
+static void
+_ncm_mset_func_batch_mt_eval (glong i, glong f, gpointer data)
+{
+  NcmMSetFuncBatch *batch        = (NcmMSetFuncBatch *) data;
+  NcmMSetFuncBatchWorker **bw_ptr = ncm_memory_pool_get (batch->mp);
+  NcmMSetFuncBatchWorker *bw      = *bw_ptr;
+
+  _ncm_mset_func_batch_eval_rows (batch, bw->func, bw->mset, i, f);
+
+  ncm_memory_pool_return (bw_ptr);
+}
+
+static void
+_ncm_mset_func_batch_run (NcmMSetFuncBatch *batch, guint nthreads)
+{
+  const guint nrows = ncm_matrix_nrows (batch->fparams);
+
+  g_assert_cmpuint (ncm_matrix_nrows (batch->res), ==, nrows);
+  g_assert_cmpuint (ncm_matrix_ncols (batch->fparams), >=, batch->offset + ncm_mset_fparams_len (batch->mset));
+
+  if (nrows == 0)
+    return;
+
+  nthreads = (nrows > nthreads) ? nthreads : (nrows - 1);
+
+  if (nthreads <= 1)
+  {
+    NcmVector *save_params = ncm_vector_new (ncm_mset_fparams_len (batch->mset));
+
+    ncm_mset_fparams_get_vector (batch->mset, save_params);
+    _ncm_mset_func_batch_eval_rows (batch, batch->func, batch->mset, 0, nrows);
+    ncm_mset_fparams_set_vector (batch->mset, save_params);
+
+    ncm_vector_free (save_params);
+  }
+  else
+  {
+    batch->ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+    batch->mp  = ncm_memory_pool_new (&_ncm_mset_func_batch_worker_dup, batch, &_ncm_mset_func_batch_worker_free);
+    g_mutex_init (&batch->dup_lock);
+
+    ncm_func_eval_threaded_loop_nw (&_ncm_mset_func_batch_mt_eval, 0, nrows, batch, nthreads);
+
+    ncm_memory_pool_free (batch->mp, TRUE);
+    ncm_serialize_clear (&batch->ser);
+    g_mutex_clear (&batch->dup_lock);
+  }
+}
+
+/**
+ * ncm_mset_func_eval_batch:
+ * @func: a #NcmMSetFunc
+ * @mset: a #NcmMSet
+ * @fparams: a #NcmMatrix containing one parameter point per row
+ * @offset: column of @fparams where the free parameters start
+ * @x: (array) (element-type double) (allow-none): arguments of @func
+ * @res: a #NcmMatrix to store the results
+ * @nthreads: number of threads
+ *
+ * Evaluates @func at @x for each row of @fparams, the $i$-th row of @res
+ * receives the @func dimension values obtained setting the free parameters
+ * of @mset to the columns [@offset, @offset + fparams_len) of the $i$-th row
+ * of @fparams. The rows of a #NcmMSetCatalog, for example, have the
+ * free parameters at the offset given by ncm_mset_catalog_nadd_vals().
+ * As in ncm_mset_func_eval(), when an evaluation point was set by
+ * ncm_mset_func_set_eval_x() it is used and @x is ignored.
+ * 
+ * If @nthreads is larger than one the rows are split among @nthreads workers,
+ * each one evaluating a copy of @func and @mset obtained through
+ * #NcmSerialize, in this case @func must be serializable (all the
+ * #NcmMSetFuncList functions are) and @mset is not modified. Otherwise the
+ * rows are evaluated using @mset and its free parameters are restored at the
+ * end.
+ *
+ */
+void
+ncm_mset_func_eval_batch (NcmMSetFunc *func, NcmMSet *mset, NcmMatrix *fparams, guint offset, const gdouble *x, NcmMatrix *res, guint nthreads)
+{
+  NcmMSetFuncBatch batch = {func, mset, fparams, offset, x, NULL, res, NULL, NULL, };
+
+  g_assert_cmpuint (ncm_matrix_ncols (res), >=, func->dim);
+
+  if ((func->eval_x != NULL) && (x != NULL))
+    g_warning ("ncm_mset_func_eval_batch: function called with arguments while an eval x was already used, ignoring argument.");
+
+  _ncm_mset_func_batch_run (&batch, nthreads);
+}
+
+/**
+ * ncm_mset_func_eval_vector_batch:
+ * @func: a #NcmMSetFunc
+ * @mset: a #NcmMSet
+ * @fparams: a #NcmMatrix containing one parameter point per row
+ * @offset: column of @fparams where the free parameters start
+ * @x_v: a #NcmVector of arguments of @func
+ * @res: a #NcmMatrix to store the results
+ * @nthreads: number of threads
+ *
+ * Same as ncm_mset_func_eval_batch() for a one dimensional and one variable
+ * function evaluated at each element of @x_v, i.e., the batch version of
+ * ncm_mset_func_eval_vector(). The element $(i, j)$ of @res receives
+ * @func evaluated at the $j$-th element of @x_v using the parameters in the
+ * $i$-th row of @fparams.
+ *
+ */
+void
+ncm_mset_func_eval_vector_batch (NcmMSetFunc *func, NcmMSet *mset, NcmMatrix *fparams, guint offset, NcmVector *x_v, NcmMatrix *res, guint nthreads)
+{
+  NcmMSetFuncBatch batch = {func, mset, fparams, offset, NULL, x_v, res, NULL, NULL, };
+
+  g_assert_cmpuint (func->dim,  ==, 1);
+  g_assert_cmpuint (func->nvar, ==, 1);
+  g_assert_cmpuint (ncm_matrix_ncols (res), >=, ncm_vector_len (x_v));
+
+  _ncm_mset_func_batch_run (&batch, nthreads);
+}
+
 /**
  * ncm_mset_func_get_nvar:
  * @func: a #NcmMSetFunc
@@ -84,6 +84,9 @@ NCM_INLINE gdouble ncm_mset_func_eval0 (NcmMSetFunc *func, NcmMSet *mset);
 NCM_INLINE gdouble ncm_mset_func_eval1 (NcmMSetFunc *func, NcmMSet *mset, const gdouble x);
 NCM_INLINE void ncm_mset_func_eval_vector (NcmMSetFunc *func, NcmMSet *mset, NcmVector *x_v, NcmVector *res_v);
 
+void ncm_mset_func_eval_batch (NcmMSetFunc *func, NcmMSet *mset, NcmMatrix *fparams, guint offset, const gdouble *x, NcmMatrix *res, guint nthreads);
+void ncm_mset_func_eval_vector_batch (NcmMSetFunc *func, NcmMSet *mset, NcmMatrix *fparams, guint offset, NcmVector *x_v, NcmMatrix *res, guint nthreads);
+
 void ncm_mset_func_set_eval_x (NcmMSetFunc *func, gdouble *x, guint len);
 
 gboolean ncm_mset_func_is_scalar (NcmMSetFunc *func);
@@ -30,6 +30,17 @@
  *
  * This object encapsulates the GSL pseudo random number generator (PRNG). The purpose is to
  * add support for saving and loading state and multhreading.
+ *
+ * Sharing a single #NcmRNG among threads requires locking it (see ncm_rng_lock()), which
+ * serializes the sampling. Alternatively, ncm_rng_substream_new() and ncm_rng_substream_set()
+ * provide independent substreams indexed by a 64-bit integer (e.g., the sample index).
+ * They use the counter-based generator Philox4x32-10 [Salmon et al. (2011)][XSalmon2011],
+ * registered here with the name #NCM_RNG_SUBSTREAM_ALGO. The key of the generator
+ * is the seed of the parent #NcmRNG and the upper half of the counter is the substream
+ * index, therefore, the numbers generated by a substream depend only on the parent seed and on
+ * the index. Setting a substream does not touch the parent state and requires no locks, each
+ * thread can keep its own substream object and the results are identical regardless of the
+ * number of threads or the order in which the indexes are processed.
  * 
  */
 
@@ -41,6 +52,121 @@
 #include "math/ncm_rng.h"
 #include "math/ncm_cfg.h"
 
+/*
+ * Philox4x32-10 counter-based generator, see Salmon, Moraes, Dror & Shaw,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC'11 (2011).
+ */
+
+#define NCM_RNG_PHILOX_M0 (0xD2511F53U)
+#define NCM_RNG_PHILOX_M1 (0xCD9E8D57U)
+#define NCM_RNG_PHILOX_W0 (0x9E3779B9U)
+#define NCM_RNG_PHILOX_W1 (0xBB67AE85U)
+
+typedef struct _NcmRNGPhiloxState
+{
+  guint32 ctr[4];
+  guint32 key[2];
+  guint32 out[4];
+  guint idx;
+} NcmRNGPhiloxState;
+
+/**
+ * ncm_rng_philox4x32_10:
+ * @ctr_in: (array fixed-size=4): counter
+ * @key_in: (array fixed-size=2): key
+ * @out: (out caller-allocates) (array fixed-size=4): output block
+ * 
+ * Applies the Philox4x32-10 bijection to the counter @ctr_in using the key @key_in
+ * and writes the four resulting 32-bit words in @out. This is the block function
+ * behind the #NCM_RNG_SUBSTREAM_ALGO generator, it is exported mainly to check the
+ * implementation against the known answers of the reference implementation.
+ * 
+ */
+void
+ncm_rng_philox4x32_10 (const guint32 *ctr_in, const guint32 *key_in, guint32 *out)
+{
+  guint32 ctr[4] = {ctr_in[0], ctr_in[1], ctr_in[2], ctr_in[3]};
+  guint32 key[2] = {key_in[0], key_in[1]};
+  guint r;
+
+  for (r = 0; r < 10; r++)
+  {
+    const guint64 p0 = (guint64) NCM_RNG_PHILOX_M0 * ctr[0];
+    const guint64 p1 = (guint64) NCM_RNG_PHILOX_M1 * ctr[2];
+    const guint32 hi0 = p0 >> 32;
+    const guint32 lo0 = (guint32) p0;
+    const guint32 hi1 = p1 >> 32;
+    const guint32 lo1 = (guint32) p1;
+
+    ctr[0] = hi1 ^ ctr[1] ^ key[0];
+    ctr[1] = lo1;
+    ctr[2] = hi0 ^ ctr[3] ^ key[1];
+    ctr[3] = lo0;
+
+    key[0] += NCM_RNG_PHILOX_W0;
+    key[1] += NCM_RNG_PHILOX_W1;
+  }
+
+  out[0] = ctr[0];
+  out[1] = ctr[1];
+  out[2] = ctr[2];
+  out[3] = ctr[3];
+}
+
+static void
+_ncm_rng_philox_set (void *vstate, unsigned long int seed)
+{
+  NcmRNGPhiloxState *state = (NcmRNGPhiloxState *) vstate;
+  const guint64 seed64     = seed;
+
+  state->key[0] = (guint32) seed64;
+  state->key[1] = (guint32) (seed64 >> 32);
+  state->ctr[0] = 0;
+  state->ctr[1] = 0;
+  state->ctr[2] = 0;
+  state->ctr[3] = 0;
+  state->idx    = 4;
+}
+
+static unsigned long int
+_ncm_rng_philox_get (void *vstate)
+{
+  NcmRNGPhiloxState *state = (NcmRNGPhiloxState *) vstate;
+
+  if (state->idx == 4)
+  {
+    ncm_rng_philox4x32_10 (state->ctr, state->key, state->out);
+
+    /* Only the lower half of the counter is incremented, the upper half is the substream index. */
+    state->ctr[0]++;
+    if (state->ctr[0] == 0)
+      state->ctr[1]++;
+
+    state->idx = 0;
+  }
+
+  return state->out[state->idx++];
+}
+
+static double
+_ncm_rng_philox_get_double (void *vstate)
+{
+  return _ncm_rng_philox_get (vstate) / 4294967296.0;
+}
+
+static const gsl_rng_type _ncm_rng_philox_type =
+{
+  NCM_RNG_SUBSTREAM_ALGO,
+  0xffffffffUL,
+  0,
+  sizeof (NcmRNGPhiloxState),
+  &_ncm_rng_philox_set,
+  &_ncm_rng_philox_get,
+  &_ncm_rng_philox_get_double
+};
+
+G_LOCK_DEFINE_STATIC (seed_hash_lock);
+
 enum
 {
   PROP_0,
@@ -338,9 +464,12 @@ ncm_rng_set_algo (NcmRNG *rng, const gchar *algo)
         break;
       }
     }
-    if (!found)
+    if (found)
+      type = *t;
+    else if (strcmp (_ncm_rng_philox_type.name, algo) == 0)
+      type = &_ncm_rng_philox_type;
+    else
       g_error ("ncm_rng_set_algo: cannot find algorithm %s.", algo);
-    type = *t;
   }
   else
     type = gsl_rng_default;
@@ -390,7 +519,12 @@ ncm_rng_check_seed (NcmRNG *rng, gulong seed)
 {
   NcmRNGClass *rng_class = NCM_RNG_GET_CLASS (rng);
   gint seed_int = seed;
-  gpointer b = g_hash_table_lookup (rng_class->seed_hash, GINT_TO_POINTER (seed_int));
+  gpointer b;
+
+  G_LOCK (seed_hash_lock);
+  b = g_hash_table_lookup (rng_class->seed_hash, GINT_TO_POINTER (seed_int));
+  G_UNLOCK (seed_hash_lock);
+
   return GPOINTER_TO_INT (b) == 0;
 }
 
@@ -411,7 +545,11 @@ ncm_rng_set_seed (NcmRNG *rng, gulong seed)
     NcmRNGClass *rng_class = NCM_RNG_GET_CLASS (rng);    
     gint seed_int = seed;
     gsl_rng_set (rng->r, seed);
+
+    G_LOCK (seed_hash_lock);
     g_hash_table_insert (rng_class->seed_hash, GINT_TO_POINTER (seed_int), GINT_TO_POINTER (1));
+    G_UNLOCK (seed_hash_lock);
+
     rng->seed_set = TRUE;
   }
 }
@@ -450,6 +588,58 @@ ncm_rng_set_random_seed (NcmRNG *rng, gboolean allow_colisions)
   ncm_rng_set_seed (rng, seed);
 }
 
+/**
+ * ncm_rng_substream_new:
+ * @rng: a #NcmRNG
+ * @index: substream index
+ * 
+ * Creates a new #NcmRNG using the #NCM_RNG_SUBSTREAM_ALGO algorithm and sets it
+ * to the substream @index of @rng, see ncm_rng_substream_set().
+ * 
+ * Returns: (transfer full): a new #NcmRNG.
+ */
+NcmRNG *
+ncm_rng_substream_new (NcmRNG *rng, guint64 index)
+{
+  NcmRNG *sub = g_object_new (NCM_TYPE_RNG,
+                              "algorithm", NCM_RNG_SUBSTREAM_ALGO,
+                              NULL);
+
+  ncm_rng_substream_set (rng, sub, index);
+
+  return sub;
+}
+
+/**
+ * ncm_rng_substream_set:
+ * @rng: a #NcmRNG
+ * @sub: a #NcmRNG using the #NCM_RNG_SUBSTREAM_ALGO algorithm
+ * @index: substream index
+ * 
+ * Sets @sub to the beginning of the substream @index of @rng. The
+ * substream is determined by the seed of @rng and @index only, the
+ * state of @rng is neither used nor changed. This function does not
+ * lock @rng and can be called concurrently from different threads
+ * as long as each thread uses its own @sub.
+ * 
+ */
+void
+ncm_rng_substream_set (NcmRNG *rng, NcmRNG *sub, guint64 index)
+{
+  NcmRNGPhiloxState *state;
+
+  g_assert (gsl_rng_name (sub->r) == _ncm_rng_philox_type.name);
+
+  state = (NcmRNGPhiloxState *) gsl_rng_state (sub->r);
+  _ncm_rng_philox_set (state, rng->seed_val);
+
+  state->ctr[2] = (guint32) index;
+  state->ctr[3] = (guint32) (index >> 32);
+
+  sub->seed_val = rng->seed_val;
+  sub->seed_set = TRUE;
+}
+
 static GHashTable *rng_table = NULL;
 
 /**
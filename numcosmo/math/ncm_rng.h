@@ -84,8 +84,14 @@ void ncm_rng_set_seed (NcmRNG *rng, gulong seed);
 gulong ncm_rng_get_seed (NcmRNG *rng);
 void ncm_rng_set_random_seed (NcmRNG *rng, gboolean allow_colisions);
 
+NcmRNG *ncm_rng_substream_new (NcmRNG *rng, guint64 index);
+void ncm_rng_substream_set (NcmRNG *rng, NcmRNG *sub, guint64 index);
+void ncm_rng_philox4x32_10 (const guint32 *ctr_in, const guint32 *key_in, guint32 *out);
+
 NcmRNG *ncm_rng_pool_get (const gchar *name);
 
+#define NCM_RNG_SUBSTREAM_ALGO "ncm_philox4x32_10"
+
 NCM_INLINE gdouble ncm_rng_uniform_gen (NcmRNG *rng, const gdouble xl, const gdouble xu); 
 NCM_INLINE gdouble ncm_rng_gaussian_gen (NcmRNG *rng, const gdouble mu, const gdouble sigma); 
 NCM_INLINE gdouble ncm_rng_ugaussian_gen (NcmRNG *rng); 
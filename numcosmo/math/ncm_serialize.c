@@ -856,33 +856,35 @@ ncm_serialize_from_file (NcmSerialize *ser, const gchar *filename)
 GObject *
 ncm_serialize_from_binfile (NcmSerialize *ser, const gchar *filename)
 {
-  GError *error = NULL;
-  gchar *file   = NULL;
-  gsize length  = 0;
-  GObject *obj  = NULL;
+  GError *error     = NULL;
+  GMappedFile *file = NULL;
+  GObject *obj      = NULL;
 
   g_assert (filename != NULL);
-  
-  if (!g_file_get_contents (filename, &file, &length, &error))
-    g_error ("_nc_data_snia_cov_load_matrix: cannot open file %s: %s",
+
+  /* 
+   * The file is mapped instead of read, the arrays are copied directly 
+   * from the mapped pages to the new objects.
+   */
+  file = g_mapped_file_new (filename, FALSE, &error);
+  if (file == NULL)
+    g_error ("ncm_serialize_from_binfile: cannot open file %s: %s",
              filename, error->message);
 
-  g_assert_cmpint (length, >, 0);
+  g_assert_cmpint (g_mapped_file_get_length (file), >, 0);
 
   {
-    GVariant *obj_ser = g_variant_new_from_data (G_VARIANT_TYPE (NCM_SERIALIZE_OBJECT_TYPE),
-                                                 file,
-                                                 length,
-                                                 TRUE,
-                                                 g_free,
-                                                 file
-                                                 );
+    GBytes *bytes     = g_mapped_file_get_bytes (file);
+    GVariant *obj_ser = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (NCM_SERIALIZE_OBJECT_TYPE), bytes, TRUE));
 
     obj = ncm_serialize_from_variant (ser, obj_ser);
 
     g_variant_unref (obj_ser);
+    g_bytes_unref (bytes);
   }
 
+  g_mapped_file_unref (file);
+
   return obj;
 }
 
@@ -1254,6 +1256,22 @@ ncm_serialize_to_variant (NcmSerialize *ser, GObject *obj)
   gchar *obj_name = g_strdup (G_OBJECT_TYPE_NAME (obj));
   gchar *saved_name = NULL;
 
+  if ((ser->opts & NCM_SERIALIZE_OPT_SHARE_ARRAYS) && 
+      (NCM_IS_VECTOR (obj) || NCM_IS_MATRIX (obj)) &&
+      !ncm_serialize_contain_instance (ser, obj))
+  {
+    /*
+     * Arrays are added to the named instances, the deserialization 
+     * will then return the same object instead of copying its values.
+     */
+    gchar *name = g_strdup_printf (NCM_SERIALIZE_AUTOSAVE_NAME NCM_SERIALIZE_AUTOSAVE_NFORMAT, ser->autosave_count);
+    
+    ncm_serialize_set (ser, obj, name, FALSE);
+    ser->autosave_count++;
+
+    g_free (name);
+  }
+
   if (ncm_serialize_contain_instance (ser, obj))
   {
     gchar *ni_name = ncm_serialize_peek_name (ser, obj);
@@ -55,6 +55,7 @@ struct _NcmSerializeClass
  * @NCM_SERIALIZE_OPT_AUTOSAVE_SER: Whether to automatically include named deserialized objects in the named instances.
  * @NCM_SERIALIZE_OPT_AUTONAME_SER: Whether to automatically name objects on serialization.
  * @NCM_SERIALIZE_OPT_CLEAN_DUP: Combination of NCM_SERIALIZE_OPT_AUTOSAVE_SER and NCM_SERIALIZE_OPT_AUTONAME_SER
+ * @NCM_SERIALIZE_OPT_SHARE_ARRAYS: Whether to serialize #NcmVector and #NcmMatrix objects as references to the original instances, only valid for in-process duplication.
  *
  * Options for serialization.
  *
@@ -65,6 +66,7 @@ typedef enum _NcmSerializeOpt
   NCM_SERIALIZE_OPT_AUTOSAVE_SER = 1 << 0,
   NCM_SERIALIZE_OPT_AUTONAME_SER = 1 << 1,
   NCM_SERIALIZE_OPT_CLEAN_DUP    = NCM_SERIALIZE_OPT_AUTOSAVE_SER | NCM_SERIALIZE_OPT_AUTONAME_SER,
+  NCM_SERIALIZE_OPT_SHARE_ARRAYS = 1 << 2,
 } NcmSerializeOpt;
 
 struct _NcmSerialize
@@ -45,9 +45,12 @@
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_math.h>
+#include <gsl/gsl_sf_bessel.h>
 #include <mpfr.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
+#define NCM_SF_SBESSEL_TABLE_TOL 1.0e-12
+
 /**
  * ncm_sf_sbessel_recur_new: (skip)
  * @x_grid: a #NcmGrid
@@ -480,3 +483,176 @@ ncm_sf_sbessel_spline (gulong l, gdouble xi, gdouble xf, gdouble reltol)
 	ncm_spline_set_func (s, NCM_SPLINE_FUNCTION_SPLINE, &F, xi, xf, 0, reltol);
 	return s;
 }
+
+/**
+ * ncm_sf_sbessel_table_new: (skip)
+ * @lmax: largest multipole $\ell_\mathrm{max}$
+ * @xmax: largest argument $x_\mathrm{max}$
+ * @dx: grid spacing
+ *
+ * Tabulates $j_\ell(x)$ and its derivative for all $0 \leq \ell \leq \ell_\mathrm{max}$
+ * on the uniform grid $x_i = i\,\mathrm{d}x$ covering $[0, x_\mathrm{max}]$.
+ * All multipoles at a given $x_i$ are obtained at once through Steed's
+ * method, which, unlike the upward recurrence, is stable for $x < \ell$.
+ * For each $\ell$ only the nodes from the one preceding the first node
+ * where $\vert j_\ell\vert$ exceeds #NCM_SF_SBESSEL_TABLE_TOL onwards are
+ * stored, contiguously in $x$, see ncm_sf_sbessel_table_get_xmin().
+ *
+ * Returns: (transfer full): a new #NcmSFSBesselTable.
+ */
+NcmSFSBesselTable *
+ncm_sf_sbessel_table_new (guint lmax, gdouble xmax, gdouble dx)
+{
+  NcmSFSBesselTable *jltab = g_new (NcmSFSBesselTable, 1);
+  gdouble *jl_x            = g_new (gdouble, lmax + 2);
+  gdouble *jl_prev         = g_new (gdouble, lmax + 1);
+  gdouble *djl_prev        = g_new (gdouble, lmax + 1);
+  guint i, l;
+
+  g_assert_cmpfloat (dx, >, 0.0);
+  g_assert_cmpfloat (xmax, >, dx);
+
+  jltab->lmax = lmax;
+  jltab->dx   = dx;
+  jltab->nx   = ceil (xmax / dx) + 2;
+  jltab->xmax = (jltab->nx - 1) * dx;
+  jltab->jl   = g_new0 (gdouble *, lmax + 1);
+  jltab->djl  = g_new0 (gdouble *, lmax + 1);
+  jltab->imin = g_new (guint, lmax + 1);
+
+  for (l = 0; l <= lmax; l++)
+  {
+    jl_prev[l]     = (l == 0) ? 1.0 : 0.0;
+    djl_prev[l]    = (l == 1) ? 1.0 / 3.0 : 0.0;
+    jltab->imin[l] = 0;
+
+    if (l <= 1)
+    {
+      jltab->jl[l]     = g_new (gdouble, jltab->nx);
+      jltab->djl[l]    = g_new (gdouble, jltab->nx);
+      jltab->jl[l][0]  = jl_prev[l];
+      jltab->djl[l][0] = djl_prev[l];
+    }
+  }
+
+  for (i = 1; i < jltab->nx; i++)
+  {
+    const gdouble x = i * dx;
+    gint ret        = gsl_sf_bessel_jl_steed_array (lmax + 1, x, jl_x);
+
+    if (ret != GSL_SUCCESS)
+      g_error ("ncm_sf_sbessel_table_new: failed to compute j_l(%g) up to l = %u.", x, lmax + 1);
+
+    for (l = 0; l <= lmax; l++)
+    {
+      const gdouble djl_x = l * jl_x[l] / x - jl_x[l + 1];
+
+      if (jltab->jl[l] == NULL)
+      {
+        if ((fabs (jl_x[l]) > NCM_SF_SBESSEL_TABLE_TOL) || (i == jltab->nx - 1))
+        {
+          const guint len = jltab->nx - i + 1;
+
+          jltab->imin[l]   = i - 1;
+          jltab->jl[l]     = g_new (gdouble, len);
+          jltab->djl[l]    = g_new (gdouble, len);
+          jltab->jl[l][0]  = jl_prev[l];
+          jltab->djl[l][0] = djl_prev[l];
+        }
+        else
+        {
+          jl_prev[l]  = jl_x[l];
+          djl_prev[l] = djl_x;
+          continue;
+        }
+      }
+
+      jltab->jl[l][i - jltab->imin[l]]  = jl_x[l];
+      jltab->djl[l][i - jltab->imin[l]] = djl_x;
+    }
+  }
+
+  g_free (jl_x);
+  g_free (jl_prev);
+  g_free (djl_prev);
+
+  return jltab;
+}
+
+/**
+ * ncm_sf_sbessel_table_free:
+ * @jltab: a #NcmSFSBesselTable
+ *
+ * Frees @jltab.
+ *
+ */
+void
+ncm_sf_sbessel_table_free (NcmSFSBesselTable *jltab)
+{
+  guint l;
+
+  for (l = 0; l <= jltab->lmax; l++)
+  {
+    g_free (jltab->jl[l]);
+    g_free (jltab->djl[l]);
+  }
+
+  g_free (jltab->jl);
+  g_free (jltab->djl);
+  g_free (jltab->imin);
+  g_free (jltab);
+}
+
+/**
+ * ncm_sf_sbessel_table_eval:
+ * @jltab: a #NcmSFSBesselTable
+ * @l: multipole $\ell$
+ * @x: argument $x$
+ *
+ * Evaluates $j_\ell(x)$ through cubic Hermite interpolation of the
+ * tabulated values and derivatives. Returns zero for $x$ below
+ * ncm_sf_sbessel_table_get_xmin().
+ *
+ * Returns: $j_\ell(x)$.
+ */
+gdouble
+ncm_sf_sbessel_table_eval (NcmSFSBesselTable *jltab, guint l, gdouble x)
+{
+  const gdouble u = x / jltab->dx;
+  const guint i   = (guint) u;
+
+  g_assert_cmpuint (l, <=, jltab->lmax);
+
+  if (i < jltab->imin[l])
+    return 0.0;
+  else if (i >= jltab->nx - 1)
+    return jltab->jl[l][jltab->nx - 1 - jltab->imin[l]];
+  else
+  {
+    const gdouble *jl  = &jltab->jl[l][i - jltab->imin[l]];
+    const gdouble *djl = &jltab->djl[l][i - jltab->imin[l]];
+    const gdouble t    = u - i;
+    const gdouble t2   = t * t;
+    const gdouble t3   = t2 * t;
+    const gdouble h00  = 2.0 * t3 - 3.0 * t2 + 1.0;
+    const gdouble h10  = t3 - 2.0 * t2 + t;
+    const gdouble h01  = -2.0 * t3 + 3.0 * t2;
+    const gdouble h11  = t3 - t2;
+
+    return h00 * jl[0] + h01 * jl[1] + jltab->dx * (h10 * djl[0] + h11 * djl[1]);
+  }
+}
+
+/**
+ * ncm_sf_sbessel_table_get_xmin:
+ * @jltab: a #NcmSFSBesselTable
+ * @l: multipole $\ell$
+ *
+ * Returns: the argument below which $\vert j_\ell(x)\vert$ is negligible.
+ */
+gdouble
+ncm_sf_sbessel_table_get_xmin (NcmSFSBesselTable *jltab, guint l)
+{
+  g_assert_cmpuint (l, <=, jltab->lmax);
+  return jltab->imin[l] * jltab->dx;
+}
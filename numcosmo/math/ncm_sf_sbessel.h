@@ -67,6 +67,31 @@ void ncm_sf_sbessel_deriv (gulong l, gdouble x, gdouble jl, gdouble jlp1, gdoubl
 
 NcmSpline *ncm_sf_sbessel_spline (gulong l, gdouble xi, gdouble xf, gdouble reltol);
 
+typedef struct _NcmSFSBesselTable NcmSFSBesselTable;
+
+/**
+ * NcmSFSBesselTable:
+ *
+ * Table of $j_\ell(x)$ and $j^\prime_\ell(x)$ on a uniform grid in $x$
+ * for all $0 \leq \ell \leq \ell_\mathrm{max}$.
+ */
+struct _NcmSFSBesselTable
+{
+  /*< private >*/
+  guint lmax;
+  guint nx;
+  gdouble xmax;
+  gdouble dx;
+  gdouble **jl;
+  gdouble **djl;
+  guint *imin;
+};
+
+NcmSFSBesselTable *ncm_sf_sbessel_table_new (guint lmax, gdouble xmax, gdouble dx);
+void ncm_sf_sbessel_table_free (NcmSFSBesselTable *jltab);
+gdouble ncm_sf_sbessel_table_eval (NcmSFSBesselTable *jltab, guint l, gdouble x);
+gdouble ncm_sf_sbessel_table_get_xmin (NcmSFSBesselTable *jltab, guint l);
+
 G_END_DECLS
 
 #endif /* _NCM_SF_SBESSEL_H */
@@ -42,6 +42,7 @@
 #include "math/ncm_stats_vec.h"
 #include "math/ncm_c.h"
 #include "math/ncm_lapack.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include "gslextras/cqp/gsl_cqp.h"
@@ -82,8 +83,33 @@ struct _NcmStatsDistNdKDEGaussPrivate
   NcmVector *zeta;
   NcmLapackWS *lapack_ws;
   GArray *ipiv;
+  gdouble cutoff;
+  guint nthreads;
+  gboolean tree_ok;
+  GArray *tree_nodes;
+  GArray *tree_bbox;
+  GArray *tree_perm;
+  GArray *tree_stack;
+  GArray *nb_idx;
+  GArray *nb_d2;
+  GArray *IM_rowptr;
+  GArray *IM_col;
+  GArray *IM_val;
 };
 
+typedef struct _NcmStatsDistNdKDEGaussNode
+{
+  guint start;
+  guint end;
+  gint left;
+  gint right;
+} NcmStatsDistNdKDEGaussNode;
+
+#define _NCM_STATS_DIST_ND_KDE_GAUSS_LEAF_SIZE 16
+#define _NCM_STATS_DIST_ND_KDE_GAUSS_ROW_BLOCK 256
+#define _NCM_STATS_DIST_ND_KDE_GAUSS_SPARSE_RELTOL 1.0e-10
+#define _NCM_STATS_DIST_ND_KDE_GAUSS_SPARSE_MAXITER 10000
+
 enum
 {
   PROP_0,
@@ -91,6 +117,8 @@ enum
   PROP_OVER_SMOOTH,
   PROP_NEARPD_MAXITER,
   PROP_LOOCV,
+  PROP_CUTOFF,
+  PROP_NTHREADS,
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcmStatsDistNdKDEGauss, ncm_stats_dist_nd_kde_gauss, NCM_TYPE_STATS_DIST_ND);
@@ -130,6 +158,18 @@ ncm_stats_dist_nd_kde_gauss_init (NcmStatsDistNdKDEGauss *dndg)
   self->zeta             = NULL;
   self->lapack_ws        = ncm_lapack_ws_new ();
   self->ipiv             = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->cutoff           = 0.0;
+  self->nthreads         = 0;
+  self->tree_ok          = FALSE;
+  self->tree_nodes       = g_array_new (FALSE, FALSE, sizeof (NcmStatsDistNdKDEGaussNode));
+  self->tree_bbox        = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  self->tree_perm        = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->tree_stack       = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->nb_idx           = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->nb_d2            = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  self->IM_rowptr        = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->IM_col           = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->IM_val           = g_array_new (FALSE, FALSE, sizeof (gdouble));
 
   g_ptr_array_set_free_func (self->smatrix_rows, (GDestroyNotify) ncm_vector_free);
 }
@@ -156,6 +196,12 @@ _ncm_stats_dist_nd_kde_gauss_set_property (GObject *object, guint prop_id, const
     case PROP_LOOCV:
       ncm_stats_dist_nd_kde_gauss_set_LOOCV_bandwidth_adj (dndg, g_value_get_boolean (value));
       break;
+    case PROP_CUTOFF:
+      ncm_stats_dist_nd_kde_gauss_set_cutoff (dndg, g_value_get_double (value));
+      break;
+    case PROP_NTHREADS:
+      ncm_stats_dist_nd_kde_gauss_set_nthreads (dndg, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -184,6 +230,12 @@ _ncm_stats_dist_nd_kde_gauss_get_property (GObject *object, guint prop_id, GValu
     case PROP_LOOCV:
       g_value_set_boolean (value, ncm_stats_dist_nd_kde_gauss_get_LOOCV_bandwidth_adj (dndg));
       break;
+    case PROP_CUTOFF:
+      g_value_set_double (value, ncm_stats_dist_nd_kde_gauss_get_cutoff (dndg));
+      break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, ncm_stats_dist_nd_kde_gauss_get_nthreads (dndg));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -218,6 +270,16 @@ _ncm_stats_dist_nd_kde_gauss_dispose (GObject *object)
   ncm_lapack_ws_clear (&self->lapack_ws);
   g_clear_pointer (&self->ipiv, g_array_unref);
 
+  g_clear_pointer (&self->tree_nodes, g_array_unref);
+  g_clear_pointer (&self->tree_bbox, g_array_unref);
+  g_clear_pointer (&self->tree_perm, g_array_unref);
+  g_clear_pointer (&self->tree_stack, g_array_unref);
+  g_clear_pointer (&self->nb_idx, g_array_unref);
+  g_clear_pointer (&self->nb_d2, g_array_unref);
+  g_clear_pointer (&self->IM_rowptr, g_array_unref);
+  g_clear_pointer (&self->IM_col, g_array_unref);
+  g_clear_pointer (&self->IM_val, g_array_unref);
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_stats_dist_nd_kde_gauss_parent_class)->dispose (object);
 }
@@ -282,6 +344,22 @@ ncm_stats_dist_nd_kde_gauss_class_init (NcmStatsDistNdKDEGaussClass *klass)
                                                       "Maximum number of iterations in the nearPD call",
                                                       1, G_MAXUINT, 200,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_CUTOFF,
+                                   g_param_spec_double ("cutoff",
+                                                        NULL,
+                                                        "Kernel truncation in units of the kernel width",
+                                                        0.0, G_MAXDOUBLE, 0.0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used in the truncated kernel matrix",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
   dnd_class->set_dim           = &_ncm_stats_dist_nd_kde_gauss_set_dim;
   dnd_class->prepare           = &_ncm_stats_dist_nd_kde_gauss_prepare;
@@ -346,6 +424,8 @@ _ncm_stats_dist_nd_kde_gauss_prepare_cov (NcmStatsDistNdKDEGaussPrivate * const
 
   ret = gsl_blas_dtrsm (CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, 1.0, ncm_matrix_gsl (self->cov_decomp), ncm_matrix_gsl (self->sample_matrix));
   NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_prepare", ret);  
+
+  self->tree_ok = FALSE;
 }
 
 static void 
@@ -436,6 +516,326 @@ _ncm_stats_dist_nd_kde_gauss_prepare_IM (NcmStatsDistNdKDEGaussPrivate * const s
   }
 }
 
+#define _NCM_KDE_SM_X(self,i,k) (ncm_matrix_get ((self)->sample_matrix, (i), (k)))
+
+static void
+_ncm_stats_dist_nd_kde_gauss_tree_select (NcmStatsDistNdKDEGaussPrivate * const self, guint *perm, gint left, gint right, const gint kth, const guint dim)
+{
+  while (right > left)
+  {
+    const gdouble pivot = _NCM_KDE_SM_X (self, perm[(left + right) / 2], dim);
+    gint i = left;
+    gint j = right;
+
+    while (i <= j)
+    {
+      while (_NCM_KDE_SM_X (self, perm[i], dim) < pivot)
+        i++;
+      while (_NCM_KDE_SM_X (self, perm[j], dim) > pivot)
+        j--;
+
+      if (i <= j)
+      {
+        const guint tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+        i++;
+        j--;
+      }
+    }
+
+    if (kth <= j)
+      right = j;
+    else if (kth >= i)
+      left = i;
+    else
+      break;
+  }
+}
+
+static gint
+_ncm_stats_dist_nd_kde_gauss_tree_build_node (NcmStatsDistNdKDEGaussPrivate * const self, const guint start, const guint end)
+{
+  const gint node_id                 = self->tree_nodes->len;
+  NcmStatsDistNdKDEGaussNode node    = {start, end, -1, -1};
+  guint *perm                        = &g_array_index (self->tree_perm, guint, 0);
+  guint split_dim                    = 0;
+  gdouble max_width                  = 0.0;
+  gdouble *bmin, *bmax;
+  guint i, k;
+
+  g_array_append_val (self->tree_nodes, node);
+  g_array_set_size (self->tree_bbox, self->tree_bbox->len + 2 * self->d);
+
+  bmin = &g_array_index (self->tree_bbox, gdouble, 2 * self->d * node_id);
+  bmax = bmin + self->d;
+
+  for (k = 0; k < self->d; k++)
+  {
+    bmin[k] = GSL_POSINF;
+    bmax[k] = GSL_NEGINF;
+  }
+
+  for (i = start; i < end; i++)
+  {
+    for (k = 0; k < self->d; k++)
+    {
+      const gdouble x_ik = _NCM_KDE_SM_X (self, perm[i], k);
+      bmin[k] = MIN (bmin[k], x_ik);
+      bmax[k] = MAX (bmax[k], x_ik);
+    }
+  }
+
+  for (k = 0; k < self->d; k++)
+  {
+    const gdouble width_k = bmax[k] - bmin[k];
+    if (width_k > max_width)
+    {
+      max_width = width_k;
+      split_dim = k;
+    }
+  }
+
+  if ((end - start > _NCM_STATS_DIST_ND_KDE_GAUSS_LEAF_SIZE) && (max_width > 0.0))
+  {
+    const guint mid = (start + end) / 2;
+    gint left, right;
+
+    _ncm_stats_dist_nd_kde_gauss_tree_select (self, perm, start, end - 1, mid, split_dim);
+
+    left  = _ncm_stats_dist_nd_kde_gauss_tree_build_node (self, start, mid);
+    right = _ncm_stats_dist_nd_kde_gauss_tree_build_node (self, mid, end);
+
+    /* The node array may have been reallocated by the recursive calls */
+    g_array_index (self->tree_nodes, NcmStatsDistNdKDEGaussNode, node_id).left  = left;
+    g_array_index (self->tree_nodes, NcmStatsDistNdKDEGaussNode, node_id).right = right;
+  }
+
+  return node_id;
+}
+
+static void
+_ncm_stats_dist_nd_kde_gauss_tree_prepare (NcmStatsDistNdKDEGaussPrivate * const self)
+{
+  guint i;
+
+  if (self->tree_ok)
+    return;
+
+  g_array_set_size (self->tree_nodes, 0);
+  g_array_set_size (self->tree_bbox, 0);
+  g_array_set_size (self->tree_perm, self->n);
+
+  for (i = 0; i < self->n; i++)
+    g_array_index (self->tree_perm, guint, i) = i;
+
+  _ncm_stats_dist_nd_kde_gauss_tree_build_node (self, 0, self->n);
+
+  self->tree_ok = TRUE;
+}
+
+/*
+ * Finds all sample points (in whitened coordinates) inside the ball
+ * of squared radius r2 around x. The scratch arrays are passed as
+ * arguments so that different threads can query the same tree.
+ */
+static void
+_ncm_stats_dist_nd_kde_gauss_tree_query (NcmStatsDistNdKDEGaussPrivate * const self, const gdouble *x, const gdouble r2, GArray *stack, GArray *nb_idx, GArray *nb_d2)
+{
+  const guint *perm = &g_array_index (self->tree_perm, guint, 0);
+  guint root        = 0;
+
+  g_array_set_size (stack, 0);
+  g_array_set_size (nb_idx, 0);
+  g_array_set_size (nb_d2, 0);
+
+  g_array_append_val (stack, root);
+
+  while (stack->len > 0)
+  {
+    const guint node_id                     = g_array_index (stack, guint, stack->len - 1);
+    const NcmStatsDistNdKDEGaussNode *node  = &g_array_index (self->tree_nodes, NcmStatsDistNdKDEGaussNode, node_id);
+    const gdouble *bmin                     = &g_array_index (self->tree_bbox, gdouble, 2 * self->d * node_id);
+    const gdouble *bmax                     = bmin + self->d;
+    gdouble dmin2                           = 0.0;
+    guint k;
+
+    g_array_set_size (stack, stack->len - 1);
+
+    for (k = 0; k < self->d; k++)
+    {
+      if (x[k] < bmin[k])
+        dmin2 += gsl_pow_2 (bmin[k] - x[k]);
+      else if (x[k] > bmax[k])
+        dmin2 += gsl_pow_2 (x[k] - bmax[k]);
+    }
+
+    if (dmin2 > r2)
+      continue;
+
+    if (node->left < 0)
+    {
+      guint i;
+      for (i = node->start; i < node->end; i++)
+      {
+        const guint j = perm[i];
+        gdouble d2    = 0.0;
+
+        for (k = 0; k < self->d; k++)
+          d2 += gsl_pow_2 (_NCM_KDE_SM_X (self, j, k) - x[k]);
+
+        if (d2 <= r2)
+        {
+          g_array_append_val (nb_idx, j);
+          g_array_append_val (nb_d2, d2);
+        }
+      }
+    }
+    else
+    {
+      const guint left  = node->left;
+      const guint right = node->right;
+      g_array_append_val (stack, right);
+      g_array_append_val (stack, left);
+    }
+  }
+}
+
+typedef struct _NcmStatsDistNdKDEGaussSparseArg
+{
+  NcmStatsDistNdKDEGaussPrivate *self;
+  gboolean fill;
+} NcmStatsDistNdKDEGaussSparseArg;
+
+static void
+_ncm_stats_dist_nd_kde_gauss_sparse_IM_block (glong i, glong f, gpointer data)
+{
+  NcmStatsDistNdKDEGaussSparseArg *arg        = (NcmStatsDistNdKDEGaussSparseArg *) data;
+  NcmStatsDistNdKDEGaussPrivate * const self  = arg->self;
+  const gdouble r2                            = gsl_pow_2 (self->cutoff) * self->href2;
+  GArray *stack                               = g_array_new (FALSE, FALSE, sizeof (guint));
+  GArray *nb_idx                              = g_array_new (FALSE, FALSE, sizeof (guint));
+  GArray *nb_d2                               = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  glong b;
+
+  for (b = i; b < f; b++)
+  {
+    const guint row_i = b * _NCM_STATS_DIST_ND_KDE_GAUSS_ROW_BLOCK;
+    const guint row_f = MIN (row_i + _NCM_STATS_DIST_ND_KDE_GAUSS_ROW_BLOCK, self->n);
+    guint r;
+
+    for (r = row_i; r < row_f; r++)
+    {
+      const gdouble *x_r = ncm_matrix_ptr (self->sample_matrix, r, 0);
+
+      _ncm_stats_dist_nd_kde_gauss_tree_query (self, x_r, r2, stack, nb_idx, nb_d2);
+
+      if (arg->fill)
+      {
+        const guint p0 = g_array_index (self->IM_rowptr, guint, r);
+        guint l;
+
+        g_assert_cmpuint (g_array_index (self->IM_rowptr, guint, r + 1) - p0, ==, nb_idx->len);
+
+        for (l = 0; l < nb_idx->len; l++)
+        {
+          g_array_index (self->IM_col, guint, p0 + l)   = g_array_index (nb_idx, guint, l);
+          g_array_index (self->IM_val, gdouble, p0 + l) = exp (- 0.5 * g_array_index (nb_d2, gdouble, l) / self->href2);
+        }
+      }
+      else
+        g_array_index (self->IM_rowptr, guint, r + 1) = nb_idx->len;
+    }
+  }
+
+  g_array_unref (stack);
+  g_array_unref (nb_idx);
+  g_array_unref (nb_d2);
+}
+
+static void 
+_ncm_stats_dist_nd_kde_gauss_prepare_sparse_IM (NcmStatsDistNdKDEGaussPrivate * const self)
+{
+  const guint nblocks = (self->n + _NCM_STATS_DIST_ND_KDE_GAUSS_ROW_BLOCK - 1) / _NCM_STATS_DIST_ND_KDE_GAUSS_ROW_BLOCK;
+  NcmStatsDistNdKDEGaussSparseArg arg = {self, FALSE};
+  guint i;
+
+  _ncm_stats_dist_nd_kde_gauss_tree_prepare (self);
+
+  g_array_set_size (self->IM_rowptr, self->n + 1);
+  g_array_index (self->IM_rowptr, guint, 0) = 0;
+
+  /* First pass: number of neighbours of each point */
+  if ((self->nthreads > 1) && (nblocks > 1))
+    ncm_func_eval_threaded_loop_full (&_ncm_stats_dist_nd_kde_gauss_sparse_IM_block, 0, nblocks, &arg);
+  else
+    _ncm_stats_dist_nd_kde_gauss_sparse_IM_block (0, nblocks, &arg);
+
+  for (i = 0; i < self->n; i++)
+    g_array_index (self->IM_rowptr, guint, i + 1) += g_array_index (self->IM_rowptr, guint, i);
+
+  g_array_set_size (self->IM_col, g_array_index (self->IM_rowptr, guint, self->n));
+  g_array_set_size (self->IM_val, g_array_index (self->IM_rowptr, guint, self->n));
+
+  /* Second pass: fill the rows in place */
+  arg.fill = TRUE;
+  if ((self->nthreads > 1) && (nblocks > 1))
+    ncm_func_eval_threaded_loop_full (&_ncm_stats_dist_nd_kde_gauss_sparse_IM_block, 0, nblocks, &arg);
+  else
+    _ncm_stats_dist_nd_kde_gauss_sparse_IM_block (0, nblocks, &arg);
+}
+
+/*
+ * Solves the same box constrained problem passed to LowRankQP,
+ * min 1/2 a^T IM a - f^T a with 0 <= a <= 1, using projected
+ * Gauss-Seidel iterations over the truncated (sparse) IM.
+ */
+static void
+_ncm_stats_dist_nd_kde_gauss_sparse_solve (NcmStatsDistNdKDEGaussPrivate * const self, NcmVector *f, NcmVector *alpha)
+{
+  const guint *rowptr = &g_array_index (self->IM_rowptr, guint, 0);
+  const guint *col    = (self->IM_col->len > 0) ? &g_array_index (self->IM_col, guint, 0) : NULL;
+  const gdouble *val  = (self->IM_val->len > 0) ? &g_array_index (self->IM_val, gdouble, 0) : NULL;
+  guint iter;
+
+  ncm_vector_set_zero (alpha);
+
+  for (iter = 0; iter < _NCM_STATS_DIST_ND_KDE_GAUSS_SPARSE_MAXITER; iter++)
+  {
+    gdouble max_delta = 0.0;
+    gdouble max_alpha = 0.0;
+    guint i;
+
+    for (i = 0; i < self->n; i++)
+    {
+      gdouble res_i  = ncm_vector_fast_get (f, i);
+      gdouble diag_i = 1.0;
+      gdouble alpha_i;
+      guint p;
+
+      for (p = rowptr[i]; p < rowptr[i + 1]; p++)
+      {
+        if (col[p] == i)
+          diag_i = val[p];
+        else
+          res_i -= val[p] * ncm_vector_fast_get (alpha, col[p]);
+      }
+
+      alpha_i   = GSL_MIN (GSL_MAX (res_i / diag_i, 0.0), 1.0);
+      max_delta = GSL_MAX (max_delta, fabs (alpha_i - ncm_vector_fast_get (alpha, i)));
+      max_alpha = GSL_MAX (max_alpha, alpha_i);
+
+      ncm_vector_fast_set (alpha, i, alpha_i);
+    }
+
+    if (max_delta <= _NCM_STATS_DIST_ND_KDE_GAUSS_SPARSE_RELTOL * max_alpha)
+      break;
+  }
+
+  if (iter == _NCM_STATS_DIST_ND_KDE_GAUSS_SPARSE_MAXITER)
+    g_warning ("_ncm_stats_dist_nd_kde_gauss_sparse_solve: maximum number of iterations reached (%u).", iter);
+}
+
 static gdouble 
 _ncm_stats_dist_nd_kde_gauss_LOOCV_err2 (gdouble h, gpointer user_data)
 {
@@ -854,7 +1254,6 @@ _ncm_stats_dist_nd_kde_gauss_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2l
     ncm_vector_clear (&self->zeta);
 
     self->A       = ncm_matrix_new (1, self->n);
-    self->IM      = ncm_matrix_new (self->n, self->n);
     self->b       = ncm_vector_new (1);
     self->beta    = ncm_vector_new (1);
     self->dv      = ncm_vector_new (self->n);
@@ -864,6 +1263,10 @@ _ncm_stats_dist_nd_kde_gauss_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2l
 
     self->alloc_n = self->n;
   }
+
+  /* The dense n x n matrix is only needed by the untruncated interpolation and LOOCV */
+  if ((self->IM == NULL) && ((self->cutoff == 0.0) || self->LOOCV))
+    self->IM = ncm_matrix_new (self->n, self->n);
   
   self->min_m2lnp = GSL_POSINF;
   self->max_m2lnp = GSL_NEGINF;
@@ -907,6 +1310,34 @@ _ncm_stats_dist_nd_kde_gauss_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2l
     gint verbose = 0;
     gint maxiter = 400;
 
+    if (self->cutoff > 0.0)
+    {
+      for (i = 0; i < self->n; i++)
+      {
+        const gdouble m2lnp_i = ncm_vector_get (m2lnp, i);
+        ncm_vector_set (self->zeta, i, exp (-0.5 * (m2lnp_i - self->min_m2lnp)));
+      }
+
+      _ncm_stats_dist_nd_kde_gauss_prepare_sparse_IM (self);
+      _ncm_stats_dist_nd_kde_gauss_sparse_solve (self, self->zeta, self->weights);
+
+      {
+        const gdouble wsum = ncm_vector_sum_cpts (self->weights);
+
+        if (!(wsum > 0.0) || !gsl_finite (wsum))
+        {
+          g_warning ("_ncm_stats_dist_nd_kde_gauss_prepare_interp: the truncated system gave non-positive weights (sum = % 22.15g), "
+                     "using uniform weights.", wsum);
+          ncm_vector_set_all (self->weights, 1.0 / (1.0 * self->n));
+        }
+        else
+        {
+          ncm_vector_scale (self->weights, 1.0 / wsum);
+        }
+      }
+      return;
+    }
+
     if (self->n > 10000)
       g_warning ("_ncm_stats_dist_nd_kde_gauss_prepare_interp: very large system n = %u!", self->n);
 
@@ -954,11 +1385,9 @@ _ncm_stats_dist_nd_kde_gauss_prepare_interp (NcmStatsDistNd *dnd, NcmVector *m2l
   ncm_vector_scale (self->weights, 1.0 / ncm_vector_sum_cpts (self->weights));
 }
 
-static gdouble 
-_ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
+static gdouble
+_ncm_stats_dist_nd_kde_gauss_kernel_sum (NcmStatsDistNdKDEGaussPrivate * const self, NcmVector *y)
 {
-  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
-  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
   gdouble s = 0.0;
   gdouble c = 0.0;
   gint i, ret;
@@ -966,7 +1395,28 @@ _ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
   ncm_vector_memcpy (self->v, y);
   ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit,
                         ncm_matrix_gsl (self->cov_decomp), ncm_vector_gsl (self->v));
-  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_eval", ret);
+  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_kernel_sum", ret);
+
+  if (self->cutoff > 0.0)
+  {
+    const gdouble r2 = gsl_pow_2 (self->cutoff) * self->href2;
+    guint l;
+
+    _ncm_stats_dist_nd_kde_gauss_tree_prepare (self);
+    _ncm_stats_dist_nd_kde_gauss_tree_query (self, ncm_vector_data (self->v), r2, self->tree_stack, self->nb_idx, self->nb_d2);
+
+    for (l = 0; l < self->nb_idx->len; l++)
+    {
+      const guint j    = g_array_index (self->nb_idx, guint, l);
+      const gdouble e_j = ncm_vector_get (self->weights, j) * exp (- 0.5 * g_array_index (self->nb_d2, gdouble, l) / self->href2);
+      const gdouble t   = s + e_j;
+
+      c += (s >= e_j) ? ((s - t) + e_j) : ((e_j - t) + s);
+      s  = t;
+    }
+
+    return s;
+  }
   
   for (i = 0; i < self->n; i++)
   {
@@ -985,40 +1435,25 @@ _ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
     s    = t;
   }
 
-  return s * exp (- self->lnnorm);
+  return s;
 }
 
 static gdouble 
-_ncm_stats_dist_nd_kde_gauss_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *y)
+_ncm_stats_dist_nd_kde_gauss_eval (NcmStatsDistNd *dnd, NcmVector *y)
 {
   NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
   NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
-  gdouble s = 0.0;
-  gdouble c = 0.0;
-  gint i, ret;
-
-  ncm_vector_memcpy (self->v, y);
-  ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit,
-                        ncm_matrix_gsl (self->cov_decomp), ncm_vector_gsl (self->v));
-  NCM_TEST_GSL_RESULT ("_ncm_stats_dist_nd_kde_gauss_eval_m2lnp", ret);
+  const gdouble s = _ncm_stats_dist_nd_kde_gauss_kernel_sum (self, y);
 
-  for (i = 0; i < self->n; i++)
-  {
-    NcmVector *row_i = g_ptr_array_index (self->smatrix_rows, i);
-    gdouble e_i, t, m2lnp_i = 0.0;
-    gint k;
-
-    for (k = 0; k < self->d; k++)
-    {
-      m2lnp_i += gsl_pow_2 (ncm_vector_fast_get (row_i, k) - ncm_vector_fast_get (self->v, k));
-    }
+  return s * exp (- self->lnnorm);
+}
 
-    e_i  = ncm_vector_get (self->weights, i) * exp (- 0.5 * m2lnp_i / self->href2);
-    t    = s + e_i;
-    c   += (s >= e_i) ? ((s - t) + e_i) : ((e_i - t) + s);
-    s    = t;
-    /*printf ("% 22.15g % 22.15g % 22.15g\n", e_i, s, self->lnnorm);*/
-  }
+static gdouble 
+_ncm_stats_dist_nd_kde_gauss_eval_m2lnp (NcmStatsDistNd *dnd, NcmVector *y)
+{
+  NcmStatsDistNdKDEGauss *dndg = NCM_STATS_DIST_ND_KDE_GAUSS (dnd);
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  const gdouble s = _ncm_stats_dist_nd_kde_gauss_kernel_sum (self, y);
 
   return -2.0 * (log (s) - self->lnnorm);
 }
@@ -1243,3 +1678,77 @@ ncm_stats_dist_nd_kde_gauss_add_obs (NcmStatsDistNdKDEGauss *dndg, NcmVector *y)
   ncm_stats_dist_nd_kde_gauss_add_obs_weight (dndg, y, 1.0);
 }
 
+/**
+ * ncm_stats_dist_nd_kde_gauss_set_cutoff:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ * @cutoff: kernel truncation in units of the kernel width
+ * 
+ * Sets the kernel truncation @cutoff, kernels farther than 
+ * @cutoff kernel widths are ignored. When @cutoff is larger than 
+ * zero, the kernels are located using a kd-tree, making the 
+ * evaluation cost proportional to the number of kernels within 
+ * the cutoff. The interpolation system in 
+ * ncm_stats_dist_nd_prepare_interp() is then kept sparse and solved 
+ * iteratively. A @cutoff equal to zero disables the truncation.
+ * 
+ * The kd-tree is built on the first evaluation and queried using 
+ * scratch buffers kept in @dndg, as is the whitened point used by 
+ * the untruncated evaluation. Evaluating the same object from 
+ * different threads is therefore not safe, each thread must use 
+ * its own copy.
+ * 
+ */
+void 
+ncm_stats_dist_nd_kde_gauss_set_cutoff (NcmStatsDistNdKDEGauss *dndg, const gdouble cutoff)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+
+  g_assert_cmpfloat (cutoff, >=, 0.0);
+  
+  self->cutoff = cutoff;
+}
+
+/**
+ * ncm_stats_dist_nd_kde_gauss_get_cutoff:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ * 
+ * Returns: the kernel truncation in units of the kernel width.
+ */
+gdouble 
+ncm_stats_dist_nd_kde_gauss_get_cutoff (NcmStatsDistNdKDEGauss *dndg)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  
+  return self->cutoff;
+}
+
+/**
+ * ncm_stats_dist_nd_kde_gauss_set_nthreads:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used to build the truncated kernel matrix,
+ * values smaller than two disable threading.
+ * 
+ */
+void 
+ncm_stats_dist_nd_kde_gauss_set_nthreads (NcmStatsDistNdKDEGauss *dndg, const guint nthreads)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+
+  self->nthreads = nthreads;
+}
+
+/**
+ * ncm_stats_dist_nd_kde_gauss_get_nthreads:
+ * @dndg: a #NcmStatsDistNdKDEGauss
+ * 
+ * Returns: the number of threads used to build the truncated kernel matrix.
+ */
+guint 
+ncm_stats_dist_nd_kde_gauss_get_nthreads (NcmStatsDistNdKDEGauss *dndg)
+{
+  NcmStatsDistNdKDEGaussPrivate * const self = dndg->priv;
+  
+  return self->nthreads;
+}
@@ -73,6 +73,12 @@ gdouble ncm_stats_dist_nd_kde_gauss_get_over_smooth (NcmStatsDistNdKDEGauss *dnd
 void ncm_stats_dist_nd_kde_gauss_set_LOOCV_bandwidth_adj (NcmStatsDistNdKDEGauss *dndg, gboolean LOOCV);
 gboolean ncm_stats_dist_nd_kde_gauss_get_LOOCV_bandwidth_adj (NcmStatsDistNdKDEGauss *dndg);
 
+void ncm_stats_dist_nd_kde_gauss_set_cutoff (NcmStatsDistNdKDEGauss *dndg, const gdouble cutoff);
+gdouble ncm_stats_dist_nd_kde_gauss_get_cutoff (NcmStatsDistNdKDEGauss *dndg);
+
+void ncm_stats_dist_nd_kde_gauss_set_nthreads (NcmStatsDistNdKDEGauss *dndg, const guint nthreads);
+guint ncm_stats_dist_nd_kde_gauss_get_nthreads (NcmStatsDistNdKDEGauss *dndg);
+
 void ncm_stats_dist_nd_kde_gauss_add_obs_weight (NcmStatsDistNdKDEGauss *dndg, NcmVector *y, const gdouble w);
 void ncm_stats_dist_nd_kde_gauss_add_obs (NcmStatsDistNdKDEGauss *dndg, NcmVector *y);
 
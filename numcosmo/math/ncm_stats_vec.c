@@ -590,6 +590,179 @@ _ncm_stats_vec_update_from_vec_weight_mean (NcmStatsVec *svec, const gdouble w,
   }
 }
 
+static void
+_ncm_stats_vec_merge_moments (NcmStatsVec *svec, const gdouble wb, const gdouble wb2, const guint nb, NcmVector *mean_b, NcmVector *var_b, NcmMatrix *M2_b)
+{
+  const gdouble wa        = svec->weight;
+  const gdouble curweight = wa + wb;
+  const gdouble R         = wb / curweight;
+  const gdouble f         = wa * R;
+  const guint sveclen     = svec->len;
+  guint i;
+
+  switch (svec->t)
+  {
+    case NCM_STATS_VEC_COV:
+      for (i = 0; i < sveclen; i++)
+      {
+        const gdouble delta_i = ncm_vector_fast_get (mean_b, i) - ncm_vector_fast_get (svec->mean, i);
+        guint j;
+
+        for (j = i + 1; j < sveclen; j++)
+        {
+          const gdouble delta_j = ncm_vector_fast_get (mean_b, j) - ncm_vector_fast_get (svec->mean, j);
+          const gdouble oC_ij   = ncm_matrix_get (svec->cov, i, j);
+          const gdouble C_ij    = oC_ij + ncm_matrix_get (M2_b, i, j) + f * delta_i * delta_j;
+
+          ncm_matrix_set (svec->cov, i, j, C_ij);
+          ncm_matrix_set (svec->cov, j, i, C_ij);
+        }
+      }
+    case NCM_STATS_VEC_VAR:
+      for (i = 0; i < sveclen; i++)
+      {
+        const gdouble delta_i = ncm_vector_fast_get (mean_b, i) - ncm_vector_fast_get (svec->mean, i);
+        const gdouble var     = ncm_vector_fast_get (svec->var, i);
+
+        ncm_vector_fast_set (svec->var, i, var + ncm_vector_fast_get (var_b, i) + f * delta_i * delta_i);
+      }
+    case NCM_STATS_VEC_MEAN:
+      for (i = 0; i < sveclen; i++)
+      {
+        const gdouble mean_i  = ncm_vector_fast_get (svec->mean, i);
+        const gdouble delta_i = ncm_vector_fast_get (mean_b, i) - mean_i;
+
+        ncm_vector_fast_set (svec->mean, i, mean_i + delta_i * R);
+      }
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  svec->nitens  += nb;
+  svec->weight   = curweight;
+  svec->weight2 += wb2;
+  svec->bias_wt  = 1.0 / (svec->weight - svec->weight2 / svec->weight);
+}
+
+/*
+ * Block update: the moments of the whole block are computed first (two-pass,
+ * the second moment through a single rank-k update dsyrk) and then combined
+ * with the current ones using the pairwise (Chan et al.) merge above.
+ */
+static void
+_ncm_stats_vec_update_block (NcmStatsVec *svec, GPtrArray *data, NcmVector *w)
+{
+  const guint nrows   = data->len;
+  const guint sveclen = svec->len;
+  NcmVector *mean_b   = NULL;
+  NcmVector *var_b    = NULL;
+  NcmMatrix *M2_b     = NULL;
+  gdouble wb          = 0.0;
+  gdouble wb2         = 0.0;
+  guint k;
+
+  if (nrows == 0)
+    return;
+
+  if (w != NULL)
+    g_assert_cmpuint (ncm_vector_len (w), ==, nrows);
+
+  mean_b = ncm_vector_new (sveclen);
+  ncm_vector_set_zero (mean_b);
+
+  for (k = 0; k < nrows; k++)
+  {
+    NcmVector *x_k  = g_ptr_array_index (data, k);
+    const gdouble w_k = (w != NULL) ? ncm_vector_get (w, k) : 1.0;
+
+    ncm_vector_axpy (mean_b, w_k, x_k);
+    wb  += w_k;
+    wb2 += w_k * w_k;
+  }
+  ncm_vector_scale (mean_b, 1.0 / wb);
+
+  switch (svec->t)
+  {
+    case NCM_STATS_VEC_COV:
+    {
+      NcmMatrix *Xc = ncm_matrix_new (nrows, sveclen);
+      guint i;
+
+      M2_b  = ncm_matrix_new (sveclen, sveclen);
+      var_b = ncm_vector_new (sveclen);
+
+      for (k = 0; k < nrows; k++)
+      {
+        NcmVector *x_k    = g_ptr_array_index (data, k);
+        const gdouble w_k = (w != NULL) ? ncm_vector_get (w, k) : 1.0;
+        gdouble sqrt_w_k;
+
+        g_assert_cmpfloat (w_k, >=, 0.0);
+        sqrt_w_k = sqrt (w_k);
+
+        for (i = 0; i < sveclen; i++)
+          ncm_matrix_set (Xc, k, i, sqrt_w_k * (ncm_vector_fast_get (x_k, i) - ncm_vector_fast_get (mean_b, i)));
+      }
+
+      gsl_blas_dsyrk (CblasUpper, CblasTrans, 1.0, ncm_matrix_gsl (Xc), 0.0, ncm_matrix_gsl (M2_b));
+
+      for (i = 0; i < sveclen; i++)
+        ncm_vector_fast_set (var_b, i, ncm_matrix_get (M2_b, i, i));
+
+      ncm_matrix_free (Xc);
+      break;
+    }
+    case NCM_STATS_VEC_VAR:
+    {
+      var_b = ncm_vector_new (sveclen);
+      ncm_vector_set_zero (var_b);
+
+      for (k = 0; k < nrows; k++)
+      {
+        NcmVector *x_k    = g_ptr_array_index (data, k);
+        const gdouble w_k = (w != NULL) ? ncm_vector_get (w, k) : 1.0;
+        guint i;
+
+        for (i = 0; i < sveclen; i++)
+        {
+          const gdouble delta_i = ncm_vector_fast_get (x_k, i) - ncm_vector_fast_get (mean_b, i);
+          ncm_vector_fast_set (var_b, i, ncm_vector_fast_get (var_b, i) + w_k * delta_i * delta_i);
+        }
+      }
+      break;
+    }
+    case NCM_STATS_VEC_MEAN:
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  _ncm_stats_vec_merge_moments (svec, wb, wb2, nrows, mean_b, var_b, M2_b);
+
+  if (svec->q_array->len == svec->len)
+  {
+    for (k = 0; k < nrows; k++)
+    {
+      NcmVector *x_k = g_ptr_array_index (data, k);
+      guint i;
+
+      for (i = 0; i < svec->len; i++)
+      {
+        const gdouble x_i = ncm_vector_fast_get (x_k, i);
+        gsl_rstat_quantile_workspace *qws_i = g_ptr_array_index (svec->q_array, i);
+        gsl_rstat_quantile_add (x_i, qws_i);
+      }
+    }
+  }
+
+  ncm_vector_free (mean_b);
+  ncm_vector_clear (&var_b);
+  ncm_matrix_clear (&M2_b);
+}
+
 /**
  * ncm_stats_vec_update_weight:
  * @svec: a #NcmStatsVec
@@ -731,20 +904,7 @@ ncm_stats_vec_prepend (NcmStatsVec *svec, NcmVector *x, gboolean dup)
 void
 ncm_stats_vec_append_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup)
 {
-  guint i;
-
-  for (i = 0; i < data->len; i++)
-  {
-    NcmVector *x = g_ptr_array_index (data, i);
-    svec->update (svec, 1.0, x);
-    if (svec->save_x)
-    {
-      if (dup)
-        g_ptr_array_add (svec->saved_x, ncm_vector_dup (x));
-      else
-        g_ptr_array_add (svec->saved_x, ncm_vector_ref (x));
-    }
-  }
+  ncm_stats_vec_append_weight_data (svec, data, NULL, dup);
 }
 
 /**
@@ -765,24 +925,21 @@ ncm_stats_vec_append_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup)
 void
 ncm_stats_vec_prepend_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup)
 {
-  guint i;
+  _ncm_stats_vec_update_block (svec, data, NULL);
 
   if (svec->save_x)
   {
     const guint cp_len  = data->len;
     const guint old_len = svec->saved_x->len;
     const guint new_len = old_len + cp_len;
+    guint i;
 
     g_ptr_array_set_size (svec->saved_x, new_len);
     memmove (&svec->saved_x->pdata[cp_len], svec->saved_x->pdata, sizeof (gpointer) * old_len);
-  }
 
-  for (i = 0; i < data->len; i++)
-  {
-    NcmVector *x = g_ptr_array_index (data, i);
-    svec->update (svec, 1.0, x);
-    if (svec->save_x)
+    for (i = 0; i < data->len; i++)
     {
+      NcmVector *x = g_ptr_array_index (data, i);
       if (dup)
         g_ptr_array_index (svec->saved_x, i) = ncm_vector_dup (x);
       else
@@ -791,6 +948,106 @@ ncm_stats_vec_prepend_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup)
   }
 }
 
+/**
+ * ncm_stats_vec_append_weight_data:
+ * @svec: a #NcmStatsVec
+ * @data: (element-type NcmVector): a #GPtrArray containing #NcmVector s to be added
+ * @w: (allow-none): a #NcmVector containing the weights of each element of @data
+ * @dup: a boolean
+ *
+ * Appends and updates the statistics using the data contained in @data and
+ * weights @w (if @w is NULL all weights are set to 1.0). The whole block is
+ * reduced at once, the first moments are computed over the block, the covariance
+ * is obtained through a single rank-k update and the result is then merged in @svec.
+ * The weights must be non-negative when @svec is of type #NCM_STATS_VEC_COV.
+ *
+ * It assumes that each element of @data is a #NcmVector of same size #NcmStatsVec:length and
+ * with continuous allocation. i.e., NcmVector:stride == 1.
+ *
+ * If @svec was created with save_x TRUE, the paramenter @dup determines if the vectors
+ * from @data will be duplicated or if just a reference for the current vectors in @data
+ * will be saved.
+ *
+ */
+void
+ncm_stats_vec_append_weight_data (NcmStatsVec *svec, GPtrArray *data, NcmVector *w, gboolean dup)
+{
+  _ncm_stats_vec_update_block (svec, data, w);
+
+  if (svec->save_x)
+  {
+    guint i;
+
+    for (i = 0; i < data->len; i++)
+    {
+      NcmVector *x = g_ptr_array_index (data, i);
+      if (dup)
+        g_ptr_array_add (svec->saved_x, ncm_vector_dup (x));
+      else
+        g_ptr_array_add (svec->saved_x, ncm_vector_ref (x));
+    }
+  }
+}
+
+/**
+ * ncm_stats_vec_merge:
+ * @svec: a #NcmStatsVec
+ * @src: a #NcmStatsVec
+ *
+ * Merges the statistics accumulated in @src into @svec, after the call
+ * @svec contains the statistics of the union of both samples. This can
+ * be used to accumulate partial statistics in different threads, each one
+ * using its own #NcmStatsVec, and combine them at the end.
+ *
+ * Both objects must have the same length and @src type must be at least
+ * as complete as the @svec type, e.g., a #NCM_STATS_VEC_COV object can be
+ * merged into a #NCM_STATS_VEC_VAR but not the opposite.
+ *
+ * If both objects save their data, the saved vectors in @src are appended
+ * (by reference) to @svec. If @svec has quantile calculation enabled, @src
+ * must have saved its data.
+ *
+ */
+void
+ncm_stats_vec_merge (NcmStatsVec *svec, NcmStatsVec *src)
+{
+  g_assert_cmpuint (svec->len, ==, src->len);
+  g_assert_cmpint (src->t, >=, svec->t);
+
+  if (src->nitens == 0)
+    return;
+
+  _ncm_stats_vec_merge_moments (svec, src->weight, src->weight2, src->nitens, src->mean, src->var, src->cov);
+
+  if (svec->q_array->len == svec->len)
+  {
+    guint k;
+
+    if (!src->save_x)
+      g_error ("ncm_stats_vec_merge: cannot merge quantiles from a NcmStatsVec without saved data.");
+
+    for (k = 0; k < src->saved_x->len; k++)
+    {
+      NcmVector *x_k = g_ptr_array_index (src->saved_x, k);
+      guint i;
+
+      for (i = 0; i < svec->len; i++)
+      {
+        gsl_rstat_quantile_workspace *qws_i = g_ptr_array_index (svec->q_array, i);
+        gsl_rstat_quantile_add (ncm_vector_fast_get (x_k, i), qws_i);
+      }
+    }
+  }
+
+  if (svec->save_x && src->save_x)
+  {
+    guint k;
+
+    for (k = 0; k < src->saved_x->len; k++)
+      g_ptr_array_add (svec->saved_x, ncm_vector_ref (g_ptr_array_index (src->saved_x, k)));
+  }
+}
+
 /**
  * ncm_stats_vec_enable_quantile:
  * @svec: a #NcmStatsVec
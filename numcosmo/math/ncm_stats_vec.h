@@ -147,6 +147,9 @@ void ncm_stats_vec_append (NcmStatsVec *svec, NcmVector *x, gboolean dup);
 void ncm_stats_vec_prepend (NcmStatsVec *svec, NcmVector *x, gboolean dup);
 void ncm_stats_vec_append_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup);
 void ncm_stats_vec_prepend_data (NcmStatsVec *svec, GPtrArray *data, gboolean dup);
+void ncm_stats_vec_append_weight_data (NcmStatsVec *svec, GPtrArray *data, NcmVector *w, gboolean dup);
+
+void ncm_stats_vec_merge (NcmStatsVec *svec, NcmStatsVec *src);
 
 void ncm_stats_vec_enable_quantile (NcmStatsVec *svec, gdouble p);
 void ncm_stats_vec_disable_quantile (NcmStatsVec *svec);
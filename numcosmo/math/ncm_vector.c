@@ -628,16 +628,25 @@ GVariant *
 ncm_vector_get_variant (const NcmVector *v)
 {
   guint n = ncm_vector_len (v);
-  GVariantBuilder builder;
   GVariant *var;
-  guint i;
 
-  g_variant_builder_init (&builder, G_VARIANT_TYPE ("ad"));
+  if ((n > 0) && (ncm_vector_stride (v) == 1))
+  {
+    var = g_variant_new_fixed_array (G_VARIANT_TYPE ("d"), ncm_vector_const_ptr (v, 0), n, sizeof (gdouble));
+  }
+  else
+  {
+    GVariantBuilder builder;
+    guint i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("ad"));
 
-  for (i = 0; i < n; i++)
-    g_variant_builder_add (&builder, "d", ncm_vector_get (v, i));
+    for (i = 0; i < n; i++)
+      g_variant_builder_add (&builder, "d", ncm_vector_get (v, i));
+
+    var = g_variant_builder_end (&builder);
+  }
 
-  var = g_variant_builder_end (&builder);
   g_variant_ref_sink (var);
 
   return var;
@@ -1128,13 +1137,13 @@ ncm_vector_get_absminmax (const NcmVector *cv, gdouble *absmin, gdouble *absmax)
 void
 ncm_vector_set_from_variant (NcmVector *cv, GVariant *var)
 {
+  const gdouble *data;
   gsize n;
-  guint i;
 
   if (!g_variant_is_of_type (var, G_VARIANT_TYPE ("ad")))
     g_error ("ncm_vector_set_from_variant: Cannot convert `%s' variant to an array of doubles", g_variant_get_type_string (var));
 
-  n = g_variant_n_children (var);
+  data = g_variant_get_fixed_array (var, &n, sizeof (gdouble));
 
   if (ncm_vector_len (cv) == 0)
   {
@@ -1147,12 +1156,8 @@ ncm_vector_set_from_variant (NcmVector *cv, GVariant *var)
   else if (n != ncm_vector_len (cv))
     g_error ("set_property: cannot set vector values, variant contains %zu childs but vector dimension is %u", n, ncm_vector_len (cv));
 
-  for (i = 0; i < n; i++)
-  {
-    gdouble val = 0.0;
-    g_variant_get_child (var, i, "d", &val);
-    ncm_vector_set (cv, i, val);
-  }
+  if (n > 0)
+    ncm_vector_set_data (cv, data, n);
 }
 
 /**
@@ -41,6 +41,13 @@
  * 
  * See [NcRecomb][NcRecomb.description] for symbol definitions.
  * 
+ * The reionization optical depth is the integral of $X_\e$ times a kernel
+ * that depends only on the background cosmology. When #NcHIReion:tau-cache
+ * is enabled, this kernel is tabulated once per cosmology, together with
+ * fixed Gauss-Legendre weights, and $\tau_\mathrm{reion}$ for new values
+ * of the reionization parameters becomes a weighted sum over the stored
+ * nodes, see nc_hireion_get_tau_cached() and nc_hireion_get_tau_batch().
+ * 
  * FIXME
  *
  */
@@ -60,6 +67,7 @@
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <gsl/gsl_integration.h>
+#include <gsl/gsl_math.h>
 #endif /* NUMCOSMO_GIR_SCAN */
 
 G_DEFINE_ABSTRACT_TYPE (NcHIReion, nc_hireion, NCM_TYPE_MODEL);
@@ -68,18 +76,42 @@ enum
 {
   PROP_0,
   PROP_PREC,
+  PROP_TAU_CACHE,
+  PROP_TAU_NPANELS,
   PROP_SIZE,
 };
 
 static void
 nc_hireion_init (NcHIReion *reion)
 {
-  reion->prec = 0.0;
+  reion->prec        = 0.0;
+  reion->tau_cache   = FALSE;
+  reion->tau_npanels = 0;
+  reion->tau_x_max   = 0.0;
+  reion->tau_nbuilds = 0;
+  reion->tau_lambda  = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  reion->tau_w       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  reion->ctrl_cosmo  = ncm_model_ctrl_new (NULL);
+}
+
+static void
+nc_hireion_dispose (GObject *object)
+{
+  NcHIReion *reion = NC_HIREION (object);
+
+  ncm_model_ctrl_clear (&reion->ctrl_cosmo);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (nc_hireion_parent_class)->dispose (object);
 }
 
 static void
 nc_hireion_finalize (GObject *object)
 {
+  NcHIReion *reion = NC_HIREION (object);
+
+  g_array_unref (reion->tau_lambda);
+  g_array_unref (reion->tau_w);
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_hireion_parent_class)->finalize (object);
@@ -96,6 +128,12 @@ nc_hireion_set_property (GObject *object, guint prop_id, const GValue *value, GP
     case PROP_PREC:
       reion->prec = g_value_get_double (value);
       break;
+    case PROP_TAU_CACHE:
+      nc_hireion_set_tau_cache (reion, g_value_get_boolean (value));
+      break;
+    case PROP_TAU_NPANELS:
+      nc_hireion_set_tau_npanels (reion, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -113,6 +151,12 @@ nc_hireion_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
     case PROP_PREC:
       g_value_set_double (value, reion->prec);
       break;
+    case PROP_TAU_CACHE:
+      g_value_set_boolean (value, nc_hireion_get_tau_cache (reion));
+      break;
+    case PROP_TAU_NPANELS:
+      g_value_set_uint (value, nc_hireion_get_tau_npanels (reion));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -134,6 +178,7 @@ nc_hireion_class_init (NcHIReionClass *klass)
 
   model_class->set_property = nc_hireion_set_property;
   model_class->get_property = nc_hireion_get_property;
+  object_class->dispose     = nc_hireion_dispose;
   object_class->finalize    = nc_hireion_finalize;
   
   ncm_model_class_set_name_nick (model_class, "Abstract class for H and He reionization models.", "NcHIReion");
@@ -153,6 +198,20 @@ nc_hireion_class_init (NcHIReionClass *klass)
                                                         "Precision for reionization calculations",
                                                         0.0, 1.0, 1.0e-7,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_TAU_CACHE,
+                                   g_param_spec_boolean ("tau-cache",
+                                                         NULL,
+                                                         "Whether to compute tau from the tabulated cosmological kernel",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_TAU_NPANELS,
+                                   g_param_spec_uint ("tau-npanels",
+                                                      NULL,
+                                                      "Number of quadrature panels used in the tabulated tau kernel",
+                                                      1, G_MAXUINT, NC_HIREION_DEFAULT_TAU_NPANELS,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
   ncm_model_class_check_params_info (model_class);
 
@@ -291,21 +350,26 @@ _nc_hireion_dtau_dlambda (gdouble lambda, gpointer data)
 static gdouble 
 _nc_hireion_get_tau (NcHIReion *reion, NcHICosmo *cosmo)
 {
-  gdouble result = 0.0;
-  gdouble error  = 0.0;
-  const gdouble lambda_i = -log (nc_hireion_get_init_x (reion, cosmo));
-  gsl_integration_workspace **w = ncm_integral_get_workspace();
-  NcHIReionTauInt tau_int = {reion, cosmo};
-  gsl_function F;
+  if (reion->tau_cache)
+    return nc_hireion_get_tau_cached (reion, cosmo);
+  else
+  {
+    gdouble result = 0.0;
+    gdouble error  = 0.0;
+    const gdouble lambda_i = -log (nc_hireion_get_init_x (reion, cosmo));
+    gsl_integration_workspace **w = ncm_integral_get_workspace();
+    NcHIReionTauInt tau_int = {reion, cosmo};
+    gsl_function F;
 
-  F.function = &_nc_hireion_dtau_dlambda;
-  F.params   = &tau_int;
+    F.function = &_nc_hireion_dtau_dlambda;
+    F.params   = &tau_int;
 
-  gsl_integration_qag (&F, lambda_i, 0.0, 1.0, reion->prec, NCM_INTEGRAL_PARTITION, 6, *w, &result, &error);
+    gsl_integration_qag (&F, lambda_i, 0.0, 1.0, reion->prec, NCM_INTEGRAL_PARTITION, 6, *w, &result, &error);
 
-  ncm_memory_pool_return (w);
+    ncm_memory_pool_return (w);
 
-  return -result;  
+    return -result;
+  }
 }
 
 /**
@@ -323,6 +387,259 @@ nc_hireion_get_tau (NcHIReion *reion, NcHICosmo *cosmo)
   return NC_HIREION_GET_CLASS (reion)->get_tau (reion, cosmo);
 }
 
+/**
+ * nc_hireion_set_tau_cache:
+ * @reion: a #NcHIReion
+ * @tau_cache: whether to use the tabulated kernel
+ *
+ * Sets whether nc_hireion_get_tau() uses the tabulated cosmological kernel,
+ * see nc_hireion_get_tau_cached(), instead of the adaptive integration.
+ * 
+ */
+void 
+nc_hireion_set_tau_cache (NcHIReion *reion, gboolean tau_cache)
+{
+  reion->tau_cache = tau_cache;
+}
+
+/**
+ * nc_hireion_get_tau_cache:
+ * @reion: a #NcHIReion
+ *
+ * Returns: whether nc_hireion_get_tau() uses the tabulated kernel.
+ */
+gboolean 
+nc_hireion_get_tau_cache (NcHIReion *reion)
+{
+  return reion->tau_cache;
+}
+
+/**
+ * nc_hireion_set_tau_npanels:
+ * @reion: a #NcHIReion
+ * @tau_npanels: number of panels
+ *
+ * Sets the number of panels, uniformly spaced in $\lambda$, used to tabulate
+ * the optical depth kernel. Each panel uses #NC_HIREION_TAU_PANEL_NNODES
+ * Gauss-Legendre nodes.
+ * 
+ */
+void 
+nc_hireion_set_tau_npanels (NcHIReion *reion, guint tau_npanels)
+{
+  g_assert_cmpuint (tau_npanels, >, 0);
+
+  if (reion->tau_npanels != tau_npanels)
+  {
+    reion->tau_npanels = tau_npanels;
+    reion->tau_x_max   = 0.0;
+    ncm_model_ctrl_force_update (reion->ctrl_cosmo);
+  }
+}
+
+/**
+ * nc_hireion_get_tau_npanels:
+ * @reion: a #NcHIReion
+ *
+ * Returns: the number of panels used to tabulate the optical depth kernel.
+ */
+guint 
+nc_hireion_get_tau_npanels (NcHIReion *reion)
+{
+  return reion->tau_npanels;
+}
+
+/*
+ * Panel @i of the table covers [lambda_l, lambda_u], the panels are uniform
+ * in lambda from -ln(tau_x_max) to 0.
+ */
+static void
+_nc_hireion_tau_panel (NcHIReion *reion, const guint i, gdouble *lambda_l, gdouble *lambda_u)
+{
+  const gdouble lambda_max = -log (reion->tau_x_max);
+  const gdouble dlambda    = -lambda_max / reion->tau_npanels;
+
+  lambda_l[0] = lambda_max + i * dlambda;
+  lambda_u[0] = (i + 1 == reion->tau_npanels) ? 0.0 : lambda_l[0] + dlambda;
+}
+
+/*
+ * Tabulates the nodes lambda_k and weights w_k K(lambda_k), where
+ * K = -dtau/dlambda / X_e depends only on the background, covering
+ * x in [1, tau_x_max]. The table is rebuilt when the parameters of
+ * @cosmo change or when @x_init falls outside the covered range.
+ * Changes in the submodels of @cosmo, e.g., in @reion itself, do
+ * not affect the kernel and are ignored.
+ */
+static void
+_nc_hireion_prepare_tau_nodes (NcHIReion *reion, NcHICosmo *cosmo, const gdouble x_init)
+{
+  gboolean need_update;
+
+  ncm_model_ctrl_update (reion->ctrl_cosmo, NCM_MODEL (cosmo));
+  need_update = ncm_model_ctrl_model_last_update (reion->ctrl_cosmo);
+
+  if (x_init > reion->tau_x_max)
+  {
+    reion->tau_x_max = 1.25 * x_init;
+    need_update      = TRUE;
+  }
+
+  if (need_update)
+  {
+    gsl_integration_glfixed_table *glt = gsl_integration_glfixed_table_alloc (NC_HIREION_TAU_PANEL_NNODES);
+    guint i;
+
+    g_array_set_size (reion->tau_lambda, 0);
+    g_array_set_size (reion->tau_w, 0);
+
+    for (i = 0; i < reion->tau_npanels; i++)
+    {
+      gdouble lambda_l, lambda_u;
+      guint k;
+
+      _nc_hireion_tau_panel (reion, i, &lambda_l, &lambda_u);
+
+      for (k = 0; k < NC_HIREION_TAU_PANEL_NNODES; k++)
+      {
+        gdouble lambda_k, w_k;
+
+        gsl_integration_glfixed_point (lambda_l, lambda_u, k, &lambda_k, &w_k, glt);
+        w_k *= -nc_recomb_dtau_dlambda_Xe (cosmo, lambda_k);
+
+        g_array_append_val (reion->tau_lambda, lambda_k);
+        g_array_append_val (reion->tau_w, w_k);
+      }
+    }
+
+    gsl_integration_glfixed_table_free (glt);
+    reion->tau_nbuilds++;
+  }
+}
+
+/*
+ * The panels above the one containing @lambda_i use the table, the
+ * remaining part [lambda_i, lambda_u] of that panel is integrated with
+ * its own Gauss-Legendre nodes.
+ */
+static gdouble
+_nc_hireion_tau_sum (NcHIReion *reion, NcHICosmo *cosmo, const gdouble lambda_i)
+{
+  const gdouble lambda_max = -log (reion->tau_x_max);
+  const gdouble dlambda    = -lambda_max / reion->tau_npanels;
+  const guint p            = GSL_MIN ((guint) floor (GSL_MAX (lambda_i - lambda_max, 0.0) / dlambda), reion->tau_npanels - 1);
+  gdouble lambda_l, lambda_u;
+  gdouble tau = 0.0;
+  guint k;
+
+  for (k = (p + 1) * NC_HIREION_TAU_PANEL_NNODES; k < reion->tau_lambda->len; k++)
+  {
+    const gdouble lambda_k = g_array_index (reion->tau_lambda, gdouble, k);
+
+    tau += g_array_index (reion->tau_w, gdouble, k) * nc_hireion_get_Xe (reion, cosmo, lambda_k, 0.0);
+  }
+
+  _nc_hireion_tau_panel (reion, p, &lambda_l, &lambda_u);
+
+  if (lambda_u > lambda_i)
+  {
+    gsl_integration_glfixed_table *glt = gsl_integration_glfixed_table_alloc (NC_HIREION_TAU_PANEL_NNODES);
+
+    for (k = 0; k < NC_HIREION_TAU_PANEL_NNODES; k++)
+    {
+      gdouble lambda_k, w_k;
+
+      gsl_integration_glfixed_point (lambda_i, lambda_u, k, &lambda_k, &w_k, glt);
+      tau -= w_k * nc_recomb_dtau_dlambda_Xe (cosmo, lambda_k) * nc_hireion_get_Xe (reion, cosmo, lambda_k, 0.0);
+    }
+
+    gsl_integration_glfixed_table_free (glt);
+  }
+
+  return tau;
+}
+
+/**
+ * nc_hireion_get_tau_cached:
+ * @reion: a #NcHIReion
+ * @cosmo: a #NcHICosmo
+ *
+ * Calculates the reionization optical depth $\tau_\mathrm{reion}$ as a
+ * weighted sum of $X_\e$ over the tabulated nodes. The background dependent
+ * kernel is computed only when the parameters of @cosmo change, so changing
+ * only the reionization parameters costs one evaluation of $X_\e$ per node,
+ * plus #NC_HIREION_TAU_PANEL_NNODES kernel evaluations for the part of the
+ * panel where reionization starts. The accuracy is controlled by
+ * #NcHIReion:tau-npanels instead of #NcHIReion:prec.
+ * 
+ * Returns: $\tau_\mathrm{reion}$.
+ */
+gdouble 
+nc_hireion_get_tau_cached (NcHIReion *reion, NcHICosmo *cosmo)
+{
+  const gdouble x_init = nc_hireion_get_init_x (reion, cosmo);
+
+  _nc_hireion_prepare_tau_nodes (reion, cosmo, x_init);
+
+  return _nc_hireion_tau_sum (reion, cosmo, -log (x_init));
+}
+
+static void
+_nc_hireion_orig_params_set_row (NcmModel *model, NcmMatrix *params, const guint i)
+{
+  const guint len = ncm_model_len (model);
+  guint j;
+
+  for (j = 0; j < len; j++)
+    ncm_model_orig_param_set (model, j, ncm_matrix_get (params, i, j));
+}
+
+/**
+ * nc_hireion_get_tau_batch:
+ * @reion: a #NcHIReion
+ * @cosmo: a #NcHICosmo
+ * @params: a #NcmMatrix
+ * @tau: a #NcmVector
+ *
+ * Calculates $\tau_\mathrm{reion}$ for each row of @params, interpreted as
+ * the original parameter vector of @reion, storing the results in @tau.
+ * The kernel is tabulated once for @cosmo covering all rows, see
+ * nc_hireion_get_tau_cached(). The parameters of @reion are restored at
+ * the end.
+ * 
+ */
+void 
+nc_hireion_get_tau_batch (NcHIReion *reion, NcHICosmo *cosmo, NcmMatrix *params, NcmVector *tau)
+{
+  NcmModel *model   = NCM_MODEL (reion);
+  const guint nrows = ncm_matrix_nrows (params);
+  NcmVector *orig   = ncm_vector_dup (ncm_model_orig_params_peek_vector (model));
+  gdouble x_init    = 0.0;
+  guint i;
+
+  g_assert_cmpuint (ncm_matrix_ncols (params), ==, ncm_model_len (model));
+  g_assert_cmpuint (ncm_vector_len (tau), ==, nrows);
+
+  for (i = 0; i < nrows; i++)
+  {
+    _nc_hireion_orig_params_set_row (model, params, i);
+    x_init = GSL_MAX (x_init, nc_hireion_get_init_x (reion, cosmo));
+  }
+
+  _nc_hireion_prepare_tau_nodes (reion, cosmo, x_init);
+
+  for (i = 0; i < nrows; i++)
+  {
+    _nc_hireion_orig_params_set_row (model, params, i);
+    ncm_vector_set (tau, i, _nc_hireion_tau_sum (reion, cosmo, -log (nc_hireion_get_init_x (reion, cosmo))));
+  }
+
+  for (i = 0; i < ncm_model_len (model); i++)
+    ncm_model_orig_param_set (model, i, ncm_vector_get (orig, i));
+
+  ncm_vector_free (orig);
+}
+
 static void _nc_hireion_flist_tau (NcmMSetFuncList *flist, NcmMSet *mset, const gdouble *x, gdouble *res)
 {
   NcHICosmo *cosmo = NC_HICOSMO (ncm_mset_peek (mset, nc_hicosmo_id ()));
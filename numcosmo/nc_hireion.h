@@ -33,6 +33,7 @@
 #include <numcosmo/math/ncm_c.h>
 #include <numcosmo/math/ncm_model.h>
 #include <numcosmo/math/ncm_mset.h>
+#include <numcosmo/math/ncm_model_ctrl.h>
 
 G_BEGIN_DECLS
 
@@ -60,6 +61,13 @@ struct _NcHIReion
   /*< private >*/
   NcmModel parent_instance;
   gdouble prec;
+  gboolean tau_cache;
+  guint tau_npanels;
+  gdouble tau_x_max;
+  guint tau_nbuilds;
+  GArray *tau_lambda;
+  GArray *tau_w;
+  NcmModelCtrl *ctrl_cosmo;
 };
 
 GType nc_hireion_get_type (void) G_GNUC_CONST;
@@ -75,7 +83,16 @@ gdouble nc_hireion_get_init_x (NcHIReion *reion, NcHICosmo *cosmo);
 gdouble nc_hireion_get_Xe (NcHIReion *reion, NcHICosmo *cosmo, const gdouble lambda, const gdouble Xe_recomb);
 gdouble nc_hireion_get_tau (NcHIReion *reion, NcHICosmo *cosmo);
 
+void nc_hireion_set_tau_cache (NcHIReion *reion, gboolean tau_cache);
+gboolean nc_hireion_get_tau_cache (NcHIReion *reion);
+void nc_hireion_set_tau_npanels (NcHIReion *reion, guint tau_npanels);
+guint nc_hireion_get_tau_npanels (NcHIReion *reion);
+gdouble nc_hireion_get_tau_cached (NcHIReion *reion, NcHICosmo *cosmo);
+void nc_hireion_get_tau_batch (NcHIReion *reion, NcHICosmo *cosmo, NcmMatrix *params, NcmVector *tau);
+
 #define NC_HIREION_DEFAULT_PARAMS_ABSTOL (0.0)
+#define NC_HIREION_DEFAULT_TAU_NPANELS (200)
+#define NC_HIREION_TAU_PANEL_NNODES (8)
 
 G_END_DECLS
 
@@ -0,0 +1,1261 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 2; tab-width: 2 -*-  */
+/***************************************************************************
+ *            nc_recomb_emul.c
+ *
+ *  Sun October 18 10:12:44 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * nc_recomb_emul.c
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:nc_recomb_emul
+ * @title: NcRecombEmul
+ * @short_description: Tabulated emulator of the Seager recombination history.
+ * @include: numcosmo/nc_recomb_emul.h
+ *
+ * This object emulates #NcRecombSeager by interpolating ionization histories
+ * precomputed on a tensor grid over the parameters that control
+ * recombination, namely $\omega_b$, $\omega_c$, $T_{\gamma0}$, $Y_p$ and
+ * $N_\mathrm{eff}$, see #NcRecombEmulParam.
+ *
+ * For each grid node the exact solver is run once and $\ln X_e$, $\ln
+ * X_\mathrm{HII}$ and $X_\mathrm{HeII}$ are stored on a fixed uniform grid
+ * in $\lambda$. The nodes along each direction are Chebyshev-Gauss-Lobatto
+ * points and a cosmology is emulated through the tensor product of the
+ * Lagrange interpolating polynomials, which reduces to a single
+ * matrix-vector product per preparation. The reionization contribution,
+ * when a #NcHIReion submodel is present, and the optical depth splines are
+ * computed exactly from the interpolated recombination history.
+ *
+ * Directions where the lower and upper bounds coincide are kept fixed and
+ * do not contribute to the table size. The table has
+ * #NcRecombEmul:nnodes$^d$ rows, where $d$ is the number of varying
+ * directions, and can be saved and loaded through #NcmSerialize.
+ *
+ * The table is built by nc_recomb_emul_train(). Since this requires one
+ * exact solution per node, training on first use from the cosmology being
+ * prepared is only done when #NcRecombEmul:auto-train is set, otherwise
+ * preparing an untrained emulator is an error. Cosmologies outside the
+ * training box are computed with the exact solver when
+ * #NcRecombEmul:fallback is set. The accuracy of the table can be checked
+ * against the exact solver with nc_recomb_emul_validate().
+ *
+ * The default #NC_RECOMB_EMUL_DEFAULT_NNODES nodes per direction keep the
+ * relative error in $X_e$ below $10^{-4}$ over the default box, at the
+ * cost of $5^5 = 3125$ exact solutions and a table of about $225$ MB with
+ * the default #NcRecombEmul:nlambda. Narrower boxes or fixed directions
+ * reduce both considerably.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include "build_cfg.h"
+
+#include "nc_recomb_emul.h"
+#include "nc_hireion.h"
+#include "math/ncm_spline_cubic_notaknot.h"
+#include "math/ncm_spline_func.h"
+
+#ifndef NUMCOSMO_GIR_SCAN
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_math.h>
+#endif /* NUMCOSMO_GIR_SCAN */
+
+struct _NcRecombEmulPrivate
+{
+  NcRecombSeager *seager;
+  NcHICosmo *train_cosmo;
+  NcmVector *lower;
+  NcmVector *upper;
+  guint nnodes;
+  guint nlambda;
+  gboolean fallback;
+  gboolean auto_train;
+  gboolean constructed;
+  gboolean exact;
+  gboolean has_reion;
+  NcmMatrix *table;
+  gdouble table_lambdai;
+  guint dim_len[NC_RECOMB_EMUL_PARAM_LEN];
+  guint ntotal;
+  gdouble *nodes;
+  gdouble *lw;
+  NcmVector *weights;
+  NcmVector *interp;
+  NcmVector *lambda_v;
+  NcmVector *log_Xe_v;
+  NcmVector *log_XHII_v;
+  NcmVector *XHeII_v;
+  NcmSpline *log_Xe_s;
+  NcmSpline *log_XHII_s;
+  NcmSpline *XHeII_s;
+  NcmSpline *Xe_reion_s;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (NcRecombEmul, nc_recomb_emul, NC_TYPE_RECOMB);
+
+enum
+{
+  PROP_0,
+  PROP_NNODES,
+  PROP_NLAMBDA,
+  PROP_FALLBACK,
+  PROP_AUTO_TRAIN,
+  PROP_LOWER,
+  PROP_UPPER,
+  PROP_TABLE,
+  PROP_SIZE,
+};
+
+static const gdouble _nc_recomb_emul_default_range[NC_RECOMB_EMUL_PARAM_LEN][2] = {
+  {0.019, 0.025}, /* omega_b  */
+  {0.100, 0.140}, /* omega_c  */
+  {2.700, 2.750}, /* T_gamma0 */
+  {0.220, 0.280}, /* Y_p      */
+  {2.500, 3.600}, /* N_eff    */
+};
+
+static void
+nc_recomb_emul_init (NcRecombEmul *recomb_emul)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv = nc_recomb_emul_get_instance_private (recomb_emul);
+  guint i;
+
+  self->seager        = NULL;
+  self->train_cosmo   = NULL;
+  self->lower         = ncm_vector_new (NC_RECOMB_EMUL_PARAM_LEN);
+  self->upper         = ncm_vector_new (NC_RECOMB_EMUL_PARAM_LEN);
+  self->nnodes        = 0;
+  self->nlambda       = 0;
+  self->fallback      = FALSE;
+  self->auto_train    = FALSE;
+  self->constructed   = FALSE;
+  self->exact         = FALSE;
+  self->has_reion     = FALSE;
+  self->table         = NULL;
+  self->table_lambdai = GSL_NAN;
+  self->ntotal        = 0;
+  self->nodes         = NULL;
+  self->lw            = NULL;
+  self->weights       = NULL;
+  self->interp        = NULL;
+  self->lambda_v      = NULL;
+  self->log_Xe_v      = NULL;
+  self->log_XHII_v    = NULL;
+  self->XHeII_v       = NULL;
+  self->log_Xe_s      = ncm_spline_cubic_notaknot_new ();
+  self->log_XHII_s    = ncm_spline_cubic_notaknot_new ();
+  self->XHeII_s       = ncm_spline_cubic_notaknot_new ();
+  self->Xe_reion_s    = ncm_spline_cubic_notaknot_new ();
+
+  for (i = 0; i < NC_RECOMB_EMUL_PARAM_LEN; i++)
+  {
+    ncm_vector_set (self->lower, i, _nc_recomb_emul_default_range[i][0]);
+    ncm_vector_set (self->upper, i, _nc_recomb_emul_default_range[i][1]);
+    self->dim_len[i] = 0;
+  }
+}
+
+static void _nc_recomb_emul_set_table (NcRecombEmul *recomb_emul, NcmMatrix *table);
+static void _nc_recomb_emul_invalidate (NcRecombEmul *recomb_emul);
+static void _nc_recomb_emul_alloc (NcRecombEmul *recomb_emul);
+static void _nc_recomb_emul_free_buffers (NcRecombEmulPrivate * const self);
+
+static void
+_nc_recomb_emul_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  NcRecombEmul *recomb_emul = NC_RECOMB_EMUL (object);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  g_return_if_fail (NC_IS_RECOMB_EMUL (object));
+
+  switch (prop_id)
+  {
+    case PROP_NNODES:
+      nc_recomb_emul_set_nnodes (recomb_emul, g_value_get_uint (value));
+      break;
+    case PROP_NLAMBDA:
+      nc_recomb_emul_set_nlambda (recomb_emul, g_value_get_uint (value));
+      break;
+    case PROP_FALLBACK:
+      nc_recomb_emul_set_fallback (recomb_emul, g_value_get_boolean (value));
+      break;
+    case PROP_AUTO_TRAIN:
+      nc_recomb_emul_set_auto_train (recomb_emul, g_value_get_boolean (value));
+      break;
+    case PROP_LOWER:
+    case PROP_UPPER:
+    {
+      NcmVector *v = g_value_get_object (value);
+
+      if (v != NULL)
+      {
+        if (ncm_vector_len (v) != NC_RECOMB_EMUL_PARAM_LEN)
+          g_error ("_nc_recomb_emul_set_property: the bounds vector must have length %d, got %u.",
+                   NC_RECOMB_EMUL_PARAM_LEN, ncm_vector_len (v));
+
+        ncm_vector_memcpy ((prop_id == PROP_LOWER) ? self->lower : self->upper, v);
+        _nc_recomb_emul_invalidate (recomb_emul);
+      }
+      break;
+    }
+    case PROP_TABLE:
+      _nc_recomb_emul_set_table (recomb_emul, g_value_get_object (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+_nc_recomb_emul_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  NcRecombEmul *recomb_emul = NC_RECOMB_EMUL (object);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  g_return_if_fail (NC_IS_RECOMB_EMUL (object));
+
+  switch (prop_id)
+  {
+    case PROP_NNODES:
+      g_value_set_uint (value, nc_recomb_emul_get_nnodes (recomb_emul));
+      break;
+    case PROP_NLAMBDA:
+      g_value_set_uint (value, nc_recomb_emul_get_nlambda (recomb_emul));
+      break;
+    case PROP_FALLBACK:
+      g_value_set_boolean (value, nc_recomb_emul_get_fallback (recomb_emul));
+      break;
+    case PROP_AUTO_TRAIN:
+      g_value_set_boolean (value, nc_recomb_emul_get_auto_train (recomb_emul));
+      break;
+    case PROP_LOWER:
+      g_value_set_object (value, self->lower);
+      break;
+    case PROP_UPPER:
+      g_value_set_object (value, self->upper);
+      break;
+    case PROP_TABLE:
+      g_value_set_object (value, self->table);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+_nc_recomb_emul_constructed (GObject *object)
+{
+  /* Chain up : start */
+  G_OBJECT_CLASS (nc_recomb_emul_parent_class)->constructed (object);
+  {
+    NcRecombEmul *recomb_emul = NC_RECOMB_EMUL (object);
+    NcRecombEmulPrivate * const self = recomb_emul->priv;
+    NcRecomb *recomb = NC_RECOMB (recomb_emul);
+
+    self->seager      = nc_recomb_seager_new_full (recomb->init_frac, recomb->zi, recomb->prec);
+    self->constructed = TRUE;
+
+    _nc_recomb_emul_alloc (recomb_emul);
+
+    if (self->table != NULL)
+    {
+      NcmMatrix *table = ncm_matrix_ref (self->table);
+
+      _nc_recomb_emul_set_table (recomb_emul, table);
+      ncm_matrix_free (table);
+    }
+  }
+}
+
+static void
+_nc_recomb_emul_dispose (GObject *object)
+{
+  NcRecombEmul *recomb_emul = NC_RECOMB_EMUL (object);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  nc_recomb_seager_clear (&self->seager);
+  nc_hicosmo_clear (&self->train_cosmo);
+
+  ncm_vector_clear (&self->lower);
+  ncm_vector_clear (&self->upper);
+  ncm_matrix_clear (&self->table);
+
+  _nc_recomb_emul_free_buffers (self);
+
+  ncm_spline_clear (&self->log_Xe_s);
+  ncm_spline_clear (&self->log_XHII_s);
+  ncm_spline_clear (&self->XHeII_s);
+  ncm_spline_clear (&self->Xe_reion_s);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (nc_recomb_emul_parent_class)->dispose (object);
+}
+
+static void
+_nc_recomb_emul_finalize (GObject *object)
+{
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (nc_recomb_emul_parent_class)->finalize (object);
+}
+
+static void _nc_recomb_emul_prepare (NcRecomb *recomb, NcHICosmo *cosmo);
+static gdouble _nc_recomb_emul_Xe (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda);
+static gdouble _nc_recomb_emul_XHII (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda);
+static gdouble _nc_recomb_emul_XHeII (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda);
+
+static void
+nc_recomb_emul_class_init (NcRecombEmulClass *klass)
+{
+  GObjectClass* object_class  = G_OBJECT_CLASS (klass);
+  NcRecombClass* recomb_class = NC_RECOMB_CLASS (klass);
+
+  object_class->set_property  = &_nc_recomb_emul_set_property;
+  object_class->get_property  = &_nc_recomb_emul_get_property;
+  object_class->constructed   = &_nc_recomb_emul_constructed;
+  object_class->dispose       = &_nc_recomb_emul_dispose;
+  object_class->finalize      = &_nc_recomb_emul_finalize;
+
+  /**
+   * NcRecombEmul:nnodes:
+   *
+   * Number of nodes along each varying direction of the table.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_NNODES,
+                                   g_param_spec_uint ("nnodes",
+                                                      NULL,
+                                                      "Number of nodes per direction",
+                                                      2, G_MAXUINT, NC_RECOMB_EMUL_DEFAULT_NNODES,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:nlambda:
+   *
+   * Number of knots in $\lambda$ used to store each ionization history.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_NLAMBDA,
+                                   g_param_spec_uint ("nlambda",
+                                                      NULL,
+                                                      "Number of knots in lambda",
+                                                      10, G_MAXUINT, NC_RECOMB_EMUL_DEFAULT_NLAMBDA,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:fallback:
+   *
+   * Whether to use the exact solver for cosmologies outside the table range.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_FALLBACK,
+                                   g_param_spec_boolean ("fallback",
+                                                         NULL,
+                                                         "Use the exact solver outside the table range",
+                                                         TRUE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:auto-train:
+   *
+   * Whether to build the table from the first cosmology prepared when
+   * the emulator is not trained.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_AUTO_TRAIN,
+                                   g_param_spec_boolean ("auto-train",
+                                                         NULL,
+                                                         "Train on first use",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:lower:
+   *
+   * Lower bounds of the table, ordered as in #NcRecombEmulParam.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_LOWER,
+                                   g_param_spec_object ("lower",
+                                                        NULL,
+                                                        "Lower bounds",
+                                                        NCM_TYPE_VECTOR,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:upper:
+   *
+   * Upper bounds of the table, ordered as in #NcRecombEmulParam.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_UPPER,
+                                   g_param_spec_object ("upper",
+                                                        NULL,
+                                                        "Upper bounds",
+                                                        NCM_TYPE_VECTOR,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  /**
+   * NcRecombEmul:table:
+   *
+   * The precomputed table, one row per node and the three
+   * histories $\ln X_e$, $\ln X_\mathrm{HII}$ and $X_\mathrm{HeII}$
+   * concatenated along the columns.
+   *
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_TABLE,
+                                   g_param_spec_object ("table",
+                                                        NULL,
+                                                        "Precomputed table",
+                                                        NCM_TYPE_MATRIX,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  recomb_class->prepare = &_nc_recomb_emul_prepare;
+  recomb_class->Xe      = &_nc_recomb_emul_Xe;
+  recomb_class->XHII    = &_nc_recomb_emul_XHII;
+  recomb_class->XHeII   = &_nc_recomb_emul_XHeII;
+}
+
+static void
+_nc_recomb_emul_free_buffers (NcRecombEmulPrivate * const self)
+{
+  g_clear_pointer (&self->nodes, g_free);
+  g_clear_pointer (&self->lw, g_free);
+
+  ncm_vector_clear (&self->weights);
+  ncm_vector_clear (&self->interp);
+  ncm_vector_clear (&self->lambda_v);
+  ncm_vector_clear (&self->log_Xe_v);
+  ncm_vector_clear (&self->log_XHII_v);
+  ncm_vector_clear (&self->XHeII_v);
+}
+
+static void
+_nc_recomb_emul_alloc (NcRecombEmul *recomb_emul)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  guint d;
+
+  if (!self->constructed)
+    return;
+
+  _nc_recomb_emul_free_buffers (self);
+
+  self->nodes  = g_new (gdouble, NC_RECOMB_EMUL_PARAM_LEN * self->nnodes);
+  self->lw     = g_new (gdouble, NC_RECOMB_EMUL_PARAM_LEN * self->nnodes);
+  self->ntotal = 1;
+
+  for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+  {
+    const gdouble lb = ncm_vector_get (self->lower, d);
+    const gdouble ub = ncm_vector_get (self->upper, d);
+    gdouble *nodes_d = &self->nodes[d * self->nnodes];
+
+    if (lb == ub)
+    {
+      self->dim_len[d] = 1;
+      nodes_d[0]       = lb;
+    }
+    else
+    {
+      const gdouble c = 0.5 * (ub + lb);
+      const gdouble r = 0.5 * (ub - lb);
+      guint k;
+
+      self->dim_len[d] = self->nnodes;
+
+      for (k = 0; k < self->nnodes; k++)
+        nodes_d[k] = c - r * cos (M_PI * k / (self->nnodes - 1.0));
+
+      nodes_d[0]                = lb;
+      nodes_d[self->nnodes - 1] = ub;
+    }
+
+    self->ntotal *= self->dim_len[d];
+  }
+
+  self->weights    = ncm_vector_new (self->ntotal);
+  self->interp     = ncm_vector_new (3 * self->nlambda);
+  self->lambda_v   = ncm_vector_new (self->nlambda);
+  self->log_Xe_v   = ncm_vector_get_subvector (self->interp, 0, self->nlambda);
+  self->log_XHII_v = ncm_vector_get_subvector (self->interp, self->nlambda, self->nlambda);
+  self->XHeII_v    = ncm_vector_get_subvector (self->interp, 2 * self->nlambda, self->nlambda);
+}
+
+static void
+_nc_recomb_emul_invalidate (NcRecombEmul *recomb_emul)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  if (!self->constructed)
+    return;
+
+  ncm_matrix_clear (&self->table);
+  self->table_lambdai = GSL_NAN;
+
+  _nc_recomb_emul_alloc (recomb_emul);
+  ncm_model_ctrl_force_update (NC_RECOMB (recomb_emul)->ctrl_cosmo);
+}
+
+static void
+_nc_recomb_emul_set_table (NcRecombEmul *recomb_emul, NcmMatrix *table)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  if (table != NULL)
+    ncm_matrix_ref (table);
+
+  ncm_matrix_clear (&self->table);
+  self->table         = table;
+  self->table_lambdai = GSL_NAN;
+
+  if (!self->constructed || (table == NULL))
+    return;
+
+  if ((ncm_matrix_nrows (table) != self->ntotal) || (ncm_matrix_ncols (table) != 3 * self->nlambda))
+    g_error ("_nc_recomb_emul_set_table: table has shape (%u, %u) but the current grid requires (%u, %u).",
+             ncm_matrix_nrows (table), ncm_matrix_ncols (table), self->ntotal, 3 * self->nlambda);
+
+  ncm_model_ctrl_force_update (NC_RECOMB (recomb_emul)->ctrl_cosmo);
+}
+
+static void
+_nc_recomb_emul_sync_seager (NcRecombEmul *recomb_emul)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcRecomb *recomb = NC_RECOMB (recomb_emul);
+  NcRecomb *seager = NC_RECOMB (self->seager);
+
+  if ((seager->zi != recomb->zi) || (seager->prec != recomb->prec) || (seager->init_frac != recomb->init_frac))
+  {
+    g_object_set (seager,
+                  "zi", recomb->zi,
+                  "prec", recomb->prec,
+                  "init-frac", recomb->init_frac,
+                  NULL);
+  }
+}
+
+static void
+_nc_recomb_emul_cosmo_coord (NcHICosmo *cosmo, gdouble *u)
+{
+  u[NC_RECOMB_EMUL_OMEGA_B]  = nc_hicosmo_Omega_b0h2 (cosmo);
+  u[NC_RECOMB_EMUL_OMEGA_C]  = nc_hicosmo_Omega_c0h2 (cosmo);
+  u[NC_RECOMB_EMUL_T_GAMMA0] = nc_hicosmo_T_gamma0 (cosmo);
+  u[NC_RECOMB_EMUL_YP]       = nc_hicosmo_Yp_4He (cosmo);
+  u[NC_RECOMB_EMUL_NEFF]     = nc_hicosmo_Neff (cosmo);
+}
+
+static gboolean
+_nc_recomb_emul_coord_in_range (NcRecombEmulPrivate * const self, const gdouble *u)
+{
+  guint d;
+
+  for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+  {
+    const gdouble lb = ncm_vector_get (self->lower, d);
+    const gdouble ub = ncm_vector_get (self->upper, d);
+
+    if (self->dim_len[d] == 1)
+    {
+      if (!gsl_finite (u[d]) || (fabs (u[d] - lb) > GSL_DBL_EPSILON * 10.0 * fabs (lb)))
+        return FALSE;
+    }
+    else if (!((u[d] >= lb) && (u[d] <= ub)))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+_nc_recomb_emul_set_train_cosmo (NcRecombEmul *recomb_emul, NcHICosmoDE *cosmo_de)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcmModel *model                  = NCM_MODEL (cosmo_de);
+  NcmModel *train_model;
+  guint i;
+
+  /*
+   * A fresh instance carries no submodels, so the exact solver returns the
+   * recombination history without reionization.
+   */
+  nc_hicosmo_clear (&self->train_cosmo);
+  self->train_cosmo = g_object_new (G_OBJECT_TYPE (cosmo_de), NULL);
+  train_model       = NCM_MODEL (self->train_cosmo);
+
+  for (i = 0; i < ncm_model_sparam_len (model); i++)
+    ncm_model_orig_param_set (train_model, i, ncm_model_orig_param_get (model, i));
+
+  ncm_model_param_set_ftype (train_model, NC_HICOSMO_DE_HE_YP, NCM_PARAM_TYPE_FREE);
+}
+
+static void
+_nc_recomb_emul_set_train_coord (NcRecombEmulPrivate * const self, const gdouble *u)
+{
+  NcmModel *model  = NCM_MODEL (self->train_cosmo);
+  const gdouble h2 = nc_hicosmo_h2 (self->train_cosmo);
+
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_OMEGA_B,  u[NC_RECOMB_EMUL_OMEGA_B] / h2);
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_OMEGA_C,  u[NC_RECOMB_EMUL_OMEGA_C] / h2);
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_T_GAMMA0, u[NC_RECOMB_EMUL_T_GAMMA0]);
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_HE_YP,    u[NC_RECOMB_EMUL_YP]);
+  ncm_model_orig_param_set (model, NC_HICOSMO_DE_ENNU,     u[NC_RECOMB_EMUL_NEFF]);
+}
+
+static void
+_nc_recomb_emul_set_lambda (NcRecombEmul *recomb_emul)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcRecomb *recomb                 = NC_RECOMB (recomb_emul);
+  const gdouble lambdai            = recomb->lambdai;
+  const gdouble lambdaf            = recomb->lambdaf;
+  guint j;
+
+  for (j = 0; j < self->nlambda; j++)
+    ncm_vector_set (self->lambda_v, j, lambdai + (lambdaf - lambdai) * j / (self->nlambda - 1.0));
+
+  ncm_vector_set (self->lambda_v, self->nlambda - 1, lambdaf);
+}
+
+static void
+_nc_recomb_emul_interp (NcRecombEmulPrivate * const self, const gdouble *u)
+{
+  guint d, j;
+
+  for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+  {
+    const gdouble *nodes_d = &self->nodes[d * self->nnodes];
+    gdouble *lw_d          = &self->lw[d * self->nnodes];
+    guint k, m;
+
+    for (k = 0; k < self->dim_len[d]; k++)
+    {
+      lw_d[k] = 1.0;
+
+      for (m = 0; m < self->dim_len[d]; m++)
+      {
+        if (m != k)
+          lw_d[k] *= (u[d] - nodes_d[m]) / (nodes_d[k] - nodes_d[m]);
+      }
+    }
+  }
+
+  for (j = 0; j < self->ntotal; j++)
+  {
+    guint r   = j;
+    gdouble w = 1.0;
+
+    for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+    {
+      const guint k = r % self->dim_len[d];
+
+      w *= self->lw[d * self->nnodes + k];
+      r /= self->dim_len[d];
+    }
+
+    ncm_vector_set (self->weights, j, w);
+  }
+
+  gsl_blas_dgemv (CblasTrans, 1.0, ncm_matrix_gsl (self->table), ncm_vector_gsl (self->weights), 0.0, ncm_vector_gsl (self->interp));
+}
+
+static void
+_nc_recomb_emul_node_coord (NcRecombEmulPrivate * const self, guint j, gdouble *u)
+{
+  guint d;
+
+  for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+  {
+    const guint k = j % self->dim_len[d];
+
+    u[d] = self->nodes[d * self->nnodes + k];
+    j   /= self->dim_len[d];
+  }
+}
+
+static gdouble
+_nc_recomb_emul_Xe_recomb (NcRecombEmulPrivate * const self, const gdouble lambda)
+{
+  return exp (ncm_spline_eval (self->log_Xe_s, lambda));
+}
+
+static gdouble
+_nc_recomb_emul_Xe_reion (gdouble lambda, gpointer p)
+{
+  gpointer *m                      = (gpointer *) p;
+  NcRecombEmul *recomb_emul        = NC_RECOMB_EMUL (m[0]);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcHICosmo *cosmo                 = NC_HICOSMO (m[1]);
+  NcHIReion *reion                 = NC_HIREION (m[2]);
+
+  return nc_hireion_get_Xe (reion, cosmo, lambda, _nc_recomb_emul_Xe_recomb (self, lambda));
+}
+
+static void
+_nc_recomb_emul_set_splines (NcRecombEmulPrivate * const self)
+{
+  ncm_spline_set (self->log_Xe_s,   self->lambda_v, self->log_Xe_v,   TRUE);
+  ncm_spline_set (self->log_XHII_s, self->lambda_v, self->log_XHII_v, TRUE);
+  ncm_spline_set (self->XHeII_s,    self->lambda_v, self->XHeII_v,    TRUE);
+}
+
+static void
+_nc_recomb_emul_prepare (NcRecomb *recomb, NcHICosmo *cosmo)
+{
+  NcRecombEmul *recomb_emul        = NC_RECOMB_EMUL (recomb);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcHIReion *reion                 = NC_HIREION (ncm_model_peek_submodel_by_mid (NCM_MODEL (cosmo), nc_hireion_id ()));
+  gdouble u[NC_RECOMB_EMUL_PARAM_LEN];
+
+  if ((self->table != NULL) && gsl_finite (self->table_lambdai) && (self->table_lambdai != recomb->lambdai))
+    ncm_matrix_clear (&self->table);
+
+  if (self->table == NULL)
+  {
+    if (!self->auto_train)
+      g_error ("_nc_recomb_emul_prepare: emulator not trained, call nc_recomb_emul_train() first or enable auto-train.");
+
+    if (!NC_IS_HICOSMO_DE (cosmo))
+      g_error ("_nc_recomb_emul_prepare: emulator not trained and `%s' cannot be used as a template, call nc_recomb_emul_train() first.",
+               G_OBJECT_TYPE_NAME (cosmo));
+
+    g_debug ("_nc_recomb_emul_prepare: training the emulator on %u nodes.", self->ntotal);
+
+    nc_recomb_emul_train (recomb_emul, NC_HICOSMO_DE (cosmo));
+  }
+
+  self->table_lambdai = recomb->lambdai;
+
+  _nc_recomb_emul_cosmo_coord (cosmo, u);
+
+  if (!_nc_recomb_emul_coord_in_range (self, u))
+  {
+    if (!self->fallback)
+      g_error ("_nc_recomb_emul_prepare: cosmology outside the emulator range and fallback is disabled.");
+
+    _nc_recomb_emul_sync_seager (recomb_emul);
+    nc_recomb_prepare (NC_RECOMB (self->seager), cosmo);
+
+    self->exact = TRUE;
+  }
+  else
+  {
+    _nc_recomb_emul_set_lambda (recomb_emul);
+    _nc_recomb_emul_interp (self, u);
+    _nc_recomb_emul_set_splines (self);
+
+    if (reion != NULL)
+    {
+      gpointer m[3] = {recomb_emul, cosmo, reion};
+      gsl_function F;
+
+      F.function = &_nc_recomb_emul_Xe_reion;
+      F.params   = m;
+
+      ncm_spline_set_func (self->Xe_reion_s, NCM_SPLINE_FUNCTION_SPLINE,
+                           &F, recomb->lambdai, recomb->lambdaf, 0, recomb->prec);
+    }
+
+    self->has_reion = (reion != NULL);
+    self->exact     = FALSE;
+  }
+
+  _nc_recomb_prepare_tau_splines (recomb, cosmo);
+  _nc_recomb_prepare_redshifts (recomb, cosmo);
+}
+
+static gdouble
+_nc_recomb_emul_Xe (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda)
+{
+  NcRecombEmul *recomb_emul        = NC_RECOMB_EMUL (recomb);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  if (self->exact)
+    return nc_recomb_Xe (NC_RECOMB (self->seager), cosmo, lambda);
+  else if (self->has_reion)
+    return ncm_spline_eval (self->Xe_reion_s, lambda);
+  else
+    return _nc_recomb_emul_Xe_recomb (self, lambda);
+}
+
+static gdouble
+_nc_recomb_emul_XHII (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda)
+{
+  NcRecombEmul *recomb_emul        = NC_RECOMB_EMUL (recomb);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  if (self->exact)
+    return nc_recomb_XHII (NC_RECOMB (self->seager), cosmo, lambda);
+  else
+    return exp (ncm_spline_eval (self->log_XHII_s, lambda));
+}
+
+static gdouble
+_nc_recomb_emul_XHeII (NcRecomb *recomb, NcHICosmo *cosmo, const gdouble lambda)
+{
+  NcRecombEmul *recomb_emul        = NC_RECOMB_EMUL (recomb);
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  if (self->exact)
+    return nc_recomb_XHeII (NC_RECOMB (self->seager), cosmo, lambda);
+  else
+    return ncm_spline_eval (self->XHeII_s, lambda);
+}
+
+/**
+ * nc_recomb_emul_new:
+ *
+ * Creates a new #NcRecombEmul using default properties.
+ *
+ * Returns: (transfer full): a new #NcRecombEmul.
+ */
+NcRecombEmul *
+nc_recomb_emul_new (void)
+{
+  return g_object_new (NC_TYPE_RECOMB_EMUL,
+                       NULL);
+}
+
+/**
+ * nc_recomb_emul_new_full:
+ * @init_frac: inital fraction of HeIII
+ * @zi: initial redshift
+ * @prec: precision
+ *
+ * Creates a new #NcRecombEmul using @init_frac, @zi and @prec.
+ *
+ * Returns: (transfer full): a new #NcRecombEmul.
+ */
+NcRecombEmul *
+nc_recomb_emul_new_full (gdouble init_frac, gdouble zi, gdouble prec)
+{
+  return g_object_new (NC_TYPE_RECOMB_EMUL,
+                       "init-frac", init_frac,
+                       "zi", zi,
+                       "prec", prec,
+                       NULL);
+}
+
+/**
+ * nc_recomb_emul_ref:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Increases the reference count of @recomb_emul.
+ *
+ * Returns: (transfer full): @recomb_emul.
+ */
+NcRecombEmul *
+nc_recomb_emul_ref (NcRecombEmul *recomb_emul)
+{
+  return g_object_ref (recomb_emul);
+}
+
+/**
+ * nc_recomb_emul_free:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Decreases the reference count of @recomb_emul.
+ *
+ */
+void
+nc_recomb_emul_free (NcRecombEmul *recomb_emul)
+{
+  g_object_unref (recomb_emul);
+}
+
+/**
+ * nc_recomb_emul_clear:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Decreases the reference count of *@recomb_emul if
+ * *@recomb_emul is not NULL, then sets *@recomb_emul to NULL.
+ *
+ */
+void
+nc_recomb_emul_clear (NcRecombEmul **recomb_emul)
+{
+  g_clear_object (recomb_emul);
+}
+
+/**
+ * nc_recomb_emul_set_range:
+ * @recomb_emul: a #NcRecombEmul
+ * @p: a #NcRecombEmulParam
+ * @lb: lower bound
+ * @ub: upper bound
+ *
+ * Sets the table range of the parameter @p to $[@lb, @ub]$. When
+ * @lb equals @ub the parameter is kept fixed. Changing the range
+ * discards the current table.
+ *
+ */
+void
+nc_recomb_emul_set_range (NcRecombEmul *recomb_emul, NcRecombEmulParam p, const gdouble lb, const gdouble ub)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  g_assert_cmpuint (p, <, NC_RECOMB_EMUL_PARAM_LEN);
+  g_assert_cmpfloat (lb, <=, ub);
+
+  if ((ncm_vector_get (self->lower, p) != lb) || (ncm_vector_get (self->upper, p) != ub))
+  {
+    ncm_vector_set (self->lower, p, lb);
+    ncm_vector_set (self->upper, p, ub);
+    _nc_recomb_emul_invalidate (recomb_emul);
+  }
+}
+
+/**
+ * nc_recomb_emul_get_range:
+ * @recomb_emul: a #NcRecombEmul
+ * @p: a #NcRecombEmulParam
+ * @lb: (out): lower bound
+ * @ub: (out): upper bound
+ *
+ * Gets the table range of the parameter @p.
+ *
+ */
+void
+nc_recomb_emul_get_range (NcRecombEmul *recomb_emul, NcRecombEmulParam p, gdouble *lb, gdouble *ub)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  g_assert_cmpuint (p, <, NC_RECOMB_EMUL_PARAM_LEN);
+
+  lb[0] = ncm_vector_get (self->lower, p);
+  ub[0] = ncm_vector_get (self->upper, p);
+}
+
+/**
+ * nc_recomb_emul_set_nnodes:
+ * @recomb_emul: a #NcRecombEmul
+ * @nnodes: number of nodes
+ *
+ * Sets the number of nodes along each varying direction. Changing
+ * it discards the current table.
+ *
+ */
+void
+nc_recomb_emul_set_nnodes (NcRecombEmul *recomb_emul, guint nnodes)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  g_assert_cmpuint (nnodes, >, 1);
+
+  if (self->nnodes != nnodes)
+  {
+    self->nnodes = nnodes;
+    _nc_recomb_emul_invalidate (recomb_emul);
+  }
+}
+
+/**
+ * nc_recomb_emul_get_nnodes:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: the number of nodes along each varying direction.
+ */
+guint
+nc_recomb_emul_get_nnodes (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->nnodes;
+}
+
+/**
+ * nc_recomb_emul_set_nlambda:
+ * @recomb_emul: a #NcRecombEmul
+ * @nlambda: number of knots
+ *
+ * Sets the number of knots in $\lambda$. Changing it discards the
+ * current table.
+ *
+ */
+void
+nc_recomb_emul_set_nlambda (NcRecombEmul *recomb_emul, guint nlambda)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+
+  g_assert_cmpuint (nlambda, >=, 10);
+
+  if (self->nlambda != nlambda)
+  {
+    self->nlambda = nlambda;
+    _nc_recomb_emul_invalidate (recomb_emul);
+  }
+}
+
+/**
+ * nc_recomb_emul_get_nlambda:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: the number of knots in $\lambda$.
+ */
+guint
+nc_recomb_emul_get_nlambda (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->nlambda;
+}
+
+/**
+ * nc_recomb_emul_set_fallback:
+ * @recomb_emul: a #NcRecombEmul
+ * @fallback: whether to use the exact solver outside the table range
+ *
+ * Sets whether cosmologies outside the table range are computed
+ * with the exact solver. When disabled they result in an error.
+ *
+ */
+void
+nc_recomb_emul_set_fallback (NcRecombEmul *recomb_emul, gboolean fallback)
+{
+  recomb_emul->priv->fallback = fallback;
+}
+
+/**
+ * nc_recomb_emul_get_fallback:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: whether the exact solver is used outside the table range.
+ */
+gboolean
+nc_recomb_emul_get_fallback (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->fallback;
+}
+
+/**
+ * nc_recomb_emul_set_auto_train:
+ * @recomb_emul: a #NcRecombEmul
+ * @auto_train: whether to train on first use
+ *
+ * Sets whether preparing an untrained emulator builds the table using
+ * the cosmology being prepared as template, see nc_recomb_emul_train().
+ * When disabled it results in an error.
+ *
+ */
+void
+nc_recomb_emul_set_auto_train (NcRecombEmul *recomb_emul, gboolean auto_train)
+{
+  recomb_emul->priv->auto_train = auto_train;
+}
+
+/**
+ * nc_recomb_emul_get_auto_train:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: whether the table is built on first use.
+ */
+gboolean
+nc_recomb_emul_get_auto_train (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->auto_train;
+}
+
+/**
+ * nc_recomb_emul_peek_seager:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: (transfer none): the exact solver used to build the table.
+ */
+NcRecombSeager *
+nc_recomb_emul_peek_seager (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->seager;
+}
+
+/**
+ * nc_recomb_emul_peek_table:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: (transfer none) (nullable): the precomputed table or NULL if not trained.
+ */
+NcmMatrix *
+nc_recomb_emul_peek_table (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->table;
+}
+
+/**
+ * nc_recomb_emul_is_trained:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: whether @recomb_emul contains a table.
+ */
+gboolean
+nc_recomb_emul_is_trained (NcRecombEmul *recomb_emul)
+{
+  return (recomb_emul->priv->table != NULL);
+}
+
+/**
+ * nc_recomb_emul_in_range:
+ * @recomb_emul: a #NcRecombEmul
+ * @cosmo: a #NcHICosmo
+ *
+ * Returns: whether @cosmo lies inside the table range.
+ */
+gboolean
+nc_recomb_emul_in_range (NcRecombEmul *recomb_emul, NcHICosmo *cosmo)
+{
+  gdouble u[NC_RECOMB_EMUL_PARAM_LEN];
+
+  _nc_recomb_emul_cosmo_coord (cosmo, u);
+
+  return _nc_recomb_emul_coord_in_range (recomb_emul->priv, u);
+}
+
+/**
+ * nc_recomb_emul_is_exact:
+ * @recomb_emul: a #NcRecombEmul
+ *
+ * Returns: whether the last preparation used the exact solver.
+ */
+gboolean
+nc_recomb_emul_is_exact (NcRecombEmul *recomb_emul)
+{
+  return recomb_emul->priv->exact;
+}
+
+/**
+ * nc_recomb_emul_train:
+ * @recomb_emul: a #NcRecombEmul
+ * @cosmo_de: a #NcHICosmoDE
+ *
+ * Builds the table running the exact solver at every node. The
+ * parameters of @cosmo_de not spanned by the table, e.g. $H_0$,
+ * are used as the template for all nodes; its submodels are
+ * ignored. The model @cosmo_de is not modified.
+ *
+ */
+void
+nc_recomb_emul_train (NcRecombEmul *recomb_emul, NcHICosmoDE *cosmo_de)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcRecomb *recomb                 = NC_RECOMB (recomb_emul);
+  NcRecomb *seager                 = NC_RECOMB (self->seager);
+  NcmMatrix *table                 = ncm_matrix_new (self->ntotal, 3 * self->nlambda);
+  guint j;
+
+  _nc_recomb_emul_sync_seager (recomb_emul);
+  _nc_recomb_emul_set_train_cosmo (recomb_emul, cosmo_de);
+  _nc_recomb_emul_set_lambda (recomb_emul);
+
+  for (j = 0; j < self->ntotal; j++)
+  {
+    gdouble u[NC_RECOMB_EMUL_PARAM_LEN];
+    guint i;
+
+    _nc_recomb_emul_node_coord (self, j, u);
+    _nc_recomb_emul_set_train_coord (self, u);
+
+    nc_recomb_prepare (seager, self->train_cosmo);
+
+    for (i = 0; i < self->nlambda; i++)
+    {
+      const gdouble lambda = ncm_vector_get (self->lambda_v, i);
+
+      ncm_matrix_set (table, j, i,                     log (nc_recomb_Xe (seager, self->train_cosmo, lambda)));
+      ncm_matrix_set (table, j, self->nlambda + i,     log (nc_recomb_XHII (seager, self->train_cosmo, lambda)));
+      ncm_matrix_set (table, j, 2 * self->nlambda + i, nc_recomb_XHeII (seager, self->train_cosmo, lambda));
+    }
+  }
+
+  _nc_recomb_emul_set_table (recomb_emul, table);
+  self->table_lambdai = recomb->lambdai;
+
+  ncm_matrix_free (table);
+}
+
+/**
+ * nc_recomb_emul_validate:
+ * @recomb_emul: a #NcRecombEmul
+ * @cosmo_de: a #NcHICosmoDE
+ * @nsamples: number of test points
+ * @rng: a #NcmRNG
+ *
+ * Compares the emulator against the exact solver at @nsamples
+ * points drawn uniformly inside the table range, using @cosmo_de
+ * as template as in nc_recomb_emul_train(). The comparison is made
+ * at the midpoints of the $\lambda$ knots, so it includes both the
+ * interpolation across nodes and the spline error.
+ *
+ * Returns: the maximum relative error in $X_e$ over all test points.
+ */
+gdouble
+nc_recomb_emul_validate (NcRecombEmul *recomb_emul, NcHICosmoDE *cosmo_de, guint nsamples, NcmRNG *rng)
+{
+  NcRecombEmulPrivate * const self = recomb_emul->priv;
+  NcRecomb *recomb                 = NC_RECOMB (recomb_emul);
+  NcRecomb *seager                 = NC_RECOMB (self->seager);
+  gdouble max_rel_err              = 0.0;
+  guint n;
+
+  if (self->table == NULL)
+    nc_recomb_emul_train (recomb_emul, cosmo_de);
+  else
+    _nc_recomb_emul_set_train_cosmo (recomb_emul, cosmo_de);
+
+  _nc_recomb_emul_sync_seager (recomb_emul);
+  _nc_recomb_emul_set_lambda (recomb_emul);
+
+  for (n = 0; n < nsamples; n++)
+  {
+    gdouble u[NC_RECOMB_EMUL_PARAM_LEN];
+    guint d, i;
+
+    ncm_rng_lock (rng);
+    for (d = 0; d < NC_RECOMB_EMUL_PARAM_LEN; d++)
+    {
+      const gdouble lb = ncm_vector_get (self->lower, d);
+      const gdouble ub = ncm_vector_get (self->upper, d);
+
+      u[d] = (lb == ub) ? lb : ncm_rng_uniform_gen (rng, lb, ub);
+    }
+    ncm_rng_unlock (rng);
+
+    _nc_recomb_emul_set_train_coord (self, u);
+    nc_recomb_prepare (seager, self->train_cosmo);
+
+    _nc_recomb_emul_cosmo_coord (self->train_cosmo, u);
+    _nc_recomb_emul_interp (self, u);
+    _nc_recomb_emul_set_splines (self);
+
+    for (i = 0; i + 1 < self->nlambda; i++)
+    {
+      const gdouble lambda   = 0.5 * (ncm_vector_get (self->lambda_v, i) + ncm_vector_get (self->lambda_v, i + 1));
+      const gdouble Xe_exact = nc_recomb_Xe (seager, self->train_cosmo, lambda);
+      const gdouble Xe_emul  = _nc_recomb_emul_Xe_recomb (self, lambda);
+
+      max_rel_err = GSL_MAX (max_rel_err, fabs (Xe_emul / Xe_exact - 1.0));
+    }
+  }
+
+  /* The splines now hold the last test point. */
+  ncm_model_ctrl_force_update (recomb->ctrl_cosmo);
+
+  return max_rel_err;
+}
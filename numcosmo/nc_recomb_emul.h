@@ -0,0 +1,132 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 2; tab-width: 2 -*-  */
+/***************************************************************************
+ *            nc_recomb_emul.h
+ *
+ *  Sun October 18 10:12:44 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * nc_recomb_emul.h
+ * Copyright (C) 2026 Sandro Dias Pinto Vitenti <sandro@isoftware.com.br>
+ *
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NC_RECOMB_EMUL_H_
+#define _NC_RECOMB_EMUL_H_
+
+#include <glib.h>
+#include <glib-object.h>
+#include <numcosmo/build_cfg.h>
+#include <numcosmo/nc_recomb.h>
+#include <numcosmo/nc_recomb_seager.h>
+#include <numcosmo/model/nc_hicosmo_de.h>
+#include <numcosmo/math/ncm_matrix.h>
+#include <numcosmo/math/ncm_rng.h>
+
+G_BEGIN_DECLS
+
+#define NC_TYPE_RECOMB_EMUL             (nc_recomb_emul_get_type ())
+#define NC_RECOMB_EMUL(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), NC_TYPE_RECOMB_EMUL, NcRecombEmul))
+#define NC_RECOMB_EMUL_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), NC_TYPE_RECOMB_EMUL, NcRecombEmulClass))
+#define NC_IS_RECOMB_EMUL(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NC_TYPE_RECOMB_EMUL))
+#define NC_IS_RECOMB_EMUL_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), NC_TYPE_RECOMB_EMUL))
+#define NC_RECOMB_EMUL_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), NC_TYPE_RECOMB_EMUL, NcRecombEmulClass))
+
+typedef struct _NcRecombEmulClass NcRecombEmulClass;
+typedef struct _NcRecombEmul NcRecombEmul;
+typedef struct _NcRecombEmulPrivate NcRecombEmulPrivate;
+
+struct _NcRecombEmulClass
+{
+  /*< private >*/
+  NcRecombClass parent_class;
+};
+
+/**
+ * NcRecombEmulParam:
+ * @NC_RECOMB_EMUL_OMEGA_B: physical baryon density $\omega_b = \Omega_{b0}h^2$.
+ * @NC_RECOMB_EMUL_OMEGA_C: physical cold dark matter density $\omega_c = \Omega_{c0}h^2$.
+ * @NC_RECOMB_EMUL_T_GAMMA0: CMB temperature today $T_{\gamma0}$.
+ * @NC_RECOMB_EMUL_YP: primordial helium mass fraction $Y_p$.
+ * @NC_RECOMB_EMUL_NEFF: effective number of relativistic species $N_\mathrm{eff}$.
+ *
+ * Parameters spanned by the emulator table.
+ *
+ */
+typedef enum _NcRecombEmulParam
+{
+  NC_RECOMB_EMUL_OMEGA_B = 0,
+  NC_RECOMB_EMUL_OMEGA_C,
+  NC_RECOMB_EMUL_T_GAMMA0,
+  NC_RECOMB_EMUL_YP,
+  NC_RECOMB_EMUL_NEFF,
+  /* < private > */
+  NC_RECOMB_EMUL_PARAM_LEN, /*< skip >*/
+} NcRecombEmulParam;
+
+struct _NcRecombEmul
+{
+  /*< private >*/
+  NcRecomb parent_instance;
+  NcRecombEmulPrivate *priv;
+};
+
+GType nc_recomb_emul_get_type (void) G_GNUC_CONST;
+
+NcRecombEmul *nc_recomb_emul_new (void);
+NcRecombEmul *nc_recomb_emul_new_full (gdouble init_frac, gdouble zi, gdouble prec);
+NcRecombEmul *nc_recomb_emul_ref (NcRecombEmul *recomb_emul);
+void nc_recomb_emul_free (NcRecombEmul *recomb_emul);
+void nc_recomb_emul_clear (NcRecombEmul **recomb_emul);
+
+void nc_recomb_emul_set_range (NcRecombEmul *recomb_emul, NcRecombEmulParam p, const gdouble lb, const gdouble ub);
+void nc_recomb_emul_get_range (NcRecombEmul *recomb_emul, NcRecombEmulParam p, gdouble *lb, gdouble *ub);
+void nc_recomb_emul_set_nnodes (NcRecombEmul *recomb_emul, guint nnodes);
+guint nc_recomb_emul_get_nnodes (NcRecombEmul *recomb_emul);
+void nc_recomb_emul_set_nlambda (NcRecombEmul *recomb_emul, guint nlambda);
+guint nc_recomb_emul_get_nlambda (NcRecombEmul *recomb_emul);
+void nc_recomb_emul_set_fallback (NcRecombEmul *recomb_emul, gboolean fallback);
+gboolean nc_recomb_emul_get_fallback (NcRecombEmul *recomb_emul);
+void nc_recomb_emul_set_auto_train (NcRecombEmul *recomb_emul, gboolean auto_train);
+gboolean nc_recomb_emul_get_auto_train (NcRecombEmul *recomb_emul);
+
+NcRecombSeager *nc_recomb_emul_peek_seager (NcRecombEmul *recomb_emul);
+NcmMatrix *nc_recomb_emul_peek_table (NcRecombEmul *recomb_emul);
+gboolean nc_recomb_emul_is_trained (NcRecombEmul *recomb_emul);
+gboolean nc_recomb_emul_in_range (NcRecombEmul *recomb_emul, NcHICosmo *cosmo);
+gboolean nc_recomb_emul_is_exact (NcRecombEmul *recomb_emul);
+
+void nc_recomb_emul_train (NcRecombEmul *recomb_emul, NcHICosmoDE *cosmo_de);
+gdouble nc_recomb_emul_validate (NcRecombEmul *recomb_emul, NcHICosmoDE *cosmo_de, guint nsamples, NcmRNG *rng);
+
+/**
+ * NC_RECOMB_EMUL_DEFAULT_NNODES:
+ *
+ * Default number of nodes per direction, it keeps the relative error in
+ * $X_e$ below $10^{-4}$ over the default box.
+ */
+#define NC_RECOMB_EMUL_DEFAULT_NNODES (5)
+
+/**
+ * NC_RECOMB_EMUL_DEFAULT_NLAMBDA:
+ *
+ * Default number of knots in $\lambda$.
+ */
+#define NC_RECOMB_EMUL_DEFAULT_NLAMBDA (3000)
+
+G_END_DECLS
+
+#endif /* _NC_RECOMB_EMUL_H_ */
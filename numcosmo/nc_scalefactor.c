@@ -33,7 +33,20 @@
  * $E = H / H_0$ is the dimensionless Hubble function [nc_hicosmo_E()] 
  * and $\Omega_{k0}$ is the curvature parameter today [nc_hicosmo_Omega_k0()].
  * 
- * 
+ * Besides the splines used by the scalar evaluation functions, each prepare
+ * also builds monotone cubic Hermite interpolants for $z(\eta)$, $t(\eta)$
+ * and their inverses. They use the exact derivatives $dz/d\eta = -E$ and
+ * $dt/d\eta = 1/(1+z)$ at the integration nodes, limited with the
+ * Fritsch-Carlson conditions so that the interpolants and their inverses
+ * are strictly monotone. The array functions, e.g.,
+ * nc_scalefactor_eval_eta_z_array(), use only these read-only tables and
+ * can be called concurrently from different threads after
+ * nc_scalefactor_prepare(). They return an estimate of the largest
+ * interpolation error in the intervals used, obtained from the difference
+ * between the Hermite interpolant and the cubic spline at the middle of
+ * each interval. Unlike the scalar functions they do not extrapolate,
+ * inputs outside the integrated interval are clamped to its borders and
+ * reported with a warning.
  * 
  */
 
@@ -52,6 +65,7 @@
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
 #include <nvector/nvector_serial.h>
+#include <gsl/gsl_math.h>
 #define SUN_DENSE_ACCESS SM_ELEMENT_D
 #endif /* NUMCOSMO_GIR_SCAN */
 
@@ -66,6 +80,18 @@ enum
   PROP_ABSTOL,
 };
 
+/*
+ * Monotone cubic Hermite table y(x), with one slope per knot
+ * and one error estimate per interval.
+ */
+typedef struct _NcScalefactorHermite
+{
+  GArray *x;
+  GArray *y;
+  GArray *m;
+  GArray *err;
+} NcScalefactorHermite;
+
 struct _NcScalefactorPrivate
 {
   NcDistance *dist;
@@ -89,10 +115,154 @@ struct _NcScalefactorPrivate
   N_Vector y;
   SUNMatrix A;
   SUNLinearSolver LS;
+  NcScalefactorHermite *h_mz_eta;
+  NcScalefactorHermite *h_eta_mz;
+  NcScalefactorHermite *h_t_eta;
+  NcScalefactorHermite *h_eta_t;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (NcScalefactor, nc_scalefactor, G_TYPE_OBJECT);
 
+static NcScalefactorHermite *
+_nc_scalefactor_hermite_new (void)
+{
+  NcScalefactorHermite *h = g_new (NcScalefactorHermite, 1);
+
+  h->x   = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  h->y   = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  h->m   = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  h->err = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  return h;
+}
+
+static void
+_nc_scalefactor_hermite_free (NcScalefactorHermite *h)
+{
+  g_array_unref (h->x);
+  g_array_unref (h->y);
+  g_array_unref (h->m);
+  g_array_unref (h->err);
+  g_free (h);
+}
+
+static gdouble
+_nc_scalefactor_hermite_eval_interval (NcScalefactorHermite *h, const guint k, const gdouble x)
+{
+  const gdouble x0  = g_array_index (h->x, gdouble, k);
+  const gdouble x1  = g_array_index (h->x, gdouble, k + 1);
+  const gdouble dx  = x1 - x0;
+  const gdouble s   = (x - x0) / dx;
+  const gdouble s2  = s * s;
+  const gdouble s3  = s2 * s;
+  const gdouble h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+  const gdouble h10 = s3 - 2.0 * s2 + s;
+  const gdouble h01 = -2.0 * s3 + 3.0 * s2;
+  const gdouble h11 = s3 - s2;
+
+  return h00 * g_array_index (h->y, gdouble, k) + h10 * dx * g_array_index (h->m, gdouble, k) +
+         h01 * g_array_index (h->y, gdouble, k + 1) + h11 * dx * g_array_index (h->m, gdouble, k + 1);
+}
+
+/*
+ * Points outside the knots are clamped to the first or last knot, counted
+ * in n_out, and evaluated there instead of extrapolating the cubic.
+ */
+static gdouble
+_nc_scalefactor_hermite_eval (NcScalefactorHermite *h, gdouble x, gdouble *err, guint *n_out)
+{
+  const gdouble x_min = g_array_index (h->x, gdouble, 0);
+  const gdouble x_max = g_array_index (h->x, gdouble, h->x->len - 1);
+  guint k;
+
+  if (x < x_min)
+  {
+    x = x_min;
+    (*n_out)++;
+  }
+  else if (x > x_max)
+  {
+    x = x_max;
+    (*n_out)++;
+  }
+
+  k    = _ncm_spline_bsearch_stride ((gdouble *)h->x->data, 1, x, 0, h->x->len - 1);
+  *err = GSL_MAX (*err, g_array_index (h->err, gdouble, k));
+
+  return _nc_scalefactor_hermite_eval_interval (h, k, x);
+}
+
+static void
+_nc_scalefactor_hermite_report_out (const gchar *func, const guint n_out, const guint len, const gdouble lb, const gdouble ub)
+{
+  if (n_out > 0)
+    g_warning ("%s: %u of %u values outside the interpolation interval [% 22.15g, % 22.15g], clamped to the interval.",
+               func, n_out, len, lb, ub);
+}
+
+/*
+ * Copies the knots and the exact slopes dy_dx, applies the Fritsch-Carlson
+ * limiter to guarantee a monotone interpolant and estimates the error in
+ * each interval by comparing with the spline @s at the middle point.
+ */
+static void
+_nc_scalefactor_hermite_set (NcScalefactorHermite *h, GArray *x, GArray *y, GArray *dy_dx, NcmSpline *s)
+{
+  const guint len = x->len;
+  guint k;
+
+  g_assert_cmpuint (len, >, 1);
+  g_assert_cmpuint (y->len, ==, len);
+  g_assert_cmpuint (dy_dx->len, ==, len);
+
+  g_array_set_size (h->x, 0);
+  g_array_set_size (h->y, 0);
+  g_array_set_size (h->m, 0);
+  g_array_append_vals (h->x, x->data, len);
+  g_array_append_vals (h->y, y->data, len);
+  g_array_append_vals (h->m, dy_dx->data, len);
+
+  for (k = 0; k + 1 < len; k++)
+  {
+    const gdouble delta = (g_array_index (h->y, gdouble, k + 1) - g_array_index (h->y, gdouble, k)) / 
+                          (g_array_index (h->x, gdouble, k + 1) - g_array_index (h->x, gdouble, k));
+    gdouble *m0 = &g_array_index (h->m, gdouble, k);
+    gdouble *m1 = &g_array_index (h->m, gdouble, k + 1);
+
+    if (delta == 0.0)
+    {
+      *m0 = 0.0;
+      *m1 = 0.0;
+    }
+    else
+    {
+      const gdouble alpha = GSL_MAX (*m0 / delta, 0.0);
+      const gdouble beta  = GSL_MAX (*m1 / delta, 0.0);
+      const gdouble tau2  = alpha * alpha + beta * beta;
+
+      if (tau2 > 9.0)
+      {
+        const gdouble tau = 3.0 / sqrt (tau2);
+        *m0 = tau * alpha * delta;
+        *m1 = tau * beta * delta;
+      }
+      else
+      {
+        *m0 = alpha * delta;
+        *m1 = beta * delta;
+      }
+    }
+  }
+
+  g_array_set_size (h->err, len - 1);
+  for (k = 0; k + 1 < len; k++)
+  {
+    const gdouble x_m = 0.5 * (g_array_index (h->x, gdouble, k) + g_array_index (h->x, gdouble, k + 1));
+
+    g_array_index (h->err, gdouble, k) = fabs (_nc_scalefactor_hermite_eval_interval (h, k, x_m) - ncm_spline_eval (s, x_m));
+  }
+}
+
 static void
 nc_scalefactor_init (NcScalefactor *a)
 {
@@ -129,6 +299,11 @@ nc_scalefactor_init (NcScalefactor *a)
   
   NCM_CVODE_CHECK ((gpointer)self->A, "SUNDenseMatrix", 0, );
   NCM_CVODE_CHECK ((gpointer)self->LS, "SUNDenseLinearSolver", 0, );
+
+  self->h_mz_eta    = _nc_scalefactor_hermite_new ();
+  self->h_eta_mz    = _nc_scalefactor_hermite_new ();
+  self->h_t_eta     = _nc_scalefactor_hermite_new ();
+  self->h_eta_t     = _nc_scalefactor_hermite_new ();
 }
 
 static void
@@ -169,6 +344,11 @@ nc_scalefactor_finalize (GObject *object)
     self->LS = NULL;
   }
 
+  _nc_scalefactor_hermite_free (self->h_mz_eta);
+  _nc_scalefactor_hermite_free (self->h_eta_mz);
+  _nc_scalefactor_hermite_free (self->h_t_eta);
+  _nc_scalefactor_hermite_free (self->h_eta_t);
+
   /* Chain up : end */
   G_OBJECT_CLASS (nc_scalefactor_parent_class)->finalize (object);
 }
@@ -369,6 +549,7 @@ nc_scalefactor_clear (NcScalefactor **a)
 
 static void _nc_scalefactor_init (NcScalefactor *a, NcHICosmo *cosmo);
 static void _nc_scalefactor_calc_spline (NcScalefactor *a, NcHICosmo *cosmo);
+static void _nc_scalefactor_calc_hermite (NcScalefactor *a, NcHICosmo *cosmo, GArray *eta_a, GArray *mz_a, GArray *t_a);
 
 /**
  * nc_scalefactor_prepare:
@@ -762,6 +943,143 @@ nc_scalefactor_eval_eta_t (NcScalefactor *a, const gdouble t)
   return ncm_spline_eval (self->eta_t, t);
 }
 
+/**
+ * nc_scalefactor_eval_z_eta_array:
+ * @a: a #NcScalefactor
+ * @eta: a #NcmVector containing conformal times $\eta_i$
+ * @z: a #NcmVector to store $z(\eta_i)$
+ *
+ * Calculates the redshift for each element of @eta using the monotone
+ * interpolant, @eta and @z can be the same vector. This function is
+ * thread-safe after nc_scalefactor_prepare(). Values outside the
+ * integrated interval are clamped to it and reported with a warning.
+ *
+ * Returns: an estimate of the largest absolute error in $z$.
+ */
+gdouble
+nc_scalefactor_eval_z_eta_array (NcScalefactor *a, NcmVector *eta, NcmVector *z)
+{
+  NcScalefactorPrivate * const self = a->priv;
+  const guint len = ncm_vector_len (eta);
+  gdouble err = 0.0;
+  guint n_out = 0;
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (z), ==, len);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (z, i, -_nc_scalefactor_hermite_eval (self->h_mz_eta, ncm_vector_get (eta, i), &err, &n_out));
+
+  _nc_scalefactor_hermite_report_out ("nc_scalefactor_eval_z_eta_array", n_out, len,
+                                      g_array_index (self->h_mz_eta->x, gdouble, 0),
+                                      g_array_index (self->h_mz_eta->x, gdouble, self->h_mz_eta->x->len - 1));
+
+  return err;
+}
+
+/**
+ * nc_scalefactor_eval_eta_z_array:
+ * @a: a #NcScalefactor
+ * @z: a #NcmVector containing redshifts $z_i$
+ * @eta: a #NcmVector to store $\eta(z_i)$
+ *
+ * Calculates the conformal time for each element of @z using the monotone
+ * inverse interpolant, @z and @eta can be the same vector. This function is
+ * thread-safe after nc_scalefactor_prepare(). Values outside the
+ * integrated interval are clamped to it and reported with a warning.
+ *
+ * Returns: an estimate of the largest absolute error in $\eta$.
+ */
+gdouble
+nc_scalefactor_eval_eta_z_array (NcScalefactor *a, NcmVector *z, NcmVector *eta)
+{
+  NcScalefactorPrivate * const self = a->priv;
+  const guint len = ncm_vector_len (z);
+  gdouble err = 0.0;
+  guint n_out = 0;
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (eta), ==, len);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (eta, i, _nc_scalefactor_hermite_eval (self->h_eta_mz, -ncm_vector_get (z, i), &err, &n_out));
+
+  _nc_scalefactor_hermite_report_out ("nc_scalefactor_eval_eta_z_array", n_out, len,
+                                      -g_array_index (self->h_eta_mz->x, gdouble, self->h_eta_mz->x->len - 1),
+                                      -g_array_index (self->h_eta_mz->x, gdouble, 0));
+
+  return err;
+}
+
+/**
+ * nc_scalefactor_eval_t_eta_array:
+ * @a: a #NcScalefactor
+ * @eta: a #NcmVector containing conformal times $\eta_i$
+ * @t: a #NcmVector to store $t(\eta_i)$
+ *
+ * Calculates the cosmic time for each element of @eta using the monotone
+ * interpolant, @eta and @t can be the same vector. This function is
+ * thread-safe after nc_scalefactor_prepare(). Values outside the
+ * integrated interval are clamped to it and reported with a warning.
+ *
+ * Returns: an estimate of the largest absolute error in $t$.
+ */
+gdouble
+nc_scalefactor_eval_t_eta_array (NcScalefactor *a, NcmVector *eta, NcmVector *t)
+{
+  NcScalefactorPrivate * const self = a->priv;
+  const guint len = ncm_vector_len (eta);
+  gdouble err = 0.0;
+  guint n_out = 0;
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (t), ==, len);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (t, i, _nc_scalefactor_hermite_eval (self->h_t_eta, ncm_vector_get (eta, i), &err, &n_out));
+
+  _nc_scalefactor_hermite_report_out ("nc_scalefactor_eval_t_eta_array", n_out, len,
+                                      g_array_index (self->h_t_eta->x, gdouble, 0),
+                                      g_array_index (self->h_t_eta->x, gdouble, self->h_t_eta->x->len - 1));
+
+  return err;
+}
+
+/**
+ * nc_scalefactor_eval_eta_t_array:
+ * @a: a #NcScalefactor
+ * @t: a #NcmVector containing cosmic times $t_i$
+ * @eta: a #NcmVector to store $\eta(t_i)$
+ *
+ * Calculates the conformal time for each element of @t using the monotone
+ * inverse interpolant, @t and @eta can be the same vector. Combined with
+ * nc_scalefactor_eval_z_eta_array() it gives $z(t)$ for many objects. This
+ * function is thread-safe after nc_scalefactor_prepare(). Values outside
+ * the integrated interval are clamped to it and reported with a warning.
+ *
+ * Returns: an estimate of the largest absolute error in $\eta$.
+ */
+gdouble
+nc_scalefactor_eval_eta_t_array (NcScalefactor *a, NcmVector *t, NcmVector *eta)
+{
+  NcScalefactorPrivate * const self = a->priv;
+  const guint len = ncm_vector_len (t);
+  gdouble err = 0.0;
+  guint n_out = 0;
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (eta), ==, len);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (eta, i, _nc_scalefactor_hermite_eval (self->h_eta_t, ncm_vector_get (t, i), &err, &n_out));
+
+  _nc_scalefactor_hermite_report_out ("nc_scalefactor_eval_eta_t_array", n_out, len,
+                                      g_array_index (self->h_eta_t->x, gdouble, 0),
+                                      g_array_index (self->h_eta_t->x, gdouble, self->h_eta_t->x->len - 1));
+
+  return err;
+}
+
 static void
 _nc_scalefactor_calc_spline (NcScalefactor *a, NcHICosmo *cosmo)
 {
@@ -831,16 +1149,55 @@ _nc_scalefactor_calc_spline (NcScalefactor *a, NcHICosmo *cosmo)
 
 	ncm_spline_set_array (self->a_eta, eta_a, mz_a, TRUE);
 	ncm_spline_set_array (self->eta_a, mz_a, eta_a, TRUE);
-  g_array_unref (eta_a);
-  g_array_unref (mz_a);
 
   ncm_spline_set_array (self->t_eta, eta_a, t_a, TRUE);
   ncm_spline_set_array (self->eta_t, t_a, eta_a, TRUE);
+
+  _nc_scalefactor_calc_hermite (a, cosmo, eta_a, mz_a, t_a);
+
+  g_array_unref (eta_a);
+  g_array_unref (mz_a);
   g_array_unref (t_a);
   
   return;
 }
 
+static void
+_nc_scalefactor_calc_hermite (NcScalefactor *a, NcHICosmo *cosmo, GArray *eta_a, GArray *mz_a, GArray *t_a)
+{
+  NcScalefactorPrivate * const self = a->priv;
+  const guint len = eta_a->len;
+  GArray *dmz_deta = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), len);
+  GArray *deta_dmz = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), len);
+  GArray *dt_deta  = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), len);
+  GArray *deta_dt  = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), len);
+  guint k;
+
+  for (k = 0; k < len; k++)
+  {
+    const gdouble mz  = g_array_index (mz_a, gdouble, k);
+    const gdouble x   = 1.0 - mz;
+    const gdouble E   = nc_hicosmo_E (cosmo, -mz);
+    const gdouble E_1 = 1.0 / E;
+    const gdouble x_1 = 1.0 / x;
+
+    g_array_append_val (dmz_deta, E);
+    g_array_append_val (deta_dmz, E_1);
+    g_array_append_val (dt_deta, x_1);
+    g_array_append_val (deta_dt, x);
+  }
+
+  _nc_scalefactor_hermite_set (self->h_mz_eta, eta_a, mz_a, dmz_deta, self->a_eta);
+  _nc_scalefactor_hermite_set (self->h_eta_mz, mz_a, eta_a, deta_dmz, self->eta_a);
+  _nc_scalefactor_hermite_set (self->h_t_eta, eta_a, t_a, dt_deta, self->t_eta);
+  _nc_scalefactor_hermite_set (self->h_eta_t, t_a, eta_a, deta_dt, self->eta_t);
+
+  g_array_unref (dmz_deta);
+  g_array_unref (deta_dmz);
+  g_array_unref (dt_deta);
+  g_array_unref (deta_dt);
+}
+
 static gint
 dz_deta_f (realtype t, N_Vector y, N_Vector ydot, gpointer f_data)
 {
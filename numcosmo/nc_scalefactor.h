@@ -89,6 +89,11 @@ gdouble nc_scalefactor_eval_eta_x (NcScalefactor *a, const gdouble x);
 gdouble nc_scalefactor_eval_t_eta (NcScalefactor *a, const gdouble eta);
 gdouble nc_scalefactor_eval_eta_t (NcScalefactor *a, const gdouble t);
 
+gdouble nc_scalefactor_eval_z_eta_array (NcScalefactor *a, NcmVector *eta, NcmVector *z);
+gdouble nc_scalefactor_eval_eta_z_array (NcScalefactor *a, NcmVector *z, NcmVector *eta);
+gdouble nc_scalefactor_eval_t_eta_array (NcScalefactor *a, NcmVector *eta, NcmVector *t);
+gdouble nc_scalefactor_eval_eta_t_array (NcScalefactor *a, NcmVector *t, NcmVector *eta);
+
 #define NC_SCALEFACTOR_DEFAULT_ZF (1.0e14)
 #define NC_SCALEFACTOR_DEFAULT_A0 (1.0)
 #define NC_SCALEFACTOR_DEFAULT_RELTOL (1.0e-13)
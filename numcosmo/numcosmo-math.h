@@ -133,6 +133,7 @@
 #include <numcosmo/math/ncm_fit_gsl_mm.h>
 #include <numcosmo/math/ncm_fit_gsl_mms.h>
 #include <numcosmo/math/ncm_mset_catalog.h>
+#include <numcosmo/math/ncm_mset_catalog_stream.h>
 #include <numcosmo/math/ncm_mset_trans_kern.h>
 #include <numcosmo/math/ncm_mset_trans_kern_flat.h>
 #include <numcosmo/math/ncm_mset_trans_kern_gauss.h>
@@ -145,6 +146,7 @@
 #include <numcosmo/math/ncm_fit_esmcmc_walker_stretch.h>
 #include <numcosmo/math/ncm_fit_esmcmc_walker_walk.h>
 #include <numcosmo/math/ncm_fit_esmcmc_walker_aps.h>
+#include <numcosmo/math/ncm_fit_esmcmc_walker_adaptive.h>
 #include <numcosmo/math/ncm_lh_ratio1d.h>
 #include <numcosmo/math/ncm_lh_ratio2d.h>
 #include <numcosmo/math/ncm_abc.h>
@@ -53,6 +53,7 @@
 /* Cosmic thermodynamics */
 #include <numcosmo/nc_recomb.h>
 #include <numcosmo/nc_recomb_seager.h>
+#include <numcosmo/nc_recomb_emul.h>
 #include <numcosmo/nc_hireion.h>
 #include <numcosmo/nc_hireion_camb.h>
 
@@ -42,16 +42,22 @@
 #include "perturbations/nc_hipert.h"
 #include "math/ncm_cfg.h"
 #include "math/ncm_util.h"
+#include "nc_enum_types.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <cvode/cvode.h>
+#include <cvode/cvode_ls.h>
+#include <cvode/cvode_bandpre.h>
 #include <nvector/nvector_serial.h>
 #include <sundials/sundials_matrix.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunlinsol/sunlinsol_band.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 
 #define SUN_DENSE_ACCESS SM_ELEMENT_D
-#define SUN_BAND_ACCESS SM_ELEMENT_D
+#define SUN_BAND_ACCESS SM_ELEMENT_B
 #endif /* NUMCOSMO_GIR_SCAN */
 
 #include "perturbations/nc_hipert_private.h"
@@ -63,6 +69,10 @@ enum {
   PROP_RELTOL,
   PROP_ABSTOL,
   PROP_ALPHAI,
+  PROP_NTHREADS,
+  PROP_LIN_SOLVER,
+  PROP_MUPPER,
+  PROP_MLOWER,
   PROP_SIZE,
 };
 
@@ -84,6 +94,10 @@ nc_hipert_init (NcHIPert *pert)
   self->cvode       = CVodeCreate (CV_ADAMS);
   self->cvode_init  = FALSE;
   self->cvode_stiff = FALSE;
+  self->nthreads    = 0;
+  self->lin_solver  = NC_HIPERT_LIN_SOLVER_DENSE;
+  self->mupper      = 0;
+  self->mlower      = 0;
 }
 
 static void
@@ -110,6 +124,18 @@ nc_hipert_set_property (GObject *object, guint prop_id, const GValue *value, GPa
     case PROP_ALPHAI:
       self->alpha0 = g_value_get_double (value);
       break;
+    case PROP_NTHREADS:
+      nc_hipert_set_nthreads (pert, g_value_get_uint (value));
+      break;
+    case PROP_LIN_SOLVER:
+      nc_hipert_set_lin_solver (pert, g_value_get_enum (value));
+      break;
+    case PROP_MUPPER:
+      nc_hipert_set_band_width (pert, g_value_get_uint (value), self->mlower);
+      break;
+    case PROP_MLOWER:
+      nc_hipert_set_band_width (pert, self->mupper, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -140,6 +166,18 @@ nc_hipert_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
     case PROP_ALPHAI:
       g_value_set_double (value, self->alpha0);
       break;
+    case PROP_NTHREADS:
+      g_value_set_uint (value, nc_hipert_get_nthreads (pert));
+      break;
+    case PROP_LIN_SOLVER:
+      g_value_set_enum (value, nc_hipert_get_lin_solver (pert));
+      break;
+    case PROP_MUPPER:
+      g_value_set_uint (value, self->mupper);
+      break;
+    case PROP_MLOWER:
+      g_value_set_uint (value, self->mlower);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -187,6 +225,7 @@ nc_hipert_finalize (GObject *object)
 }
 
 static void _nc_hipert_set_mode_k (NcHIPert *pert, gdouble k);
+static void _nc_hipert_alloc_lin_solver (NcHIPert *pert);
 static void _nc_hipert_set_abstol (NcHIPert *pert, gdouble abstol);
 static void _nc_hipert_set_reltol (NcHIPert *pert, gdouble reltol);
 
@@ -239,6 +278,35 @@ nc_hipert_class_init (NcHIPertClass *klass)
                                                         -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
+  g_object_class_install_property (object_class,
+                                   PROP_NTHREADS,
+                                   g_param_spec_uint ("nthreads",
+                                                      NULL,
+                                                      "Number of threads used by the multi-mode drivers",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_LIN_SOLVER,
+                                   g_param_spec_enum ("lin-solver",
+                                                      NULL,
+                                                      "Linear solver used by the stiff integrator",
+                                                      NC_TYPE_HIPERT_LIN_SOLVER, NC_HIPERT_LIN_SOLVER_DENSE,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_MUPPER,
+                                   g_param_spec_uint ("band-mupper",
+                                                      NULL,
+                                                      "Upper bandwidth of the system Jacobian",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_MLOWER,
+                                   g_param_spec_uint ("band-mlower",
+                                                      NULL,
+                                                      "Lower bandwidth of the system Jacobian",
+                                                      0, G_MAXUINT32, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
   klass->set_mode_k = &_nc_hipert_set_mode_k;
   klass->set_abstol = &_nc_hipert_set_abstol;
   klass->set_reltol = &_nc_hipert_set_reltol;
@@ -301,6 +369,142 @@ _nc_hipert_set_abstol (NcHIPert *pert, gdouble abstol)
   }
 }
 
+#define _NC_HIPERT_MUPPER(self) (MIN ((self)->mupper, (self)->sys_size - 1))
+#define _NC_HIPERT_MLOWER(self) (MIN ((self)->mlower, (self)->sys_size - 1))
+
+static const gchar *
+_nc_hipert_lin_solver_name (NcHIPertLinSolver lin_solver)
+{
+  switch (lin_solver)
+  {
+    case NC_HIPERT_LIN_SOLVER_DENSE:
+      return "dense";
+    case NC_HIPERT_LIN_SOLVER_BAND:
+      return "band";
+    case NC_HIPERT_LIN_SOLVER_SPGMR:
+      return "spgmr";
+    default:
+      g_assert_not_reached ();
+      return NULL;
+  }
+}
+
+static void
+_nc_hipert_alloc_lin_solver (NcHIPert *pert)
+{
+  NcHIPertPrivate * const self = pert->priv;
+
+  if (self->A != NULL)
+  {
+    SUNMatDestroy (self->A);
+    self->A = NULL;
+  }
+
+  if (self->LS != NULL)
+  {
+    SUNLinSolFree (self->LS);
+    self->LS = NULL;
+  }
+
+  if (self->sys_size == 0)
+    return;
+
+  switch (self->lin_solver)
+  {
+    case NC_HIPERT_LIN_SOLVER_DENSE:
+      self->A  = SUNDenseMatrix (self->sys_size, self->sys_size);
+      NCM_CVODE_CHECK ((gpointer)self->A, "SUNDenseMatrix", 0, );
+
+      self->LS = SUNDenseLinearSolver (self->y, self->A);
+      NCM_CVODE_CHECK ((gpointer)self->LS, "SUNDenseLinearSolver", 0, );
+      break;
+    case NC_HIPERT_LIN_SOLVER_BAND:
+      self->A  = SUNBandMatrix (self->sys_size, _NC_HIPERT_MUPPER (self), _NC_HIPERT_MLOWER (self));
+      NCM_CVODE_CHECK ((gpointer)self->A, "SUNBandMatrix", 0, );
+
+      self->LS = SUNBandLinearSolver (self->y, self->A);
+      NCM_CVODE_CHECK ((gpointer)self->LS, "SUNBandLinearSolver", 0, );
+      break;
+    case NC_HIPERT_LIN_SOLVER_SPGMR:
+      self->LS = SUNLinSol_SPGMR (self->y, PREC_LEFT, 0);
+      NCM_CVODE_CHECK ((gpointer)self->LS, "SUNLinSol_SPGMR", 0, );
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/*
+ * _nc_hipert_set_lin_solver_opts:
+ * @pert: a #NcHIPert
+ * @jac: (allow-none): Jacobian function
+ *
+ * Attaches the linear solver to the CVode object, it must be called
+ * after CVodeInit/CVodeReInit. For the direct solvers @jac is used
+ * as the Jacobian function (difference quotients when NULL), for
+ * #NC_HIPERT_LIN_SOLVER_SPGMR @jac is ignored and a banded difference
+ * quotient preconditioner is attached instead.
+ *
+ */
+void
+_nc_hipert_set_lin_solver_opts (NcHIPert *pert, CVLsJacFn jac)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  gint flag;
+
+  switch (self->lin_solver)
+  {
+    case NC_HIPERT_LIN_SOLVER_DENSE:
+    case NC_HIPERT_LIN_SOLVER_BAND:
+      flag = CVodeSetLinearSolver (self->cvode, self->LS, self->A);
+      NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
+
+      if (jac != NULL)
+      {
+        flag = CVodeSetJacFn (self->cvode, jac);
+        NCM_CVODE_CHECK (&flag, "CVodeSetJacFn", 1, );
+      }
+      break;
+    case NC_HIPERT_LIN_SOLVER_SPGMR:
+      flag = CVodeSetLinearSolver (self->cvode, self->LS, NULL);
+      NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
+
+      flag = CVBandPrecInit (self->cvode, self->sys_size, _NC_HIPERT_MUPPER (self), _NC_HIPERT_MLOWER (self));
+      NCM_CVODE_CHECK (&flag, "CVBandPrecInit", 1, );
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/*
+ * _nc_hipert_jac_set:
+ * @J: a SUNMatrix
+ * @i: row
+ * @j: column
+ * @Jij: value of $J_{ij}$
+ *
+ * Sets the element $J_{ij}$ of the Jacobian @J, which can be a dense or a
+ * band matrix, depending on the solver in use. Elements outside the band are
+ * dropped, so that Jacobian functions written for the full system can be used
+ * with #NC_HIPERT_LIN_SOLVER_BAND, which then works with the banded part of
+ * the Jacobian.
+ *
+ */
+void
+_nc_hipert_jac_set (SUNMatrix J, const gint i, const gint j, const gdouble Jij)
+{
+  if (SUNMatGetID (J) == SUNMATRIX_BAND)
+  {
+    if ((j - i <= SUNBandMatrix_UpperBandwidth (J)) && (i - j <= SUNBandMatrix_LowerBandwidth (J)))
+      SUN_BAND_ACCESS (J, i, j) = Jij;
+  }
+  else
+    SUN_DENSE_ACCESS (J, i, j) = Jij;
+}
+
 /**
  * nc_hipert_get_reltol:
  * @pert: a #NcHIPert.
@@ -393,18 +597,6 @@ nc_hipert_set_sys_size (NcHIPert *pert, guint sys_size)
       N_VDestroy (self->y);
       self->y = NULL;
     }
-    if (self->A != NULL)
-    {
-      SUNMatDestroy (self->A);
-      self->A = NULL;
-    }
-
-    if (self->LS != NULL)
-    {
-      SUNLinSolFree (self->LS);
-      self->LS = NULL;
-    }
-    
     if (self->vec_abstol != NULL)
     {
       N_VDestroy (self->vec_abstol);
@@ -416,19 +608,134 @@ nc_hipert_set_sys_size (NcHIPert *pert, guint sys_size)
     {
       self->y          = N_VNew_Serial (sys_size);
       self->vec_abstol = N_VNew_Serial (sys_size);
-
-      self->A          = SUNDenseMatrix (sys_size, sys_size);
-      self->LS         = SUNDenseLinearSolver (self->y, self->A);
-
-      NCM_CVODE_CHECK ((gpointer)self->A, "SUNDenseMatrix", 0, );
-      NCM_CVODE_CHECK ((gpointer)self->LS, "SUNDenseLinearSolver", 0, );
     }
+
+    _nc_hipert_alloc_lin_solver (pert);
     self->prepared = FALSE;
 
     nc_hipert_reset_solver (pert);
   }
 }
 
+/**
+ * nc_hipert_set_lin_solver:
+ * @pert: a #NcHIPert.
+ * @lin_solver: a #NcHIPertLinSolver.
+ *
+ * Sets the linear solver used in the Newton iterations of the
+ * stiff integrator. The band solver and the preconditioner of
+ * #NC_HIPERT_LIN_SOLVER_SPGMR use the bandwidths set by
+ * nc_hipert_set_band_width(). Only subclasses whose Jacobian
+ * function handles band matrices honor #NC_HIPERT_LIN_SOLVER_BAND.
+ *
+ */
+void
+nc_hipert_set_lin_solver (NcHIPert *pert, NcHIPertLinSolver lin_solver)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  g_assert_cmpint (lin_solver, <, NC_HIPERT_LIN_SOLVER_LEN);
+
+  if (self->lin_solver != lin_solver)
+  {
+    self->lin_solver = lin_solver;
+    _nc_hipert_alloc_lin_solver (pert);
+    nc_hipert_reset_solver (pert);
+  }
+}
+
+/**
+ * nc_hipert_get_lin_solver:
+ * @pert: a #NcHIPert.
+ *
+ * Returns: the #NcHIPertLinSolver in use.
+ */
+NcHIPertLinSolver
+nc_hipert_get_lin_solver (NcHIPert *pert)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  return self->lin_solver;
+}
+
+/**
+ * nc_hipert_set_band_width:
+ * @pert: a #NcHIPert.
+ * @mupper: upper bandwidth
+ * @mlower: lower bandwidth
+ *
+ * Sets the upper and lower bandwidths of the system Jacobian, they are
+ * used by #NC_HIPERT_LIN_SOLVER_BAND and by the banded preconditioner
+ * of #NC_HIPERT_LIN_SOLVER_SPGMR. Both are clipped to the system size
+ * minus one.
+ *
+ */
+void
+nc_hipert_set_band_width (NcHIPert *pert, guint mupper, guint mlower)
+{
+  NcHIPertPrivate * const self = pert->priv;
+
+  if ((self->mupper != mupper) || (self->mlower != mlower))
+  {
+    self->mupper = mupper;
+    self->mlower = mlower;
+
+    if (self->lin_solver != NC_HIPERT_LIN_SOLVER_DENSE)
+    {
+      _nc_hipert_alloc_lin_solver (pert);
+      nc_hipert_reset_solver (pert);
+    }
+  }
+}
+
+/**
+ * nc_hipert_print_stats:
+ * @pert: a #NcHIPert.
+ *
+ * Prints the integrator statistics followed by the linear solver
+ * statistics of the last evolution.
+ *
+ */
+void
+nc_hipert_print_stats (NcHIPert *pert)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  glong nlinsetups, njaceval, nlinrhs;
+  gint flag;
+
+  if (!self->cvode_init)
+    return;
+
+  ncm_util_cvode_print_stats (self->cvode);
+
+  flag = CVodeGetNumLinSolvSetups (self->cvode, &nlinsetups);
+  NCM_CVODE_CHECK (&flag, "CVodeGetNumLinSolvSetups", 1, );
+  flag = CVodeGetNumJacEvals (self->cvode, &njaceval);
+  NCM_CVODE_CHECK (&flag, "CVodeGetNumJacEvals", 1, );
+  flag = CVodeGetNumLinRhsEvals (self->cvode, &nlinrhs);
+  NCM_CVODE_CHECK (&flag, "CVodeGetNumLinRhsEvals", 1, );
+
+  g_message ("# Linear solver: %s, sys_size = %u, mupper = %u, mlower = %u\n", 
+             _nc_hipert_lin_solver_name (self->lin_solver), self->sys_size,
+             _NC_HIPERT_MUPPER (self), _NC_HIPERT_MLOWER (self));
+  g_message ("# nlinsetups = %-6ld njaceval = %-6ld nlinrhs = %-6ld\n", nlinsetups, njaceval, nlinrhs);
+
+  if (self->lin_solver == NC_HIPERT_LIN_SOLVER_SPGMR)
+  {
+    glong nliniter, nlinconvfail, nprecevals, nprecsolves;
+
+    flag = CVodeGetNumLinIters (self->cvode, &nliniter);
+    NCM_CVODE_CHECK (&flag, "CVodeGetNumLinIters", 1, );
+    flag = CVodeGetNumLinConvFails (self->cvode, &nlinconvfail);
+    NCM_CVODE_CHECK (&flag, "CVodeGetNumLinConvFails", 1, );
+    flag = CVodeGetNumPrecEvals (self->cvode, &nprecevals);
+    NCM_CVODE_CHECK (&flag, "CVodeGetNumPrecEvals", 1, );
+    flag = CVodeGetNumPrecSolves (self->cvode, &nprecsolves);
+    NCM_CVODE_CHECK (&flag, "CVodeGetNumPrecSolves", 1, );
+
+    g_message ("# nliniter = %-6ld nlinconvfail = %-6ld nprecevals = %-6ld nprecsolves = %-6ld\n",
+               nliniter, nlinconvfail, nprecevals, nprecsolves);
+  }
+}
+
 /**
  * nc_hipert_set_stiff_solver:
  * @pert: a #NcHIPert.
@@ -461,6 +768,49 @@ nc_hipert_set_stiff_solver (NcHIPert *pert, gboolean stiff)
   }
 }
 
+/**
+ * nc_hipert_get_stiff_solver:
+ * @pert: a #NcHIPert.
+ *
+ * Returns: whether a stiff solver is being used.
+ */
+gboolean
+nc_hipert_get_stiff_solver (NcHIPert *pert)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  return self->cvode_stiff;
+}
+
+/**
+ * nc_hipert_set_nthreads:
+ * @pert: a #NcHIPert.
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used by the drivers that evolve
+ * several modes at once, each thread uses its own copy of the
+ * perturbation object. Values smaller than two disable threading.
+ *
+ */
+void
+nc_hipert_set_nthreads (NcHIPert *pert, const guint nthreads)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  self->nthreads = nthreads;
+}
+
+/**
+ * nc_hipert_get_nthreads:
+ * @pert: a #NcHIPert.
+ *
+ * Returns: the number of threads used by the multi-mode drivers.
+ */
+guint
+nc_hipert_get_nthreads (NcHIPert *pert)
+{
+  NcHIPertPrivate * const self = pert->priv;
+  return self->nthreads;
+}
+
 /**
  * nc_hipert_reset_solver:
  * @pert: a #NcHIPert
@@ -60,6 +60,24 @@ struct _NcHIPert
   NcHIPertPrivate *priv;
 };
 
+/**
+ * NcHIPertLinSolver:
+ * @NC_HIPERT_LIN_SOLVER_DENSE: dense Jacobian and dense LU decomposition.
+ * @NC_HIPERT_LIN_SOLVER_BAND: band Jacobian and band LU decomposition.
+ * @NC_HIPERT_LIN_SOLVER_SPGMR: matrix-free GMRES with a banded preconditioner.
+ *
+ * Linear solvers used in the Newton iterations of the stiff integrator.
+ *
+ */
+typedef enum /*< enum,underscore_name=NC_HIPERT_LIN_SOLVER >*/
+{
+  NC_HIPERT_LIN_SOLVER_DENSE = 0,
+  NC_HIPERT_LIN_SOLVER_BAND,
+  NC_HIPERT_LIN_SOLVER_SPGMR,
+  /* < private > */
+  NC_HIPERT_LIN_SOLVER_LEN, /*< skip >*/
+} NcHIPertLinSolver;
+
 GType nc_hipert_get_type (void) G_GNUC_CONST;
 
 NCM_INLINE void nc_hipert_set_mode_k (NcHIPert *pert, gdouble k);
@@ -74,6 +92,13 @@ void nc_hipert_set_prepared (NcHIPert *pert, gboolean prepared);
 
 void nc_hipert_set_sys_size (NcHIPert *pert, guint sys_size);
 void nc_hipert_set_stiff_solver (NcHIPert *pert, gboolean stiff);
+gboolean nc_hipert_get_stiff_solver (NcHIPert *pert);
+void nc_hipert_set_nthreads (NcHIPert *pert, const guint nthreads);
+guint nc_hipert_get_nthreads (NcHIPert *pert);
+void nc_hipert_set_lin_solver (NcHIPert *pert, NcHIPertLinSolver lin_solver);
+NcHIPertLinSolver nc_hipert_get_lin_solver (NcHIPert *pert);
+void nc_hipert_set_band_width (NcHIPert *pert, guint mupper, guint mlower);
+void nc_hipert_print_stats (NcHIPert *pert);
 void nc_hipert_reset_solver (NcHIPert *pert);
 
 G_END_DECLS
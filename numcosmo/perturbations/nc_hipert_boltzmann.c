@@ -39,6 +39,7 @@
 
 #include "nc_enum_types.h"
 #include "perturbations/nc_hipert_boltzmann.h"
+#include "math/ncm_func_eval.h"
 
 #ifndef NUMCOSMO_GIR_SCAN
 #include <cvode/cvode.h>
@@ -106,6 +107,7 @@ nc_hipert_boltzmann_init (NcHIPertBoltzmann *pb)
 
   pb->ctrl_cosmo             = ncm_model_ctrl_new (NULL);
   pb->ctrl_prim              = ncm_model_ctrl_new (NULL);
+  pb->jl_table               = NULL;
 }
 
 static void
@@ -227,6 +229,9 @@ _nc_hipert_boltzmann_dispose (GObject *object)
 static void
 _nc_hipert_boltzmann_finalize (GObject *object)
 {
+  NcHIPertBoltzmann *pb = NC_HIPERT_BOLTZMANN (object);
+
+  g_clear_pointer (&pb->jl_table, ncm_sf_sbessel_table_free);
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_hipert_boltzmann_parent_class)->finalize (object);
@@ -972,3 +977,206 @@ nc_hipert_boltzmann_get_EB_Cls (NcHIPertBoltzmann *pb, NcmVector *Cls)
 
   NC_HIPERT_BOLTZMANN_GET_CLASS (pb)->get_EB_Cls (pb, Cls);
 }
+
+/**
+ * nc_hipert_boltzmann_set_bessel_table:
+ * @pb: a #NcHIPertBoltzmann
+ * @lmax: largest multipole
+ * @xmax: largest argument $k(\eta_0 - \eta)$
+ * @dx: grid spacing
+ *
+ * Makes sure the spherical Bessel table used by the line-of-sight
+ * projection covers $0 \leq \ell \leq$ @lmax and $0 \leq x \leq$ @xmax
+ * with spacing at most @dx. The table is only rebuilt when the current
+ * one is insufficient, so it is shared among all subsequent calls of
+ * nc_hipert_boltzmann_los_transfer().
+ *
+ */
+void
+nc_hipert_boltzmann_set_bessel_table (NcHIPertBoltzmann *pb, guint lmax, gdouble xmax, gdouble dx)
+{
+  NcmSFSBesselTable *jltab = pb->jl_table;
+
+  if ((jltab == NULL) || (jltab->lmax < lmax) || (jltab->xmax < xmax) || (jltab->dx > dx))
+  {
+    g_clear_pointer (&pb->jl_table, ncm_sf_sbessel_table_free);
+    pb->jl_table = ncm_sf_sbessel_table_new (lmax, xmax, dx);
+  }
+}
+
+#define NC_HIPERT_BOLTZMANN_LOS_LBLOCK 16
+
+typedef struct _NcHIPertBoltzmannLOS
+{
+  NcmSFSBesselTable *jltab;
+  NcmVector *k;
+  NcmVector *eta;
+  NcmMatrix *S;
+  NcmMatrix *Delta_l;
+  gdouble eta0;
+  gdouble *w;
+} NcHIPertBoltzmannLOS;
+
+static void
+_nc_hipert_boltzmann_los_transfer_k (glong i, glong f, gpointer data)
+{
+  NcHIPertBoltzmannLOS *los = (NcHIPertBoltzmannLOS *) data;
+  const guint neta          = ncm_vector_len (los->eta);
+  const guint nl            = ncm_matrix_ncols (los->Delta_l);
+  glong a;
+
+  for (a = i; a < f; a++)
+  {
+    const gdouble k = ncm_vector_get (los->k, a);
+    guint l0;
+
+    for (l0 = 0; l0 < nl; l0 += NC_HIPERT_BOLTZMANN_LOS_LBLOCK)
+    {
+      const guint l1 = MIN (l0 + NC_HIPERT_BOLTZMANN_LOS_LBLOCK, nl);
+      gdouble Delta[NC_HIPERT_BOLTZMANN_LOS_LBLOCK] = {0.0, };
+      gdouble xmin[NC_HIPERT_BOLTZMANN_LOS_LBLOCK];
+      guint j, l;
+
+      for (l = l0; l < l1; l++)
+        xmin[l - l0] = ncm_sf_sbessel_table_get_xmin (los->jltab, l);
+
+      for (j = 0; j < neta; j++)
+      {
+        const gdouble x  = k * (los->eta0 - ncm_vector_get (los->eta, j));
+        const gdouble wS = los->w[j] * ncm_matrix_get (los->S, a, j);
+
+        /* The l-block is sorted in l and so is xmin, nothing to add past the first miss. */
+        if ((wS == 0.0) || (x < xmin[0]))
+          continue;
+
+        for (l = l0; (l < l1) && (x >= xmin[l - l0]); l++)
+          Delta[l - l0] += wS * ncm_sf_sbessel_table_eval (los->jltab, l, x);
+      }
+
+      for (l = l0; l < l1; l++)
+        ncm_matrix_set (los->Delta_l, a, l, Delta[l - l0]);
+    }
+  }
+}
+
+/**
+ * nc_hipert_boltzmann_los_transfer:
+ * @pb: a #NcHIPertBoltzmann
+ * @k: a #NcmVector containing the modes $k$
+ * @eta: a #NcmVector containing increasing conformal times $\eta$
+ * @S: a #NcmMatrix containing the sources $S(k_a, \eta_j)$
+ * @eta0: conformal time today $\eta_0$
+ * @Delta_l: a #NcmMatrix to store the transfers $\Delta_\ell(k_a)$
+ *
+ * Projects the sources in @S on the line of sight,
+ * $$\Delta_\ell(k) = \int\mathrm{d}\eta\,S(k, \eta)\,j_\ell\left[k(\eta_0 - \eta)\right],$$
+ * for all $0 \leq \ell <$ ncols(@Delta_l), using the trapezoidal rule on the
+ * nodes @eta. Both @eta and @eta0 are conformal times in the same units as
+ * $1/k$, and each row of @S must hold the source already multiplied by
+ * whatever Jacobian is needed to integrate it in $\eta$, e.g., when the
+ * sources are tabulated in $\lambda$ the row must contain
+ * $S\,\mathrm{d}\lambda/\mathrm{d}\eta$ evaluated at the nodes @eta. The spherical Bessel functions are read from the table
+ * prepared by nc_hipert_boltzmann_set_bessel_table(), which must cover
+ * these multipoles and $\max(k)(\eta_0 - \eta_\mathrm{min})$. Within each mode
+ * the multipoles are accumulated in blocks so that each time node is visited once
+ * per block, and the modes are distributed among #NcHIPert:nthreads threads.
+ *
+ */
+void
+nc_hipert_boltzmann_los_transfer (NcHIPertBoltzmann *pb, NcmVector *k, NcmVector *eta, NcmMatrix *S, const gdouble eta0, NcmMatrix *Delta_l)
+{
+  const guint nk   = ncm_vector_len (k);
+  const guint neta = ncm_vector_len (eta);
+  const guint nl   = ncm_matrix_ncols (Delta_l);
+  NcHIPertBoltzmannLOS los;
+  guint j;
+
+  g_assert_cmpuint (neta, >, 1);
+  g_assert_cmpuint (ncm_matrix_nrows (S), ==, nk);
+  g_assert_cmpuint (ncm_matrix_ncols (S), ==, neta);
+  g_assert_cmpuint (ncm_matrix_nrows (Delta_l), ==, nk);
+
+  if (pb->jl_table == NULL)
+    g_error ("nc_hipert_boltzmann_los_transfer: no Bessel table, call nc_hipert_boltzmann_set_bessel_table first.");
+  else
+  {
+    const gdouble xmax = ncm_vector_get_max (k) * (eta0 - ncm_vector_get (eta, 0));
+
+    if ((pb->jl_table->lmax + 1 < nl) || (pb->jl_table->xmax < xmax))
+      g_error ("nc_hipert_boltzmann_los_transfer: Bessel table covers l <= %u and x <= %g, but l <= %u and x <= %g were requested.",
+               pb->jl_table->lmax, pb->jl_table->xmax, nl - 1, xmax);
+  }
+
+  los.jltab   = pb->jl_table;
+  los.k       = k;
+  los.eta     = eta;
+  los.S       = S;
+  los.Delta_l = Delta_l;
+  los.eta0    = eta0;
+  los.w       = g_new0 (gdouble, neta);
+
+  for (j = 0; j + 1 < neta; j++)
+  {
+    const gdouble h = 0.5 * (ncm_vector_get (eta, j + 1) - ncm_vector_get (eta, j));
+
+    los.w[j]     += h;
+    los.w[j + 1] += h;
+  }
+
+  if ((nc_hipert_get_nthreads (NC_HIPERT (pb)) > 1) && (nk > 1))
+    ncm_func_eval_threaded_loop_full (&_nc_hipert_boltzmann_los_transfer_k, 0, nk, &los);
+  else
+    _nc_hipert_boltzmann_los_transfer_k (0, nk, &los);
+
+  g_free (los.w);
+}
+
+/**
+ * nc_hipert_boltzmann_los_Cls:
+ * @pb: a #NcHIPertBoltzmann
+ * @prim: a #NcHIPrim
+ * @k: a #NcmVector containing the modes $k$
+ * @Delta_l1: a #NcmMatrix containing the transfers $\Delta^{(1)}_\ell(k)$
+ * @Delta_l2: a #NcmMatrix containing the transfers $\Delta^{(2)}_\ell(k)$
+ * @Cls: a #NcmVector to store the $C_\ell$
+ *
+ * Computes $$C_\ell = 4\pi\int\mathrm{d}\ln k\,P_\zeta(k)\,\Delta^{(1)}_\ell(k)\Delta^{(2)}_\ell(k),$$
+ * using the trapezoidal rule in $\ln k$, for all $0 \leq \ell <$ len(@Cls). The
+ * transfers are in the layout of nc_hipert_boltzmann_los_transfer(), pass
+ * the same matrix twice for the auto-correlation.
+ *
+ */
+void
+nc_hipert_boltzmann_los_Cls (NcHIPertBoltzmann *pb, NcHIPrim *prim, NcmVector *k, NcmMatrix *Delta_l1, NcmMatrix *Delta_l2, NcmVector *Cls)
+{
+  const guint nk = ncm_vector_len (k);
+  const guint nl = ncm_vector_len (Cls);
+  gdouble *wP    = g_new0 (gdouble, nk);
+  guint a, l;
+
+  g_assert_cmpuint (nk, >, 1);
+  g_assert_cmpuint (ncm_matrix_nrows (Delta_l1), ==, nk);
+  g_assert_cmpuint (ncm_matrix_nrows (Delta_l2), ==, nk);
+  g_assert_cmpuint (ncm_matrix_ncols (Delta_l1), >=, nl);
+  g_assert_cmpuint (ncm_matrix_ncols (Delta_l2), >=, nl);
+
+  for (a = 0; a + 1 < nk; a++)
+  {
+    const gdouble h = 0.5 * log (ncm_vector_get (k, a + 1) / ncm_vector_get (k, a));
+
+    wP[a]     += h;
+    wP[a + 1] += h;
+  }
+
+  for (a = 0; a < nk; a++)
+    wP[a] *= 4.0 * M_PI * nc_hiprim_SA_powspec_k (prim, ncm_vector_get (k, a));
+
+  ncm_vector_set_zero (Cls);
+  for (a = 0; a < nk; a++)
+  {
+    for (l = 0; l < nl; l++)
+      ncm_vector_addto (Cls, l, wP[a] * ncm_matrix_get (Delta_l1, a, l) * ncm_matrix_get (Delta_l2, a, l));
+  }
+
+  g_free (wP);
+}
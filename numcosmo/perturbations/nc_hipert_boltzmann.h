@@ -30,6 +30,9 @@
 #include <glib-object.h>
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_model_ctrl.h>
+#include <numcosmo/math/ncm_vector.h>
+#include <numcosmo/math/ncm_matrix.h>
+#include <numcosmo/math/ncm_sf_sbessel.h>
 #include <numcosmo/nc_hiprim.h>
 #include <numcosmo/nc_hicosmo.h>
 #include <numcosmo/perturbations/nc_hipert.h>
@@ -162,6 +165,7 @@ struct _NcHIPertBoltzmann
   gboolean tight_coupling;
   NcmModelCtrl *ctrl_cosmo;
   NcmModelCtrl *ctrl_prim;
+  NcmSFSBesselTable *jl_table;
 };
 
 GType nc_hipert_boltzmann_get_type (void) G_GNUC_CONST;
@@ -212,6 +216,10 @@ void nc_hipert_boltzmann_get_TE_Cls (NcHIPertBoltzmann *pb, NcmVector *Cls);
 void nc_hipert_boltzmann_get_TB_Cls (NcHIPertBoltzmann *pb, NcmVector *Cls);
 void nc_hipert_boltzmann_get_EB_Cls (NcHIPertBoltzmann *pb, NcmVector *Cls);
 
+void nc_hipert_boltzmann_set_bessel_table (NcHIPertBoltzmann *pb, guint lmax, gdouble xmax, gdouble dx);
+void nc_hipert_boltzmann_los_transfer (NcHIPertBoltzmann *pb, NcmVector *k, NcmVector *eta, NcmMatrix *S, const gdouble eta0, NcmMatrix *Delta_l);
+void nc_hipert_boltzmann_los_Cls (NcHIPertBoltzmann *pb, NcHIPrim *prim, NcmVector *k, NcmMatrix *Delta_l1, NcmMatrix *Delta_l2, NcmVector *Cls);
+
 #define NC_HIPERT_BOLTZMANN_LAMBDA2X(lambda) (exp (-(lambda)))
 #define NC_HIPERT_BOLTZMANN_X2LAMBDA(x) (-log (x))
 
@@ -45,9 +45,10 @@
 #include <sundials/sundials_matrix.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunmatrix/sunmatrix_band.h>
 
 #define SUN_DENSE_ACCESS SM_ELEMENT_D
-#define SUN_BAND_ACCESS SM_ELEMENT_D
+#define SUN_BAND_ACCESS SM_ELEMENT_B
 #endif /* NUMCOSMO_GIR_SCAN */
 
 #include "perturbations/nc_hipert_private.h"
@@ -61,10 +62,20 @@ enum
 
 G_DEFINE_TYPE (NcHIPertBoltzmannStd, nc_hipert_boltzmann_std, NC_TYPE_HIPERT_BOLTZMANN);
 
+/* 
+ * Largest distance from the diagonal of the non-zero elements of
+ * the Jacobian, see _nc_hipert_boltzmann_std_band_J(). Within the
+ * hierarchy each multipole couples to l-1 and l+1 which, with the
+ * interleaved temperature and polarization variables, are two
+ * entries apart; the coupling of PHI to THETA2 and of THETA(3) to
+ * THETA2 sets the limit.
+ */
+#define NC_HIPERT_BOLTZMANN_STD_BAND_WIDTH 4
+
 static void
 nc_hipert_boltzmann_std_init (NcHIPertBoltzmannStd *pbs)
 {
-
+  nc_hipert_set_band_width (NC_HIPERT (pbs), NC_HIPERT_BOLTZMANN_STD_BAND_WIDTH, NC_HIPERT_BOLTZMANN_STD_BAND_WIDTH);
 }
 
 static void
@@ -281,11 +292,7 @@ _nc_hipert_boltzmann_std_set_opts (NcHIPertBoltzmann *pb)
   flag = CVodeSetUserData (pert->priv->cvode, pert);
   NCM_CVODE_CHECK (&flag, "CVodeSetUserData", 1,);
 
-  flag = CVodeSetLinearSolver (pert->priv->cvode, pert->priv->LS, pert->priv->A);
-  NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
-
-  flag = CVodeSetJacFn (pert->priv->cvode, &_nc_hipert_boltzmann_std_band_J);
-  NCM_CVODE_CHECK (&flag, "CVodeSetJacFn", 1, );
+  _nc_hipert_set_lin_solver_opts (pert, &_nc_hipert_boltzmann_std_band_J);
 
   flag = CVodeSetStopTime (pert->priv->cvode, pb->lambdaf);
   NCM_CVODE_CHECK (&flag, "CVodeSetStopTime", 1,);
@@ -349,6 +356,7 @@ _nc_hipert_boltzmann_std_get_sources (NcHIPertBoltzmann *pb, gdouble *S0, gdoubl
 static void
 _nc_hipert_boltzmann_std_print_stats (NcHIPertBoltzmann *pb)
 {
+  nc_hipert_print_stats (NC_HIPERT (pb));
 }
 
 static gdouble
@@ -430,7 +438,7 @@ nc_hipert_boltzmann_std_new (NcRecomb *recomb, guint lmax)
 {
   NcHIPertBoltzmannStd *pbs = g_object_new (NC_TYPE_HIPERT_BOLTZMANN_STD,
                                             "recomb", recomb,
-                                            "l-max", lmax,
+                                            "TT-l-max", lmax,
                                             NULL);
   NC_HIPERT_BOLTZMANN (pbs)->lambdai = NC_HIPERT_BOLTZMANN_X2LAMBDA (1.0e9);
   NC_HIPERT_BOLTZMANN (pbs)->lambdaf = NC_HIPERT_BOLTZMANN_X2LAMBDA (1.0);
@@ -606,7 +614,7 @@ _nc_hipert_boltzmann_std_step (realtype lambda, N_Vector y, N_Vector ydot, gpoin
   return 0;
 }
 
-#define _NC_BAND_ELEM(J,i,j) SUN_BAND_ACCESS ((J), (gint)(i), (gint)(j))
+#define _NC_BAND_ELEM(J,i,j) (*(is_band ? &SUN_BAND_ACCESS ((J), (gint)(i), (gint)(j)) : &SUN_DENSE_ACCESS ((J), (gint)(i), (gint)(j))))
 
 static gint
 _nc_hipert_boltzmann_std_band_J (realtype lambda, N_Vector y, N_Vector fy, SUNMatrix J, void *jac_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
@@ -636,6 +644,7 @@ _nc_hipert_boltzmann_std_band_J (realtype lambda, N_Vector y, N_Vector fy, SUNMa
   const gdouble k2x2_3E2 = x * k2x_3E2;
   const gdouble dErm2_dx = (3.0 * Omega_m0 * x2 + 4.0 * Omega_r0 * x3);
   const gdouble taubar = nc_recomb_dtau_dlambda (pb->recomb, cosmo, lambda);
+  const gboolean is_band = (SUNMatGetID (J) == SUNMATRIX_BAND);
   guint i;
 
   _NC_BAND_ELEM (J, NC_HIPERT_BOLTZMANN_PHI, NC_HIPERT_BOLTZMANN_PHI)         = -1.0 - k2x2_3E2 - x * dErm2_dx / (2.0 * E2);
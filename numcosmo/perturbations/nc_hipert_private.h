@@ -47,8 +47,15 @@ struct _NcHIPertPrivate
   N_Vector vec_abstol;
   gdouble k;
   gboolean prepared;
+  guint nthreads;
+  NcHIPertLinSolver lin_solver;
+  guint mupper;
+  guint mlower;
 };
 
+void _nc_hipert_set_lin_solver_opts (NcHIPert *pert, CVLsJacFn jac);
+void _nc_hipert_jac_set (SUNMatrix J, const gint i, const gint j, const gdouble Jij);
+
 G_END_DECLS
 
 #endif /* _NC_HIPERT_PRIVATE_H_ */
@@ -72,6 +72,9 @@
 #include "build_cfg.h"
 
 #include "math/ncm_spline_cubic_notaknot.h"
+#include "math/ncm_memory_pool.h"
+#include "math/ncm_func_eval.h"
+#include "math/ncm_serialize.h"
 #include "perturbations/nc_hipert_two_fluids.h"
 #include "perturbations/nc_hipert_itwo_fluids.h"
 
@@ -1345,8 +1348,7 @@ nc_hipert_two_fluids_set_init_cond (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, gd
   flag = CVodeSetMaxNumSteps (pert->priv->cvode, G_MAXUINT32);
   NCM_CVODE_CHECK (&flag, "CVodeSetMaxNumSteps", 1, );
 
-  flag = CVodeSetLinearSolver (pert->priv->cvode, pert->priv->LS, pert->priv->A);
-  NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
+  _nc_hipert_set_lin_solver_opts (pert, NULL);
 
 #ifdef HAVE_SUNDIALS_ARKODE
   flag = ARKodeSStolerances (self->arkode, pert->priv->reltol, 0.0);
@@ -1355,6 +1357,10 @@ nc_hipert_two_fluids_set_init_cond (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, gd
   flag = ARKodeSetMaxNumSteps (self->arkode, G_MAXUINT32);
   NCM_CVODE_CHECK (&flag, "ARKodeSetMaxNumSteps", 1, );
 
+  /* The implicit part Jacobians are written for dense matrices only. */
+  if (nc_hipert_get_lin_solver (pert) != NC_HIPERT_LIN_SOLVER_DENSE)
+    g_error ("nc_hipert_two_fluids_set_init_cond: the ARKode integrator only supports the dense linear solver.");
+
   flag = ARKodeSetLinearSolver (self->arkode, pert->priv->LS, pert->priv->A);
   NCM_CVODE_CHECK (&flag, "ARKodeSetLinearSolver", 1, );
 
@@ -1628,8 +1634,7 @@ nc_hipert_two_fluids_set_init_cond_mode1sub (NcHIPertTwoFluids *ptf, NcHICosmo *
   flag = CVodeSetMaxNumSteps (pert->priv->cvode, G_MAXUINT32);
   NCM_CVODE_CHECK (&flag, "CVodeSetMaxNumSteps", 1, );
 
-  flag = CVodeSetLinearSolver (pert->priv->cvode, pert->priv->LS, pert->priv->A);
-  NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
+  _nc_hipert_set_lin_solver_opts (pert, NULL);
 }
 
 /**
@@ -1860,3 +1865,225 @@ nc_hipert_two_fluids_get_cross_time (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, N
   return alpha;
 }
 
+
+typedef struct _NcHIPertTwoFluidsSpec
+{
+  NcHIPertTwoFluids *ptf;
+  NcHICosmo *cosmo;
+  NcmSerialize *ser;
+  GMutex dup_lock;
+  NcmMemoryPool *mp;
+  guint main_mode;
+  gdouble alpha_i;
+  gdouble alpha_f;
+  gdouble prec;
+  NcmVector *k_vec;
+  NcmVector *Delta_zeta;
+  NcmVector *Delta_S;
+} NcHIPertTwoFluidsSpec;
+
+typedef struct _NcHIPertTwoFluidsSpecWorker
+{
+  NcHIPertTwoFluids *ptf;
+  NcHICosmo *cosmo;
+  NcmVector *ci;
+} NcHIPertTwoFluidsSpecWorker;
+
+static gpointer
+_nc_hipert_two_fluids_spec_worker_dup (gpointer userdata)
+{
+  NcHIPertTwoFluidsSpec *spec     = (NcHIPertTwoFluidsSpec *) userdata;
+  NcHIPert *pert                  = NC_HIPERT (spec->ptf);
+  NcHIPertTwoFluidsSpecWorker *sw = g_new (NcHIPertTwoFluidsSpecWorker, 1);
+
+  g_mutex_lock (&spec->dup_lock);
+
+  sw->ptf = NC_HIPERT_TWO_FLUIDS (ncm_serialize_dup_obj (spec->ser, G_OBJECT (spec->ptf)));
+  /* The stiff solver choice is not a property, hence it is not serialized. */
+  nc_hipert_set_stiff_solver (NC_HIPERT (sw->ptf), nc_hipert_get_stiff_solver (pert));
+
+  sw->cosmo = NC_HICOSMO (ncm_model_dup (NCM_MODEL (spec->cosmo), spec->ser));
+  sw->ci    = ncm_vector_new (NC_HIPERT_ITWO_FLUIDS_VARS_LEN);
+
+  ncm_serialize_reset (spec->ser, TRUE);
+  g_mutex_unlock (&spec->dup_lock);
+
+  return sw;
+}
+
+static void
+_nc_hipert_two_fluids_spec_worker_free (gpointer p)
+{
+  NcHIPertTwoFluidsSpecWorker *sw = (NcHIPertTwoFluidsSpecWorker *) p;
+
+  nc_hipert_two_fluids_clear (&sw->ptf);
+  nc_hicosmo_clear (&sw->cosmo);
+  ncm_vector_clear (&sw->ci);
+
+  g_free (sw);
+}
+
+static void
+_nc_hipert_two_fluids_spec_eval_k (NcHIPertTwoFluidsSpec *spec, NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, NcmVector *ci, const glong j)
+{
+  const gdouble k     = ncm_vector_get (spec->k_vec, j);
+  const gdouble RH_lp = nc_hicosmo_RH_planck (cosmo);
+  const gdouble norm  = gsl_pow_3 (k) / (2.0 * gsl_pow_2 (M_PI * RH_lp));
+  const NcHIPertTwoFluidsCross cross = (spec->main_mode == 1) ? NC_HIPERT_TWO_FLUIDS_CROSS_MODE1MAIN : NC_HIPERT_TWO_FLUIDS_CROSS_MODE2MAIN;
+  gdouble alpha_s, alpha;
+  NcmVector *state;
+
+  nc_hipert_set_mode_k (NC_HIPERT (ptf), k);
+
+  alpha_s = nc_hipert_two_fluids_get_cross_time (ptf, cosmo, cross, spec->alpha_i, spec->prec);
+
+  nc_hipert_two_fluids_get_init_cond_zetaS (ptf, cosmo, alpha_s, spec->main_mode, 0.25 * M_PI, ci);
+  nc_hipert_two_fluids_set_init_cond (ptf, cosmo, alpha_s, spec->main_mode, FALSE, ci);
+  nc_hipert_two_fluids_evolve (ptf, cosmo, spec->alpha_f);
+
+  state = nc_hipert_two_fluids_peek_state (ptf, cosmo, &alpha);
+
+  ncm_vector_set (spec->Delta_zeta, j, norm * (gsl_pow_2 (ncm_vector_get (state, NC_HIPERT_ITWO_FLUIDS_VARS_ZETA_R)) + gsl_pow_2 (ncm_vector_get (state, NC_HIPERT_ITWO_FLUIDS_VARS_ZETA_I))));
+
+  if (spec->Delta_S != NULL)
+    ncm_vector_set (spec->Delta_S, j, norm * (gsl_pow_2 (ncm_vector_get (state, NC_HIPERT_ITWO_FLUIDS_VARS_S_R)) + gsl_pow_2 (ncm_vector_get (state, NC_HIPERT_ITWO_FLUIDS_VARS_S_I))));
+}
+
+static void
+_nc_hipert_two_fluids_spec_mt_eval (glong i, glong f, gpointer data)
+{
+  NcHIPertTwoFluidsSpec *spec = (NcHIPertTwoFluidsSpec *) data;
+  NcHIPertTwoFluidsSpecWorker **sw_ptr = ncm_memory_pool_get (spec->mp);
+  NcHIPertTwoFluidsSpecWorker *sw = *sw_ptr;
+  glong j;
+
+  for (j = i; j < f; j++)
+    _nc_hipert_two_fluids_spec_eval_k (spec, sw->ptf, sw->cosmo, sw->ci, j);
+
+  ncm_memory_pool_return (sw_ptr);
+}
+
+/**
+ * nc_hipert_two_fluids_compute_zeta_spectrum:
+ * @ptf: a #NcHIPertTwoFluids
+ * @cosmo: a #NcHICosmo
+ * @main_mode: main mode (1 or 2)
+ * @alpha_i: initial guess for the initial time of each mode
+ * @alpha_f: final time $\alpha_f$
+ * @prec: precision of the initial conditions, see nc_hipert_two_fluids_get_cross_time()
+ * @k_vec: a #NcmVector containing the modes $k$
+ * @Delta_zeta: a #NcmVector to store $\Delta_\zeta(k)$
+ * @Delta_S: (allow-none): a #NcmVector to store $\Delta_S(k)$
+ *
+ * Computes the power spectra $\Delta_\zeta(k) = k^3\vert\zeta_k\vert^2/(2\pi^2R_H^2)$
+ * and $\Delta_S(k)$ at $\alpha_f$ for each mode in @k_vec, where $R_H$ is the Hubble 
+ * radius in Planck units [nc_hicosmo_RH_planck()]. Each mode starts at the time where
+ * its @main_mode approximate solution is valid within @prec.
+ * 
+ * When #NcHIPert:nthreads is larger than one the modes are distributed, one 
+ * at a time, among the threads in the library thread pool. Each thread evolves 
+ * its modes using its own copies of @ptf and @cosmo, hence @ptf is left untouched.
+ * Otherwise, the modes are evolved serially using @ptf.
+ *
+ */
+void
+nc_hipert_two_fluids_compute_zeta_spectrum (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, guint main_mode, const gdouble alpha_i, const gdouble alpha_f, const gdouble prec, NcmVector *k_vec, NcmVector *Delta_zeta, NcmVector *Delta_S)
+{
+  const guint len      = ncm_vector_len (k_vec);
+  const guint nthreads = nc_hipert_get_nthreads (NC_HIPERT (ptf));
+  NcHIPertTwoFluidsSpec spec;
+
+  g_assert ((main_mode == 1) || (main_mode == 2));
+  g_assert_cmpuint (ncm_vector_len (Delta_zeta), ==, len);
+  if (Delta_S != NULL)
+    g_assert_cmpuint (ncm_vector_len (Delta_S), ==, len);
+
+  spec.ptf        = ptf;
+  spec.cosmo      = cosmo;
+  spec.ser        = NULL;
+  spec.mp         = NULL;
+  spec.main_mode  = main_mode;
+  spec.alpha_i    = alpha_i;
+  spec.alpha_f    = alpha_f;
+  spec.prec       = prec;
+  spec.k_vec      = k_vec;
+  spec.Delta_zeta = Delta_zeta;
+  spec.Delta_S    = Delta_S;
+
+  if ((nthreads > 1) && (len > 1))
+  {
+    spec.ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+    spec.mp  = ncm_memory_pool_new (&_nc_hipert_two_fluids_spec_worker_dup, &spec,
+                                    (GDestroyNotify) &_nc_hipert_two_fluids_spec_worker_free);
+    g_mutex_init (&spec.dup_lock);
+
+    ncm_func_eval_threaded_loop_full (&_nc_hipert_two_fluids_spec_mt_eval, 0, len, &spec);
+
+    ncm_memory_pool_free (spec.mp, TRUE);
+    ncm_serialize_free (spec.ser);
+    g_mutex_clear (&spec.dup_lock);
+  }
+  else
+  {
+    NcmVector *ci = ncm_vector_new (NC_HIPERT_ITWO_FLUIDS_VARS_LEN);
+    guint j;
+
+    for (j = 0; j < len; j++)
+      _nc_hipert_two_fluids_spec_eval_k (&spec, ptf, cosmo, ci, j);
+
+    ncm_vector_free (ci);
+  }
+}
+
+/**
+ * nc_hipert_two_fluids_compute_zeta_spectrum_spline:
+ * @ptf: a #NcHIPertTwoFluids
+ * @cosmo: a #NcHICosmo
+ * @main_mode: main mode (1 or 2)
+ * @alpha_i: initial guess for the initial time of each mode
+ * @alpha_f: final time $\alpha_f$
+ * @prec: precision of the initial conditions
+ * @ki: smallest mode $k_i$
+ * @kf: largest mode $k_f$
+ * @nnodes: number of modes
+ *
+ * Computes $\Delta_\zeta(k)$ in @nnodes log-spaced modes in $[k_i, k_f]$
+ * using nc_hipert_two_fluids_compute_zeta_spectrum() and interpolates
+ * $\ln\Delta_\zeta$ as a function of $\ln k$.
+ *
+ * Returns: (transfer full): a #NcmSpline for $\ln\Delta_\zeta(\ln k)$.
+ */
+NcmSpline *
+nc_hipert_two_fluids_compute_zeta_spectrum_spline (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, guint main_mode, const gdouble alpha_i, const gdouble alpha_f, const gdouble prec, const gdouble ki, const gdouble kf, const guint nnodes)
+{
+  NcmVector *k_vec      = ncm_vector_new (nnodes);
+  NcmVector *lnk_vec    = ncm_vector_new (nnodes);
+  NcmVector *Delta_zeta = ncm_vector_new (nnodes);
+  NcmSpline *s          = ncm_spline_cubic_notaknot_new ();
+  const gdouble lnki    = log (ki);
+  const gdouble lnkf    = log (kf);
+  guint j;
+
+  g_assert_cmpuint (nnodes, >=, ncm_spline_min_size (s));
+  g_assert_cmpfloat (kf, >, ki);
+
+  for (j = 0; j < nnodes; j++)
+  {
+    const gdouble lnk = lnki + (lnkf - lnki) * j / (nnodes - 1.0);
+    ncm_vector_set (lnk_vec, j, lnk);
+    ncm_vector_set (k_vec, j, exp (lnk));
+  }
+
+  nc_hipert_two_fluids_compute_zeta_spectrum (ptf, cosmo, main_mode, alpha_i, alpha_f, prec, k_vec, Delta_zeta, NULL);
+
+  for (j = 0; j < nnodes; j++)
+    ncm_vector_set (Delta_zeta, j, log (ncm_vector_get (Delta_zeta, j)));
+
+  ncm_spline_set (s, lnk_vec, Delta_zeta, TRUE);
+
+  ncm_vector_free (k_vec);
+  ncm_vector_free (lnk_vec);
+  ncm_vector_free (Delta_zeta);
+
+  return s;
+}
@@ -33,6 +33,8 @@
 #endif /* NUMCOSMO_GIR_SCAN */
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_ode_spline.h>
+#include <numcosmo/math/ncm_spline.h>
+#include <numcosmo/math/ncm_vector.h>
 #include <numcosmo/nc_hicosmo.h>
 #include <numcosmo/perturbations/nc_hipert.h>
 #include <numcosmo/perturbations/nc_hipert_wkb.h>
@@ -108,6 +110,9 @@ gdouble nc_hipert_two_fluids_get_state_mod (NcHIPertTwoFluids *ptf);
 
 gdouble nc_hipert_two_fluids_get_cross_time (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, NcHIPertTwoFluidsCross cross, gdouble alpha_i, gdouble prec);
 
+void nc_hipert_two_fluids_compute_zeta_spectrum (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, guint main_mode, const gdouble alpha_i, const gdouble alpha_f, const gdouble prec, NcmVector *k_vec, NcmVector *Delta_zeta, NcmVector *Delta_S);
+NcmSpline *nc_hipert_two_fluids_compute_zeta_spectrum_spline (NcHIPertTwoFluids *ptf, NcHICosmo *cosmo, guint main_mode, const gdouble alpha_i, const gdouble alpha_f, const gdouble prec, const gdouble ki, const gdouble kf, const guint nnodes);
+
 #define NC_HIPERT_TWO_FLUIDS_A2Q(Ai) (cimag (Ai)) 
 #define NC_HIPERT_TWO_FLUIDS_A2P(Ai) (creal (Ai)) 
 #define NC_HIPERT_TWO_FLUIDS_QP2A(Q,P) ((P) + I * (Q))
@@ -430,11 +430,11 @@ _nc_hipert_wkb_phase_J (realtype alpha, N_Vector y, N_Vector fy, SUNMatrix J, gp
     const gdouble Rnunu = Rnu / nu;
     const gdouble nu2   = nu * nu;
 
-    SUN_DENSE_ACCESS (J, 0, 0) = - Rnunu * U;
-    SUN_DENSE_ACCESS (J, 0, 1) = - Rnunu;
+    _nc_hipert_jac_set (J, 0, 0, - Rnunu * U);
+    _nc_hipert_jac_set (J, 0, 1, - Rnunu);
 
-    SUN_DENSE_ACCESS (J, 1, 0) = - (1.0 / Rnunu) * (nu2 * expm1 (4.0 * rnu) + V) + (4.0 * nu2 / Rnunu) * gsl_pow_4 (Rnu);
-    SUN_DENSE_ACCESS (J, 1, 1) = 0.0;
+    _nc_hipert_jac_set (J, 1, 0, - (1.0 / Rnunu) * (nu2 * expm1 (4.0 * rnu) + V) + (4.0 * nu2 / Rnunu) * gsl_pow_4 (Rnu));
+    _nc_hipert_jac_set (J, 1, 1, 0.0);
     
     return 0;
   }
@@ -528,11 +528,7 @@ _nc_hipert_wkb_prepare_exact (NcHIPertWKB *wkb, NcmModel *model)
   flag = CVodeSetMaxNumSteps (pert->priv->cvode, 1000000);
   NCM_CVODE_CHECK (&flag, "CVodeSetMaxNumSteps", 1, );
 
-  flag = CVodeSetLinearSolver (pert->priv->cvode, pert->priv->LS, pert->priv->A);
-  NCM_CVODE_CHECK (&flag, "CVodeSetLinearSolver", 1, );
-
-  flag = CVodeSetJacFn (pert->priv->cvode, &_nc_hipert_wkb_phase_J);
-  NCM_CVODE_CHECK (&flag, "CVodeSetJacFn", 1, );
+  _nc_hipert_set_lin_solver_opts (pert, &_nc_hipert_wkb_phase_J);
   
   {
     gdouble last = wkb->alpha_i;
@@ -0,0 +1,751 @@
+/***************************************************************************
+ *            test_nc_data_reduced_shear_cluster_mass.c
+ *
+ *  Sun October 18 18:40:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+#include <gsl/gsl_integration.h>
+
+#ifdef HAVE_HDF5
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#endif /* HAVE_HDF5 */
+
+#define TEST_NC_DRS_NGAL 40
+#define TEST_NC_DRS_NZ 64
+#define TEST_NC_DRS_RA 10.0
+#define TEST_NC_DRS_DEC -5.0
+#define TEST_NC_DRS_ZC 0.3
+#define TEST_NC_DRS_NGAL_THREADS 3000
+#define TEST_NC_DRS_NGAL_QUAD 60
+
+typedef struct _TestNcDataReducedShearClusterMass
+{
+  NcDataReducedShearClusterMass *drs;
+  gchar *tmp_dir;
+  gchar *h5_file;
+  gdouble ra[TEST_NC_DRS_NGAL];
+  gdouble dec[TEST_NC_DRS_NGAL];
+  gdouble e1[TEST_NC_DRS_NGAL];
+  gdouble e2[TEST_NC_DRS_NGAL];
+  gchar filter[TEST_NC_DRS_NGAL];
+  gdouble z_best[TEST_NC_DRS_NGAL];
+  gdouble zbins[TEST_NC_DRS_NGAL][TEST_NC_DRS_NZ];
+  gdouble pdz[TEST_NC_DRS_NGAL][TEST_NC_DRS_NZ];
+} TestNcDataReducedShearClusterMass;
+
+void test_nc_data_reduced_shear_cluster_mass_new (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_load_hdf5 (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_load_hdf5_cut (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_traps (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_load_hdf5_empty (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_m2lnL_threads (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_photoz (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_spec (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+void test_nc_data_reduced_shear_cluster_mass_free (TestNcDataReducedShearClusterMass *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/m2lnL/threads", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_m2lnL_threads,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/m2lnL/quad/photoz", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_photoz,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/m2lnL/quad/spec", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_spec,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+#ifdef HAVE_HDF5
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/hdf5/load", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_load_hdf5,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/hdf5/load_cut", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_load_hdf5_cut,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/hdf5/traps", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_traps,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+
+#if GLIB_CHECK_VERSION (2, 38, 0)
+  g_test_add ("/nc/data_reduced_shear_cluster_mass/hdf5/empty/subprocess", TestNcDataReducedShearClusterMass, NULL,
+              &test_nc_data_reduced_shear_cluster_mass_new,
+              &test_nc_data_reduced_shear_cluster_mass_load_hdf5_empty,
+              &test_nc_data_reduced_shear_cluster_mass_free);
+#endif
+#endif /* HAVE_HDF5 */
+
+  g_test_run ();
+}
+
+#ifdef HAVE_HDF5
+
+typedef struct _TestNcDRSGal
+{
+  glong id;
+  gdouble ra;
+  gdouble dec;
+  gdouble e1;
+  gdouble e2;
+  gchar filter;
+} TestNcDRSGal;
+
+typedef struct _TestNcDRSPhotoz
+{
+  glong id;
+  gdouble z_best;
+  gdouble zbins[TEST_NC_DRS_NZ];
+  gdouble pdz[TEST_NC_DRS_NZ];
+} TestNcDRSPhotoz;
+
+static void
+_test_nc_data_reduced_shear_cluster_mass_write_hdf5 (TestNcDataReducedShearClusterMass *test)
+{
+  const gchar *gal_names[]   = {"id", "coord_ra_deg", "coord_dec_deg", "ext_shapeHSM_HsmShapeRegauss_e1", "ext_shapeHSM_HsmShapeRegauss_e2", "filter"};
+  const size_t gal_offsets[] = {
+    HOFFSET (TestNcDRSGal, id), HOFFSET (TestNcDRSGal, ra), HOFFSET (TestNcDRSGal, dec),
+    HOFFSET (TestNcDRSGal, e1), HOFFSET (TestNcDRSGal, e2), HOFFSET (TestNcDRSGal, filter)
+  };
+  const gchar *pz_names[]    = {"id", "Z_BEST", "zbins", "pdz"};
+  const size_t pz_offsets[]  = {HOFFSET (TestNcDRSPhotoz, id), HOFFSET (TestNcDRSPhotoz, z_best), HOFFSET (TestNcDRSPhotoz, zbins), HOFFSET (TestNcDRSPhotoz, pdz)};
+  const hsize_t dims[1]      = {TEST_NC_DRS_NZ};
+  TestNcDRSGal *gal          = g_new0 (TestNcDRSGal, TEST_NC_DRS_NGAL);
+  TestNcDRSPhotoz *pz        = g_new0 (TestNcDRSPhotoz, TEST_NC_DRS_NGAL);
+  hid_t str_t                = H5Tcopy (H5T_C_S1);
+  hid_t arr_t                = H5Tarray_create2 (H5T_NATIVE_DOUBLE, 1, dims);
+  hid_t gal_types[6];
+  hid_t pz_types[4];
+  hid_t h5f;
+  herr_t ret;
+  guint i, j;
+
+  ret = H5Tset_size (str_t, 1);
+  g_assert_cmpint (ret, !=, -1);
+  ret = H5Tset_strpad (str_t, H5T_STR_NULLPAD);
+  g_assert_cmpint (ret, !=, -1);
+
+  gal_types[0] = H5T_NATIVE_LONG;
+  gal_types[1] = H5T_NATIVE_DOUBLE;
+  gal_types[2] = H5T_NATIVE_DOUBLE;
+  gal_types[3] = H5T_NATIVE_DOUBLE;
+  gal_types[4] = H5T_NATIVE_DOUBLE;
+  gal_types[5] = str_t;
+
+  pz_types[0] = H5T_NATIVE_LONG;
+  pz_types[1] = H5T_NATIVE_DOUBLE;
+  pz_types[2] = arr_t;
+  pz_types[3] = arr_t;
+
+  for (i = 0; i < TEST_NC_DRS_NGAL; i++)
+  {
+    gal[i].id     = 1000 + i;
+    gal[i].ra     = test->ra[i];
+    gal[i].dec    = test->dec[i];
+    gal[i].e1     = test->e1[i];
+    gal[i].e2     = test->e2[i];
+    gal[i].filter = test->filter[i];
+
+    /* The photo-z table is written in reverse order, the loader must match them by id. */
+    pz[TEST_NC_DRS_NGAL - 1 - i].id     = 1000 + i;
+    pz[TEST_NC_DRS_NGAL - 1 - i].z_best = test->z_best[i];
+
+    for (j = 0; j < TEST_NC_DRS_NZ; j++)
+    {
+      pz[TEST_NC_DRS_NGAL - 1 - i].zbins[j] = test->zbins[i][j];
+      pz[TEST_NC_DRS_NGAL - 1 - i].pdz[j]   = test->pdz[i][j];
+    }
+  }
+
+  h5f = H5Fcreate (test->h5_file, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  g_assert_cmpint (h5f, >=, 0);
+
+  ret = H5TBmake_table ("galaxies", h5f, "deepCoadd_meas", 6, TEST_NC_DRS_NGAL, sizeof (TestNcDRSGal),
+                        gal_names, gal_offsets, gal_types, 16, NULL, 0, gal);
+  g_assert_cmpint (ret, >=, 0);
+
+  ret = H5TBmake_table ("photoz", h5f, "zphot_ref", 4, TEST_NC_DRS_NGAL, sizeof (TestNcDRSPhotoz),
+                        pz_names, pz_offsets, pz_types, 16, NULL, 0, pz);
+  g_assert_cmpint (ret, >=, 0);
+
+  ret = H5Fclose (h5f);
+  g_assert_cmpint (ret, >=, 0);
+  H5Tclose (str_t);
+  H5Tclose (arr_t);
+
+  g_free (gal);
+  g_free (pz);
+}
+
+#endif /* HAVE_HDF5 */
+
+void
+test_nc_data_reduced_shear_cluster_mass_new (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  NcDistance *dist = nc_distance_new (3.0);
+  NcmRNG *rng      = ncm_rng_seeded_new (NULL, 1234);
+  guint i, j;
+
+  test->drs     = nc_data_reduced_shear_cluster_mass_new (dist);
+  test->tmp_dir = g_dir_make_tmp ("test_nc_data_reduced_shear_cluster_mass_XXXXXX", NULL);
+  test->h5_file = g_build_filename (test->tmp_dir, "drs.h5", NULL);
+
+  g_assert (test->tmp_dir != NULL);
+
+  for (i = 0; i < TEST_NC_DRS_NGAL; i++)
+  {
+    const gdouble theta = 2.0 * M_PI * i / TEST_NC_DRS_NGAL;
+    const gdouble r_deg = 0.2 * (i + 1.0) / TEST_NC_DRS_NGAL;
+    gdouble zpeak;
+
+    test->ra[i]     = TEST_NC_DRS_RA + r_deg * cos (theta) / cos (TEST_NC_DRS_DEC * M_PI / 180.0);
+    test->dec[i]    = TEST_NC_DRS_DEC + r_deg * sin (theta);
+    test->e1[i]     = ncm_rng_gaussian_gen (rng, 0.0, 0.2);
+    test->e2[i]     = ncm_rng_gaussian_gen (rng, 0.0, 0.2);
+    test->filter[i] = (i % 5 == 4) ? 'r' : 'i';
+    test->z_best[i] = ncm_rng_uniform_gen (rng, 0.4, 1.9);
+
+    /* Kept without cuts: a negative and a non-finite Z_BEST. */
+    if (i == 1)
+      test->z_best[i] = -0.2;
+    else if (i == 2)
+      test->z_best[i] = GSL_NAN;
+
+    /* Always discarded: non-finite shape. */
+    if (i == 3)
+      test->e1[i] = GSL_NAN;
+
+    zpeak = gsl_finite (test->z_best[i]) ? test->z_best[i] : 1.0;
+
+    for (j = 0; j < TEST_NC_DRS_NZ; j++)
+    {
+      const gdouble z = 3.0 * j / (TEST_NC_DRS_NZ - 1.0);
+      const gdouble u = (z - zpeak) / 0.1;
+
+      test->zbins[i][j] = z;
+      test->pdz[i][j]   = (fabs (u) < 3.0) ? exp (-0.5 * u * u) : 0.0;
+    }
+
+    /* A delta distribution, only Z_BEST is kept. */
+    if (i == 6)
+    {
+      for (j = 0; j < TEST_NC_DRS_NZ; j++)
+        test->pdz[i][j] = (j == 20) ? 1.0 : 0.0;
+    }
+  }
+
+#ifdef HAVE_HDF5
+  _test_nc_data_reduced_shear_cluster_mass_write_hdf5 (test);
+#endif /* HAVE_HDF5 */
+
+  nc_distance_free (dist);
+  ncm_rng_free (rng);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_free (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_data_reduced_shear_cluster_mass_free, test->drs);
+
+  g_unlink (test->h5_file);
+  g_rmdir (test->tmp_dir);
+
+  g_free (test->h5_file);
+  g_free (test->tmp_dir);
+}
+
+static gboolean
+_test_nc_data_reduced_shear_cluster_mass_keep (TestNcDataReducedShearClusterMass *test, const guint i, const gdouble r_min, const gdouble r_max, const gdouble zb_min, const gdouble zb_max, gdouble *r_arcmin)
+{
+  if ((test->filter[i] != 'i') || !gsl_finite (test->e1[i]) || !gsl_finite (test->e2[i]))
+    return FALSE;
+
+  r_arcmin[0] = ncm_util_great_circle_distance (test->ra[i], test->dec[i], TEST_NC_DRS_RA, TEST_NC_DRS_DEC) * 60.0;
+
+  if ((gsl_finite (zb_min) || gsl_finite (zb_max)) && !((test->z_best[i] >= zb_min) && (test->z_best[i] <= zb_max)))
+    return FALSE;
+
+  if ((gsl_finite (r_min) || gsl_finite (r_max)) && !((r_arcmin[0] >= r_min) && (r_arcmin[0] <= r_max)))
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+_test_nc_data_reduced_shear_cluster_mass_check (TestNcDataReducedShearClusterMass *test, NcDataReducedShearClusterMass *drs, const gdouble r_min, const gdouble r_max, const gdouble zb_min, const gdouble zb_max)
+{
+  NcmMatrix *gal_obs   = NULL;
+  NcmVector *pz_z      = NULL;
+  NcmVector *pz_pdf    = NULL;
+  NcmVector *pz_z_best = NULL;
+  NcmVector *pz_nknots = NULL;
+  guint row            = 0;
+  guint knot           = 0;
+  guint i;
+
+  g_object_get (drs,
+                "gal-obs",   &gal_obs,
+                "pz-z",      &pz_z,
+                "pz-pdf",    &pz_pdf,
+                "pz-z-best", &pz_z_best,
+                "pz-nknots", &pz_nknots,
+                NULL);
+
+  g_assert (gal_obs != NULL);
+  g_assert (pz_z_best != NULL);
+  g_assert (pz_nknots != NULL);
+  g_assert_cmpuint (ncm_matrix_ncols (gal_obs), ==, 2);
+  g_assert_cmpuint (ncm_vector_len (pz_z_best), ==, ncm_matrix_nrows (gal_obs));
+  g_assert_cmpuint (ncm_vector_len (pz_nknots), ==, ncm_matrix_nrows (gal_obs));
+
+  /* The photo-z table is written in reverse order, so are the loaded galaxies. */
+  for (i = TEST_NC_DRS_NGAL; i-- > 0;)
+  {
+    gdouble r_arcmin;
+
+    if (!_test_nc_data_reduced_shear_cluster_mass_keep (test, i, r_min, r_max, zb_min, zb_max, &r_arcmin))
+      continue;
+
+    g_assert_cmpuint (row, <, ncm_matrix_nrows (gal_obs));
+    ncm_assert_cmpdouble_e (ncm_matrix_get (gal_obs, row, 0), ==, r_arcmin, 1.0e-12, 0.0);
+
+    if (gsl_finite (test->z_best[i]))
+      ncm_assert_cmpdouble (ncm_vector_get (pz_z_best, row), ==, test->z_best[i]);
+    else
+      g_assert (gsl_isnan (ncm_vector_get (pz_z_best, row)));
+
+    {
+      gint first_nz = -1, last_nz = -1;
+      guint nknots  = 0;
+      gint j;
+
+      for (j = 0; j < TEST_NC_DRS_NZ; j++)
+      {
+        if (test->pdz[i][j] > 0.0)
+        {
+          if (first_nz == -1)
+            first_nz = j;
+          last_nz = j;
+        }
+      }
+
+      if (first_nz != last_nz)
+      {
+        const gint k_i = GSL_MAX (first_nz - 1, 0);
+        const gint k_f = GSL_MIN (last_nz + 1, TEST_NC_DRS_NZ - 1);
+
+        nknots = k_f - k_i + 1;
+        for (j = k_i; j <= k_f; j++)
+        {
+          ncm_assert_cmpdouble (ncm_vector_get (pz_z, knot),   ==, test->zbins[i][j]);
+          ncm_assert_cmpdouble (ncm_vector_get (pz_pdf, knot), ==, test->pdz[i][j]);
+          knot++;
+        }
+      }
+
+      g_assert_cmpuint (ncm_vector_get (pz_nknots, row), ==, nknots);
+    }
+
+    row++;
+  }
+
+  g_assert_cmpuint (row, ==, ncm_matrix_nrows (gal_obs));
+  g_assert_cmpuint (knot, ==, ncm_vector_len (pz_z));
+  g_assert_cmpuint (knot, ==, ncm_vector_len (pz_pdf));
+
+  ncm_matrix_free (gal_obs);
+  ncm_vector_free (pz_z);
+  ncm_vector_free (pz_pdf);
+  ncm_vector_free (pz_z_best);
+  ncm_vector_free (pz_nknots);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_load_hdf5 (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  gchar *drs_file = g_build_filename (test->tmp_dir, "drs.obj", NULL);
+  NcDataReducedShearClusterMass *drs_dup;
+
+  nc_data_reduced_shear_cluster_mass_load_hdf5 (test->drs, test->h5_file, 'i', TEST_NC_DRS_ZC, TEST_NC_DRS_RA, TEST_NC_DRS_DEC);
+  _test_nc_data_reduced_shear_cluster_mass_check (test, test->drs, GSL_NEGINF, GSL_POSINF, GSL_NEGINF, GSL_POSINF);
+
+  /* Round trip through the serialized object. */
+  ncm_serialize_global_to_file (G_OBJECT (test->drs), drs_file);
+  drs_dup = nc_data_reduced_shear_cluster_mass_new_from_file (drs_file);
+
+  _test_nc_data_reduced_shear_cluster_mass_check (test, drs_dup, GSL_NEGINF, GSL_POSINF, GSL_NEGINF, GSL_POSINF);
+
+  nc_data_reduced_shear_cluster_mass_free (drs_dup);
+  g_unlink (drs_file);
+  g_free (drs_file);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_load_hdf5_cut (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  nc_data_reduced_shear_cluster_mass_load_hdf5_cut (test->drs, test->h5_file, 'i', TEST_NC_DRS_ZC, TEST_NC_DRS_RA, TEST_NC_DRS_DEC, 2.0, 9.0, 0.5, 1.5);
+  _test_nc_data_reduced_shear_cluster_mass_check (test, test->drs, 2.0, 9.0, 0.5, 1.5);
+
+  /* One-sided cuts: the negative and the non-finite Z_BEST are dropped. */
+  nc_data_reduced_shear_cluster_mass_load_hdf5_cut (test->drs, test->h5_file, 'i', TEST_NC_DRS_ZC, TEST_NC_DRS_RA, TEST_NC_DRS_DEC, GSL_NEGINF, GSL_POSINF, 0.0, GSL_POSINF);
+  _test_nc_data_reduced_shear_cluster_mass_check (test, test->drs, GSL_NEGINF, GSL_POSINF, 0.0, GSL_POSINF);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_traps (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+#if GLIB_CHECK_VERSION (2, 38, 0)
+  g_test_trap_subprocess ("/nc/data_reduced_shear_cluster_mass/hdf5/empty/subprocess", 0, 0);
+  g_test_trap_assert_failed ();
+  g_test_trap_assert_stderr ("*no galaxy left*");
+#endif
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_load_hdf5_empty (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  nc_data_reduced_shear_cluster_mass_load_hdf5_cut (test->drs, test->h5_file, 'i', TEST_NC_DRS_ZC, TEST_NC_DRS_RA, TEST_NC_DRS_DEC, GSL_NEGINF, GSL_POSINF, 10.0, 20.0);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_m2lnL_threads (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  const guint ngal              = TEST_NC_DRS_NGAL_THREADS;
+  const gdouble dz[]            = {-0.2, -0.1, 0.0, 0.1, 0.2};
+  const gdouble dP[]            = {0.0, 0.5, 1.0, 0.5, 0.0};
+  const guint nk                = G_N_ELEMENTS (dz);
+  NcmRNG *rng                   = ncm_rng_seeded_new (NULL, 4321);
+  NcDistance *dist              = nc_distance_new (3.0);
+  NcHICosmo *cosmo              = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcDensityProfile *dp          = NC_DENSITY_PROFILE (nc_density_profile_new_from_name ("NcDensityProfileNFW{'Delta':<200.0>}"));
+  NcWLSurfaceMassDensity *smd   = nc_wl_surface_mass_density_new (dist);
+  NcReducedShearClusterMass *rs = nc_reduced_shear_cluster_mass_new ();
+  NcmMSet *mset                 = ncm_mset_new (cosmo, dp, smd, rs, NULL);
+  NcmMatrix *gal_obs            = ncm_matrix_new (ngal, 2);
+  NcmVector *pz_z_best          = ncm_vector_new (ngal);
+  NcmVector *pz_nknots          = ncm_vector_new (ngal);
+  NcmVector *pz_z               = ncm_vector_new (nk * ((ngal + 2) / 3));
+  NcmVector *pz_pdf             = ncm_vector_new (nk * ((ngal + 2) / 3));
+  const guint nthreads[]        = {4, 1, 2};
+  guint knot                    = 0;
+  guint i, l, n;
+
+  for (i = 0; i < ngal; i++)
+  {
+    const gdouble zb = ncm_rng_uniform_gen (rng, 0.5, 1.0);
+
+    ncm_matrix_set (gal_obs, i, 0, ncm_rng_uniform_gen (rng, 2.0, 12.0));
+    ncm_matrix_set (gal_obs, i, 1, ncm_rng_gaussian_gen (rng, 0.05, 0.2));
+    ncm_vector_set (pz_z_best, i, zb);
+
+    /* One third of the galaxies have a P(z), the others only Z_BEST. */
+    if (i % 3 == 0)
+    {
+      for (l = 0; l < nk; l++)
+      {
+        ncm_vector_set (pz_z, knot, zb + dz[l]);
+        ncm_vector_set (pz_pdf, knot, dP[l]);
+        knot++;
+      }
+      ncm_vector_set (pz_nknots, i, nk);
+    }
+    else
+      ncm_vector_set (pz_nknots, i, 0.0);
+  }
+  g_assert_cmpuint (knot, ==, ncm_vector_len (pz_z));
+
+  g_object_set (test->drs,
+                "z-cluster", TEST_NC_DRS_ZC,
+                "gal-obs",   gal_obs,
+                "pz-z",      pz_z,
+                "pz-pdf",    pz_pdf,
+                "pz-z-best", pz_z_best,
+                "pz-nknots", pz_nknots,
+                NULL);
+
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_M_DELTA, 1.0e15);
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_C,       4.0);
+
+  for (l = 0; l < 2; l++)
+  {
+    gdouble m2lnL_0 = 0.0;
+
+    for (n = 0; n < G_N_ELEMENTS (nthreads); n++)
+    {
+      gdouble m2lnL;
+
+      nc_data_reduced_shear_cluster_mass_set_nthreads (test->drs, nthreads[n]);
+      ncm_data_m2lnL_val (NCM_DATA (test->drs), mset, &m2lnL);
+
+      g_assert (gsl_finite (m2lnL));
+      g_assert_cmpfloat (m2lnL, !=, 0.0);
+
+      if (n == 0)
+        m2lnL_0 = m2lnL;
+      else
+        ncm_assert_cmpdouble (m2lnL, ==, m2lnL_0);
+    }
+
+    /* A new profile shape. */
+    ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_C, 6.0);
+  }
+
+  ncm_rng_free (rng);
+  nc_distance_free (dist);
+  nc_hicosmo_free (cosmo);
+  nc_density_profile_free (dp);
+  nc_wl_surface_mass_density_free (smd);
+  nc_reduced_shear_cluster_mass_free (rs);
+  ncm_mset_free (mset);
+  ncm_matrix_free (gal_obs);
+  ncm_vector_free (pz_z_best);
+  ncm_vector_free (pz_nknots);
+  ncm_vector_free (pz_z);
+  ncm_vector_free (pz_pdf);
+}
+
+typedef struct _TestNcDRSQuad
+{
+  NcGalaxyRedshift *gz;
+  NcReducedShearClusterMass *rs;
+  NcWLSurfaceMassDensity *smd;
+  NcDensityProfile *dp;
+  NcHICosmo *cosmo;
+  guint j;
+  gdouble R_Mpc;
+  gdouble g_obs;
+} TestNcDRSQuad;
+
+static gdouble
+_test_nc_data_reduced_shear_cluster_mass_P (const gdouble z, TestNcDRSQuad *q)
+{
+  const gdouble g_th = nc_wl_surface_mass_density_reduced_shear (q->smd, q->dp, q->cosmo, q->R_Mpc, z, TEST_NC_DRS_ZC, TEST_NC_DRS_ZC);
+
+  return nc_reduced_shear_cluster_mass_P_z_gth_gobs (q->rs, q->cosmo, z, g_th, q->g_obs);
+}
+
+static gdouble
+_test_nc_data_reduced_shear_cluster_mass_int (gdouble z, gpointer userdata)
+{
+  TestNcDRSQuad *q = (TestNcDRSQuad *) userdata;
+
+  return nc_galaxy_redshift_pdf (q->gz, q->j, z) * _test_nc_data_reduced_shear_cluster_mass_P (z, q);
+}
+
+/*
+ * Reference likelihood: the source redshift integrals are computed with
+ * an adaptive quadrature and the reduced shear directly at each redshift,
+ * without the fixed nodes and the beta_s table.
+ */
+static gdouble
+_test_nc_data_reduced_shear_cluster_mass_m2lnL_ref (GPtrArray *gz_array, NcmMatrix *gal_obs, TestNcDRSQuad *q)
+{
+  gsl_integration_workspace *w = gsl_integration_workspace_alloc (1000);
+  const gdouble dA             = nc_distance_angular_diameter (q->smd->dist, q->cosmo, TEST_NC_DRS_ZC) * nc_hicosmo_RH_Mpc (q->cosmo);
+  gdouble m2lnL                = 0.0;
+  guint i;
+
+  for (i = 0; i < gz_array->len; i++)
+  {
+    const gdouble z_gal = nc_galaxy_redshift_mode (g_ptr_array_index (gz_array, i));
+
+    q->gz    = g_ptr_array_index (gz_array, i);
+    q->R_Mpc = (ncm_matrix_get (gal_obs, i, 0) / 60.0) * (M_PI / 180.0) * dA;
+    q->g_obs = ncm_matrix_get (gal_obs, i, 1);
+
+    /* The same cuts applied by the likelihood. */
+    if ((z_gal < TEST_NC_DRS_ZC + 0.1) || (z_gal > 1.25) || (q->R_Mpc < 0.75) || (q->R_Mpc > 3.0))
+      continue;
+
+    if (!nc_galaxy_redshift_has_dist (q->gz))
+    {
+      m2lnL += -2.0 * log (_test_nc_data_reduced_shear_cluster_mass_P (z_gal, q));
+    }
+    else
+    {
+      gsl_function F;
+
+      F.function = &_test_nc_data_reduced_shear_cluster_mass_int;
+      F.params   = q;
+
+      for (q->j = 0; q->j < nc_galaxy_redshift_nintervals (q->gz); q->j++)
+      {
+        gdouble z_lower, z_upper, P_j, err;
+
+        nc_galaxy_redshift_pdf_limits (q->gz, q->j, &z_lower, &z_upper);
+        gsl_integration_qag (&F, z_lower, z_upper, 0.0, 1.0e-7, 1000, GSL_INTEG_GAUSS31, w, &P_j, &err);
+
+        m2lnL += -2.0 * log (P_j);
+      }
+    }
+  }
+
+  gsl_integration_workspace_free (w);
+
+  return m2lnL;
+}
+
+static void
+_test_nc_data_reduced_shear_cluster_mass_m2lnL_quad (TestNcDataReducedShearClusterMass *test, const gboolean photoz)
+{
+  const guint ngal              = TEST_NC_DRS_NGAL_QUAD;
+  const guint nk                = 13;
+  NcmRNG *rng                   = ncm_rng_seeded_new (NULL, 5678);
+  NcDistance *dist              = nc_distance_new (3.0);
+  NcHICosmo *cosmo              = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcDensityProfile *dp          = NC_DENSITY_PROFILE (nc_density_profile_new_from_name ("NcDensityProfileNFW{'Delta':<200.0>}"));
+  NcWLSurfaceMassDensity *smd   = nc_wl_surface_mass_density_new (dist);
+  NcReducedShearClusterMass *rs = nc_reduced_shear_cluster_mass_new ();
+  NcmMSet *mset                 = ncm_mset_new (cosmo, dp, smd, rs, NULL);
+  NcmMatrix *gal_obs            = ncm_matrix_new (ngal, 2);
+  NcmVector *pz_z_best          = ncm_vector_new (ngal);
+  NcmVector *pz_nknots          = ncm_vector_new (ngal);
+  NcmVector *pz_z               = photoz ? ncm_vector_new (nk * ngal) : NULL;
+  NcmVector *pz_pdf             = photoz ? ncm_vector_new (nk * ngal) : NULL;
+  GPtrArray *gz_array           = g_ptr_array_new_with_free_func ((GDestroyNotify) nc_galaxy_redshift_free);
+  TestNcDRSQuad q               = {NULL, rs, smd, dp, cosmo, 0, 0.0, 0.0};
+  gdouble m2lnL, m2lnL_ref;
+  guint i, l;
+
+  for (i = 0; i < ngal; i++)
+  {
+    const gdouble zb = ncm_rng_uniform_gen (rng, 0.7, 1.1);
+
+    ncm_matrix_set (gal_obs, i, 0, ncm_rng_uniform_gen (rng, 3.0, 10.0));
+    ncm_matrix_set (gal_obs, i, 1, ncm_rng_gaussian_gen (rng, 0.05, 0.2));
+    ncm_vector_set (pz_z_best, i, zb);
+
+    if (photoz)
+    {
+      NcmVector *zv               = ncm_vector_get_subvector (pz_z, nk * i, nk);
+      NcmVector *Pzv              = ncm_vector_get_subvector (pz_pdf, nk * i, nk);
+      NcGalaxyRedshiftSpline *gzs = nc_galaxy_redshift_spline_new ();
+
+      /* A Gaussian P(z) tabulated on a coarse grid, as in the photo-z catalogs. */
+      for (l = 0; l < nk; l++)
+      {
+        const gdouble dz = 0.05 * (l - 0.5 * (nk - 1.0));
+
+        ncm_vector_set (zv, l, zb + dz);
+        ncm_vector_set (Pzv, l, exp (-0.5 * gsl_pow_2 (dz / 0.1)));
+      }
+
+      ncm_vector_set (pz_nknots, i, nk);
+      nc_galaxy_redshift_spline_init_from_vectors (gzs, zv, Pzv);
+      g_ptr_array_add (gz_array, gzs);
+
+      ncm_vector_free (zv);
+      ncm_vector_free (Pzv);
+    }
+    else
+    {
+      ncm_vector_set (pz_nknots, i, 0.0);
+      g_ptr_array_add (gz_array, nc_galaxy_redshift_spec_new (zb));
+    }
+  }
+
+  g_object_set (test->drs,
+                "z-cluster", TEST_NC_DRS_ZC,
+                "gal-obs",   gal_obs,
+                "pz-z",      pz_z,
+                "pz-pdf",    pz_pdf,
+                "pz-z-best", pz_z_best,
+                "pz-nknots", pz_nknots,
+                NULL);
+
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_M_DELTA, 1.0e15);
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_C,       4.0);
+
+  g_assert_cmpuint (nc_data_reduced_shear_cluster_mass_get_nnodes (test->drs), ==, 20);
+  ncm_data_m2lnL_val (NCM_DATA (test->drs), mset, &m2lnL);
+
+  m2lnL_ref = _test_nc_data_reduced_shear_cluster_mass_m2lnL_ref (gz_array, gal_obs, &q);
+  g_assert (gsl_finite (m2lnL_ref));
+  g_assert_cmpfloat (m2lnL_ref, !=, 0.0);
+
+  if (photoz)
+  {
+    gdouble m2lnL_hi;
+
+    /* The default Gauss-Legendre rule, then a much finer one. */
+    ncm_assert_cmpdouble_e (m2lnL, ==, m2lnL_ref, 0.0, ngal * 1.0e-5);
+
+    nc_data_reduced_shear_cluster_mass_set_nnodes (test->drs, 200);
+    ncm_data_m2lnL_val (NCM_DATA (test->drs), mset, &m2lnL_hi);
+
+    ncm_assert_cmpdouble_e (m2lnL_hi, ==, m2lnL_ref, 0.0, ngal * 1.0e-6);
+  }
+  else
+  {
+    /* Only the beta_s table differs from the reference. */
+    ncm_assert_cmpdouble_e (m2lnL, ==, m2lnL_ref, 0.0, ngal * 1.0e-7);
+  }
+
+  g_ptr_array_unref (gz_array);
+  ncm_rng_free (rng);
+  nc_distance_free (dist);
+  nc_hicosmo_free (cosmo);
+  nc_density_profile_free (dp);
+  nc_wl_surface_mass_density_free (smd);
+  nc_reduced_shear_cluster_mass_free (rs);
+  ncm_mset_free (mset);
+  ncm_matrix_free (gal_obs);
+  ncm_vector_free (pz_z_best);
+  ncm_vector_free (pz_nknots);
+  ncm_vector_clear (&pz_z);
+  ncm_vector_clear (&pz_pdf);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_photoz (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  _test_nc_data_reduced_shear_cluster_mass_m2lnL_quad (test, TRUE);
+}
+
+void
+test_nc_data_reduced_shear_cluster_mass_m2lnL_quad_spec (TestNcDataReducedShearClusterMass *test, gconstpointer pdata)
+{
+  _test_nc_data_reduced_shear_cluster_mass_m2lnL_quad (test, FALSE);
+}
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *            test_nc_hipert_adiab.c
+ *
+ *  Sun October 18 23:58:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcHIPertAdiab
+{
+  NcHIPertAdiab *pa;
+  NcHICosmoVexp *Vexp;
+  gdouble tc;
+} TestNcHIPertAdiab;
+
+void test_nc_hipert_adiab_new (TestNcHIPertAdiab *test, gconstpointer pdata);
+void test_nc_hipert_adiab_Delta_array_threaded (TestNcHIPertAdiab *test, gconstpointer pdata);
+void test_nc_hipert_adiab_free (TestNcHIPertAdiab *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/hipert/adiab/Delta_array/threaded", TestNcHIPertAdiab, NULL,
+              &test_nc_hipert_adiab_new,
+              &test_nc_hipert_adiab_Delta_array_threaded,
+              &test_nc_hipert_adiab_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_hipert_adiab_new (TestNcHIPertAdiab *test, gconstpointer pdata)
+{
+  NcmHOAA *hoaa;
+
+  test->pa   = nc_hipert_adiab_new ();
+  test->Vexp = nc_hicosmo_Vexp_new ();
+  hoaa       = NCM_HOAA (test->pa);
+
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_ALPHA_B,   1.0e-1);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_SIGMA_PHI, 0.8);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_D_PHI,     0.5);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_X_B,       1.0e37);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_OMEGA_L,   1.0);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_OMEGA_C,   1.0);
+  ncm_model_orig_param_set (NCM_MODEL (test->Vexp), NC_HICOSMO_VEXP_H0,        67.8);
+
+  test->tc = nc_hicosmo_Vexp_tau_xe (test->Vexp, 1.0e15);
+
+  ncm_hoaa_set_ti (hoaa, nc_hicosmo_Vexp_tau_min (test->Vexp));
+  ncm_hoaa_set_tf (hoaa, test->tc);
+  ncm_hoaa_set_reltol (hoaa, 1.0e-10);
+}
+
+void
+test_nc_hipert_adiab_free (TestNcHIPertAdiab *test, gconstpointer pdata)
+{
+  nc_hicosmo_free (NC_HICOSMO (test->Vexp));
+
+  NCM_TEST_FREE (nc_hipert_adiab_free, test->pa);
+}
+
+void
+test_nc_hipert_adiab_Delta_array_threaded (TestNcHIPertAdiab *test, gconstpointer pdata)
+{
+  NcmHOAA *hoaa           = NCM_HOAA (test->pa);
+  NcmModel *model         = NCM_MODEL (test->Vexp);
+  const guint nk          = 4;
+  NcmVector *k            = ncm_vector_new (nk);
+  NcmVector *Delta_phi    = ncm_vector_new (nk);
+  NcmVector *Delta_Pphi   = ncm_vector_new (nk);
+  NcmVector *Delta_phi_t  = ncm_vector_new (nk);
+  NcmVector *Delta_Pphi_t = ncm_vector_new (nk);
+  guint j;
+
+  for (j = 0; j < nk; j++)
+    ncm_vector_set (k, j, 0.5 * pow (2.0, j));
+
+  ncm_hoaa_set_nthreads (hoaa, 1);
+  ncm_hoaa_eval_Delta_array (hoaa, model, test->tc, k, Delta_phi, Delta_Pphi);
+
+  /* The copies used by each thread must carry the whole @hoaa configuration. */
+  ncm_hoaa_set_nthreads (hoaa, 3);
+  ncm_hoaa_eval_Delta_array (hoaa, model, test->tc, k, Delta_phi_t, Delta_Pphi_t);
+
+  for (j = 0; j < nk; j++)
+  {
+    g_assert_cmpfloat (ncm_vector_get (Delta_phi, j), >, 0.0);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (Delta_phi_t, j),  ==, ncm_vector_get (Delta_phi, j),  1.0e-10, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (Delta_Pphi_t, j), ==, ncm_vector_get (Delta_Pphi, j), 1.0e-10, 0.0);
+  }
+
+  ncm_vector_free (k);
+  ncm_vector_free (Delta_phi);
+  ncm_vector_free (Delta_Pphi);
+  ncm_vector_free (Delta_phi_t);
+  ncm_vector_free (Delta_Pphi_t);
+}
@@ -0,0 +1,315 @@
+/***************************************************************************
+ *            test_nc_hipert_boltzmann.c
+ *
+ *  Sun October 18 17:02:11 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_sf_bessel.h>
+#include <gsl/gsl_integration.h>
+
+#ifndef NUMCOSMO_GIR_SCAN
+#include <cvode/cvode.h>
+#include <nvector/nvector_serial.h>
+#include <sundials/sundials_matrix.h>
+#include <sundials/sundials_linearsolver.h>
+#endif /* NUMCOSMO_GIR_SCAN */
+
+#include "numcosmo/perturbations/nc_hipert_private.h"
+
+#define TEST_NC_HIPERT_BOLTZMANN_ETA0 10.0
+#define TEST_NC_HIPERT_BOLTZMANN_ETAS 3.0
+#define TEST_NC_HIPERT_BOLTZMANN_SIGMA 0.7
+#define TEST_NC_HIPERT_BOLTZMANN_NETA 4001
+#define TEST_NC_HIPERT_BOLTZMANN_LMAX 40
+#define TEST_NC_HIPERT_BOLTZMANN_STD_LMAX 10
+
+typedef struct _TestNcHIPertBoltzmannLOS
+{
+  NcHIPertBoltzmann *pb;
+  NcmVector *k;
+  NcmVector *eta;
+  NcmMatrix *S;
+} TestNcHIPertBoltzmannLOS;
+
+typedef struct _TestNcHIPertBoltzmannLOSArg
+{
+  guint l;
+  gdouble k;
+} TestNcHIPertBoltzmannLOSArg;
+
+typedef struct _TestNcHIPertBoltzmannStd
+{
+  NcHIPertBoltzmann *pb;
+  NcHICosmo *cosmo;
+} TestNcHIPertBoltzmannStd;
+
+void test_nc_hipert_boltzmann_los_new (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_los_transfer (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_los_transfer_threads (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_los_free (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata);
+
+void test_nc_hipert_boltzmann_std_new (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_std_lin_solver (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+void test_nc_hipert_boltzmann_std_free (TestNcHIPertBoltzmannStd *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/hipert/boltzmann/los/transfer", TestNcHIPertBoltzmannLOS, NULL,
+              &test_nc_hipert_boltzmann_los_new,
+              &test_nc_hipert_boltzmann_los_transfer,
+              &test_nc_hipert_boltzmann_los_free);
+
+  g_test_add ("/nc/hipert/boltzmann/los/transfer/threads", TestNcHIPertBoltzmannLOS, NULL,
+              &test_nc_hipert_boltzmann_los_new,
+              &test_nc_hipert_boltzmann_los_transfer_threads,
+              &test_nc_hipert_boltzmann_los_free);
+
+  g_test_add ("/nc/hipert/boltzmann/std/lin_solver/band", TestNcHIPertBoltzmannStd, GINT_TO_POINTER (NC_HIPERT_LIN_SOLVER_BAND),
+              &test_nc_hipert_boltzmann_std_new,
+              &test_nc_hipert_boltzmann_std_lin_solver,
+              &test_nc_hipert_boltzmann_std_free);
+
+  g_test_add ("/nc/hipert/boltzmann/std/lin_solver/spgmr", TestNcHIPertBoltzmannStd, GINT_TO_POINTER (NC_HIPERT_LIN_SOLVER_SPGMR),
+              &test_nc_hipert_boltzmann_std_new,
+              &test_nc_hipert_boltzmann_std_lin_solver,
+              &test_nc_hipert_boltzmann_std_free);
+
+  g_test_run ();
+}
+
+static gdouble
+_test_nc_hipert_boltzmann_source (const gdouble k, const gdouble eta)
+{
+  const gdouble u = (eta - TEST_NC_HIPERT_BOLTZMANN_ETAS) / TEST_NC_HIPERT_BOLTZMANN_SIGMA;
+
+  return exp (-0.5 * u * u) / (1.0 + k);
+}
+
+void
+test_nc_hipert_boltzmann_los_new (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata)
+{
+  NcRecomb *recomb = NC_RECOMB (nc_recomb_seager_new ());
+  const gdouble k_a[] = {0.3, 1.0, 2.5, 4.0};
+  const guint nk      = G_N_ELEMENTS (k_a);
+  guint a, j;
+
+  test->pb  = NC_HIPERT_BOLTZMANN (nc_hipert_boltzmann_std_new (recomb, 10));
+  test->k   = ncm_vector_new (nk);
+  test->eta = ncm_vector_new (TEST_NC_HIPERT_BOLTZMANN_NETA);
+  test->S   = ncm_matrix_new (nk, TEST_NC_HIPERT_BOLTZMANN_NETA);
+
+  for (a = 0; a < nk; a++)
+    ncm_vector_set (test->k, a, k_a[a]);
+
+  for (j = 0; j < TEST_NC_HIPERT_BOLTZMANN_NETA; j++)
+    ncm_vector_set (test->eta, j, TEST_NC_HIPERT_BOLTZMANN_ETA0 * j / (TEST_NC_HIPERT_BOLTZMANN_NETA - 1.0));
+
+  for (a = 0; a < nk; a++)
+  {
+    for (j = 0; j < TEST_NC_HIPERT_BOLTZMANN_NETA; j++)
+      ncm_matrix_set (test->S, a, j, _test_nc_hipert_boltzmann_source (k_a[a], ncm_vector_get (test->eta, j)));
+  }
+
+  nc_hipert_boltzmann_set_bessel_table (test->pb, TEST_NC_HIPERT_BOLTZMANN_LMAX,
+                                        ncm_vector_get_max (test->k) * TEST_NC_HIPERT_BOLTZMANN_ETA0, 0.01);
+
+  nc_recomb_free (recomb);
+}
+
+void
+test_nc_hipert_boltzmann_los_free (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata)
+{
+  ncm_vector_free (test->k);
+  ncm_vector_free (test->eta);
+  ncm_matrix_free (test->S);
+
+  NCM_TEST_FREE (nc_hipert_boltzmann_free, test->pb);
+}
+
+static gdouble
+_test_nc_hipert_boltzmann_los_integrand (gdouble eta, gpointer userdata)
+{
+  TestNcHIPertBoltzmannLOSArg *arg = (TestNcHIPertBoltzmannLOSArg *) userdata;
+
+  return _test_nc_hipert_boltzmann_source (arg->k, eta) *
+         gsl_sf_bessel_jl (arg->l, arg->k * (TEST_NC_HIPERT_BOLTZMANN_ETA0 - eta));
+}
+
+void
+test_nc_hipert_boltzmann_los_transfer (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata)
+{
+  const guint nk                   = ncm_vector_len (test->k);
+  const guint ls[]                 = {0, 1, 2, 10, 25, 40};
+  NcmMatrix *Delta_l               = ncm_matrix_new (nk, TEST_NC_HIPERT_BOLTZMANN_LMAX + 1);
+  gsl_integration_workspace **w    = ncm_integral_get_workspace ();
+  TestNcHIPertBoltzmannLOSArg arg;
+  gsl_function F;
+  guint a, n;
+
+  F.function = &_test_nc_hipert_boltzmann_los_integrand;
+  F.params   = &arg;
+
+  nc_hipert_boltzmann_los_transfer (test->pb, test->k, test->eta, test->S, TEST_NC_HIPERT_BOLTZMANN_ETA0, Delta_l);
+
+  for (a = 0; a < nk; a++)
+  {
+    for (n = 0; n < G_N_ELEMENTS (ls); n++)
+    {
+      gdouble Delta, err;
+
+      arg.l = ls[n];
+      arg.k = ncm_vector_get (test->k, a);
+
+      gsl_integration_qag (&F, 0.0, TEST_NC_HIPERT_BOLTZMANN_ETA0, 1.0e-13, 1.0e-10, NCM_INTEGRAL_PARTITION, 6, *w, &Delta, &err);
+
+      ncm_assert_cmpdouble_e (ncm_matrix_get (Delta_l, a, arg.l), ==, Delta, 1.0e-4, 1.0e-7);
+    }
+  }
+
+  ncm_memory_pool_return (w);
+  ncm_matrix_free (Delta_l);
+}
+
+void
+test_nc_hipert_boltzmann_los_transfer_threads (TestNcHIPertBoltzmannLOS *test, gconstpointer pdata)
+{
+  const guint nk       = ncm_vector_len (test->k);
+  NcmMatrix *Delta_l_1 = ncm_matrix_new (nk, TEST_NC_HIPERT_BOLTZMANN_LMAX + 1);
+  NcmMatrix *Delta_l_n = ncm_matrix_new (nk, TEST_NC_HIPERT_BOLTZMANN_LMAX + 1);
+  guint a, l;
+
+  nc_hipert_set_nthreads (NC_HIPERT (test->pb), 1);
+  nc_hipert_boltzmann_los_transfer (test->pb, test->k, test->eta, test->S, TEST_NC_HIPERT_BOLTZMANN_ETA0, Delta_l_1);
+
+  nc_hipert_set_nthreads (NC_HIPERT (test->pb), 3);
+  nc_hipert_boltzmann_los_transfer (test->pb, test->k, test->eta, test->S, TEST_NC_HIPERT_BOLTZMANN_ETA0, Delta_l_n);
+
+  for (a = 0; a < nk; a++)
+  {
+    for (l = 0; l <= TEST_NC_HIPERT_BOLTZMANN_LMAX; l++)
+      ncm_assert_cmpdouble (ncm_matrix_get (Delta_l_1, a, l), ==, ncm_matrix_get (Delta_l_n, a, l));
+  }
+
+  ncm_matrix_free (Delta_l_1);
+  ncm_matrix_free (Delta_l_n);
+}
+
+void
+test_nc_hipert_boltzmann_std_new (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  NcRecomb *recomb = NC_RECOMB (nc_recomb_seager_new ());
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->pb    = NC_HIPERT_BOLTZMANN (nc_hipert_boltzmann_std_new (recomb, TEST_NC_HIPERT_BOLTZMANN_STD_LMAX));
+
+  g_assert_cmpuint (nc_hipert_boltzmann_get_TT_lmax (test->pb), ==, TEST_NC_HIPERT_BOLTZMANN_STD_LMAX);
+  nc_hipert_set_reltol (NC_HIPERT (test->pb), 1.0e-9);
+
+  nc_recomb_free (recomb);
+}
+
+void
+test_nc_hipert_boltzmann_std_free (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  nc_hicosmo_free (test->cosmo);
+
+  NCM_TEST_FREE (nc_hipert_boltzmann_free, test->pb);
+}
+
+/*
+ * Evolves the hierarchy of mode @k from the initial time up to each
+ * x in @x_a and stores the whole state vector in the rows of @res.
+ */
+static void
+_test_nc_hipert_boltzmann_std_evolve (TestNcHIPertBoltzmannStd *test, const gdouble k, const gdouble *x_a, const guint nx, NcmMatrix *res)
+{
+  NcHIPert *pert = NC_HIPERT (test->pb);
+  guint i, j;
+
+  nc_hipert_set_mode_k (pert, k);
+
+  for (i = 0; i < nx; i++)
+  {
+    test->pb->lambdaf = NC_HIPERT_BOLTZMANN_X2LAMBDA (x_a[i]);
+    nc_hipert_boltzmann_prepare (test->pb, test->cosmo);
+
+    g_assert_cmpuint (pert->priv->sys_size, ==, ncm_matrix_ncols (res));
+
+    for (j = 0; j < pert->priv->sys_size; j++)
+      ncm_matrix_set (res, i, j, NV_Ith_S (pert->priv->y, j));
+  }
+}
+
+void
+test_nc_hipert_boltzmann_std_lin_solver (TestNcHIPertBoltzmannStd *test, gconstpointer pdata)
+{
+  const NcHIPertLinSolver lin_solver = GPOINTER_TO_INT (pdata);
+  NcHIPert *pert                     = NC_HIPERT (test->pb);
+  const gdouble k_a[]                = {1.0, 10.0, 100.0};
+  const gdouble x_a[]                = {1.0e5, 1.1e3, 1.0e2, 1.0};
+  const guint nx                     = G_N_ELEMENTS (x_a);
+  const guint len                    = NC_HIPERT_BOLTZMANN_LEN + 2 * (TEST_NC_HIPERT_BOLTZMANN_STD_LMAX + 1 - 3);
+  NcmMatrix *res_dense               = ncm_matrix_new (nx, len);
+  NcmMatrix *res                     = ncm_matrix_new (nx, len);
+  guint a, i, j;
+
+  for (a = 0; a < G_N_ELEMENTS (k_a); a++)
+  {
+    nc_hipert_set_lin_solver (pert, NC_HIPERT_LIN_SOLVER_DENSE);
+    _test_nc_hipert_boltzmann_std_evolve (test, k_a[a], x_a, nx, res_dense);
+
+    /* The bandwidth declared by NcHIPertBoltzmannStd must contain all couplings. */
+    nc_hipert_set_lin_solver (pert, lin_solver);
+    g_assert_cmpint (nc_hipert_get_lin_solver (pert), ==, lin_solver);
+
+    _test_nc_hipert_boltzmann_std_evolve (test, k_a[a], x_a, nx, res);
+
+    for (i = 0; i < nx; i++)
+    {
+      gdouble scale = 0.0;
+
+      for (j = 0; j < len; j++)
+        scale = GSL_MAX (scale, fabs (ncm_matrix_get (res_dense, i, j)));
+
+      g_assert_cmpfloat (scale, >, 0.0);
+
+      for (j = 0; j < len; j++)
+        ncm_assert_cmpdouble_e (ncm_matrix_get (res, i, j), ==, ncm_matrix_get (res_dense, i, j), 1.0e-5, 1.0e-5 * scale);
+    }
+  }
+
+  ncm_matrix_free (res_dense);
+  ncm_matrix_free (res);
+}
@@ -0,0 +1,239 @@
+/***************************************************************************
+ *            test_nc_hipert_two_fluids.c
+ *
+ *  Sun October 18 17:48:30 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#define TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS 5
+
+typedef struct _TestNcHIPertTwoFluids
+{
+  NcHIPertTwoFluids *ptf;
+  NcHICosmo *cosmo;
+  NcmVector *ci;
+  gdouble alpha_i;
+  gdouble alpha_f;
+} TestNcHIPertTwoFluids;
+
+void test_nc_hipert_two_fluids_new (TestNcHIPertTwoFluids *test, gconstpointer pdata);
+void test_nc_hipert_two_fluids_lin_solver (TestNcHIPertTwoFluids *test, gconstpointer pdata);
+void test_nc_hipert_two_fluids_spectrum_threaded (TestNcHIPertTwoFluids *test, gconstpointer pdata);
+void test_nc_hipert_two_fluids_free (TestNcHIPertTwoFluids *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/hipert/two_fluids/lin_solver/band", TestNcHIPertTwoFluids, GINT_TO_POINTER (NC_HIPERT_LIN_SOLVER_BAND),
+              &test_nc_hipert_two_fluids_new,
+              &test_nc_hipert_two_fluids_lin_solver,
+              &test_nc_hipert_two_fluids_free);
+
+  g_test_add ("/nc/hipert/two_fluids/lin_solver/spgmr", TestNcHIPertTwoFluids, GINT_TO_POINTER (NC_HIPERT_LIN_SOLVER_SPGMR),
+              &test_nc_hipert_two_fluids_new,
+              &test_nc_hipert_two_fluids_lin_solver,
+              &test_nc_hipert_two_fluids_free);
+
+  g_test_add ("/nc/hipert/two_fluids/spectrum/threaded", TestNcHIPertTwoFluids, NULL,
+              &test_nc_hipert_two_fluids_new,
+              &test_nc_hipert_two_fluids_spectrum_threaded,
+              &test_nc_hipert_two_fluids_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_hipert_two_fluids_new (TestNcHIPertTwoFluids *test, gconstpointer pdata)
+{
+  const gdouble k   = 1.0;
+  gdouble alpha_try;
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoQGRW");
+  test->ptf   = nc_hipert_two_fluids_new ();
+  test->ci    = ncm_vector_new (NC_HIPERT_ITWO_FLUIDS_VARS_LEN);
+
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_QGRW_W,       1.0e-1);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_QGRW_OMEGA_R, 2.0 * 1.0e-5);
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_QGRW_OMEGA_W, 2.0 * (1.0 - 1.0e-5));
+  ncm_model_orig_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_QGRW_X_B,     1.0e30);
+
+  nc_hipert_set_reltol (NC_HIPERT (test->ptf), 1.0e-9);
+  nc_hipert_set_mode_k (NC_HIPERT (test->ptf), k);
+  nc_hipert_set_stiff_solver (NC_HIPERT (test->ptf), TRUE);
+
+  alpha_try     = -nc_hicosmo_abs_alpha (test->cosmo, 1.0e-12 * k * k);
+  test->alpha_i = nc_hipert_two_fluids_get_cross_time (test->ptf, test->cosmo, NC_HIPERT_TWO_FLUIDS_CROSS_MODE1SUB, alpha_try, 1.0e-5);
+  test->alpha_f = test->alpha_i + 2.0;
+
+  g_assert (gsl_finite (test->alpha_i));
+
+  nc_hipert_two_fluids_get_init_cond_zetaS (test->ptf, test->cosmo, test->alpha_i, 1, 0.25 * M_PI, test->ci);
+}
+
+void
+test_nc_hipert_two_fluids_free (TestNcHIPertTwoFluids *test, gconstpointer pdata)
+{
+  ncm_vector_free (test->ci);
+  nc_hicosmo_free (test->cosmo);
+
+  NCM_TEST_FREE (nc_hipert_two_fluids_free, test->ptf);
+}
+
+static void
+_test_nc_hipert_two_fluids_evolve (TestNcHIPertTwoFluids *test, NcmMatrix *res)
+{
+  guint i;
+
+  nc_hipert_two_fluids_set_init_cond (test->ptf, test->cosmo, test->alpha_i, 1, FALSE, test->ci);
+
+  for (i = 0; i < TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS; i++)
+  {
+    const gdouble alpha = test->alpha_i + (test->alpha_f - test->alpha_i) * (i + 1.0) / TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS;
+    NcmVector *state;
+    gdouble alpha_s;
+
+    nc_hipert_two_fluids_evolve (test->ptf, test->cosmo, alpha);
+    state = nc_hipert_two_fluids_peek_state (test->ptf, test->cosmo, &alpha_s);
+
+    ncm_assert_cmpdouble_e (alpha_s, ==, alpha, 1.0e-12, 0.0);
+
+    ncm_matrix_set_row (res, i, state);
+  }
+}
+
+void
+test_nc_hipert_two_fluids_lin_solver (TestNcHIPertTwoFluids *test, gconstpointer pdata)
+{
+  const NcHIPertLinSolver lin_solver = GPOINTER_TO_INT (pdata);
+  NcmMatrix *res_dense = ncm_matrix_new (TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS, NC_HIPERT_ITWO_FLUIDS_VARS_LEN);
+  NcmMatrix *res       = ncm_matrix_new (TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS, NC_HIPERT_ITWO_FLUIDS_VARS_LEN);
+  gdouble scale        = 0.0;
+  guint i, j;
+
+  nc_hipert_set_lin_solver (NC_HIPERT (test->ptf), NC_HIPERT_LIN_SOLVER_DENSE);
+  _test_nc_hipert_two_fluids_evolve (test, res_dense);
+
+  /* A band narrower than the system, so that the dropped couplings are exercised. */
+  nc_hipert_set_band_width (NC_HIPERT (test->ptf), 2, 2);
+  nc_hipert_set_lin_solver (NC_HIPERT (test->ptf), lin_solver);
+  g_assert_cmpint (nc_hipert_get_lin_solver (NC_HIPERT (test->ptf)), ==, lin_solver);
+
+  _test_nc_hipert_two_fluids_evolve (test, res);
+
+  for (i = 0; i < TEST_NC_HIPERT_TWO_FLUIDS_NSTEPS; i++)
+  {
+    scale = 0.0;
+    for (j = 0; j < NC_HIPERT_ITWO_FLUIDS_VARS_LEN; j++)
+      scale = GSL_MAX (scale, fabs (ncm_matrix_get (res_dense, i, j)));
+
+    g_assert_cmpfloat (scale, >, 0.0);
+
+    for (j = 0; j < NC_HIPERT_ITWO_FLUIDS_VARS_LEN; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (res, i, j), ==, ncm_matrix_get (res_dense, i, j), 1.0e-5, 1.0e-5 * scale);
+  }
+
+  ncm_matrix_free (res_dense);
+  ncm_matrix_free (res);
+}
+
+void
+test_nc_hipert_two_fluids_spectrum_threaded (TestNcHIPertTwoFluids *test, gconstpointer pdata)
+{
+  NcHIPert *pert          = NC_HIPERT (test->ptf);
+  const gdouble prec      = 1.0e-5;
+  const gdouble ki        = 0.5;
+  const gdouble kf        = 2.0;
+  const guint nk          = 6;
+  const gdouble alpha_try = -nc_hicosmo_abs_alpha (test->cosmo, 1.0e-12 * kf * kf);
+  NcmVector *k_vec        = ncm_vector_new (nk);
+  NcmVector *Delta_zeta   = ncm_vector_new (nk);
+  NcmVector *Delta_S      = ncm_vector_new (nk);
+  NcmVector *Delta_zeta_t = ncm_vector_new (nk);
+  NcmVector *Delta_S_t    = ncm_vector_new (nk);
+  gdouble alpha_f         = -GSL_POSINF;
+  NcmSpline *s, *s_t;
+  guint j;
+
+  for (j = 0; j < nk; j++)
+  {
+    const gdouble k = ki * pow (kf / ki, j / (nk - 1.0));
+
+    ncm_vector_set (k_vec, j, k);
+
+    nc_hipert_set_mode_k (pert, k);
+    alpha_f = GSL_MAX (alpha_f, nc_hipert_two_fluids_get_cross_time (test->ptf, test->cosmo, NC_HIPERT_TWO_FLUIDS_CROSS_MODE1MAIN, alpha_try, prec));
+  }
+  alpha_f += 1.0;
+  g_assert (gsl_finite (alpha_f));
+
+  /* 
+   * A non-default linear solver and bandwidths, the copies used by each 
+   * thread must evolve the modes exactly as @ptf does.
+   */
+  nc_hipert_set_band_width (pert, 2, 2);
+  nc_hipert_set_lin_solver (pert, NC_HIPERT_LIN_SOLVER_BAND);
+
+  nc_hipert_set_nthreads (pert, 1);
+  nc_hipert_two_fluids_compute_zeta_spectrum (test->ptf, test->cosmo, 1, alpha_try, alpha_f, prec, k_vec, Delta_zeta, Delta_S);
+  s = nc_hipert_two_fluids_compute_zeta_spectrum_spline (test->ptf, test->cosmo, 1, alpha_try, alpha_f, prec, ki, kf, nk);
+
+  nc_hipert_set_nthreads (pert, 3);
+  nc_hipert_two_fluids_compute_zeta_spectrum (test->ptf, test->cosmo, 1, alpha_try, alpha_f, prec, k_vec, Delta_zeta_t, Delta_S_t);
+  s_t = nc_hipert_two_fluids_compute_zeta_spectrum_spline (test->ptf, test->cosmo, 1, alpha_try, alpha_f, prec, ki, kf, nk);
+
+  g_assert_cmpint (nc_hipert_get_lin_solver (pert), ==, NC_HIPERT_LIN_SOLVER_BAND);
+
+  for (j = 0; j < nk; j++)
+  {
+    g_assert_cmpfloat (ncm_vector_get (Delta_zeta, j), >, 0.0);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (Delta_zeta_t, j), ==, ncm_vector_get (Delta_zeta, j), 1.0e-10, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (Delta_S_t, j),    ==, ncm_vector_get (Delta_S, j),    1.0e-10, 0.0);
+  }
+
+  for (j = 0; j < 2 * nk; j++)
+  {
+    const gdouble lnk = log (ki) + log (kf / ki) * j / (2.0 * nk - 1.0);
+
+    ncm_assert_cmpdouble_e (ncm_spline_eval (s_t, lnk), ==, ncm_spline_eval (s, lnk), 0.0, 1.0e-10);
+  }
+
+  ncm_vector_free (k_vec);
+  ncm_vector_free (Delta_zeta);
+  ncm_vector_free (Delta_S);
+  ncm_vector_free (Delta_zeta_t);
+  ncm_vector_free (Delta_S_t);
+  ncm_spline_free (s);
+  ncm_spline_free (s_t);
+}
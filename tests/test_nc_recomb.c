@@ -31,6 +31,13 @@
 void test_nc_recomb_seager_new (void);
 void test_nc_recomb_seager_wmap_zstar (void);
 void test_nc_recomb_seager_Xe_ini (void);
+void test_nc_recomb_emul_validate (void);
+void test_nc_recomb_emul_default (void);
+void test_nc_recomb_emul_auto_train (void);
+void test_nc_recomb_emul_traps (void);
+void test_nc_recomb_emul_invalid_untrained (void);
+void test_nc_recomb_hireion_tau_cached (void);
+void test_nc_recomb_hireion_tau_cached_submodel (void);
 
 gint
 main (gint argc, gchar *argv[])
@@ -42,6 +49,13 @@ main (gint argc, gchar *argv[])
   g_test_add_func ("/nc/recomb/seager/new", &test_nc_recomb_seager_new);
   g_test_add_func ("/nc/recomb/seager/wmap/zstar", &test_nc_recomb_seager_wmap_zstar);
   g_test_add_func ("/nc/recomb/seager/wmap/Xe_ini", &test_nc_recomb_seager_Xe_ini);
+  g_test_add_func ("/nc/recomb/emul/validate", &test_nc_recomb_emul_validate);
+  g_test_add_func ("/nc/recomb/emul/default", &test_nc_recomb_emul_default);
+  g_test_add_func ("/nc/recomb/emul/auto_train", &test_nc_recomb_emul_auto_train);
+  g_test_add_func ("/nc/recomb/emul/traps", &test_nc_recomb_emul_traps);
+  g_test_add_func ("/nc/recomb/emul/invalid/untrained/subprocess", &test_nc_recomb_emul_invalid_untrained);
+  g_test_add_func ("/nc/recomb/hireion/tau/cached", &test_nc_recomb_hireion_tau_cached);
+  g_test_add_func ("/nc/recomb/hireion/tau/cached/submodel", &test_nc_recomb_hireion_tau_cached_submodel);
 
   g_test_run ();
 }
@@ -125,3 +139,261 @@ test_nc_recomb_seager_Xe_ini (void)
   nc_hicosmo_free (cosmo);
   nc_recomb_free (recomb);
 }
+
+void
+test_nc_recomb_emul_validate (void)
+{
+  NcRecombEmul *emul   = nc_recomb_emul_new_full (1.0e-11, NC_RECOMB_STARTING_X, 1.0e-10);
+  NcRecomb *recomb     = NC_RECOMB (emul);
+  NcRecomb *seager     = NC_RECOMB (nc_recomb_seager_new_full (1.0e-11, NC_RECOMB_STARTING_X, 1.0e-10));
+  NcHICosmo *cosmo     = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcmRNG *rng          = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  const gdouble u[NC_RECOMB_EMUL_PARAM_LEN] = {
+    nc_hicosmo_Omega_b0h2 (cosmo),
+    nc_hicosmo_Omega_c0h2 (cosmo),
+    nc_hicosmo_T_gamma0 (cosmo),
+    nc_hicosmo_Yp_4He (cosmo),
+    nc_hicosmo_Neff (cosmo)
+  };
+  gdouble lb, ub;
+  guint p;
+
+  /*
+   * A tight solver tolerance and a fine lambda grid, so that the
+   * interpolation across the Chebyshev nodes dominates the error.
+   */
+  nc_recomb_emul_set_nnodes (emul, 5);
+  nc_recomb_emul_set_nlambda (emul, 6000);
+
+  /* Only omega_b varies, the cosmology sits on the central node. */
+  for (p = 0; p < NC_RECOMB_EMUL_PARAM_LEN; p++)
+  {
+    if (p == NC_RECOMB_EMUL_OMEGA_B)
+      nc_recomb_emul_set_range (emul, p, 0.95 * u[p], 1.05 * u[p]);
+    else
+      nc_recomb_emul_set_range (emul, p, u[p], u[p]);
+  }
+
+  nc_recomb_emul_get_range (emul, NC_RECOMB_EMUL_OMEGA_B, &lb, &ub);
+  ncm_assert_cmpdouble (lb, <, ub);
+  g_assert (!nc_recomb_emul_is_trained (emul));
+
+  nc_recomb_emul_train (emul, NC_HICOSMO_DE (cosmo));
+  g_assert (nc_recomb_emul_is_trained (emul));
+  g_assert_cmpuint (ncm_matrix_nrows (nc_recomb_emul_peek_table (emul)), ==, 5);
+
+  {
+    const gdouble err = nc_recomb_emul_validate (emul, NC_HICOSMO_DE (cosmo), 4, rng);
+    ncm_assert_cmpdouble (err, <, 1.0e-6);
+  }
+
+  g_assert (nc_recomb_emul_in_range (emul, cosmo));
+
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_prepare_if_needed (seager, cosmo);
+  g_assert (!nc_recomb_emul_is_exact (emul));
+
+  ncm_assert_cmpdouble_e (nc_recomb_get_tau_z (recomb, cosmo), ==, nc_recomb_get_tau_z (seager, cosmo), 1.0e-4, 0.0);
+  ncm_assert_cmpdouble_e (nc_recomb_Xe (recomb, cosmo, -log (1.0 + 1100.0)), ==, nc_recomb_Xe (seager, cosmo, -log (1.0 + 1100.0)), 1.0e-4, 0.0);
+
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_B, 2.0 * ncm_model_orig_param_get (NCM_MODEL (cosmo), NC_HICOSMO_DE_OMEGA_B));
+  g_assert (!nc_recomb_emul_in_range (emul, cosmo));
+
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  nc_recomb_prepare_if_needed (seager, cosmo);
+  g_assert (nc_recomb_emul_is_exact (emul));
+
+  ncm_assert_cmpdouble_e (nc_recomb_get_tau_z (recomb, cosmo), ==, nc_recomb_get_tau_z (seager, cosmo), 1.0e-7, 0.0);
+
+  ncm_rng_free (rng);
+  nc_hicosmo_free (cosmo);
+  nc_recomb_free (seager);
+  NCM_TEST_FREE (nc_recomb_emul_free, emul);
+}
+
+void
+test_nc_recomb_emul_default (void)
+{
+  NcRecombEmul *emul = nc_recomb_emul_new ();
+  NcHICosmo *cosmo   = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcmRNG *rng        = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  guint ntotal       = 1;
+  gdouble err;
+  guint p;
+
+  for (p = 0; p < NC_RECOMB_EMUL_PARAM_LEN; p++)
+    ntotal *= NC_RECOMB_EMUL_DEFAULT_NNODES;
+
+  g_assert_cmpuint (nc_recomb_emul_get_nnodes (emul), ==, NC_RECOMB_EMUL_DEFAULT_NNODES);
+  g_assert_cmpuint (nc_recomb_emul_get_nlambda (emul), ==, NC_RECOMB_EMUL_DEFAULT_NLAMBDA);
+  g_assert (!nc_recomb_emul_get_auto_train (emul));
+
+  /* The default table spans all directions of the default box. */
+  nc_recomb_emul_train (emul, NC_HICOSMO_DE (cosmo));
+  g_assert_cmpuint (ncm_matrix_nrows (nc_recomb_emul_peek_table (emul)), ==, ntotal);
+
+  err = nc_recomb_emul_validate (emul, NC_HICOSMO_DE (cosmo), 4, rng);
+  ncm_assert_cmpdouble (err, <, 1.0e-4);
+
+  ncm_rng_free (rng);
+  nc_hicosmo_free (cosmo);
+  NCM_TEST_FREE (nc_recomb_emul_free, emul);
+}
+
+static void
+_test_nc_recomb_emul_set_omega_b_range (NcRecombEmul *emul, NcHICosmo *cosmo)
+{
+  const gdouble u[NC_RECOMB_EMUL_PARAM_LEN] = {
+    nc_hicosmo_Omega_b0h2 (cosmo),
+    nc_hicosmo_Omega_c0h2 (cosmo),
+    nc_hicosmo_T_gamma0 (cosmo),
+    nc_hicosmo_Yp_4He (cosmo),
+    nc_hicosmo_Neff (cosmo)
+  };
+  guint p;
+
+  for (p = 0; p < NC_RECOMB_EMUL_PARAM_LEN; p++)
+  {
+    if (p == NC_RECOMB_EMUL_OMEGA_B)
+      nc_recomb_emul_set_range (emul, p, 0.95 * u[p], 1.05 * u[p]);
+    else
+      nc_recomb_emul_set_range (emul, p, u[p], u[p]);
+  }
+}
+
+void
+test_nc_recomb_emul_auto_train (void)
+{
+  NcRecombEmul *emul = nc_recomb_emul_new ();
+  NcRecomb *recomb   = NC_RECOMB (emul);
+  NcHICosmo *cosmo   = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+
+  nc_recomb_emul_set_nnodes (emul, 3);
+  _test_nc_recomb_emul_set_omega_b_range (emul, cosmo);
+
+  g_object_set (emul, "auto-train", TRUE, NULL);
+  g_assert (nc_recomb_emul_get_auto_train (emul));
+  g_assert (!nc_recomb_emul_is_trained (emul));
+
+  nc_recomb_prepare_if_needed (recomb, cosmo);
+  g_assert (nc_recomb_emul_is_trained (emul));
+  g_assert (!nc_recomb_emul_is_exact (emul));
+  g_assert_cmpuint (ncm_matrix_nrows (nc_recomb_emul_peek_table (emul)), ==, 3);
+
+  nc_hicosmo_free (cosmo);
+  NCM_TEST_FREE (nc_recomb_emul_free, emul);
+}
+
+void
+test_nc_recomb_emul_traps (void)
+{
+#if GLIB_CHECK_VERSION(2,38,0)
+  g_test_trap_subprocess ("/nc/recomb/emul/invalid/untrained/subprocess", 0, 0);
+  g_test_trap_assert_failed ();
+#endif
+}
+
+void
+test_nc_recomb_emul_invalid_untrained (void)
+{
+  NcRecombEmul *emul = nc_recomb_emul_new ();
+  NcHICosmo *cosmo   = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+
+  nc_recomb_emul_set_nnodes (emul, 3);
+  _test_nc_recomb_emul_set_omega_b_range (emul, cosmo);
+
+  /* Without auto-train an untrained emulator cannot be prepared. */
+  nc_recomb_prepare_if_needed (NC_RECOMB (emul), cosmo);
+}
+
+void
+test_nc_recomb_hireion_tau_cached (void)
+{
+  NcHIReion *reion  = NC_HIREION (nc_hireion_camb_new ());
+  NcHICosmo *cosmo  = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  const guint nz    = 5;
+  const guint len   = ncm_model_len (NCM_MODEL (reion));
+  NcmMatrix *params = ncm_matrix_new (nz, len);
+  NcmVector *tau    = ncm_vector_new (nz);
+  guint i, j;
+
+  for (i = 0; i < nz; i++)
+  {
+    for (j = 0; j < len; j++)
+      ncm_matrix_set (params, i, j, ncm_model_orig_param_get (NCM_MODEL (reion), j));
+    ncm_matrix_set (params, i, NC_HIREION_CAMB_HII_HEII_Z, 6.0 + 4.0 * i);
+  }
+
+  nc_hireion_get_tau_batch (reion, cosmo, params, tau);
+  ncm_assert_cmpdouble (ncm_model_orig_param_get (NCM_MODEL (reion), NC_HIREION_CAMB_HII_HEII_Z), ==, NC_HIREION_CAMB_DEFAULT_HII_HEII_Z);
+
+  for (i = 0; i < nz; i++)
+  {
+    gdouble tau_qag;
+
+    ncm_model_orig_param_set (NCM_MODEL (reion), NC_HIREION_CAMB_HII_HEII_Z, 6.0 + 4.0 * i);
+    nc_hireion_set_tau_cache (reion, FALSE);
+    tau_qag = nc_hireion_get_tau (reion, cosmo);
+
+    nc_hireion_set_tau_cache (reion, TRUE);
+    ncm_assert_cmpdouble_e (nc_hireion_get_tau (reion, cosmo), ==, tau_qag, 1.0e-5, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (tau, i), ==, tau_qag, 1.0e-5, 0.0);
+  }
+
+  ncm_vector_free (tau);
+  ncm_matrix_free (params);
+  nc_hireion_free (reion);
+  nc_hicosmo_free (cosmo);
+}
+
+void
+test_nc_recomb_hireion_tau_cached_submodel (void)
+{
+  NcHIReion *reion = NC_HIREION (nc_hireion_camb_new ());
+  NcHICosmo *cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO_DE, "NcHICosmoDEXcdm{'w' : <-1.0>}");
+  gdouble tau_10 = 0.0;
+  guint nbuilds;
+  gint i;
+
+  /* The usual setup, the reionization is a submodel of the cosmology. */
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (reion));
+  nc_hireion_set_tau_cache (reion, TRUE);
+
+  /* A large z_re first, so that the table covers all values used below. */
+  ncm_model_orig_param_set (NCM_MODEL (reion), NC_HIREION_CAMB_HII_HEII_Z, 25.0);
+  nc_hireion_get_tau (reion, cosmo);
+  nbuilds = reion->tau_nbuilds;
+
+  /* z_re falls at different places inside the panels. */
+  for (i = 0; i < 20; i++)
+  {
+    const gdouble z_re = 6.0 + 0.73 * i;
+    gdouble tau_qag, tau_cached;
+
+    ncm_model_orig_param_set (NCM_MODEL (reion), NC_HIREION_CAMB_HII_HEII_Z, z_re);
+
+    tau_cached = nc_hireion_get_tau (reion, cosmo);
+    g_assert_cmpuint (reion->tau_nbuilds, ==, nbuilds);
+
+    nc_hireion_set_tau_cache (reion, FALSE);
+    tau_qag = nc_hireion_get_tau (reion, cosmo);
+    nc_hireion_set_tau_cache (reion, TRUE);
+
+    ncm_assert_cmpdouble_e (tau_cached, ==, tau_qag, 1.0e-5, 0.0);
+  }
+
+  ncm_model_orig_param_set (NCM_MODEL (reion), NC_HIREION_CAMB_HII_HEII_Z, 10.0);
+  tau_10 = nc_hireion_get_tau (reion, cosmo);
+
+  /* The root search only changes z_re and reuses the table. */
+  ncm_assert_cmpdouble_e (nc_hireion_camb_calc_z_from_tau (NC_HIREION_CAMB (reion), cosmo, tau_10), ==, 10.0, 1.0e-1, 0.0);
+  g_assert_cmpuint (reion->tau_nbuilds, ==, nbuilds);
+
+  /* Changing the cosmology rebuilds it. */
+  ncm_model_orig_param_set (NCM_MODEL (cosmo), NC_HICOSMO_DE_H0, 71.0);
+  nc_hireion_get_tau (reion, cosmo);
+  g_assert_cmpuint (reion->tau_nbuilds, ==, nbuilds + 1);
+
+  nc_hireion_free (reion);
+  nc_hicosmo_free (cosmo);
+}
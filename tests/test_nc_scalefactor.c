@@ -0,0 +1,325 @@
+/***************************************************************************
+ *            test_nc_scalefactor.c
+ *
+ *  Sun October 18 22:41:09 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#define TEST_NC_SCALEFACTOR_ZF (1.0e4)
+#define TEST_NC_SCALEFACTOR_NP (5000)
+
+typedef struct _TestNcScalefactor
+{
+  NcHICosmo *cosmo;
+  NcScalefactor *a;
+  NcmVector *z;
+  NcmVector *eta;
+  NcmVector *t;
+} TestNcScalefactor;
+
+void test_nc_scalefactor_new (TestNcScalefactor *test, gconstpointer pdata);
+void test_nc_scalefactor_array_round_trip (TestNcScalefactor *test, gconstpointer pdata);
+void test_nc_scalefactor_array_monotone (TestNcScalefactor *test, gconstpointer pdata);
+void test_nc_scalefactor_array_error_bound (TestNcScalefactor *test, gconstpointer pdata);
+void test_nc_scalefactor_array_out_of_range (TestNcScalefactor *test, gconstpointer pdata);
+void test_nc_scalefactor_free (TestNcScalefactor *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/scalefactor/array/round_trip", TestNcScalefactor, NULL,
+              &test_nc_scalefactor_new,
+              &test_nc_scalefactor_array_round_trip,
+              &test_nc_scalefactor_free);
+
+  g_test_add ("/nc/scalefactor/array/monotone", TestNcScalefactor, NULL,
+              &test_nc_scalefactor_new,
+              &test_nc_scalefactor_array_monotone,
+              &test_nc_scalefactor_free);
+
+  g_test_add ("/nc/scalefactor/array/error_bound", TestNcScalefactor, NULL,
+              &test_nc_scalefactor_new,
+              &test_nc_scalefactor_array_error_bound,
+              &test_nc_scalefactor_free);
+
+  g_test_add ("/nc/scalefactor/array/out_of_range", TestNcScalefactor, NULL,
+              &test_nc_scalefactor_new,
+              &test_nc_scalefactor_array_out_of_range,
+              &test_nc_scalefactor_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_scalefactor_new (TestNcScalefactor *test, gconstpointer pdata)
+{
+  const gdouble lnx_f = log1p (TEST_NC_SCALEFACTOR_ZF);
+  guint i;
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO_DE, "NcHICosmoDEXcdm{'w' : <-1.0>}");
+  test->a     = nc_scalefactor_new (TEST_NC_SCALEFACTOR_ZF, NULL);
+  test->z     = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  test->eta   = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  test->t     = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+
+  nc_scalefactor_prepare (test->a, test->cosmo);
+
+  /*
+   * Redshifts decreasing from zf to 0, logarithmically spaced in 1 + z and
+   * jittered so that the points fall anywhere inside the intervals, the
+   * conformal and cosmic times are then increasing. The end points are
+   * kept away from the borders of the integrated interval.
+   */
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble u   = (TEST_NC_SCALEFACTOR_NP - i - 0.5 + g_test_rand_double_range (-0.4, 0.4)) / TEST_NC_SCALEFACTOR_NP;
+    const gdouble z   = expm1 (lnx_f * u);
+    const gdouble eta = nc_scalefactor_eval_eta_z (test->a, z);
+
+    ncm_vector_set (test->z, i, z);
+    ncm_vector_set (test->eta, i, eta);
+    ncm_vector_set (test->t, i, nc_scalefactor_eval_t_eta (test->a, eta));
+  }
+}
+
+void
+test_nc_scalefactor_free (TestNcScalefactor *test, gconstpointer pdata)
+{
+  ncm_vector_free (test->z);
+  ncm_vector_free (test->eta);
+  ncm_vector_free (test->t);
+
+  NCM_TEST_FREE (nc_scalefactor_free, test->a);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+}
+
+void
+test_nc_scalefactor_array_round_trip (TestNcScalefactor *test, gconstpointer pdata)
+{
+  NcmVector *eta = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  NcmVector *z   = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  NcmVector *t   = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  gdouble err_eta, err_z, err_eta_t, err_t;
+  guint i;
+
+  /* z -> eta -> z */
+  err_eta = nc_scalefactor_eval_eta_z_array (test->a, test->z, eta);
+  err_z   = nc_scalefactor_eval_z_eta_array (test->a, eta, z);
+
+  /* eta -> t -> eta */
+  err_t     = nc_scalefactor_eval_t_eta_array (test->a, test->eta, t);
+  err_eta_t = nc_scalefactor_eval_eta_t_array (test->a, t, eta);
+
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble z_i   = ncm_vector_get (test->z, i);
+    const gdouble eta_i = ncm_vector_get (test->eta, i);
+    const gdouble E_i   = nc_hicosmo_E (test->cosmo, z_i);
+
+    /* The round trip error is the error of the way back plus the one of the way in, propagated. */
+    ncm_assert_cmpdouble_e (ncm_vector_get (z, i), ==, z_i, 1.0e-7, 2.0 * (err_z + E_i * err_eta));
+    ncm_assert_cmpdouble_e (ncm_vector_get (eta, i), ==, eta_i, 1.0e-7, 2.0 * (err_eta_t + (1.0 + z_i) * err_t));
+  }
+
+  /* The input and output vectors can be the same. */
+  ncm_vector_memcpy (z, test->z);
+  nc_scalefactor_eval_eta_z_array (test->a, z, z);
+  nc_scalefactor_eval_eta_z_array (test->a, test->z, eta);
+
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+    g_assert_cmpfloat (ncm_vector_get (z, i), ==, ncm_vector_get (eta, i));
+
+  ncm_vector_free (eta);
+  ncm_vector_free (z);
+  ncm_vector_free (t);
+}
+
+static void
+_test_nc_scalefactor_assert_monotone (NcmVector *v, const gint sign)
+{
+  const guint len = ncm_vector_len (v);
+  guint i;
+
+  for (i = 1; i < len; i++)
+  {
+    if (sign > 0)
+      g_assert_cmpfloat (ncm_vector_get (v, i), >=, ncm_vector_get (v, i - 1));
+    else
+      g_assert_cmpfloat (ncm_vector_get (v, i), <=, ncm_vector_get (v, i - 1));
+  }
+}
+
+void
+test_nc_scalefactor_array_monotone (TestNcScalefactor *test, gconstpointer pdata)
+{
+  NcmVector *out = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+
+  /* The redshifts are decreasing while the times are increasing. */
+  nc_scalefactor_eval_eta_z_array (test->a, test->z, out);
+  _test_nc_scalefactor_assert_monotone (out, +1);
+
+  nc_scalefactor_eval_z_eta_array (test->a, test->eta, out);
+  _test_nc_scalefactor_assert_monotone (out, -1);
+
+  nc_scalefactor_eval_t_eta_array (test->a, test->eta, out);
+  _test_nc_scalefactor_assert_monotone (out, +1);
+
+  nc_scalefactor_eval_eta_t_array (test->a, test->t, out);
+  _test_nc_scalefactor_assert_monotone (out, +1);
+
+  ncm_vector_free (out);
+}
+
+void
+test_nc_scalefactor_array_error_bound (TestNcScalefactor *test, gconstpointer pdata)
+{
+  NcmVector *out = ncm_vector_new (TEST_NC_SCALEFACTOR_NP);
+  gdouble err;
+  guint i;
+
+  /*
+   * The bound is the largest difference to the cubic spline at the middle
+   * of the intervals, where both interpolation errors peak. A factor of two
+   * accounts for the shape of the error differing between the two inside
+   * each interval.
+   */
+  err = nc_scalefactor_eval_eta_z_array (test->a, test->z, out);
+  g_assert_cmpfloat (err, >=, 0.0);
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble eta = nc_scalefactor_eval_eta_z (test->a, ncm_vector_get (test->z, i));
+    ncm_assert_cmpdouble_e (ncm_vector_get (out, i), ==, eta, 1.0e-14, 2.0 * err);
+  }
+
+  err = nc_scalefactor_eval_z_eta_array (test->a, test->eta, out);
+  g_assert_cmpfloat (err, >=, 0.0);
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble z = nc_scalefactor_eval_z_eta (test->a, ncm_vector_get (test->eta, i));
+    ncm_assert_cmpdouble_e (ncm_vector_get (out, i), ==, z, 1.0e-14, 2.0 * err);
+  }
+
+  err = nc_scalefactor_eval_t_eta_array (test->a, test->eta, out);
+  g_assert_cmpfloat (err, >=, 0.0);
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble t = nc_scalefactor_eval_t_eta (test->a, ncm_vector_get (test->eta, i));
+    ncm_assert_cmpdouble_e (ncm_vector_get (out, i), ==, t, 1.0e-14, 2.0 * err);
+  }
+
+  err = nc_scalefactor_eval_eta_t_array (test->a, test->t, out);
+  g_assert_cmpfloat (err, >=, 0.0);
+  for (i = 0; i < TEST_NC_SCALEFACTOR_NP; i++)
+  {
+    const gdouble eta = nc_scalefactor_eval_eta_t (test->a, ncm_vector_get (test->t, i));
+    ncm_assert_cmpdouble_e (ncm_vector_get (out, i), ==, eta, 1.0e-14, 2.0 * err);
+  }
+
+  ncm_vector_free (out);
+}
+
+void
+test_nc_scalefactor_array_out_of_range (TestNcScalefactor *test, gconstpointer pdata)
+{
+  NcmVector *z_border   = ncm_vector_new (2);
+  NcmVector *eta_border = ncm_vector_new (2);
+  NcmVector *t_border   = ncm_vector_new (2);
+  NcmVector *in         = ncm_vector_new (3);
+  NcmVector *out        = ncm_vector_new (3);
+  gdouble eta_i, eta_f, t_i, t_f;
+
+  /* At the borders the interpolants return the integrated values. */
+  ncm_vector_set (z_border, 0, TEST_NC_SCALEFACTOR_ZF);
+  ncm_vector_set (z_border, 1, 0.0);
+
+  nc_scalefactor_eval_eta_z_array (test->a, z_border, eta_border);
+  nc_scalefactor_eval_t_eta_array (test->a, eta_border, t_border);
+
+  eta_i = ncm_vector_get (eta_border, 0);
+  eta_f = ncm_vector_get (eta_border, 1);
+  t_i   = ncm_vector_get (t_border, 0);
+  t_f   = ncm_vector_get (t_border, 1);
+
+  g_assert_cmpfloat (eta_i, <, eta_f);
+  g_assert_cmpfloat (t_i, <, t_f);
+
+  /* Values outside are evaluated at the borders instead of extrapolated. */
+  ncm_vector_set (in, 0, 10.0 * TEST_NC_SCALEFACTOR_ZF);
+  ncm_vector_set (in, 1, 1.0);
+  ncm_vector_set (in, 2, -0.5);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*nc_scalefactor_eval_eta_z_array: 2 of 3 values outside*");
+  nc_scalefactor_eval_eta_z_array (test->a, in, out);
+  g_test_assert_expected_messages ();
+
+  g_assert_cmpfloat (ncm_vector_get (out, 0), ==, eta_i);
+  g_assert_cmpfloat (ncm_vector_get (out, 1), >, eta_i);
+  g_assert_cmpfloat (ncm_vector_get (out, 1), <, eta_f);
+  g_assert_cmpfloat (ncm_vector_get (out, 2), ==, eta_f);
+
+  ncm_vector_set (in, 0, eta_i - (eta_f - eta_i));
+  ncm_vector_set (in, 1, 0.5 * (eta_i + eta_f));
+  ncm_vector_set (in, 2, eta_f + (eta_f - eta_i));
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*nc_scalefactor_eval_z_eta_array: 2 of 3 values outside*");
+  nc_scalefactor_eval_z_eta_array (test->a, in, out);
+  g_test_assert_expected_messages ();
+
+  g_assert_cmpfloat (ncm_vector_get (out, 0), ==, TEST_NC_SCALEFACTOR_ZF);
+  g_assert_cmpfloat (ncm_vector_get (out, 2), ==, 0.0);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*nc_scalefactor_eval_t_eta_array: 2 of 3 values outside*");
+  nc_scalefactor_eval_t_eta_array (test->a, in, out);
+  g_test_assert_expected_messages ();
+
+  g_assert_cmpfloat (ncm_vector_get (out, 0), ==, t_i);
+  g_assert_cmpfloat (ncm_vector_get (out, 2), ==, t_f);
+
+  ncm_vector_set (in, 0, 0.5 * t_i);
+  ncm_vector_set (in, 1, 0.5 * (t_i + t_f));
+  ncm_vector_set (in, 2, 2.0 * t_f);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*nc_scalefactor_eval_eta_t_array: 2 of 3 values outside*");
+  nc_scalefactor_eval_eta_t_array (test->a, in, out);
+  g_test_assert_expected_messages ();
+
+  g_assert_cmpfloat (ncm_vector_get (out, 0), ==, eta_i);
+  g_assert_cmpfloat (ncm_vector_get (out, 2), ==, eta_f);
+
+  ncm_vector_free (z_border);
+  ncm_vector_free (eta_border);
+  ncm_vector_free (t_border);
+  ncm_vector_free (in);
+  ncm_vector_free (out);
+}
@@ -32,6 +32,59 @@
 #include <glib.h>
 #include <glib-object.h>
 
+/*
+ * A NFW profile whose projected density is tapered by $1 / [1 + (R / r_t)^2]$,
+ * $r_t$ being an extra shape parameter which is not a model parameter.
+ */
+
+typedef struct _TestNcDensityProfileTaperClass
+{
+  NcDensityProfileNFWClass parent_class;
+} TestNcDensityProfileTaperClass;
+
+typedef struct _TestNcDensityProfileTaper
+{
+  NcDensityProfileNFW parent_instance;
+  gdouble rt;
+} TestNcDensityProfileTaper;
+
+GType test_nc_density_profile_taper_get_type (void);
+
+G_DEFINE_TYPE (TestNcDensityProfileTaper, test_nc_density_profile_taper, NC_TYPE_DENSITY_PROFILE_NFW);
+
+static void
+test_nc_density_profile_taper_init (TestNcDensityProfileTaper *dpt)
+{
+  dpt->rt = 1.0;
+}
+
+static gdouble
+_test_nc_density_profile_taper_integral_density_los (NcDensityProfile *dp, NcHICosmo *cosmo, const gdouble R, const gdouble z)
+{
+  TestNcDensityProfileTaper *dpt = (TestNcDensityProfileTaper *) dp;
+  const gdouble u                = R / dpt->rt;
+
+  return NC_DENSITY_PROFILE_CLASS (test_nc_density_profile_taper_parent_class)->integral_density_los (dp, cosmo, R, z) / (1.0 + u * u);
+}
+
+static gdouble
+_test_nc_density_profile_taper_integral_density_2d (NcDensityProfile *dp, NcHICosmo *cosmo, const gdouble R, const gdouble z)
+{
+  TestNcDensityProfileTaper *dpt = (TestNcDensityProfileTaper *) dp;
+  const gdouble u                = R / dpt->rt;
+
+  return NC_DENSITY_PROFILE_CLASS (test_nc_density_profile_taper_parent_class)->integral_density_2d (dp, cosmo, R, z) / (1.0 + u * u);
+}
+
+static void
+test_nc_density_profile_taper_class_init (TestNcDensityProfileTaperClass *klass)
+{
+  NcDensityProfileClass *dp_class = NC_DENSITY_PROFILE_CLASS (klass);
+
+  dp_class->integral_density_los = &_test_nc_density_profile_taper_integral_density_los;
+  dp_class->integral_density_2d  = &_test_nc_density_profile_taper_integral_density_2d;
+}
+
 typedef struct _TestNcWLSurfaceMassDensity
 {
   NcWLSurfaceMassDensity *smd;
@@ -49,6 +102,8 @@ void test_nc_wl_surface_mass_density_convergence (TestNcWLSurfaceMassDensity *te
 void test_nc_wl_surface_mass_density_shear (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
 void test_nc_wl_surface_mass_density_reduced_shear (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
 void test_nc_wl_surface_mass_density_reduced_shear_infinity (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
+void test_nc_wl_surface_mass_density_array_nfw (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
+void test_nc_wl_surface_mass_density_array_taper (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
 void test_nc_wl_surface_mass_density_free (TestNcWLSurfaceMassDensity *test, gconstpointer pdata);
 
 gint
@@ -87,6 +142,15 @@ main (gint argc, gchar *argv[])
               &test_nc_wl_surface_mass_density_reduced_shear_infinity,
               &test_nc_wl_surface_mass_density_free);                                                         
 
+  g_test_add ("/nc/wl_surface_mass_density/array/nfw", TestNcWLSurfaceMassDensity, NULL,
+              &test_nc_wl_surface_mass_density_new,
+              &test_nc_wl_surface_mass_density_array_nfw,
+              &test_nc_wl_surface_mass_density_free);
+  g_test_add ("/nc/wl_surface_mass_density/array/taper", TestNcWLSurfaceMassDensity, NULL,
+              &test_nc_wl_surface_mass_density_new,
+              &test_nc_wl_surface_mass_density_array_taper,
+              &test_nc_wl_surface_mass_density_free);
+
   g_test_run ();
 }
 
@@ -256,3 +320,92 @@ test_nc_wl_surface_mass_density_reduced_shear_infinity (TestNcWLSurfaceMassDensi
   ncm_assert_cmpdouble_e (k2, ==, 0.12174598,   1.0e-5, 0.0);
   ncm_assert_cmpdouble_e (k3, ==, 0.0021164506, 1.0e-5, 0.0);
 }
+
+static void
+_test_nc_wl_surface_mass_density_array_cmp (TestNcWLSurfaceMassDensity *test, NcDensityProfile *dp)
+{
+  NcHICosmo *cosmo            = test->cosmo;
+  NcWLSurfaceMassDensity *smd = test->smd;
+  const gdouble zc_a[]        = {0.2, 0.2, 1.0, 1.0, 1.0, 0.2, 0.6, 1.0};
+  const gdouble zs_a[]        = {1.5, 0.9, 1.5, 2.0, 2.0, 1.5, 3.0, 1.5};
+  const guint nR              = 5;
+  const guint len             = nR * G_N_ELEMENTS (zc_a);
+  NcmVector *R                = ncm_vector_new (len);
+  NcmVector *zs               = ncm_vector_new (len);
+  NcmVector *zl               = ncm_vector_new (len);
+  NcmVector *zc               = ncm_vector_new (len);
+  NcmVector *sigma            = ncm_vector_new (len);
+  NcmVector *sigma_mean       = ncm_vector_new (len);
+  NcmVector *gt               = ncm_vector_new (len);
+  NcmVector *gt_inf           = ncm_vector_new (len);
+  guint i;
+
+  /* 
+   * Consecutive points share the redshifts in blocks, the array functions
+   * reuse the redshift dependent quantities within a block and must 
+   * recompute them when the redshift changes or comes back.
+   */
+  for (i = 0; i < len; i++)
+  {
+    const guint iz = i / nR;
+    const guint iR = i % nR;
+
+    ncm_vector_set (R,  i, 0.05 * exp (log (20.0 / 0.05) * iR / (nR - 1.0)));
+    ncm_vector_set (zs, i, zs_a[iz]);
+    ncm_vector_set (zl, i, zc_a[iz]);
+    ncm_vector_set (zc, i, zc_a[iz]);
+  }
+
+  nc_wl_surface_mass_density_sigma_array (smd, dp, cosmo, R, zc, sigma);
+  nc_wl_surface_mass_density_sigma_mean_array (smd, dp, cosmo, R, zc, sigma_mean);
+  nc_wl_surface_mass_density_reduced_shear_array (smd, dp, cosmo, R, zs, zl, zc, gt);
+  nc_wl_surface_mass_density_reduced_shear_infinity_array (smd, dp, cosmo, R, zs, zl, zc, gt_inf);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble R_i  = ncm_vector_get (R, i);
+    const gdouble zs_i = ncm_vector_get (zs, i);
+    const gdouble zl_i = ncm_vector_get (zl, i);
+    const gdouble zc_i = ncm_vector_get (zc, i);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (sigma, i),      ==, nc_wl_surface_mass_density_sigma (smd, dp, cosmo, R_i, zc_i),      1.0e-14, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (sigma_mean, i), ==, nc_wl_surface_mass_density_sigma_mean (smd, dp, cosmo, R_i, zc_i), 1.0e-14, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (gt, i),         ==, nc_wl_surface_mass_density_reduced_shear (smd, dp, cosmo, R_i, zs_i, zl_i, zc_i),          1.0e-14, 0.0);
+    ncm_assert_cmpdouble_e (ncm_vector_get (gt_inf, i),     ==, nc_wl_surface_mass_density_reduced_shear_infinity (smd, dp, cosmo, R_i, zs_i, zl_i, zc_i), 1.0e-14, 0.0);
+  }
+
+  ncm_vector_free (R);
+  ncm_vector_free (zs);
+  ncm_vector_free (zl);
+  ncm_vector_free (zc);
+  ncm_vector_free (sigma);
+  ncm_vector_free (sigma_mean);
+  ncm_vector_free (gt);
+  ncm_vector_free (gt_inf);
+}
+
+void
+test_nc_wl_surface_mass_density_array_nfw (TestNcWLSurfaceMassDensity *test, gconstpointer pdata)
+{
+  _test_nc_wl_surface_mass_density_array_cmp (test, test->dp);
+}
+
+void
+test_nc_wl_surface_mass_density_array_taper (TestNcWLSurfaceMassDensity *test, gconstpointer pdata)
+{
+  TestNcDensityProfileTaper *dpt = g_object_new (test_nc_density_profile_taper_get_type (), "Delta", 200.0, NULL);
+  NcDensityProfile *dp           = NC_DENSITY_PROFILE (dpt);
+  const gdouble rt_a[]           = {0.1, 1.0, 10.0};
+  guint it;
+
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_M_DELTA, 1.0e15);
+  ncm_model_orig_param_set (NCM_MODEL (dp), NC_DENSITY_PROFILE_C,       4.0);
+
+  for (it = 0; it < G_N_ELEMENTS (rt_a); it++)
+  {
+    dpt->rt = rt_a[it];
+    _test_nc_wl_surface_mass_density_array_cmp (test, dp);
+  }
+
+  nc_density_profile_free (dp);
+}
@@ -0,0 +1,319 @@
+/***************************************************************************
+ *            test_ncm_abc.c
+ *
+ *  Sun October 18 20:21:14 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+/*
+ * A toy ABC: the data is a single draw of a Gaussian with known covariance
+ * and unknown mean, the distance is the Euclidean distance between the
+ * observed and the mock draws and the particles are accepted inside epsilon.
+ */
+
+typedef struct _TestNcmABCGaussClass
+{
+  NcmABCClass parent_class;
+} TestNcmABCGaussClass;
+
+typedef struct _TestNcmABCGauss
+{
+  NcmABC parent_instance;
+  NcmVector *y_obs;
+} TestNcmABCGauss;
+
+GType test_ncm_abc_gauss_get_type (void);
+
+G_DEFINE_TYPE (TestNcmABCGauss, test_ncm_abc_gauss, NCM_TYPE_ABC);
+
+static void
+test_ncm_abc_gauss_init (TestNcmABCGauss *abcg)
+{
+  abcg->y_obs = NULL;
+}
+
+static void
+_test_ncm_abc_gauss_finalize (GObject *object)
+{
+  TestNcmABCGauss *abcg = (TestNcmABCGauss *) object;
+
+  ncm_vector_clear (&abcg->y_obs);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (test_ncm_abc_gauss_parent_class)->finalize (object);
+}
+
+static NcmVector *
+_test_ncm_abc_gauss_peek_y (NcmDataset *dset)
+{
+  return NCM_DATA_GAUSS_COV (ncm_dataset_peek_data (dset, 0))->y;
+}
+
+static gboolean
+_test_ncm_abc_gauss_data_summary (NcmABC *abc)
+{
+  TestNcmABCGauss *abcg = (TestNcmABCGauss *) abc;
+
+  ncm_vector_clear (&abcg->y_obs);
+  abcg->y_obs = ncm_vector_dup (_test_ncm_abc_gauss_peek_y (abc->dset));
+
+  return TRUE;
+}
+
+static gdouble
+_test_ncm_abc_gauss_mock_distance (NcmABC *abc, NcmDataset *dset, NcmVector *theta, NcmVector *thetastar, NcmRNG *rng)
+{
+  TestNcmABCGauss *abcg = (TestNcmABCGauss *) abc;
+  NcmVector *y          = _test_ncm_abc_gauss_peek_y (dset);
+  gdouble d2            = 0.0;
+  guint i;
+
+  for (i = 0; i < ncm_vector_len (y); i++)
+    d2 += gsl_pow_2 (ncm_vector_get (y, i) - ncm_vector_get (abcg->y_obs, i));
+
+  return sqrt (d2);
+}
+
+static gdouble
+_test_ncm_abc_gauss_distance_prob (NcmABC *abc, gdouble distance)
+{
+  return (distance < abc->epsilon) ? 1.0 : 0.0;
+}
+
+static void
+_test_ncm_abc_gauss_update_tkern (NcmABC *abc)
+{
+}
+
+static const gchar *
+_test_ncm_abc_gauss_get_desc (NcmABC *abc)
+{
+  return "Gaussian mean toy ABC";
+}
+
+static const gchar *
+_test_ncm_abc_gauss_log_info (NcmABC *abc)
+{
+  return "";
+}
+
+static void
+test_ncm_abc_gauss_class_init (TestNcmABCGaussClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  NcmABCClass *abc_class     = NCM_ABC_CLASS (klass);
+
+  object_class->finalize = &_test_ncm_abc_gauss_finalize;
+
+  abc_class->data_summary  = &_test_ncm_abc_gauss_data_summary;
+  abc_class->mock_distance = &_test_ncm_abc_gauss_mock_distance;
+  abc_class->distance_prob = &_test_ncm_abc_gauss_distance_prob;
+  abc_class->update_tkern  = &_test_ncm_abc_gauss_update_tkern;
+  abc_class->get_desc      = &_test_ncm_abc_gauss_get_desc;
+  abc_class->log_info      = &_test_ncm_abc_gauss_log_info;
+}
+
+typedef struct _TestNcmABC
+{
+  NcmABC *abc;
+  NcmDataGaussCovMVND *data_mvnd;
+  guint dim;
+  guint nparticles;
+} TestNcmABC;
+
+void test_ncm_abc_new (TestNcmABC *test, gconstpointer pdata);
+void test_ncm_abc_adaptive_posterior (TestNcmABC *test, gconstpointer pdata);
+void test_ncm_abc_adaptive_traps (TestNcmABC *test, gconstpointer pdata);
+void test_ncm_abc_adaptive_invalid_ess_frac (TestNcmABC *test, gconstpointer pdata);
+void test_ncm_abc_free (TestNcmABC *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/abc/adaptive/posterior", TestNcmABC, GINT_TO_POINTER (1),
+              &test_ncm_abc_new,
+              &test_ncm_abc_adaptive_posterior,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/adaptive/posterior/threads", TestNcmABC, GINT_TO_POINTER (3),
+              &test_ncm_abc_new,
+              &test_ncm_abc_adaptive_posterior,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/adaptive/traps", TestNcmABC, GINT_TO_POINTER (1),
+              &test_ncm_abc_new,
+              &test_ncm_abc_adaptive_traps,
+              &test_ncm_abc_free);
+
+#if GLIB_CHECK_VERSION (2, 38, 0)
+  g_test_add ("/ncm/abc/adaptive/invalid/ess_frac/subprocess", TestNcmABC, GINT_TO_POINTER (1),
+              &test_ncm_abc_new,
+              &test_ncm_abc_adaptive_invalid_ess_frac,
+              &test_ncm_abc_free);
+#endif
+
+  g_test_run ();
+}
+
+void
+test_ncm_abc_new (TestNcmABC *test, gconstpointer pdata)
+{
+  NcmRNG *rng              = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmModelMVND *model_mvnd;
+  NcmDataset *dset;
+  NcmMSet *mset;
+  NcmMSetTransKernFlat *prior;
+
+  test->dim        = 2;
+  test->nparticles = 1000;
+  test->data_mvnd  = ncm_data_gauss_cov_mvnd_new_full (test->dim, 0.5, 1.0, 1.0, -1.0, 1.0, rng);
+
+  model_mvnd = ncm_model_mvnd_new (test->dim);
+  dset       = ncm_dataset_new_list (test->data_mvnd, NULL);
+  mset       = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+  prior      = ncm_mset_trans_kern_flat_new ();
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  /* Flat prior on the parameter bounds, [-50, 50] for each mean. */
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (prior), mset);
+  ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (prior));
+
+  test->abc = g_object_new (test_ncm_abc_gauss_get_type (),
+                            "mset",     mset,
+                            "prior",    prior,
+                            "data-set", dset,
+                            "adaptive", TRUE,
+                            NULL);
+
+  ncm_abc_set_rng (test->abc, rng);
+  ncm_abc_set_nthreads (test->abc, GPOINTER_TO_INT (pdata));
+
+  ncm_rng_free (rng);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_mset_clear (&mset);
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (prior));
+}
+
+void
+test_ncm_abc_free (TestNcmABC *test, gconstpointer pdata)
+{
+  ncm_data_gauss_cov_mvnd_clear (&test->data_mvnd);
+  NCM_TEST_FREE (ncm_abc_free, test->abc);
+}
+
+void
+test_ncm_abc_adaptive_posterior (TestNcmABC *test, gconstpointer pdata)
+{
+  const gdouble target_epsilon = 0.2;
+  NcmDataGaussCov *gauss       = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  NcmVector *y_obs             = ncm_vector_dup (gauss->y);
+  NcmVector *mean              = ncm_vector_new (test->dim);
+  NcmMatrix *cov               = ncm_matrix_new (test->dim, test->dim);
+  NcmABC *abc                  = test->abc;
+  gdouble ess;
+  guint j, a, b;
+
+  ncm_abc_run_to_epsilon (abc, test->nparticles, target_epsilon, 40);
+
+  g_assert_cmpfloat (ncm_abc_get_epsilon (abc), <=, target_epsilon);
+  g_assert_cmpuint (ncm_abc_get_nsims (abc), >=, (abc->nupdates + 1) * test->nparticles);
+
+  ess = ncm_abc_get_ess (abc);
+  g_assert_cmpfloat (ess, >, 0.1 * test->nparticles);
+
+  /* Weighted mean and covariance of the last population. */
+  ncm_vector_set_zero (mean);
+  ncm_matrix_set_zero (cov);
+  for (j = 0; j < test->nparticles; j++)
+  {
+    NcmVector *row    = ncm_mset_catalog_peek_row (abc->mcat, test->nparticles * abc->nupdates + j);
+    const gdouble w_j = g_array_index (abc->weights, gdouble, j);
+
+    g_assert_cmpfloat (ncm_vector_get (row, 0), <, target_epsilon);
+
+    for (a = 0; a < test->dim; a++)
+      ncm_vector_addto (mean, a, w_j * ncm_vector_get (row, 2 + a));
+  }
+  for (j = 0; j < test->nparticles; j++)
+  {
+    NcmVector *row    = ncm_mset_catalog_peek_row (abc->mcat, test->nparticles * abc->nupdates + j);
+    const gdouble w_j = g_array_index (abc->weights, gdouble, j);
+
+    for (a = 0; a < test->dim; a++)
+    {
+      for (b = 0; b < test->dim; b++)
+      {
+        ncm_matrix_addto (cov, a, b, w_j *
+                          (ncm_vector_get (row, 2 + a) - ncm_vector_get (mean, a)) *
+                          (ncm_vector_get (row, 2 + b) - ncm_vector_get (mean, b)));
+      }
+    }
+  }
+
+  /*
+   * With a flat prior the posterior is the Gaussian centered at the
+   * observation, and the ABC acceptance inside a ball of radius epsilon
+   * adds epsilon^2 / (dim + 2) to the variances. The tolerances are five
+   * times the Monte Carlo errors given the effective sample size.
+   */
+  for (a = 0; a < test->dim; a++)
+  {
+    const gdouble var_a = ncm_matrix_get (gauss->cov, a, a) + gsl_pow_2 (target_epsilon) / (test->dim + 2.0);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (mean, a), ==, ncm_vector_get (y_obs, a), 0.0, 5.0 * sqrt (var_a / ess));
+    ncm_assert_cmpdouble_e (ncm_matrix_get (cov, a, a), ==, var_a, 5.0 * sqrt (2.0 / ess), 0.0);
+  }
+
+  ncm_vector_free (y_obs);
+  ncm_vector_free (mean);
+  ncm_matrix_free (cov);
+}
+
+void
+test_ncm_abc_adaptive_traps (TestNcmABC *test, gconstpointer pdata)
+{
+#if GLIB_CHECK_VERSION (2, 38, 0)
+  g_test_trap_subprocess ("/ncm/abc/adaptive/invalid/ess_frac/subprocess", 0, 0);
+  g_test_trap_assert_failed ();
+#endif
+}
+
+void
+test_ncm_abc_adaptive_invalid_ess_frac (TestNcmABC *test, gconstpointer pdata)
+{
+  /* Keeping the whole ESS would never decrease epsilon. */
+  ncm_abc_set_ess_frac (test->abc, 1.0);
+}
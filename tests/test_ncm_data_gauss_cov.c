@@ -42,6 +42,7 @@ void test_ncm_data_gauss_cov_test_new (TestNcmDataGaussCovTest *test, gconstpoin
 void test_ncm_data_gauss_cov_test_free (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_sanity (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_bootstrap_view (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -60,6 +61,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_data_gauss_cov_test_resample,
               &test_ncm_data_gauss_cov_test_free);
 
+  g_test_add ("/ncm/data_gauss_cov_test/bootstrap/view", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_bootstrap_view,
+              &test_ncm_data_gauss_cov_test_free);
+
   g_test_run ();
 }
 
@@ -160,3 +166,43 @@ test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpoin
   ncm_stats_vec_clear (&stat);
   ncm_vector_clear (&mean);
 }
+
+void
+test_ncm_data_gauss_cov_test_bootstrap_view (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  NcmDataset *dset = ncm_dataset_new ();
+  NcmRNG *rng      = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataset *view;
+  NcmDataGaussCov *gauss, *gauss_view;
+  NcmData *data_view;
+  guint i;
+
+  ncm_dataset_append_data (dset, test->data);
+  ncm_dataset_bootstrap_set (dset, NCM_DATASET_BSTRAP_PARTIAL);
+
+  view = ncm_dataset_bootstrap_view (dset);
+  g_assert (NCM_IS_DATASET (view));
+  g_assert_cmpuint (ncm_dataset_get_ndata (view), ==, 1);
+
+  data_view  = ncm_dataset_peek_data (view, 0);
+  gauss      = NCM_DATA_GAUSS_COV (test->data);
+  gauss_view = NCM_DATA_GAUSS_COV (data_view);
+
+  g_assert (data_view != test->data);
+  g_assert (gauss_view->y == gauss->y);
+  g_assert (gauss_view->cov == gauss->cov);
+
+  g_assert (ncm_data_bootstrap_enabled (data_view));
+  g_assert (data_view->bstrap != test->data->bstrap);
+
+  ncm_dataset_bootstrap_resample (view, rng);
+  g_assert (ncm_bootstrap_is_init (data_view->bstrap));
+  g_assert (!ncm_bootstrap_is_init (test->data->bstrap));
+
+  for (i = 0; i < ncm_bootstrap_get_bsize (data_view->bstrap); i++)
+    g_assert_cmpuint (ncm_bootstrap_get (data_view->bstrap, i), <, gauss->np);
+
+  ncm_rng_free (rng);
+  NCM_TEST_FREE (ncm_dataset_free, view);
+  NCM_TEST_FREE (ncm_dataset_free, dset);
+}
@@ -125,6 +125,10 @@ TESTS_NCM_DECL (gsl, nmsimplex2rand)
 void test_ncm_fit_free (TestNcmFit *test, gconstpointer pdata);
 void test_ncm_fit_run (TestNcmFit *test, gconstpointer pdata);
 void test_ncm_fit_invalid_run (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_numdiff_mt (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_numdiff_mt_pool (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_warm_start (TestNcmFit *test, gconstpointer pdata);
+void test_ncm_fit_dup_with_dataset (TestNcmFit *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -150,6 +154,33 @@ main (gint argc, gchar *argv[])
   TESTS_NCM_ADD (gsl, nmsimplex2)
   TESTS_NCM_ADD (gsl, nmsimplex2rand)
 
+  g_test_add ("/ncm/fit/gsl/ls/numdiff/mt", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_ls_new,
+              &test_ncm_fit_numdiff_mt,
+              &test_ncm_fit_free);
+
+  g_test_add ("/ncm/fit/gsl/ls/numdiff/mt/pool", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_ls_new,
+              &test_ncm_fit_numdiff_mt_pool,
+              &test_ncm_fit_free);
+
+  g_test_add ("/ncm/fit/gsl/mm_vector_bfgs/warm_start", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_mm_vector_bfgs_new,
+              &test_ncm_fit_warm_start,
+              &test_ncm_fit_free);
+
+  g_test_add ("/ncm/fit/gsl/nmsimplex/dup_with_dataset", TestNcmFit, NULL,
+              &test_ncm_fit_gsl_nmsimplex_new,
+              &test_ncm_fit_dup_with_dataset,
+              &test_ncm_fit_free);
+
+#ifdef NUMCOSMO_HAVE_NLOPT
+  g_test_add ("/ncm/fit/nlopt/neldermead/warm_start", TestNcmFit, NULL,
+              &test_ncm_fit_nlopt_neldermead_new,
+              &test_ncm_fit_warm_start,
+              &test_ncm_fit_free);
+#endif /* NUMCOSMO_HAVE_NLOPT */
+
 #if GLIB_CHECK_VERSION(2,38,0)
 #ifdef NUMCOSMO_HAVE_NLOPT
   TESTS_NCM_ADD_INVALID (nlopt, neldermead)
@@ -217,6 +248,233 @@ test_ncm_fit_run (TestNcmFit *test, gconstpointer pdata)
   }
 }
 
+void
+test_ncm_fit_numdiff_mt (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit            = test->fit;
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  const guint data_len   = ncm_fit_state_get_data_len (fit->fstate);
+  NcmMatrix *H_st        = ncm_matrix_new (fparam_len, fparam_len);
+  NcmMatrix *H_mt        = ncm_matrix_new (fparam_len, fparam_len);
+  NcmMatrix *J_st        = ncm_matrix_new (data_len, fparam_len);
+  NcmMatrix *J_mt        = ncm_matrix_new (data_len, fparam_len);
+  guint i, j;
+
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_fit_set_nthreads (fit, 0);
+  ncm_fit_numdiff_m2lnL_hessian (fit, H_st, 1.0e-3);
+  ncm_fit_ls_J_nd_ac (fit, J_st);
+
+  ncm_fit_set_nthreads (fit, 4);
+  g_assert_cmpuint (ncm_fit_get_nthreads (fit), ==, 4);
+  ncm_fit_numdiff_m2lnL_hessian (fit, H_mt, 1.0e-3);
+  ncm_fit_ls_J_nd_ac (fit, J_mt);
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    for (j = 0; j < fparam_len; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (H_st, i, j), ==, ncm_matrix_get (H_mt, i, j), 1.0e-10, 1.0e-13);
+    for (j = 0; j < data_len; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (J_st, j, i), ==, ncm_matrix_get (J_mt, j, i), 1.0e-10, 1.0e-13);
+  }
+
+  ncm_fit_ls_J_nd_ce (fit, J_mt);
+  ncm_fit_set_nthreads (fit, 0);
+  ncm_fit_ls_J_nd_ce (fit, J_st);
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    for (j = 0; j < data_len; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (J_st, j, i), ==, ncm_matrix_get (J_mt, j, i), 1.0e-10, 1.0e-13);
+  }
+
+  ncm_fit_fisher (fit);
+  ncm_matrix_memcpy (H_st, fit->fstate->covar);
+
+  ncm_fit_set_nthreads (fit, 4);
+  ncm_fit_fisher (fit);
+  ncm_matrix_memcpy (H_mt, fit->fstate->covar);
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    for (j = 0; j < fparam_len; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (H_st, i, j), ==, ncm_matrix_get (H_mt, i, j), 1.0e-7, 1.0e-10);
+  }
+
+  ncm_matrix_free (H_st);
+  ncm_matrix_free (H_mt);
+  ncm_matrix_free (J_st);
+  ncm_matrix_free (J_mt);
+}
+
+/*
+ * Compares the threaded Jacobian of @fit with the serial one computed
+ * by a copy of @fit, @fit itself is not changed.
+ */
+static void
+_test_ncm_fit_cmp_J_nd_mt (NcmFit *fit)
+{
+  NcmSerialize *ser      = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmFit *fit_st         = ncm_fit_dup (fit, ser);
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  const guint data_len   = ncm_fit_state_get_data_len (fit->fstate);
+  NcmMatrix *J_st        = ncm_matrix_new (data_len, fparam_len);
+  NcmMatrix *J_mt        = ncm_matrix_new (data_len, fparam_len);
+  guint i, j;
+
+  g_assert_cmpuint (ncm_fit_get_nthreads (fit_st), <=, 1);
+
+  ncm_fit_ls_J_nd_ce (fit, J_mt);
+  ncm_fit_ls_J_nd_ce (fit_st, J_st);
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    for (j = 0; j < data_len; j++)
+      ncm_assert_cmpdouble_e (ncm_matrix_get (J_st, j, i), ==, ncm_matrix_get (J_mt, j, i), 1.0e-10, 1.0e-13);
+  }
+
+  ncm_matrix_free (J_st);
+  ncm_matrix_free (J_mt);
+  ncm_fit_free (fit_st);
+  ncm_serialize_free (ser);
+}
+
+void
+test_ncm_fit_numdiff_mt_pool (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit    = test->fit;
+  NcmModelID mid = ncm_model_mvnd_id ();
+  NcmMemoryPool *mp;
+
+  if (ncm_mset_fparam_len (fit->mset) < 3)
+    return;
+
+  ncm_fit_set_nthreads (fit, 4);
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+  _test_ncm_fit_cmp_J_nd_mt (fit);
+
+  /* Same models, free parameters and likelihood, the copies are kept. */
+  mp = fit->mp;
+  g_assert_nonnull (mp);
+
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+  g_assert (fit->mp == mp);
+  _test_ncm_fit_cmp_J_nd_mt (fit);
+
+  /* Different free parameters. */
+  ncm_mset_param_set_ftype (fit->mset, mid, 0, NCM_PARAM_TYPE_FIXED);
+  ncm_fit_reset (fit);
+  g_assert_null (fit->mp);
+
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+  _test_ncm_fit_cmp_J_nd_mt (fit);
+
+  /* Different data. */
+  ncm_dataset_resample (fit->lh->dset, fit->mset, test->rng);
+  ncm_fit_reset (fit);
+  g_assert_null (fit->mp);
+
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+  _test_ncm_fit_cmp_J_nd_mt (fit);
+}
+
+void
+test_ncm_fit_warm_start (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit            = test->fit;
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  NcmVector *p0          = ncm_vector_new (fparam_len);
+  NcmMatrix *cov;
+
+  ncm_mset_fparams_get_vector (fit->mset, p0);
+
+  ncm_fit_run (fit, NCM_FIT_RUN_MSGS_NONE);
+  ncm_fit_numdiff_m2lnL_covar (fit);
+  cov = ncm_fit_get_covar (fit);
+
+  ncm_fit_set_warm_start (fit, cov);
+  g_assert (ncm_fit_peek_warm_start (fit) == cov);
+
+  ncm_mset_fparams_set_vector (fit->mset, p0);
+  test_ncm_fit_run (test, pdata);
+
+  ncm_fit_set_warm_start (fit, NULL);
+  g_assert (ncm_fit_peek_warm_start (fit) == NULL);
+
+  ncm_vector_free (p0);
+  ncm_matrix_free (cov);
+}
+
+void
+test_ncm_fit_dup_with_dataset (TestNcmFit *test, gconstpointer pdata)
+{
+  NcmFit *fit       = test->fit;
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmDataset *view;
+  NcmFit *dup;
+  gdouble m2lnL, m2lnL_dup;
+
+  ncm_dataset_bootstrap_set (fit->lh->dset, NCM_DATASET_BSTRAP_TOTAL);
+
+  view = ncm_dataset_bootstrap_view (fit->lh->dset);
+  dup  = ncm_fit_dup_with_dataset (fit, view, ser);
+  ncm_serialize_reset (ser, TRUE);
+
+  g_assert_true (dup != fit);
+  g_assert_true (dup->lh->dset == view);
+  g_assert_true (dup->mset != fit->mset);
+
+  /* The view has its own data objects sharing the data arrays. */
+  {
+    NcmDataGaussCov *gauss     = NCM_DATA_GAUSS_COV (ncm_dataset_peek_data (fit->lh->dset, 0));
+    NcmDataGaussCov *gauss_dup = NCM_DATA_GAUSS_COV (ncm_dataset_peek_data (view, 0));
+
+    g_assert_true (gauss_dup != gauss);
+    g_assert_true (gauss_dup->y == gauss->y);
+    g_assert_true (gauss_dup->cov == gauss->cov);
+  }
+
+  ncm_fit_m2lnL_val (fit, &m2lnL);
+  ncm_fit_m2lnL_val (dup, &m2lnL_dup);
+  ncm_assert_cmpdouble (m2lnL_dup, ==, m2lnL);
+
+  /*
+   * Resampling the view gives the same likelihood as resampling a full
+   * copy of the dataset, and does not change the original one.
+   */
+  {
+    const gulong seed    = g_test_rand_int ();
+    NcmRNG *rng_view     = ncm_rng_seeded_new (NULL, seed);
+    NcmRNG *rng_full     = ncm_rng_seeded_new (NULL, seed);
+    NcmDataset *full     = ncm_dataset_dup (fit->lh->dset, ser);
+    NcmFit *dup_full;
+    gdouble m2lnL_full, m2lnL_after;
+
+    ncm_serialize_reset (ser, TRUE);
+    dup_full = ncm_fit_dup_with_dataset (fit, full, ser);
+
+    ncm_dataset_bootstrap_resample (view, rng_view);
+    ncm_dataset_bootstrap_resample (full, rng_full);
+
+    ncm_fit_m2lnL_val (dup, &m2lnL_dup);
+    ncm_fit_m2lnL_val (dup_full, &m2lnL_full);
+    ncm_fit_m2lnL_val (fit, &m2lnL_after);
+
+    ncm_assert_cmpdouble (m2lnL_dup, ==, m2lnL_full);
+    ncm_assert_cmpdouble (m2lnL_after, ==, m2lnL);
+
+    ncm_fit_free (dup_full);
+    ncm_dataset_free (full);
+    ncm_rng_free (rng_view);
+    ncm_rng_free (rng_full);
+  }
+
+  ncm_fit_free (dup);
+  ncm_dataset_free (view);
+  ncm_serialize_free (ser);
+}
+
 #ifdef NUMCOSMO_HAVE_NLOPT
 TESTS_NCM_TRAPS (nlopt, neldermead)
 TESTS_NCM_TRAPS (nlopt, slsqp)
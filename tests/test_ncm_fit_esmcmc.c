@@ -28,6 +28,9 @@
 #endif /* HAVE_CONFIG_H */
 #include <numcosmo/numcosmo.h>
 
+#include <math.h>
+#include <gsl/gsl_randist.h>
+
 typedef struct _TestNcmFitESMCMC
 {
   gint dim;
@@ -41,7 +44,10 @@ typedef struct _TestNcmFitESMCMC
 
 void test_ncm_fit_esmcmc_new_stretch (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_new_aps (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_new_stretch_odd (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_new_adaptive (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_traps (TestNcmFitESMCMC *test, gconstpointer pdata);
+void test_ncm_fit_esmcmc_adaptive_mean_cov (void);
 
 void test_ncm_fit_esmcmc_free (TestNcmFitESMCMC *test, gconstpointer pdata);
 void test_ncm_fit_esmcmc_run (TestNcmFitESMCMC *test, gconstpointer pdata);
@@ -89,6 +95,18 @@ main (gint argc, gchar *argv[])
               &test_ncm_fit_esmcmc_run_lre_auto_trim_vol,
               &test_ncm_fit_esmcmc_free);
 
+  g_test_add ("/ncm/fit/esmcmc/adaptive/run", TestNcmFitESMCMC, NULL,
+              &test_ncm_fit_esmcmc_new_adaptive,
+              &test_ncm_fit_esmcmc_run,
+              &test_ncm_fit_esmcmc_free);
+
+  g_test_add ("/ncm/fit/esmcmc/adaptive/run_lre", TestNcmFitESMCMC, NULL,
+              &test_ncm_fit_esmcmc_new_adaptive,
+              &test_ncm_fit_esmcmc_run_lre,
+              &test_ncm_fit_esmcmc_free);
+
+  g_test_add_func ("/ncm/fit/esmcmc/adaptive/mean_cov", &test_ncm_fit_esmcmc_adaptive_mean_cov);
+
   g_test_add ("/ncm/fit/esmcmc/stretch/run", TestNcmFitESMCMC, NULL,
               &test_ncm_fit_esmcmc_new_stretch,
               &test_ncm_fit_esmcmc_run,
@@ -109,6 +127,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_fit_esmcmc_run_lre_auto_trim_vol,
               &test_ncm_fit_esmcmc_free);
   
+  g_test_add ("/ncm/fit/esmcmc/stretch/odd/run", TestNcmFitESMCMC, NULL,
+              &test_ncm_fit_esmcmc_new_stretch_odd,
+              &test_ncm_fit_esmcmc_run,
+              &test_ncm_fit_esmcmc_free);
+  
   g_test_add ("/ncm/fit/esmcmc/stretch/traps", TestNcmFitESMCMC, NULL,
               &test_ncm_fit_esmcmc_new_stretch,
               &test_ncm_fit_esmcmc_traps,
@@ -180,6 +203,194 @@ test_ncm_fit_esmcmc_new_aps (TestNcmFitESMCMC *test, gconstpointer pdata)
   ncm_fit_esmcmc_clear (&esmcmc);
 }
 
+void
+test_ncm_fit_esmcmc_new_adaptive (TestNcmFitESMCMC *test, gconstpointer pdata)
+{
+  const gint dim                      = test->dim = g_test_rand_int_range (2, 10);
+  const gint nwalkers                 = 10 * g_test_rand_int_range (3, 6) + g_test_rand_int_range (0, 2);
+  NcmRNG *rng                         = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd      = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmModelMVND *model_mvnd            = ncm_model_mvnd_new (dim);
+  NcmDataset *dset                    = ncm_dataset_new_list (data_mvnd, NULL);
+  NcmLikelihood *lh                   = ncm_likelihood_new (dset);
+  NcmMSet *mset                       = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+  NcmMSetTransKernGauss *init_sampler = ncm_mset_trans_kern_gauss_new (0);
+
+  NcmFitESMCMCWalkerAdaptive *adaptive;
+  NcmFitESMCMC *esmcmc;
+  NcmFit *fit;
+
+  test->nrun_div = 5;
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  fit = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+  
+  ncm_fit_set_maxiter (fit, 10000000);
+
+  adaptive = ncm_fit_esmcmc_walker_adaptive_new (nwalkers, ncm_mset_fparams_len (mset));
+  ncm_fit_esmcmc_walker_adaptive_set_kde_weight (adaptive, g_test_rand_double_range (0.0, 1.0));
+  
+  esmcmc = ncm_fit_esmcmc_new (fit, 
+                               nwalkers, 
+                               NCM_MSET_TRANS_KERN (init_sampler), 
+                               NCM_FIT_ESMCMC_WALKER (adaptive), 
+                               NCM_FIT_RUN_MSGS_NONE);
+  
+  ncm_fit_esmcmc_set_rng (esmcmc, rng);
+
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (init_sampler), mset);
+  ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_mset_trans_kern_gauss_set_cov_from_rescale (init_sampler, 0.1);
+
+  test->data_mvnd = ncm_data_gauss_cov_mvnd_ref (data_mvnd);
+  test->esmcmc    = ncm_fit_esmcmc_ref (esmcmc);
+  test->fit       = ncm_fit_ref (fit);
+  test->rng       = rng;
+
+  g_assert (NCM_IS_FIT (fit));
+
+  ncm_data_gauss_cov_mvnd_clear (&data_mvnd);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_likelihood_clear (&lh);
+  ncm_mset_clear (&mset);
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_fit_clear (&fit);
+  ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (adaptive));
+  ncm_fit_esmcmc_clear (&esmcmc);
+}
+
+void
+test_ncm_fit_esmcmc_adaptive_mean_cov (void)
+{
+  const gint dim                       = g_test_rand_int_range (2, 10);
+  const gint nwalkers                  = 10 * g_test_rand_int_range (3, 6) + g_test_rand_int_range (0, 2);
+  const gint nens                      = g_test_rand_int_range (2, 6);
+  const gint ntot                      = nens * nwalkers;
+  NcmRNG *rng                          = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmFitESMCMCWalkerAdaptive *adaptive = ncm_fit_esmcmc_walker_adaptive_new (nwalkers, dim);
+  NcmVector *mean                      = ncm_vector_new (dim);
+  NcmVector *mean_a                    = ncm_vector_new (dim);
+  NcmMatrix *cov                       = ncm_matrix_new (dim, dim);
+  NcmMatrix *cov_a                     = ncm_matrix_new (dim, dim);
+  NcmMatrix *points                    = ncm_matrix_new (ntot, dim);
+  GPtrArray *theta                     = g_ptr_array_new_with_free_func ((GDestroyNotify) &ncm_vector_free);
+  GPtrArray *m2lnL                     = g_ptr_array_new_with_free_func ((GDestroyNotify) &ncm_vector_free);
+  gint e, k, i, j;
+
+  ncm_fit_esmcmc_walker_adaptive_set_kde_weight (adaptive, 0.0);
+  ncm_fit_esmcmc_walker_adaptive_set_adapt (adaptive, TRUE);
+
+  for (k = 0; k < nwalkers; k++)
+  {
+    g_ptr_array_add (theta, ncm_vector_new (dim));
+    g_ptr_array_add (m2lnL, ncm_vector_new (1));
+  }
+
+  for (e = 0; e < nens; e++)
+  {
+    for (k = 0; k < nwalkers; k++)
+    {
+      NcmVector *theta_k = g_ptr_array_index (theta, k);
+
+      for (i = 0; i < dim; i++)
+      {
+        const gdouble x_i = (i + 1.0) * (1.0 + e * 0.1) + (i + 1.0) * gsl_ran_ugaussian (rng->r);
+
+        ncm_vector_set (theta_k, i, x_i);
+        ncm_matrix_set (points, e * nwalkers + k, i, x_i);
+      }
+      ncm_vector_set (g_ptr_array_index (m2lnL, k), 0, 0.0);
+    }
+
+    ncm_fit_esmcmc_walker_setup (NCM_FIT_ESMCMC_WALKER (adaptive), theta, m2lnL, 0, nwalkers, rng);
+    g_assert_cmpuint (ncm_fit_esmcmc_walker_adaptive_get_nobs (adaptive), ==, (e + 1) * nwalkers);
+  }
+
+  /* Mean and sum of squares computed directly from all ensembles. */
+  ncm_vector_set_zero (mean);
+  for (k = 0; k < ntot; k++)
+  {
+    for (i = 0; i < dim; i++)
+      ncm_vector_addto (mean, i, ncm_matrix_get (points, k, i) / ntot);
+  }
+
+  ncm_matrix_set_zero (cov);
+  for (k = 0; k < ntot; k++)
+  {
+    for (i = 0; i < dim; i++)
+    {
+      for (j = 0; j < dim; j++)
+      {
+        const gdouble d_i = ncm_matrix_get (points, k, i) - ncm_vector_get (mean, i);
+        const gdouble d_j = ncm_matrix_get (points, k, j) - ncm_vector_get (mean, j);
+
+        ncm_matrix_addto (cov, i, j, d_i * d_j);
+      }
+    }
+  }
+
+  /* Diagonal regularization from the variance of the first ensemble. */
+  for (i = 0; i < dim; i++)
+  {
+    gdouble mean_i = 0.0;
+    gdouble var_i  = 0.0;
+
+    for (k = 0; k < nwalkers; k++)
+      mean_i += ncm_matrix_get (points, k, i) / nwalkers;
+
+    for (k = 0; k < nwalkers; k++)
+      var_i += gsl_pow_2 (ncm_matrix_get (points, k, i) - mean_i) / nwalkers;
+
+    ncm_matrix_addto (cov, i, i, 1.0e-3 * var_i);
+  }
+  ncm_matrix_scale (cov, 1.0 / ntot);
+
+  ncm_fit_esmcmc_walker_adaptive_get_mean (adaptive, mean_a);
+  ncm_fit_esmcmc_walker_adaptive_get_cov (adaptive, cov_a);
+
+  for (i = 0; i < dim; i++)
+  {
+    ncm_assert_cmpdouble_e (ncm_vector_get (mean_a, i), ==, ncm_vector_get (mean, i), 1.0e-10, 1.0e-12 * (i + 1.0));
+
+    for (j = 0; j < dim; j++)
+    {
+      const gdouble scale = sqrt (ncm_matrix_get (cov, i, i) * ncm_matrix_get (cov, j, j));
+
+      ncm_assert_cmpdouble_e (ncm_matrix_get (cov_a, i, j), ==, ncm_matrix_get (cov, i, j), 1.0e-8, 1.0e-10 * scale);
+    }
+  }
+
+  /* After a reset the statistics restart from the next ensemble. */
+  ncm_fit_esmcmc_walker_adaptive_reset (adaptive);
+  g_assert_cmpuint (ncm_fit_esmcmc_walker_adaptive_get_nobs (adaptive), ==, 0);
+
+  ncm_fit_esmcmc_walker_setup (NCM_FIT_ESMCMC_WALKER (adaptive), theta, m2lnL, 0, nwalkers, rng);
+  g_assert_cmpuint (ncm_fit_esmcmc_walker_adaptive_get_nobs (adaptive), ==, nwalkers);
+
+  ncm_fit_esmcmc_walker_adaptive_get_mean (adaptive, mean_a);
+  for (i = 0; i < dim; i++)
+  {
+    gdouble mean_i = 0.0;
+
+    for (k = 0; k < nwalkers; k++)
+      mean_i += ncm_vector_get (g_ptr_array_index (theta, k), i) / nwalkers;
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (mean_a, i), ==, mean_i, 1.0e-10, 1.0e-12 * (i + 1.0));
+  }
+
+  g_ptr_array_unref (theta);
+  g_ptr_array_unref (m2lnL);
+  ncm_vector_free (mean);
+  ncm_vector_free (mean_a);
+  ncm_matrix_free (cov);
+  ncm_matrix_free (cov_a);
+  ncm_matrix_free (points);
+  ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (adaptive));
+  ncm_rng_free (rng);
+}
+
 void
 test_ncm_fit_esmcmc_new_stretch (TestNcmFitESMCMC *test, gconstpointer pdata)
 {
@@ -235,6 +446,76 @@ test_ncm_fit_esmcmc_new_stretch (TestNcmFitESMCMC *test, gconstpointer pdata)
   ncm_fit_esmcmc_clear (&esmcmc);
 }
 
+void
+test_ncm_fit_esmcmc_new_stretch_odd (TestNcmFitESMCMC *test, gconstpointer pdata)
+{
+  const gint dim                      = test->dim = g_test_rand_int_range (2, 10);
+  const gint nwalkers                 = 10 * g_test_rand_int_range (2, 5) + 1;
+  NcmRNG *rng                         = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd      = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 5.0e-1, 1.0, 1.0, 2.0, rng);
+  NcmModelMVND *model_mvnd            = ncm_model_mvnd_new (dim);
+  NcmDataset *dset                    = ncm_dataset_new_list (data_mvnd, NULL);
+  NcmLikelihood *lh                   = ncm_likelihood_new (dset);
+  NcmMSet *mset                       = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+  NcmMSetTransKernGauss *init_sampler = ncm_mset_trans_kern_gauss_new (0);
+
+  NcmFitESMCMCWalkerStretch *stretch;
+  NcmFitESMCMC *esmcmc;
+  NcmFit *fit;
+  guint s, k;
+
+  test->nrun_div = 1;
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  fit = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+  ncm_fit_set_maxiter (fit, 10000000);
+
+  stretch = ncm_fit_esmcmc_walker_stretch_new (nwalkers, ncm_mset_fparams_len (mset));
+
+  k = 0;
+  for (s = 0; s < 2; s++)
+  {
+    guint si, sf;
+    ncm_fit_esmcmc_walker_get_subset (NCM_FIT_ESMCMC_WALKER (stretch), s, &si, &sf);
+    g_assert_cmpuint (si, ==, k);
+    g_assert_cmpuint (sf - si, ==, (s == 0) ? nwalkers / 2 : nwalkers - nwalkers / 2);
+    for (; k < sf; k++)
+      g_assert_cmpuint (ncm_fit_esmcmc_walker_subset_of (NCM_FIT_ESMCMC_WALKER (stretch), k), ==, s);
+  }
+  g_assert_cmpuint (k, ==, nwalkers);
+  
+  esmcmc  = ncm_fit_esmcmc_new (fit, 
+                                nwalkers, 
+                                NCM_MSET_TRANS_KERN (init_sampler), 
+                                NCM_FIT_ESMCMC_WALKER (stretch), 
+                                NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_fit_esmcmc_set_rng (esmcmc, rng);
+  ncm_fit_esmcmc_set_nthreads (esmcmc, 4);
+
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (init_sampler), mset);
+  ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_mset_trans_kern_gauss_set_cov_from_rescale (init_sampler, 0.01);
+
+  test->data_mvnd = ncm_data_gauss_cov_mvnd_ref (data_mvnd);
+  test->esmcmc    = ncm_fit_esmcmc_ref (esmcmc);
+  test->fit       = ncm_fit_ref (fit);
+  test->rng       = rng;
+
+  g_assert (NCM_IS_FIT (fit));
+
+  ncm_data_gauss_cov_mvnd_clear (&data_mvnd);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_likelihood_clear (&lh);
+  ncm_mset_clear (&mset);
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_fit_clear (&fit);
+  ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (stretch));
+  ncm_fit_esmcmc_clear (&esmcmc);
+}
+
 void
 test_ncm_fit_esmcmc_free (TestNcmFitESMCMC *test, gconstpointer pdata)
 {
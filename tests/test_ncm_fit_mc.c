@@ -0,0 +1,488 @@
+/***************************************************************************
+ *            test_ncm_fit_mc.c
+ *
+ *  Sun October 18 19:40:05 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmFitMC
+{
+  NcmFit *fit;
+  gulong seed;
+  guint nrealizations;
+} TestNcmFitMC;
+
+typedef struct _TestNcmFitMCRun
+{
+  NcmFitMCResampleType rtype;
+  guint nthreads;
+  gboolean keep_order;
+  gboolean substreams;
+  NcmFitMCRefit refit;
+  guint bias_check;
+  gboolean share_data;
+} TestNcmFitMCRun;
+
+void test_ncm_fit_mc_new (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_substreams (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_keep_order (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_refit_newton (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_refit_warm (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_refit_out_of_bounds (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_share_data (TestNcmFitMC *test, gconstpointer pdata);
+void test_ncm_fit_mc_free (TestNcmFitMC *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/fit/mc/substreams", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_substreams,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/keep_order", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_keep_order,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/refit/newton", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_refit_newton,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/refit/warm", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_refit_warm,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/refit/out_of_bounds", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_refit_out_of_bounds,
+              &test_ncm_fit_mc_free);
+
+  g_test_add ("/ncm/fit/mc/share_data", TestNcmFitMC, NULL,
+              &test_ncm_fit_mc_new,
+              &test_ncm_fit_mc_share_data,
+              &test_ncm_fit_mc_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_fit_mc_new (TestNcmFitMC *test, gconstpointer pdata)
+{
+  const gint dim                 = g_test_rand_int_range (2, 5);
+  NcmRNG *rng                    = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmDataGaussCovMVND *data_mvnd = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-2, 1.0e0, 1.0, -1.0, 1.0, rng);
+  NcmModelMVND *model_mvnd       = ncm_model_mvnd_new (dim);
+  NcmDataset *dset               = ncm_dataset_new_list (data_mvnd, NULL);
+  NcmLikelihood *lh              = ncm_likelihood_new (dset);
+  NcmMSet *mset                  = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  test->fit           = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+  test->seed          = g_test_rand_int_range (1, G_MAXINT32);
+  test->nrealizations = 20;
+
+  ncm_fit_set_maxiter (test->fit, 100000);
+
+  /* The fiducial model is the best fit of the original data. */
+  ncm_fit_run (test->fit, NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_rng_free (rng);
+  ncm_data_gauss_cov_mvnd_clear (&data_mvnd);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_likelihood_clear (&lh);
+  ncm_mset_clear (&mset);
+}
+
+void
+test_ncm_fit_mc_free (TestNcmFitMC *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_fit_free, test->fit);
+}
+
+/*
+ * Runs a NcmFitMC over @fit using a new RNG with the test seed, the rows
+ * of the resulting catalog are returned in a matrix. If @mc_out is not
+ * NULL it receives the NcmFitMC object.
+ */
+static NcmMatrix *
+_test_ncm_fit_mc_run_full (TestNcmFitMC *test, NcmFit *fit, const TestNcmFitMCRun *run, NcmFitMC **mc_out)
+{
+  NcmRNG *rng  = ncm_rng_seeded_new (NULL, test->seed);
+  NcmFitMC *mc = ncm_fit_mc_new (fit, run->rtype, NCM_FIT_RUN_MSGS_NONE);
+  NcmMSetCatalog *mcat;
+  NcmMatrix *res;
+  guint i;
+
+  ncm_fit_mc_set_nthreads (mc, run->nthreads);
+  ncm_fit_mc_keep_order (mc, run->keep_order);
+  ncm_fit_mc_use_rng_substreams (mc, run->substreams);
+  ncm_fit_mc_set_refit (mc, run->refit);
+  ncm_fit_mc_set_bias_check (mc, run->bias_check);
+  ncm_fit_mc_share_data (mc, run->share_data);
+  ncm_fit_mc_set_rng (mc, rng);
+
+  ncm_fit_mc_start_run (mc);
+  ncm_fit_mc_run (mc, test->nrealizations);
+  ncm_fit_mc_end_run (mc);
+
+  mcat = ncm_fit_mc_get_catalog (mc);
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat), ==, test->nrealizations);
+
+  res = ncm_matrix_new (test->nrealizations, ncm_mset_catalog_ncols (mcat));
+  for (i = 0; i < test->nrealizations; i++)
+    ncm_matrix_set_row (res, i, ncm_mset_catalog_peek_row (mcat, i));
+
+  if (mc_out != NULL)
+    *mc_out = mc;
+  else
+    ncm_fit_mc_free (mc);
+
+  ncm_mset_catalog_free (mcat);
+  ncm_rng_free (rng);
+
+  return res;
+}
+
+/*
+ * Each run uses a copy of the fiducial fit, since the single thread
+ * runs modify the fit object.
+ */
+static NcmMatrix *
+_test_ncm_fit_mc_run (TestNcmFitMC *test, const TestNcmFitMCRun *run, NcmFitMC **mc_out)
+{
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmFit *fit       = ncm_fit_dup (test->fit, ser);
+  NcmMatrix *res    = _test_ncm_fit_mc_run_full (test, fit, run, mc_out);
+
+  ncm_fit_free (fit);
+  ncm_serialize_free (ser);
+
+  return res;
+}
+
+static gint
+_test_ncm_fit_mc_cmp_row (gconstpointer a, gconstpointer b, gpointer userdata)
+{
+  NcmMatrix *res  = NCM_MATRIX (userdata);
+  const gdouble x = ncm_matrix_get (res, *(const guint *) a, 0);
+  const gdouble y = ncm_matrix_get (res, *(const guint *) b, 0);
+
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+/*
+ * Without keep_order the rows are written in the order the realizations
+ * finish, the catalogs are then compared after sorting by -2lnL.
+ */
+static NcmMatrix *
+_test_ncm_fit_mc_sort_rows (NcmMatrix *res)
+{
+  const guint nrows = ncm_matrix_nrows (res);
+  NcmMatrix *sorted = ncm_matrix_new (nrows, ncm_matrix_ncols (res));
+  GArray *idx       = g_array_sized_new (FALSE, FALSE, sizeof (guint), nrows);
+  guint i;
+
+  for (i = 0; i < nrows; i++)
+    g_array_append_val (idx, i);
+
+  g_array_sort_with_data (idx, &_test_ncm_fit_mc_cmp_row, res);
+
+  for (i = 0; i < nrows; i++)
+  {
+    NcmVector *row = ncm_matrix_get_row (res, g_array_index (idx, guint, i));
+
+    ncm_matrix_set_row (sorted, i, row);
+    ncm_vector_free (row);
+  }
+
+  g_array_unref (idx);
+
+  return sorted;
+}
+
+static void
+_test_ncm_fit_mc_assert_equal (NcmMatrix *res0, NcmMatrix *res)
+{
+  const guint nrows = ncm_matrix_nrows (res0);
+  const guint ncols = ncm_matrix_ncols (res0);
+  guint i, j;
+
+  g_assert_cmpuint (ncm_matrix_nrows (res), ==, nrows);
+  g_assert_cmpuint (ncm_matrix_ncols (res), ==, ncols);
+
+  for (i = 0; i < nrows; i++)
+  {
+    for (j = 0; j < ncols; j++)
+      ncm_assert_cmpdouble (ncm_matrix_get (res, i, j), ==, ncm_matrix_get (res0, i, j));
+  }
+}
+
+void
+test_ncm_fit_mc_substreams (TestNcmFitMC *test, gconstpointer pdata)
+{
+  const guint nthreads[] = {2, 4};
+  TestNcmFitMCRun run    = {NCM_FIT_MC_RESAMPLE_FROM_MODEL, 1, FALSE, TRUE};
+  NcmMatrix *res0        = _test_ncm_fit_mc_run (test, &run, NULL);
+  NcmMatrix *res0_sorted = _test_ncm_fit_mc_sort_rows (res0);
+  guint n;
+
+  /* The realizations must not repeat. */
+  {
+    guint i;
+    for (i = 1; i < test->nrealizations; i++)
+      g_assert_cmpfloat (ncm_matrix_get (res0_sorted, i, 0), !=, ncm_matrix_get (res0_sorted, i - 1, 0));
+  }
+
+  for (n = 0; n < G_N_ELEMENTS (nthreads); n++)
+  {
+    NcmMatrix *res, *res_sorted;
+
+    run.nthreads = nthreads[n];
+
+    /* Same catalog, row by row, keeping the order. */
+    run.keep_order = TRUE;
+    res = _test_ncm_fit_mc_run (test, &run, NULL);
+    _test_ncm_fit_mc_assert_equal (res0, res);
+    ncm_matrix_free (res);
+
+    /* Same set of rows, in any order. */
+    run.keep_order = FALSE;
+    res        = _test_ncm_fit_mc_run (test, &run, NULL);
+    res_sorted = _test_ncm_fit_mc_sort_rows (res);
+    _test_ncm_fit_mc_assert_equal (res0_sorted, res_sorted);
+    ncm_matrix_free (res);
+    ncm_matrix_free (res_sorted);
+  }
+
+  ncm_matrix_free (res0);
+  ncm_matrix_free (res0_sorted);
+}
+
+void
+test_ncm_fit_mc_keep_order (TestNcmFitMC *test, gconstpointer pdata)
+{
+  const NcmFitMCResampleType rtypes[] = {
+    NCM_FIT_MC_RESAMPLE_FROM_MODEL,
+    NCM_FIT_MC_RESAMPLE_BOOTSTRAP_NOMIX,
+    NCM_FIT_MC_RESAMPLE_BOOTSTRAP_MIX
+  };
+  const guint nthreads[] = {2, 4};
+  guint r;
+
+  /*
+   * Without substreams the realizations are drawn in sequence from the
+   * catalog RNG, the rows buffered out of order must be committed at
+   * their place.
+   */
+  for (r = 0; r < G_N_ELEMENTS (rtypes); r++)
+  {
+    TestNcmFitMCRun run = {rtypes[r], 1, TRUE, FALSE};
+    NcmMatrix *res0     = _test_ncm_fit_mc_run (test, &run, NULL);
+    guint n;
+
+    for (n = 0; n < G_N_ELEMENTS (nthreads); n++)
+    {
+      NcmMatrix *res;
+
+      run.nthreads = nthreads[n];
+      res          = _test_ncm_fit_mc_run (test, &run, NULL);
+      _test_ncm_fit_mc_assert_equal (res0, res);
+      ncm_matrix_free (res);
+    }
+
+    ncm_matrix_free (res0);
+  }
+}
+
+/*
+ * The MVND -2lnL is quadratic, so the Newton step is the exact best fit
+ * and the refits must agree with the cold fits up to the minimizer
+ * precision.
+ */
+static void
+_test_ncm_fit_mc_assert_refit_bias (NcmFitMC *mc, const gdouble nchecked)
+{
+  NcmStatsVec *bias = ncm_fit_mc_peek_refit_bias (mc);
+  guint i;
+
+  g_assert_nonnull (bias);
+  g_assert_cmpfloat (ncm_stats_vec_get_weight (bias), ==, nchecked);
+
+  g_assert_cmpfloat (fabs (ncm_stats_vec_get_mean (bias, 0)), <, 1.0e-3);
+
+  for (i = 1; i < ncm_stats_vec_len (bias); i++)
+  {
+    g_assert_cmpfloat (fabs (ncm_stats_vec_get_mean (bias, i)), <, 1.0e-2);
+    g_assert_cmpfloat (ncm_stats_vec_get_sd (bias, i), <, 1.0e-2);
+  }
+
+  g_assert_cmpuint (ncm_fit_mc_get_newton_out_of_bounds (mc), ==, 0);
+}
+
+void
+test_ncm_fit_mc_refit_newton (TestNcmFitMC *test, gconstpointer pdata)
+{
+  TestNcmFitMCRun run = {NCM_FIT_MC_RESAMPLE_FROM_MODEL, 1, TRUE, FALSE, NCM_FIT_MC_REFIT_NEWTON, 1};
+  NcmFitMC *mc        = NULL;
+  NcmMatrix *res0     = _test_ncm_fit_mc_run (test, &run, &mc);
+  NcmMatrix *res;
+
+  _test_ncm_fit_mc_assert_refit_bias (mc, test->nrealizations);
+  ncm_fit_mc_free (mc);
+
+  run.nthreads = 3;
+  res          = _test_ncm_fit_mc_run (test, &run, &mc);
+  _test_ncm_fit_mc_assert_equal (res0, res);
+  _test_ncm_fit_mc_assert_refit_bias (mc, test->nrealizations);
+
+  ncm_fit_mc_free (mc);
+  ncm_matrix_free (res);
+  ncm_matrix_free (res0);
+}
+
+void
+test_ncm_fit_mc_refit_warm (TestNcmFitMC *test, gconstpointer pdata)
+{
+  TestNcmFitMCRun run = {NCM_FIT_MC_RESAMPLE_FROM_MODEL, 1, TRUE, FALSE, NCM_FIT_MC_REFIT_WARM, 2};
+  NcmFitMC *mc        = NULL;
+  NcmMatrix *res0     = _test_ncm_fit_mc_run (test, &run, &mc);
+  NcmMatrix *res;
+
+  /* Sample indices 0, 2, 4, ... are checked. */
+  _test_ncm_fit_mc_assert_refit_bias (mc, (test->nrealizations + 1) / 2);
+  ncm_fit_mc_free (mc);
+
+  run.nthreads = 3;
+  res          = _test_ncm_fit_mc_run (test, &run, &mc);
+  _test_ncm_fit_mc_assert_equal (res0, res);
+  _test_ncm_fit_mc_assert_refit_bias (mc, (test->nrealizations + 1) / 2);
+
+  ncm_fit_mc_free (mc);
+  ncm_matrix_free (res);
+  ncm_matrix_free (res0);
+}
+
+void
+test_ncm_fit_mc_refit_out_of_bounds (TestNcmFitMC *test, gconstpointer pdata)
+{
+  TestNcmFitMCRun run       = {NCM_FIT_MC_RESAMPLE_FROM_MODEL, 1, TRUE, FALSE, NCM_FIT_MC_REFIT_NEWTON, 0};
+  NcmSerialize *ser         = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmFit *fit               = ncm_fit_dup (test->fit, ser);
+  const NcmMSetPIndex *pi   = ncm_mset_fparam_get_pi (fit->mset, 0);
+  NcmModel *model           = ncm_mset_peek (fit->mset, pi->mid);
+  const gdouble p0          = ncm_mset_fparam_get (fit->mset, 0);
+  const gdouble lb          = p0 - 1.0e-8 * (1.0 + fabs (p0));
+  const gdouble ub          = p0 + 1.0e-8 * (1.0 + fabs (p0));
+  NcmFitMC *mc              = NULL;
+  NcmMatrix *res;
+  guint i;
+
+  /* The covariance is computed before the bounds leave no room for the numerical derivatives. */
+  ncm_fit_numdiff_m2lnL_covar (fit);
+
+  ncm_model_param_set_lower_bound (model, pi->pid, lb);
+  ncm_model_param_set_upper_bound (model, pi->pid, ub);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*Newton steps fell outside the parameter bounds*");
+  res = _test_ncm_fit_mc_run_full (test, fit, &run, &mc);
+  g_test_assert_expected_messages ();
+
+  g_assert_cmpuint (ncm_fit_mc_get_newton_out_of_bounds (mc), >, 0);
+
+  /* Discarded steps keep the fiducial best fit, no estimate leaves the bounds. */
+  for (i = 0; i < test->nrealizations; i++)
+  {
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 1), >=, lb);
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 1), <=, ub);
+  }
+
+  ncm_fit_mc_free (mc);
+  ncm_matrix_free (res);
+  ncm_fit_free (fit);
+  ncm_serialize_free (ser);
+}
+
+void
+test_ncm_fit_mc_share_data (TestNcmFitMC *test, gconstpointer pdata)
+{
+  const NcmFitMCResampleType rtypes[] = {
+    NCM_FIT_MC_RESAMPLE_BOOTSTRAP_NOMIX,
+    NCM_FIT_MC_RESAMPLE_BOOTSTRAP_MIX
+  };
+  guint r;
+
+  /*
+   * The threads resampling views of the dataset must give the same
+   * catalog as the threads with full copies and as the single thread.
+   */
+  for (r = 0; r < G_N_ELEMENTS (rtypes); r++)
+  {
+    TestNcmFitMCRun run = {rtypes[r], 1, TRUE, FALSE, NCM_FIT_MC_REFIT_COLD, 0, FALSE};
+    NcmMatrix *res0     = _test_ncm_fit_mc_run (test, &run, NULL);
+    NcmMatrix *res_copy, *res_view;
+
+    run.nthreads = 3;
+    res_copy     = _test_ncm_fit_mc_run (test, &run, NULL);
+
+    run.share_data = TRUE;
+    res_view       = _test_ncm_fit_mc_run (test, &run, NULL);
+
+    _test_ncm_fit_mc_assert_equal (res0, res_copy);
+    _test_ncm_fit_mc_assert_equal (res0, res_view);
+
+    ncm_matrix_free (res_view);
+    ncm_matrix_free (res_copy);
+    ncm_matrix_free (res0);
+
+    /* Same with substreams, where the resampling runs concurrently. */
+    run.substreams = TRUE;
+    run.nthreads   = 1;
+    run.share_data = FALSE;
+    res0           = _test_ncm_fit_mc_run (test, &run, NULL);
+
+    run.nthreads   = 3;
+    run.share_data = TRUE;
+    res_view       = _test_ncm_fit_mc_run (test, &run, NULL);
+
+    _test_ncm_fit_mc_assert_equal (res0, res_view);
+
+    ncm_matrix_free (res_view);
+    ncm_matrix_free (res0);
+  }
+}
@@ -0,0 +1,201 @@
+/***************************************************************************
+ *            test_ncm_lh_ratio.c
+ *
+ *  Sun October 18 20:58:37 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_cdf.h>
+
+/*
+ * For a Gaussian likelihood the profile likelihood regions are known:
+ * the best fit is the data vector and the border of the region of the
+ * parameters (i, j) is the ellipse of the (i, j) block of the data
+ * covariance, the remaining parameters being profiled out.
+ */
+
+typedef struct _TestNcmLHRatio
+{
+  NcmFit *fit;
+  NcmDataGaussCovMVND *data_mvnd;
+  gdouble clevel;
+} TestNcmLHRatio;
+
+void test_ncm_lh_ratio_new (TestNcmLHRatio *test, gconstpointer pdata);
+void test_ncm_lh_ratio1d_bounds (TestNcmLHRatio *test, gconstpointer pdata);
+void test_ncm_lh_ratio2d_region (TestNcmLHRatio *test, gconstpointer pdata);
+void test_ncm_lh_ratio_free (TestNcmLHRatio *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/lh_ratio1d/bounds", TestNcmLHRatio, NULL,
+              &test_ncm_lh_ratio_new,
+              &test_ncm_lh_ratio1d_bounds,
+              &test_ncm_lh_ratio_free);
+
+  g_test_add ("/ncm/lh_ratio2d/region", TestNcmLHRatio, NULL,
+              &test_ncm_lh_ratio_new,
+              &test_ncm_lh_ratio2d_region,
+              &test_ncm_lh_ratio_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_lh_ratio_new (TestNcmLHRatio *test, gconstpointer pdata)
+{
+  const guint dim          = 3;
+  NcmRNG *rng              = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmModelMVND *model_mvnd = ncm_model_mvnd_new (dim);
+  NcmDataset *dset;
+  NcmLikelihood *lh;
+  NcmMSet *mset;
+
+  test->data_mvnd = ncm_data_gauss_cov_mvnd_new_full (dim, 1.0e-1, 1.0, 1.0, -1.0, 1.0, rng);
+  test->clevel    = 0.6826894921370859;
+
+  dset = ncm_dataset_new_list (test->data_mvnd, NULL);
+  lh   = ncm_likelihood_new (dset);
+  mset = ncm_mset_new (NCM_MODEL (model_mvnd), NULL);
+
+  ncm_mset_param_set_all_ftype (mset, NCM_PARAM_TYPE_FREE);
+
+  test->fit = ncm_fit_new (NCM_FIT_TYPE_GSL_LS, NULL, lh, mset, NCM_FIT_GRAD_NUMDIFF_CENTRAL);
+  ncm_fit_set_maxiter (test->fit, 100000);
+
+  ncm_fit_run (test->fit, NCM_FIT_RUN_MSGS_NONE);
+  ncm_fit_numdiff_m2lnL_covar (test->fit);
+
+  ncm_rng_free (rng);
+  ncm_model_mvnd_clear (&model_mvnd);
+  ncm_dataset_clear (&dset);
+  ncm_likelihood_clear (&lh);
+  ncm_mset_clear (&mset);
+}
+
+void
+test_ncm_lh_ratio_free (TestNcmLHRatio *test, gconstpointer pdata)
+{
+  ncm_data_gauss_cov_mvnd_clear (&test->data_mvnd);
+  NCM_TEST_FREE (ncm_fit_free, test->fit);
+}
+
+void
+test_ncm_lh_ratio1d_bounds (TestNcmLHRatio *test, gconstpointer pdata)
+{
+  NcmDataGaussCov *gauss  = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  const gdouble chisquare = gsl_cdf_chisq_Qinv (1.0 - test->clevel, 1);
+  guint i;
+
+  for (i = 0; i < 3; i++)
+  {
+    const NcmMSetPIndex *pi = ncm_mset_fparam_get_pi (test->fit->mset, i);
+    NcmLHRatio1d *lhr1d     = ncm_lh_ratio1d_new (test->fit, pi);
+    const gdouble sigma     = sqrt (ncm_matrix_get (gauss->cov, i, i));
+    const gdouble width     = sqrt (chisquare) * sigma;
+    gdouble lb, ub, lb_mt, ub_mt;
+
+    ncm_lh_ratio1d_set_nthreads (lhr1d, 1);
+    ncm_lh_ratio1d_find_bounds (lhr1d, test->clevel, NCM_FIT_RUN_MSGS_NONE, &lb, &ub);
+
+    ncm_lh_ratio1d_set_nthreads (lhr1d, 2);
+    ncm_lh_ratio1d_find_bounds (lhr1d, test->clevel, NCM_FIT_RUN_MSGS_NONE, &lb_mt, &ub_mt);
+
+    /* The concurrent searches run the same steps as the serial ones. */
+    ncm_assert_cmpdouble_e (lb_mt, ==, lb, 0.0, 1.0e-7 * width);
+    ncm_assert_cmpdouble_e (ub_mt, ==, ub, 0.0, 1.0e-7 * width);
+
+    /* The bounds are offsets from the best fit. */
+    ncm_assert_cmpdouble_e (lb, ==, -width, 1.0e-3, 0.0);
+    ncm_assert_cmpdouble_e (ub, ==, +width, 1.0e-3, 0.0);
+
+    ncm_lh_ratio1d_free (lhr1d);
+  }
+}
+
+static void
+_test_ncm_lh_ratio2d_check_ellipse (TestNcmLHRatio *test, NcmLHRatio2dRegion *rg, const gdouble chisquare)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  const gdouble C00      = ncm_matrix_get (gauss->cov, 0, 0);
+  const gdouble C01      = ncm_matrix_get (gauss->cov, 0, 1);
+  const gdouble C11      = ncm_matrix_get (gauss->cov, 1, 1);
+  const gdouble det      = C00 * C11 - C01 * C01;
+  guint k;
+
+  g_assert_cmpuint (rg->np, >, 3);
+
+  for (k = 0; k < rg->np; k++)
+  {
+    const gdouble d0   = ncm_vector_get (rg->p1, k) - ncm_vector_get (gauss->y, 0);
+    const gdouble d1   = ncm_vector_get (rg->p2, k) - ncm_vector_get (gauss->y, 1);
+    const gdouble chi2 = (C11 * d0 * d0 - 2.0 * C01 * d0 * d1 + C00 * d1 * d1) / det;
+
+    ncm_assert_cmpdouble_e (chi2, ==, chisquare, 5.0e-3, 0.0);
+  }
+}
+
+void
+test_ncm_lh_ratio2d_region (TestNcmLHRatio *test, gconstpointer pdata)
+{
+  const gdouble chisquare = gsl_cdf_chisq_Qinv (1.0 - test->clevel, 2);
+  const NcmMSetPIndex *pi1 = ncm_mset_fparam_get_pi (test->fit->mset, 0);
+  const NcmMSetPIndex *pi2 = ncm_mset_fparam_get_pi (test->fit->mset, 1);
+  NcmLHRatio2d *lhr2d      = ncm_lh_ratio2d_new (test->fit, pi1, pi2, 1.0e-5);
+  NcmLHRatio2dRegion *rg, *rg_rays;
+
+  ncm_lh_ratio2d_set_nthreads (lhr2d, 1);
+  rg = ncm_lh_ratio2d_conf_region (lhr2d, test->clevel, 100.0, NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_lh_ratio2d_set_nthreads (lhr2d, 4);
+  rg_rays = ncm_lh_ratio2d_conf_region (lhr2d, test->clevel, 100.0, NCM_FIT_RUN_MSGS_NONE);
+
+  _test_ncm_lh_ratio2d_check_ellipse (test, rg, chisquare);
+  _test_ncm_lh_ratio2d_check_ellipse (test, rg_rays, chisquare);
+
+  /* Both borders cover the same ellipse, up to the angular sampling. */
+  {
+    const gdouble ext1 = ncm_vector_get_max (rg->p1) - ncm_vector_get_min (rg->p1);
+    const gdouble ext2 = ncm_vector_get_max (rg->p2) - ncm_vector_get_min (rg->p2);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get_max (rg_rays->p1), ==, ncm_vector_get_max (rg->p1), 0.0, 1.0e-2 * ext1);
+    ncm_assert_cmpdouble_e (ncm_vector_get_min (rg_rays->p1), ==, ncm_vector_get_min (rg->p1), 0.0, 1.0e-2 * ext1);
+    ncm_assert_cmpdouble_e (ncm_vector_get_max (rg_rays->p2), ==, ncm_vector_get_max (rg->p2), 0.0, 1.0e-2 * ext2);
+    ncm_assert_cmpdouble_e (ncm_vector_get_min (rg_rays->p2), ==, ncm_vector_get_min (rg->p2), 0.0, 1.0e-2 * ext2);
+  }
+
+  ncm_lh_ratio2d_region_free (rg);
+  ncm_lh_ratio2d_region_free (rg_rays);
+  ncm_lh_ratio2d_free (lhr2d);
+}
@@ -0,0 +1,346 @@
+/***************************************************************************
+ *            test_ncm_mpi_job.c
+ *
+ *  Sun October 18 23:12:54 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+/*
+ * No slaves are initialized, so all the calls below go through the local
+ * fallback, which is also the only path available without MPI. The jobs
+ * are run by a test subclass which evaluates $x^2 + 1$ without any delay
+ * and records the order in which the jobs were run.
+ */
+
+typedef struct _TestNcmMPIJobSquareClass
+{
+  NcmMPIJobClass parent_class;
+} TestNcmMPIJobSquareClass;
+
+typedef struct _TestNcmMPIJobSquare
+{
+  NcmMPIJob parent_instance;
+  GArray *run_order;
+} TestNcmMPIJobSquare;
+
+GType test_ncm_mpi_job_square_get_type (void);
+
+G_DEFINE_TYPE (TestNcmMPIJobSquare, test_ncm_mpi_job_square, NCM_TYPE_MPI_JOB);
+
+static void
+test_ncm_mpi_job_square_init (TestNcmMPIJobSquare *mjs)
+{
+  mjs->run_order = g_array_new (FALSE, FALSE, sizeof (gdouble));
+}
+
+static void
+_test_ncm_mpi_job_square_finalize (GObject *object)
+{
+  TestNcmMPIJobSquare *mjs = (TestNcmMPIJobSquare *) object;
+
+  g_array_unref (mjs->run_order);
+
+  /* Chain up : end */
+  G_OBJECT_CLASS (test_ncm_mpi_job_square_parent_class)->finalize (object);
+}
+
+static MPI_Datatype
+_test_ncm_mpi_job_square_datatype (NcmMPIJob *mpi_job, gint *len, gint *size)
+{
+  len[0]  = 1;
+  size[0] = sizeof (gdouble);
+#ifdef NUMCOSMO_HAVE_MPI
+  return MPI_DOUBLE;
+#else
+  return NULL;
+#endif /* NUMCOSMO_HAVE_MPI */
+}
+
+static void
+_test_ncm_mpi_job_square_run (NcmMPIJob *mpi_job, gpointer input, gpointer ret)
+{
+  TestNcmMPIJobSquare *mjs = (TestNcmMPIJobSquare *) mpi_job;
+  const gdouble x          = ncm_vector_get (input, 0);
+
+  g_array_append_val (mjs->run_order, x);
+  ncm_vector_set (ret, 0, x * x + 1.0);
+}
+
+static void
+test_ncm_mpi_job_square_class_init (TestNcmMPIJobSquareClass *klass)
+{
+  GObjectClass *object_class    = G_OBJECT_CLASS (klass);
+  NcmMPIJobClass *mpi_job_class = NCM_MPI_JOB_CLASS (klass);
+
+  object_class->finalize = &_test_ncm_mpi_job_square_finalize;
+
+  mpi_job_class->input_datatype  = &_test_ncm_mpi_job_square_datatype;
+  mpi_job_class->return_datatype = &_test_ncm_mpi_job_square_datatype;
+  mpi_job_class->run             = &_test_ncm_mpi_job_square_run;
+}
+
+#define TEST_NCM_MPI_JOB_NJOBS (50)
+
+typedef struct _TestNcmMPIJob
+{
+  NcmMPIJob *mpi_job;
+  GPtrArray *input_a;
+  GPtrArray *ret_a;
+} TestNcmMPIJob;
+
+void test_ncm_mpi_job_new (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_submit (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_wait_any (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_out_of_order (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_run_array (TestNcmMPIJob *test, gconstpointer pdata);
+void test_ncm_mpi_job_free (TestNcmMPIJob *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/mpi_job/async/submit", TestNcmMPIJob, NULL,
+              &test_ncm_mpi_job_new,
+              &test_ncm_mpi_job_submit,
+              &test_ncm_mpi_job_free);
+
+  g_test_add ("/ncm/mpi_job/async/wait_any", TestNcmMPIJob, NULL,
+              &test_ncm_mpi_job_new,
+              &test_ncm_mpi_job_wait_any,
+              &test_ncm_mpi_job_free);
+
+  g_test_add ("/ncm/mpi_job/async/out_of_order", TestNcmMPIJob, NULL,
+              &test_ncm_mpi_job_new,
+              &test_ncm_mpi_job_out_of_order,
+              &test_ncm_mpi_job_free);
+
+  g_test_add ("/ncm/mpi_job/run_array", TestNcmMPIJob, NULL,
+              &test_ncm_mpi_job_new,
+              &test_ncm_mpi_job_run_array,
+              &test_ncm_mpi_job_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_mpi_job_new (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  guint i;
+
+  test->mpi_job = g_object_new (test_ncm_mpi_job_square_get_type (), NULL);
+  test->input_a = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  test->ret_a   = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+  {
+    NcmVector *input = ncm_vector_new (1);
+    NcmVector *ret   = ncm_vector_new (1);
+
+    ncm_vector_set (input, 0, g_test_rand_double_range (-10.0, 10.0));
+    ncm_vector_set (ret, 0, GSL_NAN);
+
+    g_ptr_array_add (test->input_a, input);
+    g_ptr_array_add (test->ret_a, ret);
+  }
+}
+
+void
+test_ncm_mpi_job_free (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  g_ptr_array_unref (test->input_a);
+  g_ptr_array_unref (test->ret_a);
+
+  NCM_TEST_FREE (ncm_mpi_job_free, test->mpi_job);
+}
+
+static guint
+_test_ncm_mpi_job_submit (TestNcmMPIJob *test, const guint i)
+{
+  return ncm_mpi_job_submit (test->mpi_job, g_ptr_array_index (test->input_a, i), g_ptr_array_index (test->ret_a, i));
+}
+
+static void
+_test_ncm_mpi_job_check (TestNcmMPIJob *test, const guint i)
+{
+  const gdouble x = ncm_vector_get (g_ptr_array_index (test->input_a, i), 0);
+
+  g_assert_cmpfloat (ncm_vector_get (g_ptr_array_index (test->ret_a, i), 0), ==, x * x + 1.0);
+}
+
+static void
+_test_ncm_mpi_job_check_run_order (TestNcmMPIJob *test)
+{
+  TestNcmMPIJobSquare *mjs = (TestNcmMPIJobSquare *) test->mpi_job;
+  guint i;
+
+  /* Each job was run exactly once, locally in the submission order. */
+  g_assert_cmpuint (mjs->run_order->len, ==, TEST_NCM_MPI_JOB_NJOBS);
+
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+    g_assert_cmpfloat (g_array_index (mjs->run_order, gdouble, i), ==, ncm_vector_get (g_ptr_array_index (test->input_a, i), 0));
+}
+
+void
+test_ncm_mpi_job_submit (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  guint job_ids[TEST_NCM_MPI_JOB_NJOBS];
+  guint job_id;
+  guint i;
+
+  g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+  {
+    job_ids[i] = _test_ncm_mpi_job_submit (test, i);
+
+    if (i > 0)
+      g_assert_cmpuint (job_ids[i], >, job_ids[i - 1]);
+  }
+
+  /* Without slaves the jobs complete in the submission order. */
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+  {
+    g_assert_true (ncm_mpi_job_poll (test->mpi_job, &job_id));
+    g_assert_cmpuint (job_id, ==, job_ids[i]);
+
+    _test_ncm_mpi_job_check (test, i);
+  }
+
+  g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+  _test_ncm_mpi_job_check_run_order (test);
+}
+
+void
+test_ncm_mpi_job_wait_any (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  guint job_ids[TEST_NCM_MPI_JOB_NJOBS];
+  guint job_id;
+  guint i;
+
+  /* Each completed job is collected by wait_any before the next submission. */
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS / 2; i++)
+  {
+    job_ids[i] = _test_ncm_mpi_job_submit (test, i);
+
+    g_assert_cmpuint (ncm_mpi_job_wait_any (test->mpi_job), ==, job_ids[i]);
+    g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+
+    _test_ncm_mpi_job_check (test, i);
+  }
+
+  /* The remaining jobs are collected by wait_all, which discards their identifiers. */
+  for (; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+    job_ids[i] = _test_ncm_mpi_job_submit (test, i);
+
+  g_assert_cmpuint (ncm_mpi_job_wait_any (test->mpi_job), ==, job_ids[TEST_NCM_MPI_JOB_NJOBS / 2]);
+  ncm_mpi_job_wait_all (test->mpi_job);
+
+  g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+    _test_ncm_mpi_job_check (test, i);
+
+  _test_ncm_mpi_job_check_run_order (test);
+}
+
+void
+test_ncm_mpi_job_out_of_order (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  GHashTable *job_index = g_hash_table_new (g_direct_hash, g_direct_equal);
+  guint ncollected      = 0;
+  guint nsubmitted      = 0;
+  guint job_id;
+  guint i;
+
+  /*
+   * The caller must not assume any relation between the submission and 
+   * the completion orders, the returns are matched through the job 
+   * identifiers. Submissions and collections are interleaved in uneven 
+   * batches using both poll and wait_any.
+   */
+  while (ncollected < TEST_NCM_MPI_JOB_NJOBS)
+  {
+    const guint nbatch = GSL_MIN (g_test_rand_int_range (0, 5), TEST_NCM_MPI_JOB_NJOBS - nsubmitted);
+
+    for (i = 0; i < nbatch; i++, nsubmitted++)
+    {
+      job_id = _test_ncm_mpi_job_submit (test, nsubmitted);
+
+      g_assert_false (g_hash_table_contains (job_index, GUINT_TO_POINTER (job_id)));
+      g_hash_table_insert (job_index, GUINT_TO_POINTER (job_id), GUINT_TO_POINTER (nsubmitted + 1));
+    }
+
+    if (ncollected == nsubmitted)
+    {
+      g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+      continue;
+    }
+
+    if (g_test_rand_bit ())
+      job_id = ncm_mpi_job_wait_any (test->mpi_job);
+    else
+      g_assert_true (ncm_mpi_job_poll (test->mpi_job, &job_id));
+
+    {
+      const guint index = GPOINTER_TO_UINT (g_hash_table_lookup (job_index, GUINT_TO_POINTER (job_id)));
+
+      g_assert_cmpuint (index, >, 0);
+      g_assert_true (g_hash_table_remove (job_index, GUINT_TO_POINTER (job_id)));
+
+      _test_ncm_mpi_job_check (test, index - 1);
+      ncollected++;
+    }
+  }
+
+  g_assert_cmpuint (g_hash_table_size (job_index), ==, 0);
+  g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+  _test_ncm_mpi_job_check_run_order (test);
+
+  g_hash_table_unref (job_index);
+}
+
+void
+test_ncm_mpi_job_run_array (TestNcmMPIJob *test, gconstpointer pdata)
+{
+  guint job_id;
+  guint i;
+
+  ncm_mpi_job_run_array (test->mpi_job, test->input_a, test->ret_a);
+
+  g_assert_false (ncm_mpi_job_poll (test->mpi_job, &job_id));
+
+  for (i = 0; i < TEST_NCM_MPI_JOB_NJOBS; i++)
+    _test_ncm_mpi_job_check (test, i);
+
+  _test_ncm_mpi_job_check_run_order (test);
+}
@@ -0,0 +1,373 @@
+/***************************************************************************
+ *            test_ncm_mpsf_sbessel_int.c
+ *
+ *  Mon October 19 00:21:37 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#define TEST_NCM_MPSF_SBESSEL_INT_PREC (128)
+#define TEST_NCM_MPSF_SBESSEL_INT_L (7)
+
+typedef struct _TestNcmMpsfSBesselInt
+{
+  NcmGridSection x_secs[3];
+  NcmGridSection k_secs[2];
+  NcmMpsfSBesselIntSpline *int_jlspline;
+  gchar *filename;
+} TestNcmMpsfSBesselInt;
+
+void test_ncm_mpsf_sbessel_int_new (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_prepare (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_save_load (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_load_corrupted (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_load_version (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_load_truncated (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_cached_fill (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+void test_ncm_mpsf_sbessel_int_free (TestNcmMpsfSBesselInt *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/mpsf/sbessel_int/prepare", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_prepare,
+              &test_ncm_mpsf_sbessel_int_free);
+  g_test_add ("/ncm/mpsf/sbessel_int/save_load", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_save_load,
+              &test_ncm_mpsf_sbessel_int_free);
+  g_test_add ("/ncm/mpsf/sbessel_int/load/corrupted", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_load_corrupted,
+              &test_ncm_mpsf_sbessel_int_free);
+  g_test_add ("/ncm/mpsf/sbessel_int/load/version", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_load_version,
+              &test_ncm_mpsf_sbessel_int_free);
+  g_test_add ("/ncm/mpsf/sbessel_int/load/truncated", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_load_truncated,
+              &test_ncm_mpsf_sbessel_int_free);
+  g_test_add ("/ncm/mpsf/sbessel_int/cached_fill", TestNcmMpsfSBesselInt, NULL,
+              &test_ncm_mpsf_sbessel_int_new,
+              &test_ncm_mpsf_sbessel_int_cached_fill,
+              &test_ncm_mpsf_sbessel_int_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_mpsf_sbessel_int_new (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  /* 
+   * The random end point makes the grid names, and then the cache file 
+   * names, unique to this run. 
+   */
+  const gdouble x_end = 4.0 + g_test_rand_double_range (0.0, 1.0);
+  const NcmGridSection x_secs[3] = {
+    {NCM_GRID_NODES_START, 0,  6, 0.1, 1.0},
+    {NCM_GRID_NODES_BOTH,  6, 12, 1.0, x_end},
+    {0, }
+  };
+  const NcmGridSection k_secs[2] = {
+    {NCM_GRID_NODES_BOTH,  0,  5, 0.5, 10.0},
+    {0, }
+  };
+
+  memcpy (test->x_secs, x_secs, sizeof (x_secs));
+  memcpy (test->k_secs, k_secs, sizeof (k_secs));
+
+  test->int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_new_from_sections (TEST_NCM_MPSF_SBESSEL_INT_PREC, test->x_secs, test->k_secs);
+  test->filename     = g_strdup_printf ("test_ncm_mpsf_sbessel_int_%u.dat", g_test_rand_int ());
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_prepare (test->int_jlspline, TEST_NCM_MPSF_SBESSEL_INT_L, GMP_RNDN);
+}
+
+void
+test_ncm_mpsf_sbessel_int_free (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  gchar *fullname = ncm_cfg_get_fullpath ("%s", test->filename);
+
+  g_unlink (fullname);
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_free (test->int_jlspline);
+  g_free (test->filename);
+  g_free (fullname);
+}
+
+static void
+_test_ncm_mpsf_sbessel_int_cmp (NcmMpsfSBesselIntSpline *int_jlspline, NcmMpsfSBesselIntSpline *int_jlspline_ref)
+{
+  guint i, j, n;
+
+  g_assert_cmpuint (int_jlspline->prec, ==, int_jlspline_ref->prec);
+  g_assert_cmpuint (int_jlspline->x->nnodes, ==, int_jlspline_ref->x->nnodes);
+  g_assert_cmpuint (int_jlspline->k->nnodes, ==, int_jlspline_ref->k->nnodes);
+  g_assert_cmpuint (int_jlspline->rules_count, ==, int_jlspline_ref->rules_count);
+
+  for (i = 0; i < int_jlspline->x->nnodes; i++)
+    g_assert_cmpint (mpq_cmp (int_jlspline->x->nodes[i], int_jlspline_ref->x->nodes[i]), ==, 0);
+
+  for (j = 0; j < int_jlspline->k->nnodes; j++)
+    g_assert_cmpint (mpq_cmp (int_jlspline->k->nodes[j], int_jlspline_ref->k->nodes[j]), ==, 0);
+
+  for (j = 0; j < int_jlspline->k->nnodes; j++)
+    for (i = 0; i < int_jlspline->x->nnodes; i++)
+      g_assert_cmpuint (NCM_MPSF_SBESSEL_INT_MAP (int_jlspline, i, j), ==, NCM_MPSF_SBESSEL_INT_MAP (int_jlspline_ref, i, j));
+
+  for (i = 0; i < int_jlspline->rules_count; i++)
+  {
+    NcmMpsfSBesselIntegRecur *xnjlrec     = int_jlspline->xnjlrec[i];
+    NcmMpsfSBesselIntegRecur *xnjlrec_ref = int_jlspline_ref->xnjlrec[i];
+
+    for (n = 0; n < 4; n++)
+    {
+      g_assert_true (mpfr_equal_p (xnjlrec->int_jl_xn[n],   xnjlrec_ref->int_jl_xn[n]));
+      g_assert_true (mpfr_equal_p (xnjlrec->int_jlp1_xn[n], xnjlrec_ref->int_jlp1_xn[n]));
+    }
+  }
+}
+
+void
+test_ncm_mpsf_sbessel_int_prepare (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  NcmMpsfSBesselIntSpline *int_jlspline = test->int_jlspline;
+  const glong l                         = TEST_NCM_MPSF_SBESSEL_INT_L;
+  mpfr_t res;
+  mpq_t q;
+  guint i, j, n;
+
+  mpq_init (q);
+  mpfr_init2 (res, TEST_NCM_MPSF_SBESSEL_INT_PREC);
+
+  g_assert_true (int_jlspline->prepared);
+  g_assert_cmpuint (int_jlspline->rules_count, >, 0);
+  g_assert_cmpuint (int_jlspline->rules_count, <=, int_jlspline->x->nnodes * int_jlspline->k->nnodes);
+
+  /* 
+   * The rules are computed by the thread pool, each one must be equal 
+   * to the serial evaluation of the integrals at its node $x_ik_j$.
+   */
+  for (j = 0; j < int_jlspline->k->nnodes; j++)
+  {
+    for (i = 0; i < int_jlspline->x->nnodes; i++)
+    {
+      NcmMpsfSBesselIntegRecur *xnjlrec = int_jlspline->xnjlrec[NCM_MPSF_SBESSEL_INT_MAP (int_jlspline, i, j)];
+
+      mpq_mul (q, int_jlspline->x->nodes[i], int_jlspline->k->nodes[j]);
+
+      for (n = 0; n < 4; n++)
+      {
+        ncm_mpsf_sbessel_jl_xj_integral_q (l + 0, n, q, res, GMP_RNDN);
+        g_assert_true (mpfr_equal_p (xnjlrec->int_jl_xn[n], res));
+
+        ncm_mpsf_sbessel_jl_xj_integral_q (l + 1, n, q, res, GMP_RNDN);
+        g_assert_true (mpfr_equal_p (xnjlrec->int_jlp1_xn[n], res));
+      }
+    }
+  }
+
+  mpq_clear (q);
+  mpfr_clear (res);
+}
+
+void
+test_ncm_mpsf_sbessel_int_save_load (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  NcmMpsfSBesselIntSpline *int_jlspline;
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_save (test->int_jlspline, test->filename);
+  g_assert_true (ncm_cfg_exists (test->filename));
+
+  int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_load (test->filename);
+  g_assert_nonnull (int_jlspline);
+  g_assert_true (int_jlspline->prepared);
+
+  _test_ncm_mpsf_sbessel_int_cmp (int_jlspline, test->int_jlspline);
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_free (int_jlspline);
+}
+
+static gchar *
+_test_ncm_mpsf_sbessel_int_save_contents (TestNcmMpsfSBesselInt *test, gsize *len)
+{
+  gchar *fullname = ncm_cfg_get_fullpath ("%s", test->filename);
+  GError *error   = NULL;
+  gchar *data     = NULL;
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_save (test->int_jlspline, test->filename);
+
+  g_assert_true (g_file_get_contents (fullname, &data, len, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (len[0], >, 5 + sizeof (guint32) + NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN);
+
+  g_free (fullname);
+
+  return data;
+}
+
+static void
+_test_ncm_mpsf_sbessel_int_set_contents (TestNcmMpsfSBesselInt *test, const gchar *data, gsize len)
+{
+  gchar *fullname = ncm_cfg_get_fullpath ("%s", test->filename);
+  GError *error   = NULL;
+
+  g_assert_true (g_file_set_contents (fullname, data, len, &error));
+  g_assert_no_error (error);
+
+  g_free (fullname);
+}
+
+void
+test_ncm_mpsf_sbessel_int_load_corrupted (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  gsize len;
+  gchar *data = _test_ncm_mpsf_sbessel_int_save_contents (test, &len);
+  const gsize pos[2] = {5 + sizeof (guint32) + 1, len - NCM_MPSF_SBESSEL_INT_CACHE_CHECKSUM_LEN - 1};
+  guint i;
+
+  /* A flipped bit in the body or in its last byte must be detected. */
+  for (i = 0; i < G_N_ELEMENTS (pos); i++)
+  {
+    data[pos[i]] ^= 0x01;
+    _test_ncm_mpsf_sbessel_int_set_contents (test, data, len);
+
+    g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*checksum mismatch*");
+    g_assert_null (ncm_mpsf_sbessel_jl_xj_integrate_spline_load (test->filename));
+    g_test_assert_expected_messages ();
+
+    data[pos[i]] ^= 0x01;
+  }
+
+  g_free (data);
+}
+
+void
+test_ncm_mpsf_sbessel_int_load_version (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  gsize len;
+  gchar *data         = _test_ncm_mpsf_sbessel_int_save_contents (test, &len);
+  const guint32 other = GUINT32_TO_BE (NCM_MPSF_SBESSEL_INT_CACHE_VERSION + 1);
+
+  memcpy (&data[5], &other, sizeof (guint32));
+  _test_ncm_mpsf_sbessel_int_set_contents (test, data, len);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*version*differs*");
+  g_assert_null (ncm_mpsf_sbessel_jl_xj_integrate_spline_load (test->filename));
+  g_test_assert_expected_messages ();
+
+  g_free (data);
+}
+
+void
+test_ncm_mpsf_sbessel_int_load_truncated (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  gsize len;
+  gchar *data = _test_ncm_mpsf_sbessel_int_save_contents (test, &len);
+
+  /* Truncated after the header the checksum cannot match. */
+  _test_ncm_mpsf_sbessel_int_set_contents (test, data, len / 2);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*checksum mismatch*");
+  g_assert_null (ncm_mpsf_sbessel_jl_xj_integrate_spline_load (test->filename));
+  g_test_assert_expected_messages ();
+
+  /* Without the complete header the file is not recognized. */
+  _test_ncm_mpsf_sbessel_int_set_contents (test, data, 3);
+
+  g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*not a valid cache file*");
+  g_assert_null (ncm_mpsf_sbessel_jl_xj_integrate_spline_load (test->filename));
+  g_test_assert_expected_messages ();
+
+  g_free (data);
+}
+
+static gchar *
+_test_ncm_mpsf_sbessel_int_cache_name (TestNcmMpsfSBesselInt *test, const glong l)
+{
+  gchar *name_x     = ncm_grid_get_name (test->x_secs);
+  gchar *name_k     = ncm_grid_get_name (test->k_secs);
+  gchar *rname      = g_strconcat (name_x, name_k, NULL);
+  gchar *rname_hash = g_compute_checksum_for_string (G_CHECKSUM_MD5, rname, strlen (rname));
+  gchar *filename   = g_strdup_printf ("xnjl_rule_%ld_%lu_%s.dat", l, (gulong) TEST_NCM_MPSF_SBESSEL_INT_PREC, rname_hash);
+
+  g_free (name_x);
+  g_free (name_k);
+  g_free (rname);
+  g_free (rname_hash);
+
+  return filename;
+}
+
+void
+test_ncm_mpsf_sbessel_int_cached_fill (TestNcmMpsfSBesselInt *test, gconstpointer pdata)
+{
+  const glong lmin = TEST_NCM_MPSF_SBESSEL_INT_L - 1;
+  const glong lmax = TEST_NCM_MPSF_SBESSEL_INT_L + 1;
+  glong l;
+
+  for (l = lmin; l <= lmax; l++)
+  {
+    gchar *filename = _test_ncm_mpsf_sbessel_int_cache_name (test, l);
+
+    g_assert_false (ncm_cfg_exists (filename));
+    g_free (filename);
+  }
+
+  ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_fill (TEST_NCM_MPSF_SBESSEL_INT_PREC, lmin, lmax, test->x_secs, test->k_secs, GMP_RNDN);
+
+  for (l = lmin; l <= lmax; l++)
+  {
+    gchar *filename = _test_ncm_mpsf_sbessel_int_cache_name (test, l);
+    gchar *fullname = ncm_cfg_get_fullpath ("%s", filename);
+
+    g_assert_true (ncm_cfg_exists (filename));
+
+    /* The cached rules must be the ones computed directly. */
+    if (l == TEST_NCM_MPSF_SBESSEL_INT_L)
+    {
+      NcmMpsfSBesselIntSpline *int_jlspline = ncm_mpsf_sbessel_jl_xj_integrate_spline_cached_new (TEST_NCM_MPSF_SBESSEL_INT_PREC, l, test->x_secs, test->k_secs, GMP_RNDN);
+
+      _test_ncm_mpsf_sbessel_int_cmp (int_jlspline, test->int_jlspline);
+      ncm_mpsf_sbessel_jl_xj_integrate_spline_free (int_jlspline);
+    }
+
+    g_unlink (fullname);
+
+    g_free (filename);
+    g_free (fullname);
+  }
+}
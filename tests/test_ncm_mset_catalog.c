@@ -47,7 +47,53 @@ void test_ncm_mset_catalog_norma (TestNcmMSetCatalog *test, gconstpointer pdata)
 void test_ncm_mset_catalog_norma_bound (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_norma_unif (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_vol (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_stream (TestNcmMSetCatalog *test, gconstpointer pdata);
 void test_ncm_mset_catalog_invalid_run (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_func_batch (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_func_nthreads (TestNcmMSetCatalog *test, gconstpointer pdata);
+
+/*
+ * Polynomial in x with the free parameters as coefficients.
+ */
+static void
+_test_ncm_mset_catalog_func_poly (NcmMSetFuncList *flist, NcmMSet *mset, const gdouble *x, gdouble *res)
+{
+  const guint len = ncm_mset_fparams_len (mset);
+  gint k;
+
+  res[0] = 0.0;
+  for (k = len - 1; k >= 0; k--)
+    res[0] = res[0] * x[0] + ncm_mset_fparam_get (mset, k);
+}
+
+/*
+ * Sum and sum of squares of the free parameters.
+ */
+static void
+_test_ncm_mset_catalog_func_moments (NcmMSetFuncList *flist, NcmMSet *mset, const gdouble *x, gdouble *res)
+{
+  const guint len = ncm_mset_fparams_len (mset);
+  guint k;
+
+  res[0] = 0.0;
+  res[1] = 0.0;
+  for (k = 0; k < len; k++)
+  {
+    const gdouble p_k = ncm_mset_fparam_get (mset, k);
+
+    res[0] += p_k;
+    res[1] += p_k * p_k;
+  }
+}
+
+/*
+ * Free parameter selected by its index.
+ */
+static void
+_test_ncm_mset_catalog_func_fparam (NcmMSetFuncList *flist, NcmMSet *mset, const gdouble *x, gdouble *res)
+{
+  res[0] = ncm_mset_fparam_get (mset, (guint) x[0]);
+}
 
 gint
 main (gint argc, gchar *argv[])
@@ -56,6 +102,13 @@ main (gint argc, gchar *argv[])
   ncm_cfg_init_full_ptr (&argc, &argv);
   ncm_cfg_enable_gsl_err_handler ();
 
+  ncm_mset_func_list_register ("poly", "p(x)", "TestNcmMSetCatalog", "Polynomial of the free parameters",
+                               G_TYPE_NONE, _test_ncm_mset_catalog_func_poly, 1, 1);
+  ncm_mset_func_list_register ("moments", "m", "TestNcmMSetCatalog", "Moments of the free parameters",
+                               G_TYPE_NONE, _test_ncm_mset_catalog_func_moments, 0, 2);
+  ncm_mset_func_list_register ("fparam", "p_i", "TestNcmMSetCatalog", "Free parameter by index",
+                               G_TYPE_NONE, _test_ncm_mset_catalog_func_fparam, 1, 1);
+
   g_test_add ("/ncm/mset/catalog/mean", TestNcmMSetCatalog, NULL,
               &test_ncm_mset_catalog_new,
               &test_ncm_mset_catalog_mean,
@@ -86,6 +139,23 @@ main (gint argc, gchar *argv[])
               &test_ncm_mset_catalog_vol,
               &test_ncm_mset_catalog_free);
   
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  g_test_add ("/ncm/mset/catalog/stream", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_stream,
+              &test_ncm_mset_catalog_free);
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+  g_test_add ("/ncm/mset/catalog/func/batch", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_func_batch,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset/catalog/func/nthreads", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_func_nthreads,
+              &test_ncm_mset_catalog_free);
+
   g_test_add ("/ncm/mset/catalog/traps", TestNcmMSetCatalog, NULL,
               &test_ncm_mset_catalog_new,
               &test_ncm_mset_catalog_traps,
@@ -102,6 +172,7 @@ main (gint argc, gchar *argv[])
 
 #define NTESTS_MIN 100
 #define NTESTS_MAX 200
+#define TEST_NCM_MSET_CATALOG_STREAM_NBINS 100000
 
 void
 test_ncm_mset_catalog_new (TestNcmMSetCatalog *test, gconstpointer pdata)
@@ -394,6 +465,358 @@ test_ncm_mset_catalog_vol (TestNcmMSetCatalog *test, gconstpointer pdata)
 }
  
 
+void
+test_ncm_mset_catalog_stream (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmData *data            = NCM_DATA (test->data_mvnd);
+  NcmDataGaussCov *cov     = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  NcmMSet *mset            = ncm_mset_catalog_peek_mset (test->mcat);
+  const guint nt           = g_test_rand_int_range (NTESTS_MIN, NTESTS_MAX);
+  const guint chunk_size   = g_test_rand_int_range (1, 50);
+  gchar *tmp_dir           = g_dir_make_tmp ("test_ncm_mset_catalog_stream_XXXXXX", NULL);
+  gchar *cat_file          = g_build_filename (tmp_dir, "mcat.fits", NULL);
+  gchar *cat_mset          = g_build_filename (tmp_dir, "mcat.mset", NULL);
+  gchar *join_file         = g_build_filename (tmp_dir, "mcat_join.fits", NULL);
+  gchar *join_mset         = g_build_filename (tmp_dir, "mcat_join.mset", NULL);
+  gchar *files[3]          = {cat_file, cat_file, NULL};
+  NcmStatsVec *pstats      = ncm_mset_catalog_peek_pstats (test->mcat);
+  NcmMSetCatalogStream *mcs;
+  NcmStatsVec *sstats;
+  guint i;
+
+  g_assert (tmp_dir != NULL);
+
+  ncm_mset_catalog_set_file (test->mcat, cat_file);
+
+  for (i = 0; i < nt; i++)
+  {
+    gdouble m2lnL = 0.0;
+    ncm_data_m2lnL_val (data, mset, &m2lnL);
+
+    ncm_data_resample (data, mset, test->rng);
+    ncm_mset_catalog_add_from_vector_array (test->mcat, cov->y, &m2lnL);
+  }
+
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  mcs    = ncm_mset_catalog_stream_new (cat_file, TEST_NCM_MSET_CATALOG_STREAM_NBINS);
+  sstats = ncm_mset_catalog_stream_peek_stats (mcs);
+
+  ncm_mset_catalog_stream_add_file (mcs, cat_file, 0, chunk_size);
+
+  g_assert_cmpuint (ncm_mset_catalog_stream_nrows (mcs), ==, nt);
+  g_assert_cmpuint (ncm_mset_catalog_stream_ncols (mcs), ==, ncm_stats_vec_len (pstats));
+
+  for (i = 0; i < ncm_stats_vec_len (pstats); i++)
+  {
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_mean (sstats, i), ==, ncm_stats_vec_get_mean (pstats, i), 1.0e-10, 0.0);
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_var (sstats, i), ==, ncm_stats_vec_get_var (pstats, i), 1.0e-8, 0.0);
+
+    if (ncm_mset_catalog_stream_col_has_hist (mcs, i))
+    {
+      const gdouble q0 = ncm_mset_catalog_stream_get_quantile (mcs, i, 0.1);
+      const gdouble q1 = ncm_mset_catalog_stream_get_quantile (mcs, i, 0.5);
+      const gdouble q2 = ncm_mset_catalog_stream_get_quantile (mcs, i, 0.9);
+
+      g_assert_cmpfloat (q0, <=, q1);
+      g_assert_cmpfloat (q1, <=, q2);
+    }
+  }
+
+  /* Streaming the same file twice doubles the rows and keeps the moments. */
+  ncm_mset_catalog_stream_reset (mcs);
+  ncm_mset_catalog_stream_add_files (mcs, files, NULL, chunk_size);
+
+  g_assert_cmpuint (ncm_mset_catalog_stream_nrows (mcs), ==, 2 * nt);
+
+  for (i = 0; i < ncm_stats_vec_len (pstats); i++)
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_mean (sstats, i), ==, ncm_stats_vec_get_mean (pstats, i), 1.0e-10, 0.0);
+
+  ncm_mset_catalog_stream_join (files, NULL, join_file, chunk_size);
+
+  {
+    NcmMSetCatalog *mcat_join = ncm_mset_catalog_new_from_file_ro (join_file, 0);
+
+    g_assert_cmpuint (ncm_mset_catalog_len (mcat_join), ==, 2 * nt);
+
+    for (i = 0; i < nt; i++)
+    {
+      NcmVector *row   = ncm_mset_catalog_peek_row (test->mcat, i);
+      NcmVector *row_a = ncm_mset_catalog_peek_row (mcat_join, 2 * i + 0);
+      NcmVector *row_b = ncm_mset_catalog_peek_row (mcat_join, 2 * i + 1);
+      guint j;
+
+      for (j = 0; j < ncm_vector_len (row); j++)
+      {
+        g_assert_cmpfloat (ncm_vector_get (row_a, j), ==, ncm_vector_get (row, j));
+        g_assert_cmpfloat (ncm_vector_get (row_b, j), ==, ncm_vector_get (row, j));
+      }
+    }
+
+    /*
+     * Exact quantiles of the joined catalog. The p-values 0.8 -+ 4 / nt and
+     * 4 / nt bracket the 0.1, 0.5 and 0.9 quantiles by two rows of each
+     * input, the histogram adds at most one bin width.
+     */
+    {
+      NcmMSet *mset_join     = ncm_mset_catalog_peek_mset (mcat_join);
+      NcmMSetFuncList *fp    = ncm_mset_func_list_new ("TestNcmMSetCatalog:fparam", NULL);
+      const guint fparam_len = ncm_mset_fparam_len (mset_join);
+      NcmVector *x_v         = ncm_vector_new (fparam_len);
+      GArray *p_val          = g_array_new (FALSE, FALSE, sizeof (gdouble));
+      const gdouble dp       = 4.0 / nt;
+      const gdouble p[3]     = {0.8 - dp, 0.8 + dp, dp};
+      NcmMatrix *ci;
+
+      for (i = 0; i < fparam_len; i++)
+        ncm_vector_set (x_v, i, i);
+
+      g_array_append_vals (p_val, p, 3);
+
+      ci = ncm_mset_catalog_calc_ci_direct (mcat_join, NCM_MSET_FUNC (fp), x_v, p_val);
+
+      for (i = 0; i < fparam_len; i++)
+      {
+        const gdouble w = (ncm_mset_fparam_get_upper_bound (mset_join, i) - ncm_mset_fparam_get_lower_bound (mset_join, i)) / TEST_NCM_MSET_CATALOG_STREAM_NBINS;
+        guint col;
+
+        g_assert (ncm_mset_catalog_stream_col_by_name (mcs, ncm_mset_fparam_full_name (mset_join, i), &col));
+        g_assert (ncm_mset_catalog_stream_col_has_hist (mcs, col));
+
+        {
+          const gdouble q0 = ncm_mset_catalog_stream_get_quantile (mcs, col, 0.1);
+          const gdouble q1 = ncm_mset_catalog_stream_get_quantile (mcs, col, 0.5);
+          const gdouble q2 = ncm_mset_catalog_stream_get_quantile (mcs, col, 0.9);
+
+          g_assert_cmpfloat (q0, >=, ncm_matrix_get (ci, i, 3) - w);
+          g_assert_cmpfloat (q0, <=, ncm_matrix_get (ci, i, 1) + w);
+          g_assert_cmpfloat (q1, >=, ncm_matrix_get (ci, i, 5) - w);
+          g_assert_cmpfloat (q1, <=, ncm_matrix_get (ci, i, 6) + w);
+          g_assert_cmpfloat (q2, >=, ncm_matrix_get (ci, i, 2) - w);
+          g_assert_cmpfloat (q2, <=, ncm_matrix_get (ci, i, 4) + w);
+        }
+
+        ncm_assert_cmpdouble_e (ncm_stats_vec_get_mean (sstats, col), ==, ncm_matrix_get (ci, i, 0), 1.0e-10, 0.0);
+      }
+
+      ncm_matrix_free (ci);
+      g_array_unref (p_val);
+      ncm_vector_free (x_v);
+      ncm_mset_func_free (NCM_MSET_FUNC (fp));
+    }
+
+    ncm_mset_catalog_free (mcat_join);
+  }
+
+  ncm_mset_catalog_stream_free (mcs);
+  ncm_mset_catalog_set_file (test->mcat, NULL);
+
+  g_unlink (cat_file);
+  g_unlink (cat_mset);
+  g_unlink (join_file);
+  g_unlink (join_mset);
+  g_rmdir (tmp_dir);
+
+  g_free (cat_file);
+  g_free (cat_mset);
+  g_free (join_file);
+  g_free (join_mset);
+  g_free (tmp_dir);
+}
+
+static void
+_test_ncm_mset_catalog_assert_equal (NcmMatrix *a, NcmMatrix *b)
+{
+  guint i, j;
+
+  g_assert_cmpuint (ncm_matrix_nrows (a), ==, ncm_matrix_nrows (b));
+  g_assert_cmpuint (ncm_matrix_ncols (a), ==, ncm_matrix_ncols (b));
+
+  for (i = 0; i < ncm_matrix_nrows (a); i++)
+  {
+    for (j = 0; j < ncm_matrix_ncols (a); j++)
+      ncm_assert_cmpdouble (ncm_matrix_get (a, i, j), ==, ncm_matrix_get (b, i, j));
+  }
+}
+
+void
+test_ncm_mset_catalog_func_batch (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSet *mset               = ncm_mset_catalog_peek_mset (test->mcat);
+  const guint nrows           = g_test_rand_int_range (NTESTS_MIN, NTESTS_MAX);
+  const guint offset          = 1;
+  NcmMSetFuncList *poly       = ncm_mset_func_list_new ("TestNcmMSetCatalog:poly", NULL);
+  NcmMSetFuncList *moments    = ncm_mset_func_list_new ("TestNcmMSetCatalog:moments", NULL);
+  NcmVector *x_v              = ncm_vector_new (5);
+  NcmVector *p0               = ncm_vector_new (test->dim);
+  NcmVector *p                = ncm_vector_new (test->dim);
+  NcmMatrix *fparams          = ncm_matrix_new (nrows, offset + test->dim);
+  NcmMatrix *res_m            = ncm_matrix_new (nrows, 2);
+  NcmMatrix *res_p            = ncm_matrix_new (nrows, ncm_vector_len (x_v));
+  NcmMatrix *res_s            = ncm_matrix_new (nrows, ncm_vector_len (x_v));
+  NcmVector *res_row          = ncm_vector_new (ncm_vector_len (x_v));
+  guint i, j;
+
+  for (j = 0; j < ncm_vector_len (x_v); j++)
+    ncm_vector_set (x_v, j, j / (ncm_vector_len (x_v) - 1.0));
+
+  for (i = 0; i < nrows; i++)
+  {
+    ncm_matrix_set (fparams, i, 0, GSL_NAN);
+    for (j = 0; j < test->dim; j++)
+      ncm_matrix_set (fparams, i, offset + j, ncm_rng_uniform_gen (test->rng, 1.0, 2.0));
+  }
+
+  ncm_mset_fparams_get_vector (mset, p0);
+
+  /* Serial references, one row at a time. */
+  for (i = 0; i < nrows; i++)
+  {
+    NcmVector *row = ncm_matrix_get_row (fparams, i);
+
+    ncm_mset_fparams_set_vector_offset (mset, row, offset);
+    ncm_mset_func_eval (NCM_MSET_FUNC (moments), mset, NULL, ncm_matrix_ptr (res_m, i, 0));
+    ncm_mset_func_eval_vector (NCM_MSET_FUNC (poly), mset, x_v, res_row);
+    ncm_matrix_set_row (res_s, i, res_row);
+
+    ncm_vector_free (row);
+  }
+  ncm_mset_fparams_set_vector (mset, p0);
+
+  {
+    const guint nthreads[] = {0, 1, 4};
+    guint n;
+
+    for (n = 0; n < G_N_ELEMENTS (nthreads); n++)
+    {
+      NcmMatrix *res = ncm_matrix_new (nrows, 2);
+
+      ncm_mset_func_eval_batch (NCM_MSET_FUNC (moments), mset, fparams, offset, NULL, res, nthreads[n]);
+      _test_ncm_mset_catalog_assert_equal (res_m, res);
+
+      ncm_mset_func_eval_vector_batch (NCM_MSET_FUNC (poly), mset, fparams, offset, x_v, res_p, nthreads[n]);
+      _test_ncm_mset_catalog_assert_equal (res_s, res_p);
+
+      /* The batch never changes the parameters of mset. */
+      ncm_mset_fparams_get_vector (mset, p);
+      for (j = 0; j < test->dim; j++)
+        ncm_assert_cmpdouble (ncm_vector_get (p, j), ==, ncm_vector_get (p0, j));
+
+      ncm_matrix_free (res);
+    }
+  }
+
+  /* As in ncm_mset_func_eval(), the evaluation point set in the function has precedence. */
+  {
+    gdouble x0        = 0.5;
+    gdouble x1        = 0.25;
+    NcmMatrix *res    = ncm_matrix_new (nrows, 1);
+    NcmMatrix *res_mt = ncm_matrix_new (nrows, 1);
+
+    ncm_mset_func_set_eval_x (NCM_MSET_FUNC (poly), &x0, 1);
+
+    g_test_expect_message ("NUMCOSMO", G_LOG_LEVEL_WARNING, "*eval x was already used, ignoring argument*");
+    ncm_mset_func_eval_batch (NCM_MSET_FUNC (poly), mset, fparams, offset, &x1, res, 0);
+    g_test_assert_expected_messages ();
+
+    ncm_mset_func_eval_batch (NCM_MSET_FUNC (poly), mset, fparams, offset, NULL, res_mt, 4);
+
+    for (i = 0; i < nrows; i++)
+    {
+      NcmVector *row = ncm_matrix_get_row (fparams, i);
+      gdouble f0;
+
+      ncm_mset_fparams_set_vector_offset (mset, row, offset);
+      ncm_mset_func_eval (NCM_MSET_FUNC (poly), mset, NULL, &f0);
+
+      ncm_assert_cmpdouble (ncm_matrix_get (res, i, 0), ==, f0);
+      ncm_assert_cmpdouble (ncm_matrix_get (res_mt, i, 0), ==, f0);
+
+      ncm_vector_free (row);
+    }
+    ncm_mset_fparams_set_vector (mset, p0);
+
+    ncm_matrix_free (res);
+    ncm_matrix_free (res_mt);
+  }
+
+  ncm_vector_free (res_row);
+  ncm_matrix_free (res_s);
+  ncm_matrix_free (res_p);
+  ncm_matrix_free (res_m);
+  ncm_matrix_free (fparams);
+  ncm_vector_free (p);
+  ncm_vector_free (p0);
+  ncm_vector_free (x_v);
+  ncm_mset_func_free (NCM_MSET_FUNC (moments));
+  ncm_mset_func_free (NCM_MSET_FUNC (poly));
+}
+
+void
+test_ncm_mset_catalog_func_nthreads (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmData *data         = NCM_DATA (test->data_mvnd);
+  NcmDataGaussCov *cov  = NCM_DATA_GAUSS_COV (test->data_mvnd);
+  NcmMSet *mset         = ncm_mset_catalog_peek_mset (test->mcat);
+  const guint nt        = g_test_rand_int_range (NTESTS_MIN, NTESTS_MAX);
+  NcmMSetFuncList *poly = ncm_mset_func_list_new ("TestNcmMSetCatalog:poly", NULL);
+  NcmVector *x_v        = ncm_vector_new (5);
+  GArray *p_val         = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *lim           = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  NcmMatrix *ci_direct, *ci_interp, *pvalue;
+  guint i;
+
+  for (i = 0; i < nt; i++)
+  {
+    gdouble m2lnL = 0.0;
+    ncm_data_m2lnL_val (data, mset, &m2lnL);
+
+    ncm_data_resample (data, mset, test->rng);
+    ncm_mset_catalog_add_from_vector_array (test->mcat, cov->y, &m2lnL);
+  }
+
+  for (i = 0; i < ncm_vector_len (x_v); i++)
+    ncm_vector_set (x_v, i, i / (ncm_vector_len (x_v) - 1.0));
+
+  {
+    const gdouble p_val_a[] = {0.6827, 0.9545};
+    const gdouble lim_a[]   = {1.0, 2.0, 4.0};
+
+    g_array_append_vals (p_val, p_val_a, G_N_ELEMENTS (p_val_a));
+    g_array_append_vals (lim, lim_a, G_N_ELEMENTS (lim_a));
+  }
+
+  ci_direct = ncm_mset_catalog_calc_ci_direct (test->mcat, NCM_MSET_FUNC (poly), x_v, p_val);
+  ci_interp = ncm_mset_catalog_calc_ci_interp (test->mcat, NCM_MSET_FUNC (poly), x_v, p_val, 100, NCM_FIT_RUN_MSGS_NONE);
+  pvalue    = ncm_mset_catalog_calc_pvalue (test->mcat, NCM_MSET_FUNC (poly), x_v, lim, 100, NCM_FIT_RUN_MSGS_NONE);
+
+  /* The batched evaluation gives the same values in the same order. */
+  ncm_mset_catalog_set_nthreads (test->mcat, 3);
+  g_assert_cmpuint (ncm_mset_catalog_get_nthreads (test->mcat), ==, 3);
+
+  {
+    NcmMatrix *ci_direct_mt = ncm_mset_catalog_calc_ci_direct (test->mcat, NCM_MSET_FUNC (poly), x_v, p_val);
+    NcmMatrix *ci_interp_mt = ncm_mset_catalog_calc_ci_interp (test->mcat, NCM_MSET_FUNC (poly), x_v, p_val, 100, NCM_FIT_RUN_MSGS_NONE);
+    NcmMatrix *pvalue_mt    = ncm_mset_catalog_calc_pvalue (test->mcat, NCM_MSET_FUNC (poly), x_v, lim, 100, NCM_FIT_RUN_MSGS_NONE);
+
+    _test_ncm_mset_catalog_assert_equal (ci_direct, ci_direct_mt);
+    _test_ncm_mset_catalog_assert_equal (ci_interp, ci_interp_mt);
+    _test_ncm_mset_catalog_assert_equal (pvalue, pvalue_mt);
+
+    ncm_matrix_free (ci_direct_mt);
+    ncm_matrix_free (ci_interp_mt);
+    ncm_matrix_free (pvalue_mt);
+  }
+
+  ncm_matrix_free (ci_direct);
+  ncm_matrix_free (ci_interp);
+  ncm_matrix_free (pvalue);
+  g_array_unref (p_val);
+  g_array_unref (lim);
+  ncm_vector_free (x_v);
+  ncm_mset_func_free (NCM_MSET_FUNC (poly));
+}
+
 #if GLIB_CHECK_VERSION(2,38,0)
 void
 test_ncm_mset_catalog_traps (TestNcmMSetCatalog *test, gconstpointer pdata)
@@ -0,0 +1,160 @@
+/***************************************************************************
+ *            test_ncm_rng.c
+ *
+ *  Sun October 18 19:12:40 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+void test_ncm_rng_philox_kat (void);
+void test_ncm_rng_substream_stream (void);
+void test_ncm_rng_substream_independence (void);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add_func ("/ncm/rng/philox4x32_10/kat", &test_ncm_rng_philox_kat);
+  g_test_add_func ("/ncm/rng/substream/stream", &test_ncm_rng_substream_stream);
+  g_test_add_func ("/ncm/rng/substream/independence", &test_ncm_rng_substream_independence);
+
+  g_test_run ();
+}
+
+void
+test_ncm_rng_philox_kat (void)
+{
+  /* Known answers of the Random123 reference implementation (kat_vectors). */
+  const guint32 ctr[3][4] = {
+    {0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U},
+    {0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU},
+    {0x243F6A88U, 0x85A308D3U, 0x13198A2EU, 0x03707344U}
+  };
+  const guint32 key[3][2] = {
+    {0x00000000U, 0x00000000U},
+    {0xFFFFFFFFU, 0xFFFFFFFFU},
+    {0xA4093822U, 0x299F31D0U}
+  };
+  const guint32 kat[3][4] = {
+    {0x6627E8D5U, 0xE169C58DU, 0xBC57AC4CU, 0x9B00DBD8U},
+    {0x408F276DU, 0x41C83B0EU, 0xA20BC7C6U, 0x6D5451FDU},
+    {0xD16CFE09U, 0x94FDCCEBU, 0x5001E420U, 0x24126EA1U}
+  };
+  guint i, j;
+
+  for (i = 0; i < 3; i++)
+  {
+    guint32 out[4];
+
+    ncm_rng_philox4x32_10 (ctr[i], key[i], out);
+
+    for (j = 0; j < 4; j++)
+      g_assert_cmphex (out[j], ==, kat[i][j]);
+  }
+}
+
+void
+test_ncm_rng_substream_stream (void)
+{
+  const gulong seed    = g_test_rand_int_range (1, G_MAXINT32);
+  const guint64 index  = ((guint64) g_test_rand_int () << 32) + (guint32) g_test_rand_int ();
+  NcmRNG *rng          = ncm_rng_seeded_new (NULL, seed);
+  NcmRNG *sub          = ncm_rng_substream_new (rng, index);
+  const guint32 key[2] = {(guint32) seed, (guint32) (((guint64) seed) >> 32)};
+  guint32 ctr[4]       = {0, 0, (guint32) index, (guint32) (index >> 32)};
+  guint b, j;
+
+  g_assert_cmpstr (ncm_rng_get_algo (sub), ==, NCM_RNG_SUBSTREAM_ALGO);
+  g_assert_cmpuint (ncm_rng_get_seed (sub), ==, seed);
+
+  /* The substream is the sequence of blocks with counters (b, 0, index). */
+  for (b = 0; b < 5; b++)
+  {
+    guint32 out[4];
+
+    ctr[0] = b;
+    ncm_rng_philox4x32_10 (ctr, key, out);
+
+    for (j = 0; j < 4; j++)
+      g_assert_cmphex (gsl_rng_get (sub->r), ==, out[j]);
+  }
+
+  /* Resetting goes back to the beginning and does not touch the parent. */
+  {
+    gchar *state = ncm_rng_get_state (rng);
+    guint32 out[4];
+    gchar *state_after;
+
+    ncm_rng_substream_set (rng, sub, index);
+
+    ctr[0] = 0;
+    ncm_rng_philox4x32_10 (ctr, key, out);
+    g_assert_cmphex (gsl_rng_get (sub->r), ==, out[0]);
+
+    state_after = ncm_rng_get_state (rng);
+    g_assert_cmpstr (state, ==, state_after);
+
+    g_free (state);
+    g_free (state_after);
+  }
+
+  ncm_rng_free (sub);
+  NCM_TEST_FREE (ncm_rng_free, rng);
+}
+
+void
+test_ncm_rng_substream_independence (void)
+{
+  const gulong seed = g_test_rand_int_range (1, G_MAXINT32);
+  NcmRNG *rng       = ncm_rng_seeded_new (NULL, seed);
+  NcmRNG *sub0      = ncm_rng_substream_new (rng, 0);
+  NcmRNG *sub1      = ncm_rng_substream_new (rng, 1);
+  NcmRNG *sub0_b    = ncm_rng_substream_new (rng, 0);
+  guint eq          = 0;
+  guint i;
+
+  for (i = 0; i < 1000; i++)
+  {
+    const gulong a0 = gsl_rng_get (sub0->r);
+    const gulong a1 = gsl_rng_get (sub1->r);
+
+    g_assert_cmpuint (gsl_rng_get (sub0_b->r), ==, a0);
+    eq += (a0 == a1);
+  }
+
+  g_assert_cmpuint (eq, <, 2);
+
+  ncm_rng_free (sub0);
+  ncm_rng_free (sub1);
+  ncm_rng_free (sub0_b);
+  NCM_TEST_FREE (ncm_rng_free, rng);
+}
@@ -50,6 +50,9 @@ static void test_ncm_serialize_from_string_nest_samename (TestNcmSerialize *test
 static void test_ncm_serialize_to_file_from_file (TestNcmSerialize *test, gconstpointer pdata);
 static void test_ncm_serialize_to_binfile_from_binfile (TestNcmSerialize *test, gconstpointer pdata);
 
+static void test_ncm_serialize_new_share_arrays (TestNcmSerialize *test, gconstpointer pdata);
+static void test_ncm_serialize_dup_obj_share_arrays (TestNcmSerialize *test, gconstpointer pdata);
+
 static void test_ncm_serialize_reset_autosave_only (TestNcmSerialize *test, gconstpointer pdata);
 
 static void test_ncm_serialize_traps (TestNcmSerialize *test, gconstpointer pdata);
@@ -107,6 +110,10 @@ main (gint argc, gchar *argv[])
               &test_ncm_serialize_new_noclean_dup,
               &test_ncm_serialize_to_binfile_from_binfile,
               &test_ncm_serialize_free);
+  g_test_add ("/ncm/serialize/dup_obj/share_arrays", TestNcmSerialize, NULL,
+              &test_ncm_serialize_new_share_arrays,
+              &test_ncm_serialize_dup_obj_share_arrays,
+              &test_ncm_serialize_free);
 
   g_test_add ("/ncm/serialize/traps", TestNcmSerialize, NULL,
               &test_ncm_serialize_new,
@@ -154,6 +161,12 @@ test_ncm_serialize_new_noclean_dup (TestNcmSerialize *test, gconstpointer pdata)
   test->ser = ncm_serialize_new (0);
 }
 
+void 
+test_ncm_serialize_new_share_arrays (TestNcmSerialize *test, gconstpointer pdata)
+{
+  test->ser = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP | NCM_SERIALIZE_OPT_SHARE_ARRAYS);
+}
+
 void
 test_ncm_serialize_free (TestNcmSerialize *test, gconstpointer pdata)
 {
@@ -467,6 +480,53 @@ test_ncm_serialize_to_binfile_from_binfile (TestNcmSerialize *test, gconstpointe
   }
 }
 
+static void 
+test_ncm_serialize_dup_obj_share_arrays (TestNcmSerialize *test, gconstpointer pdata)
+{
+  const guint np = 100;
+  NcmVector *xv  = ncm_vector_new (np);
+  NcmVector *yv  = ncm_vector_new (np);
+  NcmSpline *s;
+  guint i;
+
+  for (i = 0; i < np; i++)
+  {
+    const gdouble x = i * 1.0 / (np - 1.0);
+    ncm_vector_set (xv, i, x);
+    ncm_vector_set (yv, i, sin (x));
+  }
+
+  s = ncm_spline_cubic_notaknot_new_full (xv, yv, TRUE);
+
+  {
+    NcmSpline *s_dup = NCM_SPLINE (ncm_serialize_dup_obj (test->ser, G_OBJECT (s)));
+    NcmVector *xv_dup = ncm_spline_get_xv (s_dup);
+    NcmVector *yv_dup = ncm_spline_get_yv (s_dup);
+
+    g_assert (s_dup != s);
+    g_assert (xv_dup == xv);
+    g_assert (yv_dup == yv);
+
+    ncm_serialize_reset (test->ser, TRUE);
+    g_assert_cmpuint (ncm_serialize_count_instances (test->ser), ==, 0);
+
+    ncm_spline_prepare (s_dup);
+    for (i = 0; i < np - 1; i++)
+    {
+      const gdouble x = (i + 0.5) / (np - 1.0);
+      g_assert_cmpfloat (ncm_spline_eval (s_dup, x), ==, ncm_spline_eval (s, x));
+    }
+
+    ncm_vector_free (xv_dup);
+    ncm_vector_free (yv_dup);
+    NCM_TEST_FREE (ncm_spline_free, s_dup);
+  }
+
+  ncm_vector_free (xv);
+  ncm_vector_free (yv);
+  NCM_TEST_FREE (ncm_spline_free, s);
+}
+
 void
 test_ncm_serialize_traps (TestNcmSerialize *test, gconstpointer pdata)
 {
@@ -34,9 +34,17 @@
 #define XMAX 8.0
 #define L 1200
 
+void test_ncm_sf_sbessel_table_gsl (void);
+
 gint
 main (gint argc, gchar *argv[])
 {
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init_full_ptr (&argc, &argv);
+  //cfg_enable_gsl_err_handler ();
+
+  g_test_add_func ("/ncm/sf/sbessel/table/gsl", &test_ncm_sf_sbessel_table_gsl);
+
   if (FALSE)
   {
     GTimer *bench = g_timer_new ();
@@ -46,10 +54,6 @@ main (gint argc, gchar *argv[])
 
     memset (time_elap, 0, sizeof (gdouble) * NTOT);
 
-    g_test_init (&argc, &argv, NULL);
-    ncm_cfg_init_full_ptr (&argc, &argv);
-    //cfg_enable_gsl_err_handler ();
-
     for (j = 430; j <= L; j++)
     {
       printf ("# L = %u\n", j);
@@ -81,4 +85,63 @@ main (gint argc, gchar *argv[])
       printf ("% 20.15g %e\n", x, time_elap[i]);
     }
   }
+
+  g_test_run ();
+}
+
+void
+test_ncm_sf_sbessel_table_gsl (void)
+{
+  const guint lmax          = 300;
+  const gdouble xmax        = 600.0;
+  const gdouble dx          = 0.05;
+  NcmSFSBesselTable *jltab  = ncm_sf_sbessel_table_new (lmax, xmax, dx);
+  NcmRNG *rng               = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  const guint ntests        = 2000;
+  const guint ls[]          = {0, 1, 2, 7, 30, 111, 299, 300};
+  guint n;
+
+  g_assert_cmpuint (jltab->lmax, ==, lmax);
+  g_assert_cmpfloat (jltab->xmax, >=, xmax);
+
+  for (n = 0; n < G_N_ELEMENTS (ls); n++)
+  {
+    const guint l       = ls[n];
+    const gdouble xmin  = ncm_sf_sbessel_table_get_xmin (jltab, l);
+    guint i;
+
+    g_assert_cmpfloat (xmin, <=, l);
+
+    /* The points below xmin are those dropped from the table, j_l must be negligible there. */
+    if (xmin > 0.0)
+    {
+      const gdouble x = ncm_rng_uniform_gen (rng, 0.0, xmin);
+
+      ncm_assert_cmpdouble (ncm_sf_sbessel_table_eval (jltab, l, x), ==, 0.0);
+      g_assert_cmpfloat (fabs (gsl_sf_bessel_jl (l, x)), <, 1.0e-10);
+    }
+
+    for (i = 0; i < ntests; i++)
+    {
+      const gdouble x      = ncm_rng_uniform_gen (rng, xmin, xmax);
+      const gdouble jl_tab = ncm_sf_sbessel_table_eval (jltab, l, x);
+      const gdouble jl_gsl = gsl_sf_bessel_jl (l, x);
+
+      ncm_assert_cmpdouble_e (jl_tab, ==, jl_gsl, 0.0, 5.0e-8);
+    }
+
+    /* On the nodes the table must reproduce the values it was built from. */
+    for (i = 0; i < 10; i++)
+    {
+      const gdouble x = (ceil (xmin / dx) + 37 * i) * dx;
+
+      if (x > xmax)
+        break;
+
+      ncm_assert_cmpdouble_e (ncm_sf_sbessel_table_eval (jltab, l, x), ==, gsl_sf_bessel_jl (l, x), 1.0e-10, 1.0e-14);
+    }
+  }
+
+  ncm_rng_free (rng);
+  ncm_sf_sbessel_table_free (jltab);
 }
@@ -45,6 +45,7 @@ typedef struct _TestNcmStatsDistNd
 } TestNcmStatsDistNd;
 
 static void test_ncm_stats_dist_nd_new_kde_gauss (TestNcmStatsDistNd *test, gconstpointer pdata);
+static void test_ncm_stats_dist_nd_new_kde_gauss_cutoff (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_est (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_interp (TestNcmStatsDistNd *test, gconstpointer pdata);
 static void test_ncm_stats_dist_nd_gauss_dens_interp_unormalized (TestNcmStatsDistNd *test, gconstpointer pdata);
@@ -79,6 +80,16 @@ main (gint argc, gchar *argv[])
               &test_ncm_stats_dist_nd_gauss_dens_interp_unormalized, 
               &test_ncm_stats_dist_nd_free);
   
+  g_test_add ("/ncm/stats/dist/nd/kde/gauss/cutoff/gauss/dens/est", TestNcmStatsDistNd, NULL, 
+              &test_ncm_stats_dist_nd_new_kde_gauss_cutoff, 
+              &test_ncm_stats_dist_nd_gauss_dens_est, 
+              &test_ncm_stats_dist_nd_free);
+  
+  g_test_add ("/ncm/stats/dist/nd/kde/gauss/cutoff/gauss/dens/interp", TestNcmStatsDistNd, NULL, 
+              &test_ncm_stats_dist_nd_new_kde_gauss_cutoff, 
+              &test_ncm_stats_dist_nd_gauss_dens_interp, 
+              &test_ncm_stats_dist_nd_free);
+  
   g_test_add ("/ncm/stats/dist/nd/kde/gauss/gauss/sampling", TestNcmStatsDistNd, NULL, 
               &test_ncm_stats_dist_nd_new_kde_gauss, 
               &test_ncm_stats_dist_nd_gauss_sampling, 
@@ -106,6 +117,19 @@ test_ncm_stats_dist_nd_new_kde_gauss (TestNcmStatsDistNd *test, gconstpointer pd
   test->nfail = 0;
 }
 
+static void
+test_ncm_stats_dist_nd_new_kde_gauss_cutoff (TestNcmStatsDistNd *test, gconstpointer pdata)
+{
+  NcmStatsDistNdKDEGauss *dndg = ncm_stats_dist_nd_kde_gauss_new (g_test_rand_int_range (2, 8), TRUE);
+
+  ncm_stats_dist_nd_kde_gauss_set_cutoff (dndg, 6.0);
+  ncm_stats_dist_nd_kde_gauss_set_nthreads (dndg, 4);
+
+  test->dim   = ncm_stats_dist_nd_get_dim (NCM_STATS_DIST_ND (dndg));
+  test->dnd   = NCM_STATS_DIST_ND (dndg);
+  test->nfail = 0;
+}
+
 static void
 test_ncm_stats_dist_nd_free (TestNcmStatsDistNd *test, gconstpointer pdata)
 {
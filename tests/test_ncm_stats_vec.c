@@ -58,6 +58,7 @@ void test_ncm_stats_vec_autocorr_new (TestNcmStatsVec *test, gconstpointer pdata
 void test_ncm_stats_vec_mean_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_var_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_cov_test (TestNcmStatsVec *test, gconstpointer pdata);
+void test_ncm_stats_vec_block_merge_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_autocorr_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_subsample_autocorr_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_free (TestNcmStatsVec *test, gconstpointer pdata);
@@ -87,6 +88,10 @@ main (gint argc, gchar *argv[])
               &test_ncm_stats_vec_cov_new, 
               &test_ncm_stats_vec_cov_test, 
               &test_ncm_stats_vec_free);
+  g_test_add ("/ncm/stats_vec/cov/block_merge", TestNcmStatsVec, NULL, 
+              &test_ncm_stats_vec_cov_new, 
+              &test_ncm_stats_vec_block_merge_test, 
+              &test_ncm_stats_vec_free);
   g_test_add ("/ncm/stats_vec/autocorr", TestNcmStatsVec, NULL, 
               &test_ncm_stats_vec_autocorr_new, 
               &test_ncm_stats_vec_autocorr_test, 
@@ -336,6 +341,72 @@ test_ncm_stats_vec_cov_test (TestNcmStatsVec *test, gconstpointer pdata)
   ncm_rng_free (rng);
 }
 
+void
+test_ncm_stats_vec_block_merge_test (TestNcmStatsVec *test, gconstpointer pdata)
+{
+  NcmRNG *rng        = ncm_rng_pool_get ("test_ncm_stats_vec");
+  NcmStatsVec *svec1 = ncm_stats_vec_new (test->v_size, NCM_STATS_VEC_COV, FALSE);
+  NcmStatsVec *svec2 = ncm_stats_vec_new (test->v_size, NCM_STATS_VEC_COV, FALSE);
+  const guint nhalf  = test->ntests / 2;
+  GPtrArray *data1   = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  GPtrArray *data2   = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  NcmVector *w1      = ncm_vector_get_subvector (test->w, 0, nhalf);
+  NcmVector *w2      = ncm_vector_get_subvector (test->w, nhalf, test->ntests - nhalf);
+  guint i;
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    ncm_vector_set (test->mu, i, 1.0 + fabs (g_test_rand_double ()));
+  }
+
+  for (i = 0; i < test->ntests; i++)
+  {
+    const gdouble sigma = fabs (g_test_rand_double ()) + 1.0e-1;
+    const gdouble w     = 1.0 / (sigma * sigma);
+    NcmVector *x_i      = ncm_matrix_get_row (test->xs, i);
+    guint j;
+
+    for (j = 0; j < test->v_size; j++)
+    {
+      const gdouble x_j = ncm_vector_get (test->mu, j) + sigma * gsl_ran_ugaussian (rng->r);
+      ncm_vector_set (x_i, j, x_j);
+    }
+    ncm_vector_set (test->w, i, w);
+    ncm_stats_vec_append_weight (test->svec, x_i, w, FALSE);
+
+    g_ptr_array_add ((i < nhalf) ? data1 : data2, x_i);
+  }
+
+  ncm_stats_vec_append_weight_data (svec1, data1, w1, FALSE);
+  ncm_stats_vec_append_weight_data (svec2, data2, w2, FALSE);
+  ncm_stats_vec_merge (svec1, svec2);
+
+  g_assert_cmpuint (svec1->nitens, ==, test->svec->nitens);
+  ncm_assert_cmpdouble_e (svec1->weight, ==, test->svec->weight, _TEST_NCM_STATS_VEC_PREC, 0.0);
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    guint j;
+
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_mean (svec1, i), ==, ncm_stats_vec_get_mean (test->svec, i), _TEST_NCM_STATS_VEC_PREC, 0.0);
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_var (svec1, i), ==, ncm_stats_vec_get_var (test->svec, i), _TEST_NCM_STATS_VEC_PREC, 0.0);
+
+    for (j = i + 1; j < test->v_size; j++)
+    {
+      ncm_assert_cmpdouble (ncm_stats_vec_get_cov (svec1, i, j), ==, ncm_stats_vec_get_cov (svec1, j, i));
+      ncm_assert_cmpdouble_e (ncm_stats_vec_get_cov (svec1, i, j) + 1.0, ==, ncm_stats_vec_get_cov (test->svec, i, j) + 1.0, _TEST_NCM_STATS_VEC_COV_PREC, 0.0);
+    }
+  }
+
+  ncm_vector_free (w1);
+  ncm_vector_free (w2);
+  g_ptr_array_unref (data1);
+  g_ptr_array_unref (data2);
+  ncm_stats_vec_free (svec1);
+  ncm_stats_vec_free (svec2);
+  ncm_rng_free (rng);
+}
+
 void
 test_ncm_stats_vec_autocorr_test (TestNcmStatsVec *test, gconstpointer pdata)
 {
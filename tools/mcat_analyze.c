@@ -98,6 +98,7 @@ main (gint argc, gchar *argv[])
   gint nsteps = 100;
   gint burnin = 0;
   gint ntests = 100;
+  gint nthreads = 0;
   gchar **funcs          = NULL;
   gchar **distribs       = NULL;
   gchar **dist_tab       = NULL;
@@ -111,6 +112,9 @@ main (gint argc, gchar *argv[])
   gchar **dump_param     = NULL;
   gchar **pprob_gt       = NULL;
   gchar **pprob_lt       = NULL;
+  gchar **stream_cats    = NULL;
+  gint chunk_size        = NCM_MSET_CATALOG_STREAM_DEFAULT_CHUNK_SIZE;
+  gint nbins             = NCM_MSET_CATALOG_STREAM_DEFAULT_NBINS;
   NcmRNG *rng;
   guint i;
   
@@ -137,6 +141,7 @@ main (gint argc, gchar *argv[])
     { "zi",               0, 0, G_OPTION_ARG_DOUBLE,       &zi,             "Initial redshift (default 0).", NULL },
     { "zf",               0, 0, G_OPTION_ARG_DOUBLE,       &zf,             "Final redshift (default 1).", NULL },
     { "nsteps",           0, 0, G_OPTION_ARG_INT,          &nsteps,         "Number of points in the functions grid (default 100).", NULL },
+    { "nthreads",         0, 0, G_OPTION_ARG_INT,          &nthreads,       "Number of threads used to evaluate the functions over the catalog (default 0, no threads).", NULL },
     { "function",       'f', 0, G_OPTION_ARG_STRING_ARRAY, &funcs,          "R => R functions to be analyzed.", NULL},
     { "distribution",   'd', 0, G_OPTION_ARG_STRING_ARRAY, &distribs,       "Function distributions to be analyzed.", NULL},
     { "parameter",      'p', 0, G_OPTION_ARG_STRING_ARRAY, &params,         "Model parameters' to be analyzed.", NULL},
@@ -153,6 +158,9 @@ main (gint argc, gchar *argv[])
     { "dump-chain",       0, 0, G_OPTION_ARG_INT,          &dump_chain,     "Print all points from the N-th chain, if --dump-param not specified dump all columns.", "N"},
     { "dump-param",       0, 0, G_OPTION_ARG_STRING_ARRAY, &dump_param,     "Parameters to dump.", "param-name"},
     { "trim",           't', 0, G_OPTION_ARG_INT,          &trim,           "Trim the catalog at T.", "T" },
+    { "stream",         'S', 0, G_OPTION_ARG_STRING_ARRAY, &stream_cats,    "Catalogs to be summarized in a single streaming pass (bounded memory, one thread per file), --burn-in is applied to each file.", NULL },
+    { "chunk-size",       0, 0, G_OPTION_ARG_INT,          &chunk_size,     "Number of rows read at a time in streaming mode (default 65536).", NULL },
+    { "nbins",            0, 0, G_OPTION_ARG_INT,          &nbins,          "Number of histogram bins used to estimate quantiles in streaming mode (default 1000).", NULL },
     { NULL }
   };
 
@@ -233,6 +241,35 @@ main (gint argc, gchar *argv[])
     g_array_unref (func_z_table);
   }
   
+  if (stream_cats != NULL)
+  {
+    const guint nstream = g_strv_length (stream_cats);
+    glong *burnin_array = g_new (glong, nstream);
+    NcmMSetCatalogStream *mcs;
+
+    if ((chunk_size <= 0) || (nbins <= 0))
+    {
+      g_print ("Invalid --chunk-size or --nbins, both must be positive.\n");
+      exit (1);
+    }
+
+    for (i = 0; i < nstream; i++)
+      burnin_array[i] = burnin;
+
+    mcs = ncm_mset_catalog_stream_new (stream_cats[0], nbins);
+    ncm_mset_catalog_stream_add_files (mcs, stream_cats, burnin_array, chunk_size);
+
+    ncm_cfg_msg_sepa ();
+    g_message ("# Streaming summary of %u catalog(s).\n", nstream);
+    ncm_mset_catalog_stream_log_stats (mcs);
+
+    ncm_mset_catalog_stream_free (mcs);
+    g_free (burnin_array);
+
+    if (cat_filename == NULL)
+      exit (0);
+  }
+
   if (cat_filename == NULL)
   {
     if (list_all || list_hicosmo || list_hicosmo_z || list_dist || list_dist_z)
@@ -250,6 +287,8 @@ main (gint argc, gchar *argv[])
     NcmMSetCatalog *mcat = ncm_mset_catalog_new_from_file_ro (cat_filename, burnin);
     NcmMSet *mset = ncm_mset_catalog_get_mset (mcat);
 
+    ncm_mset_catalog_set_nthreads (mcat, nthreads);
+
     if (auto_trim)
     {
       ncm_mset_catalog_trim_by_type (mcat, ntests, NCM_MSET_CATALOG_TRIM_TYPE_ESS, NCM_FIT_RUN_MSGS_FULL);
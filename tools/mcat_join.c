@@ -37,6 +37,7 @@ main (gint argc, gchar *argv[])
   gchar **cat_filename = NULL;
   gchar **burnins      = NULL;
   gchar *out           = NULL;
+  gint chunk_size      = NCM_MSET_CATALOG_STREAM_DEFAULT_CHUNK_SIZE;
   
   GError *error = NULL;
   GOptionContext *context;
@@ -45,6 +46,7 @@ main (gint argc, gchar *argv[])
     { "catalog",        'c', 0, G_OPTION_ARG_STRING_ARRAY, &cat_filename,   "Input catalog filename.", NULL },
     { "burnin",         'b', 0, G_OPTION_ARG_STRING_ARRAY, &burnins,        "Burnin for the input catalogs.", NULL },
     { "out",            'o', 0, G_OPTION_ARG_STRING,       &out,            "Output catalog.", NULL },
+    { "chunk-size",     'k', 0, G_OPTION_ARG_INT,          &chunk_size,     "Approximated number of rows kept in memory (default 65536).", NULL },
     { NULL }
   };
 
@@ -62,6 +64,12 @@ main (gint argc, gchar *argv[])
     exit (1);
   }
 
+  if (chunk_size <= 0)
+  {
+    g_print ("Invalid chunk size %d, it must be positive.\n", chunk_size);
+    exit (1);
+  }
+
   if (cat_filename == NULL)
   {
     g_print ("No input catalogs, use --catalog/-c.\n");
@@ -81,56 +89,12 @@ main (gint argc, gchar *argv[])
     }
     else
     {
-      GPtrArray *mcats_array   = g_ptr_array_new ();
-      GArray *max_time_array   = g_array_new (TRUE, TRUE, sizeof (guint));
-      NcmMSetCatalog *mcat_out = ncm_mset_catalog_new_from_file_ro (cat_filename[0], 0);
-      const guint nchains      = ncm_mset_catalog_nchains (mcat_out);
-      NcmMSet *mset            = ncm_mset_catalog_get_mset (mcat_out);
-      guint mmax_time          = 0;
-      guint i, t;
-      
-      g_ptr_array_set_free_func (mcats_array, (GDestroyNotify)ncm_mset_catalog_free);
-
-      ncm_mset_catalog_set_file (mcat_out, NULL);
-      ncm_mset_catalog_reset (mcat_out);
-      
-      for (i = 0; i < nmcats; i++)
-      {
-        const glong burnin   = (i < nburnins) ? atol (burnins[i]) : 0;
-        NcmMSetCatalog *mcat = ncm_mset_catalog_new_from_file_ro (cat_filename[i], burnin);
-        NcmMSet *mset_i      = ncm_mset_catalog_get_mset (mcat);
-        guint max_time_i     = ncm_mset_catalog_max_time (mcat);
-
-        g_assert_cmpuint (ncm_mset_catalog_nchains (mcat), ==, nchains);
-        g_assert_cmpuint (ncm_mset_cmp_all (mset, mset_i), ==, 0);
-
-        if (burnin % nchains != 0)
-          g_error ("Burnin[%u] not multiple of nchains %u.", i, nchains);
-
-        mmax_time = GSL_MAX (mmax_time, max_time_i);
-        
-        ncm_mset_free (mset_i);
-        g_ptr_array_add (mcats_array, mcat);
-        g_array_append_val (max_time_array, max_time_i);
-      }
+      glong *burnin_array = g_new0 (glong, nmcats);
+      gchar *out_file     = NULL;
+      guint i;
 
-      for (t = 0; t < mmax_time; t++)
-      {
-        const guint offset = t * nchains;
-        for (i = 0; i < nmcats; i++)
-        {
-          if (t < g_array_index (max_time_array, guint, i))
-          {
-            NcmMSetCatalog *mcat_i = g_ptr_array_index (mcats_array, i);
-            guint wi;
-            for (wi = 0; wi < nchains; wi++)
-            {
-              NcmVector *row = ncm_mset_catalog_peek_row (mcat_i, offset + wi);
-              ncm_mset_catalog_add_from_vector (mcat_out, row);
-            }
-          }
-        }
-      }
+      for (i = 0; i < nburnins && i < nmcats; i++)
+        burnin_array[i] = atol (burnins[i]);
 
       if (out == NULL)
       {
@@ -143,8 +107,7 @@ main (gint argc, gchar *argv[])
           out_default = g_strdup_printf ("joined_mcat_%d.fits", i++);
         }
         
-        ncm_mset_catalog_set_file (mcat_out, out_default);
-        g_free (out_default);
+        out_file = out_default;
       }
       else
       {
@@ -161,21 +124,19 @@ main (gint argc, gchar *argv[])
             out_ren = g_strdup_printf ("%s_ren%d.fits", out_base, i++);
           }
 
-          ncm_mset_catalog_set_file (mcat_out, out_ren);
-          
+          out_file = out_ren;
           g_free (out_base);
-          g_free (out_ren);
         }
         else
-          ncm_mset_catalog_set_file (mcat_out, out);
+          out_file = g_strdup (out);
       }
 
-      g_ptr_array_unref (mcats_array);
-      g_array_unref (max_time_array);
-      ncm_mset_free (mset);
+      ncm_mset_catalog_stream_join (cat_filename, burnin_array, out_file, chunk_size);
+
+      g_free (out_file);
+      g_free (burnin_array);
     }
   }
 
   return 0;
 }
-